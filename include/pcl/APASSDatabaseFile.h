@@ -205,12 +205,12 @@ public:
       if ( Metadata().databaseIdentifier == "APASSDR9" )
       {
          m_dr = "DR9";
-         m_decoder = &APASSDatabaseFile::GetEncodedDR9Data;
+         m_decoder = &APASSDatabaseFile::GetEncodedStarData<EncodedDR9StarData>;
       }
       else if ( Metadata().databaseIdentifier == "APASSDR10" )
       {
          m_dr = "DR10";
-         m_decoder = &APASSDatabaseFile::GetEncodedDR10Data;
+         m_decoder = &APASSDatabaseFile::GetEncodedStarData<EncodedDR10StarData>;
       }
       else
          throw Error( "Invalid or unsupported APASS database file with unknown identifier '"
@@ -263,14 +263,38 @@ public:
     *
     * \li Instrumentation items for performance analysis, including: total
     * search time, time used for I/O operations, total I/O operations, time
-    * used for data decoding, and time used for data decompression.
+    * used for data decoding, time used for data decompression, and the
+    * number of data blocks retrieved from the shared block cache.
+    *
+    * When called from the root thread, this function loads and decodes the
+    * quadtree leaf nodes intersecting the search region in parallel.
     */
    void Search( APASSSearchData& data ) const
    {
-      ElapsedTime T;
-      for ( const XPSD::IndexTree& tree : m_index )
-         tree.Search( data.centerRA, data.centerDec, data.radius, &data );
-      data.timeTotal += T();
+      SearchLeaves( data );
+   }
+
+   /*!
+    * Performs a set of search operations in a single pass.
+    *
+    * Each element of the \a data array defines the parameters of a search
+    * operation, as for Search( APASSSearchData& ), and receives its results.
+    * Each quadtree index is traversed only once for all search regions, and
+    * each intersecting leaf node is loaded, uncompressed and decoded only
+    * once. This is much more efficient than performing many separate searches
+    * of small regions, as required for photometric calibration of individual
+    * stars or mosaic panels.
+    *
+    * The lists of found sources, excess counts and reject counts are identical
+    * to those obtained by performing each search separately. Since I/O and
+    * decoding operations are shared, the instrumentation items of the
+    * elements of \a data are not used. If \a batchData is not nullptr,
+    * instrumentation items for the whole set of searches will be accumulated
+    * in the structure pointed to by \a batchData.
+    */
+   void Search( Array<APASSSearchData>& data, XPSD::SearchDataBase* batchData = nullptr ) const
+   {
+      SearchLeavesBatch( data, batchData );
    }
 
    /*!
@@ -287,7 +311,8 @@ private:
 
    IsoString m_dr; // data release, one of "DR9", "DR10"
 
-   using star_decoder = void (APASSDatabaseFile::*)( const ByteArray&, const XPSD::IndexTree&, const XPSD::IndexNode&, void* ) const;
+   using star_decoder = void (APASSDatabaseFile::*)( const ByteArray&, const XPSD::IndexTree&, const XPSD::IndexNode&,
+                                                     void* const*, int, void* ) const;
    star_decoder m_decoder = nullptr;
 
 #pragma pack(push, 1)
@@ -356,127 +381,106 @@ private:
 
    void GetEncodedData( const ByteArray& data, const XPSD::IndexTree& tree, const XPSD::IndexNode& node, void* searchData ) const override
    {
-      (this->*m_decoder)( data, tree, node, searchData );
+      (this->*m_decoder)( data, tree, node, &searchData, 1, searchData );
    }
 
-   void GetEncodedDR9Data( const ByteArray& data, const XPSD::IndexTree& tree, const XPSD::IndexNode& node, void* searchData ) const
+   void GetEncodedBatchData( const ByteArray& data, const XPSD::IndexTree& tree, const XPSD::IndexNode& node,
+                             void* const* searchData, int searchCount, void* batchData ) const override
    {
-      ElapsedTime T;
-      APASSSearchData* search = reinterpret_cast<APASSSearchData*>( searchData );
-      double r = Rad( search->radius );
-      const EncodedDR9StarData* S = reinterpret_cast<const EncodedDR9StarData*>( data.Begin() );
-      int count = int( data.Size() / sizeof( EncodedDR9StarData ) );
-      int matched = 0;
-      for ( int i = 0; i < count; ++i, ++S )
-         if ( search->requiredFlags == 0 || (S->flags & search->requiredFlags) == search->requiredFlags )
-            if ( search->inclusionFlags == 0 || (S->flags & search->inclusionFlags) != 0 )
-               if ( search->exclusionFlags == 0 || (S->flags & search->exclusionFlags) == 0 )
-               {
-                  float mag_V = 0.001*S->mag_V - 1.5;
-                  if ( mag_V >= search->magnitudeLow )
-                     if ( mag_V <= search->magnitudeHigh )
-                     {
-                        APASSStarData star;
-                        double x = node.x0 + double( S->dx )/3600/1000;
-                        double y = node.y0 + double( S->dy )/3600/1000;
-                        tree.Unproject( star.ra, star.dec, x, y );
-                        if ( unlikely( S->dra != 0 ) )
-                        {
-                           star.ra += double( S->dra )/3600/1000/10;
-                           if ( star.ra < 0 )
-                              star.ra += 360;
-                           else if ( star.ra >= 360 )
-                              star.ra -= 360;
-                        }
-                        if ( Distance( search->centerRA, search->centerDec, star.ra, star.dec ) < r )
-                        {
-                           if ( search->stars.Length() < size_type( search->sourceLimit ) )
-                           {
-                              star.mag_V = mag_V;
-                              star.mag_B = 0.001*S->mag_B - 1.5;
-                              star.mag_g = 0.001*S->mag_g - 1.5;
-                              star.mag_r = 0.001*S->mag_r - 1.5;
-                              star.mag_i = 0.001*S->mag_i - 1.5;
-                              star.err_V = 0.001*S->err_V;
-                              star.err_B = 0.001*S->err_B;
-                              star.err_g = 0.001*S->err_g;
-                              star.err_r = 0.001*S->err_r;
-                              star.err_i = 0.001*S->err_i;
-                              star.flags = S->flags;
-                              search->stars << star;
-                           }
-                           else
-                              ++search->excessCount;
-                           ++matched;
-                        }
-                     }
-               }
+      (this->*m_decoder)( data, tree, node, searchData, searchCount, batchData );
+   }
 
-      search->rejectCount += count - matched;
-      search->timeDecode += T();
+   static void DecodeMagnitudes( APASSStarData& star, const EncodedDR9StarData* S )
+   {
+      star.mag_B = 0.001*S->mag_B - 1.5;
+      star.mag_g = 0.001*S->mag_g - 1.5;
+      star.mag_r = 0.001*S->mag_r - 1.5;
+      star.mag_i = 0.001*S->mag_i - 1.5;
+      star.err_V = 0.001*S->err_V;
+      star.err_B = 0.001*S->err_B;
+      star.err_g = 0.001*S->err_g;
+      star.err_r = 0.001*S->err_r;
+      star.err_i = 0.001*S->err_i;
    }
 
-   void GetEncodedDR10Data( const ByteArray& data, const XPSD::IndexTree& tree, const XPSD::IndexNode& node, void* searchData ) const
+   static void DecodeMagnitudes( APASSStarData& star, const EncodedDR10StarData* S )
+   {
+      star.mag_B   = 0.001*S->mag_B   - 1.5;
+   // star.mag_u   = 0.001*S->mag_u   - 1.5;
+      star.mag_g   = 0.001*S->mag_g   - 1.5;
+      star.mag_r   = 0.001*S->mag_r   - 1.5;
+      star.mag_i   = 0.001*S->mag_i   - 1.5;
+      star.mag_z_s = 0.001*S->mag_z_s - 1.5;
+   // star.mag_Y   = 0.001*S->mag_Y   - 1.5;
+      star.err_V   = 0.001*S->err_V;
+      star.err_B   = 0.001*S->err_B;
+   // star.err_u   = 0.001*S->err_u;
+      star.err_g   = 0.001*S->err_g;
+      star.err_r   = 0.001*S->err_r;
+      star.err_i   = 0.001*S->err_i;
+      star.err_z_s = 0.001*S->err_z_s;
+   // star.err_Y   = 0.001*S->err_Y;
+   }
+
+   template <class E>
+   void GetEncodedStarData( const ByteArray& data, const XPSD::IndexTree& tree, const XPSD::IndexNode& node,
+                            void* const* searchData, int searchCount, void* batchData ) const
    {
       ElapsedTime T;
-      APASSSearchData* search = reinterpret_cast<APASSSearchData*>( searchData );
-      double r = Rad( search->radius );
-      const EncodedDR10StarData* S = reinterpret_cast<const EncodedDR10StarData*>( data.Begin() );
-      int count = int( data.Size() / sizeof( EncodedDR10StarData ) );
-      int matched = 0;
+      const E* S = reinterpret_cast<const E*>( data.Begin() );
+      int count = int( data.Size() / sizeof( E ) );
+
+      // Every source is a reject until it matches the search criteria.
+      for ( int k = 0; k < searchCount; ++k )
+         reinterpret_cast<APASSSearchData*>( searchData[k] )->rejectCount += count;
+
       for ( int i = 0; i < count; ++i, ++S )
-         if ( search->requiredFlags == 0 || (S->flags & search->requiredFlags) == search->requiredFlags )
-            if ( search->inclusionFlags == 0 || (S->flags & search->inclusionFlags) != 0 )
-               if ( search->exclusionFlags == 0 || (S->flags & search->exclusionFlags) == 0 )
+      {
+         float mag_V = 0.001*S->mag_V - 1.5;
+         APASSStarData star;
+         bool decoded = false;
+
+         for ( int k = 0; k < searchCount; ++k )
+         {
+            APASSSearchData* search = reinterpret_cast<APASSSearchData*>( searchData[k] );
+            if ( !MatchesSearchCriteria( *search, S->flags, mag_V ) )
+               continue;
+
+            /*
+             * Source coordinates are decoded only once, and only for sources
+             * matching the flag and magnitude criteria of at least one search.
+             */
+            if ( !decoded )
+            {
+               double x = node.x0 + double( S->dx )/3600/1000;
+               double y = node.y0 + double( S->dy )/3600/1000;
+               tree.Unproject( star.ra, star.dec, x, y );
+               if ( unlikely( S->dra != 0 ) )
                {
-                  float mag_V = 0.001*S->mag_V - 1.5;
-                  if ( mag_V >= search->magnitudeLow )
-                     if ( mag_V <= search->magnitudeHigh )
-                     {
-                        APASSStarData star;
-                        double x = node.x0 + double( S->dx )/3600/1000;
-                        double y = node.y0 + double( S->dy )/3600/1000;
-                        tree.Unproject( star.ra, star.dec, x, y );
-                        if ( unlikely( S->dra != 0 ) )
-                        {
-                           star.ra += double( S->dra )/3600/1000/10;
-                           if ( star.ra < 0 )
-                              star.ra += 360;
-                           else if ( star.ra >= 360 )
-                              star.ra -= 360;
-                        }
-                        if ( Distance( search->centerRA, search->centerDec, star.ra, star.dec ) < r )
-                        {
-                           if ( search->stars.Length() < size_type( search->sourceLimit ) )
-                           {
-                              star.mag_V   = mag_V;
-                              star.mag_B   = 0.001*S->mag_B   - 1.5;
-                           // star.mag_u   = 0.001*S->mag_u   - 1.5;
-                              star.mag_g   = 0.001*S->mag_g   - 1.5;
-                              star.mag_r   = 0.001*S->mag_r   - 1.5;
-                              star.mag_i   = 0.001*S->mag_i   - 1.5;
-                              star.mag_z_s = 0.001*S->mag_z_s - 1.5;
-                           // star.mag_Y   = 0.001*S->mag_Y   - 1.5;
-                              star.err_V   = 0.001*S->err_V;
-                              star.err_B   = 0.001*S->err_B;
-                           // star.err_u   = 0.001*S->err_u;
-                              star.err_g   = 0.001*S->err_g;
-                              star.err_r   = 0.001*S->err_r;
-                              star.err_i   = 0.001*S->err_i;
-                              star.err_z_s = 0.001*S->err_z_s;
-                           // star.err_Y   = 0.001*S->err_Y;
-                              star.flags   = S->flags;
-                              search->stars << star;
-                           }
-                           else
-                              ++search->excessCount;
-                           ++matched;
-                        }
-                     }
+                  star.ra += double( S->dra )/3600/1000/10;
+                  if ( star.ra < 0 )
+                     star.ra += 360;
+                  else if ( star.ra >= 360 )
+                     star.ra -= 360;
                }
+               star.mag_V = mag_V;
+               DecodeMagnitudes( star, S );
+               star.flags = S->flags;
+               decoded = true;
+            }
+
+            if ( Distance( search->centerRA, search->centerDec, star.ra, star.dec ) < Rad( search->radius ) )
+            {
+               --search->rejectCount;
+               if ( search->stars.Length() < size_type( search->sourceLimit ) )
+                  search->stars << star;
+               else
+                  ++search->excessCount;
+            }
+         }
+      }
 
-      search->rejectCount += count - matched;
-      search->timeDecode += T();
+      reinterpret_cast<XPSD::SearchDataBase*>( batchData )->timeDecode += T();
    }
 
    friend class APASSDR9DatabaseFileGenerator;
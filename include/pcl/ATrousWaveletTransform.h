@@ -116,6 +116,14 @@ class InterlacedTransformation;
  * The last layer, at index N, is the large-scale residual layer. Pixels in the
  * residual layer image can only be positive or zero real values.
  *
+ * With separable scaling functions, the decomposition is computed in a single
+ * streaming pass: rows flow through a chain of ring buffers sized to the
+ * vertical extent of the dilated filter at each scale, and all wavelet layers
+ * are generated row by row without intermediate images. Only the scales
+ * required by enabled layers are computed. The StreamingNoiseKSigma() and
+ * StreamingNoiseMRS() member functions use the same engine to compute noise
+ * estimates without storing the wavelet layers.
+ *
  * \ingroup multiscale_transforms
  *
  * \note The StarletTransform class is an alias for %ATrousWaveletTransform.
@@ -638,6 +646,75 @@ public:
                     double sigma = 0, float k = 3, size_type* N = nullptr,
                     float low = 0.00002F, float high = 0.99998F ) const;
 
+   /*!
+    * Estimation of the standard deviation of the noise in a wavelet layer of
+    * the specified \a image, without storing its wavelet transform.
+    *
+    * This routine yields the same result as:
+    *
+    * \code
+    * ATrousWaveletTransform W( ScalingFunction(), j+1, ScalingSequence() );
+    * W << image;
+    * W.NoiseKSigma( j, k, eps, n, N );
+    * \endcode
+    *
+    * but when the scaling function is separable, the wavelet decomposition is
+    * computed in a single streaming pass over the rows of the image, keeping
+    * only the rows required by the dilated filters of each scale in ring
+    * buffers. Only the coefficients of the requested layer \a j are stored,
+    * which is the minimum required to perform the k-sigma iterations. For
+    * non-separable scaling functions, or images too small for the largest
+    * scale, this function performs a conventional decomposition.
+    *
+    * This object doesn't need to contain a wavelet transform; its scaling
+    * function, number of layers and scaling sequence are used, and its
+    * current transform, if any, is neither used nor modified. The wavelet
+    * decomposition is computed for the selected rectangle and the currently
+    * selected channel of \a image. \a j can be the index of the residual
+    * layer, that is, NumberOfLayers().
+    *
+    * For information on the rest of parameters see NoiseKSigma().
+    */
+   double StreamingNoiseKSigma( const ImageVariant& image, int j = 0, float k = 3,
+                                float eps = 0.01, int n = 10, size_type* N = nullptr ) const;
+
+   /*!
+    * Estimation of the standard deviation of the Gaussian noise from the
+    * multiresolution support of the specified \a image, without storing its
+    * wavelet transform.
+    *
+    * This routine computes the same estimate as:
+    *
+    * \code
+    * ATrousWaveletTransform W( ScalingFunction(), NumberOfLayers(), ScalingSequence() );
+    * W << image;
+    * W.NoiseMRS( image, sj, sigma, k, N, low, high );
+    * \endcode
+    *
+    * but when the scaling function is separable, all wavelet layers are
+    * computed in a single streaming pass over the rows of the image. For each
+    * pixel within the sampling range only two values are retained: its
+    * maximum absolute wavelet coefficient relative to the noise at the
+    * corresponding scale, and its value minus the residual layer. This is all
+    * the information required by the iterative algorithm, whose memory
+    * requirements are reduced to about 2/(NumberOfLayers()+1) of those of a
+    * stored transform. For non-separable scaling functions, or images too
+    * small for the largest scale, this function performs a conventional
+    * decomposition.
+    *
+    * The result is not guaranteed to be bit-identical to NoiseMRS(). The
+    * significance of each pixel is stored as a 32-bit floating point number
+    * and compared with K*sigma, so pixels whose significance is within
+    * rounding error of the threshold may be classified differently. The
+    * resulting differences are usually negligible.
+    *
+    * This object doesn't need to contain a wavelet transform. For information
+    * on parameters and return values see NoiseMRS().
+    */
+   double StreamingNoiseMRS( const ImageVariant& image, const float sj[],
+                             double sigma = 0, float k = 3, size_type* N = nullptr,
+                             float low = 0.00002F, float high = 0.99998F ) const;
+
 private:
 
    /*
@@ -101,9 +101,12 @@ public:
     */
    struct Performance
    {
-      float  sizeReduction   = 0; //!< Relative size reduction, e.g.: 0.25 for a 25% size reduction.
-      double throughput      = 0; //!< Compression/decompression rate in MiB per second.
-      int    numberOfThreads = 0; //!< Number of parallel threads used.
+      float     sizeReduction     = 0; //!< Relative size reduction, e.g.: 0.25 for a 25% size reduction.
+      double    throughput        = 0; //!< Compression/decompression rate in MiB per second.
+      int       numberOfThreads   = 0; //!< Number of parallel threads used.
+      size_type compressedBytes   = 0; //!< Total length in bytes of compressed subblock data.
+      size_type uncompressedBytes = 0; //!< Total length in bytes of uncompressed data.
+      double    elapsedTime       = 0; //!< Compression/decompression time in seconds.
    };
 
    /*!
@@ -111,6 +114,28 @@ public:
     */
    using subblock_list = Array<Subblock>;
 
+   /*!
+    * \struct pcl::Compression::SubblockRef
+    * \brief Reference to compressed subblock data stored in an external buffer.
+    *
+    * Unlike Subblock, this structure does not own the compressed data. It
+    * allows decompression of subblocks stored contiguously in a caller
+    * buffer, such as a compressed block read from a file, without copying
+    * each subblock to a separate ByteArray object.
+    */
+   struct SubblockRef
+   {
+      const uint8* compressedData   = nullptr; //!< Starting address of the compressed subblock data.
+      size_type    compressedSize   = 0;       //!< Size in bytes of the compressed subblock data.
+      size_type    uncompressedSize = 0;       //!< Size in bytes of the uncompressed subblock.
+      uint64       checksum         = 0;       //!< If non-zero, 64-bit non-cryptographic checksum of the compressed data.
+   };
+
+   /*!
+    * A dynamic, ordered list of references to compressed subblocks.
+    */
+   using subblock_ref_list = Array<SubblockRef>;
+
    /*!
     * Default constructor. This object will be initialized with the following
     * parameters:
@@ -425,6 +450,38 @@ public:
    size_type Uncompress( void* data, size_type maxSize,
                          const subblock_list& subblocks, Performance* perf = nullptr ) const;
 
+   /*!
+    * Decompression of a set of compressed subblocks stored in external
+    * buffers.
+    *
+    * \param data       Starting address of the output uncompressed data block.
+    *
+    * \param maxSize    Maximum space in bytes available at \a data. Must be
+    *                   equal to or larger than the total uncompressed size.
+    *
+    * \param subblocks  Reference to a dynamic array of references to
+    *                   compressed subblocks, which must remain valid during
+    *                   the call. This object must have coherent ItemSize() and
+    *                   ByteShufflingEnabled() properties to match the ones
+    *                   used when the data was compressed.
+    *
+    * \param perf       If non-null, pointer to a Performance structure where
+    *                   performance data will be provided.
+    *
+    * Subblocks are decompressed in parallel directly into the output \a data
+    * block. When byte shuffling is enabled, each subblock is unshuffled as
+    * soon as it has been decompressed, so no intermediate copy of the whole
+    * uncompressed block is required. Codec states are reused by each thread
+    * across successive calls; working buffers are released before returning.
+    *
+    * Returns the length in bytes of the uncompressed data. In the event of
+    * errors this function throws an Error exception. See
+    * Uncompress( void*, size_type, const subblock_list&, Performance* ) for
+    * more information.
+    */
+   size_type Uncompress( void* data, size_type maxSize,
+                         const subblock_ref_list& subblocks, Performance* perf = nullptr ) const;
+
    /*!
     * Decompression of a set of compressed subblocks.
     *
@@ -464,10 +521,13 @@ public:
    ByteArray Uncompress( const ByteArray& compressedData,
                          size_type uncompressedSize, Performance* perf = nullptr ) const
    {
-      Subblock subblock;
-      subblock.compressedData = compressedData;
+      SubblockRef subblock;
+      subblock.compressedData = compressedData.Begin();
+      subblock.compressedSize = compressedData.Length();
       subblock.uncompressedSize = uncompressedSize;
-      return Uncompress( subblock_list() << subblock, perf );
+      ByteArray data( uncompressedSize );
+      (void)Uncompress( data.Begin(), uncompressedSize, subblock_ref_list() << subblock, perf );
+      return data;
    }
 
 private:
@@ -775,7 +775,9 @@ using EphemerisObjectList = Array<EphemerisObject>;
  * specific objects is performed through a dedicated client subclass, namely
  * EphemerisFile::Handle. This class implements transparent file seek and read
  * operations, as well as fast, lock-free multithreaded evaluation of Chebyshev
- * polynomials.
+ * polynomials. When supported by the platform, XEPH files are memory-mapped
+ * for reading, so Chebyshev coefficients can be retrieved concurrently from
+ * any number of threads without locking or system calls.
  *
  * XEPH ephemeris files allow for calculation of rectangular coordinates
  * referred to the axes of the International Celestial Reference System
@@ -824,11 +826,17 @@ public:
     */
    EphemerisFile( EphemerisFile&& x )
       : m_file( std::move( x.m_file ) )
+      , m_data( x.m_data )
+      , m_dataSize( x.m_dataSize )
+      , m_mapping( x.m_mapping )
       , m_startTime( x.m_startTime )
       , m_endTime( x.m_endTime )
       , m_constants( std::move( x.m_constants ) )
       , m_index( std::move( x.m_index ) )
    {
+      x.m_data = nullptr;
+      x.m_dataSize = 0;
+      x.m_mapping = nullptr;
    }
 
    /*!
@@ -836,7 +844,14 @@ public:
     */
    EphemerisFile& operator =( EphemerisFile&& x )
    {
+      UnmapFile();
       m_file = std::move( x.m_file );
+      m_data = x.m_data;
+      m_dataSize = x.m_dataSize;
+      m_mapping = x.m_mapping;
+      x.m_data = nullptr;
+      x.m_dataSize = 0;
+      x.m_mapping = nullptr;
       m_startTime = x.m_startTime;
       m_endTime = x.m_endTime;
       m_constants = std::move( x.m_constants );
@@ -1808,6 +1823,9 @@ private:
    };
 
    mutable File                  m_file;
+           const uint8*          m_data = nullptr;    // read-only mapping of the whole file, if available
+           fsize_type            m_dataSize = 0;
+           void*                 m_mapping = nullptr; // platform-dependent file mapping handle
    mutable AtomicInt             m_handleCount;
    mutable Mutex                 m_mutex;
            TimePoint             m_startTime;
@@ -1830,6 +1848,39 @@ private:
    static String s_deltaATFilePath;
    static String s_cipITRSFilePath;
 
+   /*!
+    * \internal
+    * Creates a read-only memory mapping of the currently open file. If the
+    * file cannot be mapped, expansion data will be loaded with positional
+    * file reads.
+    */
+   void MapFile();
+
+   /*!
+    * \internal
+    * Releases the current file mapping, if any.
+    */
+   void UnmapFile();
+
+   /*!
+    * \internal
+    * Reads \a size bytes of expansion data at the specified file \a position.
+    * This function is thread-safe and does not lock: data are copied from the
+    * file mapping, or loaded with a positional read that does not depend on a
+    * shared file pointer.
+    */
+   void ReadExpansionData( void* data, int64 position, size_type size ) const
+   {
+      if ( m_data != nullptr )
+      {
+         if ( position < 0 || fsize_type( position + size ) > m_dataSize )
+            throw Error( "Invalid expansion data position." );
+         ::memcpy( data, m_data + position, size );
+      }
+      else
+         m_file.ReadAt( position, data, size );
+   }
+
    /*!
     * \internal
     * Returns a pointer to an Index structure for the specified object
@@ -2166,6 +2217,63 @@ public:
          a = m_node[2].expansion( t - m_node[2].startTime );
       }
 
+      /*!
+       * Computes state vectors for a set of time points.
+       *
+       * \param[out] p     Reference to an array where the computed state
+       *                   vectors will be stored. On output, this array will
+       *                   have the same length as \a t, with the state vector
+       *                   for the time point t[i] stored in p[i].
+       *
+       * \param t          The array of requested time points in the TDB time
+       *                   scale.
+       *
+       * This function is much faster than calling ComputeState( Vector&,
+       * TimePoint ) for each time point. Consecutive time points covered by
+       * the same Chebyshev expansion are evaluated together, and the
+       * polynomial recurrences are vectorized for several time points at once
+       * when the platform supports SIMD instructions. Time points don't have
+       * to be sorted, but sorted sequences are optimal since each expansion is
+       * then loaded only once.
+       *
+       * If any element of \a t is an invalid TimePoint instance, or a time
+       * point outside the time span available from the parent ephemeris file,
+       * this member function throws an Error exception.
+       *
+       * See ComputeState( Vector&, TimePoint ) for information on units and
+       * reference systems.
+       */
+      void ComputeState( Array<Vector>& p, const Array<TimePoint>& t )
+      {
+         EvaluateBatch( p, t, 0 );
+      }
+
+      /*!
+       * Computes state vectors and their first derivatives for a set of time
+       * points.
+       *
+       * This function is equivalent to ComputeState( Array<Vector>&,
+       * const Array<TimePoint>& ) followed by ComputeFirstDerivative(
+       * Array<Vector>&, const Array<TimePoint>& ).
+       */
+      void ComputeState( Array<Vector>& p, Array<Vector>& v, const Array<TimePoint>& t )
+      {
+         EvaluateBatch( p, t, 0 );
+         EvaluateBatch( v, t, 1 );
+      }
+
+      /*!
+       * Computes the first derivatives of state vectors for a set of time
+       * points.
+       *
+       * See ComputeState( Array<Vector>&, const Array<TimePoint>& ) and
+       * ComputeFirstDerivative( Vector&, TimePoint ) for complete information.
+       */
+      void ComputeFirstDerivative( Array<Vector>& v, const Array<TimePoint>& t )
+      {
+         EvaluateBatch( v, t, 1 );
+      }
+
       /*!
        * Computes a state vector for the specified time point \a t.
        *
@@ -2535,15 +2643,13 @@ public:
                   if ( m != info.current )
                   {
                      ChebyshevFit::coefficient_series coefficients;
+                     int64 position = node.position;
+                     for ( int i = 0, n = node.NumberOfComponents(); i < n; ++i )
                      {
-                        volatile AutoLock lock( m_parent->m_mutex );
-                        m_parent->m_file.SetPosition( node.position );
-                        for ( int i = 0, n = node.NumberOfComponents(); i < n; ++i )
-                        {
-                           Vector c( node.n[i] );
-                           m_parent->m_file.Read( reinterpret_cast<void*>( c.Begin() ), c.Size() );
-                           coefficients << c;
-                        }
+                        Vector c( node.n[i] );
+                        m_parent->ReadExpansionData( reinterpret_cast<void*>( c.Begin() ), position, c.Size() );
+                        position += c.Size();
+                        coefficients << c;
                      }
                      info.current = m;
                      info.startTime = t0;
@@ -2558,6 +2664,36 @@ public:
          }
       }
 
+      /*!
+       * \internal
+       * Updates the expansion of the specified derivative order for the time
+       * point \a t, generating derivatives by numerical differentiation when
+       * they are not available from the parent file.
+       */
+      void UpdateDerivative( TimePoint t )
+      {
+         if ( HasDerivative() )
+            Update( t, 1 );
+         else
+         {
+            Update( t, 0 );
+            if ( m_node[1].current != m_node[0].current )
+            {
+               m_node[1].current = m_node[0].current;
+               m_node[1].startTime = m_node[0].startTime;
+               m_node[1].endTime = m_node[0].endTime;
+               m_node[1].expansion = m_node[0].expansion.Derivative();
+            }
+         }
+      }
+
+      /*!
+       * \internal
+       * Batch evaluation of state vectors (index=0) or their first derivatives
+       * (index=1).
+       */
+      void EvaluateBatch( Array<Vector>& y, const Array<TimePoint>& t, int index );
+
       friend class PCL_CLASS Position;
    };
 
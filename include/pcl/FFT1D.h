@@ -57,6 +57,7 @@
 #include <pcl/Defs.h>
 
 #include <pcl/Complex.h>
+#include <pcl/String.h>
 #include <pcl/Vector.h>
 
 namespace pcl
@@ -64,6 +65,87 @@ namespace pcl
 
 // ----------------------------------------------------------------------------
 
+/*!
+ * \namespace pcl::FFTBackend
+ * \brief     Implementations of fast Fourier transforms
+ *
+ * <table border="1" cellpadding="4" cellspacing="0">
+ * <tr><td>FFTBackend::Auto</td>   <td>Use the core application's implementation when available; the native PCL implementation otherwise</td></tr>
+ * <tr><td>FFTBackend::Core</td>   <td>Use the core application's implementation. If it is not available, the native implementation is used instead</td></tr>
+ * <tr><td>FFTBackend::Native</td> <td>Use the native PCL implementation</td></tr>
+ * </table>
+ *
+ * The native implementation is a mixed-radix Stockham autosort %FFT with
+ * runtime dispatched SIMD radix-2 and radix-4 butterflies (see the
+ * SIMD::FFTRadix4() function), radix-3, radix-5 and generic odd radix passes,
+ * and real-to-complex transforms computed as complex transforms of half
+ * length. Transform plans (factorizations and twiddle factors) are cached and
+ * shared by all %FFT objects of the same length and direction.
+ *
+ * The native implementation does not depend on the PixInsight core
+ * application, so it allows using all %FFT-based PCL classes in standalone
+ * applications and unit tests.
+ */
+namespace FFTBackend
+{
+   enum value_type
+   {
+      Auto,    // Core when available, Native otherwise
+      Core,    // PixInsight core application
+      Native   // PCL native implementation
+   };
+}
+
+/*!
+ * Returns the %FFT backend selected for newly created %FFT objects. The
+ * default selection is FFTBackend::Auto.
+ *
+ * \ingroup fft_1d
+ * \sa SetFFTBackend(), ActiveFFTBackend()
+ */
+PCL_FUNC FFTBackend::value_type SelectedFFTBackend() noexcept;
+
+/*!
+ * Selects the %FFT backend used by newly created %FFT objects.
+ *
+ * Existing %FFT objects continue using the implementation they were created
+ * with, so this function can be called at any time. However, transforms
+ * computed by different backends may differ by rounding errors, so a backend
+ * should normally be selected once, before performing any transform.
+ *
+ * \ingroup fft_1d
+ */
+PCL_FUNC void SetFFTBackend( FFTBackend::value_type backend ) noexcept;
+
+/*!
+ * Returns the %FFT backend effectively used by newly created %FFT objects:
+ * either FFTBackend::Core or FFTBackend::Native, as a function of the current
+ * backend selection and the availability of the core application.
+ *
+ * \ingroup fft_1d
+ */
+PCL_FUNC FFTBackend::value_type ActiveFFTBackend() noexcept;
+
+/*!
+ * Measures the performance of the available %FFT backends.
+ *
+ * For each transform length in the \a lengths array, forward complex and real
+ * transforms of 32-bit floating point data are performed with the core and
+ * native implementations. Returns a text report with one line per length and
+ * transform type, including the average execution times in microseconds and
+ * the maximum difference between both implementations, relative to the
+ * largest transform coefficient. If the core implementation is not available,
+ * only the native implementation is measured.
+ *
+ * If no lengths are specified, a predefined set of optimized lengths between
+ * 64 and 8192 is used.
+ *
+ * \ingroup fft_1d
+ */
+PCL_FUNC String BenchmarkFFTBackends( const Array<int>& lengths = Array<int>() );
+
+// ----------------------------------------------------------------------------
+
 class FFT1DBase
 {
 protected:
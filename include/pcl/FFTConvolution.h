@@ -82,6 +82,15 @@ namespace pcl
  * (mirroring), and is able to convolve images and response functions of
  * arbitrary sizes, only limited by the available memory.
  *
+ * By default the whole selected area of each channel is convolved with a
+ * single complex transform. Alternatively, %FFTConvolution can work in
+ * <em>tiled mode</em>, where the image is convolved by the overlap-save
+ * method over small tiles using real-to-complex transforms. Tiled convolution
+ * requires a working memory proportional to the tile size and the number of
+ * threads instead of the image size, which makes it the method of choice for
+ * very large images and real response functions. See
+ * EnableTiledConvolution() for more information.
+ *
  * \sa Convolution, SeparableConvolution
 */
 class PCL_CLASS FFTConvolution : public ImageTransformation, public ParallelProcess
@@ -139,6 +148,9 @@ public:
       , ParallelProcess( x )
       , m_image( x.m_image )
       , m_outputRealCmp( x.m_outputRealCmp )
+      , m_tiled( x.m_tiled )
+      , m_tileSize( x.m_tileSize )
+      , m_tileMemory( x.m_tileMemory )
    {
       if ( x.m_filter )
          m_filter = x.m_filter->Clone();
@@ -171,6 +183,9 @@ public:
          else
             m_image = x.m_image;
          m_outputRealCmp = x.m_outputRealCmp;
+         m_tiled = x.m_tiled;
+         m_tileSize = x.m_tileSize;
+         m_tileMemory = x.m_tileMemory;
       }
       return *this;
    }
@@ -327,6 +342,136 @@ public:
       m_outputRealCmp = !enable;
    }
 
+   /*!
+    * Returns true iff tiled convolution is enabled for this object.
+    *
+    * \sa EnableTiledConvolution()
+    */
+   bool IsTiledConvolutionEnabled() const
+   {
+      return m_tiled;
+   }
+
+   /*!
+    * Enables tiled convolution for this object.
+    *
+    * In tiled mode, each channel of the target image is convolved by the
+    * overlap-save method: the image is divided into tiles, each tile is
+    * extended with the required filter margins (mirrored at the image
+    * boundaries), transformed with a two-dimensional real-to-complex FFT,
+    * multiplied by the DFT of the response function and transformed back.
+    * The DFT of the response function is computed once for the current tile
+    * dimensions and reused for all tiles and channels. Tiles are convolved in
+    * parallel, and the working memory depends only on the tile size and the
+    * number of running threads.
+    *
+    * Tiled convolution is only applied to real images convolved with real
+    * response functions. If either the target image or the response function
+    * image is complex, the standard full-frame convolution algorithm is used
+    * irrespective of this setting.
+    *
+    * Tiled convolution is disabled by default.
+    *
+    * \sa TileSize(), SetTileSize()
+    */
+   void EnableTiledConvolution( bool enable = true )
+   {
+      m_tiled = enable;
+   }
+
+   /*!
+    * Disables tiled convolution for this object.
+    *
+    * \sa EnableTiledConvolution()
+    */
+   void DisableTiledConvolution( bool disable = true )
+   {
+      EnableTiledConvolution( !disable );
+   }
+
+   /*!
+    * Returns the nominal size in pixels of a tile for tiled convolution,
+    * including filter margins. A value of zero means that the tile size is
+    * selected automatically from the working memory budget.
+    *
+    * \sa SetTileSize(), TileMemoryBudget(), EnableTiledConvolution()
+    */
+   int TileSize() const
+   {
+      return m_tileSize;
+   }
+
+   /*!
+    * Sets the nominal size in pixels of a tile for tiled convolution,
+    * including filter margins. Specify zero to select tile sizes
+    * automatically, which is the default setting.
+    *
+    * Automatic tiles are as large as allowed by TileMemoryBudget(), but not
+    * larger than required for all running threads to work on the same strip
+    * of tiles. In this way the filter margins, which are computed once for
+    * each tile, represent the smallest possible fraction of the work.
+    *
+    * The actual tile dimensions are computed as optimized FFT lengths at
+    * least twice the dimensions of the response function, and never larger
+    * than required to convolve the target image with a single tile. Smaller
+    * tiles reduce working memory requirements and improve memory locality,
+    * at the cost of more redundant computations on overlapping tile margins.
+    *
+    * \sa TileSize(), EnableTiledConvolution()
+    */
+   void SetTileSize( int size )
+   {
+      PCL_PRECONDITION( size >= 0 )
+      m_tileSize = Max( 0, size );
+   }
+
+   /*!
+    * Returns the maximum working memory in bytes available for tiled
+    * convolution with automatic tile sizes. This includes the tile buffers of
+    * all running threads, the DFT of the response function and the buffered
+    * strips of convolved tiles. A value of zero means that one quarter of the
+    * currently available physical memory will be used.
+    *
+    * \sa SetTileMemoryBudget(), SetTileSize()
+    */
+   size_type TileMemoryBudget() const
+   {
+      return m_tileMemory;
+   }
+
+   /*!
+    * Sets the maximum working memory in bytes available for tiled
+    * convolution with automatic tile sizes. Specify zero to use one quarter
+    * of the available physical memory, which is the default setting.
+    *
+    * Tiles are never made smaller than twice the dimensions of the response
+    * function, so very small budgets may be exceeded.
+    *
+    * \sa TileMemoryBudget(), SetTileSize()
+    */
+   void SetTileMemoryBudget( size_type bytes )
+   {
+      m_tileMemory = bytes;
+   }
+
+   /*!
+    * Returns a pointer to the discrete Fourier transform of the response
+    * function used for tiled convolution, or nullptr if it has not been
+    * created yet.
+    *
+    * The returned complex image stores the Hermitian half of the DFT of the
+    * real response function in wrap around order, as computed by a
+    * two-dimensional real-to-complex FFT of the tile dimensions. Its width is
+    * one half of the tile width plus one, and its height is equal to the tile
+    * height.
+    *
+    * \sa ResponseFunctionDFT(), EnableTiledConvolution()
+    */
+   const ComplexImage* TiledResponseFunctionDFT() const
+   {
+      return m_hTile;
+   }
+
    /*!
     * Returns the minimum filter size in pixels for which FFT-based
     * two-dimensional convolution is consistently faster than nonseparable
@@ -433,6 +578,9 @@ protected:
    AutoPointer<KernelFilter> m_filter;
    ImageVariant              m_image;
    bool                      m_outputRealCmp = false;
+   bool                      m_tiled = false;
+   int                       m_tileSize = 0;
+   size_type                 m_tileMemory = 0;
 
    /*
     * Internal DFT of the response function. Initially zero. This matrix is
@@ -441,6 +589,14 @@ protected:
     */
    mutable AutoPointer<ComplexImage> m_h;
 
+   /*
+    * Internal DFT of the response function for tiled convolution, and width
+    * of the real tiles it has been computed for. Regenerated as necessary for
+    * different tile dimensions.
+    */
+   mutable AutoPointer<ComplexImage> m_hTile;
+   mutable int                       m_hTileWidth = 0;
+
    /*
     * In-place Fourier-based 2-D convolution algorithm.
     */
@@ -461,6 +617,8 @@ private:
       m_filter.Destroy();
       m_image.Free();
       m_h.Destroy();
+      m_hTile.Destroy();
+      m_hTileWidth = 0;
    }
 
    void Validate() const;
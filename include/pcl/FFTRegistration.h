@@ -307,6 +307,10 @@ FFTRegistrationEngine& operator <<( FFTRegistrationEngine& R, const O& image )
  * computes the offsets \e dx and \e dy required to register a target image on
  * a reference image, using an %FFT-based phase correlation algorithm.
  *
+ * Sets of target images can be evaluated in parallel with EvaluateBatch(),
+ * and translations can be estimated on binned images before a refinement at
+ * full resolution (see SetPyramidLevels()).
+ *
  * \sa FFTRotationAndScaling, FFTRegistrationEngine
  */
 class PCL_CLASS FFTTranslation : public FFTRegistrationEngine
@@ -420,6 +424,124 @@ public:
       return m_peak;
    }
 
+   /*!
+    * Returns the number of pyramid levels used for coarse-to-fine evaluation
+    * of translations. When this number is zero (the default value),
+    * translations are evaluated at full resolution.
+    *
+    * \sa SetPyramidLevels()
+    */
+   int PyramidLevels() const
+   {
+      return m_pyramidLevels;
+   }
+
+   /*!
+    * Sets the number of pyramid levels used for coarse-to-fine evaluation of
+    * translations.
+    *
+    * When \a n > 0, the reference and target images are binned by a factor of
+    * 2^n to compute a coarse translation estimate. The final translation is
+    * then refined by phase correlation at full resolution on a centered
+    * window of the reference image (see RefinementSize()), extracted from the
+    * target image at the coarsely registered position. This can reduce the
+    * cost of each evaluation by one order of magnitude or more, at the price
+    * of requiring significant structures within the refinement window. The
+    * number of levels is reduced automatically if the binned images would be
+    * too small. The maximum value is 8.
+    *
+    * When coarse-to-fine evaluation is active, DFTOfReferenceImage() returns
+    * the discrete Fourier transform of the binned reference image.
+    *
+    * \note As a consequence of calling this function, this engine is reset
+    * and must be reinitialized.
+    */
+   void SetPyramidLevels( int n )
+   {
+      n = Range( n, 0, 8 );
+      if ( n != m_pyramidLevels )
+      {
+         Reset();
+         m_pyramidLevels = n;
+      }
+   }
+
+   /*!
+    * Returns the size in pixels of the full-resolution refinement window used
+    * for coarse-to-fine evaluation. When this size is zero (the default
+    * value), the refinement window is one fourth of the largest dimension of
+    * the reference image, with a minimum of 64 pixels.
+    *
+    * \sa SetRefinementSize(), PyramidLevels()
+    */
+   int RefinementSize() const
+   {
+      return m_refinementSize;
+   }
+
+   /*!
+    * Sets the size in pixels of the full-resolution refinement window used
+    * for coarse-to-fine evaluation. Specify zero to select an automatic
+    * refinement size.
+    *
+    * \note As a consequence of calling this function, this engine is reset
+    * and must be reinitialized.
+    */
+   void SetRefinementSize( int n )
+   {
+      n = Max( 0, n );
+      if ( n != m_refinementSize )
+      {
+         Reset();
+         m_refinementSize = n;
+      }
+   }
+
+   /*!
+    * \struct Result
+    * \brief The result of a translation evaluation.
+    */
+   struct Result
+   {
+      FPoint delta = 0.0F; //!< Translation increments in pixels.
+      float  peak = 0.0F;  //!< Peak value read from the phase matrix.
+   };
+
+   /*!
+    * A list of translation evaluation results.
+    */
+   using result_list = Array<Result>;
+
+   /*!
+    * Evaluates translations for a set of target \a images.
+    *
+    * Returns a list of evaluation results, where each element corresponds to
+    * the image at the same position in the \a images array. The results are
+    * the same that would be obtained by calling Evaluate() for each target
+    * image, but the evaluations are performed in parallel, one image per
+    * thread, and each thread reuses its %FFT objects and working matrices for
+    * all of its images. This is much more efficient than successive calls to
+    * Evaluate() for large sets of small images, which is the typical case of
+    * lucky imaging and comet registration tasks. If this engine performs
+    * coarse-to-fine evaluations (see PyramidLevels()), so does this function.
+    *
+    * The current Delta() and Peak() values of this object are not modified
+    * by this function. Empty ImageVariant objects yield zero results.
+    *
+    * \param images          The target images.
+    *
+    * \param parallel        Whether to evaluate images in parallel. True by
+    *                        default.
+    *
+    * \param maxProcessors   The maximum number of threads. The default value
+    *                        is PCL_MAX_PROCESSORS.
+    *
+    * If this engine has not been initialized, this function throws an Error
+    * exception.
+    */
+   result_list EvaluateBatch( const Array<ImageVariant>& images,
+                              bool parallel = true, int maxProcessors = PCL_MAX_PROCESSORS ) const;
+
 protected:
 
    // Allow translations > size/2.
@@ -432,6 +554,14 @@ protected:
    // Peak value detected in the phase matrix.
    float    m_peak = 0.0F;
 
+   // Coarse-to-fine evaluation.
+   int          m_pyramidLevels = 0;
+   int          m_refinementSize = 0;      // 0 = automatic
+   int          m_pyramidFactor = 0;       // effective binning factor, or 0 if unused
+   Rect         m_referenceWindow = 0;     // refinement window, relative to the reference selection
+   ComplexImage m_fftWindowReference;      // DFT of the reference refinement window
+                                           // (m_fftReference is the DFT of the binned reference)
+
    ComplexImage DoInitialize( const pcl::Image& ) override;
    ComplexImage DoInitialize( const pcl::DImage& ) override;
    ComplexImage DoInitialize( const pcl::ComplexImage& ) override;
@@ -447,6 +577,8 @@ protected:
    void DoEvaluate( const pcl::UInt8Image& ) override;
    void DoEvaluate( const pcl::UInt16Image& ) override;
    void DoEvaluate( const pcl::UInt32Image& ) override;
+
+   friend class PCL_FFTTranslationEngine;
 };
 
 // ----------------------------------------------------------------------------
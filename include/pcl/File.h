@@ -897,6 +897,22 @@ public:
     */
    virtual void Read( void* buffer, fsize_type len );
 
+   /*!
+    * Reads a contiguous block of \a len bytes, starting at the specified
+    * absolute file \a position, into the specified \a buffer.
+    *
+    * This is a positional read operation: it does not depend on the current
+    * file position, so it can be called concurrently from multiple threads on
+    * the same %File object, as long as no sequential I/O operations are being
+    * performed simultaneously. On POSIX platforms the current file position is
+    * not modified by this function. On Windows the current file position is
+    * undefined after calling this function.
+    *
+    * Throws a File::Error exception if the requested block cannot be read
+    * completely.
+    */
+   void ReadAt( fpos_type position, void* buffer, fsize_type len ) const;
+
    /*!
     * Reads an object \a x of type T.
     */
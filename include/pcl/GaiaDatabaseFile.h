@@ -499,14 +499,39 @@ public:
     *
     * \li Instrumentation items for performance analysis, including: total
     * search time, time used for I/O operations, total I/O operations, time
-    * used for data decoding, and time used for data decompression.
+    * used for data decoding, time used for data decompression, and the
+    * number of data blocks retrieved from the shared block cache.
+    *
+    * When called from the root thread, this function loads and decodes the
+    * quadtree leaf nodes intersecting the search region in parallel.
     */
    void Search( GaiaSearchData& data ) const
    {
-      ElapsedTime T;
-      for ( const XPSD::IndexTree& tree : m_index )
-         tree.Search( data.centerRA, data.centerDec, data.radius, &data );
-      data.timeTotal += T();
+      SearchLeaves( data );
+   }
+
+   /*!
+    * Performs a set of search operations in a single pass.
+    *
+    * Each element of the \a data array defines the parameters of a search
+    * operation, as for Search( GaiaSearchData& ), and receives its results.
+    * This is much more efficient than performing the searches separately when
+    * many small regions have to be searched, for example one region per
+    * detected star or per mosaic panel: each quadtree index is traversed only
+    * once for all search regions, and each intersecting leaf node is loaded,
+    * uncompressed and decoded only once, with flag and magnitude criteria
+    * applied before decoding source coordinates.
+    *
+    * The lists of found sources, excess counts and reject counts are identical
+    * to those obtained by performing each search separately. Since I/O and
+    * decoding operations are shared, the instrumentation items of the
+    * elements of \a data are not used. If \a batchData is not nullptr,
+    * instrumentation items for the whole set of searches will be accumulated
+    * in the structure pointed to by \a batchData.
+    */
+   void Search( Array<GaiaSearchData>& data, XPSD::SearchDataBase* batchData = nullptr ) const
+   {
+      SearchLeavesBatch( data, batchData );
    }
 
 private:
@@ -564,83 +589,98 @@ private:
 #pragma pack(pop)
 
    void GetEncodedData( const ByteArray& data, const XPSD::IndexTree& tree, const XPSD::IndexNode& node, void* searchData ) const override
+   {
+      GetEncodedBatchData( data, tree, node, &searchData, 1, searchData );
+   }
+
+   void GetEncodedBatchData( const ByteArray& data, const XPSD::IndexTree& tree, const XPSD::IndexNode& node,
+                             void* const* searchData, int searchCount, void* batchData ) const override
    {
       ElapsedTime T;
-      GaiaSearchData* search = reinterpret_cast<GaiaSearchData*>( searchData );
-      double searchRadius = Rad( search->radius );
       int itemSize = m_hasSpectrumData ? EncodedStarSPDataSize() : sizeof( EncodedStarData );
       int count = int( data.Size() / itemSize );
-      int matchCount = 0;
+
+      // Every source is a reject until it matches the search criteria.
+      for ( int k = 0; k < searchCount; ++k )
+         reinterpret_cast<GaiaSearchData*>( searchData[k] )->rejectCount += count;
+
       for ( int i = 0; i < count; ++i )
       {
          const EncodedStarData* S = reinterpret_cast<const EncodedStarData*>( data.Begin() + i*itemSize );
-         if ( search->requiredFlags == 0 || (S->flags & search->requiredFlags) == search->requiredFlags )
-            if ( search->inclusionFlags == 0 || (S->flags & search->inclusionFlags) != 0 )
-               if ( search->exclusionFlags == 0 || (S->flags & search->exclusionFlags) == 0 )
+         float magG = 0.001*S->magG - 1.5;
+         GaiaStarData star;
+         bool decoded = false;
+
+         for ( int k = 0; k < searchCount; ++k )
+         {
+            GaiaSearchData* search = reinterpret_cast<GaiaSearchData*>( searchData[k] );
+            if ( !MatchesSearchCriteria( *search, S->flags, magG ) )
+               continue;
+
+            /*
+             * Source coordinates are decoded only once, and only for sources
+             * matching the flag and magnitude criteria of at least one search.
+             */
+            if ( !decoded )
+            {
+               double x = node.x0 + double( S->dx )/3600/1000/500;
+               double y = node.y0 + double( S->dy )/3600/1000/500;
+               tree.Unproject( star.ra, star.dec, x, y );
+               if ( unlikely( S->dra != 0 ) )
                {
-                  float magG = 0.001*S->magG - 1.5;
-                  if ( magG >= search->magnitudeLow )
-                     if ( magG <= search->magnitudeHigh )
+                  star.ra += double( S->dra )/3600/1000/100;
+                  if ( star.ra < 0 )
+                     star.ra += 360;
+                  else if ( star.ra >= 360 )
+                     star.ra -= 360;
+               }
+               star.parx = S->parx;
+               star.pmra = S->pmra;
+               star.pmdec = S->pmdec;
+               star.magG = magG;
+               star.magBP = 0.001*S->magBP - 1.5;
+               star.magRP = 0.001*S->magRP - 1.5;
+               star.flags = S->flags;
+               decoded = true;
+            }
+
+            if ( Distance( search->centerRA, search->centerDec, star.ra, star.dec ) < Rad( search->radius ) )
+            {
+               --search->rejectCount;
+
+               if ( search->stars.Length() < size_type( search->sourceLimit ) )
+               {
+                  if ( m_hasSpectrumData )
+                  {
+                     const EncodedStarSPData* SS = static_cast<const EncodedStarSPData*>( S );
+                     star.flux = FVector( m_spectrumCount );
+                     if ( search->photonFluxUnits )
+                     {
+                        for ( int j = 0; j < m_spectrumCount; ++j )
+                           star.flux[j] = (SS->flux[j]*SS->fluxMul + SS->fluxMin) * (m_spectrumStart + j*m_spectrumStep)/1.602e-19/1.239979e-3;
+                        if ( search->normalizeSpectrum )
+                           star.flux /= star.flux.MaxComponent();
+                     }
+                     else
                      {
-                        double x = node.x0 + double( S->dx )/3600/1000/500;
-                        double y = node.y0 + double( S->dy )/3600/1000/500;
-                        GaiaStarData star;
-                        tree.Unproject( star.ra, star.dec, x, y );
-                        if ( unlikely( S->dra != 0 ) )
-                        {
-                           star.ra += double( S->dra )/3600/1000/100;
-                           if ( star.ra < 0 )
-                              star.ra += 360;
-                           else if ( star.ra >= 360 )
-                              star.ra -= 360;
-                        }
-                        if ( Distance( search->centerRA, search->centerDec, star.ra, star.dec ) < searchRadius )
-                        {
-                           ++matchCount;
-
-                           if ( search->stars.Length() < size_type( search->sourceLimit ) )
-                           {
-                              star.parx = S->parx;
-                              star.pmra = S->pmra;
-                              star.pmdec = S->pmdec;
-                              star.magG = magG;
-                              star.magBP = 0.001*S->magBP - 1.5;
-                              star.magRP = 0.001*S->magRP - 1.5;
-                              star.flags = S->flags;
-
-                              if ( m_hasSpectrumData )
-                              {
-                                 const EncodedStarSPData* SS = static_cast<const EncodedStarSPData*>( S );
-                                 star.flux = FVector( m_spectrumCount );
-                                 if ( search->photonFluxUnits )
-                                 {
-                                    for ( int j = 0; j < m_spectrumCount; ++j )
-                                       star.flux[j] = (SS->flux[j]*SS->fluxMul + SS->fluxMin) * (m_spectrumStart + j*m_spectrumStep)/1.602e-19/1.239979e-3;
-                                    if ( search->normalizeSpectrum )
-                                       star.flux /= star.flux.MaxComponent();
-                                 }
-                                 else
-                                 {
-                                    if ( search->normalizeSpectrum )
-                                       for ( int j = 0; j < m_spectrumCount; ++j )
-                                          star.flux[j] = SS->flux[j]/m_spectrumRange;
-                                    else
-                                       for ( int j = 0; j < m_spectrumCount; ++j )
-                                          star.flux[j] = SS->flux[j]*SS->fluxMul + SS->fluxMin;
-                                 }
-                              }
-
-                              search->stars << star;
-                           }
-                           else
-                              ++search->excessCount;
-                        }
+                        if ( search->normalizeSpectrum )
+                           for ( int j = 0; j < m_spectrumCount; ++j )
+                              star.flux[j] = SS->flux[j]/m_spectrumRange;
+                        else
+                           for ( int j = 0; j < m_spectrumCount; ++j )
+                              star.flux[j] = SS->flux[j]*SS->fluxMul + SS->fluxMin;
                      }
+                  }
+
+                  search->stars << star;
                }
+               else
+                  ++search->excessCount;
+            }
+         }
       }
 
-      search->rejectCount += count - matchCount;
-      search->timeDecode += T();
+      reinterpret_cast<XPSD::SearchDataBase*>( batchData )->timeDecode += T();
    }
 
    friend class GaiaDR2DatabaseFileGenerator;
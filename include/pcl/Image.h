@@ -66,6 +66,7 @@
 #include <pcl/PixelAllocator.h>
 #include <pcl/PixelTraits.h>
 #include <pcl/ReferenceArray.h>
+#include <pcl/SIMDDispatch.h>
 #include <pcl/Vector.h>
 
 #ifndef __PCL_IMAGE_NO_BITMAP
@@ -16077,112 +16078,21 @@ private:
          }
       }
 
-#ifdef __PCL_AVX2
-
-      PCL_HOT_FUNCTION
       static void Build( SzVector& H, const float* __restrict__ A, size_type N, double low, double high )
       {
          const double range = high - low;
-         if ( 1 + range == 1 )
-            return;
-
-         const float s = float( (__PCL_MEDIAN_HISTOGRAM_LENGTH - 1)/range );
-         const float l = float( low );
-         const __m256 S = _mm256_set1_ps( s );
-         const __m256 L = _mm256_set1_ps( l );
-         const size_type stepLength = 0x40000000u;
-
-         for ( size_type p = 0; p < N; p += stepLength )
-         {
-            const float* __restrict__ V = A + p;
-            const int n = int( pcl::Min( stepLength, N - p ) );
-            const int n8 = n >> 3;
-
-            if ( ((ptrdiff_t)V) & 31 )
-               for ( int i = 0; i < n8; ++i )
-               {
-                  __m256 v = _mm256_loadu_ps( (const float* __restrict__)(V + i*8) );
-                  __m256i K = _mm256_cvttps_epi32( _mm256_mul_ps( _mm256_sub_ps( v, L ), S ) );
-                  for ( int j = 0; j < 8; ++j )
-                  {
-                     const int k = ((const int* __restrict__)&K)[j];
-                     if ( k >= 0 && k < __PCL_MEDIAN_HISTOGRAM_LENGTH )
-                        ++H[k];
-                  }
-               }
-            else
-               for ( int i = 0; i < n8; ++i )
-               {
-                  __m256i K = _mm256_cvttps_epi32( _mm256_mul_ps( _mm256_sub_ps( ((const __m256* __restrict__)V)[i], L ), S ) );
-                  for ( int j = 0; j < 8; ++j )
-                  {
-                     const int k = ((const int* __restrict__)&K)[j];
-                     if ( k >= 0 && k < __PCL_MEDIAN_HISTOGRAM_LENGTH )
-                        ++H[k];
-                  }
-               }
-
-            for ( int i = n8 << 3; i < n; ++i )
-            {
-               const int k = TruncInt( s * (V[i] - l) );
-               if ( k >= 0 && k < __PCL_MEDIAN_HISTOGRAM_LENGTH )
-                  ++H[k];
-            }
-         }
+         if ( 1 + range != 1 )
+            SIMD::Histogram( H.Begin(), __PCL_MEDIAN_HISTOGRAM_LENGTH, A, N,
+                             float( low ), float( (__PCL_MEDIAN_HISTOGRAM_LENGTH - 1)/range ) );
       }
 
-      PCL_HOT_FUNCTION
       static void Build( SzVector& H, const double* __restrict__ A, size_type N, double low, double high )
       {
          const double range = high - low;
-         if ( 1 + range == 1 )
-            return;
-
-         const double s = (__PCL_MEDIAN_HISTOGRAM_LENGTH - 1)/range;
-         const __m256d S = _mm256_set1_pd( s );
-         const __m256d L = _mm256_set1_pd( low );
-         const size_type stepLength = 0x40000000u;
-
-         for ( size_type p = 0; p < N; p += stepLength )
-         {
-            const double* __restrict__ V = A + p;
-            const int n = int( pcl::Min( stepLength, N - p ) );
-            const int n4 = n >> 2;
-
-            if ( ((ptrdiff_t)V) & 31 )
-               for ( int i = 0; i < n4; ++i )
-               {
-                  __m256d v = _mm256_loadu_pd( (const double* __restrict__)(V + i*4) );
-                  __m128i K = _mm256_cvttpd_epi32( _mm256_mul_pd( _mm256_sub_pd( v, L ), S ) );
-                  for ( int j = 0; j < 4; ++j )
-                  {
-                     const int k = ((const int* __restrict__)&K)[j];
-                     if ( k >= 0 && k < __PCL_MEDIAN_HISTOGRAM_LENGTH )
-                        ++H[k];
-                  }
-               }
-            else
-               for ( int i = 0; i < n4; ++i )
-               {
-                  __m128i K = _mm256_cvttpd_epi32( _mm256_mul_pd( _mm256_sub_pd( ((const __m256d* __restrict__)V)[i], L ), S ) );
-                  for ( int j = 0; j < 4; ++j )
-                  {
-                     const int k = ((const int* __restrict__)&K)[j];
-                     if ( k >= 0 && k < __PCL_MEDIAN_HISTOGRAM_LENGTH )
-                        ++H[k];
-                  }
-               }
-
-            for ( int i = n4 << 2; i < n; ++i )
-            {
-               const int k = TruncInt( s * (V[i] - low) );
-               if ( k >= 0 && k < __PCL_MEDIAN_HISTOGRAM_LENGTH )
-                  ++H[k];
-            }
-         }
+         if ( 1 + range != 1 )
+            SIMD::Histogram( H.Begin(), __PCL_MEDIAN_HISTOGRAM_LENGTH, A, N,
+                             low, (__PCL_MEDIAN_HISTOGRAM_LENGTH - 1)/range );
       }
-
-#endif // __PCL_AVX2
    };
 
    // -------------------------------------------------------------------------
@@ -0,0 +1,421 @@
+//     ____   ______ __
+//    / __ \ / ____// /
+//   / /_/ // /    / /
+//  / ____// /___ / /___   PixInsight Class Library
+// /_/     \____//_____/   PCL 2.8.5
+// ----------------------------------------------------------------------------
+// pcl/ImageFilePrefetcher.h - Released 2024-12-28T16:53:48Z
+// ----------------------------------------------------------------------------
+// This file is part of the PixInsight Class Library (PCL).
+// PCL is a multiplatform C++ framework for development of PixInsight modules.
+//
+// Copyright (c) 2003-2024 Pleiades Astrophoto S.L. All Rights Reserved.
+//
+// Redistribution and use in both source and binary forms, with or without
+// modification, is permitted provided that the following conditions are met:
+//
+// 1. All redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//
+// 2. All redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//
+// 3. Neither the names "PixInsight" and "Pleiades Astrophoto", nor the names
+//    of their contributors, may be used to endorse or promote products derived
+//    from this software without specific prior written permission. For written
+//    permission, please contact info@pixinsight.com.
+//
+// 4. All products derived from this software, in any form whatsoever, must
+//    reproduce the following acknowledgment in the end-user documentation
+//    and/or other materials provided with the product:
+//
+//    "This product is based on software from the PixInsight project, developed
+//    by Pleiades Astrophoto and its contributors (https://pixinsight.com/)."
+//
+//    Alternatively, if that is where third-party acknowledgments normally
+//    appear, this acknowledgment must be reproduced in the product itself.
+//
+// THIS SOFTWARE IS PROVIDED BY PLEIADES ASTROPHOTO AND ITS CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED
+// TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+// PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL PLEIADES ASTROPHOTO OR ITS
+// CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, BUSINESS
+// INTERRUPTION; PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; AND LOSS OF USE,
+// DATA OR PROFITS) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+// ----------------------------------------------------------------------------
+
+#ifndef __PCL_ImageFilePrefetcher_h
+#define __PCL_ImageFilePrefetcher_h
+
+/// \file pcl/ImageFilePrefetcher.h
+
+#ifndef __PCL_BUILDING_PIXINSIGHT_APPLICATION
+
+#include <pcl/Defs.h>
+
+#include <pcl/AutoPointer.h>
+#include <pcl/FITSHeaderKeyword.h>
+#include <pcl/ImageDescription.h>
+#include <pcl/ImageVariant.h>
+#include <pcl/Property.h>
+#include <pcl/StringList.h>
+
+namespace pcl
+{
+
+// ----------------------------------------------------------------------------
+
+class PCL_CLASS ImageFilePrefetcherPrivate;
+
+// ----------------------------------------------------------------------------
+
+/*!
+ * \class ImageFilePrefetcher
+ * \brief Asynchronous reader of image files for sequential batch processes
+ *
+ * Batch processes usually open an image file, read the whole image and only
+ * then start working on it, so the processors remain idle while each file is
+ * being loaded and decoded. %ImageFilePrefetcher reads an ordered list of
+ * image files with a background thread, keeping up to PrefetchCount() images
+ * decoded ahead of the consumer, while the consumer is working on the
+ * previous images.
+ *
+ * Images are read with the standard FileFormat and FileFormatInstance
+ * interfaces, so any installed file format can be used without changes.
+ * Only the first image of each file is read. Before decoding a file, the
+ * reader advises the operating system that the next file in the list will
+ * be read soon (by calling posix_fadvise() with POSIX_FADV_WILLNEED on Linux
+ * and FreeBSD, or fcntl() with F_RDADVISE on macOS), so that the disk
+ * transfers of the next file overlap with decoding of the current one. This
+ * advice is not available on Windows, where only the decoding is performed
+ * in advance.
+ *
+ * Decoded images can be limited by a memory budget (see SetMemoryLimit()).
+ * The size of each image is computed from its description before reading
+ * its pixels, and the image is not decoded until it fits in the budget
+ * along with the images already waiting to be retrieved. One image is
+ * always read if no image is waiting, even if it exceeds the budget, so a
+ * prefetcher never stalls.
+ *
+ * Retrieved images are handed out by Next() as ImageVariant objects that
+ * own the images created by the reader, hence no pixel data are copied. If
+ * a file cannot be read, Next() throws the corresponding exception in the
+ * consumer's thread, and the next call to Next() returns the next file.
+ *
+ * Typical usage:
+ *
+ * \code
+ * ImageFilePrefetcher prefetcher( filePaths, inputHints );
+ * prefetcher.SetSampleFormat( 32, true ); // read all images as 32-bit float
+ * prefetcher.Start();
+ * while ( prefetcher.HasNext() )
+ * {
+ *    try
+ *    {
+ *       ImageFilePrefetcher::Item item = prefetcher.Next();
+ *       // ... process item.image
+ *    }
+ *    catch ( ... )
+ *    {
+ *       // ... apply the error policy of the process
+ *    }
+ * }
+ * \endcode
+ *
+ * The reader thread is started by Start(), or by the first call to Next(),
+ * and stopped by Stop() or by the destructor. Reading parameters must be set
+ * before starting the reader; changes made while the reader is running have
+ * no effect until the prefetcher is restarted. A %ImageFilePrefetcher object
+ * must be used by a single consumer thread.
+ *
+ * \sa FileFormat, FileFormatInstance
+ */
+class PCL_CLASS ImageFilePrefetcher
+{
+public:
+
+   /*!
+    * \struct pcl::ImageFilePrefetcher::Item
+    * \brief An image read by ImageFilePrefetcher, along with its metadata.
+    */
+   struct Item
+   {
+      String           filePath;           //!< Full path to the image file.
+      ImageVariant     image;              //!< The image read from the file.
+      ImageDescription description;        //!< Basic information and format-independent options of the image.
+      int              numberOfImages = 0; //!< Number of images in the file. Only the first image is read.
+      FITSKeywordArray keywords;           //!< FITS header keywords, if enabled and supported by the file format.
+      PropertyArray    properties;         //!< Image properties, if enabled and supported by the file format.
+   };
+
+   /*!
+    * Constructs a prefetcher for the specified list of image files, which
+    * will be read in the same order. The specified format \a hints will be
+    * used to open all files.
+    *
+    * The reader thread is not started by this constructor.
+    */
+   ImageFilePrefetcher( const StringList& filePaths, const IsoString& hints = IsoString() );
+
+   /*!
+    * Constructs a prefetcher with format hints specified as a UTF-16 string.
+    */
+   ImageFilePrefetcher( const StringList& filePaths, const IsoString::ustring_base& hints )
+      : ImageFilePrefetcher( filePaths, IsoString( hints ) )
+   {
+   }
+
+   /*!
+    * Copy constructor. This constructor is disabled because %ImageFilePrefetcher
+    * represents a unique running task.
+    */
+   ImageFilePrefetcher( const ImageFilePrefetcher& ) = delete;
+
+   /*!
+    * Copy assignment. This operator is disabled because %ImageFilePrefetcher
+    * represents a unique running task.
+    */
+   ImageFilePrefetcher& operator =( const ImageFilePrefetcher& ) = delete;
+
+   /*!
+    * Virtual destructor. Stops the reader thread and destroys all images not
+    * yet retrieved.
+    */
+   virtual ~ImageFilePrefetcher();
+
+   /*!
+    * Returns the list of image files read by this prefetcher.
+    */
+   const StringList& FilePaths() const
+   {
+      return m_filePaths;
+   }
+
+   /*!
+    * Returns the format hints used to open image files.
+    */
+   const IsoString& Hints() const
+   {
+      return m_hints;
+   }
+
+   /*!
+    * Returns the maximum number of decoded images that can be waiting to be
+    * retrieved, including the image being read. The default value is 2.
+    */
+   int PrefetchCount() const
+   {
+      return m_prefetchCount;
+   }
+
+   /*!
+    * Sets the maximum number of decoded images waiting to be retrieved. The
+    * specified value \a n is constrained to be &ge; 1.
+    */
+   void SetPrefetchCount( int n )
+   {
+      m_prefetchCount = Max( 1, n );
+   }
+
+   /*!
+    * Returns the maximum amount of memory in bytes that can be used by
+    * decoded images waiting to be retrieved, or zero if there is no memory
+    * limit. The default value is zero.
+    *
+    * Images already retrieved by the consumer are not accounted for.
+    */
+   size_type MemoryLimit() const
+   {
+      return m_memoryLimit;
+   }
+
+   /*!
+    * Sets the maximum amount of memory in bytes that can be used by decoded
+    * images waiting to be retrieved. Specify zero to disable the memory
+    * limit.
+    */
+   void SetMemoryLimit( size_type bytes )
+   {
+      m_memoryLimit = bytes;
+   }
+
+   /*!
+    * Returns the number of bits per sample of the images read, or zero if
+    * images are read in their native sample data types, as stored in the
+    * files. The default value is zero.
+    */
+   int BitsPerSample() const
+   {
+      return m_bitsPerSample;
+   }
+
+   /*!
+    * Returns true iff images are read in a floating point sample data type.
+    * This is only meaningful when BitsPerSample() is nonzero.
+    */
+   bool IsFloatSample() const
+   {
+      return m_floatSample;
+   }
+
+   /*!
+    * Sets the sample data type of the images read. Images will be converted
+    * to real samples of the specified size (32 or 64 bits) if \a floatSample
+    * is true, or to unsigned integer samples (8, 16 or 32 bits) otherwise.
+    * If \a bitsPerSample is zero, images will be read in their native sample
+    * data types.
+    */
+   void SetSampleFormat( int bitsPerSample, bool floatSample = true )
+   {
+      m_bitsPerSample = bitsPerSample;
+      m_floatSample = floatSample;
+   }
+
+   /*!
+    * Returns true iff images are created as shared images, that is, images
+    * allocated by the core application. The default value is false.
+    */
+   bool IsSharedImages() const
+   {
+      return m_sharedImages;
+   }
+
+   /*!
+    * Enables or disables the creation of shared images.
+    */
+   void SetSharedImages( bool enable = true )
+   {
+      m_sharedImages = enable;
+   }
+
+   /*!
+    * Returns true iff FITS header keywords are read along with the images.
+    * The default value is true.
+    */
+   bool IsKeywordsEnabled() const
+   {
+      return m_readKeywords;
+   }
+
+   /*!
+    * Enables or disables reading FITS header keywords.
+    */
+   void EnableKeywords( bool enable = true )
+   {
+      m_readKeywords = enable;
+   }
+
+   /*!
+    * Returns true iff image properties are read along with the images. The
+    * default value is true.
+    */
+   bool IsPropertiesEnabled() const
+   {
+      return m_readProperties;
+   }
+
+   /*!
+    * Enables or disables reading image properties.
+    */
+   void EnableProperties( bool enable = true )
+   {
+      m_readProperties = enable;
+   }
+
+   /*!
+    * Starts the reader thread. Has no effect if the reader is already
+    * running. If the prefetcher has been stopped, reading continues with the
+    * first file not yet retrieved.
+    */
+   void Start();
+
+   /*!
+    * Stops the reader thread and destroys all images not yet retrieved. If
+    * the reader is decoding an image, this function waits until the current
+    * file has been read.
+    */
+   void Stop();
+
+   /*!
+    * Returns true iff the prefetcher has been started and has not been
+    * stopped. Note that the reader thread terminates once the last file has
+    * been read, but the prefetcher remains running until all images have been
+    * retrieved or Stop() is called.
+    */
+   bool IsRunning() const;
+
+   /*!
+    * Returns true iff there are images still to be retrieved with Next().
+    */
+   bool HasNext() const
+   {
+      return m_next < m_filePaths.Length();
+   }
+
+   /*!
+    * Returns the index in the list of files of the next image that will be
+    * retrieved with Next().
+    */
+   size_type NextIndex() const
+   {
+      return m_next;
+   }
+
+   /*!
+    * Waits until the next image is available for retrieval, or until the
+    * specified time \a ms in milliseconds has elapsed. Returns true if the
+    * next image is available, or if there are no more images to retrieve.
+    *
+    * This function does not start the reader thread.
+    */
+   bool WaitNext( unsigned ms );
+
+   /*!
+    * Returns the next image in the list of files, waiting for the reader
+    * thread to finish decoding it if necessary. The reader thread is started
+    * if it is not running.
+    *
+    * When called from the root thread, this function processes pending
+    * events, excluding user input events, while waiting.
+    *
+    * Console output generated by the file format while reading the image is
+    * written to the console before returning. If the file could not be read,
+    * the error is thrown as an exception. In all cases, the next call to this
+    * function will return the next image in the list.
+    *
+    * Throws an Error exception if there are no more images to retrieve.
+    */
+   Item Next();
+
+private:
+
+   StringList                             m_filePaths;
+   IsoString                              m_hints;
+   int                                    m_prefetchCount = 2;
+   size_type                              m_memoryLimit = 0;
+   int                                    m_bitsPerSample = 0;
+   bool                                   m_floatSample = true;
+   bool                                   m_sharedImages = false;
+   bool                                   m_readKeywords = true;
+   bool                                   m_readProperties = true;
+   size_type                              m_next = 0;
+   AutoPointer<ImageFilePrefetcherPrivate> m_data;
+
+   friend class ImageFilePrefetcherPrivate;
+};
+
+// ----------------------------------------------------------------------------
+
+} // pcl
+
+#endif   // __PCL_BUILDING_PIXINSIGHT_APPLICATION
+
+#endif   // __PCL_ImageFilePrefetcher_h
+
+// ----------------------------------------------------------------------------
+// EOF pcl/ImageFilePrefetcher.h - Released 2024-12-28T16:53:48Z
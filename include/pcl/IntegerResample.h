@@ -62,6 +62,9 @@
 namespace pcl
 {
 
+class PCL_CLASS FileFormatInstance;
+class PCL_CLASS ImageInfo;
+
 // ----------------------------------------------------------------------------
 
 /*!
@@ -198,6 +201,89 @@ public:
       return true;
    }
 
+   /*!
+    * Reads the current image in an image \a file and resamples it with this
+    * object.
+    *
+    * \param file   A file format instance open for reading. The image to be
+    *               read must be selected in this instance.
+    *
+    * \param info   Geometry and color space of the image being read, as
+    *               provided by FileFormatInstance::Open().
+    *
+    * \param[out] image   The image where the resampled data will be stored.
+    *
+    * When this object performs a downsampling operation and the file format
+    * instance supports incremental reads (see
+    * FileFormatInstance::CanReadIncrementally()), source pixel rows are read
+    * and downsampled in successive strips of limited size, so the
+    * full-resolution image never has to be stored in memory. This is the
+    * fastest and most memory-efficient way to generate binned versions of
+    * large images stored in files. Otherwise the whole image is read and then
+    * resampled in memory.
+    *
+    * The result is identical to reading the full image and applying this
+    * transformation to it. Returns true if the image was successfully read;
+    * false in the event of file read error.
+    */
+   bool ReadImage( FileFormatInstance& file, const ImageInfo& info, pcl::Image& image ) const;
+
+   /*!
+    * Reads and resamples an image in 64-bit floating point format. See
+    * ReadImage( FileFormatInstance&, const ImageInfo&, Image& ) for a full
+    * description.
+    */
+   bool ReadImage( FileFormatInstance& file, const ImageInfo& info, pcl::DImage& image ) const;
+
+   /*!
+    * Reads and resamples an image in 8-bit unsigned integer format. See
+    * ReadImage( FileFormatInstance&, const ImageInfo&, Image& ) for a full
+    * description.
+    */
+   bool ReadImage( FileFormatInstance& file, const ImageInfo& info, pcl::UInt8Image& image ) const;
+
+   /*!
+    * Reads and resamples an image in 16-bit unsigned integer format. See
+    * ReadImage( FileFormatInstance&, const ImageInfo&, Image& ) for a full
+    * description.
+    */
+   bool ReadImage( FileFormatInstance& file, const ImageInfo& info, pcl::UInt16Image& image ) const;
+
+   /*!
+    * Reads and resamples an image in 32-bit unsigned integer format. See
+    * ReadImage( FileFormatInstance&, const ImageInfo&, Image& ) for a full
+    * description.
+    */
+   bool ReadImage( FileFormatInstance& file, const ImageInfo& info, pcl::UInt32Image& image ) const;
+
+   /*!
+    * Reads and resamples an image transported by an ImageVariant object. See
+    * ReadImage( FileFormatInstance&, const ImageInfo&, Image& ) for a full
+    * description.
+    *
+    * Returns true iff the ImageVariant object transports a valid real or
+    * integer image and the image was successfully read.
+    */
+   bool ReadImage( FileFormatInstance& file, const ImageInfo& info, ImageVariant& image ) const
+   {
+      if ( image )
+         if ( !image.IsComplexSample() )
+            if ( image.IsFloatSample() )
+               switch ( image.BitsPerSample() )
+               {
+               case 32: return ReadImage( file, info, static_cast<pcl::Image&>( *image ) );
+               case 64: return ReadImage( file, info, static_cast<pcl::DImage&>( *image ) );
+               }
+            else
+               switch ( image.BitsPerSample() )
+               {
+               case  8: return ReadImage( file, info, static_cast<pcl::UInt8Image&>( *image ) );
+               case 16: return ReadImage( file, info, static_cast<pcl::UInt16Image&>( *image ) );
+               case 32: return ReadImage( file, info, static_cast<pcl::UInt32Image&>( *image ) );
+               }
+      return false;
+   }
+
 protected:
 
    /*
@@ -0,0 +1,240 @@
+//     ____   ______ __
+//    / __ \ / ____// /
+//   / /_/ // /    / /
+//  / ____// /___ / /___   PixInsight Class Library
+// /_/     \____//_____/   PCL 2.8.5
+// ----------------------------------------------------------------------------
+// pcl/MeasurementContext.h - Released 2024-12-28T16:53:48Z
+// ----------------------------------------------------------------------------
+// This file is part of the PixInsight Class Library (PCL).
+// PCL is a multiplatform C++ framework for development of PixInsight modules.
+//
+// Copyright (c) 2003-2024 Pleiades Astrophoto S.L. All Rights Reserved.
+//
+// Redistribution and use in both source and binary forms, with or without
+// modification, is permitted provided that the following conditions are met:
+//
+// 1. All redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//
+// 2. All redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//
+// 3. Neither the names "PixInsight" and "Pleiades Astrophoto", nor the names
+//    of their contributors, may be used to endorse or promote products derived
+//    from this software without specific prior written permission. For written
+//    permission, please contact info@pixinsight.com.
+//
+// 4. All products derived from this software, in any form whatsoever, must
+//    reproduce the following acknowledgment in the end-user documentation
+//    and/or other materials provided with the product:
+//
+//    "This product is based on software from the PixInsight project, developed
+//    by Pleiades Astrophoto and its contributors (https://pixinsight.com/)."
+//
+//    Alternatively, if that is where third-party acknowledgments normally
+//    appear, this acknowledgment must be reproduced in the product itself.
+//
+// THIS SOFTWARE IS PROVIDED BY PLEIADES ASTROPHOTO AND ITS CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED
+// TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+// PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL PLEIADES ASTROPHOTO OR ITS
+// CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, BUSINESS
+// INTERRUPTION; PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; AND LOSS OF USE,
+// DATA OR PROFITS) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+// ----------------------------------------------------------------------------
+
+#ifndef __PCL_MeasurementContext_h
+#define __PCL_MeasurementContext_h
+
+/// \file pcl/MeasurementContext.h
+
+#include <pcl/Defs.h>
+
+#include <pcl/Image.h>
+#include <pcl/ImageVariant.h>
+#include <pcl/PSFFit.h>
+#include <pcl/ReferenceArray.h>
+#include <pcl/StarDetector.h>
+
+namespace pcl
+{
+
+// ----------------------------------------------------------------------------
+
+/*!
+ * \class MeasurementContext
+ * \brief Per-image cache of intermediate star detection and PSF photometry data
+ *
+ * A %MeasurementContext object stores intermediate results generated while
+ * measuring a single image, so that several measurement tools working on the
+ * same image can share them instead of recomputing them:
+ *
+ * \li Working images used for star detection: the intensity component or
+ * selected channel of the measured image and its noise-reduced version.
+ *
+ * \li Star detection structure maps and local maxima maps, which are by far
+ * the most expensive stages of star detection. Structure maps only depend on
+ * the image and a few preprocessing parameters (see
+ * StarDetector::StructureLayers(), StarDetector::NoiseLayers(),
+ * StarDetector::HotPixelFilterRadius(), StarDetector::NoiseReductionFilterRadius()),
+ * so they can be shared by star detectors with different detection criteria.
+ *
+ * \li Lists of detected stars and fitted PSFs, which are reused when the same
+ * parameters are applied to the same image.
+ *
+ * \li The M* and N* robust estimates of PSFSignalEstimator, stored as named
+ * scalar values. Other tools can store their own statistics with
+ * SetStatistic().
+ *
+ * The StarDetector::DetectStars(), PSFEstimator::FitStars() and
+ * PSFSignalEstimator::EstimateSignal() member functions have overloaded
+ * versions accepting a %MeasurementContext object, which produce exactly the
+ * same results as their context-free counterparts.
+ *
+ * A measurement context is bound to the first image it is used with. If it is
+ * used with a different image, or if the geometry of the image changes (for
+ * example after a crop operation), all cached data are discarded
+ * automatically. However, modifications of pixel data cannot be detected:
+ * Clear() must be called explicitly if the measured image is modified in
+ * place without changing its geometry.
+ *
+ * \note %MeasurementContext is not thread-safe. A measurement context should
+ * be used by a single thread, typically to measure a single image.
+ *
+ * \sa StarDetector, PSFEstimator, PSFSignalEstimator
+ */
+class PCL_CLASS MeasurementContext
+{
+public:
+
+   /*!
+    * Default constructor. Constructs an empty measurement context.
+    */
+   MeasurementContext() = default;
+
+   /*!
+    * Copy constructor. This constructor is disabled because measurement
+    * contexts are unique objects.
+    */
+   MeasurementContext( const MeasurementContext& ) = delete;
+
+   /*!
+    * Copy assignment. This operator is disabled because measurement contexts
+    * are unique objects.
+    */
+   MeasurementContext& operator =( const MeasurementContext& ) = delete;
+
+   /*!
+    * Destroys a %MeasurementContext object and all cached data.
+    */
+   virtual ~MeasurementContext()
+   {
+      Clear();
+   }
+
+   /*!
+    * Discards all cached data and unbinds this context from its current
+    * image.
+    */
+   void Clear();
+
+   /*!
+    * Returns true iff this context contains no cached data.
+    */
+   bool IsEmpty() const
+   {
+      return m_images.IsEmpty() && m_stars.IsEmpty() && m_psfs.IsEmpty() && m_statistics.IsEmpty();
+   }
+
+   /*!
+    * Returns the approximate amount of memory in bytes used by the images
+    * cached in this context.
+    */
+   size_type ImageMemorySize() const;
+
+   /*!
+    * Retrieves a named scalar statistic. Returns true and assigns the cached
+    * value to \a value if a statistic with the specified \a key exists for the
+    * specified \a image; returns false otherwise.
+    *
+    * Keys are arbitrary strings. By convention, they should start with the
+    * name of the class or process that generates the statistic, followed by a
+    * colon, followed by a list of the parameters used for its calculation;
+    * for example, "PSFSignalEstimator:MStar:256".
+    */
+   bool GetStatistic( const ImageVariant& image, const IsoString& key, double& value );
+
+   /*!
+    * Stores a named scalar statistic for the specified \a image. If a
+    * statistic with the same \a key already exists, its value is replaced.
+    */
+   void SetStatistic( const ImageVariant& image, const IsoString& key, double value );
+
+private:
+
+   struct ImageItem
+   {
+      IsoString key;
+      Image     image;
+   };
+
+   struct StarListItem
+   {
+      IsoString               key;
+      StarDetector::star_list stars;
+      int                     minStarSize = 0;
+   };
+
+   struct PSFListItem
+   {
+      IsoString      key;
+      Array<PSFData> psfs;
+   };
+
+   struct StatisticItem
+   {
+      IsoString key;
+      double    value = 0;
+   };
+
+   IsoString                    m_imageKey;
+   IsoString                    m_detectionKey; // key of the last star detection performed
+   ReferenceArray<ImageItem>    m_images;
+   Array<StarListItem>          m_stars;
+   Array<PSFListItem>           m_psfs;
+   Array<StatisticItem>         m_statistics;
+
+   /*
+    * Binds this context to the specified image, discarding all cached data if
+    * a different image or image geometry is detected.
+    */
+   void Bind( const ImageVariant& image );
+
+   Image* FindImage( const IsoString& key );
+   Image& AddImage( const IsoString& key );
+
+   const StarListItem* FindStars( const IsoString& key ) const;
+   void AddStars( const IsoString& key, const StarDetector::star_list& stars, int minStarSize );
+
+   const Array<PSFData>* FindPSFs( const IsoString& key ) const;
+   void AddPSFs( const IsoString& key, const Array<PSFData>& psfs );
+
+   friend class StarDetector;
+   friend class PSFEstimator;
+   friend class PSFSignalEstimator;
+};
+
+// ----------------------------------------------------------------------------
+
+} // pcl
+
+#endif   // __PCL_MeasurementContext_h
+
+// ----------------------------------------------------------------------------
+// EOF pcl/MeasurementContext.h - Released 2024-12-28T16:53:48Z
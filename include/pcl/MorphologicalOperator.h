@@ -60,6 +60,7 @@
 #include <pcl/Exception.h>
 #include <pcl/Math.h>
 #include <pcl/PixelTraits.h>
+#include <pcl/SIMDDispatch.h>
 #include <pcl/Selection.h>
 #include <pcl/Sort.h>
 #include <pcl/String.h>
@@ -185,6 +186,16 @@ public:
    {
       throw NotImplemented( *this, "Apply to 32-bit integer images" );
    }
+
+protected:
+
+   /*
+    * Minimum number of neighborhood values that justifies the use of a
+    * dispatched SIMD kernel. Operators are applied once per pixel; for small
+    * structuring elements, such as the usual 3x3 and 5x5 patterns, inline
+    * scalar loops are faster than an out-of-line kernel call.
+    */
+   static constexpr size_type s_simdKernelThreshold = 64;
 };
 
 // ----------------------------------------------------------------------------
@@ -271,85 +282,19 @@ private:
       return x;
    }
 
-#ifdef __PCL_AVX2
-
    static float Operate( float* __restrict__ f, size_type n )
    {
-      if ( unlikely( n < 8 ) )
-      {
-         float min = f[0];
-         for ( size_type i = 1; i < n; ++i )
-            if ( f[i] < min )
-               min = f[i];
-         return min;
-      }
-
-      __m256 vmin;
-      const size_type n8 = n >> 3;
-      if ( unlikely( ((ptrdiff_t)f) & 31 ) )
-      {
-         vmin = _mm256_loadu_ps( f );
-         for ( size_type i = 1; i < n8; ++i )
-            vmin = _mm256_min_ps( vmin, _mm256_loadu_ps( (const float* __restrict__)(f + i*8) ) );
-      }
-      else
-      {
-         vmin = _mm256_load_ps( f );
-         for ( size_type i = 1; i < n8; ++i )
-            vmin = _mm256_min_ps( vmin, ((const __m256* __restrict__)f)[i] );
-      }
-      float min = ((const float* __restrict__)&vmin)[0];
-      for ( int i = 1; i < 8; ++i )
-      {
-         float vn = ((const float* __restrict__)&vmin)[i];
-         if ( vn < min )
-            min = vn;
-      }
-      for ( size_type i = n8 << 3; i < n; ++i )
-         if ( f[i] < min )
-            min = f[i];
-      return min;
+      if ( n < s_simdKernelThreshold )
+         return Operate<float>( f, n );
+      return SIMD::Min( f, n );
    }
 
    static double Operate( double* __restrict__ f, size_type n )
    {
-      if ( unlikely( n < 4 ) )
-      {
-         double min = f[0];
-         for ( size_type i = 1; i < n; ++i )
-            if ( f[i] < min )
-               min = f[i];
-         return min;
-      }
-
-      __m256d vmin;
-      const size_type n4 = n >> 2;
-      if ( unlikely( ((ptrdiff_t)f) & 31 ) )
-      {
-         vmin = _mm256_loadu_pd( f );
-         for ( size_type i = 1; i < n4; ++i )
-            vmin = _mm256_min_pd( vmin, _mm256_loadu_pd( (const double* __restrict__)(f + i*4) ) );
-      }
-      else
-      {
-         vmin = _mm256_load_pd( f );
-         for ( size_type i = 1; i < n4; ++i )
-            vmin = _mm256_min_pd( vmin, ((const __m256d* __restrict__)f)[i] );
-      }
-      double min = ((const double* __restrict__)&vmin)[0];
-      for ( int i = 1; i < 4; ++i )
-      {
-         double vn = ((const double* __restrict__)&vmin)[i];
-         if ( vn < min )
-            min = vn;
-      }
-      for ( size_type i = n4 << 2; i < n; ++i )
-         if ( f[i] < min )
-            min = f[i];
-      return min;
+      if ( n < s_simdKernelThreshold )
+         return Operate<double>( f, n );
+      return SIMD::Min( f, n );
    }
-
-#endif
 };
 
 // ----------------------------------------------------------------------------
@@ -443,85 +388,19 @@ private:
       return x;
    }
 
-#ifdef __PCL_AVX2
-
    static float Operate( float* __restrict__ f, size_type n )
    {
-      if ( unlikely( n < 8 ) )
-      {
-         float max = f[0];
-         for ( size_type i = 1; i < n; ++i )
-            if ( f[i] > max )
-               max = f[i];
-         return max;
-      }
-
-      __m256 vmax;
-      const size_type n8 = n >> 3;
-      if ( unlikely( ((ptrdiff_t)f) & 31 ) )
-      {
-         vmax = _mm256_loadu_ps( f );
-         for ( size_type i = 1; i < n8; ++i )
-            vmax = _mm256_max_ps( vmax, _mm256_loadu_ps( (const float* __restrict__)(f + i*8) ) );
-      }
-      else
-      {
-         vmax = _mm256_load_ps( f );
-         for ( size_type i = 1; i < n8; ++i )
-            vmax = _mm256_max_ps( vmax, ((const __m256* __restrict__)f)[i] );
-      }
-      float max = ((const float* __restrict__)&vmax)[0];
-      for ( int i = 1; i < 8; ++i )
-      {
-         float vn = ((const float* __restrict__)&vmax)[i];
-         if ( vn > max )
-            max = vn;
-      }
-      for ( size_type i = n8 << 3; i < n; ++i )
-         if ( f[i] > max )
-            max = f[i];
-      return max;
+      if ( n < s_simdKernelThreshold )
+         return Operate<float>( f, n );
+      return SIMD::Max( f, n );
    }
 
    static double Operate( double* __restrict__ f, size_type n )
    {
-      if ( unlikely( n < 4 ) )
-      {
-         double max = f[0];
-         for ( size_type i = 1; i < n; ++i )
-            if ( f[i] > max )
-               max = f[i];
-         return max;
-      }
-
-      __m256d vmax;
-      const size_type n4 = n >> 2;
-      if ( unlikely( ((ptrdiff_t)f) & 31 ) )
-      {
-         vmax = _mm256_loadu_pd( f );
-         for ( size_type i = 1; i < n4; ++i )
-            vmax = _mm256_max_pd( vmax, _mm256_loadu_pd( (const double* __restrict__)(f + i*4) ) );
-      }
-      else
-      {
-         vmax = _mm256_load_pd( f );
-         for ( size_type i = 1; i < n4; ++i )
-            vmax = _mm256_max_pd( vmax, ((const __m256d* __restrict__)f)[i] );
-      }
-      double max = ((const double* __restrict__)&vmax)[0];
-      for ( int i = 1; i < 4; ++i )
-      {
-         double vn = ((const double* __restrict__)&vmax)[i];
-         if ( vn > max )
-            max = vn;
-      }
-      for ( size_type i = n4 << 2; i < n; ++i )
-         if ( f[i] > max )
-            max = f[i];
-      return max;
+      if ( n < s_simdKernelThreshold )
+         return Operate<double>( f, n );
+      return SIMD::Max( f, n );
    }
-
-#endif
 };
 
 // ----------------------------------------------------------------------------
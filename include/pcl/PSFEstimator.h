@@ -62,6 +62,8 @@
 namespace pcl
 {
 
+class PCL_CLASS MeasurementContext;
+
 // ----------------------------------------------------------------------------
 
 /*!
@@ -377,6 +379,24 @@ public:
     */
    Array<PSFData> FitStars( const ImageVariant& image ) const;
 
+   /*!
+    * Performs star detection, PSF fitting and signal evaluation for the
+    * specified \a image, using and updating the intermediate data cached in
+    * the specified measurement \a context. Returns a list of PSFData
+    * structures for all valid PSF fits performed.
+    *
+    * The result is identical to FitStars( const ImageVariant& ). Star
+    * detection reuses the structure maps available in the \a context (see
+    * StarDetector::DetectStars( const ImageVariant&, MeasurementContext& )),
+    * and if the same star detection and PSF fitting parameters have already
+    * been applied to the same image, the cached list of PSF fits is returned
+    * without performing any PSF fitting work.
+    *
+    * \note This function is thread-safe as long as the \a context is not
+    * used concurrently by other threads. See MeasurementContext.
+    */
+   Array<PSFData> FitStars( const ImageVariant& image, MeasurementContext& context ) const;
+
 protected:
 
    mutable pcl::StarDetector m_starDetector;
@@ -388,6 +408,10 @@ protected:
            float             m_growthForFlux = 1.0F;
            int               m_maxStars = 0;
            bool              m_weighted = false;
+
+private:
+
+   Array<PSFData> FitStars( const ImageVariant& image, MeasurementContext* context ) const;
 };
 
 // ----------------------------------------------------------------------------
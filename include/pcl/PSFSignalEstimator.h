@@ -180,6 +180,24 @@ public:
     */
    Estimates EstimateSignal( const ImageVariant& image ) const;
 
+   /*!
+    * Evaluates the total and mean PSF flux and square flux, along with the M*
+    * and N* estimates of mean background level and noise standard deviation,
+    * for the selected channel of the specified \a image, using and updating
+    * the intermediate data cached in the specified measurement \a context.
+    *
+    * The result is identical to EstimateSignal( const ImageVariant& ). Star
+    * detection and PSF fitting data are shared through the \a context as
+    * described for PSFEstimator::FitStars( const ImageVariant&,
+    * MeasurementContext& ), and the M* and N* estimates are stored in the
+    * \a context, so the multiscale median transform required to compute them
+    * is performed only once for each background model scale.
+    *
+    * \note This function is thread-safe as long as the \a context is not
+    * used concurrently by other threads. See MeasurementContext.
+    */
+   Estimates EstimateSignal( const ImageVariant& image, MeasurementContext& context ) const;
+
    /*!
     * Evaluates the total and mean PSF flux and square flux, along with the M*
     * and N* estimates of mean background level and noise standard deviation,
@@ -321,6 +339,8 @@ public:
 private:
 
    int m_scale = 256;
+
+   Estimates EstimateSignal( const ImageVariant& image, MeasurementContext* context ) const;
 };
 
 // ----------------------------------------------------------------------------
@@ -1322,6 +1322,312 @@ public:
       return (x > 0.0031308) ? 1.055*Pow( x, sample( 1/2.4 ) ) - 0.055 : 12.92*x;
    }
 
+   /*!
+    * Converts a sequence of nonlinear RGB channel values to linear values
+    * in-place, by applying the gamma function of this RGB working space.
+    *
+    * \param[in,out] x  Pointer to the first element of the sequence.
+    *
+    * \param n          Number of elements in the sequence.
+    *
+    * This function and the rest of <em>batch conversion functions</em>
+    * defined by this class operate on planar arrays of 32-bit floating point
+    * values in the normalized [0,1] range. Batch conversions are runtime
+    * dispatched SIMD kernels (see SIMDKernel). On processors supporting AVX2
+    * they use vectorized implementations of the logarithmic and exponential
+    * functions with relative errors below 1e-6, which is well below the
+    * resolution of a 16-bit integer sample; otherwise portable code is
+    * executed. In all cases results are equivalent to the corresponding
+    * single-pixel conversion functions within 32-bit floating point accuracy.
+    */
+   void LinearRGB( float* x, size_type n ) const;
+
+   /*!
+    * Converts a sequence of linear RGB channel values to nonlinear values
+    * in-place, by applying the inverse gamma function of this RGB working
+    * space. This is the inverse of LinearRGB( float*, size_type ).
+    */
+   void GammaRGB( float* x, size_type n ) const;
+
+   /*!
+    * Returns a lookup table of linear RGB values for all integer sample values
+    * in the range [0,2^bits-1], where \a bits must be in the range [1,16].
+    *
+    * The returned table can be used with the
+    * LinearRGB( float*, const uint16*, size_type, const FVector& ) function
+    * to perform fast gamma linearization of 8-bit and 16-bit integer images.
+    */
+   FVector LinearRGBTable( int bits ) const;
+
+   /*!
+    * Converts a sequence of 8-bit integer RGB channel values to normalized
+    * linear floating point values.
+    *
+    * \param[out] y  Pointer to the first element of the output sequence.
+    *
+    * \param x       Pointer to the first element of the input sequence.
+    *
+    * \param n       Number of elements in the input and output sequences.
+    */
+   void LinearRGB( float* y, const uint8* x, size_type n ) const;
+
+   /*!
+    * Converts a sequence of 16-bit integer RGB channel values to normalized
+    * linear floating point values.
+    *
+    * \param[out] y  Pointer to the first element of the output sequence.
+    *
+    * \param x       Pointer to the first element of the input sequence.
+    *
+    * \param n       Number of elements in the input and output sequences.
+    *
+    * For long sequences, a temporary lookup table is generated automatically.
+    * To convert many short sequences, generate a lookup table with
+    * LinearRGBTable() and call
+    * LinearRGB( float*, const uint16*, size_type, const FVector& ).
+    */
+   void LinearRGB( float* y, const uint16* x, size_type n ) const;
+
+   /*!
+    * Converts a sequence of integer RGB channel values to normalized linear
+    * floating point values using a precomputed lookup table.
+    *
+    * \param[out] y  Pointer to the first element of the output sequence.
+    *
+    * \param x       Pointer to the first element of the input sequence.
+    *
+    * \param n       Number of elements in the input and output sequences.
+    *
+    * \param table   A lookup table generated by LinearRGBTable() for the
+    *                number of bits of the input sample values.
+    */
+   void LinearRGB( float* y, const uint16* x, size_type n, const FVector& table ) const;
+
+   /*!
+    * Batch conversion from RGB to CIE XYZ.
+    *
+    * \param[out] X,Y,Z    Pointers to the output arrays of normalized CIE XYZ
+    *                      components.
+    *
+    * \param R,G,B         Pointers to the input arrays of normalized RGB
+    *                      components.
+    *
+    * \param n             Number of elements in all input and output arrays.
+    *
+    * Output arrays can be the same as input arrays for in-place conversion.
+    */
+   void RGBToCIEXYZ( float* X, float* Y, float* Z, const float* R, const float* G, const float* B, size_type n ) const;
+
+   /*!
+    * Batch conversion from linear RGB to CIE XYZ. Input RGB components must
+    * have been linearized previously, for example with LinearRGB(). This is
+    * useful to convert integer images with a precomputed lookup table.
+    *
+    * Output arrays can be the same as input arrays for in-place conversion.
+    */
+   void LinearRGBToCIEXYZ( float* X, float* Y, float* Z, const float* R, const float* G, const float* B, size_type n ) const;
+
+   /*!
+    * Batch conversion from CIE XYZ to RGB.
+    *
+    * \param[out] R,G,B    Pointers to the output arrays of normalized RGB
+    *                      components.
+    *
+    * \param X,Y,Z         Pointers to the input arrays of normalized CIE XYZ
+    *                      components.
+    *
+    * \param n             Number of elements in all input and output arrays.
+    *
+    * Output arrays can be the same as input arrays for in-place conversion.
+    */
+   void CIEXYZToRGB( float* R, float* G, float* B, const float* X, const float* Y, const float* Z, size_type n ) const;
+
+   /*!
+    * Batch calculation of CIE Y components (luminance).
+    *
+    * \param[out] Y        Pointer to the output array of normalized CIE Y
+    *                      components.
+    *
+    * \param R,G,B         Pointers to the input arrays of normalized RGB
+    *                      components.
+    *
+    * \param n             Number of elements in all input and output arrays.
+    */
+   void RGBToCIEY( float* Y, const float* R, const float* G, const float* B, size_type n ) const;
+
+   /*!
+    * Batch calculation of CIE L* components (lightness).
+    *
+    * \param[out] L        Pointer to the output array of normalized CIE L*
+    *                      components.
+    *
+    * \param R,G,B         Pointers to the input arrays of normalized RGB
+    *                      components.
+    *
+    * \param n             Number of elements in all input and output arrays.
+    */
+   void RGBToCIEL( float* L, const float* R, const float* G, const float* B, size_type n ) const;
+
+   /*!
+    * Batch conversion from RGB to CIE L*a*b*.
+    *
+    * \param[out] L,a,b    Pointers to the output arrays of normalized
+    *                      CIE L*a*b* components.
+    *
+    * \param R,G,B         Pointers to the input arrays of normalized RGB
+    *                      components.
+    *
+    * \param n             Number of elements in all input and output arrays.
+    *
+    * Output arrays can be the same as input arrays for in-place conversion.
+    */
+   void RGBToCIELab( float* L, float* a, float* b, const float* R, const float* G, const float* B, size_type n ) const;
+
+   /*!
+    * Batch conversion from linear RGB to CIE L*a*b*. Input RGB components must
+    * have been linearized previously, for example with LinearRGB().
+    *
+    * Output arrays can be the same as input arrays for in-place conversion.
+    */
+   void LinearRGBToCIELab( float* L, float* a, float* b, const float* R, const float* G, const float* B, size_type n ) const;
+
+   /*!
+    * Batch conversion from CIE L*a*b* to RGB.
+    *
+    * \param[out] R,G,B    Pointers to the output arrays of normalized RGB
+    *                      components.
+    *
+    * \param L,a,b         Pointers to the input arrays of normalized
+    *                      CIE L*a*b* components.
+    *
+    * \param n             Number of elements in all input and output arrays.
+    *
+    * Output arrays can be the same as input arrays for in-place conversion.
+    */
+   void CIELabToRGB( float* R, float* G, float* B, const float* L, const float* a, const float* b, size_type n ) const;
+
+   /*!
+    * Batch conversion from RGB to CIE L*c*h*.
+    *
+    * \param[out] L,c,h    Pointers to the output arrays of normalized
+    *                      CIE L*c*h* components.
+    *
+    * \param R,G,B         Pointers to the input arrays of normalized RGB
+    *                      components.
+    *
+    * \param n             Number of elements in all input and output arrays.
+    *
+    * Output arrays can be the same as input arrays for in-place conversion.
+    */
+   void RGBToCIELch( float* L, float* c, float* h, const float* R, const float* G, const float* B, size_type n ) const;
+
+   /*!
+    * Batch conversion from CIE L*c*h* to RGB.
+    *
+    * \param[out] R,G,B    Pointers to the output arrays of normalized RGB
+    *                      components.
+    *
+    * \param L,c,h         Pointers to the input arrays of normalized
+    *                      CIE L*c*h* components.
+    *
+    * \param n             Number of elements in all input and output arrays.
+    *
+    * Output arrays can be the same as input arrays for in-place conversion.
+    */
+   void CIELchToRGB( float* R, float* G, float* B, const float* L, const float* c, const float* h, size_type n ) const;
+
+   /*!
+    * Batch conversion from RGB to the HSV color ordering system.
+    *
+    * \param[out] H,S,V    Pointers to the output arrays of HSV channel
+    *                      values. Hue values are normalized to [0,1).
+    *
+    * \param R,G,B         Pointers to the input arrays of normalized RGB
+    *                      components.
+    *
+    * \param n             Number of elements in all input and output arrays.
+    *
+    * Output arrays can be the same as input arrays for in-place conversion.
+    */
+   static void RGBToHSV( float* H, float* S, float* V, const float* R, const float* G, const float* B, size_type n );
+
+   /*!
+    * Batch conversion from RGB to the HSI color ordering system. See
+    * RGBToHSV( float*, float*, float*, const float*, const float*, const float*, size_type )
+    * for a description of function parameters.
+    */
+   static void RGBToHSI( float* H, float* S, float* I, const float* R, const float* G, const float* B, size_type n );
+
+   /*!
+    * Batch conversion from the HSV color ordering system to RGB.
+    *
+    * \param[out] R,G,B    Pointers to the output arrays of normalized RGB
+    *                      components.
+    *
+    * \param H,S,V         Pointers to the input arrays of HSV channel values.
+    *                      Hue values must be normalized to [0,1).
+    *
+    * \param n             Number of elements in all input and output arrays.
+    *
+    * Output arrays can be the same as input arrays for in-place conversion.
+    */
+   static void HSVToRGB( float* R, float* G, float* B, const float* H, const float* S, const float* V, size_type n );
+
+   /*!
+    * Batch conversion from the HSI color ordering system to RGB. See
+    * HSVToRGB( float*, float*, float*, const float*, const float*, const float*, size_type )
+    * for a description of function parameters.
+    */
+   static void HSIToRGB( float* R, float* G, float* B, const float* H, const float* S, const float* I, size_type n );
+
+   /*!
+    * Batch conversion from RGB to HSV channel values plus CIE L* components.
+    *
+    * \param[out] H,S,V    Pointers to the output arrays of HSV channel
+    *                      values. Can be the same as the input RGB arrays.
+    *
+    * \param[out] L        Pointer to the output array of normalized CIE L*
+    *                      components. Must not be any of the input arrays.
+    *
+    * \param R,G,B         Pointers to the input arrays of normalized RGB
+    *                      components.
+    *
+    * \param n             Number of elements in all input and output arrays.
+    */
+   void RGBToHSVL( float* H, float* S, float* V, float* L, const float* R, const float* G, const float* B, size_type n ) const;
+
+   /*!
+    * Batch conversion from RGB to HSI channel values plus CIE L* components.
+    * See RGBToHSVL( float*, float*, float*, float*, const float*, const float*, const float*, size_type )
+    * for a description of function parameters.
+    */
+   void RGBToHSIL( float* H, float* S, float* I, float* L, const float* R, const float* G, const float* B, size_type n ) const;
+
+   /*!
+    * Batch conversion from HSV chrominance and CIE L* components to RGB. This
+    * is the batch version of HSVLToRGB( sample&, sample&, sample&, sample,
+    * sample, sample, sample ).
+    *
+    * \param[out] R,G,B    Pointers to the output arrays of normalized RGB
+    *                      components. Can be the same as the input HSV
+    *                      arrays, but not the same as \a L.
+    *
+    * \param H,S,V         Pointers to the input arrays of HSV channel values.
+    *
+    * \param L             Pointer to the input array of normalized CIE L*
+    *                      components.
+    *
+    * \param n             Number of elements in all input and output arrays.
+    */
+   void HSVLToRGB( float* R, float* G, float* B, const float* H, const float* S, const float* V, const float* L, size_type n ) const;
+
+   /*!
+    * Batch conversion from HSI chrominance and CIE L* components to RGB. See
+    * HSVLToRGB( float*, float*, float*, const float*, const float*, const float*, const float*, size_type )
+    * for a description of function parameters.
+    */
+   void HSILToRGB( float* R, float* G, float* B, const float* H, const float* S, const float* I, const float* L, size_type n ) const;
+
 protected:
 
    struct Data : public ReferenceCounter
@@ -1555,6 +1861,7 @@ protected:
    }
 
    friend struct Data;
+   friend class PCL_RGBColorSystemEngine;
 
 public:
 
@@ -562,9 +562,60 @@ public:
          m_s[i] = SplitMix64( x );
    }
 
+   /*!
+    * Advances the state of this generator by 2^128 calls to UI64().
+    *
+    * This function can be used to generate 2^128 nonoverlapping subsequences
+    * for parallel computations. For example, a set of independent generators
+    * for concurrent threads can be obtained by copying a seeded generator and
+    * calling Jump() once on each successive copy. Since the sequence of
+    * deviates produced by each copy depends only on the initial seed and on
+    * its ordinal position, parallel generation of random deviates can be made
+    * reproducible irrespective of the number of threads used.
+    */
+   void Jump() noexcept
+   {
+      static const uint64 J[] = { 0x180ec6d33cfd0aba, 0xd5a61266f0c9392c, 0xa9582618e03fc9aa, 0x39abdc4529b1661c };
+      Jump( J );
+   }
+
+   /*!
+    * Advances the state of this generator by 2^192 calls to UI64().
+    *
+    * This function can be used to generate 2^64 starting points, from each of
+    * which Jump() will generate 2^64 nonoverlapping subsequences for parallel
+    * distributed computations.
+    */
+   void LongJump() noexcept
+   {
+      static const uint64 J[] = { 0x76e15d3efefdcbbf, 0xc5004e441c522fb3, 0x77710069854ee241, 0x39109bb02acbe635 };
+      Jump( J );
+   }
+
 private:
 
    uint64 m_s[ 4 ];
+
+   void Jump( const uint64* J ) noexcept
+   {
+      uint64 s0 = 0, s1 = 0, s2 = 0, s3 = 0;
+      for ( int i = 0; i < 4; ++i )
+         for ( int b = 0; b < 64; ++b )
+         {
+            if ( J[i] & (uint64( 1 ) << b) )
+            {
+               s0 ^= m_s[0];
+               s1 ^= m_s[1];
+               s2 ^= m_s[2];
+               s3 ^= m_s[3];
+            }
+            (void)UI64();
+         }
+      m_s[0] = s0;
+      m_s[1] = s1;
+      m_s[2] = s2;
+      m_s[3] = s3;
+   }
 };
 
 // ----------------------------------------------------------------------------
@@ -0,0 +1,630 @@
+//     ____   ______ __
+//    / __ \ / ____// /
+//   / /_/ // /    / /
+//  / ____// /___ / /___   PixInsight Class Library
+// /_/     \____//_____/   PCL 2.8.5
+// ----------------------------------------------------------------------------
+// pcl/SIMDDispatch.h - Released 2024-12-28T16:53:48Z
+// ----------------------------------------------------------------------------
+// This file is part of the PixInsight Class Library (PCL).
+// PCL is a multiplatform C++ framework for development of PixInsight modules.
+//
+// Copyright (c) 2003-2024 Pleiades Astrophoto S.L. All Rights Reserved.
+//
+// Redistribution and use in both source and binary forms, with or without
+// modification, is permitted provided that the following conditions are met:
+//
+// 1. All redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//
+// 2. All redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//
+// 3. Neither the names "PixInsight" and "Pleiades Astrophoto", nor the names
+//    of their contributors, may be used to endorse or promote products derived
+//    from this software without specific prior written permission. For written
+//    permission, please contact info@pixinsight.com.
+//
+// 4. All products derived from this software, in any form whatsoever, must
+//    reproduce the following acknowledgment in the end-user documentation
+//    and/or other materials provided with the product:
+//
+//    "This product is based on software from the PixInsight project, developed
+//    by Pleiades Astrophoto and its contributors (https://pixinsight.com/)."
+//
+//    Alternatively, if that is where third-party acknowledgments normally
+//    appear, this acknowledgment must be reproduced in the product itself.
+//
+// THIS SOFTWARE IS PROVIDED BY PLEIADES ASTROPHOTO AND ITS CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED
+// TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+// PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL PLEIADES ASTROPHOTO OR ITS
+// CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, BUSINESS
+// INTERRUPTION; PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; AND LOSS OF USE,
+// DATA OR PROFITS) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+// ----------------------------------------------------------------------------
+
+#ifndef __PCL_SIMDDispatch_h
+#define __PCL_SIMDDispatch_h
+
+/// \file pcl/SIMDDispatch.h
+
+#include <pcl/Defs.h>
+#include <pcl/Diagnostics.h>
+
+#include <pcl/Array.h>
+#include <pcl/Complex.h>
+#include <pcl/String.h>
+
+/*
+ * Runtime dispatch of SIMD kernels is only implemented for x86_64 processors.
+ * On other architectures only portable implementations are available.
+ */
+#if defined( __x86_64__ ) || defined( _M_X64 )
+#  define __PCL_SIMD_DISPATCH 1
+#  ifdef _MSC_VER
+#    include <intrin.h>
+#  endif
+#  include <immintrin.h>
+#endif
+
+/*
+ * Per-function code generation targets for implementations of dispatched
+ * kernels. PCL is compiled for a baseline SSE4.2 instruction set; functions
+ * using wider instruction sets must be declared with these attributes and
+ * must only be called after checking ActiveSIMDInstructionSet(), or
+ * indirectly through a SIMDKernel object. With MSVC, intrinsics can always be
+ * used without specific compiler options.
+ */
+#if defined( __GNUC__ ) || defined( __clang__ )
+#  define __PCL_TARGET_SSE4    __attribute__(( target( "sse4.2" ) ))
+#  define __PCL_TARGET_AVX2    __attribute__(( target( "avx2,fma" ) ))
+#  define __PCL_TARGET_AVX512  __attribute__(( target( "avx512f,avx2,fma" ) ))
+#else
+#  define __PCL_TARGET_SSE4
+#  define __PCL_TARGET_AVX2
+#  define __PCL_TARGET_AVX512
+#endif
+
+namespace pcl
+{
+
+// ----------------------------------------------------------------------------
+
+/*!
+ * \namespace pcl::SIMDInstructionSet
+ * \brief     SIMD instruction sets supported by dispatched PCL kernels
+ *
+ * <table border="1" cellpadding="4" cellspacing="0">
+ * <tr><td>SIMDInstructionSet::Generic</td> <td>Portable C++ code, no specific SIMD instructions required</td></tr>
+ * <tr><td>SIMDInstructionSet::SSE4</td>    <td>SSE4.2 instructions</td></tr>
+ * <tr><td>SIMDInstructionSet::AVX2</td>    <td>AVX2 and FMA3 instructions</td></tr>
+ * <tr><td>SIMDInstructionSet::AVX512</td>  <td>AVX-512 Foundation instructions</td></tr>
+ * </table>
+ *
+ * Symbolic constants are sorted by increasing capabilities: a processor
+ * supporting an instruction set also supports all instruction sets with
+ * smaller constant values.
+ */
+namespace SIMDInstructionSet
+{
+   enum value_type
+   {
+      Generic,    // Portable C++ code
+      SSE4,       // SSE4.2
+      AVX2,       // AVX2 + FMA3
+      AVX512,     // AVX-512F
+      NumberOfInstructionSets
+   };
+
+   /*!
+    * Returns the name of a SIMD instruction set.
+    */
+   String Name( int isa );
+}
+
+/*!
+ * Returns the most capable SIMD instruction set supported by the running
+ * processor and operating system, among the instruction sets used by PCL
+ * dispatched kernels.
+ *
+ * This function checks both the CPUID feature flags and the extended
+ * processor states enabled by the operating system (XGETBV), so the returned
+ * instruction set can always be used safely. The detection is performed once;
+ * subsequent calls return a cached value.
+ *
+ * \ingroup hw_identification_functions
+ * \sa SIMDInstructionSetLimit(), SetSIMDInstructionSetLimit()
+ */
+PCL_FUNC SIMDInstructionSet::value_type MaxSIMDInstructionSetSupported() noexcept;
+
+/*!
+ * Returns the current upper limit for the SIMD instruction sets selected by
+ * dispatched kernels. By default no limit is imposed and this function
+ * returns SIMDInstructionSet::AVX512.
+ *
+ * \ingroup hw_identification_functions
+ */
+PCL_FUNC SIMDInstructionSet::value_type SIMDInstructionSetLimit() noexcept;
+
+/*!
+ * Sets an upper limit for the SIMD instruction sets selected by dispatched
+ * kernels, and reselects the implementations of all registered kernels
+ * accordingly.
+ *
+ * Limiting the instruction set can be useful to avoid the frequency scaling
+ * caused by wide vector instructions on some processors, or to validate and
+ * benchmark baseline code paths on modern hardware. This function is not
+ * intended to be called while dispatched kernels are being executed by other
+ * threads.
+ *
+ * \ingroup hw_identification_functions
+ */
+PCL_FUNC void SetSIMDInstructionSetLimit( SIMDInstructionSet::value_type isa );
+
+/*!
+ * Returns the SIMD instruction set effectively available for dispatched
+ * kernels, that is, the smallest of MaxSIMDInstructionSetSupported() and
+ * SIMDInstructionSetLimit().
+ *
+ * \ingroup hw_identification_functions
+ */
+inline SIMDInstructionSet::value_type ActiveSIMDInstructionSet() noexcept
+{
+   SIMDInstructionSet::value_type isa = MaxSIMDInstructionSetSupported();
+   SIMDInstructionSet::value_type limit = SIMDInstructionSetLimit();
+   return (isa < limit) ? isa : limit;
+}
+
+// ----------------------------------------------------------------------------
+
+/*!
+ * \class SIMDKernelBase
+ * \brief Abstract base class of runtime dispatched SIMD kernels
+ *
+ * A SIMD kernel is a computational routine (typically the innermost loop of a
+ * performance-critical algorithm) implemented for several SIMD instruction
+ * sets. At runtime, the implementation corresponding to the most capable
+ * instruction set supported by the running processor is selected, subject to
+ * the limit set by SetSIMDInstructionSetLimit().
+ *
+ * All kernels are registered automatically upon construction in a global
+ * registry, which can be used to validate each implementation against the
+ * portable reference implementation (SelfTest()) and to measure the relative
+ * performance of all available implementations (Benchmark()).
+ *
+ * \sa SIMDKernel
+ */
+class PCL_CLASS SIMDKernelBase
+{
+public:
+
+   /*!
+    * Represents a SIMD instruction set.
+    */
+   using instruction_set = SIMDInstructionSet::value_type;
+
+   /*!
+    * Virtual destructor. Removes this kernel from the global registry.
+    */
+   virtual ~SIMDKernelBase();
+
+   /*!
+    * Copy constructor. This constructor is disabled because kernels are
+    * unique objects.
+    */
+   SIMDKernelBase( const SIMDKernelBase& ) = delete;
+
+   /*!
+    * Copy assignment. This operator is disabled because kernels are unique
+    * objects.
+    */
+   SIMDKernelBase& operator =( const SIMDKernelBase& ) = delete;
+
+   /*!
+    * Returns the unique identifier of this kernel.
+    */
+   const IsoString& Id() const noexcept
+   {
+      return m_id;
+   }
+
+   /*!
+    * Returns the instruction set of the implementation currently selected for
+    * execution of this kernel.
+    */
+   instruction_set SelectedInstructionSet() const noexcept
+   {
+      return m_selected;
+   }
+
+   /*!
+    * Returns true iff this kernel has an implementation for the specified
+    * instruction set \a isa, and the running processor supports it.
+    */
+   bool IsAvailable( instruction_set isa ) const noexcept
+   {
+      return HasImplementation( isa ) && isa <= MaxSIMDInstructionSetSupported();
+   }
+
+   /*!
+    * Validates the implementation of this kernel for the specified
+    * instruction set \a isa against the portable (generic) implementation.
+    * Returns true if the results agree within the tolerances applicable to
+    * this kernel; false otherwise. Returns false if the implementation is not
+    * available on the running machine.
+    */
+   bool SelfTest( instruction_set isa ) const;
+
+   /*!
+    * Measures the performance of the implementation of this kernel for the
+    * specified instruction set \a isa. Returns the average execution time in
+    * nanoseconds per processed element for arrays of \a length elements, or
+    * zero if the implementation is not available on the running machine.
+    */
+   double Benchmark( instruction_set isa, size_type length = 16384 ) const;
+
+   /*!
+    * Selects the most capable implementation available on the running
+    * machine, subject to the current instruction set limit. This function is
+    * called automatically upon construction and when the instruction set
+    * limit is changed.
+    */
+   void Select() noexcept;
+
+   /*!
+    * Returns the list of all registered kernels.
+    */
+   static Array<SIMDKernelBase*> Kernels();
+
+   /*!
+    * Returns the registered kernel with the specified identifier, or nullptr
+    * if no such kernel exists.
+    */
+   static SIMDKernelBase* KernelById( const IsoString& id );
+
+   /*!
+    * Validates all available implementations of all registered kernels.
+    * Returns true iff all tests succeed. If a \a report string is specified,
+    * a line of text describing each test and its result is appended to it.
+    */
+   static bool SelfTestAll( String* report = nullptr );
+
+   /*!
+    * Benchmarks all available implementations of all registered kernels.
+    * Returns a text report with one line per kernel and the execution time
+    * of each implementation in nanoseconds per element.
+    */
+   static String BenchmarkAll( size_type length = 16384 );
+
+protected:
+
+   /*!
+    * Constructs a new kernel with the specified unique identifier and
+    * registers it.
+    */
+   SIMDKernelBase( const IsoString& id );
+
+   /*!
+    * Returns true iff this kernel has an implementation for the specified
+    * instruction set \a isa.
+    */
+   virtual bool HasImplementation( instruction_set isa ) const noexcept = 0;
+
+   /*!
+    * Selects the implementation for the specified instruction set \a isa for
+    * execution of this kernel.
+    */
+   virtual void SelectImplementation( instruction_set isa ) noexcept = 0;
+
+   /*!
+    * Validates the implementation for the specified instruction set \a isa.
+    */
+   virtual bool DoSelfTest( instruction_set isa ) const = 0;
+
+   /*!
+    * Executes the implementation for the specified instruction set \a isa
+    * once for a test array of \a length elements.
+    */
+   virtual void DoBenchmark( instruction_set isa, size_type length ) const = 0;
+
+private:
+
+   IsoString       m_id;
+   instruction_set m_selected = SIMDInstructionSet::Generic;
+};
+
+// ----------------------------------------------------------------------------
+
+/*!
+ * \class SIMDKernel
+ * \brief Runtime dispatched SIMD kernel
+ *
+ * The template argument \a F is a function pointer type. A %SIMDKernel object
+ * stores a portable implementation, which is mandatory, plus optional
+ * implementations for the SSE4, AVX2 and AVX-512 instruction sets. A null
+ * pointer indicates that no specific implementation exists for an instruction
+ * set, in which case the implementation for the next less capable instruction
+ * set will be selected.
+ *
+ * Each kernel also provides a test function, which receives a candidate and a
+ * reference implementation and must return true iff both produce equivalent
+ * results, and a benchmark function, which must execute a given
+ * implementation once for an array of the specified length.
+ *
+ * Calling a %SIMDKernel object invokes the selected implementation with just
+ * the cost of an indirect function call.
+ */
+template <typename F>
+class PCL_CLASS SIMDKernel : public SIMDKernelBase
+{
+public:
+
+   /*!
+    * The function pointer type of kernel implementations.
+    */
+   using function = F;
+
+   /*!
+    * The type of a test function.
+    */
+   using test_function = bool (*)( function, function );
+
+   /*!
+    * The type of a benchmark function.
+    */
+   using benchmark_function = void (*)( function, size_type );
+
+   /*!
+    * Constructs and registers a new SIMD kernel.
+    *
+    * \param id         Unique identifier of the kernel.
+    * \param generic    Portable implementation. Must not be null.
+    * \param sse4       SSE4.2 implementation, or nullptr.
+    * \param avx2       AVX2/FMA3 implementation, or nullptr.
+    * \param avx512     AVX-512F implementation, or nullptr.
+    * \param test       Test function.
+    * \param benchmark  Benchmark function.
+    */
+   SIMDKernel( const IsoString& id, function generic, function sse4, function avx2, function avx512,
+               test_function test, benchmark_function benchmark )
+      : SIMDKernelBase( id )
+      , m_test( test )
+      , m_benchmark( benchmark )
+   {
+      PCL_PRECONDITION( generic != nullptr )
+      m_implementation[SIMDInstructionSet::Generic] = generic;
+      m_implementation[SIMDInstructionSet::SSE4] = sse4;
+      m_implementation[SIMDInstructionSet::AVX2] = avx2;
+      m_implementation[SIMDInstructionSet::AVX512] = avx512;
+      m_function = generic;
+      Select();
+   }
+
+   /*!
+    * Returns the currently selected implementation.
+    */
+   function Function() const noexcept
+   {
+      return m_function;
+   }
+
+   /*!
+    * Returns the implementation for the specified instruction set \a isa, or
+    * nullptr if this kernel has no specific implementation for it, or if the
+    * running processor does not support it (see IsAvailable()).
+    */
+   function Implementation( instruction_set isa ) const noexcept
+   {
+      return IsAvailable( isa ) ? m_implementation[isa] : nullptr;
+   }
+
+   /*!
+    * Invokes the currently selected implementation with the specified
+    * arguments.
+    */
+   template <typename... A>
+   auto operator ()( A... args ) const
+   {
+      return m_function( args... );
+   }
+
+protected:
+
+   bool HasImplementation( instruction_set isa ) const noexcept override
+   {
+      return m_implementation[isa] != nullptr;
+   }
+
+   void SelectImplementation( instruction_set isa ) noexcept override
+   {
+      m_function = m_implementation[isa];
+   }
+
+   bool DoSelfTest( instruction_set isa ) const override
+   {
+      return m_test( m_implementation[isa], m_implementation[SIMDInstructionSet::Generic] );
+   }
+
+   void DoBenchmark( instruction_set isa, size_type length ) const override
+   {
+      m_benchmark( m_implementation[isa], length );
+   }
+
+private:
+
+   function           m_function = nullptr;
+   function           m_implementation[ SIMDInstructionSet::NumberOfInstructionSets ];
+   test_function      m_test = nullptr;
+   benchmark_function m_benchmark = nullptr;
+};
+
+// ----------------------------------------------------------------------------
+
+/*!
+ * \namespace pcl::SIMD
+ * \brief     Runtime dispatched SIMD kernels
+ *
+ * The functions in this namespace execute built-in SIMD kernels implemented
+ * for all instruction sets defined in the SIMDInstructionSet namespace. The
+ * most efficient implementation available on the running machine is selected
+ * at runtime.
+ */
+namespace SIMD
+{
+   /*!
+    * Returns the minimum of the \a n &gt; 0 elements of the array \a f.
+    */
+   PCL_FUNC float Min( const float* f, size_type n );
+
+   /*!
+    * Returns the minimum of the \a n &gt; 0 elements of the array \a f.
+    */
+   PCL_FUNC double Min( const double* f, size_type n );
+
+   /*!
+    * Returns the maximum of the \a n &gt; 0 elements of the array \a f.
+    */
+   PCL_FUNC float Max( const float* f, size_type n );
+
+   /*!
+    * Returns the maximum of the \a n &gt; 0 elements of the array \a f.
+    */
+   PCL_FUNC double Max( const double* f, size_type n );
+
+   /*!
+    * Accumulates a histogram of the \a n elements of the array \a f in the
+    * array \a H of \a length bins. Each element v is counted in the bin with
+    * index k = TruncInt( scale*(v - low) ), and ignored if k is outside the
+    * [0,length) range.
+    */
+   PCL_FUNC void Histogram( size_type* H, int length, const float* f, size_type n, float low, float scale );
+
+   /*!
+    * Accumulates a histogram of the \a n elements of the array \a f in the
+    * array \a H of \a length bins. Each element v is counted in the bin with
+    * index k = TruncInt( scale*(v - low) ), and ignored if k is outside the
+    * [0,length) range.
+    */
+   PCL_FUNC void Histogram( size_type* H, int length, const double* f, size_type n, double low, double scale );
+
+   /*!
+    * Accumulates a histogram of absolute deviations from \a center of the
+    * \a n elements of the array \a f in the array \a H of \a length bins.
+    * Each element v is counted in the bin with index
+    * k = TruncInt( scale*(Abs( v - center ) - low) ), and ignored if k is
+    * outside the [0,length) range.
+    */
+   PCL_FUNC void AbsDevHistogram( size_type* H, int length, const float* f, size_type n, float center, float low, float scale );
+
+   /*!
+    * Accumulates a histogram of absolute deviations from \a center of the
+    * \a n elements of the array \a f in the array \a H of \a length bins.
+    * Each element v is counted in the bin with index
+    * k = TruncInt( scale*(Abs( v - center ) - low) ), and ignored if k is
+    * outside the [0,length) range.
+    */
+   PCL_FUNC void AbsDevHistogram( size_type* H, int length, const double* f, size_type n, double center, double low, double scale );
+
+   /*!
+    * Element-wise scaled complex multiplication: x[i] = k*x[i]*y[i], for
+    * 0 &le; i &lt; \a n.
+    */
+   PCL_FUNC void MultiplyComplex( fcomplex* x, const fcomplex* y, float k, size_type n );
+
+   /*!
+    * Element-wise scaled complex multiplication: x[i] = k*x[i]*y[i], for
+    * 0 &le; i &lt; \a n.
+    */
+   PCL_FUNC void MultiplyComplex( dcomplex* x, const dcomplex* y, double k, size_type n );
+
+   /*!
+    * Returns the dot product of the arrays \a x and \a y of \a n elements.
+    */
+   PCL_FUNC double DotProduct( const float* x, const float* y, size_type n );
+
+   /*!
+    * Returns the dot product of the arrays \a x and \a y of \a n elements.
+    */
+   PCL_FUNC double DotProduct( const double* x, const double* y, size_type n );
+
+   /*!
+    * Returns the indexed dot product of the arrays \a x and \a y:
+    *
+    * Sum_i x[index[i]]*y[i], 0 &le; i &lt; \a n.
+    *
+    * The AVX2 and AVX-512 implementations use gather instructions.
+    */
+   PCL_FUNC double IndexedDotProduct( const float* x, const float* y, const int* index, size_type n );
+
+   /*!
+    * Returns the indexed dot product of the arrays \a x and \a y. See
+    * IndexedDotProduct( const float*, const float*, const int*, size_type ).
+    */
+   PCL_FUNC double IndexedDotProduct( const double* x, const double* y, const int* index, size_type n );
+
+   /*!
+    * Evaluates a Chebyshev series by Clenshaw recurrences for a set of
+    * points. For 0 &le; j &lt; \a n:
+    *
+    * r[j] = c[0]/2 + Sum_k c[k]*T_k( y[j] ), 0 &lt; k &lt; \a m
+    *
+    * where T_k is the Chebyshev polynomial of the first kind of degree k and
+    * the evaluation points y[j] are in the [-1,+1] interval. At least one
+    * coefficient must be specified (\a m &gt; 0).
+    */
+   PCL_FUNC void ChebyshevSeries( double* r, const double* y, size_type n, const double* c, int m );
+
+   /*!
+    * Radix-2 butterflies of a Stockham autosort fast Fourier transform. For
+    * 0 &le; i &lt; \a n, with a = x[i] and b = x[i + xs]:
+    *
+    * y[i] = a + b\n
+    * y[i + ys] = w[0]*(a - b)
+    *
+    * Strides \a xs and \a ys are expressed in complex elements. The input
+    * and output arrays must not overlap. The \a sign argument is unused; it
+    * is only specified for consistency with FFTRadix4().
+    */
+   PCL_FUNC void FFTRadix2( fcomplex* y, size_type ys, const fcomplex* x, size_type xs, const fcomplex* w, int sign, size_type n );
+
+   /*!
+    * Radix-2 butterflies of a Stockham autosort fast Fourier transform. See
+    * FFTRadix2( fcomplex*, size_type, const fcomplex*, size_type, const fcomplex*, int, size_type ).
+    */
+   PCL_FUNC void FFTRadix2( dcomplex* y, size_type ys, const dcomplex* x, size_type xs, const dcomplex* w, int sign, size_type n );
+
+   /*!
+    * Radix-4 butterflies of a Stockham autosort fast Fourier transform. For
+    * 0 &le; i &lt; \a n, with a_k = x[i + k*xs], k = 0,...,3:
+    *
+    * y[i + j*ys] = w_j * Sum_k a_k*(sign*I)^(j*k), j = 0,...,3
+    *
+    * where I is the imaginary unit, w_0 = 1, and w_1, w_2, w_3 are the three
+    * consecutive twiddle factors stored at \a w. \a sign is -1 for forward
+    * transforms and +1 for inverse transforms. Strides \a xs and \a ys are
+    * expressed in complex elements. The input and output arrays must not
+    * overlap.
+    */
+   PCL_FUNC void FFTRadix4( fcomplex* y, size_type ys, const fcomplex* x, size_type xs, const fcomplex* w, int sign, size_type n );
+
+   /*!
+    * Radix-4 butterflies of a Stockham autosort fast Fourier transform. See
+    * FFTRadix4( fcomplex*, size_type, const fcomplex*, size_type, const fcomplex*, int, size_type ).
+    */
+   PCL_FUNC void FFTRadix4( dcomplex* y, size_type ys, const dcomplex* x, size_type xs, const dcomplex* w, int sign, size_type n );
+}
+
+// ----------------------------------------------------------------------------
+
+} // pcl
+
+#endif   // __PCL_SIMDDispatch_h
+
+// ----------------------------------------------------------------------------
+// EOF pcl/SIMDDispatch.h - Released 2024-12-28T16:53:48Z
@@ -56,10 +56,13 @@
 
 #include <pcl/Defs.h>
 
+#include <pcl/Atomic.h>
 #include <pcl/AutoPointer.h>
 #include <pcl/Compression.h>
 #include <pcl/ElapsedTime.h>
 #include <pcl/File.h>
+#include <pcl/ReferenceArray.h>
+#include <pcl/Thread.h>
 #include <pcl/TimePoint.h>
 #include <pcl/Vector.h>
 
@@ -177,6 +180,19 @@ public:
       uint32   countIO = 0u;             //!< Total number of I/O operations performed (output data).
       double   timeUncompress = 0;       //!< Time consumed by data uncompression in seconds (output data).
       double   timeDecode = 0;           //!< Time consumed by data decoding in seconds (output data).
+      uint32   countCacheHits = 0u;      /*!< Number of leaf data blocks retrieved from the shared block cache,
+                                              without I/O or uncompression operations (output data). */
+
+      /*!
+       * Returns the fraction of leaf data blocks retrieved from the shared
+       * block cache, in the range [0,1]. Returns zero if no data blocks have
+       * been retrieved. See StarDatabaseFile::SetBlockCacheCapacity().
+       */
+      double CacheHitRatio() const
+      {
+         uint32 count = countCacheHits + countIO;
+         return (count > 0) ? double( countCacheHits )/count : 0.0;
+      }
    };
 
    /*!
@@ -204,6 +220,7 @@ public:
          timeTotal = timeIO = 0;
          countIO = 0u;
          timeUncompress = timeDecode = 0;
+         countCacheHits = 0u;
       }
    };
 
@@ -438,6 +455,25 @@ protected:
          SearchRecursive( 0, ra, dec, r, searchData );
       }
 
+      void GetIntersectingLeaves( Array<uint32>& leaves, double ra, double dec, double r ) const
+      {
+         GetIntersectingLeavesRecursive( leaves, 0, ra, dec, r );
+      }
+
+      void GetIntersectingLeaves( Array<uint32>& leaves, Array<Array<int>>& leafSearches,
+                                  const Array<const SearchDataBase*>& searches ) const
+      {
+         Array<int> active;
+         for ( int i = 0; i < int( searches.Length() ); ++i )
+            active << i;
+         GetIntersectingLeavesRecursive( leaves, leafSearches, 0, searches, active );
+      }
+
+      const IndexNode& Node( uint32 nodeIndex ) const
+      {
+         return m_nodes[nodeIndex];
+      }
+
    private:
 
       StarDatabaseFile* m_parent = nullptr;
@@ -481,6 +517,61 @@ protected:
       // Defined after StarDatabaseFile declaration.
       void SearchRecursive( uint32 nodeIndex, double ra, double dec, double r, void* searchData ) const;
 
+      void GetIntersectingLeavesRecursive( Array<uint32>& leaves, uint32 nodeIndex, double ra, double dec, double r ) const
+      {
+         const IndexNode& node = m_nodes[nodeIndex];
+         if ( IntersectsNodeRegion( ra, dec, r, node ) )
+         {
+            if ( node.IsLeaf() )
+               leaves << nodeIndex;
+            else
+            {
+               if ( node.index.child.nw != 0 )
+                  GetIntersectingLeavesRecursive( leaves, node.index.child.nw, ra, dec, r );
+               if ( node.index.child.ne != 0 )
+                  GetIntersectingLeavesRecursive( leaves, node.index.child.ne, ra, dec, r );
+               if ( node.index.child.sw != 0 )
+                  GetIntersectingLeavesRecursive( leaves, node.index.child.sw, ra, dec, r );
+               if ( node.index.child.se != 0 )
+                  GetIntersectingLeavesRecursive( leaves, node.index.child.se, ra, dec, r );
+            }
+         }
+      }
+
+      /*
+       * Multiple search regions: each node is tested only for the regions
+       * that intersect its parent, and each leaf node is reported once along
+       * with the indices of all intersecting regions.
+       */
+      void GetIntersectingLeavesRecursive( Array<uint32>& leaves, Array<Array<int>>& leafSearches, uint32 nodeIndex,
+                                           const Array<const SearchDataBase*>& searches, const Array<int>& active ) const
+      {
+         const IndexNode& node = m_nodes[nodeIndex];
+         Array<int> intersecting;
+         for ( int i : active )
+            if ( IntersectsNodeRegion( searches[i]->centerRA, searches[i]->centerDec, searches[i]->radius, node ) )
+               intersecting << i;
+         if ( !intersecting.IsEmpty() )
+         {
+            if ( node.IsLeaf() )
+            {
+               leaves << nodeIndex;
+               leafSearches << intersecting;
+            }
+            else
+            {
+               if ( node.index.child.nw != 0 )
+                  GetIntersectingLeavesRecursive( leaves, leafSearches, node.index.child.nw, searches, intersecting );
+               if ( node.index.child.ne != 0 )
+                  GetIntersectingLeavesRecursive( leaves, leafSearches, node.index.child.ne, searches, intersecting );
+               if ( node.index.child.sw != 0 )
+                  GetIntersectingLeavesRecursive( leaves, leafSearches, node.index.child.sw, searches, intersecting );
+               if ( node.index.child.se != 0 )
+                  GetIntersectingLeavesRecursive( leaves, leafSearches, node.index.child.se, searches, intersecting );
+            }
+         }
+      }
+
       friend class StarDatabaseFile;
    };
 };
@@ -639,6 +730,44 @@ public:
       return m_statistics;
    }
 
+   /*!
+    * Returns the capacity in bytes of the shared block cache.
+    *
+    * Uncompressed leaf node data blocks are stored in a process-wide cache
+    * shared by all %StarDatabaseFile instances. Repeated searches over the
+    * same regions, as happens when many images of the same field are
+    * solved astrometrically, can then be served without I/O and uncompression
+    * operations. Cached blocks are identified by the full path, size and last
+    * modification time of their files, so they remain available after a file
+    * is closed, and are reused when the same file is opened again. When the
+    * cache reaches its capacity, least recently used blocks are discarded. The
+    * default capacity is 256 MiB.
+    *
+    * Cache usage can be evaluated with the XPSD::SearchDataBase::countCacheHits
+    * and XPSD::SearchDataBase::countIO search result items.
+    */
+   static size_type BlockCacheCapacity();
+
+   /*!
+    * Sets the capacity in bytes of the shared block cache. If the cache holds
+    * more data than the specified capacity, least recently used blocks will be
+    * discarded immediately. A zero capacity disables the cache.
+    *
+    * See BlockCacheCapacity() for more information.
+    */
+   static void SetBlockCacheCapacity( size_type capacity );
+
+   /*!
+    * Returns the total size in bytes of the data blocks currently stored in
+    * the shared block cache.
+    */
+   static size_type BlockCacheSize();
+
+   /*!
+    * Discards all data blocks stored in the shared block cache.
+    */
+   static void ClearBlockCache();
+
    /*!
     * Generates a file to store a point source database in XPSD format.
     *
@@ -700,6 +829,7 @@ public:
 protected:
 
    mutable File                     m_file;
+           uint64                   m_fileId = 0;
            XPSD::Metadata           m_metadata;
            XPSD::Statistics         m_statistics;
            float                    m_magnitudeLow = 0;
@@ -709,11 +839,14 @@ protected:
            AutoPointer<Compression> m_compression;
            String                   m_parameters;
 
+   /*
+    * Positional reads do not depend on a shared file position, so leaf data
+    * blocks can be loaded concurrently by parallel search threads.
+    */
    virtual void LoadData( void* block, uint64 offset, uint32 size, void* searchData ) const
    {
       ElapsedTime T;
-      m_file.SetPosition( m_dataPosition + offset );
-      m_file.Read( block, size );
+      m_file.ReadAt( m_dataPosition + offset, block, size );
       reinterpret_cast<SearchDataBase*>( searchData )->timeIO += T();
       ++reinterpret_cast<SearchDataBase*>( searchData )->countIO;
    }
@@ -730,6 +863,391 @@ protected:
 
    virtual void GetEncodedData( const ByteArray&, const XPSD::IndexTree&, const XPSD::IndexNode&, void* ) const = 0;
 
+   /*
+    * Decodes a leaf node data block for a set of search operations. Derived
+    * classes should reimplement this function to decode each point source
+    * only once for all of the searches. Instrumentation items not specific to
+    * a particular search, such as decoding times, should be accumulated in
+    * the XPSD::SearchDataBase structure pointed to by batchData. The default
+    * implementation simply decodes the block once for each search.
+    */
+   virtual void GetEncodedBatchData( const ByteArray& data, const XPSD::IndexTree& tree, const XPSD::IndexNode& node,
+                                     void* const* searchData, int searchCount, void* batchData ) const
+   {
+      for ( int i = 0; i < searchCount; ++i )
+         GetEncodedData( data, tree, node, searchData[i] );
+   }
+
+   /*
+    * Returns true iff a point source with the specified \a flags and
+    * \a magnitude satisfies the flag and magnitude criteria of a search.
+    */
+   static bool MatchesSearchCriteria( const XPSD::SearchDataBase& search, uint32 flags, float magnitude )
+   {
+      return (search.requiredFlags == 0 || (flags & search.requiredFlags) == search.requiredFlags)
+          && (search.inclusionFlags == 0 || (flags & search.inclusionFlags) != 0)
+          && (search.exclusionFlags == 0 || (flags & search.exclusionFlags) == 0)
+          && magnitude >= search.magnitudeLow
+          && magnitude <= search.magnitudeHigh;
+   }
+
+   /*
+    * Returns the uncompressed data block of a leaf node, either from the
+    * shared block cache, or loaded and uncompressed from this file.
+    */
+   ByteArray GetLeafData( const XPSD::IndexNode& node, void* searchData ) const;
+
+   /*
+    * Performs a search operation for the specified search data structure,
+    * which must be an instance of XPSD::SearchData<>. Leaf nodes intersecting
+    * the search region are loaded and decoded in parallel when this function
+    * is called from the root thread. Search results are identical to those of
+    * a sequential search, including the order of found sources.
+    */
+   template <class SD>
+   void SearchLeaves( SD& data ) const
+   {
+      ElapsedTime T;
+
+      Array<LeafRef> leaves;
+      for ( const XPSD::IndexTree& tree : m_index )
+      {
+         Array<uint32> nodes;
+         tree.GetIntersectingLeaves( nodes, data.centerRA, data.centerDec, data.radius );
+         for ( uint32 node : nodes )
+            leaves << LeafRef{ &tree, node };
+      }
+
+      Array<size_type> L;
+      if ( leaves.Length() > 1 && Thread::IsRootThread() )
+         L = Thread::OptimalThreadLoads( leaves.Length() );
+
+      if ( L.Length() < 2 )
+      {
+         for ( const LeafRef& leaf : leaves )
+            SearchLeaf( leaf, &data );
+      }
+      else
+      {
+         ReferenceArray<SearchThread<SD>> threads;
+         for ( size_type i = 0, n = 0; i < L.Length(); n += L[i++] )
+            threads.Add( new SearchThread<SD>( *this, data, leaves, n, n + L[i], threads, int( i ) ) );
+         int i = 0;
+         for ( SearchThread<SD>& thread : threads )
+            thread.Start( ThreadPriority::DefaultMax, i++ );
+         for ( SearchThread<SD>& thread : threads )
+            thread.Wait();
+
+         String errorMessage;
+         double timeIO = 0, timeUncompress = 0, timeDecode = 0;
+         for ( SearchThread<SD>& thread : threads )
+         {
+            if ( !thread.errorMessage.IsEmpty() )
+            {
+               if ( errorMessage.IsEmpty() )
+                  errorMessage = thread.errorMessage;
+               continue;
+            }
+            MergeSearchResults( data, thread.data );
+            data.countIO += thread.data.countIO;
+            data.countCacheHits += thread.data.countCacheHits;
+            timeIO = Max( timeIO, thread.data.timeIO );
+            timeUncompress = Max( timeUncompress, thread.data.timeUncompress );
+            timeDecode = Max( timeDecode, thread.data.timeDecode );
+         }
+         data.timeIO += timeIO;
+         data.timeUncompress += timeUncompress;
+         data.timeDecode += timeDecode;
+
+         threads.Destroy();
+
+         if ( !errorMessage.IsEmpty() )
+            throw Error( errorMessage );
+      }
+
+      data.timeTotal += T();
+   }
+
+   /*
+    * Performs a set of search operations in a single pass. Each quadtree is
+    * traversed once for all search regions, and each intersecting leaf node
+    * is loaded, uncompressed and decoded only once, with its point sources
+    * distributed among all of the searches whose regions intersect the node.
+    * Leaf nodes are processed in parallel when this function is called from
+    * the root thread.
+    *
+    * Found sources, excess and reject counts are returned in the
+    * corresponding elements of the \a searches array, with the same contents
+    * and order as if each search had been performed separately. Since I/O,
+    * uncompression and decoding are shared among searches, instrumentation
+    * items are accumulated in the structure pointed to by \a batchData, if
+    * it is not nullptr.
+    */
+   template <class SD>
+   void SearchLeavesBatch( Array<SD>& searches, XPSD::SearchDataBase* batchData ) const
+   {
+      ElapsedTime T;
+
+      XPSD::SearchDataBase localStats;
+      XPSD::SearchDataBase& stats = (batchData != nullptr) ? *batchData : localStats;
+
+      Array<const XPSD::SearchDataBase*> regions;
+      for ( const SD& search : searches )
+         regions << &search;
+
+      Array<BatchLeafRef> leaves;
+      for ( const XPSD::IndexTree& tree : m_index )
+      {
+         Array<uint32> nodes;
+         Array<Array<int>> nodeSearches;
+         tree.GetIntersectingLeaves( nodes, nodeSearches, regions );
+         for ( size_type i = 0; i < nodes.Length(); ++i )
+            leaves << BatchLeafRef{ &tree, nodes[i], nodeSearches[i] };
+      }
+
+      Array<size_type> L;
+      if ( leaves.Length() > 1 && Thread::IsRootThread() )
+         L = Thread::OptimalThreadLoads( leaves.Length() );
+
+      if ( L.Length() < 2 )
+      {
+         for ( const BatchLeafRef& leaf : leaves )
+            SearchBatchLeaf( leaf, searches.Begin(), stats );
+      }
+      else
+      {
+         ReferenceArray<BatchSearchThread<SD>> threads;
+         for ( size_type i = 0, n = 0; i < L.Length(); n += L[i++] )
+            threads.Add( new BatchSearchThread<SD>( *this, searches, leaves, n, n + L[i], threads, int( i ) ) );
+         int i = 0;
+         for ( BatchSearchThread<SD>& thread : threads )
+            thread.Start( ThreadPriority::DefaultMax, i++ );
+         for ( BatchSearchThread<SD>& thread : threads )
+            thread.Wait();
+
+         String errorMessage;
+         double timeIO = 0, timeUncompress = 0, timeDecode = 0;
+         for ( BatchSearchThread<SD>& thread : threads )
+         {
+            if ( !thread.errorMessage.IsEmpty() )
+            {
+               if ( errorMessage.IsEmpty() )
+                  errorMessage = thread.errorMessage;
+               continue;
+            }
+            for ( size_type j = 0; j < searches.Length(); ++j )
+               MergeSearchResults( searches[j], thread.searches[j] );
+            stats.countIO += thread.stats.countIO;
+            stats.countCacheHits += thread.stats.countCacheHits;
+            timeIO = Max( timeIO, thread.stats.timeIO );
+            timeUncompress = Max( timeUncompress, thread.stats.timeUncompress );
+            timeDecode = Max( timeDecode, thread.stats.timeDecode );
+         }
+         stats.timeIO += timeIO;
+         stats.timeUncompress += timeUncompress;
+         stats.timeDecode += timeDecode;
+
+         threads.Destroy();
+
+         if ( !errorMessage.IsEmpty() )
+            throw Error( errorMessage );
+      }
+
+      stats.timeTotal += T();
+   }
+
+private:
+
+   struct LeafRef
+   {
+      const XPSD::IndexTree* tree;
+      uint32                 node;
+   };
+
+   struct BatchLeafRef
+   {
+      const XPSD::IndexTree* tree;
+      uint32                 node;
+      Array<int>             searches; // indices of intersecting searches
+   };
+
+   void SearchLeaf( const LeafRef& leaf, void* searchData ) const
+   {
+      const XPSD::IndexNode& node = leaf.tree->Node( leaf.node );
+      GetEncodedData( GetLeafData( node, searchData ), *leaf.tree, node, searchData );
+   }
+
+   template <class SD>
+   void SearchBatchLeaf( const BatchLeafRef& leaf, SD* searches, XPSD::SearchDataBase& stats ) const
+   {
+      Array<void*> searchData;
+      for ( int i : leaf.searches )
+         searchData << static_cast<void*>( searches + i );
+      const XPSD::IndexNode& node = leaf.tree->Node( leaf.node );
+      GetEncodedBatchData( GetLeafData( node, &stats ), *leaf.tree, node,
+                           searchData.Begin(), int( searchData.Length() ), &stats );
+   }
+
+   /*
+    * Returns the effective source limit of a parallel search thread that has
+    * found \a count sources, when the threads processing preceding leaf nodes
+    * have found \a preceding sources. Counts of preceding threads can only
+    * grow, so further sources found by this thread beyond the returned limit
+    * will never be included in the merged search result. Lowering the source
+    * limit allows derived classes to skip decoding of these sources, which are
+    * just counted as excess objects.
+    */
+   static uint32 ThreadSourceLimit( uint32 sourceLimit, size_type count, size_type preceding )
+   {
+      if ( preceding >= sourceLimit )
+         return uint32( count );
+      return uint32( Max( count, size_type( sourceLimit ) - preceding ) );
+   }
+
+   /*
+    * Appends the sources found by a parallel search thread, preserving the
+    * source limit of the search.
+    */
+   template <class SD>
+   static void MergeSearchResults( SD& data, const SD& threadData )
+   {
+      for ( const auto& star : threadData.stars )
+         if ( data.stars.Length() < size_type( data.sourceLimit ) )
+            data.stars << star;
+         else
+            ++data.excessCount;
+      data.excessCount += threadData.excessCount;
+      data.rejectCount += threadData.rejectCount;
+   }
+
+   template <class SD>
+   class SearchThread : public Thread
+   {
+   public:
+
+      SD     data;
+      String errorMessage;
+
+      SearchThread( const StarDatabaseFile& file, const SD& searchData,
+                    const Array<LeafRef>& leaves, size_type start, size_type end,
+                    ReferenceArray<SearchThread>& threads, int index )
+         : data( searchData )
+         , m_file( file )
+         , m_leaves( leaves )
+         , m_start( start )
+         , m_end( end )
+         , m_threads( threads )
+         , m_index( index )
+         , m_sourceLimit( searchData.sourceLimit )
+      {
+         data.ResetSearchResults();
+      }
+
+      void Run() override
+      {
+         try
+         {
+            for ( size_type i = m_start; i < m_end; ++i )
+            {
+               m_file.SearchLeaf( m_leaves[i], &data );
+               if ( m_sourceLimit != uint32_max )
+               {
+                  m_count.Store( int( data.stars.Length() ) );
+                  size_type preceding = 0;
+                  for ( int j = 0; j < m_index; ++j )
+                     preceding += size_type( m_threads[j].m_count.Load() );
+                  data.sourceLimit = ThreadSourceLimit( m_sourceLimit, data.stars.Length(), preceding );
+               }
+            }
+         }
+         catch ( const Exception& x )
+         {
+            errorMessage = x.Message();
+         }
+         catch ( ... )
+         {
+            errorMessage = "Unknown exception in parallel XPSD search thread.";
+         }
+      }
+
+   private:
+
+      const StarDatabaseFile&       m_file;
+      const Array<LeafRef>&         m_leaves;
+      size_type                     m_start, m_end;
+      ReferenceArray<SearchThread>& m_threads; // threads of this search
+      int                           m_index;   // index of this thread in m_threads
+      uint32                        m_sourceLimit;
+      AtomicInt                     m_count;   // sources found by this thread
+   };
+
+   template <class SD>
+   class BatchSearchThread : public Thread
+   {
+   public:
+
+      Array<SD>            searches;
+      XPSD::SearchDataBase stats;
+      String               errorMessage;
+
+      BatchSearchThread( const StarDatabaseFile& file, const Array<SD>& batch,
+                         const Array<BatchLeafRef>& leaves, size_type start, size_type end,
+                         ReferenceArray<BatchSearchThread>& threads, int index )
+         : searches( batch )
+         , m_file( file )
+         , m_leaves( leaves )
+         , m_start( start )
+         , m_end( end )
+         , m_threads( threads )
+         , m_index( index )
+         , m_counts( batch.Length() )
+      {
+         for ( SD& search : searches )
+         {
+            m_sourceLimits << search.sourceLimit;
+            search.ResetSearchResults();
+         }
+      }
+
+      void Run() override
+      {
+         try
+         {
+            for ( size_type i = m_start; i < m_end; ++i )
+            {
+               m_file.SearchBatchLeaf( m_leaves[i], searches.Begin(), stats );
+               for ( int j : m_leaves[i].searches )
+                  if ( m_sourceLimits[j] != uint32_max )
+                  {
+                     m_counts[j].Store( int( searches[j].stars.Length() ) );
+                     size_type preceding = 0;
+                     for ( int k = 0; k < m_index; ++k )
+                        preceding += size_type( m_threads[k].m_counts[j].Load() );
+                     searches[j].sourceLimit = ThreadSourceLimit( m_sourceLimits[j], searches[j].stars.Length(), preceding );
+                  }
+            }
+         }
+         catch ( const Exception& x )
+         {
+            errorMessage = x.Message();
+         }
+         catch ( ... )
+         {
+            errorMessage = "Unknown exception in parallel XPSD search thread.";
+         }
+      }
+
+   private:
+
+      const StarDatabaseFile&            m_file;
+      const Array<BatchLeafRef>&         m_leaves;
+      size_type                          m_start, m_end;
+      ReferenceArray<BatchSearchThread>& m_threads; // threads of this batch
+      int                                m_index;   // index of this thread in m_threads
+      Array<uint32>                      m_sourceLimits;
+      Array<AtomicInt>                   m_counts;  // sources found by this thread, per search
+   };
+
    friend class XPSD::IndexTree;
 };
 
@@ -742,13 +1260,7 @@ XPSD::IndexTree::SearchRecursive( uint32 nodeIndex, double ra, double dec, doubl
    if ( IntersectsNodeRegion( ra, dec, r, node ) )
    {
       if ( node.IsLeaf() )
-      {
-         ByteArray block( size_type( node.CompressedBlockSize() ) );
-         m_parent->LoadData( block.Begin(), node.BlockOffset(), node.CompressedBlockSize(), searchData );
-         if ( node.CompressedBlockSize() != node.BlockSize() )
-            m_parent->Uncompress( block, node.BlockSize(), searchData );
-         m_parent->GetEncodedData( block, *this, node, searchData );
-      }
+         m_parent->GetEncodedData( m_parent->GetLeafData( node, searchData ), *this, node, searchData );
       else
       {
          if ( node.index.child.nw != 0 )
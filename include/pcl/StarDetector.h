@@ -63,6 +63,8 @@
 namespace pcl
 {
 
+class PCL_CLASS MeasurementContext;
+
 // ----------------------------------------------------------------------------
 
 /*!
@@ -854,6 +856,26 @@ public:
       return DetectStars( image );
    }
 
+   /*!
+    * Performs star detection with the current parameters, using and updating
+    * the intermediate data cached in the specified measurement \a context.
+    * Returns a dynamic array of Star structures sorted by brightness (flux) in
+    * descending order.
+    *
+    * The result is identical to DetectStars( const ImageVariant& ). However,
+    * the working image, the structure map and the local maxima map are only
+    * computed if they are not already available in the \a context for the
+    * same image and preprocessing parameters. Star detectors with different
+    * detection criteria (sensitivity, peak response, upper limit, etc.) can
+    * therefore share the most expensive stages of the star detection task.
+    * If the same star detection parameters have already been applied to the
+    * same image, the cached list of stars is returned immediately.
+    *
+    * \note This function is thread-safe as long as the \a context is not
+    * used concurrently by other threads. See MeasurementContext.
+    */
+   star_list DetectStars( const ImageVariant& image, MeasurementContext& context ) const;
+
    /*!
     * Computes a binary map of star detection structures for the specified
     * \a image and the current set of star detection parameters.
@@ -899,6 +921,7 @@ protected:
 private:
 
    star_list DetectStars( Image& image ) const;
+   star_list ExtractStars( const Image& image, Image& map, const Image& lmMap ) const;
 };
 
 // ----------------------------------------------------------------------------
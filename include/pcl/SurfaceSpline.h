@@ -282,6 +282,30 @@ protected:
     */
    static void EvaluateHandle( const void* handle, double* z, const double* x, const double* y, double x0, double y0, double r, size_type n );
 
+   /*!
+    * Vectorized evaluation of a PCL-implemented surface spline for a set of
+    * 32-bit floating point coordinates. Evaluation points are processed in
+    * blocks suitable for SIMD execution, and large sets are split across
+    * threads when \a parallel is true. Does not require the core application.
+    */
+   static void EvaluateVector( float* __restrict__ z, const float* __restrict__ x, const float* __restrict__ y, size_type n,
+                               double x0, double y0, double r0,
+                               rbf_type rbf, double e2, bool polynomial, int order,
+                               const float* __restrict__ xn, const float* __restrict__ yn,
+                               const float* __restrict__ spline, int nodes,
+                               bool parallel, int maxProcessors );
+
+   /*!
+    * Vectorized evaluation of a PCL-implemented surface spline for a set of
+    * 64-bit floating point coordinates.
+    */
+   static void EvaluateVector( double* __restrict__ z, const double* __restrict__ x, const double* __restrict__ y, size_type n,
+                               double x0, double y0, double r0,
+                               rbf_type rbf, double e2, bool polynomial, int order,
+                               const double* __restrict__ xn, const double* __restrict__ yn,
+                               const double* __restrict__ spline, int nodes,
+                               bool parallel, int maxProcessors );
+
    /*!
     * Generate a plain text serialization of a core surface spline object.
     */
@@ -355,7 +379,7 @@ protected:
  * PointGridInterpolation, ShepardInterpolation, SurfacePolynomial
  */
 template <typename T>
-class PCL_CLASS SurfaceSpline : private SurfaceSplineBase
+class PCL_CLASS SurfaceSpline : private SurfaceSplineBase, public ParallelProcess
 {
 public:
 
@@ -398,7 +422,8 @@ public:
     * Copy constructor.
     */
    SurfaceSpline( const SurfaceSpline& S )
-      : m_rbf( S.m_rbf )
+      : ParallelProcess( S )
+      , m_rbf( S.m_rbf )
       , m_havePolynomial( S.m_havePolynomial )
       , m_eps( S.m_eps )
       , m_eps2( S.m_eps2 )
@@ -421,7 +446,8 @@ public:
     * Move constructor.
     */
    SurfaceSpline( SurfaceSpline&& S )
-      : m_rbf( S.m_rbf )
+      : ParallelProcess( S )
+      , m_rbf( S.m_rbf )
       , m_havePolynomial( S.m_havePolynomial )
       , m_eps( S.m_eps )
       , m_eps2( S.m_eps2 )
@@ -458,6 +484,7 @@ public:
       if ( &S != this )
       {
          Clear();
+         (void)ParallelProcess::operator =( S );
          m_rbf = S.m_rbf;
          m_havePolynomial = S.m_havePolynomial;
          m_eps = S.m_eps;
@@ -486,6 +513,7 @@ public:
       if ( &S != this )
       {
          Clear();
+         (void)ParallelProcess::operator =( S );
          m_rbf = S.m_rbf;
          m_havePolynomial = S.m_havePolynomial;
          m_eps = S.m_eps;
@@ -1108,9 +1136,11 @@ public:
     *
     * For core DDM-RBF interpolation/approximation, this is a support function
     * for fast multithreaded evaluation of the surface spline at large-scale
-    * sets of interpolation points. For PCL RBF implementations this function
-    * can be convenient, but it does not provide any significant performance
-    * improvement.
+    * sets of interpolation points. For PCL RBF implementations, points are
+    * evaluated by a vectorized PCL engine that does not require the core
+    * application. If parallel processing is enabled for this object and this
+    * function is called from the root thread, large point sets are split
+    * across up to MaxProcessors() threads.
     *
     * \note This function provides compatibility with the GridInterpolation and
     * PointGridInterpolation classes.
@@ -1126,8 +1156,10 @@ public:
       if ( m_handle != 0 )
          EvaluateHandle( m_handle, Z, X, Y, m_x0, m_y0, m_r0, n );
       else
-         for ( size_type i = 0; i < n; ++i )
-            Z[i] = operator()( X[i], Y[i] );
+         EvaluateVector( Z, X, Y, n, m_x0, m_y0, m_r0,
+                         m_rbf, m_eps2, m_havePolynomial, m_order,
+                         m_x.Begin(), m_y.Begin(), m_spline.Begin(), m_x.Length(),
+                         IsParallelProcessingEnabled(), MaxProcessors() );
    }
 
    /*!
@@ -1153,15 +1185,16 @@ public:
    /*!
     * Returns true iff this object can be evaluated for vectors of points in
     * 2-D space efficiently by calling the Evaluate() member functions. In
-    * current PCL versions, this member function only returns true for RBF
-    * interpolation/approximation algorithms with core implementations.
+    * current PCL versions, this member function returns true for all valid
+    * surface splines, since both core and PCL RBF implementations provide
+    * vectorized evaluation.
     *
     * \note This function provides compatibility with the GridInterpolation and
     * PointGridInterpolation classes.
     */
    bool HasFastVectorEvaluation() const
    {
-      return m_handle != 0;
+      return IsValid();
    }
 
 protected:
@@ -1897,8 +1930,9 @@ public:
    /*!
     * Returns true iff this object can be evaluated for vectors of points in
     * 2-D space efficiently by calling the Evaluate() member functions. In
-    * current PCL versions, this member function only returns true for RBF
-    * interpolation/approximation algorithms with core implementations.
+    * current PCL versions, this member function returns true for all valid
+    * surface splines, since both core and PCL RBF implementations provide
+    * vectorized evaluation.
     *
     * \note This function provides compatibility with the
     * PointGridInterpolation class.
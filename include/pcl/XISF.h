@@ -369,6 +369,12 @@ public:
     */
    constexpr static bool DefaultWarningsAreErrors = false;
 
+   /*!
+    * Whether to spool uncompressed image data written incrementally to a
+    * temporary file by default.
+    */
+   constexpr static bool DefaultSpoolImageData = false;
+
    /*!
     * The namespace prefix of all %XISF reserved properties.
     */
@@ -395,6 +401,7 @@ public:
    static const bool DefaultAutoMetadata;
    static const bool DefaultNoWarnings;
    static const bool DefaultWarningsAreErrors;
+   static const bool DefaultSpoolImageData;
    static const char* InternalNamespacePrefix;
 
 #endif // !__clang__
@@ -650,6 +657,7 @@ public:
    uint8                   compressionLevel   : 7;  //!< Codec-independent compression level: 0 = auto, 1 = fast, 100 = maximum compression.
    uint8                   verbosity          : 3;  //!< Verbosity level: 0 = quiet, > 0 = write console state messages.
    bool                    fixNonFinite       : 1;  //!< Replace NaNs, infinities and negative zeros with lower bound values in floating point images (reading only).
+   bool                    spoolImageData     : 1;  //!< Spool uncompressed image data written incrementally to a temporary file (writing only).
    uint16                  blockAlignmentSize;      //!< Block alignment size in bytes (0 = 1 = unaligned).
    uint16                  maxInlineBlockSize;      //!< Maximum size in bytes of an inline/embedded block.
    double                  outputLowerBound;        //!< Lower bound for output floating point pixel samples (=0.0 by default).
@@ -691,6 +699,7 @@ public:
       compressionLevel   = XISF::DefaultCompressionLevel;
       verbosity          = XISF::DefaultVerbosity;
       fixNonFinite       = XISF::DefaultFixNonFinite;
+      spoolImageData     = XISF::DefaultSpoolImageData;
       blockAlignmentSize = XISF::DefaultBlockAlignSize;
       maxInlineBlockSize = XISF::DefaultMaxBlockInlineSize;
       outputLowerBound   = XISF::DefaultOutputLowerBound;
@@ -1537,6 +1546,13 @@ public:
     *
     * The data type and other image parameters are defined by the current set
     * of format-independent options (see SetImageOptions()).
+    *
+    * By default the whole image is held in memory until CloseImage() is
+    * called. If the XISFOptions::spoolImageData option is enabled, no
+    * compression codec has been selected, and the image is too large to be
+    * stored as an inline block, pixel samples written by WriteSamples() are
+    * spooled to a temporary file in the directory of the output file, which
+    * is removed when the stream is closed.
     */
    void CreateImage( const ImageInfo& info );
 
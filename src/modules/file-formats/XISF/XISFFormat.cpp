@@ -229,6 +229,13 @@ String XISFFormat::Implementation() const
 "\nupper-bound n           ( w)  n is the upper bound of the output range for"
 "\n                              generated pixel sample data."
 "\n-------------------------------------------------------------------------------"
+"\nspool-image-data        ( w)  Write uncompressed image data generated"
+"\n                              incrementally to a temporary file, instead of"
+"\n                              holding the whole image in memory."
+"\n-------------------------------------------------------------------------------"
+"\nno-spool-image-data     ( w)  Hold image data generated incrementally in"
+"\n                              memory until the image is closed."
+"\n-------------------------------------------------------------------------------"
 "\n"
    "</p>"
    "</html>";
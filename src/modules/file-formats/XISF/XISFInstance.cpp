@@ -178,6 +178,7 @@ public:
    HintValue<double>            outputLowerBound;
    HintValue<double>            outputUpperBound;
    HintValue<bool>              fixNonFinite;
+   HintValue<bool>              spoolImageData;
 
    XISFStreamHints( const IsoString& hints )
    {
@@ -333,6 +334,10 @@ public:
             fixNonFinite = true;
          else if ( *i == "ignore-non-finite" )
             fixNonFinite = false;
+         else if ( *i == "spool-image-data" )
+            spoolImageData = true;
+         else if ( *i == "no-spool-image-data" )
+            spoolImageData = false;
       }
    }
 
@@ -417,6 +422,9 @@ public:
       if ( fixNonFinite.HasChanged() )
          hints << (fixNonFinite.Value() ? "fix-non-finite" : "ignore-non-finite");
 
+      if ( spoolImageData.HasChanged() )
+         hints << (spoolImageData.Value() ? "spool-image-data" : "no-spool-image-data");
+
       return IsoString().ToSpaceSeparated( hints );
    }
 
@@ -492,6 +500,8 @@ public:
          options.outputLowerBound = outputLowerBound;
       if ( outputUpperBound.HasChanged() )
          options.outputUpperBound = outputUpperBound;
+      if ( spoolImageData.HasChanged() )
+         options.spoolImageData = spoolImageData;
    }
 };
 
@@ -291,6 +291,7 @@ void APASSInstance::Search()
          p_searchData.excessCount += thread.data.excessCount;
          p_searchData.rejectCount += thread.data.rejectCount;
          p_searchData.countIO += thread.data.countIO;
+         p_searchData.countCacheHits += thread.data.countCacheHits;
          if ( thread.data.timeTotal > p_searchData.timeTotal )
             p_searchData.timeTotal = thread.data.timeTotal;
          if ( thread.data.timeIO > p_searchData.timeIO )
@@ -362,7 +363,9 @@ void APASSInstance::Search()
          "\nTotal I/O time ............. " + ElapsedTime::ToString( p_searchData.timeIO, 2 ) +
          "\nTotal I/O operations ....... " + String( p_searchData.countIO ) +
          "\nTotal uncompression time ... " + ElapsedTime::ToString( p_searchData.timeUncompress, 2 ) +
-         "\nTotal decoding time ........ " + ElapsedTime::ToString( p_searchData.timeDecode, 2 ) );
+         "\nTotal decoding time ........ " + ElapsedTime::ToString( p_searchData.timeDecode, 2 ) +
+         "\nBlock cache hits ........... " + String( p_searchData.countCacheHits ) +
+         String().Format( " (%.1f%%)", 100*p_searchData.CacheHitRatio() ) );
       break;
    }
 }
@@ -798,6 +801,8 @@ void* APASSInstance::LockParameter( const MetaParameter* p, size_type tableRow )
       return &p_searchData.timeUncompress;
    if ( p == TheATimeDecodeParameter )
       return &p_searchData.timeDecode;
+   if ( p == TheACountCacheHitsParameter )
+      return &p_searchData.countCacheHits;
    if ( p == TheADatabaseFilePathParameter )
       return p_databaseFilePaths[tableRow].Begin();
    if ( p == TheAIsValidParameter )
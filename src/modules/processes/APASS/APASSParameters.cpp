@@ -101,6 +101,7 @@ ATimeIO*                TheATimeIOParameter = nullptr;
 ACountIO*               TheACountIOParameter = nullptr;
 ATimeUncompress*        TheATimeUncompressParameter = nullptr;
 ATimeDecode*            TheATimeDecodeParameter = nullptr;
+ACountCacheHits*        TheACountCacheHitsParameter = nullptr;
 AIsValid*               TheAIsValidParameter = nullptr;
 AOutputDataRelease*     TheAOutputDataReleaseParameter = nullptr;
 ADatabaseMagnitudeLow*  TheADatabaseMagnitudeLowParameter = nullptr;
@@ -1074,6 +1075,24 @@ bool ATimeDecode::IsReadOnly() const
 
 // ----------------------------------------------------------------------------
 
+ACountCacheHits::ACountCacheHits( MetaProcess* P )
+   : MetaUInt32( P )
+{
+   TheACountCacheHitsParameter = this;
+}
+
+IsoString ACountCacheHits::Id() const
+{
+   return "countCacheHits";
+}
+
+bool ACountCacheHits::IsReadOnly() const
+{
+   return true;
+}
+
+// ----------------------------------------------------------------------------
+
 AIsValid::AIsValid( MetaProcess* P )
    : MetaBoolean( P )
 {
@@ -738,6 +738,20 @@ extern ATimeDecode* TheATimeDecodeParameter;
 
 // ----------------------------------------------------------------------------
 
+class ACountCacheHits : public MetaUInt32
+{
+public:
+
+   ACountCacheHits( MetaProcess* );
+
+   IsoString Id() const override;
+   bool IsReadOnly() const override;
+};
+
+extern ACountCacheHits* TheACountCacheHitsParameter;
+
+// ----------------------------------------------------------------------------
+
 class AIsValid : public MetaBoolean
 {
 public:
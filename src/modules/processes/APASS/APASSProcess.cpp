@@ -155,6 +155,7 @@ APASSProcess::APASSProcess()
    new ACountIO( this );
    new ATimeUncompress( this );
    new ATimeDecode( this );
+   new ACountCacheHits( this );
    new AIsValid( this );
    new AOutputDataRelease( this );
    new ADatabaseMagnitudeLow( this );
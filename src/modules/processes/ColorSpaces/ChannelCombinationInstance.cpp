@@ -231,6 +231,55 @@ static void ToRGB( int colorSpace,
 
 // ----------------------------------------------------------------------------
 
+/*
+ * Batch conversions, performed in-place on rows of pixels.
+ */
+static void FromRGB( int colorSpace, const RGBColorSystem& rgbws, float* ch0, float* ch1, float* ch2, size_type n )
+{
+   switch ( colorSpace )
+   {
+   case ColorSpaceId::CIEXYZ:
+      rgbws.RGBToCIEXYZ( ch0, ch1, ch2, ch0, ch1, ch2, n );
+      break;
+   case ColorSpaceId::CIELab:
+      rgbws.RGBToCIELab( ch0, ch1, ch2, ch0, ch1, ch2, n );
+      break;
+   case ColorSpaceId::CIELch:
+      rgbws.RGBToCIELch( ch0, ch1, ch2, ch0, ch1, ch2, n );
+      break;
+   case ColorSpaceId::HSV:
+      RGBColorSystem::RGBToHSV( ch0, ch1, ch2, ch0, ch1, ch2, n );
+      break;
+   case ColorSpaceId::HSI:
+      RGBColorSystem::RGBToHSI( ch0, ch1, ch2, ch0, ch1, ch2, n );
+      break;
+   }
+}
+
+static void ToRGB( int colorSpace, const RGBColorSystem& rgbws, float* ch0, float* ch1, float* ch2, size_type n )
+{
+   switch ( colorSpace )
+   {
+   case ColorSpaceId::CIEXYZ:
+      rgbws.CIEXYZToRGB( ch0, ch1, ch2, ch0, ch1, ch2, n );
+      break;
+   case ColorSpaceId::CIELab:
+      rgbws.CIELabToRGB( ch0, ch1, ch2, ch0, ch1, ch2, n );
+      break;
+   case ColorSpaceId::CIELch:
+      rgbws.CIELchToRGB( ch0, ch1, ch2, ch0, ch1, ch2, n );
+      break;
+   case ColorSpaceId::HSV:
+      RGBColorSystem::HSVToRGB( ch0, ch1, ch2, ch0, ch1, ch2, n );
+      break;
+   case ColorSpaceId::HSI:
+      RGBColorSystem::HSIToRGB( ch0, ch1, ch2, ch0, ch1, ch2, n );
+      break;
+   }
+}
+
+// ----------------------------------------------------------------------------
+
 template <class P, class P0, class P1, class P2>
 #ifdef __GNUC__
 __attribute__((noinline))
@@ -247,12 +296,68 @@ static void CombineChannels( GenericImage<P>& img, int colorSpace, const String&
 
    const RGBColorSystem& rgbws = img.RGBWorkingSpace();
 
+   /*
+    * Color space conversions are vectorized batch conversions by rows of
+    * pixels, unless the target image requires more than single floating
+    * point precision.
+    */
+   bool useBatchConversions = colorSpace != ColorSpaceId::RGB &&
+                              (P::BitsPerSample() <= 16 || P::IsFloatSample() && P::BitsPerSample() == 32);
+   FVector c0, c1, c2;
+   if ( useBatchConversions )
+   {
+      c0 = FVector( r.Width() );
+      c1 = FVector( r.Width() );
+      c2 = FVector( r.Width() );
+   }
+
    for ( int y = r.y0; y < r.y1; ++y )
    {
       const typename P0::sample* data0 = (src0 != 0) ? src0->PixelAddress( r.x0, y ) : 0;
       const typename P1::sample* data1 = (src1 != 0) ? src1->PixelAddress( r.x0, y ) : 0;
       const typename P2::sample* data2 = (src2 != 0) ? src2->PixelAddress( r.x0, y ) : 0;
 
+      if ( useBatchConversions )
+      {
+         const size_type n = r.Width();
+         float* __restrict__ f0 = c0.Begin();
+         float* __restrict__ f1 = c1.Begin();
+         float* __restrict__ f2 = c2.Begin();
+
+         if ( !allChannels )
+         {
+            for ( size_type i = 0; i < n; ++i )
+            {
+               P::FromSample( f0[i], R[i] );
+               P::FromSample( f1[i], G[i] );
+               P::FromSample( f2[i], B[i] );
+            }
+            FromRGB( colorSpace, rgbws, f0, f1, f2, n );
+         }
+
+         if ( data0 != 0 )
+            for ( size_type i = 0; i < n; ++i )
+               P0::FromSample( f0[i], data0[i] );
+         if ( data1 != 0 )
+            for ( size_type i = 0; i < n; ++i )
+               P1::FromSample( f1[i], data1[i] );
+         if ( data2 != 0 )
+            for ( size_type i = 0; i < n; ++i )
+               P2::FromSample( f2[i], data2[i] );
+
+         ToRGB( colorSpace, rgbws, f0, f1, f2, n );
+
+         for ( size_type i = 0; i < n; ++i )
+         {
+            *R++ = P::ToSample( f0[i] );
+            *G++ = P::ToSample( f1[i] );
+            *B++ = P::ToSample( f2[i] );
+         }
+
+         img.Status() += n;
+         continue;
+      }
+
       for ( int x = r.x0; x < r.x1; ++x, ++img.Status() )
       {
          if ( colorSpace == ColorSpaceId::RGB )
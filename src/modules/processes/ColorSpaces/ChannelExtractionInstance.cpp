@@ -278,66 +278,130 @@ static void ExtractChannels( const GenericImage<P>& img, const View& view,
       const typename P::sample* B = img.PixelData( 2 );
       const typename P::sample* RN = R + N;
 
-      for ( ;; )
+      /*
+       * CIE and HSV/HSI components are computed with vectorized batch
+       * conversions over blocks of pixels, unless the target sample type
+       * requires more than single floating point precision.
+       */
+      bool useBatchConversions = E.ColorSpace() != ColorSpaceId::RGB &&
+                                 (P1::BitsPerSample() <= 16 || P1::IsFloatSample() && P1::BitsPerSample() == 32);
+
+      if ( useBatchConversions )
       {
-         if ( E.ColorSpace() == ColorSpaceId::RGB )
-         {
-            if ( E.IsChannelEnabled( 0 ) )
-               P::FromSample( *data[0], *R );
-            if ( E.IsChannelEnabled( 1 ) )
-               P::FromSample( *data[1], *G );
-            if ( E.IsChannelEnabled( 2 ) )
-               P::FromSample( *data[2], *B );
-         }
-         else
+         const int blockSize = 4096;
+         FVector r( blockSize ), g( blockSize ), b( blockSize );
+         float* ch[ 3 ] = { r.Begin(), g.Begin(), b.Begin() };
+
+         for ( size_type i = 0; i < N; )
          {
-            RGBColorSystem::sample r, g, b;
-            P::FromSample( r, *R );
-            P::FromSample( g, *G );
-            P::FromSample( b, *B );
+            size_type n = Min( size_type( blockSize ), N - i );
 
-            RGBColorSystem::sample ch0, ch1, ch2;
+            for ( size_type j = 0; j < n; ++j )
+            {
+               P::FromSample( r[j], R[i+j] );
+               P::FromSample( g[j], G[i+j] );
+               P::FromSample( b[j], B[i+j] );
+            }
 
+            // Batch conversions are performed in-place.
             if ( isLightness )
-               ch0 = rgbws.Lightness( r, g, b );
-            else if ( isValue )
-               ch2 = rgbws.Value( r, g, b );
-            else if ( isIntensity )
-               ch2 = rgbws.Intensity( r, g, b );
+               rgbws.RGBToCIEL( ch[0], ch[0], ch[1], ch[2], n );
             else
                switch ( E.ColorSpace() )
                {
                case ColorSpaceId::CIEXYZ :
-                  rgbws.RGBToCIEXYZ( ch0, ch1, ch2, r, g, b );
+                  rgbws.RGBToCIEXYZ( ch[0], ch[1], ch[2], ch[0], ch[1], ch[2], n );
                   break;
                case ColorSpaceId::CIELab :
-                  rgbws.RGBToCIELab( ch0, ch1, ch2, r, g, b );
+                  rgbws.RGBToCIELab( ch[0], ch[1], ch[2], ch[0], ch[1], ch[2], n );
                   break;
                case ColorSpaceId::CIELch :
-                  rgbws.RGBToCIELch( ch0, ch1, ch2, r, g, b );
+                  rgbws.RGBToCIELch( ch[0], ch[1], ch[2], ch[0], ch[1], ch[2], n );
                   break;
                case ColorSpaceId::HSV :
-                  rgbws.RGBToHSV( ch0, ch1, ch2, r, g, b );
+                  RGBColorSystem::RGBToHSV( ch[0], ch[1], ch[2], ch[0], ch[1], ch[2], n );
                   break;
                case ColorSpaceId::HSI :
-                  rgbws.RGBToHSI( ch0, ch1, ch2, r, g, b );
+                  RGBColorSystem::RGBToHSI( ch[0], ch[1], ch[2], ch[0], ch[1], ch[2], n );
                   break;
                }
 
-            if ( E.IsChannelEnabled( 0 ) )
-               *data[0] = P1::ToSample( ch0 );
-            if ( E.IsChannelEnabled( 1 ) )
-               *data[1] = P1::ToSample( ch1 );
-            if ( E.IsChannelEnabled( 2 ) )
-               *data[2] = P1::ToSample( ch2 );
-         }
-
-         ++img.Status();
-
-         if ( ++R == RN )
-            break;
+            for ( int k = 0; k < 3; ++k )
+               if ( E.IsChannelEnabled( k ) )
+               {
+                  typename P1::sample* __restrict__ t = data[k] + i;
+                  const float* __restrict__ c = ch[k];
+                  for ( size_type j = 0; j < n; ++j )
+                     t[j] = P1::ToSample( c[j] );
+               }
 
-         ++G; ++B; ++data[0]; ++data[1]; ++data[2];
+            i += n;
+            img.Status() += n;
+         }
+      }
+      else
+      {
+         for ( ;; )
+         {
+            if ( E.ColorSpace() == ColorSpaceId::RGB )
+            {
+               if ( E.IsChannelEnabled( 0 ) )
+                  P::FromSample( *data[0], *R );
+               if ( E.IsChannelEnabled( 1 ) )
+                  P::FromSample( *data[1], *G );
+               if ( E.IsChannelEnabled( 2 ) )
+                  P::FromSample( *data[2], *B );
+            }
+            else
+            {
+               RGBColorSystem::sample r, g, b;
+               P::FromSample( r, *R );
+               P::FromSample( g, *G );
+               P::FromSample( b, *B );
+
+               RGBColorSystem::sample ch0, ch1, ch2;
+
+               if ( isLightness )
+                  ch0 = rgbws.Lightness( r, g, b );
+               else if ( isValue )
+                  ch2 = rgbws.Value( r, g, b );
+               else if ( isIntensity )
+                  ch2 = rgbws.Intensity( r, g, b );
+               else
+                  switch ( E.ColorSpace() )
+                  {
+                  case ColorSpaceId::CIEXYZ :
+                     rgbws.RGBToCIEXYZ( ch0, ch1, ch2, r, g, b );
+                     break;
+                  case ColorSpaceId::CIELab :
+                     rgbws.RGBToCIELab( ch0, ch1, ch2, r, g, b );
+                     break;
+                  case ColorSpaceId::CIELch :
+                     rgbws.RGBToCIELch( ch0, ch1, ch2, r, g, b );
+                     break;
+                  case ColorSpaceId::HSV :
+                     rgbws.RGBToHSV( ch0, ch1, ch2, r, g, b );
+                     break;
+                  case ColorSpaceId::HSI :
+                     rgbws.RGBToHSI( ch0, ch1, ch2, r, g, b );
+                     break;
+                  }
+
+               if ( E.IsChannelEnabled( 0 ) )
+                  *data[0] = P1::ToSample( ch0 );
+               if ( E.IsChannelEnabled( 1 ) )
+                  *data[1] = P1::ToSample( ch1 );
+               if ( E.IsChannelEnabled( 2 ) )
+                  *data[2] = P1::ToSample( ch2 );
+            }
+
+            ++img.Status();
+
+            if ( ++R == RN )
+               break;
+
+            ++G; ++B; ++data[0]; ++data[1]; ++data[2];
+         }
       }
 
       for ( int i = 0; i < 3; ++i )
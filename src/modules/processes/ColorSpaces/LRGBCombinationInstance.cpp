@@ -519,6 +519,21 @@ static void CombineLRGB( GenericImage<P>& img, const Rect& r,
       else
          clip = false;
 
+   /*
+    * CIE conversions are vectorized batch conversions by rows of pixels,
+    * unless the target image requires more than single floating point
+    * precision.
+    */
+   bool useBatchConversions = isCIE && (P::BitsPerSample() <= 16 || P::IsFloatSample() && P::BitsPerSample() == 32);
+   FVector bR, bG, bB, bL;
+   if ( useBatchConversions )
+   {
+      bR = FVector( r.Width() );
+      bG = FVector( r.Width() );
+      bB = FVector( r.Width() );
+      bL = FVector( r.Width() );
+   }
+
    for ( int y = r.y0; y < r.y1; ++y )
    {
       const typename P0::sample* dataR = (srcR != 0) ? srcR->PixelAddress( r.x0, y ) : 0;
@@ -553,10 +568,11 @@ static void CombineLRGB( GenericImage<P>& img, const Rect& r,
             }
       }
 
-      for ( int x = r.x0; x < r.x1; ++x, ++img.Status() )
+      /*
+       * Input RGB components, scaled and clipped.
+       */
+      auto ReadRGB = [&]( RGBColorSystem::sample& R, RGBColorSystem::sample& G, RGBColorSystem::sample& B )
       {
-         RGBColorSystem::sample R, G, B;
-
          if ( dataR != 0 )
             P0::FromSample( R, *dataR++ );
          else
@@ -598,45 +614,129 @@ static void CombineLRGB( GenericImage<P>& img, const Rect& r,
                B = 1;
             else
                B /= clipValue;
+      };
 
-         if ( isCIE )
-         {
-            RGBColorSystem::sample L;
+      /*
+       * Input lightness component.
+       */
+      auto ReadL = [&]()
+      {
+         RGBColorSystem::sample L;
+         if ( srcL.IsFloatSample() )
+            switch ( srcL.BitsPerSample() )
+            {
+            case 32:
+               FloatPixelTraits::FromSample( L, *(float*)dataL );
+               break;
+            case 64:
+               DoublePixelTraits::FromSample( L, *(double*)dataL );
+               break;
+            default:
+               L = 0;
+               break;
+            }
+         else
+            switch ( srcL.BitsPerSample() )
+            {
+            case  8:
+               UInt8PixelTraits::FromSample( L, *(uint8*)dataL );
+               break;
+            case 16:
+               UInt16PixelTraits::FromSample( L, *(uint16*)dataL );
+               break;
+            case 32:
+               UInt32PixelTraits::FromSample( L, *(uint32*)dataL );
+               break;
+            default:
+               L = 0;
+               break;
+            }
 
+         dataL += srcL.BytesPerSample();
+         return L;
+      };
+
+      if ( useBatchConversions )
+      {
+         const size_type n = r.Width();
+         float* __restrict__ fR = bR.Begin();
+         float* __restrict__ fG = bG.Begin();
+         float* __restrict__ fB = bB.Begin();
+         float* __restrict__ fL = bL.Begin();
+         typename P::sample* __restrict__ rowR = dstR;
+         typename P::sample* __restrict__ rowG = dstG;
+         typename P::sample* __restrict__ rowB = dstB;
+
+         for ( size_type i = 0; i < n; ++i )
+         {
+            RGBColorSystem::sample R, G, B;
+            ReadRGB( R, G, B );
+            fR[i] = float( R );
+            fG[i] = float( G );
+            fB[i] = float( B );
             if ( dataL != 0 )
+               fL[i] = float( ReadL() );
+            ++dstR; ++dstG; ++dstB;
+         }
+
+         if ( dataL == 0 )
+            rgbws.RGBToCIEL( fL, fR, fG, fB, n );
+
+         // In-place conversions: R,G,B -> L0,c,h or L0,a,b
+         if ( isSaturationMTF )
+            rgbws.RGBToCIELch( fR, fG, fB, fR, fG, fB, n );
+         else
+            rgbws.RGBToCIELab( fR, fG, fB, fR, fG, fB, n );
+
+         for ( size_type i = 0; i < n; ++i )
+         {
+            double L = fL[i];
+
+            if ( isLuminanceMTF )
+               L = HistogramTransformation::MTF( mL, L );
+
+            if ( isKL )
             {
-               if ( srcL.IsFloatSample() )
-                  switch ( srcL.BitsPerSample() )
-                  {
-                  case 32:
-                     FloatPixelTraits::FromSample( L, *(float*)dataL );
-                     break;
-                  case 64:
-                     DoublePixelTraits::FromSample( L, *(double*)dataL );
-                     break;
-                  default:
-                     L = 0;
-                     break;
-                  }
-               else
-                  switch ( srcL.BitsPerSample() )
-                  {
-                  case  8:
-                     UInt8PixelTraits::FromSample( L, *(uint8*)dataL );
-                     break;
-                  case 16:
-                     UInt16PixelTraits::FromSample( L, *(uint16*)dataL );
-                     break;
-                  case 32:
-                     UInt32PixelTraits::FromSample( L, *(uint32*)dataL );
-                     break;
-                  default:
-                     L = 0;
-                     break;
-                  }
+               L *= k[3];
+               L += k31*fR[i];
+            }
 
-               dataL += srcL.BytesPerSample();
+            if ( isSaturationMTF )
+            {
+               double c = fG[i];
+               fG[i] = float( HistogramTransformation::MTF( mc, c )*L + c*(1 - L) );
             }
+
+            fL[i] = float( L );
+         }
+
+         if ( isSaturationMTF )
+            rgbws.CIELchToRGB( fR, fG, fB, fL, fG, fB, n );
+         else
+            rgbws.CIELabToRGB( fR, fG, fB, fL, fG, fB, n );
+
+         for ( size_type i = 0; i < n; ++i )
+         {
+            rowR[i] = P::ToSample( fR[i] );
+            rowG[i] = P::ToSample( fG[i] );
+            rowB[i] = P::ToSample( fB[i] );
+         }
+
+         img.Status() += n;
+         continue;
+      }
+
+      for ( int x = r.x0; x < r.x1; ++x, ++img.Status() )
+      {
+         RGBColorSystem::sample R, G, B;
+         ReadRGB( R, G, B );
+
+         if ( isCIE )
+         {
+            RGBColorSystem::sample L;
+
+            if ( dataL != 0 )
+               L = ReadL();
             else
                L = CIEL( rgbws, R, G, B );
 
@@ -152,7 +152,9 @@ public:
                  || H.Size() > image.Width()
                  || H.Size() > image.Height() )
             {
-               FFTConvolution( H ) >> image;
+               FFTConvolution Z( H );
+               Z.EnableTiledConvolution();
+               Z >> image;
             }
             else if ( H.IsSeparable() && H.Size() >= SeparableConvolution::FasterThanNonseparableFilterSize( nofThreads ) )
             {
@@ -189,6 +191,7 @@ public:
                else
                {
                   FFTConvolution Z( F.Kernel() );
+                  Z.EnableTiledConvolution();
                   Z >> image;
                   if ( instance.rescaleHighPass )
                      image.Normalize();
@@ -205,6 +208,7 @@ public:
 
             ImageVariant v( view.Image() );
             FFTConvolution Z( v );
+            Z.EnableTiledConvolution();
             Z >> image;
          }
          break;
@@ -299,7 +303,10 @@ void ConvolutionInstance::Convolve( Image& image, int zoomLevel ) const
    S.SetAbsMode( AbsoluteResizeMode::ForceWidthAndHeight );
    S >> h;
 
-   FFTConvolution( ImageVariant( &h ) ) >> image;
+   ImageVariant v( &h );
+   FFTConvolution Z( v );
+   Z.EnableTiledConvolution();
+   Z >> image;
 }
 
 // ----------------------------------------------------------------------------
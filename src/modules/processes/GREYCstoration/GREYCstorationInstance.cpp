@@ -68,29 +68,14 @@
 #include "GREYCstorationInstance.h"
 #include "GREYCstorationParameters.h"
 
+#include <pcl/Atomic.h>
 #include <pcl/AutoViewLock.h>
-#include <pcl/View.h>
-#include <pcl/StandardStatus.h>
 #include <pcl/Console.h>
+#include <pcl/GaussianFilter.h>
+#include <pcl/SeparableConvolution.h>
+#include <pcl/StandardStatus.h>
 #include <pcl/Thread.h>
-#include <pcl/AutoLock.h>
-#include <pcl/GlobalSettings.h>
-
-static pcl::Mutex     GREYCstoration_mutex1;
-static pcl::Mutex     GREYCstoration_mutex2;
-static pcl::size_type GREYCstoration_count = 0;
-static bool           GREYCstoration_abort = false;
-
-#define cimg_debug 0
-#define cimg_display 0
-#define cimg_use_openmp 0
-#define cimg_verbosity 0
-
-#define cimg_pixinsight_module_greycstoration 1
-
-#include "CImg/CImg.h"
-
-#undef Status
+#include <pcl/View.h>
 
 namespace pcl
 {
@@ -167,392 +152,559 @@ bool GREYCstorationInstance::CanExecuteOn( const View& view, pcl::String& whyNot
 // ----------------------------------------------------------------------------
 // ----------------------------------------------------------------------------
 
-template <typename T>
-class GREYCstorationThread : public Thread
+/*
+ * Native implementation of the GREYCstoration anisotropic diffusion algorithm
+ * for two-dimensional images, after CImg<T>::blur_anisotropic() by David
+ * Tschumperlé.
+ *
+ * Each iteration computes a single field of diffusion tensors for the whole
+ * image, which is shared by all processing threads. Then the image is
+ * smoothed by line integral convolutions (LIC) along the streamlines of the
+ * vector fields defined by the tensors for a set of uniformly distributed
+ * directions. LIC passes are distributed among threads as square tiles
+ * claimed dynamically, so there are no overlapping bands to copy back and
+ * forth, and the number of working threads does not depend on the image
+ * height. Pixels are transformed in place, with a single accumulation image
+ * reused across iterations.
+ */
+class GREYCstorationEngine
 {
 public:
 
-   GREYCstorationThread( cimg_library::CImg<T>* aImage,
-                         const GREYCstorationInstance& aInstance,
-                         int startRow, int endRow )
-      : cimg( aImage )
-      , instance( aInstance )
-      , y0( startRow )
-      , y1( endRow )
+   template <class P>
+   static void Apply( GenericImage<P>& img, const GREYCstorationInstance& instance )
    {
-   }
+      typedef typename P::sample sample;
 
-   virtual ~GREYCstorationThread()
-   {
-      if ( cimg != nullptr )
-         delete cimg, cimg = nullptr;
-   }
+      int w = img.Width();
+      int h = img.Height();
+      int n = img.NumberOfNominalChannels();
 
-   void Run() override; // Defined after GREYCstorationEngine
+      /*
+       * In the normal working mode, all nominal channels are processed as a
+       * single unit. The alternative mode processes each color channel as an
+       * independent image. Using the alternative mode is not recommended on a
+       * regular basis because it lacks GREYCstoration's strongest point for
+       * color image denoising: manage the relationships between color
+       * components as a single mathematical object.
+       *
+       * Alpha channels are never processed.
+       */
+      int groupChannels = (n > 1 && !instance.coupledChannels) ? 1 : n;
 
-   const cimg_library::CImg<T>* Image() const
-   {
-      return cimg;
-   }
+      /*
+       * LIC directions, exactly as generated by CImg.
+       */
+      Array<float> angles;
+      {
+         float da = instance.angularStepSize;
+         for ( float theta = float( 360 - da*Floor( 360.0/da ) )/2; theta < 360; theta += da )
+            angles << theta;
+      }
 
-   int StartRow() const
-   {
-      return y0;
-   }
+      int numberOfTiles = ((w + TileSize - 1)/TileSize)*((h + TileSize - 1)/TileSize);
 
-   int EndRow() const
-   {
-      return y1;
-   }
+      StatusMonitor status = img.Status();
+      status.Initialize( String( "Processing " ) + ((n == 1) ? "grayscale pixel data" :
+                               (instance.coupledChannels ? "multichannel pixel data" :
+                                                           "separate color channels" )),
+                         size_type( instance.numberOfIterations )*(n/groupChannels)*angles.Length()*numberOfTiles );
+
+      GenericImage<P> T; // diffusion tensors
+      T.AllocateData( w, h, 3 );
+      GenericImage<P> V; // LIC vector field
+      V.AllocateData( w, h, 3 );
+      GenericImage<P> R; // LIC accumulation
+      R.AllocateData( w, h, groupChannels );
+
+      for ( int it = 0; it < instance.numberOfIterations; ++it )
+         for ( int c0 = 0; c0 < n; c0 += groupChannels )
+         {
+            DiffusionTensors( T, img, c0, groupChannels, instance );
 
-   int NumberOfRows() const
-   {
-      return y1 - y0;
-   }
+            sample minValue, maxValue;
+            GetExtremeSampleValues( minValue, maxValue, img, c0, groupChannels );
 
-private:
+            R.Zero();
 
-   cimg_library::CImg<T>* cimg;
-   const GREYCstorationInstance& instance;
-   int y0, y1;
-};
+            for ( float theta : angles )
+            {
+               RunRowThreads<VectorFieldThread<P>>( h, V, T, theta, instance.spatialStepSize );
 
-// ----------------------------------------------------------------------------
-// ----------------------------------------------------------------------------
+               AtomicInt tileCounter;
+               AbstractImage::ThreadData data( status, numberOfTiles );
+               int numberOfThreads = Thread::NumberOfThreads( numberOfTiles, 1 );
+               ReferenceArray<LICThread<P>> threads;
+               for ( int i = 0; i < numberOfThreads; ++i )
+                  threads.Add( new LICThread<P>( data, R, img, c0, V, instance, tileCounter ) );
+               AbstractImage::RunThreads( threads, data );
+               threads.Destroy();
+               status = data.status;
+            }
 
-class GREYCstorationEngine
-{
-public:
+            /*
+             * Average LIC results and constrain them to the initial range of
+             * sample values. This also keeps floating point images within the
+             * normalized [0,1] range.
+             */
+            sample numberOfAngles = sample( angles.Length() );
+            for ( int c = 0; c < groupChannels; ++c )
+            {
+               sample* f = img[c0+c];
+               const sample* r = R[c];
+               for ( size_type i = 0, N = img.NumberOfPixels(); i < N; ++i )
+                  f[i] = Range( r[i]/numberOfAngles, minValue, maxValue );
+            }
+         }
 
-   template <class P>
-   static void Apply( GenericImage<P>& img, const GREYCstorationInstance& instance )
-   {
-      typedef cimg_library::CImg<typename P::sample>   thread_image;
-      typedef GREYCstorationThread<typename P::sample> thread;
+      img.Status() = status;
+   }
 
-      /*
-       * Size of overlapping regions.
-       * The optimal factor of 0.25 has been found by experimentation.
-       */
-      int d = Max( 6, RoundInt( 0.25*instance.amplitude ) );
+private:
 
-      /*
-       * Processing threads
-       */
-      IndirectArray<thread> threads;
+   /*
+    * Size in pixels of the square tiles processed by LIC threads.
+    */
+   constexpr static int TileSize = 64;
 
-      /*
-       * Temporary storage for alpha channels
-       */
-      typename P::sample** alphaChannels = nullptr;
+   /*
+    * Computes the field of diffusion tensors for a group of channels, after
+    * CImg<T>::diffusion_tensors().
+    */
+   template <class P>
+   static void DiffusionTensors( GenericImage<P>& T, const GenericImage<P>& img, int c0, int nc,
+                                 const GREYCstorationInstance& instance )
+   {
+      typedef typename P::sample sample;
 
-      /*
-       * Image geometry, color space and status monitor.
-       */
-      int w = img.Width();
       int h = img.Height();
-      int n = img.NumberOfNominalChannels();
-      int n0 = img.NumberOfChannels();
-      ImageColor::color_space cs = img.ColorSpace();
-      StatusMonitor status = img.Status();
 
-      /*
-       * Thread wait time
-       */
-      uint32 waitTime = 750; // milliseconds
+      GenericImage<P> B;
+      B.AllocateData( img.Width(), h, nc );
+      for ( int c = 0; c < nc; ++c )
+         P::Copy( B[c], img[c0+c], img.NumberOfPixels() );
+      if ( instance.alpha > 0 )
+         SeparableConvolution( GaussianFilter( instance.alpha ).AsSeparableFilter() ) >> B;
 
       /*
-       * Reset global thread control variables
+       * The smoothed image is rescaled to the [0,255] range before computing
+       * structure tensors. Instead of rescaling pixels, we scale the tensors
+       * by the squared scaling factor.
        */
-      ::GREYCstoration_count = 0;
-      ::GREYCstoration_abort = false;
+      sample minValue, maxValue;
+      GetExtremeSampleValues( minValue, maxValue, B, 0, nc );
+      double k = (maxValue > minValue) ? 255/(double( maxValue ) - double( minValue )) : 0.0;
 
-      /*
-       * Monitoring count
-       */
-      size_type lastCount = 0;
+      RunRowThreads<StructureTensorThread<P>>( h, T, B, k*k );
+      B.FreeData();
+
+      if ( instance.sigma > 0 )
+         SeparableConvolution( GaussianFilter( instance.sigma ).AsSeparableFilter() ) >> T;
+
+      RunRowThreads<DiffusionTensorThread<P>>( h, T, instance );
+   }
 
-      try
+   template <class P>
+   static void GetExtremeSampleValues( typename P::sample& minValue, typename P::sample& maxValue,
+                                       const GenericImage<P>& img, int c0, int nc )
+   {
+      minValue = maxValue = *img[c0];
+      for ( int c = c0; c < c0+nc; ++c )
       {
-         /*
-          * Number of threads and number of pixel rows per thread
-          */
-         int numberOfThreads = Thread::NumberOfThreads( h, 2*d );
-         int rowsPerThread = h/numberOfThreads;
-
-         /*
-          * Initialize status monitor
-          */
-         size_type N = size_type( (360 - ((360%int( instance.angularStepSize )) >> 1))/instance.angularStepSize );
-         N = instance.numberOfIterations * w * (h + numberOfThreads*2*d) * (2 + N);
-         if ( P::IsFloatSample() )
-            N += instance.numberOfIterations * w*h; // Normalize() at each iteration
-         if ( n > 1 && !instance.coupledChannels )
-            N *= n;
-         status.Initialize( String( "Processing " ) + ((n == 1) ? "grayscale pixel data" :
-                                   (instance.coupledChannels ? "multichannel pixel data" :
-                                                               "separate color channels" )), N );
-         status.DisableInitialization();
-
-         /*
-          * Save alpha channels, which are not processed in our implementation of GREYCstoration.
-          * We'll restore them after completing GREYCstoration iterations.
-          */
-         if ( n0 > n )
-         {
-            alphaChannels = img.Allocator().AllocateChannelSlots( n0 - n );
-            for ( int c = n; c < n0; ++c )
-               alphaChannels[c-n] = img.PixelData( c );
-            img.ForgetAlphaChannels();
-         }
+         const typename P::sample* f = img[c];
+         for ( size_type i = 0, N = img.NumberOfPixels(); i < N; ++i )
+            if ( f[i] < minValue )
+               minValue = f[i];
+            else if ( f[i] > maxValue )
+               maxValue = f[i];
+      }
+   }
 
-         /*
-          * GREYCstoration iterations
-          */
-         for ( int it = 0; it < instance.numberOfIterations; ++it )
-         {
-            /*
-             * Generate threads
-             * To avoid border artifacts completely, we regenerate all threads
-             * with fresh subimages and overlapping regions at each iteration.
-             */
-            for ( int i = 0; i < numberOfThreads; ++i )
-            {
-               /*
-                * Starting and end rows for this thread referred to the
-                * original image (excluding overlapping regions).
-                */
-               int y0 = i*rowsPerThread;
-               int y1 = (i < numberOfThreads-1) ? (i + 1)*rowsPerThread : h;
-
-               /*
-                * Number of non-overlapping pixel rows in this thread
-                */
-               int hi = y1 - y0;
-
-               /*
-                * New thread image
-                */
-               thread_image* t = new thread_image( w, hi + 2*d, 1, n );
-
-               /*
-                * Transfer pixels from the target image
-                */
-               for ( int c = 0; c < n; ++c )
-               {
-                  // Top overlapping region
-                  for ( int y = 0; y < d; ++y )
-                     P::Copy( t->data( 0, y, 0, c ), img.ScanLine( (i == 0) ? d-y-1 : y0-d+y, c ), w );
+   /*
+    * Runs a pass of the specified thread class over the rows of the image.
+    * Row passes are fast streaming operations that are neither monitored nor
+    * abortable.
+    */
+   template <class thread, class... A>
+   static void RunRowThreads( int h, A&&... args )
+   {
+      Array<size_type> L = Thread::OptimalThreadLoads( h, 16/*overheadLimit*/ );
+      ReferenceArray<thread> threads;
+      for ( size_type i = 0, n = 0; i < L.Length(); n += L[i++] )
+         threads.Add( new thread( args..., int( n ), int( n + L[i] ) ) );
+      AbstractImage::ThreadData data;
+      AbstractImage::RunThreads( threads, data );
+      threads.Destroy();
+   }
 
-                  // Non-overlapping region
-                  P::Copy( t->data( 0, d, 0, c ), img.ScanLine( y0, c ), w*hi );
+   /*
+    * Structure tensors accumulated for all channels in a group, computed with
+    * centered finite differences and Neumann boundary conditions.
+    */
+   template <class P>
+   class StructureTensorThread : public Thread
+   {
+   public:
 
-                  // Bottom overlapping region
-                  for ( int y = 0; y < d; ++y )
-                     P::Copy( t->data( 0, d+hi+y, 0, c ), img.ScanLine( (i == numberOfThreads-1) ? h-y-1 : y1+y, c ), w );
-               }
+      typedef typename P::sample sample;
 
-               threads.Add( new thread( t, instance, y0, y1 ) );
-            }
+      StructureTensorThread( GenericImage<P>& T, const GenericImage<P>& B, double k2, int startRow, int endRow )
+         : m_T( T )
+         , m_B( B )
+         , m_k2( k2 )
+         , m_startRow( startRow )
+         , m_endRow( endRow )
+      {
+      }
 
-            /*
-             * Deallocate image data to save space.
-             * We have all pixel data stored in thread images at this point.
-             */
-            img.FreeData();
+      void Run() override
+      {
+         int w = m_B.Width();
+         int h = m_B.Height();
+         sample k2 = sample( m_k2 );
 
-            /*
-             * Fire our threads
-             */
-            for ( int i = 0; i < numberOfThreads; ++i )
-               threads[i]->Start( ThreadPriority::DefaultMax, i );
+         for ( int y = m_startRow; y < m_endRow; ++y )
+         {
+            sample* a = m_T.ScanLine( y, 0 );
+            sample* b = m_T.ScanLine( y, 1 );
+            sample* c = m_T.ScanLine( y, 2 );
+            for ( int x = 0; x < w; ++x )
+               a[x] = b[x] = c[x] = 0;
 
-            /*
-             * Wait for all threads to terminate
-             */
-            for ( ;; )
+            for ( int k = 0; k < m_B.NumberOfChannels(); ++k )
             {
-               bool someRunning = false;
+               const sample* f = m_B.ScanLine( y, k );
+               const sample* fm = m_B.ScanLine( Max( 0, y-1 ), k );
+               const sample* fp = m_B.ScanLine( Min( h-1, y+1 ), k );
 
-               /*
-                * Look for a running thread
-                */
-               for ( int i = 0; i < numberOfThreads; ++i )
-                  if ( !threads[i]->Wait( waitTime ) )
-                  {
-                     someRunning = true;
-                     break;
-                  }
+               for ( int x = 1; x < w-1; ++x )
+               {
+                  sample ix = (f[x+1] - f[x-1])/2;
+                  sample iy = (fp[x] - fm[x])/2;
+                  a[x] += ix*ix;
+                  b[x] += ix*iy;
+                  c[x] += iy*iy;
+               }
 
-               /*
-                * Break when all threads finished
-                */
-               if ( !someRunning )
-                  break;
-
-               /*
-                * Update monitor count
-                *
-                * If the user requests to abort execution, a ProcessAborted
-                * exception is thrown here. If this happens, we signal abortion
-                * through the GREYCstoration_abort global flag and wait until
-                * all threads terminate.
-                */
-               if ( ::GREYCstoration_mutex2.TryLock() )
+               for ( int x = 0; x < w; x += Max( 1, w-1 ) )
                {
-                  try
-                  {
-                     status += ::GREYCstoration_count - lastCount;
-                     lastCount = ::GREYCstoration_count;
-                  }
-                  catch ( ... )
-                  {
-                     ::GREYCstoration_abort = true;
-                  }
-                  ::GREYCstoration_mutex2.Unlock();
+                  sample ix = (f[Min( w-1, x+1 )] - f[Max( 0, x-1 )])/2;
+                  sample iy = (fp[x] - fm[x])/2;
+                  a[x] += ix*ix;
+                  b[x] += ix*iy;
+                  c[x] += iy*iy;
                }
             }
 
-            /*
-             * When no thread is running it is safe to throw an exception to
-             * abort the whole process.
-             */
-            if ( ::GREYCstoration_abort )
-               throw ProcessAborted();
-
-            /*
-             * Allocate pixel data
-             */
-            img.AllocateData( w, h, n, cs );
-
-            /*
-             * Copy processed pixels, discarding overlapping regions.
-             */
-            for ( int i = 0; i < numberOfThreads; ++i )
+            for ( int x = 0; x < w; ++x )
             {
-               const thread* t = threads[i];
-               for ( int c = 0; c < n; ++c )
-                  P::Copy( img.ScanLine( t->StartRow(), c ), t->Image()->data( 0, d, 0, c ), w*t->NumberOfRows() );
+               a[x] *= k2;
+               b[x] *= k2;
+               c[x] *= k2;
             }
+         }
+      }
 
-            /*
-             * Destroy all threads
-             */
-            threads.Destroy();
+   private:
 
-            /*
-             * Floating point images need a normalization to constrain their
-             * sample values to the [0,1] range. This is because the
-             * GREYCstoration algorithm can yield values slightly above one
-             * (say 1.00001 for example), which invalidates the rescaling to
-             * the [0,255] range performed by CImg<T>::blur_anisotropic().
-             * Along with that reason, the core PixInsight application expects
-             * all real images normalized to the [0,1] range.
-             */
-            if ( P::IsFloatSample() )
-            {
-               img.SelectNominalChannels();
-               img.Status() = status;
-               img.Normalize();
-               status = img.Status();
-            }
-         }
+            GenericImage<P>& m_T;
+      const GenericImage<P>& m_B;
+            double           m_k2;
+            int              m_startRow;
+            int              m_endRow;
+   };
 
-         if ( !status.IsCompleted() )
-            status.Complete();
+   /*
+    * Transforms smoothed structure tensors into diffusion tensors through
+    * the analytical eigendecomposition of 2x2 symmetric matrices.
+    */
+   template <class P>
+   class DiffusionTensorThread : public Thread
+   {
+   public:
+
+      typedef typename P::sample sample;
+
+      DiffusionTensorThread( GenericImage<P>& T, const GREYCstorationInstance& instance, int startRow, int endRow )
+         : m_T( T )
+         , m_instance( instance )
+         , m_startRow( startRow )
+         , m_endRow( endRow )
+      {
+      }
+
+      void Run() override
+      {
+         int w = m_T.Width();
+         double power1 = 0.5*Max( m_instance.sharpness, 1.0e-5F );
+         double power2 = power1/(1.0e-7F + 1 - m_instance.anisotropy);
 
-         /*
-          * If the image had alpha channels, restore them.
-          */
-         if ( alphaChannels != 0 )
+         for ( int y = m_startRow; y < m_endRow; ++y )
          {
-            for ( int c = n; c < n0; ++c )
+            sample* ta = m_T.ScanLine( y, 0 );
+            sample* tb = m_T.ScanLine( y, 1 );
+            sample* tc = m_T.ScanLine( y, 2 );
+            for ( int x = 0; x < w; ++x )
             {
-               img.AddAlphaChannel( alphaChannels[c-n] );
-               alphaChannels[c-n] = 0;
+               double a = ta[x], b = tb[x], c = tc[x];
+               double e = a + c;
+               double f = Sqrt( Max( e*e - 4*(a*c - b*b), 0.0 ) );
+               double l1 = 0.5*(e + f); // largest eigenvalue
+               double l2 = 0.5*(e - f);
+               double d = Sqrt( (l1 - a)*(l1 - a) + b*b );
+
+               // Unit eigenvector of the largest eigenvalue: gradient direction.
+               double vx = 1, vy = 0;
+               if ( d > 0 )
+               {
+                  vx = b/d;
+                  vy = (l1 - a)/d;
+               }
+
+               // Diffusion strengths along isophotes and gradients.
+               double s = 1 + Max( l1, 0.0 ) + Max( l2, 0.0 );
+               double n1 = Pow( s, -power1 );
+               double n2 = Pow( s, -power2 );
+
+               ta[x] = sample( n1*vy*vy + n2*vx*vx );
+               tb[x] = sample( (n2 - n1)*vx*vy );
+               tc[x] = sample( n1*vx*vx + n2*vy*vy );
             }
-            img.Allocator().Deallocate( alphaChannels );
-            alphaChannels = 0;
          }
       }
-      catch ( ... )
+
+   private:
+
+            GenericImage<P>&        m_T;
+      const GREYCstorationInstance& m_instance;
+            int                     m_startRow;
+            int                     m_endRow;
+   };
+
+   /*
+    * Vector field of normalized LIC steps for a given direction. The third
+    * channel stores the norm of the diffusion vector.
+    */
+   template <class P>
+   class VectorFieldThread : public Thread
+   {
+   public:
+
+      typedef typename P::sample sample;
+
+      VectorFieldThread( GenericImage<P>& V, const GenericImage<P>& T, float theta, float dl, int startRow, int endRow )
+         : m_V( V )
+         , m_T( T )
+         , m_theta( theta )
+         , m_dl( dl )
+         , m_startRow( startRow )
+         , m_endRow( endRow )
       {
-         threads.Destroy();
+      }
 
-         if ( alphaChannels != 0 )
+      void Run() override
+      {
+         int w = m_V.Width();
+         float thetar = float( m_theta*Const<double>::pi()/180 );
+         float vx = Cos( thetar );
+         float vy = Sin( thetar );
+
+         for ( int y = m_startRow; y < m_endRow; ++y )
          {
-            for ( int c = 0; c < n; ++c )
-               if ( alphaChannels[c] != 0 )
-                  img.Allocator().Deallocate( alphaChannels[c] );
-            img.Allocator().Deallocate( alphaChannels );
+            const sample* a = m_T.ScanLine( y, 0 );
+            const sample* b = m_T.ScanLine( y, 1 );
+            const sample* c = m_T.ScanLine( y, 2 );
+            sample* su = m_V.ScanLine( y, 0 );
+            sample* sv = m_V.ScanLine( y, 1 );
+            sample* sn = m_V.ScanLine( y, 2 );
+            for ( int x = 0; x < w; ++x )
+            {
+               float u = float( a[x]*vx + b[x]*vy );
+               float v = float( b[x]*vx + c[x]*vy );
+               float n = Max( 1.0e-5F, Sqrt( u*u + v*v ) );
+               float dln = m_dl/n;
+               su[x] = sample( u*dln );
+               sv[x] = sample( v*dln );
+               sn[x] = sample( n );
+            }
          }
-
-         throw;
       }
-   }
 
-#define CALL_CImg() \
-   cimg->blur_anisotropic( instance.amplitude, instance.sharpness, instance.anisotropy,                        \
-                           instance.alpha, instance.sigma, instance.spatialStepSize, instance.angularStepSize, \
-                           instance.precision, instance.interpolation, instance.fastApproximation )
-   template <class T>
-   static void BlurAnisotropic( cimg_library::CImg<T>* cimg, const GREYCstorationInstance& instance )
+   private:
+
+            GenericImage<P>& m_V;
+      const GenericImage<P>& m_T;
+            float            m_theta;
+            float            m_dl;
+            int              m_startRow;
+            int              m_endRow;
+   };
+
+   /*
+    * Line integral convolution along the streamlines of a vector field. Each
+    * thread claims square tiles from a shared counter until all tiles have
+    * been processed, accumulating results for the current direction.
+    */
+   template <class P>
+   class LICThread : public Thread
    {
-      if ( cimg->_spectrum == 1 || instance.coupledChannels )
+   public:
+
+      typedef typename P::sample sample;
+
+      LICThread( const AbstractImage::ThreadData& data,
+                 GenericImage<P>& R, const GenericImage<P>& img, int c0, const GenericImage<P>& V,
+                 const GREYCstorationInstance& instance, AtomicInt& tileCounter )
+         : m_data( data )
+         , m_R( R )
+         , m_img( img )
+         , m_c0( c0 )
+         , m_V( V )
+         , m_instance( instance )
+         , m_tileCounter( tileCounter )
       {
-         /*
-          * Normal GREYCstoration working mode: process a RGB (or grayscale)
-          * image as a single unit.
-          */
-         CALL_CImg();
       }
-      else
+
+      void Run() override
       {
-         /*
-          * Alternative GREYCstoration working mode: process each color channel
-          * as an independent image.
-          *
-          * Using this mode is not recommended on a regular basis because it
-          * lacks GREYCstoration's strongest point for color image denoising:
-          * manage the relationships between color components as a single
-          * mathematical object.
-          */
-         int n( cimg->_spectrum );
-         T* data = cimg->_data;
-
-         cimg->_spectrum = 1;
-
-         for ( int c = 0; c < n; ++c )
+         INIT_THREAD_MONITOR()
+
+         m_width = m_img.Width();
+         m_height = m_img.Height();
+         int h = m_height;
+         int nc = m_R.NumberOfChannels();
+         int tilesX = (m_width + TileSize - 1)/TileSize;
+         int numberOfTiles = tilesX*((h + TileSize - 1)/TileSize);
+
+         const sample* I[ 3 ];
+         sample* R[ 3 ];
+         for ( int c = 0; c < nc; ++c )
          {
-            cimg->_data = data + c*cimg->_width*cimg->_height;
+            I[c] = m_img[m_c0+c];
+            R[c] = m_R[c];
+         }
+         const sample* U = m_V[0];
+         const sample* V = m_V[1];
+         const sample* N = m_V[2];
 
-            CALL_CImg();
+         float dx1 = m_width - 1;
+         float dy1 = h - 1;
+         float dl = m_instance.spatialStepSize;
+         float sqrt2amplitude = Sqrt( 2*m_instance.amplitude );
+         bool fast = m_instance.fastApproximation;
 
-            if ( ::GREYCstoration_abort )
+         for ( ;; )
+         {
+            int tile = m_tileCounter.FetchAndAdd( 1 );
+            if ( tile >= numberOfTiles )
                break;
-         }
 
-         cimg->_spectrum = n;
-         cimg->_data = data;
+            int x0 = (tile % tilesX)*TileSize;
+            int y0 = (tile / tilesX)*TileSize;
+            int x1 = Min( x0 + TileSize, m_width );
+            int y1 = Min( y0 + TileSize, h );
+
+            for ( int y = y0; y < y1; ++y )
+               for ( int x = x0; x < x1; ++x )
+               {
+                  size_type i = size_type( y )*m_width + x;
+                  float fsigma = float( N[i] )*sqrt2amplitude;
+                  float fsigma2 = 2*fsigma*fsigma;
+                  float length = m_instance.precision*fsigma;
+                  sample val[ 3 ] = { 0, 0, 0 };
+                  float S = 0;
+                  float X = x;
+                  float Y = y;
+
+                  switch ( m_instance.interpolation )
+                  {
+                  case GREYCsInterpolation::Nearest:
+                     for ( float l = 0; l < length && X >= 0 && X <= dx1 && Y >= 0 && Y <= dy1; l += dl )
+                     {
+                        size_type j = size_type( int( Y + 0.5F ) )*m_width + int( X + 0.5F );
+                        float coef = fast ? 1.0F : float( Exp( -l*l/fsigma2 ) );
+                        for ( int c = 0; c < nc; ++c )
+                           val[c] += coef*I[c][j];
+                        S += coef;
+                        X += float( U[j] );
+                        Y += float( V[j] );
+                     }
+                     break;
+                  case GREYCsInterpolation::Bilinear:
+                     for ( float l = 0; l < length && X >= 0 && X <= dx1 && Y >= 0 && Y <= dy1; l += dl )
+                     {
+                        float u = float( Linear( U, X, Y ) );
+                        float v = float( Linear( V, X, Y ) );
+                        float coef = fast ? 1.0F : float( Exp( -l*l/fsigma2 ) );
+                        for ( int c = 0; c < nc; ++c )
+                           val[c] += coef*Linear( I[c], X, Y );
+                        S += coef;
+                        X += u;
+                        Y += v;
+                     }
+                     break;
+                  default:
+                  case GREYCsInterpolation::RungeKutta:
+                     for ( float l = 0; l < length && X >= 0 && X <= dx1 && Y >= 0 && Y <= dy1; l += dl )
+                     {
+                        float u0 = float( 0.5F*Linear( U, X, Y ) );
+                        float v0 = float( 0.5F*Linear( V, X, Y ) );
+                        float u = float( Linear( U, X + u0, Y + v0 ) );
+                        float v = float( Linear( V, X + u0, Y + v0 ) );
+                        float coef = fast ? 1.0F : float( Exp( -l*l/fsigma2 ) );
+                        for ( int c = 0; c < nc; ++c )
+                           val[c] += coef*Linear( I[c], X, Y );
+                        S += coef;
+                        X += u;
+                        Y += v;
+                     }
+                     break;
+                  }
+
+                  if ( S > 0 )
+                     for ( int c = 0; c < nc; ++c )
+                        R[c][i] += val[c]/S;
+                  else
+                     for ( int c = 0; c < nc; ++c )
+                        R[c][i] += I[c][i];
+               }
+
+            UPDATE_THREAD_MONITOR( 1 )
+         }
       }
-   }
 
-#undef CALL_CImg
-};
+   private:
 
-// ----------------------------------------------------------------------------
+      const AbstractImage::ThreadData& m_data;
+            GenericImage<P>&           m_R;
+      const GenericImage<P>&           m_img;
+            int                        m_c0;
+      const GenericImage<P>&           m_V;
+      const GREYCstorationInstance&    m_instance;
+            AtomicInt&                 m_tileCounter;
+            int                        m_width = 0;
+            int                        m_height = 0;
 
-template <class T>
-void GREYCstorationThread<T>::Run()
-{
-   try
-   {
-      GREYCstorationEngine::BlurAnisotropic( cimg, instance );
-   }
-   catch ( ... )
-   {
-   }
-}
+      /*
+       * Bilinear interpolation with clamped coordinates, after
+       * CImg<T>::_linear_atXY().
+       */
+      sample Linear( const sample* f, float fx, float fy ) const
+      {
+         float nfx = Range( fx, 0.0F, float( m_width - 1 ) );
+         float nfy = Range( fy, 0.0F, float( m_height - 1 ) );
+         int x = int( nfx );
+         int y = int( nfy );
+         float dx = nfx - x;
+         float dy = nfy - y;
+         int nx = (dx > 0) ? x+1 : x;
+         const sample* f0 = f + size_type( y )*m_width;
+         const sample* f1 = (dy > 0) ? f0 + m_width : f0;
+         sample Icc = f0[x], Inc = f0[nx], Icn = f1[x], Inn = f1[nx];
+         return Icc + dx*(Inc - Icc + dy*(Icc + Inn - Icn - Inc)) + dy*(Icn - Icc);
+      }
+   };
+};
 
 // ----------------------------------------------------------------------------
 // ----------------------------------------------------------------------------
@@ -577,25 +729,22 @@ bool GREYCstorationInstance::ExecuteOn( View& view )
       case 64: GREYCstorationEngine::Apply( static_cast<pcl::DImage&>( *image ), *this ); break;
       }
    else
-      switch ( image.BitsPerSample() )
-      {
-      case  8: GREYCstorationEngine::Apply( static_cast<pcl::UInt8Image&>( *image ), *this ); break;
-      case 16: GREYCstorationEngine::Apply( static_cast<pcl::UInt16Image&>( *image ), *this ); break;
-      case 32:
-         {
-            /*
-             * GREYCstoration (as of CImg.h version 1.46) causes overflow
-             * of bright pixels in 32-bit unsigned integer format.
-             * To work around this problem we create a temporary 64-bit
-             * floating point working image. ### TODO: Fix this issue.
-             */
-            DImage tmp = static_cast<pcl::UInt32Image&>( *image );
-            image.FreeImage();
-            GREYCstorationEngine::Apply( tmp, *this );
-            image.CopyImage( tmp );
-         }
-         break;
-      }
+   {
+      /*
+       * Integer images are processed in floating point working images, which
+       * avoids roundings and truncations at each iteration. 32-bit integers
+       * require 64-bit floating point to preserve their precision.
+       */
+      ImageVariant tmp;
+      tmp.CreateFloatImage( (image.BitsPerSample() == 32) ? 64 : 32 );
+      tmp.CopyImage( image );
+      tmp.SetStatusCallback( &status );
+      if ( tmp.BitsPerSample() == 64 )
+         GREYCstorationEngine::Apply( static_cast<pcl::DImage&>( *tmp ), *this );
+      else
+         GREYCstorationEngine::Apply( static_cast<pcl::Image&>( *tmp ), *this );
+      image.CopyImage( tmp );
+   }
 
    return true;
 }
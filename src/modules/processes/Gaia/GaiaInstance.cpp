@@ -299,6 +299,7 @@ void GaiaInstance::Search()
          p_searchData.excessCount += thread.data.excessCount;
          p_searchData.rejectCount += thread.data.rejectCount;
          p_searchData.countIO += thread.data.countIO;
+         p_searchData.countCacheHits += thread.data.countCacheHits;
          if ( thread.data.timeTotal > p_searchData.timeTotal )
             p_searchData.timeTotal = thread.data.timeTotal;
          if ( thread.data.timeIO > p_searchData.timeIO )
@@ -365,7 +366,9 @@ void GaiaInstance::Search()
          "\nTotal I/O time ............. " + ElapsedTime::ToString( p_searchData.timeIO, 2 ) +
          "\nTotal I/O operations ....... " + String( p_searchData.countIO ) +
          "\nTotal uncompression time ... " + ElapsedTime::ToString( p_searchData.timeUncompress, 2 ) +
-         "\nTotal decoding time ........ " + ElapsedTime::ToString( p_searchData.timeDecode, 2 ) );
+         "\nTotal decoding time ........ " + ElapsedTime::ToString( p_searchData.timeDecode, 2 ) +
+         "\nBlock cache hits ........... " + String( p_searchData.countCacheHits ) +
+         String().Format( " (%.1f%%)", 100*p_searchData.CacheHitRatio() ) );
       break;
    }
 }
@@ -741,6 +744,8 @@ void* GaiaInstance::LockParameter( const MetaParameter* p, size_type tableRow )
       return &p_searchData.timeUncompress;
    if ( p == TheGTimeDecodeParameter )
       return &p_searchData.timeDecode;
+   if ( p == TheGCountCacheHitsParameter )
+      return &p_searchData.countCacheHits;
    if ( p == TheGDatabaseFilePathParameter )
       return p_databaseFilePaths[tableRow].Begin();
    if ( p == TheGIsValidParameter )
@@ -98,6 +98,7 @@ GTimeIO*                      TheGTimeIOParameter = nullptr;
 GCountIO*                     TheGCountIOParameter = nullptr;
 GTimeUncompress*              TheGTimeUncompressParameter = nullptr;
 GTimeDecode*                  TheGTimeDecodeParameter = nullptr;
+GCountCacheHits*              TheGCountCacheHitsParameter = nullptr;
 GIsValid*                     TheGIsValidParameter = nullptr;
 GOutputDataRelease*           TheGOutputDataReleaseParameter = nullptr;
 GDatabaseMagnitudeLow*        TheGDatabaseMagnitudeLowParameter = nullptr;
@@ -997,6 +998,24 @@ bool GTimeDecode::IsReadOnly() const
 
 // ----------------------------------------------------------------------------
 
+GCountCacheHits::GCountCacheHits( MetaProcess* P )
+   : MetaUInt32( P )
+{
+   TheGCountCacheHitsParameter = this;
+}
+
+IsoString GCountCacheHits::Id() const
+{
+   return "countCacheHits";
+}
+
+bool GCountCacheHits::IsReadOnly() const
+{
+   return true;
+}
+
+// ----------------------------------------------------------------------------
+
 GIsValid::GIsValid( MetaProcess* P )
    : MetaBoolean( P )
 {
@@ -698,6 +698,20 @@ extern GTimeDecode* TheGTimeDecodeParameter;
 
 // ----------------------------------------------------------------------------
 
+class GCountCacheHits : public MetaUInt32
+{
+public:
+
+   GCountCacheHits( MetaProcess* );
+
+   IsoString Id() const override;
+   bool IsReadOnly() const override;
+};
+
+extern GCountCacheHits* TheGCountCacheHitsParameter;
+
+// ----------------------------------------------------------------------------
+
 class GIsValid : public MetaBoolean
 {
 public:
@@ -156,6 +156,7 @@ GaiaProcess::GaiaProcess()
    new GCountIO( this );
    new GTimeUncompress( this );
    new GTimeDecode( this );
+   new GCountCacheHits( this );
    new GIsValid( this );
    new GOutputDataRelease( this );
    new GDatabaseMagnitudeLow( this );
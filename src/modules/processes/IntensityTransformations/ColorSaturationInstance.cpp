@@ -228,6 +228,16 @@ private:
 
       void Run() override
       {
+         /*
+          * Use vectorized batch conversions for images whose samples fit in
+          * single floating point precision.
+          */
+         if ( P::BitsPerSample() <= 16 || P::IsFloatSample() && P::BitsPerSample() == 32 )
+         {
+            BatchRun();
+            return;
+         }
+
          INIT_THREAD_MONITOR()
 
          const RGBColorSystem& rgbws = m_image.RGBWorkingSpace();
@@ -284,6 +294,84 @@ private:
 
    private:
 
+      void BatchRun()
+      {
+         INIT_THREAD_MONITOR()
+
+         const RGBColorSystem& rgbws = m_image.RGBWorkingSpace();
+
+         AutoPointer<interpolator> iHS;
+         if ( !m_data.lut )
+            iHS = m_instance.Curve().InitInterpolator();
+
+         const size_type blockSize = 4096;
+         FVector bR( blockSize ), bG( blockSize ), bB( blockSize ),
+                 bH( blockSize ), bS( blockSize ), bV( blockSize ),
+                 bL( blockSize ), bk( blockSize );
+         float* __restrict__ fR = bR.Begin();
+         float* __restrict__ fG = bG.Begin();
+         float* __restrict__ fB = bB.Begin();
+         float* __restrict__ fH = bH.Begin();
+         float* __restrict__ fS = bS.Begin();
+         float* __restrict__ fV = bV.Begin();
+         float* __restrict__ fL = bL.Begin();
+         float* __restrict__ fk = bk.Begin();
+
+         typename P::sample* __restrict__ pR = m_image[0] + m_start;
+         typename P::sample* __restrict__ pG = m_image[1] + m_start;
+         typename P::sample* __restrict__ pB = m_image[2] + m_start;
+
+         for ( size_type i = m_start; i < m_end; )
+         {
+            size_type n = Min( blockSize, m_end - i );
+
+            for ( size_type j = 0; j < n; ++j )
+            {
+               P::FromSample( fR[j], pR[j] );
+               P::FromSample( fG[j], pG[j] );
+               P::FromSample( fB[j], pB[j] );
+            }
+
+            rgbws.RGBToHSVL( fH, fS, fV, fL, fR, fG, fB, n );
+
+            if ( m_data.lut )
+            {
+               for ( size_type j = 0; j < n; ++j )
+                  fS[j] = float( Range( fS[j]*m_data.lut[RoundI( fH[j]*lutMax )], 0.0, 1.0 ) );
+               rgbws.HSVLToRGB( fR, fG, fB, fH, fS, fV, fL, n );
+               for ( size_type j = 0; j < n; ++j )
+               {
+                  pR[j] = P::ToSample( fR[j] );
+                  pG[j] = P::ToSample( fG[j] );
+                  pB[j] = P::ToSample( fB[j] );
+               }
+            }
+            else
+            {
+               for ( size_type j = 0; j < n; ++j )
+               {
+                  double k = HSCurve::Interpolate( iHS, m_instance.UnshiftHueValue( fH[j] ) );
+                  fk[j] = float( k );
+                  if ( k != 0 )
+                     fS[j] = float( Range( fS[j]*BiasToSaturationFactor( k ), 0.0, 1.0 ) );
+               }
+               rgbws.HSVLToRGB( fR, fG, fB, fH, fS, fV, fL, n );
+               // Pixels with a zero saturation bias are left untouched.
+               for ( size_type j = 0; j < n; ++j )
+                  if ( fk[j] != 0 )
+                  {
+                     pR[j] = P::ToSample( fR[j] );
+                     pG[j] = P::ToSample( fG[j] );
+                     pB[j] = P::ToSample( fB[j] );
+                  }
+            }
+
+            pR += n; pG += n; pB += n; i += n;
+
+            UPDATE_THREAD_MONITOR_CHUNK( 65536, blockSize )
+         }
+      }
+
       const ColorSaturationInstance& m_instance;
       const ThreadData&              m_data;
       GenericImage<P>&               m_image;
@@ -510,6 +510,73 @@ private:
          return !m_instance[c].IsIdentity();
       }
 
+      /*
+       * Color space transformations use vectorized batch conversions for
+       * images whose samples fit in single floating point precision.
+       */
+      static bool UseBatchConversions()
+      {
+         return P::BitsPerSample() <= 16 || P::IsFloatSample() && P::BitsPerSample() == 32;
+      }
+
+      /*
+       * Applies a transformation to blocks of pixels. The transform function
+       * receives three arrays of normalized RGB components and their length,
+       * and must transform them in-place.
+       */
+      template <class F>
+      void BatchTransformation( F transform )
+      {
+         INIT_THREAD_MONITOR()
+
+         const size_type blockSize = 4096;
+         FVector bR( blockSize ), bG( blockSize ), bB( blockSize );
+         float* __restrict__ fR = bR.Begin();
+         float* __restrict__ fG = bG.Begin();
+         float* __restrict__ fB = bB.Begin();
+
+         typename P::sample* __restrict__ pR = m_image[0] + m_start;
+         typename P::sample* __restrict__ pG = m_image[1] + m_start;
+         typename P::sample* __restrict__ pB = m_image[2] + m_start;
+
+         for ( size_type i = m_start; i < m_end; )
+         {
+            size_type n = Min( blockSize, m_end - i );
+
+            for ( size_type j = 0; j < n; ++j )
+            {
+               P::FromSample( fR[j], pR[j] );
+               P::FromSample( fG[j], pG[j] );
+               P::FromSample( fB[j], pB[j] );
+            }
+
+            transform( fR, fG, fB, n );
+
+            for ( size_type j = 0; j < n; ++j )
+            {
+               pR[j] = P::ToSample( fR[j] );
+               pG[j] = P::ToSample( fG[j] );
+               pB[j] = P::ToSample( fB[j] );
+            }
+
+            pR += n; pG += n; pB += n; i += n;
+
+            UPDATE_THREAD_MONITOR_CHUNK( 65536, blockSize )
+         }
+      }
+
+      static void Transform( float* x, size_type n, interpolator* i )
+      {
+         for ( size_type j = 0; j < n; ++j )
+            x[j] = float( CurveBase::Interpolate( i, x[j] ) );
+      }
+
+      static void Transform( float* x, size_type n, const DVector& lut )
+      {
+         for ( size_type j = 0; j < n; ++j )
+            x[j] = float( lut[RoundI( x[j]*lutMax )] );
+      }
+
       void RGBATransformation( int c, const Curve& C )
       {
          INIT_THREAD_MONITOR()
@@ -557,6 +624,22 @@ private:
 
          const RGBColorSystem& rgbws = m_image.RGBWorkingSpace();
 
+         if ( UseBatchConversions() )
+         {
+            BatchTransformation( [&]( float* R, float* G, float* B, size_type n )
+            {
+               rgbws.RGBToCIELab( R, G, B, R, G, B, n );
+               if ( iL )
+                  Transform( R, n, iL );
+               if ( ia )
+                  Transform( G, n, ia );
+               if ( ib )
+                  Transform( B, n, ib );
+               rgbws.CIELabToRGB( R, G, B, R, G, B, n );
+            } );
+            return;
+         }
+
          typename P::sample* pR = m_image[0] + m_start;
          typename P::sample* pG = m_image[1] + m_start;
          typename P::sample* pB = m_image[2] + m_start;
@@ -587,6 +670,22 @@ private:
 
          const RGBColorSystem& rgbws = m_image.RGBWorkingSpace();
 
+         if ( UseBatchConversions() )
+         {
+            BatchTransformation( [&]( float* R, float* G, float* B, size_type n )
+            {
+               rgbws.RGBToCIELab( R, G, B, R, G, B, n );
+               if ( lutL )
+                  Transform( R, n, lutL );
+               if ( luta )
+                  Transform( G, n, luta );
+               if ( lutb )
+                  Transform( B, n, lutb );
+               rgbws.CIELabToRGB( R, G, B, R, G, B, n );
+            } );
+            return;
+         }
+
          typename P::sample* pR = m_image[0] + m_start;
          typename P::sample* pG = m_image[1] + m_start;
          typename P::sample* pB = m_image[2] + m_start;
@@ -624,6 +723,20 @@ private:
 
          const RGBColorSystem& rgbws = m_image.RGBWorkingSpace();
 
+         if ( UseBatchConversions() )
+         {
+            BatchTransformation( [&]( float* R, float* G, float* B, size_type n )
+            {
+               rgbws.RGBToCIELch( R, G, B, R, G, B, n );
+               if ( iL )
+                  Transform( R, n, iL );
+               if ( ic )
+                  Transform( G, n, ic );
+               rgbws.CIELchToRGB( R, G, B, R, G, B, n );
+            } );
+            return;
+         }
+
          typename P::sample* pR = m_image[0] + m_start;
          typename P::sample* pG = m_image[1] + m_start;
          typename P::sample* pB = m_image[2] + m_start;
@@ -654,6 +767,20 @@ private:
 
          const RGBColorSystem& rgbws = m_image.RGBWorkingSpace();
 
+         if ( UseBatchConversions() )
+         {
+            BatchTransformation( [&]( float* R, float* G, float* B, size_type n )
+            {
+               rgbws.RGBToCIELch( R, G, B, R, G, B, n );
+               if ( lutL )
+                  Transform( R, n, lutL );
+               if ( lutc )
+                  Transform( G, n, lutc );
+               rgbws.CIELchToRGB( R, G, B, R, G, B, n );
+            } );
+            return;
+         }
+
          typename P::sample* pR = m_image[0] + m_start;
          typename P::sample* pG = m_image[1] + m_start;
          typename P::sample* pB = m_image[2] + m_start;
@@ -695,6 +822,33 @@ private:
 
          const RGBColorSystem& rgbws = m_image.RGBWorkingSpace();
 
+         if ( UseBatchConversions() )
+         {
+            BatchTransformation( [&]( float* R, float* G, float* B, size_type n )
+            {
+               if ( ia || ib )
+               {
+                  rgbws.RGBToCIELab( R, G, B, R, G, B, n );
+                  if ( iL )
+                     Transform( R, n, iL );
+                  if ( ia )
+                     Transform( G, n, ia );
+                  if ( ib )
+                     Transform( B, n, ib );
+                  rgbws.CIELabToRGB( R, G, B, R, G, B, n );
+               }
+               if ( ic )
+               {
+                  rgbws.RGBToCIELch( R, G, B, R, G, B, n );
+                  if ( iL && !ia && !ib )
+                     Transform( R, n, iL );
+                  Transform( G, n, ic );
+                  rgbws.CIELchToRGB( R, G, B, R, G, B, n );
+               }
+            } );
+            return;
+         }
+
          typename P::sample* pR = m_image[0] + m_start;
          typename P::sample* pG = m_image[1] + m_start;
          typename P::sample* pB = m_image[2] + m_start;
@@ -739,6 +893,33 @@ private:
 
          const RGBColorSystem& rgbws = m_image.RGBWorkingSpace();
 
+         if ( UseBatchConversions() )
+         {
+            BatchTransformation( [&]( float* R, float* G, float* B, size_type n )
+            {
+               if ( luta || lutb )
+               {
+                  rgbws.RGBToCIELab( R, G, B, R, G, B, n );
+                  if ( lutL )
+                     Transform( R, n, lutL );
+                  if ( luta )
+                     Transform( G, n, luta );
+                  if ( lutb )
+                     Transform( B, n, lutb );
+                  rgbws.CIELabToRGB( R, G, B, R, G, B, n );
+               }
+               if ( lutc )
+               {
+                  rgbws.RGBToCIELch( R, G, B, R, G, B, n );
+                  if ( lutL && !luta && !lutb )
+                     Transform( R, n, lutL );
+                  Transform( G, n, lutc );
+                  rgbws.CIELchToRGB( R, G, B, R, G, B, n );
+               }
+            } );
+            return;
+         }
+
          typename P::sample* pR = m_image[0] + m_start;
          typename P::sample* pG = m_image[1] + m_start;
          typename P::sample* pB = m_image[2] + m_start;
@@ -790,6 +971,22 @@ private:
 
          const RGBColorSystem& rgbws = m_image.RGBWorkingSpace();
 
+         if ( UseBatchConversions() )
+         {
+            FVector bL( 4096 );
+            BatchTransformation( [&]( float* R, float* G, float* B, size_type n )
+            {
+               float* L = bL.Begin();
+               rgbws.RGBToHSVL( R, G, B, L, R, G, B, n );
+               if ( iH )
+                  Transform( R, n, iH );
+               if ( iS )
+                  Transform( G, n, iS );
+               rgbws.HSVLToRGB( R, G, B, R, G, B, L, n );
+            } );
+            return;
+         }
+
          typename P::sample* pR = m_image[0] + m_start;
          typename P::sample* pG = m_image[1] + m_start;
          typename P::sample* pB = m_image[2] + m_start;
@@ -821,6 +1018,22 @@ private:
 
          const RGBColorSystem& rgbws = m_image.RGBWorkingSpace();
 
+         if ( UseBatchConversions() )
+         {
+            FVector bL( 4096 );
+            BatchTransformation( [&]( float* R, float* G, float* B, size_type n )
+            {
+               float* L = bL.Begin();
+               rgbws.RGBToHSVL( R, G, B, L, R, G, B, n );
+               if ( lutH )
+                  Transform( R, n, lutH );
+               if ( lutS )
+                  Transform( G, n, lutS );
+               rgbws.HSVLToRGB( R, G, B, R, G, B, L, n );
+            } );
+            return;
+         }
+
          typename P::sample* pR = m_image[0] + m_start;
          typename P::sample* pG = m_image[1] + m_start;
          typename P::sample* pB = m_image[2] + m_start;
@@ -191,6 +191,133 @@ static double InitialBackground( const ImageVariant& image, double low, double h
 
 // ----------------------------------------------------------------------------
 
+/*
+ * Compiled masked stretch transformation for grayscale 32-bit floating point
+ * images.
+ *
+ * In the grayscale case each iteration uses the pixel being transformed as
+ * its own mask, so the whole iterative process is a function of the input
+ * sample value exclusively. We tabulate this function at the nodes of a
+ * square root grid, which concentrates nodes near zero where most background
+ * pixels live and where the function has its largest curvature, and evaluate
+ * it by cubic Hermite interpolation from function values and analytical
+ * derivatives.
+ */
+class MaskedStretchLUT
+{
+public:
+
+   /*
+    * Number of grid intervals. Each node requires 16 bytes, so we have a
+    * table of 1 MiB. With this resolution the interpolation error is well
+    * below the 32-bit floating point epsilon.
+    */
+   constexpr static int Resolution = 1 << 16;
+
+   MaskedStretchLUT() = default;
+
+   void Initialize( const DVector& m )
+   {
+      m_F = DVector( Resolution+1 );
+      m_D = DVector( Resolution+1 );
+
+      Array<size_type> L = Thread::OptimalThreadLoads( Resolution+1, 1024/*overheadLimit*/ );
+      ReferenceArray<InitializationThread> threads;
+      for ( size_type i = 0, n = 0; i < L.Length(); n += L[i++] )
+         threads.Add( new InitializationThread( *this, m, n, n + L[i] ) );
+      if ( threads.Length() > 1 )
+      {
+         for ( InitializationThread& thread : threads )
+            thread.Start();
+         for ( InitializationThread& thread : threads )
+            thread.Wait();
+      }
+      else
+         threads[0].Run();
+      threads.Destroy();
+   }
+
+   bool IsValid() const
+   {
+      return !m_F.IsEmpty();
+   }
+
+   /*
+    * Composition of all masked stretch iterations without intermediate
+    * roundings. Also computes the derivative dF/dx.
+    */
+   static double Stretch( double f, const DVector& m, double& df )
+   {
+      df = 1;
+      for ( int it = 0; it < m.Length(); ++it )
+      {
+         double f1 = 1 - f;
+         double g = HistogramTransformation::MTF( m[it], f );
+         double dg = 0;
+         if ( f > 0 && f < 1 )
+         {
+            double d = (2*m[it] - 1)*f - m[it];
+            dg = m[it]*(1 - m[it])/d/d;
+         }
+         df *= 2*f - g + f1*dg;
+         f = f*f + f1*g;
+      }
+      return f;
+   }
+
+   /*
+    * Interpolated transformation of a sample value in the [0,1) range.
+    */
+   double operator()( double x ) const
+   {
+      double u = Sqrt( x )*Resolution;
+      int i = Min( TruncInt( u ), Resolution-1 );
+      double s = u - i;
+      double s2 = s*s;
+      double s3 = s2*s;
+      return (2*s3 - 3*s2 + 1)*m_F[i] + (s3 - 2*s2 + s)*m_D[i] + (3*s2 - 2*s3)*m_F[i+1] + (s3 - s2)*m_D[i+1];
+   }
+
+private:
+
+   DVector m_F; // F(t^2)
+   DVector m_D; // dF/dt * h
+
+   class InitializationThread : public Thread
+   {
+   public:
+
+      InitializationThread( MaskedStretchLUT& lut, const DVector& m, int start, int end )
+         : m_lut( lut )
+         , m_m( m )
+         , m_start( start )
+         , m_end( end )
+      {
+      }
+
+      void Run() override
+      {
+         for ( int i = m_start; i < m_end; ++i )
+         {
+            double t = double( i )/Resolution;
+            double df;
+            m_lut.m_F[i] = Stretch( t*t, m_m, df );
+            // Chain rule: dF/dt = dF/dx * 2*t. Prescale by the grid step.
+            m_lut.m_D[i] = df*2*t/Resolution;
+         }
+      }
+
+   private:
+
+            MaskedStretchLUT& m_lut;
+      const DVector&          m_m;
+            int               m_start;
+            int               m_end;
+   };
+};
+
+// ----------------------------------------------------------------------------
+
 class MaskedStretchEngine
 {
 public:
@@ -210,9 +337,10 @@ public:
       }
 
       /*
-       * Perform the masked stretch task.
+       * Perform the masked stretch task. All iterations are applied to each
+       * pixel in a single pass over the image.
        */
-      image.Status().Initialize( "Masked stretch", image.NumberOfPixels()*instance.p_numberOfIterations );
+      image.Status().Initialize( "Masked stretch", image.NumberOfPixels() );
 
       if ( image.IsFloatSample() )
          switch ( image.BitsPerSample() )
@@ -234,17 +362,61 @@ private:
    template <class P>
    void Apply( GenericImage<P>& image, const MaskedStretchInstance& instance, const DVector& m )
    {
+      /*
+       * For grayscale 8-bit and 16-bit integer images, tabulate the iterative
+       * process for all possible sample values, including the roundings to
+       * the sample data type performed after each iteration. The result is
+       * identical to the iterative process.
+       *
+       * For large grayscale 32-bit floating point images, use a compiled
+       * lookup table. Generating the table has a fixed cost, so it pays off
+       * only for images substantially larger than the table.
+       */
+      Array<typename P::sample> sampleLUT;
+      MaskedStretchLUT lut;
+      if ( image.NumberOfNominalChannels() == 1 )
+         if ( P::IsFloatSample() )
+         {
+            if ( P::BitsPerSample() == 32 )
+               if ( image.NumberOfPixels() > 4*size_type( MaskedStretchLUT::Resolution ) )
+                  lut.Initialize( m );
+         }
+         else if ( P::BitsPerSample() <= 16 )
+         {
+            sampleLUT = Array<typename P::sample>( size_type( P::MaxSampleValue() ) + 1 );
+            for ( size_type s = 0; s < sampleLUT.Length(); ++s )
+            {
+               typename P::sample v = typename P::sample( s );
+               for ( int it = 0; it < m.Length(); ++it )
+                  v = StretchSample<P>( v, m[it] );
+               sampleLUT[s] = v;
+            }
+         }
+
       Array<size_type> L = Thread::OptimalThreadLoads( image.NumberOfPixels(), 16/*overheadLimit*/ );
       AbstractImage::ThreadData data( image, image.Status().Total() );
       ReferenceArray<MaskedStretchThread<P> > threads;
       for ( size_type i = 0, n = 0; i < L.Length(); n += L[i++] )
-         threads.Add( new MaskedStretchThread<P>( instance, data, image, m, n, n + L[i] ) );
+         threads.Add( new MaskedStretchThread<P>( instance, data, image, m, sampleLUT, lut, n, n + L[i] ) );
       AbstractImage::RunThreads( threads, data );
       threads.Destroy();
 
       image.Status() = data.status;
    }
 
+   /*
+    * One grayscale masked stretch iteration, including the rounding to the
+    * sample data type.
+    */
+   template <class P>
+   static typename P::sample StretchSample( typename P::sample v, double m )
+   {
+      double f; P::FromSample( f, v );
+      double f1 = 1 - f;
+      double g = HistogramTransformation::MTF( m, f );
+      return P::ToSample( f*f + f1*g );
+   }
+
    template <class P>
    class MaskedStretchThread : public Thread
    {
@@ -254,11 +426,15 @@ private:
                            const AbstractImage::ThreadData& data,
                            GenericImage<P>& image,
                            const DVector& m,
+                           const Array<typename P::sample>& sampleLUT,
+                           const MaskedStretchLUT& lut,
                            size_type start, size_type end )
          : m_instance( instance )
          , m_data( data )
          , m_image( image )
          , m_m( m )
+         , m_sampleLUT( sampleLUT )
+         , m_lut( lut )
          , m_start( start )
          , m_end( end )
       {
@@ -272,30 +448,75 @@ private:
 
          const RGBColorSystem& rgbws = m_image.RGBWorkingSpace();
 
-         for ( int it = 0; it < m_instance.p_numberOfIterations; ++it )
-            if ( n == 1 )
+         if ( n == 1 )
+         {
+            typename GenericImage<P>::sample_iterator i( m_image ); i += m_start;
+            typename GenericImage<P>::sample_iterator j( m_image ); j += m_end;
+            if ( !m_sampleLUT.IsEmpty() )
+            {
+               for ( ; i < j; ++i )
+               {
+                  *i = m_sampleLUT[*i];
+
+                  UPDATE_THREAD_MONITOR( 65536 )
+               }
+            }
+            else if ( m_lut.IsValid() )
             {
-               typename GenericImage<P>::sample_iterator i( m_image ); i += m_start;
-               typename GenericImage<P>::sample_iterator j( m_image ); j += m_end;
                for ( ; i < j; ++i )
                {
                   double f; P::FromSample( f, *i );
-                  double f1 = 1 - f;
-                  double g = HistogramTransformation::MTF( m_m[it], f );
-                  *i = P::ToSample( f*f + f1*g );
+                  if ( f >= 0 && f < 1 )
+                     *i = P::ToSample( m_lut( f ) );
+                  else
+                     *i = Stretch( *i );
 
                   UPDATE_THREAD_MONITOR( 65536 )
                }
             }
             else
             {
-               typename GenericImage<P>::pixel_iterator i( m_image ); i += m_start;
-               typename GenericImage<P>::pixel_iterator j( m_image ); j += m_end;
-               for ( ; i < j; ++i )
+               /*
+                * Apply all iterations to small blocks of samples, which stay
+                * in the processor cache, while the inner loops over samples
+                * remain free of dependencies and can be vectorized.
+                */
+               for ( typename P::sample* f = i.Position(), * f1 = j.Position(); f < f1; )
                {
-                  DVector v( n );
+                  int count = int( Min( f1 - f, ptrdiff_t( BlockSize ) ) );
+                  for ( int it = 0; it < m_m.Length(); ++it )
+                  {
+                     double m = m_m[it];
+                     for ( int k = 0; k < count; ++k )
+                        f[k] = StretchSample<P>( f[k], m );
+                  }
+                  f += count;
+
+                  UPDATE_THREAD_MONITOR_CHUNK( 65536, BlockSize )
+               }
+            }
+         }
+         else
+         {
+            typename GenericImage<P>::pixel_iterator i( m_image ); i += m_start;
+            typename GenericImage<P>::pixel_iterator j( m_image ); j += m_end;
+            for ( ; i < j; ++i )
+            {
+               /*
+                * The mask is computed from the current RGB components at each
+                * iteration, so the color case cannot be tabulated. Keep pixel
+                * components in local storage across iterations instead. Color
+                * images always have three nominal channels.
+                */
+               typename P::sample s[ 3 ];
+               for ( int c = 0; c < n; ++c )
+                  s[c] = i[c];
+
+               for ( int it = 0; it < m_m.Length(); ++it )
+               {
+                  double v[ 3 ];
                   for ( int c = 0; c < n; ++c )
-                     P::FromSample( v[c], i[c] );
+                     P::FromSample( v[c], s[c] );
 
                   double f;
                   switch ( m_instance.p_maskType )
@@ -313,22 +534,37 @@ private:
                   for ( int c = 0; c < n; ++c )
                   {
                      double g = HistogramTransformation::MTF( m_m[it], v[c] );
-                     i[c] = P::ToSample( f*v[c] + f1*g );
+                     s[c] = P::ToSample( f*v[c] + f1*g );
                   }
-
-                  UPDATE_THREAD_MONITOR( 65536 )
                }
+
+               for ( int c = 0; c < n; ++c )
+                  i[c] = s[c];
+
+               UPDATE_THREAD_MONITOR( 65536 )
             }
+         }
       }
 
    private:
 
-      const MaskedStretchInstance&     m_instance;
-      const AbstractImage::ThreadData& m_data;
-            GenericImage<P>&           m_image;
-      const DVector&                   m_m;
-            size_type                  m_start;
-            size_type                  m_end;
+      const MaskedStretchInstance&           m_instance;
+      const AbstractImage::ThreadData&       m_data;
+            GenericImage<P>&                 m_image;
+      const DVector&                         m_m;
+      const Array<typename P::sample>&       m_sampleLUT;
+      const MaskedStretchLUT&                m_lut;
+            size_type                        m_start;
+            size_type                        m_end;
+
+      constexpr static int BlockSize = 4096;
+
+      typename P::sample Stretch( typename P::sample v ) const
+      {
+         for ( int it = 0; it < m_m.Length(); ++it )
+            v = StretchSample<P>( v, m_m[it] );
+         return v;
+      }
    };
 
 };
@@ -52,11 +52,13 @@
 
 #include "NoiseGeneratorInstance.h"
 
+#include <pcl/AutoLock.h>
 #include <pcl/AutoViewLock.h>
 #include <pcl/HistogramTransformation.h>
 #include <pcl/ImageWindow.h>
 #include <pcl/Random.h>
 #include <pcl/StandardStatus.h>
+#include <pcl/Thread.h>
 #include <pcl/View.h>
 
 namespace pcl
@@ -69,6 +71,7 @@ NoiseGeneratorInstance::NoiseGeneratorInstance( const MetaProcess* m )
    , p_amount( TheNGNoiseAmountParameter->DefaultValue() )
    , p_distribution( NGNoiseDistribution::Default )
    , p_impulsionalNoiseProbability( TheNGImpulsionalNoiseProbabilityParameter->DefaultValue() )
+   , p_randomSeed( uint32( TheNGRandomSeedParameter->DefaultValue() ) )
    , p_preserveBrightness( NGPreserveBrightness::None ) // ### DEPRECATED
 {
 }
@@ -91,6 +94,7 @@ void NoiseGeneratorInstance::Assign( const ProcessImplementation& p )
       p_amount = x->p_amount;
       p_distribution = x->p_distribution;
       p_impulsionalNoiseProbability = x->p_impulsionalNoiseProbability;
+      p_randomSeed = x->p_randomSeed;
       p_preserveBrightness = x->p_preserveBrightness; // ### DEPRECATED
    }
 }
@@ -117,6 +121,16 @@ bool NoiseGeneratorInstance::CanExecuteOn( const View& view, pcl::String& whyNot
 
 // ----------------------------------------------------------------------------
 
+/*
+ * Noise generation is performed by rows of pixels. Each row of each channel
+ * uses its own XoShiRo256ss generator, seeded with a SplitMix64 hash of the
+ * random seed, the channel index and the row index. Generated noise only
+ * depends on the random seed, hence it is reproducible irrespective of the
+ * number of running threads, and the setup cost of each row is constant.
+ *
+ * Random deviates are generated in bulk for each row, then transformed and
+ * applied with dependency-free loops that compilers can vectorize.
+ */
 class NoiseGeneratorEngine
 {
 public:
@@ -135,41 +149,195 @@ public:
             TheNGImpulsionalNoiseProbabilityParameter->Precision(), G.p_impulsionalNoiseProbability ); break;
       }
 
-      size_type N = image.NumberOfNominalSamples();
+      uint64 seed = (G.p_randomSeed != 0) ? uint64( G.p_randomSeed ) : RandomSeed64();
+
+      size_type N = size_type( image.NumberOfNominalChannels() ) * size_type( image.Height() );
 
       image.Status().Initialize( "Generating noise, " + sdist, N );
       image.Status().DisableInitialization();
 
-      RandomNumberGenerator R;
-      double a = G.p_amount;
+      Array<size_type> L = Thread::OptimalThreadLoads( image.Height(), 16/*overheadLimit*/ );
+
+      ThreadData data( image, G, seed, N );
+
+      ReferenceArray<NoiseThread<P> > threads;
+      for ( int i = 0, n = 0; i < int( L.Length() ); n += int( L[i++] ) )
+         threads.Add( new NoiseThread<P>( data, image, n, n + int( L[i] ) ) );
+
+      AbstractImage::RunThreads( threads, data );
+
+      threads.Destroy();
+
+      image.Status() = data.status;
+   }
+
+   /*
+    * Seed for the generator of row y of channel c: the output of a SplitMix64
+    * generator initialized with the random seed, taken at the ordinal position
+    * of the row in the image. Zero seeds would select a random seed in
+    * XoShiRo256ss, so they are replaced.
+    */
+   static uint64 RowSeed( uint64 seed, int c, int y )
+   {
+      uint64 z = seed + 0x9e3779b97f4a7c15 * ((uint64( c ) << 32) + uint64( y ) + 1);
+      z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9;
+      z = (z ^ (z >> 27)) * 0x94d049bb133111eb;
+      z ^= z >> 31;
+      return (z != 0) ? z : 0x9e3779b97f4a7c15;
+   }
+
+   /*
+    * Uniform deviates in the range [0,1).
+    */
+   static void Uniform( XoShiRo256ss& R, double* x, int n )
+   {
+      for ( int i = 0; i < n; ++i )
+         x[i] = R();
+   }
+
+   /*
+    * Normal deviates with zero mean and unit standard deviation, generated in
+    * pairs by the Box-Muller transform. The array x must have room for an even
+    * number of elements greater than or equal to n.
+    */
+   static void Normal( XoShiRo256ss& R, double* x, int n )
+   {
+      int m = (n + 1) >> 1;
+      Uniform( R, x, m << 1 );
+      PCL_IVDEP
+      for ( int i = 0; i < m; ++i )
+      {
+         double r = Sqrt( -2*Ln( 1 - x[2*i] ) );  // 1 - u in (0,1]
+         double t = Const<double>::_2pi() * x[2*i+1];
+         x[2*i]   = r*Cos( t );
+         x[2*i+1] = r*Sin( t );
+      }
+   }
+
+private:
+
+   struct ThreadData : public AbstractImage::ThreadData
+   {
+      ThreadData( const AbstractImage& image, const NoiseGeneratorInstance& a_instance, uint64 a_seed, size_type N )
+         : AbstractImage::ThreadData( image, N )
+         , instance( a_instance )
+         , seed( a_seed )
+      {
+      }
+
+      const NoiseGeneratorInstance& instance;
+            uint64                  seed;
+   };
+
+   template <class P>
+   class NoiseThread : public Thread
+   {
+   public:
+
+      NoiseThread( ThreadData& data, GenericImage<P>& image, int startRow, int endRow )
+         : m_data( data )
+         , m_image( image )
+         , m_startRow( startRow )
+         , m_endRow( endRow )
+      {
+      }
+
+      void Run() override
+      {
+         INIT_THREAD_MONITOR()
 
-      for ( int c = 0; c < image.NumberOfNominalChannels(); ++c )
-         for ( typename GenericImage<P>::sample_iterator i( image, c ); i; ++i, ++image.Status() )
+         const NoiseGeneratorInstance& G = m_data.instance;
+         const int width = m_image.Width();
+         const double a = G.p_amount;
+         const double p = G.p_impulsionalNoiseProbability;
+
+         DVector v( width );
+         DVector u( 2*width + 2 );
+         double* __restrict__ pv = v.Begin();
+         double* __restrict__ pu = u.Begin();
+
+         for ( int c = 0; c < m_image.NumberOfNominalChannels(); ++c )
          {
-            double v; P::FromSample( v, *i );
-            switch ( G.p_distribution )
+            for ( int y = m_startRow; y < m_endRow; ++y )
             {
-            default:
-            case NGNoiseDistribution::Uniform:
-               v += a*(R() - 0.5);
-               break;
-            case NGNoiseDistribution::Normal:
-               v += R.Normal( 0.0, a );
-               break;
-            case NGNoiseDistribution::Poisson:
-               v = double( R.Poisson( v*65535/a ) )/(65535/a);
-               break;
-            case NGNoiseDistribution::Impulsional:
-               if ( R() <= G.p_impulsionalNoiseProbability )
-                  v += (R() >= 0.5) ? a : -a;
-               else
-                  continue;
-               break;
+               XoShiRo256ss R( NoiseGeneratorEngine::RowSeed( m_data.seed, c, y ) );
+
+               typename P::sample* __restrict__ f = m_image.ScanLine( y, c );
+
+               switch ( G.p_distribution )
+               {
+               default:
+               case NGNoiseDistribution::Uniform:
+                  NoiseGeneratorEngine::Uniform( R, pu, width );
+                  PCL_IVDEP
+                  for ( int i = 0; i < width; ++i )
+                  {
+                     P::FromSample( pv[i], f[i] );
+                     pv[i] += a*(pu[i] - 0.5);
+                  }
+                  Store( f, pv, width );
+                  break;
+
+               case NGNoiseDistribution::Normal:
+                  NoiseGeneratorEngine::Normal( R, pu, width );
+                  PCL_IVDEP
+                  for ( int i = 0; i < width; ++i )
+                  {
+                     P::FromSample( pv[i], f[i] );
+                     pv[i] += a*pu[i];
+                  }
+                  Store( f, pv, width );
+                  break;
+
+               case NGNoiseDistribution::Poisson:
+                  {
+                     PoissonRandomDeviates<XoShiRo256ss> poisson( R );
+                     const double k = 65535/a;
+                     for ( int i = 0; i < width; ++i )
+                     {
+                        P::FromSample( pv[i], f[i] );
+                        pv[i] = double( poisson( pv[i]*k ) )/k;
+                     }
+                     Store( f, pv, width );
+                  }
+                  break;
+
+               case NGNoiseDistribution::Impulsional:
+                  /*
+                   * Two uniform deviates per pixel: occurrence and sign of an
+                   * impulse. Pixels without impulses are left unchanged.
+                   */
+                  NoiseGeneratorEngine::Uniform( R, pu, 2*width );
+                  for ( int i = 0; i < width; ++i )
+                     if ( pu[2*i] <= p )
+                     {
+                        double x;
+                        P::FromSample( x, f[i] );
+                        x += (pu[2*i+1] >= 0.5) ? a : -a;
+                        f[i] = P::ToSample( Range( x, 0.0, 1.0 ) );
+                     }
+                  break;
+               }
+
+               UPDATE_THREAD_MONITOR( 16 )
             }
-
-            *i = P::ToSample( Range( v, 0.0, 1.0 ) );
          }
-   }
+      }
+
+   private:
+
+      ThreadData&      m_data;
+      GenericImage<P>& m_image;
+      int              m_startRow;
+      int              m_endRow;
+
+      static void Store( typename P::sample* __restrict__ f, const double* __restrict__ v, int n )
+      {
+         PCL_IVDEP
+         for ( int i = 0; i < n; ++i )
+            f[i] = P::ToSample( Range( v[i], 0.0, 1.0 ) );
+      }
+   };
 };
 
 // ----------------------------------------------------------------------------
@@ -213,6 +381,8 @@ void* NoiseGeneratorInstance::LockParameter( const MetaParameter* p, size_type /
       return &p_distribution;
    if ( p == TheNGImpulsionalNoiseProbabilityParameter )
       return &p_impulsionalNoiseProbability;
+   if ( p == TheNGRandomSeedParameter )
+      return &p_randomSeed;
    if ( p == TheNGPreserveBrightnessParameter ) // ### DEPRECATED
       return &p_preserveBrightness;
 
@@ -80,6 +80,7 @@ private:
    float    p_amount;
    pcl_enum p_distribution;
    float    p_impulsionalNoiseProbability;
+   uint32   p_randomSeed;
    pcl_enum p_preserveBrightness; // ### deprecated
 
    friend class NoiseGeneratorEngine;
@@ -171,6 +171,7 @@ void NoiseGeneratorInterface::UpdateControls()
    GUI->Impulsional_RadioButton.SetChecked( instance.p_distribution == NGNoiseDistribution::Impulsional );
    GUI->ImpulsionalProb_NumericControl.SetValue( instance.p_impulsionalNoiseProbability );
    GUI->ImpulsionalProb_NumericControl.Enable( instance.p_distribution == NGNoiseDistribution::Impulsional );
+   GUI->RandomSeed_NumericEdit.SetValue( instance.p_randomSeed );
 }
 
 // ----------------------------------------------------------------------------
@@ -181,6 +182,8 @@ void NoiseGeneratorInterface::__ValueUpdated( NumericEdit& sender, double value
       instance.p_amount = value;
    else if ( sender == GUI->ImpulsionalProb_NumericControl )
       instance.p_impulsionalNoiseProbability = value;
+   else if ( sender == GUI->RandomSeed_NumericEdit )
+      instance.p_randomSeed = uint32( value );
 }
 
 // ----------------------------------------------------------------------------
@@ -244,10 +247,21 @@ NoiseGeneratorInterface::GUIData::GUIData( NoiseGeneratorInterface& w )
    Distribution_GroupBox.SetTitle( "Distribution" );
    Distribution_GroupBox.SetSizer( Distribution_Sizer );
 
+   RandomSeed_NumericEdit.label.SetText( "Random seed:" );
+   RandomSeed_NumericEdit.SetInteger();
+   RandomSeed_NumericEdit.SetRange( TheNGRandomSeedParameter->MinimumValue(), TheNGRandomSeedParameter->MaximumValue() );
+   RandomSeed_NumericEdit.edit.SetFixedWidth( w.Font().Width( String( '0', 12 ) ) );
+   RandomSeed_NumericEdit.sizer.AddStretch();
+   RandomSeed_NumericEdit.SetToolTip( "<p>Seed for the pseudo-random number generator. For a given seed, the generated "
+      "noise is always the same, irrespective of the number of processor threads used.</p>"
+      "<p>Specify zero to use a different random seed for each execution.</p>" );
+   RandomSeed_NumericEdit.OnValueUpdated( (NumericEdit::value_event_handler)&NoiseGeneratorInterface::__ValueUpdated, w );
+
    Global_Sizer.SetMargin( 8 );
    Global_Sizer.SetSpacing( 6 );
    Global_Sizer.Add( Amount_NumericControl );
    Global_Sizer.Add( Distribution_GroupBox );
+   Global_Sizer.Add( RandomSeed_NumericEdit );
 
    w.SetSizer( Global_Sizer );
 
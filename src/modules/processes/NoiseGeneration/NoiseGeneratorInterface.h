@@ -103,6 +103,7 @@ private:
          RadioButton    Poisson_RadioButton;
          RadioButton    Impulsional_RadioButton;
          NumericControl ImpulsionalProb_NumericControl;
+      NumericEdit    RandomSeed_NumericEdit;
    };
 
    GUIData* GUI = nullptr;
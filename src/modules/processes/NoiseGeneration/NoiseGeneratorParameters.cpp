@@ -60,6 +60,7 @@ namespace pcl
 NGNoiseAmount*                 TheNGNoiseAmountParameter = nullptr;
 NGNoiseDistribution*           TheNGNoiseDistributionParameter = nullptr;
 NGImpulsionalNoiseProbability* TheNGImpulsionalNoiseProbabilityParameter = nullptr;
+NGRandomSeed*                  TheNGRandomSeedParameter = nullptr;
 NGPreserveBrightness*          TheNGPreserveBrightnessParameter = nullptr; // ### DEPRECATED
 
 // ----------------------------------------------------------------------------
@@ -147,6 +148,33 @@ double NGImpulsionalNoiseProbability::DefaultValue() const
 
 // ----------------------------------------------------------------------------
 
+NGRandomSeed::NGRandomSeed( MetaProcess* p ) : MetaUInt32( p )
+{
+   TheNGRandomSeedParameter = this;
+}
+
+IsoString NGRandomSeed::Id() const
+{
+   return "randomSeed";
+}
+
+double NGRandomSeed::DefaultValue() const
+{
+   return 0; // zero means a new random seed for each execution
+}
+
+double NGRandomSeed::MinimumValue() const
+{
+   return 0;
+}
+
+double NGRandomSeed::MaximumValue() const
+{
+   return uint32_max;
+}
+
+// ----------------------------------------------------------------------------
+
 // ### DEPRECATED
 NGPreserveBrightness::NGPreserveBrightness( MetaProcess* p ) : MetaEnumeration( p )
 {
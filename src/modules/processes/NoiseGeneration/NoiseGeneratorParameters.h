@@ -117,6 +117,22 @@ extern NGImpulsionalNoiseProbability* TheNGImpulsionalNoiseProbabilityParameter;
 
 // ----------------------------------------------------------------------------
 
+class NGRandomSeed : public MetaUInt32
+{
+public:
+
+   NGRandomSeed( MetaProcess* );
+
+   IsoString Id() const override;
+   double DefaultValue() const override;
+   double MinimumValue() const override;
+   double MaximumValue() const override;
+};
+
+extern NGRandomSeed* TheNGRandomSeedParameter;
+
+// ----------------------------------------------------------------------------
+
 // ### DEPRECATED
 class NGPreserveBrightness : public MetaEnumeration
 {
@@ -71,6 +71,7 @@ NoiseGeneratorProcess::NoiseGeneratorProcess()
    new NGNoiseAmount( this );
    new NGNoiseDistribution( this );
    new NGImpulsionalNoiseProbability( this );
+   new NGRandomSeed( this );
    new NGPreserveBrightness( this ); // ### DEPRECATED
 }
 
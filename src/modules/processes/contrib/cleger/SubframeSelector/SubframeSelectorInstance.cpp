@@ -61,7 +61,9 @@
 #include <pcl/FileFormatInstance.h>
 #include <pcl/Graphics.h>
 #include <pcl/ICCProfile.h>
+#include <pcl/ImageFilePrefetcher.h>
 #include <pcl/LocalNormalizationData.h>
+#include <pcl/MeasurementContext.h>
 #include <pcl/MessageBox.h>
 #include <pcl/MetaModule.h>
 #include <pcl/PSFFit.h>
@@ -247,12 +249,18 @@ public:
 
    SubframeSelectorMeasureThread( const SubframeSelectorInstance& instance,
                                   size_type itemIndex,
-                                  bool throwsOnMeasurementError = true )
+                                  bool throwsOnMeasurementError = true,
+                                  ImageFilePrefetcher* prefetcher = nullptr,
+                                  const MeasureData* cacheData = nullptr,
+                                  bool cacheChecked = false )
       : m_instance( instance )
       , m_index( itemIndex )
       , m_filePath( m_instance.p_subframes[m_index].path )
       , m_nmlPath( m_instance.p_subframes[m_index].nmlPath )
       , m_throwsOnMeasurementError( throwsOnMeasurementError )
+      , m_prefetcher( prefetcher )
+      , m_cacheData( cacheData )
+      , m_cacheChecked( cacheChecked )
    {
    }
 
@@ -262,18 +270,32 @@ public:
       {
          Module->ProcessEvents();
 
+         /*
+          * The caller may have looked up the subframe in the file cache
+          * already. In such case, cached data are passed to this thread, and
+          * a prefetched subframe must be retrieved from the prefetcher.
+          */
+         if ( m_cacheData != nullptr )
+         {
+            Console().NoteLn( "<end><cbr>* Retrieved data from file cache: <raw>" + m_filePath + "</raw>" );
+            m_outputData = *m_cacheData;
+            m_success = true;
+            return;
+         }
+
          if ( m_instance.p_routine == SSRoutine::MeasureSubframes )
             if ( m_instance.p_fileCache )
-            {
-               MeasureData cacheData( m_filePath );
-               if ( cacheData.GetFromCache( m_instance ) )
+               if ( !m_cacheChecked )
                {
-                  Console().NoteLn( "<end><cbr>* Retrieved data from file cache: <raw>" + m_filePath + "</raw>" );
-                  m_outputData = cacheData;
-                  m_success = true;
-                  return;
+                  MeasureData cacheData( m_filePath );
+                  if ( cacheData.GetFromCache( m_instance ) )
+                  {
+                     Console().NoteLn( "<end><cbr>* Retrieved data from file cache: <raw>" + m_filePath + "</raw>" );
+                     m_outputData = cacheData;
+                     m_success = true;
+                     return;
+                  }
                }
-            }
 
          ReadInputData();
          Perform();
@@ -334,6 +356,7 @@ private:
          String                    m_filePath;
          String                    m_nmlPath;
          ImageVariant              m_subframe;
+         MeasurementContext        m_context; // shared star detection and PSF data for m_subframe
          double                    m_pedestal = 0; // 16-bit DN
          double                    m_noise = 0;
          double                    m_noiseRatio = 0;
@@ -353,51 +376,82 @@ private:
          bool                      m_success = false;
          String                    m_errorInfo;
          bool                      m_throwsOnMeasurementError = true;
+         ImageFilePrefetcher*      m_prefetcher = nullptr;
+   const MeasureData*              m_cacheData = nullptr;
+         bool                      m_cacheChecked = false;
 
    void ReadInputData()
    {
       Console console;
       console.WriteLn( "<end><cbr>* Loading subframe file: <raw>" + m_filePath + "</raw>" );
 
-      FileFormat format( File::ExtractExtension( m_filePath ), true/*read*/, false/*write*/ );
-      FileFormatInstance file( format );
+      FITSKeywordArray keywords;
+      PropertyArray properties;
+      int cfaSourceChannel = 0;
 
-      ImageDescriptionArray images;
-      if ( !file.Open( images, m_filePath, m_instance.p_inputHints ) )
-         throw CaughtException();
+      if ( m_prefetcher != nullptr )
+      {
+         /*
+          * The subframe has been read in advance while the previous subframe
+          * was being measured.
+          */
+         ImageFilePrefetcher::Item item = m_prefetcher->Next();
 
-      if ( images.IsEmpty() )
-         throw Error( m_filePath + ": Empty subframe image." );
+         if ( item.numberOfImages > 1 )
+            console.NoteLn( String().Format( "* Ignoring %d additional image(s) in target file.", item.numberOfImages-1 ) );
 
-      if ( images.Length() > 1 )
-         console.NoteLn( String().Format( "* Ignoring %u additional image(s) in target file.", images.Length()-1 ) );
+         keywords = item.keywords;
+         properties = item.properties;
 
-      FITSKeywordArray keywords;
-      if ( format.CanStoreKeywords() )
-         file.ReadFITSKeywords( keywords );
+         for ( const Property& property : properties )
+            if ( property.Id() == "PCL:CFASourceChannel" )
+            {
+               if ( property.Value().IsValid() )
+                  cfaSourceChannel = property.Value().ToInt();
+               break;
+            }
 
-      PropertyArray properties;
-      if ( format.CanStoreImageProperties() )
-         properties = file.ReadImageProperties();
+         m_subframe = item.image;
+      }
+      else
+      {
+         FileFormat format( File::ExtractExtension( m_filePath ), true/*read*/, false/*write*/ );
+         FileFormatInstance file( format );
 
-      int cfaSourceChannel = 0;
-      if ( format.CanStoreImageProperties() )
-         if ( file.HasImageProperty( "PCL:CFASourceChannel" ) )
-         {
-            Variant v = file.ReadImageProperty( "PCL:CFASourceChannel" );
-            if ( v.IsValid() )
-               cfaSourceChannel = v.ToInt();
-         }
+         ImageDescriptionArray images;
+         if ( !file.Open( images, m_filePath, m_instance.p_inputHints ) )
+            throw CaughtException();
 
-      m_subframe.CreateSharedFloatImage( 32/*bitsPerSample*/ );
+         if ( images.IsEmpty() )
+            throw Error( m_filePath + ": Empty subframe image." );
 
-      {
-         static Mutex mutex;
-         static AtomicInt count;
-         volatile AutoLockCounter lock( mutex, count, m_instance.m_maxFileReadThreads );
+         if ( images.Length() > 1 )
+            console.NoteLn( String().Format( "* Ignoring %u additional image(s) in target file.", images.Length()-1 ) );
 
-         if ( !file.ReadImage( m_subframe ) || !file.Close() )
-            throw CaughtException();
+         if ( format.CanStoreKeywords() )
+            file.ReadFITSKeywords( keywords );
+
+         if ( format.CanStoreImageProperties() )
+            properties = file.ReadImageProperties();
+
+         if ( format.CanStoreImageProperties() )
+            if ( file.HasImageProperty( "PCL:CFASourceChannel" ) )
+            {
+               Variant v = file.ReadImageProperty( "PCL:CFASourceChannel" );
+               if ( v.IsValid() )
+                  cfaSourceChannel = v.ToInt();
+            }
+
+         m_subframe.CreateSharedFloatImage( 32/*bitsPerSample*/ );
+
+         {
+            static Mutex mutex;
+            static AtomicInt count;
+            volatile AutoLockCounter lock( mutex, count, m_instance.m_maxFileReadThreads );
+
+            if ( !file.ReadImage( m_subframe ) || !file.Close() )
+               throw CaughtException();
+         }
       }
 
       /*
@@ -612,7 +666,7 @@ private:
             PSFSignalEstimator E;
             E.Detector().EnableClusteredSources();
             E.Detector().DisableLocalMaximaDetection();
-            PSFSignalEstimator::Estimates e = E( m_subframe );
+            PSFSignalEstimator::Estimates e = E.EstimateSignal( m_subframe, m_context );
             psfTotalFlux = e.totalFlux;
             psfTotalPowerFlux = e.totalPowerFlux;
             psfTotalMeanFlux = e.totalMeanFlux;
@@ -780,6 +834,8 @@ private:
 
       // Run the star detector
       StarDetector::star_list stars = DetectStars();
+      // Cached measurement data are no longer needed
+      m_context.Clear();
       if ( stars.IsEmpty() )
          if ( m_throwsOnMeasurementError )
             throw Error( "No stars detected" );
@@ -832,15 +888,14 @@ private:
          for ( int n = 4;; )
          {
             ATrousWaveletTransform W( H, n );
-            W << m_subframe;
 
             size_type N;
             if ( n == 4 )
             {
-               noiseEstimateKS = W.NoiseKSigma( 0, 3, 0.01, 10, &N )/s_5x5B3Spline_kj[0];
+               noiseEstimateKS = W.StreamingNoiseKSigma( m_subframe, 0, 3, 0.01, 10, &N )/s_5x5B3Spline_kj[0];
                noiseFractionKS = double( N )/m_subframe->NumberOfPixels();
             }
-            noiseEstimate = W.NoiseMRS( m_subframe, s_5x5B3Spline_kj, noiseEstimateKS, 3, &N );
+            noiseEstimate = W.StreamingNoiseMRS( m_subframe, s_5x5B3Spline_kj, noiseEstimateKS, 3, &N );
             noiseFraction = double( N )/m_subframe->NumberOfPixels();
 
             if ( noiseEstimate > 0 )
@@ -880,7 +935,7 @@ private:
          PSFSignalEstimator E;
          E.Detector().EnableClusteredSources();
          E.Detector().DisableLocalMaximaDetection();
-         PSFSignalEstimator::Estimates e = E( m_subframe );
+         PSFSignalEstimator::Estimates e = E.EstimateSignal( m_subframe, m_context );
          m_outputData.psfSignalWeight = PSFSignalEstimator::PSFSignalWeight( e, m_outputData.noise );
          m_outputData.psfSNR = PSFSignalEstimator::PSFSNR( e, m_outputData.noise );
          m_outputData.psfFlux = e.totalFlux;
@@ -1005,7 +1060,7 @@ private:
       EvaluateSignalAndNoise();
    }
 
-   StarDetector::star_list DetectStars() const
+   StarDetector::star_list DetectStars()
    {
       // Setup StarDetector parameters and find the list of stars
       StarDetector S;
@@ -1022,7 +1077,12 @@ private:
       S.DisableLocalMaximaDetection( m_instance.p_allowClusteredSources );
       S.SetUpperLimit( m_instance.p_upperLimit );
 
-      StarDetector::star_list stars = S.DetectStars( m_subframe );
+      /*
+       * The measurement context allows us to reuse the structure maps already
+       * computed for PSF signal estimation when both star detectors share the
+       * same preprocessing parameters, which happens with default settings.
+       */
+      StarDetector::star_list stars = S.DetectStars( m_subframe, m_context );
 
       if ( m_instance.p_routine == SSRoutine::StarDetectionPreview )
          if ( IsRootThread() )
@@ -1505,15 +1565,44 @@ void SubframeSelectorInstance::Measure()
    }
    else // !p_useFileThreads || pendingItems.Length() < 2
    {
+      /*
+       * Read subframes in advance while the previous ones are being measured.
+       * Subframes available in the file cache are not read.
+       */
+      bool useCache = p_routine == SSRoutine::MeasureSubframes && p_fileCache;
+      StringList prefetchPaths;
+      MeasureDataList cacheData;
+      Array<bool> cached;
       for ( size_type itemIndex : pendingItems )
+      {
+         MeasureData data( p_subframes[itemIndex].path );
+         bool isCached = useCache && data.GetFromCache( *this );
+         if ( !isCached )
+            prefetchPaths << data.path;
+         cacheData << data;
+         cached << isCached;
+      }
+
+      ImageFilePrefetcher prefetcher( prefetchPaths, p_inputHints );
+      prefetcher.SetSampleFormat( 32, true/*floatSample*/ );
+      prefetcher.SetSharedImages();
+      // Keep a single decoded subframe waiting, besides the one being measured.
+      prefetcher.SetPrefetchCount( 1 );
+      if ( prefetchPaths.Length() > 1 )
+         prefetcher.Start();
+
+      for ( size_type i = 0; i < pendingItems.Length(); ++i )
       {
          try
          {
             SubframeSelectorMeasureThread thread( *this,
-                                                  itemIndex,
-                                                  !p_nonInteractive/*throwsOnMeasurementError*/ );
+                                                  pendingItems[i]/*itemIndex*/,
+                                                  !p_nonInteractive/*throwsOnMeasurementError*/,
+                                                  (prefetcher.IsRunning() && !cached[i]) ? &prefetcher : nullptr,
+                                                  cached[i] ? &cacheData[i] : nullptr,
+                                                  useCache/*cacheChecked*/ );
             thread.Run();
-            MeasureItem m( itemIndex );
+            MeasureItem m( pendingItems[i] );
             m.Input( thread.OutputData() );
             o_measures << m;
             ++succeeded;
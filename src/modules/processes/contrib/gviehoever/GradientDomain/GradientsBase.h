@@ -31,22 +31,6 @@
 #ifndef __GradientsBase_h
 #define __GradientsBase_h
 
-/// select solver based on fftw3
-///
-/// Mutually exclusive with USE_PIFFT
-//#define USE_FFTW
-
-/// define if you have a threading version of fftw.
-///
-/// Instead of libfftw3.so you need to link libfftw3_threads.so
-//#define USE_THREADS
-
-/// use FFT solver using PI internal functions
-///
-/// designed by Carlos Milovic F. .
-/// Mutually exclusive with USE_FFTW
-#define USE_PIFFT
-
 //#include <boost/date_time/posix_time/posix_time.hpp> //header only
 #ifdef __PCL_WINDOWS
 #include <time.h>
@@ -66,22 +50,15 @@ namespace pcl
 
 /// implements base routines for gradient domain image manipulation.
 ///
-/// Current solver is FFT based using von-Neumann boundary
-/// conditions at the rectagular borders. This kind of solver
-/// is fast, accurate and has decent memory consumptions. It is
-/// useful for images up to 10k*10k pixels (beyond that., things get
-/// real slow). Iterative solvers proved to be too slow or inaccurate.
+/// The default solver is a direct DCT based solver using von-Neumann boundary
+/// conditions at the rectangular borders. It is exact, multithreaded and
+/// works in place in the solution image, see GradientsPoissonSolver::solveDCT().
+/// A multigrid solver is available for masked and irregular domains, see
+/// GradientsPoissonSolver::solveMultigrid(). It is opt-in: it is only used by
+/// solveImageMasked(), and GradientMergeMosaic keeps using solveImage(). Both
+/// are self-contained and only use the PCL FFT routines.
 ///
-/// Uses solver by Carlos Milovic F (see #define USE_PIFFT).
-/// It is implemented in solver_dct3.h.
-/// This one is slower and uses more memory than the FFTW solver, but it uses
-/// PI internal routines only. Used with kind permission by Carlos.
-///
-/// As an alternative uses FFTW3 for FFT like ops, which currently is faster and more memory efficient
-/// than the PI version (see #define USE_FFTW). FFTW3 http://www.fftw.org/ is free
-/// for non-commercial use, and is delivered with Fedora 14. You
-/// may need to install development headers ("yum install fftw-devel-3").
-/// Package for Windows can be downloaded on FFTW web page.
+/// Earlier versions used a FFT solver by Carlos Milovic F, or optionally FFTW3.
 ///
 /// Introduction to Gradient Domain image ops: Good overview in
 /// http://www.umiacs.umd.edu/~aagrawal/ICCV2007Course/index.html
@@ -177,13 +154,27 @@ protected: // member functions
    static void createLaplaceVonNeumannImage( imageType_t const& rDx_p, imageType_t const rDy_p,
       imageType_t& rResultImage_p );
 
-   /// solve for image that solves laplacian rLapaplaceImage_p with von Neumann conditions, using FFT
+   /// solve for image that solves laplacian rLapaplaceImage_p with von Neumann conditions, using DCT
    ///
    /// Support multi channel images.
    /// @param rLaplaceImae_p laplacien to be solved.
    /// @param rSolution_p in: not used Out: solution
    static void solveImage( imageType_t const& rLaplaceImage_p, imageType_t& rSolution_p );
 
+   /// solve for image with gradients rDx_p, rDy_p on the domain given by rMask_p>0, using multigrid
+   ///
+   /// Not used by the processes of this module. The results differ from
+   /// solveImage() near the borders of the domain.
+   /// Gradients between the domain and the background are ignored, so the border
+   /// of the mask acts as von Neumann boundary. Pixels outside the domain are 0.
+   /// Support multi channel images.
+   /// @param rDx_p gradient in x direction, see createDxImage()
+   /// @param rDy_p gradient in y direction, see createDyImage()
+   /// @param rMask_p single channel mask, >0 for pixels of the domain
+   /// @param rSolution_p in: not used Out: solution
+   static void solveImageMasked( imageType_t const& rDx_p, imageType_t const& rDy_p,
+      weightImageType_t const& rMask_p, imageType_t& rSolution_p );
+
    /// load image with index_p from file. returns false if file with index does not exist
    static bool loadFile( const String& rsFilePath_p, std::size_t index_p, imageType_t& rImage_p );
 
@@ -0,0 +1,685 @@
+//     ____   ______ __
+//    / __ \ / ____// /
+//   / /_/ // /    / /
+//  / ____// /___ / /___   PixInsight Class Library
+// /_/     \____//_____/   PCL 2.8.5
+// ----------------------------------------------------------------------------
+// Standard GradientDomain Process Module Version 0.6.4
+// ----------------------------------------------------------------------------
+// GradientsPoissonSolver.cpp - Released 2024-12-28T16:54:15Z
+// ----------------------------------------------------------------------------
+// This file is part of the standard GradientDomain PixInsight module.
+//
+// Copyright (c) Georg Viehoever, 2011-2020. Licensed under LGPL 2.1
+// Copyright (c) 2003-2021 Pleiades Astrophoto S.L.
+//
+// This library is free software; you can redistribute it and/or
+// modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+// 
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// Lesser General Public License for more details.
+// 
+// You should have received a copy of the GNU Lesser General Public
+// License along with this library; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+// ----------------------------------------------------------------------------
+
+#include "GradientsPoissonSolver.h"
+
+#include <pcl/AutoLock.h>
+#include <pcl/FFT1D.h>
+#include <pcl/Thread.h>
+
+#include "Assert.h"
+
+namespace pcl
+{
+
+// ----------------------------------------------------------------------------
+
+namespace
+{
+
+/// thread processing a range of rows with a function object
+template <class F>
+class RowRangeThread : public Thread
+{
+public:
+
+   RowRangeThread( F const& rFunction_p, int startRow_p, int endRow_p )
+      : m_rFunction( rFunction_p )
+      , m_startRow( startRow_p )
+      , m_endRow( endRow_p )
+   {
+   }
+
+   void Run() override
+   {
+      m_rFunction( m_startRow, m_endRow );
+   }
+
+private:
+
+   F const& m_rFunction;
+   int m_startRow;
+   int m_endRow;
+};
+
+/// calls rFunction_p(startRow,endRow) for disjoint row ranges covering nRows_p rows, in parallel
+///
+/// @param minRows_p minimum number of rows per thread. Small jobs run in the calling thread.
+template <class F>
+void forEachRowRange( int nRows_p, int minRows_p, F const& rFunction_p )
+{
+   Array<size_type> loads = Thread::OptimalThreadLoads( nRows_p, Max( 1, minRows_p ) );
+   ReferenceArray<RowRangeThread<F>> threads;
+   for ( size_type i = 0, n = 0; i < loads.Length(); n += loads[i++] )
+      threads.Add( new RowRangeThread<F>( rFunction_p, int( n ), int( n + loads[i] ) ) );
+   AbstractImage::ThreadData data;
+   AbstractImage::RunThreads( threads, data );
+   threads.Destroy();
+}
+
+/// minimum number of rows per thread for an image width of nCols_p
+int minRowsPerThread( int nCols_p )
+{
+   return 65536 / Max( 1, nCols_p );
+}
+
+// ----------------------------------------------------------------------------
+
+/// in place DCT-II of arbitrary length, and its exact inverse (scaled DCT-III)
+///
+/// Uses Makhoul's algorithm, which needs a single complex DFT of the same length
+/// for two real sequences.
+/// DFTs of lengths that are not optimized FFT lengths are computed as circular
+/// convolutions of an optimized length (Bluestein's algorithm). Instances hold
+/// work buffers, so each thread needs its own instance.
+class DCTTransform
+{
+public:
+
+   typedef GenericFFT<double> fft_t;
+   typedef fft_t::complex complex_t;
+   typedef fft_t::complex_vector complexVector_t;
+
+   DCTTransform( int n_p )
+      : m_n( n_p )
+      , m_bBluestein( fft_t::OptimizedLength( n_p ) != n_p )
+      , m_fft( m_bBluestein ? fft_t::OptimizedLength( 2 * n_p - 1 ) : n_p )
+      , m_twiddle( n_p )
+      , m_v( n_p )
+      , m_V( n_p )
+   {
+      for ( int k = 0; k < m_n; ++k )
+      {
+         double const a = -Pi() * k / ( 2.0 * m_n );
+         m_twiddle[k] = complex_t( Cos( a ), Sin( a ) );
+      }
+
+      if ( m_bBluestein )
+      {
+         int const m = m_fft.Length();
+         m_chirp = complexVector_t( m_n );
+         for ( int k = 0; k < m_n; ++k )
+         {
+            // k^2 modulo 2n keeps the argument small for large k
+            double const a = -Pi() * double( ( int64( k ) * k ) % ( 2 * int64( m_n ) ) ) / m_n;
+            m_chirp[k] = complex_t( Cos( a ), Sin( a ) );
+         }
+         complexVector_t b( complex_t( 0 ), m );
+         b[0] = ~m_chirp[0];
+         for ( int k = 1; k < m_n; ++k )
+            b[k] = b[m - k] = ~m_chirp[k];
+         // FFT of the convolution kernel, including the normalization of the inverse FFT
+         m_kernel = complexVector_t( m );
+         m_fft( *m_kernel, *b );
+         for ( int k = 0; k < m; ++k )
+            m_kernel[k] /= m;
+         m_a = complexVector_t( m );
+         m_A = complexVector_t( m );
+      }
+   }
+
+   /// DCT-II: x(k) = sum_j x(j)*cos(pi*k*(2j+1)/(2n))
+   ///
+   /// Transforms two real sequences with a single complex DFT. pX2_p may be
+   /// nullptr.
+   void forward( double* pX1_p, double* pX2_p = nullptr )
+   {
+      for ( int k = 0, j = 0; j < m_n; ++k, j += 2 )
+         m_v[k] = complex_t( pX1_p[j], ( pX2_p != nullptr ) ? pX2_p[j] : 0.0 );
+      for ( int k = m_n - 1, j = 1; j < m_n; --k, j += 2 )
+         m_v[k] = complex_t( pX1_p[j], ( pX2_p != nullptr ) ? pX2_p[j] : 0.0 );
+      dft( *m_V, *m_v );
+      for ( int k = 0; k < m_n; ++k )
+      {
+         // separate the spectra of the real and imaginary parts
+         complex_t const z = m_V[k];
+         complex_t const zn = ~m_V[( m_n - k ) % m_n];
+         pX1_p[k] = ( ( z + zn ) * m_twiddle[k] ).Real() / 2;
+         if ( pX2_p != nullptr )
+            pX2_p[k] = ( ( z - zn ) * m_twiddle[k] ).Imag() / 2;
+      }
+   }
+
+   /// exact inverse of forward()
+   void inverse( double* pX1_p, double* pX2_p = nullptr )
+   {
+      // the inverse DFT is computed as the conjugate of the DFT of the conjugate
+      m_v[0] = ~complex_t( pX1_p[0], ( pX2_p != nullptr ) ? pX2_p[0] : 0.0 );
+      for ( int k = 1; k < m_n; ++k )
+      {
+         complex_t const t = ~m_twiddle[k];
+         complex_t z = t * complex_t( pX1_p[k], -pX1_p[m_n - k] );
+         if ( pX2_p != nullptr )
+            z += complex_t( 0, 1 ) * t * complex_t( pX2_p[k], -pX2_p[m_n - k] );
+         m_v[k] = ~z;
+      }
+      dft( *m_V, *m_v );
+      for ( int k = 0, j = 0; j < m_n; ++k, j += 2 )
+      {
+         pX1_p[j] = m_V[k].Real() / m_n;
+         if ( pX2_p != nullptr )
+            pX2_p[j] = -m_V[k].Imag() / m_n;
+      }
+      for ( int k = m_n - 1, j = 1; j < m_n; --k, j += 2 )
+      {
+         pX1_p[j] = m_V[k].Real() / m_n;
+         if ( pX2_p != nullptr )
+            pX2_p[j] = -m_V[k].Imag() / m_n;
+      }
+   }
+
+private:
+
+   int m_n;
+   bool m_bBluestein;
+   fft_t m_fft;
+   complexVector_t m_twiddle;
+   complexVector_t m_v, m_V;
+   complexVector_t m_chirp, m_kernel, m_a, m_A;
+
+   /// forward DFT of length n
+   void dft( complex_t* pY_p, complex_t const* pX_p )
+   {
+      if ( !m_bBluestein )
+      {
+         m_fft( pY_p, pX_p );
+         return;
+      }
+      int const m = m_fft.Length();
+      for ( int k = 0; k < m_n; ++k )
+         m_a[k] = pX_p[k] * m_chirp[k];
+      for ( int k = m_n; k < m; ++k )
+         m_a[k] = 0.0;
+      m_fft( *m_A, *m_a );
+      for ( int k = 0; k < m; ++k )
+         m_A[k] *= m_kernel[k];
+      m_fft( *m_a, *m_A, PCL_FFT_BACKWARD );
+      for ( int k = 0; k < m_n; ++k )
+         pY_p[k] = m_a[k] * m_chirp[k];
+   }
+};
+
+// ----------------------------------------------------------------------------
+
+/// one level of the multigrid hierarchy
+///
+/// The discrete equation for pixel p is sum_q c(p,q)*(u(q)-u(p)) = f(p), where q are
+/// the 4-neighbours of p and c(p,q) are conductances: 1 for neighbouring pixels of
+/// the finest level that both belong to the domain, 0 otherwise.
+struct MultigridLevel
+{
+   int nCols = 0;
+   int nRows = 0;
+   Array<float> cx;   ///< conductance between (col,row) and (col+1,row), (nCols-1)*nRows
+   Array<float> cy;   ///< conductance between (col,row) and (col,row+1), nCols*(nRows-1)
+   Array<float> diag; ///< sum of the conductances of each pixel. 0 for pixels outside the domain
+   Array<float> u;    ///< correction, coarse levels only
+   Array<float> f;    ///< right hand side, coarse levels only
+   Array<float> r;    ///< residual
+
+   void allocate( int nCols_p, int nRows_p )
+   {
+      nCols = nCols_p;
+      nRows = nRows_p;
+      size_type const n = size_type( nCols ) * nRows;
+      cx = Array<float>( size_type( nCols - 1 ) * nRows, 0.0F );
+      cy = Array<float>( size_type( nCols ) * ( nRows - 1 ), 0.0F );
+      diag = Array<float>( n, 0.0F );
+      r = Array<float>( n, 0.0F );
+   }
+
+   void computeDiagonal()
+   {
+      for ( int row = 0; row < nRows; ++row )
+         for ( int col = 0; col < nCols; ++col )
+         {
+            float d = 0;
+            if ( col > 0 )
+               d += cx[size_type( row ) * ( nCols - 1 ) + col - 1];
+            if ( col < nCols - 1 )
+               d += cx[size_type( row ) * ( nCols - 1 ) + col];
+            if ( row > 0 )
+               d += cy[size_type( row - 1 ) * nCols + col];
+            if ( row < nRows - 1 )
+               d += cy[size_type( row ) * nCols + col];
+            diag[size_type( row ) * nCols + col] = d;
+         }
+   }
+};
+
+/// red-black Gauss-Seidel sweeps
+template <typename T, typename S>
+void smooth( MultigridLevel const& rLevel_p, T* pU_p, S const* pF_p, int nSweeps_p )
+{
+   int const nCols = rLevel_p.nCols;
+   int const nRows = rLevel_p.nRows;
+   float const* cx = rLevel_p.cx.Begin();
+   float const* cy = rLevel_p.cy.Begin();
+   float const* diag = rLevel_p.diag.Begin();
+
+   for ( int sweep = 0; sweep < nSweeps_p; ++sweep )
+      for ( int color = 0; color < 2; ++color )
+         forEachRowRange( nRows, minRowsPerThread( nCols ),
+            [=]( int startRow_p, int endRow_p )
+            {
+               for ( int row = startRow_p; row < endRow_p; ++row )
+               {
+                  size_type const i0 = size_type( row ) * nCols;
+                  float const* cxRow = cx + size_type( row ) * ( nCols - 1 );
+                  for ( int col = ( row + color ) & 1; col < nCols; col += 2 )
+                  {
+                     size_type const i = i0 + col;
+                     if ( diag[i] == 0 )
+                        continue;
+                     T s = -pF_p[i];
+                     if ( col > 0 )
+                        s += cxRow[col - 1] * pU_p[i - 1];
+                     if ( col < nCols - 1 )
+                        s += cxRow[col] * pU_p[i + 1];
+                     if ( row > 0 )
+                        s += cy[i - nCols] * pU_p[i - nCols];
+                     if ( row < nRows - 1 )
+                        s += cy[i] * pU_p[i + nCols];
+                     pU_p[i] = s / diag[i];
+                  }
+               }
+            } );
+}
+
+/// computes the residual f-A*u into rLevel_p.r. Returns its squared norm.
+template <typename T, typename S>
+double residual( MultigridLevel& rLevel_p, T const* pU_p, S const* pF_p )
+{
+   int const nCols = rLevel_p.nCols;
+   int const nRows = rLevel_p.nRows;
+   float const* cx = rLevel_p.cx.Begin();
+   float const* cy = rLevel_p.cy.Begin();
+   float const* diag = rLevel_p.diag.Begin();
+   float* r = rLevel_p.r.Begin();
+   double norm2 = 0;
+   Mutex mutex;
+
+   forEachRowRange( nRows, minRowsPerThread( nCols ),
+      [&]( int startRow_p, int endRow_p )
+      {
+         double sum2 = 0;
+         for ( int row = startRow_p; row < endRow_p; ++row )
+         {
+            size_type const i0 = size_type( row ) * nCols;
+            float const* cxRow = cx + size_type( row ) * ( nCols - 1 );
+            for ( int col = 0; col < nCols; ++col )
+            {
+               size_type const i = i0 + col;
+               if ( diag[i] == 0 )
+               {
+                  r[i] = 0;
+                  continue;
+               }
+               T s = pF_p[i] + diag[i] * pU_p[i];
+               if ( col > 0 )
+                  s -= cxRow[col - 1] * pU_p[i - 1];
+               if ( col < nCols - 1 )
+                  s -= cxRow[col] * pU_p[i + 1];
+               if ( row > 0 )
+                  s -= cy[i - nCols] * pU_p[i - nCols];
+               if ( row < nRows - 1 )
+                  s -= cy[i] * pU_p[i + nCols];
+               r[i] = float( s );
+               sum2 += double( s ) * s;
+            }
+         }
+         volatile AutoLock lock( mutex );
+         norm2 += sum2;
+      } );
+
+   return norm2;
+}
+
+/// builds the coarse level rCoarse_p from rFine_p
+///
+/// Coarse conductances are the mean of the two fine conductances crossing each
+/// coarse cell face, which is the rediscretization of the fine operator.
+void coarsen( MultigridLevel const& rFine_p, MultigridLevel& rCoarse_p )
+{
+   int const nColsF = rFine_p.nCols;
+   int const nRowsF = rFine_p.nRows;
+   rCoarse_p.allocate( ( nColsF + 1 ) / 2, ( nRowsF + 1 ) / 2 );
+   int const nCols = rCoarse_p.nCols;
+   int const nRows = rCoarse_p.nRows;
+
+   for ( int row = 0; row < nRows; ++row )
+      for ( int col = 0; col < nCols - 1; ++col )
+      {
+         int const colF = 2 * col + 1;
+         float s = rFine_p.cx[size_type( 2 * row ) * ( nColsF - 1 ) + colF];
+         if ( 2 * row + 1 < nRowsF )
+            s += rFine_p.cx[size_type( 2 * row + 1 ) * ( nColsF - 1 ) + colF];
+         rCoarse_p.cx[size_type( row ) * ( nCols - 1 ) + col] = s / 2;
+      }
+   for ( int row = 0; row < nRows - 1; ++row )
+   {
+      int const rowF = 2 * row + 1;
+      for ( int col = 0; col < nCols; ++col )
+      {
+         float s = rFine_p.cy[size_type( rowF ) * nColsF + 2 * col];
+         if ( 2 * col + 1 < nColsF )
+            s += rFine_p.cy[size_type( rowF ) * nColsF + 2 * col + 1];
+         rCoarse_p.cy[size_type( row ) * nCols + col] = s / 2;
+      }
+   }
+   rCoarse_p.computeDiagonal();
+
+   size_type const n = size_type( nCols ) * nRows;
+   rCoarse_p.u = Array<float>( n, 0.0F );
+   rCoarse_p.f = Array<float>( n, 0.0F );
+}
+
+/// sums the fine residual of each coarse cell into the coarse right hand side
+void restrictResidual( MultigridLevel const& rFine_p, MultigridLevel& rCoarse_p )
+{
+   int const nColsF = rFine_p.nCols;
+   int const nRowsF = rFine_p.nRows;
+   int const nCols = rCoarse_p.nCols;
+   float const* r = rFine_p.r.Begin();
+   float* f = rCoarse_p.f.Begin();
+
+   forEachRowRange( rCoarse_p.nRows, minRowsPerThread( nCols ),
+      [=]( int startRow_p, int endRow_p )
+      {
+         for ( int row = startRow_p; row < endRow_p; ++row )
+            for ( int col = 0; col < nCols; ++col )
+            {
+               float s = 0;
+               for ( int rowF = 2 * row; rowF < Min( 2 * row + 2, nRowsF ); ++rowF )
+                  for ( int colF = 2 * col; colF < Min( 2 * col + 2, nColsF ); ++colF )
+                     s += r[size_type( rowF ) * nColsF + colF];
+               f[size_type( row ) * nCols + col] = s;
+            }
+      } );
+}
+
+/// adds the coarse correction to the fine solution (piecewise constant interpolation)
+template <typename T>
+void prolongate( MultigridLevel const& rCoarse_p, MultigridLevel const& rFine_p, T* pU_p )
+{
+   int const nCols = rFine_p.nCols;
+   int const nColsC = rCoarse_p.nCols;
+   float const* e = rCoarse_p.u.Begin();
+   float const* diag = rFine_p.diag.Begin();
+
+   forEachRowRange( rFine_p.nRows, minRowsPerThread( nCols ),
+      [=]( int startRow_p, int endRow_p )
+      {
+         for ( int row = startRow_p; row < endRow_p; ++row )
+         {
+            size_type const i0 = size_type( row ) * nCols;
+            float const* eRow = e + size_type( row / 2 ) * nColsC;
+            for ( int col = 0; col < nCols; ++col )
+               if ( diag[i0 + col] != 0 )
+                  pU_p[i0 + col] += eRow[col / 2];
+         }
+      } );
+}
+
+int const preSweeps = 2;
+int const postSweeps = 2;
+int const coarsestSweeps = 500;
+int const coarsestSize = 16;
+
+/// one V-cycle starting at level l_p
+template <typename T, typename S>
+void vCycle( Array<MultigridLevel>& rLevels_p, size_type l_p, T* pU_p, S const* pF_p )
+{
+   MultigridLevel& rLevel = rLevels_p[l_p];
+   if ( l_p == rLevels_p.Length() - 1 )
+   {
+      smooth( rLevel, pU_p, pF_p, coarsestSweeps );
+      return;
+   }
+   smooth( rLevel, pU_p, pF_p, preSweeps );
+   residual( rLevel, pU_p, pF_p );
+   MultigridLevel& rCoarse = rLevels_p[l_p + 1];
+   restrictResidual( rLevel, rCoarse );
+   rCoarse.u.Fill( 0.0F );
+   vCycle( rLevels_p, l_p + 1, rCoarse.u.Begin(), static_cast<float const*>( rCoarse.f.Begin() ) );
+   prolongate( rCoarse, rLevel, pU_p );
+   smooth( rLevel, pU_p, pF_p, postSweeps );
+}
+
+} // namespace
+
+// ----------------------------------------------------------------------------
+
+//static
+void GradientsPoissonSolver::solveDCT( imageType_t const& rLaplaceImage_p, imageType_t& rSolution_p )
+{
+   int const nRows = rLaplaceImage_p.Height();
+   int const nCols = rLaplaceImage_p.Width();
+   int const nChannels = rLaplaceImage_p.NumberOfChannels();
+   imageType_t::color_space colorSpace = rLaplaceImage_p.ColorSpace();
+
+   Assert( nRows > 1 && nCols > 1 );
+
+   rSolution_p.AllocateData( nCols, nRows, nChannels, colorSpace );
+   rSolution_p.ResetSelections();
+
+   // eigenvalues of the von Neumann laplacian are the sums of these terms
+   Array<double> eigenX( nCols ), eigenY( nRows );
+   for ( int col = 0; col < nCols; ++col )
+      eigenX[col] = 2 * Cos( Pi() * col / nCols ) - 2;
+   for ( int row = 0; row < nRows; ++row )
+      eigenY[row] = 2 * Cos( Pi() * row / nRows ) - 2;
+
+   // number of columns transformed together, so that we read whole cache lines
+   int const blockSize = 8;
+   int const nBlocks = ( nCols + blockSize - 1 ) / blockSize;
+
+   for ( int chan = 0; chan < nChannels; ++chan )
+   {
+      realType_t* pData = rSolution_p.PixelData( chan );
+      imageType_t::pixel_traits::Copy( pData, rLaplaceImage_p.PixelData( chan ), rSolution_p.NumberOfPixels() );
+
+      // DCT of rows
+      forEachRowRange( nRows, 16,
+         [=]( int startRow_p, int endRow_p )
+         {
+            DCTTransform dct( nCols );
+            for ( int row = startRow_p; row < endRow_p; row += 2 )
+               dct.forward( pData + size_type( row ) * nCols,
+                  ( row + 1 < endRow_p ) ? pData + size_type( row + 1 ) * nCols : nullptr );
+         } );
+
+      // DCT of columns, division by eigenvalues and inverse DCT of columns
+      forEachRowRange( nBlocks, 1,
+         [&]( int startBlock_p, int endBlock_p )
+         {
+            DCTTransform dct( nRows );
+            Array<double> buffer( size_type( blockSize ) * nRows );
+            for ( int block = startBlock_p; block < endBlock_p; ++block )
+            {
+               int const col0 = block * blockSize;
+               int const n = Min( blockSize, nCols - col0 );
+               for ( int row = 0; row < nRows; ++row )
+               {
+                  realType_t const* p = pData + size_type( row ) * nCols + col0;
+                  for ( int i = 0; i < n; ++i )
+                     buffer[size_type( i ) * nRows + row] = p[i];
+               }
+               for ( int i = 0; i < n; i += 2 )
+               {
+                  double* c1 = buffer.Begin() + size_type( i ) * nRows;
+                  double* c2 = ( i + 1 < n ) ? c1 + nRows : nullptr;
+                  dct.forward( c1, c2 );
+                  for ( int j = i; j < Min( i + 2, n ); ++j )
+                  {
+                     double* c = buffer.Begin() + size_type( j ) * nRows;
+                     double const ex = eigenX[col0 + j];
+                     for ( int row = 0; row < nRows; ++row )
+                     {
+                        double const e = ex + eigenY[row];
+                        c[row] = ( e != 0 ) ? c[row] / e : 0.0; // zero mean solution
+                     }
+                  }
+                  dct.inverse( c1, c2 );
+               }
+               for ( int row = 0; row < nRows; ++row )
+               {
+                  realType_t* p = pData + size_type( row ) * nCols + col0;
+                  for ( int i = 0; i < n; ++i )
+                     p[i] = buffer[size_type( i ) * nRows + row];
+               }
+            }
+         } );
+
+      // inverse DCT of rows
+      forEachRowRange( nRows, 16,
+         [=]( int startRow_p, int endRow_p )
+         {
+            DCTTransform dct( nCols );
+            for ( int row = startRow_p; row < endRow_p; row += 2 )
+               dct.inverse( pData + size_type( row ) * nCols,
+                  ( row + 1 < endRow_p ) ? pData + size_type( row + 1 ) * nCols : nullptr );
+         } );
+   }
+}
+
+// ----------------------------------------------------------------------------
+
+//static
+void GradientsPoissonSolver::solveMultigrid( imageType_t const& rDx_p, imageType_t const& rDy_p,
+   imageType_t const& rMask_p, imageType_t& rSolution_p,
+   realType_t tolerance_p, int maxCycles_p )
+{
+   int const nRows = rMask_p.Height();
+   int const nCols = rMask_p.Width();
+   int const nChannels = rDx_p.NumberOfChannels();
+   imageType_t::color_space colorSpace = rDx_p.ColorSpace();
+   size_type const nPixels = size_type( nCols ) * nRows;
+
+   Assert( nRows > 1 && nCols > 1 );
+   Assert( rDx_p.Width() == nCols - 1 && rDx_p.Height() == nRows );
+   Assert( rDy_p.Width() == nCols && rDy_p.Height() == nRows - 1 );
+   Assert( rDy_p.NumberOfChannels() == nChannels );
+
+   // level hierarchy
+   Array<MultigridLevel> levels;
+   {
+      MultigridLevel finest;
+      finest.allocate( nCols, nRows );
+      realType_t const* mask = rMask_p.PixelData( 0 );
+      for ( int row = 0; row < nRows; ++row )
+         for ( int col = 0; col < nCols - 1; ++col )
+         {
+            size_type const i = size_type( row ) * nCols + col;
+            if ( mask[i] > 0 && mask[i + 1] > 0 )
+               finest.cx[size_type( row ) * ( nCols - 1 ) + col] = 1;
+         }
+      for ( int row = 0; row < nRows - 1; ++row )
+         for ( int col = 0; col < nCols; ++col )
+         {
+            size_type const i = size_type( row ) * nCols + col;
+            if ( mask[i] > 0 && mask[i + nCols] > 0 )
+               finest.cy[i] = 1;
+         }
+      finest.computeDiagonal();
+      levels.Add( finest );
+   }
+   while ( levels[levels.Length() - 1].nCols > coarsestSize || levels[levels.Length() - 1].nRows > coarsestSize )
+   {
+      MultigridLevel coarse;
+      coarsen( levels[levels.Length() - 1], coarse );
+      levels.Add( coarse );
+   }
+   MultigridLevel& rFinest = levels[0];
+
+   rSolution_p.AllocateData( nCols, nRows, nChannels, colorSpace );
+   rSolution_p.ResetSelections();
+   rSolution_p.Zero();
+
+   // The right hand side only has to be as accurate as the convergence
+   // tolerance, so it is stored in single precision like the residual and
+   // the coarse levels. The solution is accumulated in double precision.
+   Array<float> f( nPixels );
+   for ( int chan = 0; chan < nChannels; ++chan )
+   {
+      // divergence of the gradients between pixels of the domain
+      realType_t const* dx = rDx_p.PixelData( chan );
+      realType_t const* dy = rDy_p.PixelData( chan );
+      double norm2 = 0;
+      for ( int row = 0; row < nRows; ++row )
+         for ( int col = 0; col < nCols; ++col )
+         {
+            size_type const i = size_type( row ) * nCols + col;
+            size_type const ix = size_type( row ) * ( nCols - 1 ) + col;
+            realType_t s = 0;
+            if ( col > 0 )
+               s -= rFinest.cx[ix - 1] * dx[ix - 1];
+            if ( col < nCols - 1 )
+               s += rFinest.cx[ix] * dx[ix];
+            if ( row > 0 )
+               s -= rFinest.cy[i - nCols] * dy[i - nCols];
+            if ( row < nRows - 1 )
+               s += rFinest.cy[i] * dy[i];
+            f[i] = float( s );
+            norm2 += double( f[i] ) * f[i];
+         }
+      if ( norm2 == 0 )
+         continue;
+
+      realType_t* u = rSolution_p.PixelData( chan );
+      for ( int cycle = 0; cycle < maxCycles_p; ++cycle )
+      {
+         vCycle( levels, 0, u, static_cast<float const*>( f.Begin() ) );
+         if ( residual( rFinest, static_cast<realType_t const*>( u ), static_cast<float const*>( f.Begin() ) ) <= tolerance_p * tolerance_p * norm2 )
+            break;
+      }
+
+      // zero mean on the domain
+      double sum = 0;
+      size_type count = 0;
+      for ( size_type i = 0; i < nPixels; ++i )
+         if ( rFinest.diag[i] != 0 )
+         {
+            sum += u[i];
+            ++count;
+         }
+      realType_t const mean = sum / count;
+      for ( size_type i = 0; i < nPixels; ++i )
+         if ( rFinest.diag[i] != 0 )
+            u[i] -= mean;
+   }
+}
+
+// ----------------------------------------------------------------------------
+
+}; // namespace pcl
+
+// ----------------------------------------------------------------------------
+// EOF GradientsPoissonSolver.cpp - Released 2024-12-28T16:54:15Z
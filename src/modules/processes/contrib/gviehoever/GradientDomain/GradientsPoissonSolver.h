@@ -0,0 +1,112 @@
+//     ____   ______ __
+//    / __ \ / ____// /
+//   / /_/ // /    / /
+//  / ____// /___ / /___   PixInsight Class Library
+// /_/     \____//_____/   PCL 2.8.5
+// ----------------------------------------------------------------------------
+// Standard GradientDomain Process Module Version 0.6.4
+// ----------------------------------------------------------------------------
+// GradientsPoissonSolver.h - Released 2024-12-28T16:54:15Z
+// ----------------------------------------------------------------------------
+// This file is part of the standard GradientDomain PixInsight module.
+//
+// Copyright (c) Georg Viehoever, 2011-2020. Licensed under LGPL 2.1
+// Copyright (c) 2003-2021 Pleiades Astrophoto S.L.
+//
+// This library is free software; you can redistribute it and/or
+// modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+// 
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// Lesser General Public License for more details.
+// 
+// You should have received a copy of the GNU Lesser General Public
+// License along with this library; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+// ----------------------------------------------------------------------------
+
+#ifndef __GradientsPoissonSolver_h
+#define __GradientsPoissonSolver_h
+
+#include <pcl/Image.h>
+
+namespace pcl
+{
+
+// ----------------------------------------------------------------------------
+
+/// solvers for the discrete Poisson equation of gradient domain image ops.
+///
+/// All solvers use the 5-point stencil with von Neumann boundary conditions,
+/// i.e. they invert GradientsBase::createLaplaceVonNeumannImage(). Solutions
+/// are determined up to an additive constant, which is chosen such that the
+/// solution has zero mean.
+///
+/// The solvers are self-contained and multithreaded. They only rely on the
+/// PCL FFT routines.
+class GradientsPoissonSolver
+{
+public:
+
+   /// holds the image data. Same as GradientsBase::imageType_t
+   typedef DImage imageType_t;
+
+   /// numeric type for images used here (double)
+   typedef imageType_t::pixel_traits::sample realType_t;
+
+   /// direct solver for rectangular domains based on the discrete cosine transform.
+   ///
+   /// Computes DCT-II/DCT-III pairs of the exact image dimensions with PCL
+   /// FFTs (Makhoul's algorithm). Lengths that are not optimized FFT lengths
+   /// are computed as convolutions of optimized lengths (Bluestein's algorithm),
+   /// so there is no padding and the solution is exact up to rounding errors.
+   /// The transforms are performed in place in rSolution_p, so the only
+   /// full-size buffer is the solution itself.
+   /// All computations are done in double precision: single precision
+   /// transforms would change the results of existing GradientMergeMosaic
+   /// projects, which use this solver.
+   ///
+   /// Supports multi channel images.
+   /// @param rLaplaceImage_p laplacian to be solved.
+   /// @param rSolution_p in: not used Out: solution
+   static void solveDCT( imageType_t const& rLaplaceImage_p, imageType_t& rSolution_p );
+
+   /// multigrid solver for masked and irregular domains.
+   ///
+   /// The domain consists of all pixels with rMask_p>0. Only gradients between
+   /// two pixels of the domain are taken into account, so the mask border
+   /// acts as a von Neumann boundary. This is why this solver takes the
+   /// gradient images instead of their laplacian. Each connected component
+   /// of the domain is solved independently, and pixels outside the domain
+   /// are set to zero.
+   ///
+   /// Uses cell centered V-cycles with red-black Gauss-Seidel smoothing.
+   /// All work buffers (conductances, right hand side, residuals and coarse
+   /// level corrections) are stored in single precision, which is sufficient
+   /// for the convergence tolerance. Only the solution is accumulated in
+   /// double precision.
+   ///
+   /// Supports multi channel images.
+   /// @param rDx_p gradients in x direction, see GradientsBase::createDxImage()
+   /// @param rDy_p gradients in y direction, see GradientsBase::createDyImage()
+   /// @param rMask_p single channel image, >0 for pixels that belong to the domain
+   /// @param rSolution_p in: not used Out: solution
+   /// @param tolerance_p stop when the norm of the residual relative to the norm of the
+   ///        right hand side is below this value
+   /// @param maxCycles_p maximum number of V-cycles per channel
+   static void solveMultigrid( imageType_t const& rDx_p, imageType_t const& rDy_p,
+      imageType_t const& rMask_p, imageType_t& rSolution_p,
+      realType_t tolerance_p = 1.0e-6, int maxCycles_p = 50 );
+};
+
+// ----------------------------------------------------------------------------
+
+}; // namespace pcl
+
+#endif // __GradientsPoissonSolver_h
+
+// ----------------------------------------------------------------------------
+// EOF GradientsPoissonSolver.h - Released 2024-12-28T16:54:15Z
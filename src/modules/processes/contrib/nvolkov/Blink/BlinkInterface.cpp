@@ -66,6 +66,7 @@
 #include <pcl/FileFormatInstance.h>
 #include <pcl/GlobalSettings.h>
 #include <pcl/Graphics.h>
+#include <pcl/IntegerResample.h>
 #include <pcl/MessageBox.h>
 #include <pcl/MetaModule.h>
 #include <pcl/ProgressBarStatus.h>
@@ -91,11 +92,33 @@ static int PreviewSize = 202;
  */
 static const float g_delaySecs[] = { 0.0F, 0.01F, 0.02F, 0.05F, 0.1F, 0.2F, 0.3F, 0.5F, 0.75F, 1.0F, 2.0F, 5.0F };
 
+/*
+ * Maximum BlinkScreen dimensions in pixels, zero = full resolution
+ */
+static const int g_screenSizes[] = { 0, 4096, 2048, 1024 };
+
 /*
  * Maximum physical memory load
  */
 static double g_memoryLoadLimit = 0.9;
 
+/*
+ * Default frame cache size as a fraction of the available physical memory.
+ */
+static double g_cacheMemoryFraction = 0.25;
+
+/*
+ * Maximum number of images loaded asynchronously ahead of the current image.
+ */
+static int g_prefetchDepth = 3;
+
+/*
+ * Maximum number of pixels used to compute STF statistics. Larger images are
+ * decimated by regular subsampling, which preserves the distribution of pixel
+ * values, and hence the median and MAD estimates used for auto stretch.
+ */
+static size_type g_maxStatisticsPixels = 2*1024*1024;
+
 // ----------------------------------------------------------------------------
 
 template <class P>
@@ -142,6 +165,73 @@ static bool LoadImage_P( GenericImage<P>& image, const String& filePath )
    }
 }
 
+// ----------------------------------------------------------------------------
+
+/*
+ * Thread-safe image reading routine for asynchronous loading. No console
+ * output and no event processing can take place here.
+ */
+static bool ReadImage_P( blink_image& image, const String& filePath )
+{
+   FileFormat format( File::ExtractExtension( filePath ), true/*toRead*/, false/*toWrite*/ );
+   FileFormatInstance file( format );
+   ImageDescriptionArray images;
+   if ( !file.Open( images, filePath ) )
+      return false;
+   bool ok = !images.IsEmpty() && file.SelectImage( 0 ) && file.ReadImage( image );
+   file.Close();
+   return ok;
+}
+
+// ----------------------------------------------------------------------------
+
+/*
+ * Regular subsampling of an image to at most maxPixels pixels.
+ */
+static void DecimateImage( blink_image& target, const blink_image& source, size_type maxPixels )
+{
+   int step = Max( 1, TruncInt( Ceil( Sqrt( double( source.NumberOfPixels() )/maxPixels ) ) ) );
+   int width = (source.Width() + step - 1)/step;
+   int height = (source.Height() + step - 1)/step;
+   target.AllocateData( width, height, source.NumberOfChannels(), source.ColorSpace() );
+   for ( int c = 0; c < source.NumberOfChannels(); ++c )
+   {
+      blink_image::sample* t = target[c];
+      for ( int y = 0; y < source.Height(); y += step )
+      {
+         const blink_image::sample* s = source.ScanLine( y, c );
+         for ( int x = 0; x < source.Width(); x += step )
+            *t++ = s[x];
+      }
+   }
+}
+
+// ----------------------------------------------------------------------------
+
+/*
+ * Box-filtered reduction of an image by an integer factor.
+ */
+static void ReduceImage( blink_image& image, int z, bool parallel = true )
+{
+   if ( z > 1 )
+   {
+      IntegerResample R( -z );
+      R.EnableParallelProcessing( parallel );
+      R >> image;
+   }
+}
+
+// ----------------------------------------------------------------------------
+
+/*
+ * Box-filtered reduction of an image to fit in the interface preview.
+ */
+static void GenerateThumbnail( blink_image& thumbnail, const blink_image& image )
+{
+   thumbnail.Assign( image );
+   ReduceImage( thumbnail, Max( 1, TruncInt( Ceil( double( Max( image.Width(), image.Height() ) )/PreviewSize ) ) ), false/*parallel*/ );
+}
+
 // ----------------------------------------------------------------------------
 // ----------------------------------------------------------------------------
 // BlinkInterface::FileData Implementation
@@ -149,12 +239,10 @@ static bool LoadImage_P( GenericImage<P>& image, const String& filePath )
 // ----------------------------------------------------------------------------
 
 BlinkInterface::FileData::FileData( FileFormatInstance& file,
-                                    blink_image* image,
                                     const ImageDescription& description,
                                     const String& path,
                                     bool realPixelData )
    : m_filePath( path )
-   , m_image( image )
    , m_options( description.options )
    , m_info( description.info )
    , m_isRealPixelData( realPixelData )
@@ -194,6 +282,9 @@ BlinkInterface::FileData::~FileData()
 
 bool BlinkInterface::BlinkData::Add( const String& filePath )
 {
+   if ( m_cacheCapacity == 0 )
+      InitializeCache();
+
    Console console;
    console.WriteLn( "<end><cbr>" + filePath );
    FileFormat format( File::ExtractExtension( filePath ), true/*toRead*/, false/*toWrite*/ );
@@ -217,6 +308,7 @@ bool BlinkInterface::BlinkData::Add( const String& filePath )
 
       size_type bytesRequired = images[0].info.NumberOfSamples()
                               * size_type( blink_image::BitsPerSample() >> 3 );
+      TrimCache( FrameBytes(), -1 ); // make room in the frame cache before reading
       size_type bytesAvailable = size_type( g_memoryLoadLimit * Module->AvailablePhysicalMemory() );
       if ( bytesAvailable == 0 )
          console.WarningLn( "<end><cbr><br>** Warning: Unable to estimate the available physical memory." );
@@ -232,11 +324,29 @@ bool BlinkInterface::BlinkData::Add( const String& filePath )
       bool realPixelData = image->IsFloatSample() != images[0].options.ieeefpSampleFormat &&
                            image->BitsPerSample() != images[0].options.bitsPerSample;
 
-      m_filesData.Add( new FileData( file, image.Release(), images[0], filePath, realPixelData ) );
+      AutoPointer<FileData> fd( new FileData( file, images[0], filePath, realPixelData ) );
+      fd->m_id = ++m_nextId;
+      fd->m_bytes = FrameBytes();
 
       if ( !file.Close() )
          throw CaughtException();
 
+      /*
+       * Statistics and preview thumbnails are computed now, while we have the
+       * full-resolution data. Then the image is reduced to the screen size
+       * and becomes the most recently used item in the frame cache.
+       */
+      GenerateThumbnail( fd->m_thumbnail, *image );
+      m_filesData.Add( fd.Release() );
+      int fileNumber = int( m_filesData.Length() ) - 1;
+      GetStatsForSTF( fileNumber, *image );
+      ReduceImage( *image, m_screenZoom );
+
+      FileData& data = m_filesData[fileNumber];
+      data.m_image = image.Release();
+      data.m_lastUsed = ++m_cacheTick;
+      m_cacheSize += data.m_bytes;
+
       return true;
    }
    catch ( ... )
@@ -260,6 +370,7 @@ void BlinkInterface::BlinkData::Remove( int row )
 {
    const int fileNumber = FileNumberGet( row );
 
+   ReleaseImage( m_filesData[fileNumber] );
    m_filesData.Destroy( m_filesData.At( fileNumber ) );
 
    if ( row == m_blinkMaster )
@@ -285,9 +396,14 @@ void BlinkInterface::BlinkData::Remove( int row )
 
 void BlinkInterface::BlinkData::Clear()
 {
+   StopPrefetching();
    m_screenRect = 0;
    m_statRect = 0;
    m_filesData.Destroy();
+   m_cacheSize = 0;
+   m_cacheCapacity = 0;
+   m_cacheHits = m_cacheMisses = 0;
+   m_screenZoom = 1;
    m_info = ImageInfo();
    m_options = ImageOptions();
    m_currentImage = 0;
@@ -299,47 +415,49 @@ void BlinkInterface::BlinkData::Clear()
 
 // ----------------------------------------------------------------------------
 
-void BlinkInterface::BlinkData::GetStatsForSTF( int fileNumber )
+void BlinkInterface::BlinkData::GetStatsForSTF( int fileNumber, const blink_image& image )
 {
    FileData& fd = m_filesData[fileNumber];
-   if ( !fd.m_statSTF.IsEmpty() )
-      return;
+   fd.m_statSTF.Clear();
 
-   StandardStatus callback;
-   StatusMonitor m;
-   m.SetCallback( &callback );
-   m.Initialize( "\nBlink: Calculating statistics", fd.m_image->NumberOfNominalChannels() );
-   ProcessEvents();
+   blink_image decimated;
+   bool isDecimated = image.NumberOfPixels() > g_maxStatisticsPixels;
+   if ( isDecimated )
+      DecimateImage( decimated, image, g_maxStatisticsPixels );
+   const blink_image& source = isDecimated ? decimated : image;
 
-   for( int c = 0; c < fd.m_image->NumberOfNominalChannels(); c++, ++m )
+   for ( int c = 0; c < source.NumberOfNominalChannels(); ++c )
    {
-      fd.m_image->SelectChannel( c );
+      source.SelectChannel( c );
       ImageStatistics S;
       S.EnableRejection();
       S.SetRejectionLimits( 0.0, 1.0 );
       S.DisableSumOfSquares();
       S.DisableBWMV();
       S.DisablePBMV();
-      S << *fd.m_image;
+      S << source;
       fd.m_statSTF.Add( S );
    }
-   fd.m_image->ResetChannelRange();
-   fd.m_isSTFStatisticsEqualToReal = fd.m_isRealPixelData;
+   source.ResetChannelRange();
+   fd.m_isSTFStatisticsEqualToReal = fd.m_isRealPixelData && !isDecimated && image.Bounds() == m_screenRect;
 }
 
 // ----------------------------------------------------------------------------
 
-void BlinkInterface::BlinkData::AutoSTF()
+void BlinkInterface::BlinkData::GetStatsForSTF( int fileNumber )
 {
-   if ( !CheckScreen() )
-      return;
+   if ( m_filesData[fileNumber].m_statSTF.IsEmpty() )
+      GetStatsForSTF( fileNumber, Image( fileNumber ) );
+}
 
-   GetStatsForSTF();
+// ----------------------------------------------------------------------------
+
+void BlinkInterface::BlinkData::ComputeAutoStretch( DisplayFunction& DF, int fileNumber )
+{
+   GetStatsForSTF( fileNumber );
 
-   const int fileNumber = FileNumberGet( m_currentImage );
    const stats_list& S = m_filesData[fileNumber].m_statSTF;
-   int n = m_filesData[fileNumber].m_image->NumberOfNominalChannels();
-   DisplayFunction DF;
+   int n = int( S.Length() );
    DF.SetLinkedRGB( TheBlinkInterface->GUI->RGBLinked_Button.IsChecked() );
    Vector sigma( n ), center( n );
    for ( int c = 0; c < n; ++c )
@@ -348,6 +466,17 @@ void BlinkInterface::BlinkData::AutoSTF()
       center[c] = S[c].Median();
    }
    DF.ComputeAutoStretch( sigma, center );
+}
+
+// ----------------------------------------------------------------------------
+
+void BlinkInterface::BlinkData::AutoSTF()
+{
+   if ( !CheckScreen() )
+      return;
+
+   DisplayFunction DF;
+   ComputeAutoStretch( DF, FileNumberGet( m_currentImage ) );
 
    m_screen.MainView().SetScreenTransferFunctions( DF.HistogramTransformations() );
 
@@ -362,19 +491,8 @@ void BlinkInterface::AutoHTThread::Run()
 
    for ( int i = m_startIndex; i < m_endIndex; ++i )
    {
-      m_blinkData.GetStatsForSTF( i );
-      FileData& fd = m_blinkData.m_filesData[i];
-      int n = fd.m_image->NumberOfNominalChannels();
-      DisplayFunction DF;
-      DF.SetLinkedRGB( TheBlinkInterface->GUI->RGBLinked_Button.IsChecked() );
-      Vector sigma( n ), center( n );
-      for ( int c = 0; c < n; ++c )
-      {
-         sigma[c] = 1.4826*fd.m_statSTF[c].MAD();
-         center[c] = fd.m_statSTF[c].Median();
-      }
-      DF.ComputeAutoStretch( sigma, center );
-      DF >> *fd.m_image;
+      FileData& fd = m_blinkData.m_filesData[m_fileNumbers[i]];
+      fd.m_autoHT >> *fd.m_image;
 
       UPDATE_THREAD_MONITOR( 1 )
    }
@@ -385,6 +503,27 @@ void BlinkInterface::BlinkData::AutoHT()
    if ( m_filesData.IsEmpty() )
       return;
 
+   /*
+    * Images being loaded asynchronously would miss the new stretch.
+    */
+   StopPrefetching();
+
+   /*
+    * Automatic stretch functions are computed from STF statistics for all
+    * images. They are applied here to the images in the frame cache, and to
+    * the rest of images as they are loaded.
+    */
+   Array<int> fileNumbers;
+   for ( int i = 0; i < int( m_filesData.Length() ); ++i )
+   {
+      FileData& fd = m_filesData[i];
+      fd.m_autoHT = DisplayFunction();
+      ComputeAutoStretch( fd.m_autoHT, i );
+      fd.m_hasAutoHT = true;
+      if ( fd.m_image != nullptr )
+         fileNumbers << i;
+   }
+
    ProgressBarStatus status( "Blink"
 #ifdef __PCL_MACOSX
    , *TheBlinkInterface
@@ -392,13 +531,13 @@ void BlinkInterface::BlinkData::AutoHT()
    );
    StatusMonitor monitor;
    monitor.SetCallback( &status );
-   monitor.Initialize( "Applying automatic display functions...", m_filesData.Length() );
+   monitor.Initialize( "Applying automatic display functions...", fileNumbers.Length() );
 
-   AbstractImage::ThreadData data( monitor, m_filesData.Length() );
-   Array<size_type> L = Thread::OptimalThreadLoads( m_filesData.Length() );
+   AbstractImage::ThreadData data( monitor, fileNumbers.Length() );
+   Array<size_type> L = Thread::OptimalThreadLoads( fileNumbers.Length() );
    ReferenceArray<AutoHTThread> threads;
    for ( int i = 0, n = 0; i < int( L.Length() ); n += int( L[i++] ) )
-      threads.Add( new AutoHTThread( data, *this, n, n + int( L[i] ) ) );
+      threads.Add( new AutoHTThread( data, *this, fileNumbers, n, n + int( L[i] ) ) );
    try
    {
       AbstractImage::RunThreads( threads, data );
@@ -427,27 +566,351 @@ void BlinkInterface::BlinkData::AutoHT()
 
 void BlinkInterface::BlinkData::ResetHT()
 {
+   StopPrefetching();
 
-   Console console;
-   console.Show();
-   console.NoteLn( "<end><cbr><br><br>* Blink: Reloading data..." );
+   /*
+    * Stretched images are simply released from the frame cache. Original
+    * pixel data will be reloaded on demand.
+    */
+   for ( FileData& fd : m_filesData )
+   {
+      fd.m_hasAutoHT = false;
+      if ( fd.m_image != nullptr )
+         ReleaseImage( fd );
+   }
 
-   ProgressBarStatus status( "Blink"
-#ifdef __PCL_MACOSX
-   , *TheBlinkInterface
-#endif
-   );
-   StatusMonitor monitor;
-   monitor.SetCallback( &status );
-   monitor.Initialize( "Reloading data...", m_filesData.Length() );
+   DisableSTF();
+   UpdateScreen();
+}
+
+// ----------------------------------------------------------------------------
 
-   for ( int fileNumber = 0; fileNumber < int( m_filesData.Length() ); ++fileNumber, ++monitor )
-      if ( !LoadImage_P( *m_filesData[fileNumber].m_image, m_filesData[fileNumber].m_filePath ) )
+blink_image& BlinkInterface::BlinkData::Image( int fileNumber )
+{
+   CollectPrefetchedImages( fileNumber );
+
+   FileData& fd = m_filesData[fileNumber];
+   if ( fd.m_image == nullptr )
+   {
+      ++m_cacheMisses;
+      TrimCache( fd.m_bytes, fileNumber );
+      AutoPointer<blink_image> image( new blink_image );
+      if ( !LoadImage_P( *image, fd.m_filePath ) )
          throw CaughtException();
+      ReduceImage( *image, m_screenZoom );
+      if ( fd.m_hasAutoHT )
+         fd.m_autoHT >> *image;
+      fd.m_image = image.Release();
+      m_cacheSize += fd.m_bytes;
+   }
+   else
+      ++m_cacheHits;
 
-   console.Hide();
+   fd.m_lastUsed = ++m_cacheTick;
+   return *fd.m_image;
+}
+
+// ----------------------------------------------------------------------------
+
+const blink_image& BlinkInterface::BlinkData::FullResolutionImage( int fileNumber, blink_image& buffer )
+{
+   if ( m_screenZoom == 1 )
+      return Image( fileNumber );
+
+   /*
+    * Reduced screen frames are useless here. Full-resolution data are read
+    * without going through the frame cache.
+    */
+   const FileData& fd = m_filesData[fileNumber];
+   if ( !LoadImage_P( buffer, fd.m_filePath ) )
+      throw CaughtException();
+   if ( fd.m_hasAutoHT )
+      fd.m_autoHT >> buffer;
+   return buffer;
+}
+
+// ----------------------------------------------------------------------------
+
+void BlinkInterface::PrefetchThread::Run()
+{
+   for ( Item& item : m_items )
+   {
+      if ( TryIsAborted() )
+         return;
+
+      try
+      {
+         AutoPointer<blink_image> image( new blink_image );
+         if ( ReadImage_P( *image, item.filePath ) )
+         {
+            ReduceImage( *image, item.zoom, false/*parallel*/ );
+            if ( item.hasAutoHT )
+               item.autoHT >> *image;
+            item.image = image.Release();
+         }
+      }
+      catch ( ... )
+      {
+         // Failed images will be loaded synchronously, with error reporting.
+      }
+   }
+}
+
+// ----------------------------------------------------------------------------
+
+void BlinkInterface::BlinkData::Prefetch()
+{
+   if ( m_filesData.Length() < 2 )
+      return;
+
+   CollectPrefetchedImages();
+   if ( m_prefetchThread )
+      return; // still busy
+
+   /*
+    * Gather the next images to be shown in blinking order, including the
+    * blink master, up to half the frame cache capacity. Images already in the
+    * cache are touched to protect them from eviction.
+    */
+   const TreeBox& tree = TheBlinkInterface->GUI->Files_TreeBox;
+   const int numberOfRows = tree.NumberOfChildren();
+   const int currentFileNumber = FileNumberGet( m_currentImage );
+   size_type budget = CacheCapacity()/2;
+   size_type bytes = 0;
+
+   Array<int> rows;
+   if ( m_isBlinkMaster && m_blinkMaster != m_currentImage )
+      rows << m_blinkMaster;
+   for ( int i = 1, n = 0; i < numberOfRows && n < g_prefetchDepth; ++i )
+   {
+      int row = (m_currentImage + i) % numberOfRows;
+      if ( m_isBlinkMaster && row == m_blinkMaster )
+         continue;
+      if ( tree.Child( row )->IsChecked() )
+         rows << row, ++n;
+   }
+
+   PrefetchThread::item_list items;
+   for ( int row : rows )
+   {
+      int fileNumber = FileNumberGet( row );
+      if ( fileNumber == currentFileNumber )
+         continue;
+      FileData& fd = m_filesData[fileNumber];
+      if ( bytes + fd.m_bytes > budget )
+         break;
+      bytes += fd.m_bytes;
+      if ( fd.m_image != nullptr )
+         fd.m_lastUsed = ++m_cacheTick;
+      else
+      {
+         PrefetchThread::Item item;
+         item.id = fd.m_id;
+         item.filePath = fd.m_filePath;
+         item.autoHT = fd.m_autoHT;
+         item.hasAutoHT = fd.m_hasAutoHT;
+         item.zoom = m_screenZoom;
+         items << item;
+      }
+   }
+
+   if ( !items.IsEmpty() )
+   {
+      m_prefetchThread = new PrefetchThread( items );
+      m_prefetchThread->Start( ThreadPriority::Low );
+   }
+}
+
+// ----------------------------------------------------------------------------
+
+void BlinkInterface::BlinkData::CollectPrefetchedImages( int fileNumber )
+{
+   if ( !m_prefetchThread )
+      return;
+
+   if ( m_prefetchThread->IsActive() )
+   {
+      /*
+       * Wait only if the required image is being loaded, to avoid reading
+       * the same file twice.
+       */
+      if ( fileNumber < 0 || !m_prefetchThread->Contains( m_filesData[fileNumber].m_id ) )
+         return;
+      m_prefetchThread->Wait();
+   }
+
+   const int keepFileNumber = m_filesData.IsEmpty() ? -1 : FileNumberGet( m_currentImage );
+   for ( PrefetchThread::Item& item : m_prefetchThread->Items() )
+      if ( item.image != nullptr )
+         for ( FileData& fd : m_filesData )
+            if ( fd.m_id == item.id )
+            {
+               if ( fd.m_image == nullptr )
+               {
+                  TrimCache( fd.m_bytes, keepFileNumber );
+                  if ( m_cacheSize + fd.m_bytes <= CacheCapacity() )
+                  {
+                     fd.m_image = item.image, item.image = nullptr;
+                     fd.m_lastUsed = ++m_cacheTick;
+                     m_cacheSize += fd.m_bytes;
+                  }
+               }
+               break;
+            }
+
+   m_prefetchThread.Destroy();
+}
+
+// ----------------------------------------------------------------------------
+
+void BlinkInterface::BlinkData::StopPrefetching()
+{
+   if ( m_prefetchThread )
+   {
+      m_prefetchThread->Abort();
+      m_prefetchThread->Wait();
+      m_prefetchThread.Destroy();
+   }
+}
+
+// ----------------------------------------------------------------------------
+
+void BlinkInterface::BlinkData::TrimCache( size_type bytesRequired, int keepFileNumber )
+{
+   /*
+    * A linear search for the least recently used frame is fine here: the
+    * number of files in a blink session is small, and each eviction is
+    * negligible compared to reading an image from disk.
+    */
+   const size_type capacity = CacheCapacity();
+   while ( m_cacheSize + bytesRequired > capacity )
+   {
+      FileData* lru = nullptr;
+      for ( int i = 0; i < int( m_filesData.Length() ); ++i )
+         if ( i != keepFileNumber )
+         {
+            FileData& fd = m_filesData[i];
+            if ( fd.m_image != nullptr )
+               if ( lru == nullptr || fd.m_lastUsed < lru->m_lastUsed )
+                  lru = &fd;
+         }
+      if ( lru == nullptr )
+         break;
+      ReleaseImage( *lru );
+   }
+}
+
+// ----------------------------------------------------------------------------
+
+void BlinkInterface::BlinkData::ReleaseImage( FileData& fd )
+{
+   if ( fd.m_image != nullptr )
+   {
+      delete fd.m_image, fd.m_image = nullptr;
+      m_cacheSize -= Min( m_cacheSize, fd.m_bytes );
+   }
+}
+
+// ----------------------------------------------------------------------------
+
+void BlinkInterface::BlinkData::InitializeCache()
+{
+   m_cacheCapacity = (m_cacheLimit > 0) ? m_cacheLimit
+                                        : size_type( g_cacheMemoryFraction * Module->AvailablePhysicalMemory() );
+   if ( m_cacheCapacity == 0 )
+      m_cacheCapacity = size_type( 1024 )*1024*1024;
+   Console().WriteLn( String().Format( "<end><cbr>Blink: Frame cache size: %.0f MiB", m_cacheCapacity/1048576.0 ) );
+}
+
+// ----------------------------------------------------------------------------
+
+void BlinkInterface::BlinkData::SetCacheLimit( size_type bytes )
+{
+   m_cacheLimit = bytes;
+   m_cacheCapacity = 0;
+   if ( !m_filesData.IsEmpty() )
+   {
+      CollectPrefetchedImages();
+      InitializeCache();
+      TrimCache( 0, FileNumberGet( m_currentImage ) );
+   }
+}
+
+// ----------------------------------------------------------------------------
+
+void BlinkInterface::BlinkData::ReportCacheUsage() const
+{
+   size_type cachedFrames = 0;
+   for ( const FileData& fd : m_filesData )
+      if ( fd.m_image != nullptr )
+         ++cachedFrames;
+   size_type requests = m_cacheHits + m_cacheMisses;
+   Console().WriteLn( String().Format( "<end><cbr>Blink: Frame cache: %u of %u frames, %.0f of %.0f MiB, ",
+                                       unsigned( cachedFrames ), unsigned( m_filesData.Length() ),
+                                       m_cacheSize/1048576.0, m_cacheCapacity/1048576.0 )
+                    + String().Format( "%u hits, %u misses (%.1f%% hit rate)",
+                                       unsigned( m_cacheHits ), unsigned( m_cacheMisses ),
+                                       (requests > 0) ? 100.0*m_cacheHits/requests : 0.0 ) );
+}
+
+// ----------------------------------------------------------------------------
+
+int BlinkInterface::BlinkData::ComputeScreenZoom() const
+{
+   if ( m_screenSizeLimit <= 0 )
+      return 1;
+   return Max( 1, TruncInt( Ceil( double( Max( m_info.width, m_info.height ) )/m_screenSizeLimit ) ) );
+}
+
+// ----------------------------------------------------------------------------
+
+Rect BlinkInterface::BlinkData::ScreenToImage( const Rect& r ) const
+{
+   if ( m_screenZoom == 1 )
+      return r;
+
+   /*
+    * Integer reduction truncates the rightmost columns and bottom rows of
+    * the image. Edges lying on the BlinkScreen border are extended to the
+    * image border.
+    */
+   Rect q = r*m_screenZoom;
+   if ( r.x1 == ScreenWidth() )
+      q.x1 = m_screenRect.x1;
+   if ( r.y1 == ScreenHeight() )
+      q.y1 = m_screenRect.y1;
+   return q;
+}
+
+// ----------------------------------------------------------------------------
+
+void BlinkInterface::BlinkData::SetScreenSizeLimit( int limit )
+{
+   m_screenSizeLimit = Max( 0, limit );
+   if ( m_filesData.IsEmpty() )
+      return; // the reduction factor is computed for the first image added
+
+   int zoom = ComputeScreenZoom();
+   if ( zoom == m_screenZoom )
+      return;
+
+   /*
+    * All cached frames have the wrong size now. BlinkScreen is recreated
+    * with the new geometry; its previews are lost.
+    */
+   StopPrefetching();
+   for ( FileData& fd : m_filesData )
+      ReleaseImage( fd );
+   m_screenZoom = zoom;
+   for ( FileData& fd : m_filesData )
+      fd.m_bytes = FrameBytes();
+
+   if ( !m_screen.IsNull() )
+   {
+      m_screen.ForceClose();
+      m_screen = ImageWindow::Null();
+   }
 
-   DisableSTF();
    UpdateScreen();
 }
 
@@ -505,6 +968,7 @@ bool BlinkInterface::BlinkData::CheckGeomery( const ImageDescription& descriptio
       m_statRect = m_screenRect = imageBounds;
       m_info = description.info;
       m_options = description.options;
+      m_screenZoom = ComputeScreenZoom();
    }
    else if ( imageBounds != m_screenRect )
    {
@@ -570,7 +1034,7 @@ void BlinkInterface::BlinkData::UpdateScreen( int fileNumber )
       if ( m_filesData.IsEmpty() )
          return;
 
-      m_screen = ImageWindow( m_info.width, m_info.height, m_info.numberOfChannels,
+      m_screen = ImageWindow( ScreenWidth(), ScreenHeight(), m_info.numberOfChannels,
                               m_options.bitsPerSample, m_options.ieeefpSampleFormat,
                               IsColor(), true, "BlinkScreen" );
 
@@ -581,15 +1045,15 @@ void BlinkInterface::BlinkData::UpdateScreen( int fileNumber )
       m_screen.Show();
    }
 
-   FileData& fd = m_filesData[fileNumber];
+   blink_image& image = Image( fileNumber );
    View view = m_screen.CurrentView();
    if( view.IsMainView() )
-      view.Image().CopyImage( *fd.m_image );
+      view.Image().CopyImage( image );
    else
    {
-      fd.m_image->SelectRectangle( m_screen.PreviewRect( view.Id() ) );
-      view.Image().CopyImage( *fd.m_image );
-      fd.m_image->ResetSelection();
+      image.SelectRectangle( m_screen.PreviewRect( view.Id() ) );
+      view.Image().CopyImage( image );
+      image.ResetSelection();
    }
    m_screen.Regenerate();
 }
@@ -600,6 +1064,7 @@ void BlinkInterface::BlinkData::Update( int row )
 {
    UpdateScreen( row );
    TheBlinkInterface->GUI->Files_TreeBox.SetCurrentNode( TheBlinkInterface->GUI->Files_TreeBox.Child( row ) );
+   Prefetch();
 }
 
 // ----------------------------------------------------------------------------
@@ -734,6 +1199,8 @@ void BlinkInterface::SaveSettings() const
    Settings::Write( SettingsKey() + "_Digits0_65535",     m_digits0_65535 );
    Settings::Write( SettingsKey() + "_Range0_65535",      m_range0_65535 );
    Settings::Write( SettingsKey() + "_WriteStatsFile",    m_writeStatsFile );
+   Settings::Write( SettingsKey() + "_CacheSize",         int( m_blink.m_cacheLimit >> 20 ) );
+   Settings::Write( SettingsKey() + "_ScreenSize",        m_blink.m_screenSizeLimit );
 
    // Video generation parameters are not saved automatically. They are saved
    // manually from BlinkVideoDialog.
@@ -762,6 +1229,14 @@ void BlinkInterface::LoadSettings()
    Settings::Read( SettingsKey() + "_Range0_65535",       m_range0_65535 );
    Settings::Read( SettingsKey() + "_ReadStatsFile",      m_writeStatsFile );
 
+   int cacheSizeMiB = 0;
+   Settings::Read( SettingsKey() + "_CacheSize",          cacheSizeMiB );
+   m_blink.SetCacheLimit( size_type( Max( 0, cacheSizeMiB ) ) << 20 );
+
+   int screenSize = 0;
+   Settings::Read( SettingsKey() + "_ScreenSize",         screenSize );
+   m_blink.SetScreenSizeLimit( screenSize );
+
    LoadVideoSettings();
 }
 
@@ -857,6 +1332,11 @@ void BlinkInterface::Init()
    GUI->NextImage_Button.Disable( oneOrNone );
    GUI->BlinkingDelay_ComboBox.Disable( oneOrNone );
 
+   int screenSizeItemIndex = int( LinearSearch( g_screenSizes, g_screenSizes+ItemsInArray( g_screenSizes ), m_blink.m_screenSizeLimit ) - g_screenSizes );
+   if ( screenSizeItemIndex < GUI->ScreenSize_ComboBox.NumberOfItems() )
+      GUI->ScreenSize_ComboBox.SetCurrentItem( screenSizeItemIndex );
+   GUI->CacheSize_SpinBox.SetValue( int( m_blink.m_cacheLimit >> 20 ) );
+
    GeneratePreview();
 
    GUI->CentralPanel_Control.Enable();
@@ -943,22 +1423,22 @@ void BlinkInterface::TranslucentPlanets()
 
 void BlinkInterface::Image2Preview()
 {
-   blink_image image( *m_blink.m_filesData[0].m_image );
+   /*
+    * The preview is rendered from a downsampled thumbnail, so no access to
+    * full-resolution data is necessary here.
+    */
+   const FileData& fd = m_blink.m_filesData[0];
+   blink_image image( fd.m_thumbnail );
 
    if ( GUI->AutoSTF_Button.IsChecked() )
    {
-      m_blink.GetStatsForSTF( 0 );
-      const stats_list& S = m_blink.m_filesData[0].m_statSTF;
-      int n = image.NumberOfNominalChannels();
       DisplayFunction DF;
-      DF.SetLinkedRGB( TheBlinkInterface->GUI->RGBLinked_Button.IsChecked() );
-      Vector sigma( n ), center( n );
-      for ( int c = 0; c < n; ++c )
-      {
-         sigma[c] = 1.4826*S[c].MAD();
-         center[c] = S[c].Median();
-      }
-      DF.ComputeAutoStretch( sigma, center );
+      m_blink.ComputeAutoStretch( DF, 0 );
+      DF >> image;
+   }
+   else if ( fd.m_hasAutoHT )
+   {
+      DisplayFunction DF( fd.m_autoHT );
       DF >> image;
    }
 
@@ -1201,11 +1681,11 @@ void BlinkInterface::FileMoveTo()
 Rect BlinkInterface::GetCropRect()
 {
    if ( m_blink.m_screen.SelectedPreview().IsNull() )
-      return m_blink.m_screen.ViewportToImage( m_blink.m_screen.VisibleViewportRect() );
+      return m_blink.ScreenToImage( m_blink.m_screen.ViewportToImage( m_blink.m_screen.VisibleViewportRect() ) );
    else
    {
       const Point p = m_blink.m_screen.PreviewRect( m_blink.m_screen.SelectedPreview().Id() ).LeftTop();
-      return m_blink.m_screen.SelectedPreview().Bounds().MovedTo( p );
+      return m_blink.ScreenToImage( m_blink.m_screen.SelectedPreview().Bounds().MovedTo( p ) );
    }
 }
 
@@ -1280,10 +1760,12 @@ void BlinkInterface::FileCropTo()
 
             if ( fd.m_isRealPixelData )
             {
-               fd.m_image->SelectRectangle( r );
-               if ( !outputFile.WriteImage( *fd.m_image ) )
+               blink_image buffer;
+               const blink_image& image = m_blink.FullResolutionImage( fileNumber, buffer );
+               image.SelectRectangle( r );
+               if ( !outputFile.WriteImage( image ) )
                   throw CaughtException();
-               fd.m_image->ResetSelection();
+               image.ResetSelection();
             }
             else
             {
@@ -1390,6 +1872,7 @@ void BlinkInterface::DisableButtonsIfRunning()
    GUI->FileCropTo_Button.Disable( m_isRunning );
    GUI->Statistics_button.Disable( m_isRunning );
    GUI->CropToVideo_button.Disable( m_isRunning );
+   GUI->ScreenSize_ComboBox.Disable( m_isRunning );
 }
 
 // ----------------------------------------------------------------------------
@@ -1438,6 +1921,8 @@ void BlinkInterface::Stop()
             m_blink.m_screen.MainView().Unlock();
       }
       m_isRunning = false;
+
+      m_blink.ReportCacheUsage();
    }
 
    GUI->Play_Button.SetIcon( Bitmap( ScaledResource( ":/icons/play.png" ) ) );
@@ -1603,6 +2088,22 @@ void BlinkInterface::__Delay_ItemSelected( ComboBox& /*sender*/, int itemIndex )
 
 // ----------------------------------------------------------------------------
 
+void BlinkInterface::__ScreenSize_ItemSelected( ComboBox& /*sender*/, int itemIndex )
+{
+   Stop();
+   m_blink.SetScreenSizeLimit( g_screenSizes[itemIndex] );
+   GUI->Preview_Control.Update();
+}
+
+// ----------------------------------------------------------------------------
+
+void BlinkInterface::__CacheSize_ValueUpdated( SpinBox& /*sender*/, int value )
+{
+   m_blink.SetCacheLimit( size_type( value ) << 20 );
+}
+
+// ----------------------------------------------------------------------------
+
 void BlinkInterface::__ActionButton_Click( Button& sender, bool /*checked*/ )
 {
    if ( sender == GUI->Play_Button && !m_isRunning )
@@ -1638,9 +2139,9 @@ void BlinkInterface::__Preview_Paint( Control& sender, const Rect& r )
    if ( m_blink.m_screen.CurrentView().IsPreview() )
       destRect += m_blink.m_screen.PreviewRect( m_blink.m_screen.CurrentView().Id() ).LeftTop();
 
-   double k = (m_blink.m_info.width > m_blink.m_info.height) ?
-                              double( sender.Width() )/m_blink.m_info.width :
-                              double( sender.Height() )/m_blink.m_info.height;
+   double k = (m_blink.ScreenWidth() > m_blink.ScreenHeight()) ?
+                              double( sender.Width() )/m_blink.ScreenWidth() :
+                              double( sender.Height() )/m_blink.ScreenHeight();
    g.StrokeRect( (k * destRect).RoundedToInt(),
                  m_blink.m_screen.SelectedPreview().IsNull() ? 0xFF00FF00/*green*/ : 0xFFFFFFFF/*white*/ );
 
@@ -1699,7 +2200,7 @@ void BlinkInterface::__Preview_MousePress( Control& sender, const Point& pos, in
    if ( m_blink.m_screen.IsNull() )
       return;
 
-   const double k = double( m_blink.m_info.width )/sender.Width();
+   const double k = double( m_blink.ScreenWidth() )/sender.Width();
    const Point p = m_blink.m_screen.PreviewRect( m_blink.m_screen.CurrentView().Id() ).LeftTop();
    m_blink.m_screen.SetViewport( pos.x*k - p.x, pos.y*k - p.y );
 
@@ -1715,7 +2216,7 @@ void BlinkInterface::__Preview_MouseMove( Control& sender, const Point& pos, uns
    if ( buttons != MouseButton::Left )
       return;
 
-   const double k = double( m_blink.m_info.width )/sender.Width() ;
+   const double k = double( m_blink.ScreenWidth() )/sender.Width();
    const Point p = m_blink.m_screen.PreviewRect( m_blink.m_screen.CurrentView().Id() ).LeftTop();
    m_blink.m_screen.SetViewport( pos.x*k - p.x, pos.y*k - p.y );
 
@@ -2094,6 +2595,41 @@ BlinkInterface::GUIData::GUIData( BlinkInterface& w )
 
    //
 
+   const char* screenSizeToolTip =
+   "<p>Maximum width and height of the BlinkScreen window in pixels.</p>"
+   "<p>Large images can be blinked much faster at a reduced resolution: frames are reduced by an integer "
+   "factor, stretched and kept in the frame cache, so showing a new image only involves copying a "
+   "screen-sized frame. Cropping, statistics and video generation always use full-resolution data.</p>"
+   "<p>Changing this option closes and recreates BlinkScreen; existing previews are lost.</p>";
+
+   ScreenSize_Label.SetText( "Screen:" );
+   ScreenSize_Label.SetTextAlignment( TextAlign::Right|TextAlign::VertCenter );
+   ScreenSize_Label.SetToolTip( screenSizeToolTip );
+
+   for ( int screenSize : g_screenSizes )
+      ScreenSize_ComboBox.AddItem( (screenSize > 0) ? String().Format( "%d px", screenSize ) : String( "Full resolution" ) );
+   ScreenSize_ComboBox.SetToolTip( screenSizeToolTip );
+   ScreenSize_ComboBox.OnItemSelected( (ComboBox::item_event_handler)&BlinkInterface::__ScreenSize_ItemSelected, w );
+
+   const char* cacheSizeToolTip =
+   "<p>Maximum amount of memory used to keep BlinkScreen frames in memory. Least recently used frames "
+   "are released when this limit is reached, and read again from disk when necessary.</p>"
+   "<p>Select Auto to use a fixed fraction of the available physical memory. Frame cache usage "
+   "statistics are written to the console each time the animation is stopped.</p>";
+
+   CacheSize_Label.SetText( "Cache:" );
+   CacheSize_Label.SetTextAlignment( TextAlign::Right|TextAlign::VertCenter );
+   CacheSize_Label.SetToolTip( cacheSizeToolTip );
+
+   CacheSize_SpinBox.SetRange( 0, 65536 );
+   CacheSize_SpinBox.SetStepSize( 256 );
+   CacheSize_SpinBox.SetSuffix( " MiB" );
+   CacheSize_SpinBox.SetMinimumValueText( "Auto" );
+   CacheSize_SpinBox.SetToolTip( cacheSizeToolTip );
+   CacheSize_SpinBox.OnValueUpdated( (SpinBox::value_event_handler)&BlinkInterface::__CacheSize_ValueUpdated, w );
+
+   //
+
    STF_Sizer.SetSpacing( 4 );
    STF_Sizer.Add( AutoHT_Button );
    STF_Sizer.Add( AutoSTF_Button );
@@ -2136,9 +2672,18 @@ BlinkInterface::GUIData::GUIData( BlinkInterface& w )
    FilesControl_Sizer.Add( CropToVideo_button );
    FilesControl_Sizer.AddStretch();
 
+   CacheControl_Sizer.SetSpacing( 4 );
+   CacheControl_Sizer.Add( ScreenSize_Label );
+   CacheControl_Sizer.Add( ScreenSize_ComboBox );
+   CacheControl_Sizer.AddSpacing( 8 );
+   CacheControl_Sizer.Add( CacheSize_Label );
+   CacheControl_Sizer.Add( CacheSize_SpinBox );
+   CacheControl_Sizer.AddStretch();
+
    RightPanel_Sizer.SetSpacing( 4 );
    RightPanel_Sizer.Add( Files_TreeBox, 100 );
    RightPanel_Sizer.Add( FilesControl_Sizer );
+   RightPanel_Sizer.Add( CacheControl_Sizer );
 
    RightPanel_Control.SetSizer( RightPanel_Sizer );
 
@@ -54,7 +54,9 @@
 #ifndef __BlinkInterface_h
 #define __BlinkInterface_h
 
+#include <pcl/AutoPointer.h>
 #include <pcl/ComboBox.h>
+#include <pcl/DisplayFunction.h>
 #include <pcl/FITSHeaderKeyword.h>
 #include <pcl/ICCProfile.h>
 #include <pcl/Image.h>
@@ -68,6 +70,7 @@
 #include <pcl/ProcessInterface.h>
 #include <pcl/ScrollBox.h>
 #include <pcl/Sizer.h>
+#include <pcl/SpinBox.h>
 #include <pcl/Timer.h>
 #include <pcl/ToolButton.h>
 #include <pcl/TreeBox.h>
@@ -117,7 +120,13 @@ private:
    struct FileData
    {
       String            m_filePath;          // file path of main image
-      blink_image*      m_image = nullptr;   // main image
+      blink_image*      m_image = nullptr;   // screen frame, nullptr if not in the frame cache
+      blink_image       m_thumbnail;         // downsampled image for the interface preview
+      uint32            m_id = 0;            // unique identifier, used by asynchronous loads
+      size_type         m_bytes = 0;         // size of the screen frame in bytes
+      uint64            m_lastUsed = 0;      // frame cache access tick for LRU eviction
+      DisplayFunction   m_autoHT;            // automatic histogram stretch, applied if m_hasAutoHT
+      bool              m_hasAutoHT = false;
       FileFormat*       m_format = nullptr;  // the file format of retrieved data
       const void*       m_fsData = nullptr;  // format-specific data
       ImageOptions      m_options;
@@ -131,7 +140,6 @@ private:
       bool              m_isRealPixelData = false; // PixelData in image == RealImage?
 
       FileData( FileFormatInstance&     file,
-                blink_image*            image,
                 const ImageDescription& description,
                 const String&           filePath,
                 bool                    realPixelData );
@@ -141,6 +149,59 @@ private:
 
    // -------------------------------------------------------------------------
 
+   /*
+    * Loads frames in the background, in cache order, for the frame cache.
+    */
+   class PrefetchThread : public Thread
+   {
+   public:
+
+      struct Item
+      {
+         uint32          id = 0;
+         String          filePath;
+         DisplayFunction autoHT;
+         bool            hasAutoHT = false;
+         int             zoom = 1;          // screen reduction factor
+         blink_image*    image = nullptr;   // loaded image, owned by this thread until collected
+      };
+
+      typedef Array<Item>  item_list;
+
+      PrefetchThread( const item_list& items )
+         : m_items( items )
+      {
+      }
+
+      ~PrefetchThread()
+      {
+         for ( Item& item : m_items )
+            if ( item.image != nullptr )
+               delete item.image, item.image = nullptr;
+      }
+
+      void Run() override;
+
+      bool Contains( uint32 id ) const
+      {
+         for ( const Item& item : m_items )
+            if ( item.id == id )
+               return true;
+         return false;
+      }
+
+      item_list& Items()
+      {
+         return m_items;
+      }
+
+   private:
+
+      item_list m_items;
+   };
+
+   // -------------------------------------------------------------------------
+
    struct BlinkData
    {
       BlinkData() = default;
@@ -172,6 +233,45 @@ private:
       void Prev();                        // Show Prev image on BlinkScreen
       void ShowNextImage();
 
+      blink_image& Image( int fileNumber ); // Screen frame, loaded on demand through the frame cache
+      const blink_image& FullResolutionImage( int fileNumber, blink_image& buffer ); // Load into buffer if frames are reduced
+
+      void Prefetch();                    // Load the next images to be shown asynchronously
+      void CollectPrefetchedImages( int fileNumber = -1 ); // Move loaded images to the cache; wait for fileNumber
+      void StopPrefetching();             // Abort asynchronous loading, discarding loaded images
+      void TrimCache( size_type bytesRequired, int keepFileNumber ); // Evict least recently used images
+      void ReleaseImage( FileData& );     // Remove an image from the frame cache
+      void InitializeCache();             // Compute the frame cache size limit for the current settings
+
+      size_type CacheCapacity() const     // Frame cache size limit in bytes
+      {
+         return m_cacheCapacity;
+      }
+
+      void SetCacheLimit( size_type );    // Change the frame cache size limit, zero = auto
+      void ReportCacheUsage() const;      // Write frame cache statistics to the console
+
+      void SetScreenSizeLimit( int );     // Change the maximum BlinkScreen dimension, reloading all frames
+      int ComputeScreenZoom() const;      // Reduction factor for the current image geometry and screen size limit
+      Rect ScreenToImage( const Rect& ) const; // Map BlinkScreen coordinates to image coordinates
+
+      int ScreenWidth() const             // BlinkScreen width in pixels
+      {
+         return m_info.width/m_screenZoom;
+      }
+
+      int ScreenHeight() const            // BlinkScreen height in pixels
+      {
+         return m_info.height/m_screenZoom;
+      }
+
+      size_type FrameBytes() const        // Size of a screen frame in bytes
+      {
+         return size_type( ScreenWidth() ) * size_type( ScreenHeight() ) * size_type( m_info.numberOfChannels )
+              * size_type( blink_image::BitsPerSample() >> 3 );
+      }
+
+      void GetStatsForSTF( int fileNumber, const blink_image& image ); // Calculate image statistics on decimated data
       void GetStatsForSTF( int fileNumber ); // Calculate image statistics
 
       void GetStatsForSTF()
@@ -180,6 +280,7 @@ private:
       }
 
       void AutoSTF();                     // Calculate and set auto screen stretch
+      void ComputeAutoStretch( DisplayFunction&, int fileNumber ); // Auto stretch from STF statistics
       void AutoHT();                      // Calculate and apply auto histogram stretch
       void ResetHT();                     // Recover original pixel data after AutoHT()
 
@@ -195,7 +296,7 @@ private:
 
       bool CheckGeomery( const ImageDescription& description ); // Compare size of new image with Screen size
 
-      Rect                     m_screenRect = 0;   // BlinkScreen geometry
+      Rect                     m_screenRect = 0;   // image geometry
       Rect                     m_statRect = 0;     // statReal geometry
       ReferenceArray<FileData> m_filesData;        // Path, Images, FITS keywords, ICC profile, ...
       ImageWindow              m_screen = ImageWindow::Null(); // BlinkScreen image window
@@ -204,6 +305,30 @@ private:
       int                      m_currentImage = 0; // current image index in m_filesData
       int                      m_blinkMaster = 0;  // Index of blinkMaster
       bool                     m_isBlinkMaster = false;
+
+      /*
+       * BlinkScreen frames are reduced by an integer factor so that no
+       * dimension exceeds m_screenSizeLimit pixels, or kept at full resolution
+       * if the limit is zero. Full-resolution data are only read on demand,
+       * for cropping, statistics and video generation.
+       */
+      int                      m_screenSizeLimit = 0; // maximum BlinkScreen dimension in pixels, zero = full resolution
+      int                      m_screenZoom = 1;   // BlinkScreen reduction factor
+
+      /*
+       * Frame cache: at most m_cacheLimit bytes (or an automatic fraction of
+       * the available physical memory if zero) of screen frames, already
+       * reduced and stretched, are kept in memory. Frames are released in
+       * least recently used order.
+       */
+      size_type                m_cacheLimit = 0;   // user-defined cache size limit in bytes, zero = auto
+      size_type                m_cacheCapacity = 0;// effective cache size limit in bytes
+      size_type                m_cacheSize = 0;    // bytes currently used by cached images
+      uint64                   m_cacheTick = 0;    // LRU access counter
+      size_type                m_cacheHits = 0;
+      size_type                m_cacheMisses = 0;
+      uint32                   m_nextId = 0;       // next FileData identifier
+      AutoPointer<PrefetchThread> m_prefetchThread;
    };
 
    // -------------------------------------------------------------------------
@@ -212,9 +337,10 @@ private:
    {
    public:
 
-      AutoHTThread( const AbstractImage::ThreadData& data, BlinkData& blinkData, int startIndex, int endIndex )
+      AutoHTThread( const AbstractImage::ThreadData& data, BlinkData& blinkData, const Array<int>& fileNumbers, int startIndex, int endIndex )
          : m_data( data )
          , m_blinkData( blinkData )
+         , m_fileNumbers( fileNumbers )
          , m_startIndex( startIndex )
          , m_endIndex( endIndex )
       {
@@ -226,6 +352,7 @@ private:
 
       const AbstractImage::ThreadData& m_data;
             BlinkData&                 m_blinkData;
+      const Array<int>&                m_fileNumbers;
             int                        m_startIndex;
             int                        m_endIndex;
    };
@@ -266,6 +393,11 @@ private:
             ToolButton           FileCropTo_Button;
             ToolButton           Statistics_button;
             ToolButton           CropToVideo_button;
+         HorizontalSizer      CacheControl_Sizer;
+            Label                ScreenSize_Label;
+            ComboBox             ScreenSize_ComboBox;
+            Label                CacheSize_Label;
+            SpinBox              CacheSize_SpinBox;
 
       Timer UpdateAnimation_Timer;
       Timer UpdatePreview_Timer;
@@ -335,6 +467,8 @@ private:
    void __Files_NodeDoubleClicked( TreeBox&, TreeBox::Node&, int );
    void __FileButton_Click( Button&, bool );
    void __Delay_ItemSelected( ComboBox&, int );
+   void __ScreenSize_ItemSelected( ComboBox&, int );
+   void __CacheSize_ValueUpdated( SpinBox&, int );
    void __ActionButton_Click( Button&, bool );
    void __Preview_Paint( Control&, const Rect& );
    void __Preview_MouseWheel( Control&, const Point&, int, unsigned, unsigned );
@@ -470,9 +470,9 @@ void BlinkStatisticsDialog::PrepareData()
    if ( !blink.m_screen.IsNull() && StatCropMode_CheckBox.IsChecked() )  // set m_rect to CurrentView Rectangle
    {
       if ( blink.m_screen.SelectedPreview().IsNull() )
-         m_rect = blink.m_screen.ViewportToImage( blink.m_screen.VisibleViewportRect() ).RoundedToInt();
+         m_rect = blink.ScreenToImage( blink.m_screen.ViewportToImage( blink.m_screen.VisibleViewportRect() ).RoundedToInt() );
       else
-         m_rect = blink.m_screen.PreviewRect( blink.m_screen.SelectedPreview().Id() );
+         m_rect = blink.ScreenToImage( blink.m_screen.PreviewRect( blink.m_screen.SelectedPreview().Id() ) );
    }
    else
       m_rect = blink.m_screenRect;      // set m_rect full size
@@ -508,7 +508,8 @@ void BlinkStatisticsDialog::PrepareData()
       {
          Console().WriteLn( "<br>Use Image in memory: " + fd.m_filePath );
          ProcessEvents();
-         img.Assign( *fd.m_image );                         // Convert & Copy blink_image to DImage
+         blink_image buffer;
+         img.Assign( blink.FullResolutionImage( fileNumber, buffer ) ); // Convert & Copy blink_image to DImage
       }
       else                                                  // load Real Image from file
       {
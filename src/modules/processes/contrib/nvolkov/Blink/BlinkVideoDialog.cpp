@@ -180,7 +180,8 @@ void BlinkVideoDialog::CreateFrames()
       if ( !outputFile.Create( i->filePath ) )
          throw CaughtException();
 
-      blink_image image( *m_parent->m_blink.m_filesData[i->fileNumber].m_image ); // create temp image
+      blink_image buffer;
+      blink_image image( m_parent->m_blink.FullResolutionImage( i->fileNumber, buffer ) ); // create temp image
       image.SelectRectangle( r ); // crop it
       if ( isSTF ) //if STF enabled apply HT to all channels
       {
@@ -51,6 +51,7 @@
 // ----------------------------------------------------------------------------
 
 #include "DebayerInstance.h"
+#include "DebayerKernels.h"
 #include "DebayerParameters.h"
 
 #include <pcl/ATrousWaveletTransform.h>
@@ -409,9 +410,8 @@ public:
             {
                ATrousWaveletTransform W( H, 1 );
                W.EnableParallelProcessing( m_numberOfSubthreads > 1, m_numberOfSubthreads );
-               W << m_image;
                size_type N;
-               noiseEstimate = W.NoiseKSigma( 0, 3, 0.01, 10, &N )/s_5x5B3Spline_kj[0];
+               noiseEstimate = W.StreamingNoiseKSigma( ImageVariant( &m_image ), 0, 3, 0.01, 10, &N )/s_5x5B3Spline_kj[0];
                noiseFraction = double( N )/m_image.NumberOfPixels();
                noiseAlgorithm = "K-Sigma";
             }
@@ -424,15 +424,14 @@ public:
                {
                   ATrousWaveletTransform W( H, n );
                   W.EnableParallelProcessing( m_numberOfSubthreads > 1, m_numberOfSubthreads );
-                  W << m_image;
 
                   size_type N;
                   if ( n == 4 )
                   {
-                     s0 = W.NoiseKSigma( 0, 3, 0.01, 10, &N )/s_5x5B3Spline_kj[0];
+                     s0 = W.StreamingNoiseKSigma( ImageVariant( &m_image ), 0, 3, 0.01, 10, &N )/s_5x5B3Spline_kj[0];
                      f0 = double( N )/m_image.NumberOfPixels();
                   }
-                  noiseEstimate = W.NoiseMRS( ImageVariant( &m_image ), s_5x5B3Spline_kj, s0, 3, &N );
+                  noiseEstimate = W.StreamingNoiseMRS( ImageVariant( &m_image ), s_5x5B3Spline_kj, s0, 3, &N );
                   noiseFraction = double( N )/m_image.NumberOfPixels();
 
                   if ( noiseEstimate > 0 && noiseFraction >= 0.01F )
@@ -548,64 +547,6 @@ struct OutputFileData
 // ----------------------------------------------------------------------------
 // ----------------------------------------------------------------------------
 
-static void BayerPatternToColorIndices( int colors[ 2 ][ 2 ], int bayerPattern )
-{
-   switch ( bayerPattern )
-   {
-   default:
-   case DebayerBayerPatternParameter::RGGB:
-      colors[0][0] = 0;
-      colors[0][1] = 1;
-      colors[1][0] = 1;
-      colors[1][1] = 2;
-      break;
-   case DebayerBayerPatternParameter::BGGR:
-      colors[0][0] = 2;
-      colors[0][1] = 1;
-      colors[1][0] = 1;
-      colors[1][1] = 0;
-      break;
-   case DebayerBayerPatternParameter::GBRG:
-      colors[0][0] = 1;
-      colors[0][1] = 2;
-      colors[1][0] = 0;
-      colors[1][1] = 1;
-      break;
-   case DebayerBayerPatternParameter::GRBG:
-      colors[0][0] = 1;
-      colors[0][1] = 0;
-      colors[1][0] = 2;
-      colors[1][1] = 1;
-      break;
-   case DebayerBayerPatternParameter::GRGB:
-      colors[0][0] = 1;
-      colors[0][1] = 0;
-      colors[1][0] = 1;
-      colors[1][1] = 2;
-      break;
-   case DebayerBayerPatternParameter::GBGR:
-      colors[0][0] = 1;
-      colors[0][1] = 2;
-      colors[1][0] = 1;
-      colors[1][1] = 0;
-      break;
-   case DebayerBayerPatternParameter::RGBG:
-      colors[0][0] = 0;
-      colors[0][1] = 1;
-      colors[1][0] = 2;
-      colors[1][1] = 1;
-      break;
-   case DebayerBayerPatternParameter::BGRG:
-      colors[0][0] = 2;
-      colors[0][1] = 1;
-      colors[1][0] = 0;
-      colors[1][1] = 1;
-      break;
-   }
-}
-
-// ----------------------------------------------------------------------------
-
 class DebayerEngine
 {
 public:
@@ -637,6 +578,55 @@ public:
       }
    }
 
+   /*
+    * Interface for incremental demosaicing. Source CFA rows are read and
+    * demosaiced rows are written by bands, so only a few rows of the source
+    * and output images have to be held in memory at any time.
+    */
+   class IncrementalIO
+   {
+   public:
+
+      /*
+       * Reads rows.Height() consecutive source rows, starting at startRow,
+       * into the specified image, which has already been allocated with the
+       * sample data type and geometry of the source image.
+       */
+      virtual void ReadRows( ImageVariant& rows, int startRow ) = 0;
+
+      /*
+       * Writes rowCount demosaiced rows of the specified image, starting at
+       * its firstRow row, as output image rows starting at startRow.
+       */
+      virtual void WriteRows( const Image& rows, int firstRow, int rowCount, int startRow ) = 0;
+   };
+
+   /*
+    * Incremental demosaicing of a source CFA image with the specified
+    * geometry and sample data format. The output image passed to the
+    * constructor is used as working space for a single band of rows.
+    */
+   void DebayerIncremental( const ImageInfo& info, const ImageOptions& options, IncrementalIO& io )
+   {
+      volatile AutoStatusCallbackRestorer saveStatus( m_output.Status() );
+      StandardStatus status;
+      m_output.SetStatusCallback( &status );
+
+      if ( options.ieeefpSampleFormat )
+         switch ( options.bitsPerSample )
+         {
+         case 32: DebayerBands<FloatPixelTraits>( info, io ); break;
+         case 64: DebayerBands<DoublePixelTraits>( info, io ); break;
+         }
+      else
+         switch ( options.bitsPerSample )
+         {
+         case  8: DebayerBands<UInt8PixelTraits>( info, io ); break;
+         case 16: DebayerBands<UInt16PixelTraits>( info, io ); break;
+         case 32: DebayerBands<UInt32PixelTraits>( info, io ); break;
+         }
+   }
+
    static IsoString MethodId( pcl_enum debayerMethod )
    {
       switch( debayerMethod )
@@ -706,7 +696,6 @@ private:
 #define m_bayerPattern this->m_bayerPattern
 #define m_start        this->m_start
 #define m_end          this->m_end
-#define SRC_CHANNEL(c) (m_source.IsColor() ? c : 0)
 
    // -------------------------------------------------------------------------
 
@@ -725,110 +714,11 @@ private:
       {
          INIT_THREAD_MONITOR()
 
-         const int src_w2 = m_source.Width() >> 1;
+         SuperPixelKernel<P> kernel( m_source, m_bayerPattern );
 
          for ( int row = m_start; row < m_end; row++ )
          {
-            for ( int col = 0; col < src_w2; col++ )
-            {
-               int red_col, red_row, green_col1, green_col2, green_row1, green_row2, blue_row, blue_col;
-               int col2 = col << 1;
-               int row2 = row << 1;
-               switch( m_bayerPattern )
-               {
-               default:
-               case DebayerBayerPatternParameter::RGGB:
-                  red_col    = col2;
-                  red_row    = row2;
-                  green_col1 = col2 + 1;
-                  green_row1 = row2;
-                  green_col2 = col2;
-                  green_row2 = row2 + 1;
-                  blue_col   = col2 + 1;
-                  blue_row   = row2 + 1;
-                  break;
-               case DebayerBayerPatternParameter::BGGR:
-                  red_col    = col2 + 1;
-                  red_row    = row2 + 1;
-                  green_col1 = col2 + 1;
-                  green_row1 = row2;
-                  green_col2 = col2;
-                  green_row2 = row2 + 1;
-                  blue_col   = col2;
-                  blue_row   = row2;
-                  break;
-               case DebayerBayerPatternParameter::GBRG:
-                  red_col    = col2;
-                  red_row    = row2 + 1;
-                  green_col1 = col2;
-                  green_row1 = row2;
-                  green_col2 = col2 + 1;
-                  green_row2 = row2 + 1;
-                  blue_col   = col2 + 1;
-                  blue_row   = row2;
-                  break;
-               case DebayerBayerPatternParameter::GRBG:
-                  red_col    = col2 + 1;
-                  red_row    = row2;
-                  green_col1 = col2;
-                  green_row1 = row2;
-                  green_col2 = col2 + 1;
-                  green_row2 = row2 + 1;
-                  blue_col   = col2;
-                  blue_row   = row2 + 1;
-                  break;
-               case DebayerBayerPatternParameter::GRGB:
-                  red_col    = col2 + 1;
-                  red_row    = row2;
-                  green_col1 = col2;
-                  green_row1 = row2;
-                  green_col2 = col2;
-                  green_row2 = row2 + 1;
-                  blue_col   = col2 + 1;
-                  blue_row   = row2 + 1;
-                  break;
-               case DebayerBayerPatternParameter::GBGR:
-                  red_col    = col2 + 1;
-                  red_row    = row2 + 1;
-                  green_col1 = col2;
-                  green_row1 = row2;
-                  green_col2 = col2;
-                  green_row2 = row2 + 1;
-                  blue_col   = col2 + 1;
-                  blue_row   = row2;
-                  break;
-               case DebayerBayerPatternParameter::RGBG:
-                  red_col    = col2;
-                  red_row    = row2;
-                  green_col1 = col2 + 1;
-                  green_row1 = row2;
-                  green_col2 = col2 + 1;
-                  green_row2 = row2 + 1;
-                  blue_col   = col2;
-                  blue_row   = row2 + 1;
-                  break;
-               case DebayerBayerPatternParameter::BGRG:
-                  red_col    = col2;
-                  red_row    = row2 + 1;
-                  green_col1 = col2 + 1;
-                  green_row1 = row2;
-                  green_col2 = col2 + 1;
-                  green_row2 = row2 + 1;
-                  blue_col   = col2;
-                  blue_row   = row2;
-                  break;
-               }
-
-               // red
-               P::FromSample( m_output( col, row, 0 ), m_source( red_col, red_row, SRC_CHANNEL( 0 ) ) );
-               //green
-               double v1, v2;
-               P::FromSample( v1, m_source( green_col1, green_row1, SRC_CHANNEL( 1 ) ) );
-               P::FromSample( v2, m_source( green_col2, green_row2, SRC_CHANNEL( 1 ) ) );
-               m_output( col, row, 1 ) = (v1 + v2)/2;
-               // blue
-               P::FromSample( m_output( col, row, 2 ), m_source( blue_col, blue_row, SRC_CHANNEL( 2 ) ) );
-            }
+            kernel( row, m_output.ScanLine( row, 0 ), m_output.ScanLine( row, 1 ), m_output.ScanLine( row, 2 ) );
 
             UPDATE_THREAD_MONITOR( 16 )
          }
@@ -850,71 +740,17 @@ private:
 
       void Run() override
       {
-         /*
-          * http://winfij.homeip.net/maximdl/bilineardebayer.html
-          */
-
          INIT_THREAD_MONITOR()
 
-         const int src_w = m_source.Width();
-         int colors[ 2 ][ 2 ]; // [row][col]
-         BayerPatternToColorIndices( colors, m_bayerPattern );
+         BilinearKernel<P> kernel( m_source, m_bayerPattern );
 
          for ( int row = m_start; row < m_end; ++row )
          {
-            // skip the first and last column
-            for ( int col = 1; col < src_w-1; ++col )
-            {
-               //color_index = (row % 2) + (col % 2); // modulo division
-               int current_color = colors[(row % 2)][(col % 2)];
-               int next_color = colors[(row % 2)][((col+1) % 2)];
-               double c1, c2, v1, v2, v3, v4, target_colors[ 3 ];
-               //straight copy of the current color
-               P::FromSample( target_colors[current_color], m_source( col, row, SRC_CHANNEL( current_color ) ) );
-               switch ( current_color )
-               {
-               case 0: // red done
-               case 2: // blue done
-                  // get green samples
-                  P::FromSample( v2, m_source( col, row + 1, SRC_CHANNEL( 1 ) ) );
-                  P::FromSample( v1, m_source( col, row - 1, SRC_CHANNEL( 1 ) ) );
-                  P::FromSample( v3, m_source( col - 1, row, SRC_CHANNEL( 1 ) ) );
-                  P::FromSample( v4, m_source( col + 1, row, SRC_CHANNEL( 1 ) ) );
-                  c1 = (v1 + v2 + v3 + v4)/4;
-                  target_colors[1] = c1;
-                  // get blue or red samples
-                  P::FromSample( v1, m_source( col - 1, row - 1, SRC_CHANNEL( 2-current_color ) ) );
-                  P::FromSample( v2, m_source( col + 1, row + 1, SRC_CHANNEL( 2-current_color ) ) );
-                  P::FromSample( v3, m_source( col - 1, row + 1, SRC_CHANNEL( 2-current_color ) ) );
-                  P::FromSample( v4, m_source( col + 1, row - 1, SRC_CHANNEL( 2-current_color ) ) );
-                  c1 = (v1 + v2 + v3 + v4)/4;
-                  // if the current color is red then we just grabbed blue and vise versa
-                  target_colors[2-current_color] = c1;
-                  break;
-
-               case 1: // green already done
-                  P::FromSample( v1, m_source( col, row - 1, SRC_CHANNEL( 2-next_color ) ) );
-                  P::FromSample( v2, m_source( col, row + 1, SRC_CHANNEL( 2-next_color ) ) );
-                  P::FromSample( v3, m_source( col - 1, row, SRC_CHANNEL( next_color ) ) ); // next color
-                  P::FromSample( v4, m_source( col + 1, row, SRC_CHANNEL( next_color ) ) );
-                  c1 = (v1 + v2)/2;
-                  c2 = (v3 + v4)/2;
-                  // if the current color is red then we just grabbed blue and vise versa
-                  target_colors[next_color] = c2;
-                  target_colors[2-next_color] = c1;
-                  break;
-               }
-
-               for ( int i = 0; i < 3; i++ )
-                  m_output( col, row, i ) = target_colors[i];
-            }
-
-            // get colors for the inner and outer column
+            float* out[ 3 ];
             for ( int i = 0; i < 3; i++ )
-            {
-               m_output( 0, row, i ) = m_output( 1, row, i );
-               m_output( src_w - 1, row, i ) = m_output( src_w-2, row, i );
-            }
+               out[i] = m_output.ScanLine( row, i );
+
+            kernel( row, out );
 
             UPDATE_THREAD_MONITOR( 16 )
          }
@@ -936,258 +772,20 @@ private:
 
       void Run() override
       {
-         // http://openfmi.net/plugins/scmsvn/cgi-bin/viewcvs.cgi/*checkout*/books/Chang.pdf?content-type=text%2Fplain&rev=15&root=interpol
-
          INIT_THREAD_MONITOR()
 
-         const int src_w = m_source.Width();
-         int colors[ 2 ][ 2 ]; // [row][col]
-         BayerPatternToColorIndices( colors, m_bayerPattern );
+         VNGKernel<P> kernel( m_source, m_bayerPattern );
 
          // iterate over all rows assigned to this thread
          for ( int row = m_start; row < m_end; row++ )
          {
-            // skip two first and last columns
-            for ( int col = 2; col < src_w-2; col++ )
-            {
-               // cache matrix of 5x5 pixels around current pixel
-               double v[ 25 ];     // values of 5x5 pixels of bayered image, centered on current pixel
-               int channels[ 25 ]; // channel indices for 5x5 pixels
-               if ( col == 2 )
-               {
-                  // for first column, read whole matrix
-                  for ( int y = 0; y < 5; y++ )
-                     for ( int x = 0; x < 5; x++ )
-                     {
-                        int c = col+x-2;
-                        int r = row+y-2;
-                        channels[y*5+x] = colors[r%2][c%2];
-                        P::FromSample( v[y*5+x], m_source( c, r, SRC_CHANNEL( channels[y*5+x] ) ) );
-                     }
-               }
-               else
-               {
-                  // for other columns, shift the matrix to the left and read just last column
-                  for ( int y = 0; y < 5; y++ )
-                  {
-                     for (int x = 0; x < 4; x++)
-                     {
-                        channels[y*5+x] = channels[y*5+x+1];
-                        v[y*5+x] = v[y*5+x+1];
-                     }
-                     channels[y*5+4] = colors[(row+y-2)%2][(col+2)%2];
-                     P::FromSample( v[y*5+4], m_source( col+2, row+y-2, SRC_CHANNEL( channels[y*5+4] ) ) );
-                  }
-               }
-
-               double gradients[ 8 ];     // gradients in N, E, S, W, NE, SW, NW and SE directions
-               int valid_gradients[ 8 ];  // list of gradients below computed threshold (valid for color computation)
-               int valid_gradients_count; // number of valid gradients
-               double value_sums[ 3 ];    // sums of color coefficients for all valid gradients
-
-               // get channel for actual pixel from bayer pattern
-               int current_channel = colors[row % 2][col % 2];
-
-               // compute gradients in eight directions
-               ComputeGradients( v, current_channel, gradients );
-
-               // compute threshold and list of gradients below the threshold
-               ThresholdGradients( gradients, valid_gradients, valid_gradients_count );
-
-               // compute sums of color coefficients for each of valid gradients
-               ComputeSums( v, channels, gradients, valid_gradients, valid_gradients_count, value_sums );
-
-               // current_channel hold index of the channel of current pixels
-               // get indices of two remaining channels
-               int other_channel1 = 0, other_channel2 = 0;
-               switch ( current_channel )
-               {
-               case 0:
-                  other_channel1 = 1;
-                  other_channel2 = 2;
-                  break;
-               case 1:
-                  other_channel1 = 0;
-                  other_channel2 = 2;
-                  break;
-               case 2:
-                  other_channel1 = 0;
-                  other_channel2 = 1;
-                  break;
-               }
-
-               // compute normalized color differences for remaining channels
-               double diff1 = (value_sums[other_channel1] - value_sums[current_channel])/double( valid_gradients_count );
-               double diff2 = (value_sums[other_channel2] - value_sums[current_channel])/double( valid_gradients_count );
-
-               // compute current pixel color
-               // current channel is directly known from bayered image (take the center of the cached matrix)
-               m_output( col, row, current_channel ) = v[12];
-               // two remaining channels are computed using normalized differences
-               m_output( col, row, other_channel1 ) = Range( v[12]+diff1, 0.0, 1.0 );
-               m_output( col, row, other_channel2 ) = Range( v[12]+diff2, 0.0, 1.0 );
-            }
-
-            // get colors for the inner and outer two columns
+            float* out[ 3 ];
             for ( int i = 0; i < 3; i++ )
-            {
-               m_output( 0, row, i ) = m_output( 2, row, i );
-               m_output( 1, row, i ) = m_output( 2, row, i );
-               m_output( src_w - 1, row, i ) = m_output( src_w - 3, row, i );
-               m_output( src_w - 2, row, i ) = m_output( src_w - 3, row, i );
-            }
-
-            UPDATE_THREAD_MONITOR( 16 )
-         }
-      }
-
-   private:
+               out[i] = m_output.ScanLine( row, i );
 
-      // compute gradients in eight directions around current pixel
-      void ComputeGradients( const double* v, int current_channel, double* gradients )
-      {
-         // compute gradients in eight directions
-         // formulas taken directly from VNG method paper
-         const int G_N = 0;
-         const int G_E = 1;
-         const int G_S = 2;
-         const int G_W = 3;
-         const int G_NE = 4;
-         const int G_SE = 5;
-         const int G_NW = 6;
-         const int G_SW = 7;
-
-         // compute vertical and horizontal gradients
-         gradients[G_N]  = Abs( v[7]  - v[17] )   + Abs( v[2]  - v[12] )   + Abs( v[6]  - v[16] )/2 +
-                           Abs( v[8]  - v[18] )/2 + Abs( v[1]  - v[11] )/2 + Abs( v[3]  - v[13] )/2;
-         gradients[G_E]  = Abs( v[13] - v[11] )   + Abs( v[14] - v[12] )   + Abs( v[8]  - v[6]  )/2 +
-                           Abs( v[18] - v[16] )/2 + Abs( v[9]  - v[7]  )/2 + Abs( v[19] - v[17] )/2;
-         gradients[G_S]  = Abs( v[17] - v[7]  )   + Abs( v[22] - v[12] )   + Abs( v[16] - v[6]  )/2 +
-                           Abs( v[18] - v[8]  )/2 + Abs( v[21] - v[11] )/2 + Abs( v[23] - v[13] )/2;
-         gradients[G_W]  = Abs( v[11] - v[13] )   + Abs( v[10] - v[12] )   + Abs( v[6]  - v[8]  )/2 +
-                           Abs( v[16] - v[18] )/2 + Abs( v[5]  - v[7]  )/2 + Abs( v[15] - v[17] )/2;
-
-         // diagonal gradients differ for green channel and other channels
-         switch ( current_channel )
-         {
-         // green center
-         default: // just to shut down '-Wmaybe-uninitialized' warnings
-         case 1:
-            gradients[G_NE] = Abs( v[8]  - v[16] ) + Abs( v[4]  - v[12] ) +
-                              Abs( v[3]  - v[11] ) + Abs( v[9]  - v[17] );
-            gradients[G_SE] = Abs( v[18] - v[6]  ) + Abs( v[24] - v[12] ) +
-                              Abs( v[23] - v[11] ) + Abs( v[19] - v[7]  );
-            gradients[G_NW] = Abs( v[6]  - v[18] ) + Abs( v[0]  - v[12] ) +
-                              Abs( v[1]  - v[13] ) + Abs( v[5]  - v[17] );
-            gradients[G_SW] = Abs( v[16] - v[8]  ) + Abs( v[20] - v[12] ) +
-                              Abs( v[21] - v[13] ) + Abs( v[15] - v[7]  );
-            break;
-         // red or blue center
-         case 0:
-         case 2:
-            gradients[G_NE] = Abs( v[8]  - v[16] )   + Abs( v[4]  - v[12] )   + Abs( v[7]  - v[11] )/2 +
-                              Abs( v[13] - v[17] )/2 + Abs( v[3]  - v[7]  )/2 + Abs( v[9]  - v[13] )/2;
-            gradients[G_SE] = Abs( v[18] - v[6]  )   + Abs( v[24] - v[12] )   + Abs( v[13] - v[7]  )/2 +
-                              Abs( v[17] - v[11] )/2 + Abs( v[19] - v[13] )   + Abs( v[23] - v[17] )/2;
-            gradients[G_NW] = Abs( v[6]  - v[18] )   + Abs( v[0]  - v[12] )   + Abs( v[7]  - v[13] )/2 +
-                              Abs( v[11] - v[17] )/2 + Abs( v[1]  - v[7]  )/2 + Abs( v[5]  - v[11] )/2;
-            gradients[G_SW] = Abs( v[16] - v[8]  )   + Abs( v[20] - v[12] )   + Abs( v[11] - v[7]  )/2 +
-                              Abs( v[17] - v[13] )/2 + Abs( v[15] - v[11] )   + Abs( v[21] - v[17] )/2;
-            break;
-         }
-      }
-
-      // compute threshold and list of gradients below the threshold
-      void ThresholdGradients( const double* gradients, int* valid_gradients, int& count )
-      {
-         // get minimal and maximal gradient
-         double min = gradients[0], max = gradients[0];
-         for ( int i = 1; i < 8; i++ )
-         {
-            if ( gradients[i] < min )
-               min = gradients[i];
-            if ( gradients[i] > max )
-               max = gradients[i];
-         }
-
-         // compute threshold
-         // k1 and k2 coefficient values are taken from VNG method paper (empirically found to produce best results)
-         const double k1 = 1.5;
-         const double k2 = 0.5;
-         double threshold = k1*min + k2*(max - min);
-
-         // find valid gradients (below threshold)
-         count = 0;
-         for ( int i = 0; i < 8; i++ )
-            if ( gradients[i] <= threshold+1e-10 )
-               valid_gradients[count++] = i;
-      }
-
-      // compute sums of averaged color coefficients form bayered image for each of valid gradients
-      void ComputeSums( const double* v, const int* channels,
-                        const double* gradients, const int* valid_gradients, int count,
-                        double* sums )
-      {
-         // list of indices to 5x5 matrix to compute summed colors for respective gradients
-         // for green center pixel
-         static int green_center_indices[ 8 ][ 8 ] =
-         {
-            {  1,  2,  3,  7, 11, 12, 13, -1 },
-            {  7,  9, 12, 13, 14, 17, 19, -1 },
-            { 11, 12, 13, 17, 21, 22, 23, -1 },
-            {  5,  7, 10, 11, 12, 15, 17, -1 },
-            {  3,  7,  8,  9, 13, -1, -1, -1 },
-            { 13, 17, 18, 19, 23, -1, -1, -1 },
-            {  1,  5,  6,  7, 11, -1, -1, -1 },
-            { 11, 15, 16, 17, 21, -1, -1, -1 }
-         };
-
-         // list of indices to 5x5 matrix to compute summed colors for respective gradients
-         // for red or blue center pixel
-         static int other_center_indices[ 8 ][ 8 ] =
-         {
-            {  2,  6,  7,  8, 12, -1, -1, -1 },
-            {  8, 12, 13, 14, 18, -1, -1, -1 },
-            { 12, 16, 17, 18, 22, -1, -1, -1 },
-            {  6, 10, 11, 12, 16, -1, -1, -1 },
-            {  3,  4,  7,  8,  9, 12, 13, -1 },
-            { 12, 13, 17, 18, 19, 23, 24, -1 },
-            {  0,  1,  5,  6,  7, 11, 12, -1 },
-            { 11, 12, 15, 16, 17, 20, 21, -1 }
-         };
-
-         // init sums to zero
-         for ( int channel = 0; channel < 3; channel++ )
-            sums[channel] = 0;
-
-         // for all valid gradients
-         for ( int i = 0; i < count; i++ )
-         {
-            // get index of the valid gradient
-            int grad = valid_gradients[i];
-            int j = 0;
-            // init partial sums over channels
-            double partial_sums[ 3 ] = { 0.0, 0.0, 0.0 };
-            int partial_counts[ 3 ] = { 0, 0, 0 };
-            int* indices = (channels[ 12 ] == 1) ? green_center_indices[grad] : other_center_indices[grad];
-
-            // compute partial sums for current gradient
-            while ( indices[j] >= 0 )
-            {
-               // get index to 5x5 matrix
-               int index = indices[j];
-               // get bayer channel for this index
-               int channel = channels[index];
-               // add to sum for this channel
-               partial_sums[channel] += v[index];
-               partial_counts[channel]++;
-               j++;
-            }
+            kernel( row, out );
 
-            // add averaged partial sums to total sums per each channel
-            for ( int channel = 0; channel < 3; channel++ )
-               if ( partial_counts[channel] > 0 )
-                  sums[channel] += partial_sums[channel]/double( partial_counts[channel] );
+            UPDATE_THREAD_MONITOR( 16 )
          }
       }
    }; // VNGThread
@@ -1336,6 +934,118 @@ private:
          case 32: DebayerVNG( static_cast<const UInt32Image&>( *source ) ); break;
          }
    }
+
+   // -------------------------------------------------------------------------
+
+   template <template <class> class T, class P>
+   void RunBandThreads( const GenericImage<P>& source, int start, int end )
+   {
+      if ( end <= start )
+         return;
+
+      Array<size_type> L = Thread::OptimalThreadLoads( end - start );
+      ReferenceArray<T<P> > threads;
+      AbstractImage::ThreadData data( m_output, end - start );
+      for ( int i = 0, n = 0; i < int( L.Length() ); n += int( L[i++] ) )
+         threads.Add( new T<P>( data, m_output, source, m_bayerPattern,
+                                start + n,
+                                start + n + int( L[i] ) ) );
+      AbstractImage::RunThreads( threads, data );
+      threads.Destroy();
+
+      m_output.Status() = data.status;
+   }
+
+   template <class P>
+   void DebayerBands( const ImageInfo& info, IncrementalIO& io )
+   {
+      bool superPixel = m_instance.p_debayerMethod == DebayerMethodParameter::SuperPixel;
+      int target_w = superPixel ? info.width >> 1 : info.width;
+      int target_h = superPixel ? info.height >> 1 : info.height;
+
+      /*
+       * Number of top and bottom output rows copied from the adjacent ones,
+       * and number of additional source rows required above and below a band
+       * of output rows. Bands of source rows always start at even rows to
+       * preserve the phase of the CFA pattern.
+       */
+      int border = 0, halo = 0;
+      switch ( m_instance.p_debayerMethod )
+      {
+      case DebayerMethodParameter::Bilinear:
+         border = 1;
+         halo = 2;
+         break;
+      case DebayerMethodParameter::VNG:
+         border = 2;
+         halo = 2;
+         break;
+      }
+
+      // About 4 MiB of output data per band.
+      int bandRows = Max( 16, int( (size_type( 4 ) << 20)/(3*sizeof( float )*target_w) ) ) & ~1;
+
+      m_output.Status().Initialize( String( MethodId( m_instance.p_debayerMethod ) ) + " demosaicing", target_h - 2*border );
+
+      GenericImage<P> source;
+      for ( int row = 0; row < target_h; )
+      {
+         // The last band takes all remaining rows, so it is never too small.
+         int endRow = (target_h - row < 2*bandRows) ? target_h : row + bandRows;
+
+         int startSourceRow, endSourceRow;
+         if ( superPixel )
+         {
+            startSourceRow = row << 1;
+            endSourceRow = endRow << 1;
+         }
+         else
+         {
+            startSourceRow = Max( 0, row - halo );
+            endSourceRow = Min( target_h, endRow + halo );
+         }
+
+         source.AllocateData( info.width, endSourceRow - startSourceRow, info.numberOfChannels, info.colorSpace );
+         {
+            ImageVariant rows( &source );
+            io.ReadRows( rows, startSourceRow );
+         }
+
+         if ( superPixel )
+         {
+            m_output.AllocateData( target_w, endRow - row, 3, ColorSpace::RGB );
+            RunBandThreads<SuperPixelThread>( source, 0, endRow - row );
+            io.WriteRows( m_output, 0, endRow - row, row );
+         }
+         else
+         {
+            // Rows of the source band and output band images are congruent.
+            m_output.AllocateData( target_w, endSourceRow - startSourceRow, 3, ColorSpace::RGB );
+            int start = Max( row, border ) - startSourceRow;
+            int end = Min( endRow, target_h - border ) - startSourceRow;
+            if ( m_instance.p_debayerMethod == DebayerMethodParameter::Bilinear )
+               RunBandThreads<BilinearThread>( source, start, end );
+            else
+               RunBandThreads<VNGThread>( source, start, end );
+
+            // Copy top and bottom rows from the adjacent ones.
+            if ( row == 0 )
+               for ( int r = 0; r < border; r++ )
+                  for ( int i = 0; i < 3; i++ )
+                     for ( int col = 0; col < target_w; col++ )
+                        m_output( col, r, i ) = m_output( col, border, i );
+            if ( endRow == target_h )
+               for ( int r = target_h-border; r < target_h; r++ )
+                  for ( int i = 0; i < 3; i++ )
+                     for ( int col = 0; col < target_w; col++ )
+                        m_output( col, r - startSourceRow, i ) = m_output( col, target_h-border-1 - startSourceRow, i );
+
+            io.WriteRows( m_output, row - startSourceRow, endRow - row, row );
+         }
+
+         row = endRow;
+      }
+   }
 };
 
 // ----------------------------------------------------------------------------
@@ -2460,7 +2170,7 @@ FVector XTransInterpolationEngine::m_xyzLUT;
 // ----------------------------------------------------------------------------
 // ----------------------------------------------------------------------------
 
-class DebayerFileThread : public Thread
+class DebayerFileThread : public Thread, public DebayerEngine::IncrementalIO
 {
 public:
 
@@ -2471,6 +2181,11 @@ public:
    {
    }
 
+   ~DebayerFileThread() override
+   {
+      m_outputFiles.Destroy();
+   }
+
    void Run() override
    {
       try
@@ -2480,7 +2195,12 @@ public:
          if ( !ReadInputData() )
             return;
 
-         Perform();
+         /*
+          * In incremental mode, demosaicing is performed by bands of rows
+          * while writing output data.
+          */
+         if ( !m_incremental )
+            Perform();
 
          WriteOutputData();
 
@@ -2578,6 +2298,13 @@ private:
          String           m_errorInfo;
          bool             m_success = false;
 
+   // Incremental demosaicing
+   bool                               m_incremental = false;
+   ImageInfo                          m_targetInfo;
+   AutoPointer<FileFormatInstance>    m_targetFile;     // open for incremental reads
+   ReferenceArray<FileFormatInstance> m_outputFiles;    // all output files being written
+   Array<int>                         m_outputChannels; // output channel of each file, -1 for RGB
+
    // -------------------------------------------------------------------------
 
    bool ReadInputData()
@@ -2586,7 +2313,8 @@ private:
       console.WriteLn( "<end><cbr>* Loading target file: <raw>" + m_targetFilePath + "</raw>" );
 
       FileFormat format( File::ExtractExtension( m_targetFilePath ), true/*read*/, false/*write*/ );
-      FileFormatInstance file( format );
+      m_targetFile = new FileFormatInstance( format );
+      FileFormatInstance& file = *m_targetFile;
 
       ImageDescriptionArray images;
       if ( !file.Open( images, m_targetFilePath, m_instance.p_inputHints ) )
@@ -2619,6 +2347,18 @@ private:
          console.Write( " (detected)" );
       console.WriteLn( ": " + m_patternId );
 
+      m_incremental = CanDebayerIncrementally( file );
+      if ( m_incremental )
+      {
+         /*
+          * The target file remains open for incremental reads until all
+          * output data have been written.
+          */
+         m_targetInfo = images[0].info;
+         m_fileData = OutputFileData( file, images[0].options );
+         return true;
+      }
+
       m_targetImage.CreateSharedImage( images[0].options.ieeefpSampleFormat,
                                        false/*isComplex*/,
                                        images[0].options.bitsPerSample );
@@ -2636,6 +2376,118 @@ private:
       return true;
    }
 
+   /*
+    * Demosaicing can be performed incrementally, without loading the whole
+    * target image, if the target file can be read incrementally and the
+    * output format can be written incrementally. X-Trans interpolation and
+    * signal and noise evaluation require the whole CFA image: the Markesteijn
+    * algorithm works on overlapping tiles with large borders, and the noise
+    * and signal estimators compute multiscale transforms of each entire CFA
+    * component. These tasks fall back to in-memory demosaicing.
+    */
+   bool CanDebayerIncrementally( const FileFormatInstance& file ) const
+   {
+      if ( m_xtrans )
+         return false;
+      if ( !file.Format().CanReadIncrementally() || !file.CanReadIncrementally() )
+         return false;
+      if ( !FileFormat( ".xisf", false/*read*/, true/*write*/ ).CanWriteIncrementally() )
+         return false;
+      if ( m_instance.p_evaluateNoise || m_instance.p_evaluateSignal )
+      {
+         /*
+          * This file could be demosaiced by bands of rows. Tell the user why
+          * the whole CFA image has to be loaded instead.
+          */
+         const char* why;
+         if ( m_instance.p_evaluateNoise && m_instance.p_evaluateSignal )
+            why = "signal and noise evaluation are";
+         else if ( m_instance.p_evaluateNoise )
+            why = "noise evaluation is";
+         else
+            why = "signal evaluation is";
+         Console().NoteLn( String( "* Incremental demosaicing disabled: " ) + why + " enabled." );
+         return false;
+      }
+      return true;
+   }
+
+   /*
+    * Output files written incrementally spool their uncompressed pixel data
+    * to disk instead of holding whole output images in memory.
+    */
+   String OutputHints() const
+   {
+      if ( m_incremental )
+         return m_instance.p_outputHints + " spool-image-data";
+      return m_instance.p_outputHints;
+   }
+
+   ImageInfo OutputImageInfo( int numberOfChannels ) const
+   {
+      ImageInfo info;
+      info.width = m_targetInfo.width;
+      info.height = m_targetInfo.height;
+      if ( m_instance.p_debayerMethod == DebayerMethodParameter::SuperPixel )
+      {
+         info.width >>= 1;
+         info.height >>= 1;
+      }
+      info.numberOfChannels = numberOfChannels;
+      info.colorSpace = (numberOfChannels == 1) ? ColorSpace::Gray : ColorSpace::RGB;
+      info.supported = true;
+      return info;
+   }
+
+   // -------------------------------------------------------------------------
+
+   /*
+    * N.B.: Band reads are not limited by the maximum number of file read
+    * threads. That limit serializes whole-image loads, but applying it to
+    * each band would make all worker threads queue on short reads, defeating
+    * the purpose of demosaicing more files concurrently.
+    */
+   void ReadRows( ImageVariant& rows, int startRow ) override
+   {
+      if ( rows.IsFloatSample() )
+         switch ( rows.BitsPerSample() )
+         {
+         case 32: ReadSamples( static_cast<Image&>( *rows ), startRow ); break;
+         case 64: ReadSamples( static_cast<DImage&>( *rows ), startRow ); break;
+         }
+      else
+         switch ( rows.BitsPerSample() )
+         {
+         case  8: ReadSamples( static_cast<UInt8Image&>( *rows ), startRow ); break;
+         case 16: ReadSamples( static_cast<UInt16Image&>( *rows ), startRow ); break;
+         case 32: ReadSamples( static_cast<UInt32Image&>( *rows ), startRow ); break;
+         }
+   }
+
+   template <class P>
+   void ReadSamples( GenericImage<P>& rows, int startRow )
+   {
+      for ( int c = 0; c < rows.NumberOfChannels(); ++c )
+         if ( !m_targetFile->ReadSamples( rows[c], startRow, rows.Height(), c ) )
+            throw CaughtException();
+   }
+
+   void WriteRows( const Image& rows, int firstRow, int rowCount, int startRow ) override
+   {
+      for ( size_type i = 0; i < m_outputFiles.Length(); ++i )
+         if ( m_outputChannels[i] < 0 )
+         {
+            for ( int c = 0; c < 3; ++c )
+               if ( !m_outputFiles[i].WriteSamples( rows.ScanLine( firstRow, c ), startRow, rowCount, c ) )
+                  throw CaughtException();
+         }
+         else
+         {
+            if ( !m_outputFiles[i].WriteSamples( rows.ScanLine( firstRow, m_outputChannels[i] ), startRow, rowCount, 0 ) )
+               throw CaughtException();
+         }
+   }
+
    // -------------------------------------------------------------------------
 
    void Perform()
@@ -2745,9 +2597,11 @@ private:
          else if ( checks.exists )
             console.NoteLn( "* File already exists, writing to: <raw>" + m_outputFilePath + "</raw>" );
 
-         FileFormatInstance outputFile( outputFormat );
+         m_outputFiles << new FileFormatInstance( outputFormat );
+         m_outputChannels << -1;
+         FileFormatInstance& outputFile = m_outputFiles.Last();
 
-         if ( !outputFile.Create( m_outputFilePath, m_instance.p_outputHints ) )
+         if ( !outputFile.Create( m_outputFilePath, OutputHints() ) )
             throw CaughtException();
 
          outputFile.SetOptions( options );
@@ -2848,6 +2702,12 @@ private:
 
          Module->ProcessEvents();
 
+         if ( m_incremental )
+         {
+            if ( !outputFile.CreateImage( OutputImageInfo( 3 ) ) )
+               throw CaughtException();
+         }
+         else
          {
             static Mutex mutex;
             static AtomicInt count;
@@ -2870,9 +2730,11 @@ private:
             else if ( checks.exists )
                console.NoteLn( "* File already exists, writing to: <raw>" + m_outputChannelFilePaths[i] + "</raw>" );
 
-            FileFormatInstance outputFile( outputFormat );
+            m_outputFiles << new FileFormatInstance( outputFormat );
+            m_outputChannels << i;
+            FileFormatInstance& outputFile = m_outputFiles.Last();
 
-            if ( !outputFile.Create( m_outputChannelFilePaths[i], m_instance.p_outputHints ) )
+            if ( !outputFile.Create( m_outputChannelFilePaths[i], OutputHints() ) )
                throw CaughtException();
 
             outputFile.SetOptions( options );
@@ -2965,6 +2827,12 @@ private:
 
             Module->ProcessEvents();
 
+            if ( m_incremental )
+            {
+               if ( !outputFile.CreateImage( OutputImageInfo( 1 ) ) )
+                  throw CaughtException();
+            }
+            else
             {
                static Mutex mutex;
                static AtomicInt count;
@@ -2976,6 +2844,29 @@ private:
             }
          }
 
+      if ( m_incremental )
+      {
+         /*
+          * Demosaic the target image by bands of rows, which are sent to all
+          * output files as soon as they are available.
+          */
+         DebayerEngine( m_outputImage, m_instance, m_bayerPattern ).DebayerIncremental( m_targetInfo, m_fileData.options, *this );
+
+         Module->ProcessEvents();
+
+         {
+            static Mutex mutex;
+            static AtomicInt count;
+            volatile AutoLockCounter lock( mutex, count, m_instance.m_maxFileWriteThreads );
+            for ( FileFormatInstance& outputFile : m_outputFiles )
+               if ( !outputFile.CloseImage() || !outputFile.Close() )
+                  throw CaughtException();
+         }
+
+         if ( !m_targetFile->Close() )
+            throw CaughtException();
+      }
+
       m_outputImage.FreeData();
    }
 };
@@ -3377,6 +3268,10 @@ bool DebayerInstance::ExecuteGlobal()
 
    console.EnableAbort();
    console.WriteLn( String().Format( "<end><cbr><br>Demosaicing of %u target files.", p_targets.Length() ) );
+   if ( p_evaluateNoise || p_evaluateSignal )
+      console.NoteLn( "* Signal and noise evaluation compute multiscale transforms of entire CFA components, "
+                      "so they require whole CFA images in memory. Disable both to demosaic Bayer target "
+                      "files by bands of rows." );
 
    int succeeded = 0;
    int failed = 0;
@@ -3429,11 +3324,40 @@ bool DebayerInstance::ExecuteGlobal()
             if ( !file.Open( images, p_targets[i].path, p_inputHints + " verbosity 0" ) )
                throw CaughtException();
             bool xtrans = IsXTransCFAFromTarget( file );
+            bool incremental = !images.IsEmpty() && !xtrans && !p_evaluateNoise && !p_evaluateSignal
+                            && file.Format().CanReadIncrementally() && file.CanReadIncrementally();
             if ( !file.Close() )
                throw CaughtException();
             if ( images.IsEmpty() )
                continue;
 
+            if ( incremental )
+            {
+               /*
+                * Incremental demosaicing only holds bands of about 4 MiB of
+                * output rows, plus the corresponding source rows. The last
+                * band can be up to twice as large. Uncompressed XISF output
+                * data are spooled to disk, but compressed output files hold
+                * all of their pixel data in memory until they are closed.
+                */
+               int w = images[0].info.width;
+               if ( p_debayerMethod == DebayerMethodParameter::SuperPixel )
+                  w >>= 1;
+               size_type bandRows = Max( 16, int( (size_type( 4 ) << 20)/(3*sizeof( float )*w) ) );
+               size_type bytesForBands = 2*bandRows*(size_type( w ) * 3 * sizeof( float )
+                                       + size_type( images[0].info.width ) * (images[0].options.bitsPerSample >> 3) * 2);
+               if ( p_outputHints.Contains( "compression-codec" ) || p_outputHints.Contains( "compress-data" ) )
+               {
+                  int n = (p_outputRGBImages ? 3 : 0) + (p_outputSeparateChannels ? 3 : 0);
+                  size_type bytesForOutputFiles = images[0].info.NumberOfPixels() * n * sizeof( float );
+                  if ( p_debayerMethod == DebayerMethodParameter::SuperPixel )
+                     bytesForOutputFiles >>= 2;
+                  bytesForBands += bytesForOutputFiles;
+               }
+               bytesForThreads << bytesForBands;
+               continue;
+            }
+
             size_type bytesForTargetImage = images[0].info.NumberOfSamples() * (images[0].options.bitsPerSample >> 3);
 
             if ( xtrans )
@@ -909,7 +909,10 @@ DebayerInterface::GUIData::GUIData( DebayerInterface& w )
       "grading and weighting with the SubframeSelector and ImageIntegration processes.</p>"
       "<p>The signal evaluation result will be stored as a set of custom, per-channel XISF properties and FITS header keywords that "
       "other processes and scripts can use for specialized image analysis purposes.</p>"
-      "<p><b>This option should always be enabled for demosaicing of deep-sky raw light frames.</b></p>" );
+      "<p><b>This option should always be enabled for demosaicing of deep-sky raw light frames.</b></p>"
+      "<p>Signal evaluation requires the whole CFA image in memory. When this option is disabled, along with noise evaluation, "
+      "Bayer target files that can be read incrementally are demosaiced by bands of rows with much smaller memory requirements, "
+      "which allows more files to be processed concurrently.</p>" );
    SignalEvaluation_SectionBar.SetSection( SignalEvaluation_Control );
    SignalEvaluation_SectionBar.EnableTitleCheckBox();
    SignalEvaluation_SectionBar.OnToggleSection( (SectionBar::section_event_handler)&DebayerInterface::e_ToggleSection, w );
@@ -1147,7 +1150,10 @@ DebayerInterface::GUIData::GUIData( DebayerInterface& w )
       "<p>These estimates can be used later by several processes and scripts for specialized image analysis purposes, "
       "most notably by SubframeSelector and ImageIntegration for image grading and weighting. Noise estimates will "
       "always be computed from uninterpolated, raw calibrated data.</p>"
-      "<p><b>This option should always be enabled under normal working conditions.</b></p>" );
+      "<p><b>This option should always be enabled under normal working conditions.</b></p>"
+      "<p>Noise evaluation requires the whole CFA image in memory. When this option is disabled, along with signal evaluation, "
+      "Bayer target files that can be read incrementally are demosaiced by bands of rows with much smaller memory requirements, "
+      "which allows more files to be processed concurrently.</p>" );
    NoiseEvaluation_SectionBar.SetSection( NoiseEvaluation_Control );
    NoiseEvaluation_SectionBar.EnableTitleCheckBox();
    NoiseEvaluation_SectionBar.OnToggleSection( (SectionBar::section_event_handler)&DebayerInterface::e_ToggleSection, w );
@@ -0,0 +1,728 @@
+//     ____   ______ __
+//    / __ \ / ____// /
+//   / /_/ // /    / /
+//  / ____// /___ / /___   PixInsight Class Library
+// /_/     \____//_____/   PCL 2.8.5
+// ----------------------------------------------------------------------------
+// Standard Debayer Process Module Version 1.12.0
+// ----------------------------------------------------------------------------
+// DebayerKernels.h - Released 2024-12-28T16:54:15Z
+// ----------------------------------------------------------------------------
+// This file is part of the standard Debayer PixInsight module.
+//
+// Copyright (c) 2003-2024 Pleiades Astrophoto S.L. All Rights Reserved.
+//
+// Redistribution and use in both source and binary forms, with or without
+// modification, is permitted provided that the following conditions are met:
+//
+// 1. All redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//
+// 2. All redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//
+// 3. Neither the names "PixInsight" and "Pleiades Astrophoto", nor the names
+//    of their contributors, may be used to endorse or promote products derived
+//    from this software without specific prior written permission. For written
+//    permission, please contact info@pixinsight.com.
+//
+// 4. All products derived from this software, in any form whatsoever, must
+//    reproduce the following acknowledgment in the end-user documentation
+//    and/or other materials provided with the product:
+//
+//    "This product is based on software from the PixInsight project, developed
+//    by Pleiades Astrophoto and its contributors (https://pixinsight.com/)."
+//
+//    Alternatively, if that is where third-party acknowledgments normally
+//    appear, this acknowledgment must be reproduced in the product itself.
+//
+// THIS SOFTWARE IS PROVIDED BY PLEIADES ASTROPHOTO AND ITS CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED
+// TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+// PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL PLEIADES ASTROPHOTO OR ITS
+// CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, BUSINESS
+// INTERRUPTION; PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; AND LOSS OF USE,
+// DATA OR PROFITS) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+// ----------------------------------------------------------------------------
+
+#ifndef __DebayerKernels_h
+#define __DebayerKernels_h
+
+#include <pcl/Image.h>
+#include <pcl/Vector.h>
+
+#include "DebayerParameters.h"
+
+namespace pcl
+{
+
+// ----------------------------------------------------------------------------
+
+/*
+ * Row demosaicing kernels for the SuperPixel, bilinear and VNG algorithms.
+ *
+ * Source rows are converted to floating point and split into the two CFA
+ * phases of each row, so all pixels of a phase are interpolated with the
+ * same sequence of operations by unit-stride loops over whole rows. This is a
+ * memory layout change that lets the compiler vectorize the kernels for the
+ * instruction set of the module build; there is no explicit SIMD code and no
+ * runtime dispatch here.
+ *
+ * These kernels are independent of the process instance and of the thread
+ * machinery, so they can be validated against reference scalar
+ * implementations by the debayertest utility (src/utils/debayertest).
+ */
+
+// ----------------------------------------------------------------------------
+
+inline void BayerPatternToColorIndices( int colors[ 2 ][ 2 ], int bayerPattern )
+{
+   switch ( bayerPattern )
+   {
+   default:
+   case DebayerBayerPatternParameter::RGGB:
+      colors[0][0] = 0;
+      colors[0][1] = 1;
+      colors[1][0] = 1;
+      colors[1][1] = 2;
+      break;
+   case DebayerBayerPatternParameter::BGGR:
+      colors[0][0] = 2;
+      colors[0][1] = 1;
+      colors[1][0] = 1;
+      colors[1][1] = 0;
+      break;
+   case DebayerBayerPatternParameter::GBRG:
+      colors[0][0] = 1;
+      colors[0][1] = 2;
+      colors[1][0] = 0;
+      colors[1][1] = 1;
+      break;
+   case DebayerBayerPatternParameter::GRBG:
+      colors[0][0] = 1;
+      colors[0][1] = 0;
+      colors[1][0] = 2;
+      colors[1][1] = 1;
+      break;
+   case DebayerBayerPatternParameter::GRGB:
+      colors[0][0] = 1;
+      colors[0][1] = 0;
+      colors[1][0] = 1;
+      colors[1][1] = 2;
+      break;
+   case DebayerBayerPatternParameter::GBGR:
+      colors[0][0] = 1;
+      colors[0][1] = 2;
+      colors[1][0] = 1;
+      colors[1][1] = 0;
+      break;
+   case DebayerBayerPatternParameter::RGBG:
+      colors[0][0] = 0;
+      colors[0][1] = 1;
+      colors[1][0] = 2;
+      colors[1][1] = 1;
+      break;
+   case DebayerBayerPatternParameter::BGRG:
+      colors[0][0] = 2;
+      colors[0][1] = 1;
+      colors[1][0] = 0;
+      colors[1][1] = 1;
+      break;
+   }
+}
+
+// ----------------------------------------------------------------------------
+
+/*
+ * Cache of source rows converted to floating point, with the samples at
+ * even and odd columns stored in separate planes. In this way all samples
+ * of a given CFA phase on a row are contiguous, and each phase can be
+ * processed with unit-stride loops over whole rows that the compiler can
+ * vectorize.
+ */
+template <class P>
+class CFARowCache
+{
+public:
+
+   CFARowCache( const GenericImage<P>& source, int numberOfRows )
+      : m_image( source )
+      , m_numberOfChannels( source.IsColor() ? 3 : 1 )
+      , m_halfWidth( (source.Width() + 1) >> 1 )
+      , m_rows( -1, numberOfRows )
+      , m_buffer( size_type( numberOfRows )*m_numberOfChannels*2*m_halfWidth )
+   {
+   }
+
+   /*
+    * Returns the samples of the specified row and channel at the columns
+    * of the specified parity: the i-th element corresponds to the column
+    * 2*i + parity. For grayscale CFA images all channels are taken from
+    * the first channel. The returned pointer remains valid until a
+    * different row is loaded into the same cache slot.
+    */
+   const double* operator()( int row, int channel, int parity )
+   {
+      int slot = row % m_rows.Length();
+      if ( m_rows[slot] != row )
+      {
+         int w = m_image.Width();
+         for ( int c = 0; c < m_numberOfChannels; ++c )
+         {
+            const typename P::sample* __restrict__ f = m_image.PixelAddress( 0, row, c );
+            double* __restrict__ e = Plane( slot, c, 0 );
+            double* __restrict__ o = Plane( slot, c, 1 );
+            for ( int i = 0, n = w >> 1; i < n; ++i, f += 2 )
+            {
+               P::FromSample( e[i], f[0] );
+               P::FromSample( o[i], f[1] );
+            }
+            if ( w & 1 )
+               P::FromSample( e[w >> 1], *f );
+         }
+         m_rows[slot] = row;
+      }
+      return Plane( slot, channel % m_numberOfChannels, parity );
+   }
+
+private:
+
+   const GenericImage<P>& m_image;
+         int              m_numberOfChannels;
+         int              m_halfWidth;
+         IVector          m_rows;   // source row cached in each slot
+         DVector          m_buffer;
+
+   double* Plane( int slot, int channel, int parity )
+   {
+      return m_buffer.At( ((size_type( slot )*m_numberOfChannels + channel)*2 + parity)*m_halfWidth );
+   }
+};
+
+// ----------------------------------------------------------------------------
+
+/*
+ * SuperPixel kernel. Each output row is generated from two source rows; the
+ * output image has half the dimensions of the source image.
+ */
+template <class P>
+class SuperPixelKernel
+{
+public:
+
+   SuperPixelKernel( const GenericImage<P>& source, pcl_enum bayerPattern )
+      : m_rows( source, 2 )
+      , m_width( source.Width() >> 1 )
+   {
+      // Positions of red, green and blue samples in a 2x2 CFA cell.
+      switch( bayerPattern )
+      {
+      default:
+      case DebayerBayerPatternParameter::RGGB:
+         red_col    = 0;
+         red_row    = 0;
+         green_col1 = 1;
+         green_row1 = 0;
+         green_col2 = 0;
+         green_row2 = 1;
+         blue_col   = 1;
+         blue_row   = 1;
+         break;
+      case DebayerBayerPatternParameter::BGGR:
+         red_col    = 1;
+         red_row    = 1;
+         green_col1 = 1;
+         green_row1 = 0;
+         green_col2 = 0;
+         green_row2 = 1;
+         blue_col   = 0;
+         blue_row   = 0;
+         break;
+      case DebayerBayerPatternParameter::GBRG:
+         red_col    = 0;
+         red_row    = 1;
+         green_col1 = 0;
+         green_row1 = 0;
+         green_col2 = 1;
+         green_row2 = 1;
+         blue_col   = 1;
+         blue_row   = 0;
+         break;
+      case DebayerBayerPatternParameter::GRBG:
+         red_col    = 1;
+         red_row    = 0;
+         green_col1 = 0;
+         green_row1 = 0;
+         green_col2 = 1;
+         green_row2 = 1;
+         blue_col   = 0;
+         blue_row   = 1;
+         break;
+      case DebayerBayerPatternParameter::GRGB:
+         red_col    = 1;
+         red_row    = 0;
+         green_col1 = 0;
+         green_row1 = 0;
+         green_col2 = 0;
+         green_row2 = 1;
+         blue_col   = 1;
+         blue_row   = 1;
+         break;
+      case DebayerBayerPatternParameter::GBGR:
+         red_col    = 1;
+         red_row    = 1;
+         green_col1 = 0;
+         green_row1 = 0;
+         green_col2 = 0;
+         green_row2 = 1;
+         blue_col   = 1;
+         blue_row   = 0;
+         break;
+      case DebayerBayerPatternParameter::RGBG:
+         red_col    = 0;
+         red_row    = 0;
+         green_col1 = 1;
+         green_row1 = 0;
+         green_col2 = 1;
+         green_row2 = 1;
+         blue_col   = 0;
+         blue_row   = 1;
+         break;
+      case DebayerBayerPatternParameter::BGRG:
+         red_col    = 0;
+         red_row    = 1;
+         green_col1 = 1;
+         green_row1 = 0;
+         green_col2 = 1;
+         green_row2 = 1;
+         blue_col   = 0;
+         blue_row   = 0;
+         break;
+      }
+   }
+
+   /*
+    * Generates the specified output row.
+    */
+   void operator()( int row, float* __restrict__ R, float* __restrict__ G, float* __restrict__ B )
+   {
+      int row2 = row << 1;
+      const double* __restrict__ r  = m_rows( row2 + red_row,    0, red_col );
+      const double* __restrict__ g1 = m_rows( row2 + green_row1, 1, green_col1 );
+      const double* __restrict__ g2 = m_rows( row2 + green_row2, 1, green_col2 );
+      const double* __restrict__ b  = m_rows( row2 + blue_row,   2, blue_col );
+
+      for ( int col = 0; col < m_width; col++ )
+      {
+         R[col] = float( r[col] );
+         G[col] = float( (g1[col] + g2[col])/2 );
+         B[col] = float( b[col] );
+      }
+   }
+
+private:
+
+   CFARowCache<P> m_rows;
+   int            m_width;
+   int            red_col, red_row, green_col1, green_col2, green_row1, green_row2, blue_row, blue_col;
+};
+
+// ----------------------------------------------------------------------------
+
+/*
+ * Bilinear kernel.
+ *
+ * http://winfij.homeip.net/maximdl/bilineardebayer.html
+ */
+template <class P>
+class BilinearKernel
+{
+public:
+
+   BilinearKernel( const GenericImage<P>& source, pcl_enum bayerPattern )
+      : m_rows( source, 3 )
+      , m_width( source.Width() )
+   {
+      BayerPatternToColorIndices( colors, bayerPattern );
+   }
+
+   /*
+    * Generates the specified output row, including its first and last
+    * columns, which are copied from the adjacent ones. The row must be in the
+    * range [1,h-2], where h is the height of the source image.
+    */
+   void operator()( int row, float* const out[ 3 ] )
+   {
+      const int src_w = m_width;
+
+      /*
+       * Process the two CFA phases of this row separately. For a pixel
+       * of phase p at column 2*i + p, the samples at the same column
+       * are the i-th elements of the row planes of parity p, and its
+       * left and right neighbors are the (i+p-1)-th and (i+p)-th
+       * elements of the planes of parity 1-p.
+       */
+      for ( int p = 0; p < 2; ++p )
+      {
+         int current_color = colors[row % 2][p];
+         int next_color = colors[row % 2][1-p];
+
+         // skip the first and last column: 1 <= col < src_w-1
+         int i0 = 1 - p;
+         int i1 = (src_w - 2 - p)/2 + 1;
+         int q = 1 - p;
+
+         //straight copy of the current color
+         const double* __restrict__ c0 = m_rows( row, current_color, p );
+
+         switch ( current_color )
+         {
+         case 0: // red done
+         case 2: // blue done
+            {
+               // green samples
+               const double* __restrict__ n = m_rows( row - 1, 1, p );
+               const double* __restrict__ s = m_rows( row + 1, 1, p );
+               const double* __restrict__ w = m_rows( row,     1, q ) + p - 1;
+               const double* __restrict__ e = m_rows( row,     1, q ) + p;
+               // blue or red samples
+               int other_color = 2 - current_color;
+               const double* __restrict__ nw = m_rows( row - 1, other_color, q ) + p - 1;
+               const double* __restrict__ se = m_rows( row + 1, other_color, q ) + p;
+               const double* __restrict__ sw = m_rows( row + 1, other_color, q ) + p - 1;
+               const double* __restrict__ ne = m_rows( row - 1, other_color, q ) + p;
+               float* __restrict__ oc = out[current_color] + p;
+               float* __restrict__ og = out[1] + p;
+               float* __restrict__ oo = out[other_color] + p;
+               for ( int i = i0; i < i1; ++i )
+               {
+                  oc[2*i] = float( c0[i] );
+                  og[2*i] = float( (n[i] + s[i] + w[i] + e[i])/4 );
+                  oo[2*i] = float( (nw[i] + se[i] + sw[i] + ne[i])/4 );
+               }
+            }
+            break;
+
+         case 1: // green already done
+            {
+               const double* __restrict__ n = m_rows( row - 1, 2 - next_color, p );
+               const double* __restrict__ s = m_rows( row + 1, 2 - next_color, p );
+               const double* __restrict__ w = m_rows( row,     next_color, q ) + p - 1;
+               const double* __restrict__ e = m_rows( row,     next_color, q ) + p;
+               float* __restrict__ oc = out[1] + p;
+               float* __restrict__ on = out[next_color] + p;
+               float* __restrict__ oo = out[2 - next_color] + p;
+               for ( int i = i0; i < i1; ++i )
+               {
+                  oc[2*i] = float( c0[i] );
+                  on[2*i] = float( (w[i] + e[i])/2 );
+                  oo[2*i] = float( (n[i] + s[i])/2 );
+               }
+            }
+            break;
+         }
+      }
+
+      // get colors for the inner and outer column
+      for ( int i = 0; i < 3; i++ )
+      {
+         out[i][0] = out[i][1];
+         out[i][src_w - 1] = out[i][src_w - 2];
+      }
+   }
+
+private:
+
+   CFARowCache<P> m_rows;
+   int            m_width;
+   int            colors[ 2 ][ 2 ]; // [row][col]
+};
+
+// ----------------------------------------------------------------------------
+
+/*
+ * Variable Number of Gradients (VNG) kernel.
+ */
+// http://openfmi.net/plugins/scmsvn/cgi-bin/viewcvs.cgi/*checkout*/books/Chang.pdf?content-type=text%2Fplain&rev=15&root=interpol
+template <class P>
+class VNGKernel
+{
+public:
+
+   VNGKernel( const GenericImage<P>& source, pcl_enum bayerPattern )
+      : m_rows( source, 5 )
+      , m_width( source.Width() )
+      , m_averages( 8*3*BlockSize )
+      , m_zeros( 0.0, BlockSize )
+   {
+      BayerPatternToColorIndices( colors, bayerPattern );
+   }
+
+   /*
+    * Generates the specified output row, including its first and last two
+    * columns, which are copied from the adjacent ones. The row must be in the
+    * range [2,h-3], where h is the height of the source image.
+    */
+   void operator()( int row, float* const out[ 3 ] )
+   {
+      const int src_w = m_width;
+
+      /*
+       * Process the two CFA phases of this row separately. For a pixel
+       * of phase p at column 2*i + p, each element of the 5x5 matrix of
+       * bayered pixels around it is the i-th element of a row plane,
+       * conveniently offset. Since the CFA channels of the matrix are
+       * the same for all pixels of a phase, all pixels of a phase are
+       * interpolated with the same sequence of operations.
+       */
+      for ( int p = 0; p < 2; ++p )
+      {
+         const double* v[ 25 ]; // 5x5 matrix of bayered image, centered on current pixel
+         int channels[ 25 ];    // channel indices for 5x5 pixels
+         for ( int y = 0; y < 5; y++ )
+            for ( int x = 0; x < 5; x++ )
+            {
+               int k = y*5 + x;
+               channels[k] = colors[(row+y-2)%2][(p+x)%2];
+               v[k] = m_rows( row+y-2, channels[k], (p+x)%2 ) + ((p+x) >> 1) - 1;
+            }
+
+         // get channel for actual pixel from bayer pattern
+         int current_channel = channels[12];
+
+         // current_channel hold index of the channel of current pixels
+         // get indices of two remaining channels
+         int other_channel1 = 0, other_channel2 = 0;
+         switch ( current_channel )
+         {
+         case 0:
+            other_channel1 = 1;
+            other_channel2 = 2;
+            break;
+         case 1:
+            other_channel1 = 0;
+            other_channel2 = 2;
+            break;
+         case 2:
+            other_channel1 = 0;
+            other_channel2 = 1;
+            break;
+         }
+
+         // skip two first and last columns: 2 <= col < src_w-2
+         int i0 = 1;
+         int i1 = (src_w - 3 - p)/2 + 1;
+
+         for ( int b0 = i0; b0 < i1; b0 += BlockSize )
+         {
+            int n = Min( BlockSize, i1 - b0 );
+
+            const double* vb[ 25 ];
+            for ( int k = 0; k < 25; k++ )
+               vb[k] = v[k] + b0;
+
+            // averaged color coefficients for all gradients, ordered as
+            // current channel, other channel 1 and other channel 2.
+            const double* sums[ 8 ][ 3 ];
+            ComputeAverages( vb, channels, n, m_averages, m_zeros, sums );
+            for ( int g = 0; g < 8; g++ )
+            {
+               const double* s[ 3 ] = { sums[g][0], sums[g][1], sums[g][2] };
+               sums[g][0] = s[current_channel];
+               sums[g][1] = s[other_channel1];
+               sums[g][2] = s[other_channel2];
+            }
+
+            int col = 2*b0 + p;
+            if ( current_channel == 1 )
+               Interpolate<true>( vb, sums, n,
+                                  out[current_channel] + col, out[other_channel1] + col, out[other_channel2] + col );
+            else
+               Interpolate<false>( vb, sums, n,
+                                   out[current_channel] + col, out[other_channel1] + col, out[other_channel2] + col );
+         }
+      }
+
+      // get colors for the inner and outer two columns
+      for ( int i = 0; i < 3; i++ )
+      {
+         out[i][0] = out[i][1] = out[i][2];
+         out[i][src_w - 1] = out[i][src_w - 2] = out[i][src_w - 3];
+      }
+   }
+
+private:
+
+   // number of pixels of a CFA phase interpolated as a block
+   constexpr static int BlockSize = 256;
+
+   CFARowCache<P> m_rows;
+   int            m_width;
+   int            colors[ 2 ][ 2 ]; // [row][col]
+   DVector        m_averages;       // averaged color coefficients for each gradient and channel
+   DVector        m_zeros;
+
+   // compute averaged color coefficients from bayered image for each gradient and channel
+   static void ComputeAverages( const double* const* v, const int* channels, int n,
+                                DVector& averages, const DVector& zeros, const double* sums[ 8 ][ 3 ] )
+   {
+      // list of indices to 5x5 matrix to compute summed colors for respective gradients
+      // for green center pixel
+      static const int green_center_indices[ 8 ][ 8 ] =
+      {
+         {  1,  2,  3,  7, 11, 12, 13, -1 },
+         {  7,  9, 12, 13, 14, 17, 19, -1 },
+         { 11, 12, 13, 17, 21, 22, 23, -1 },
+         {  5,  7, 10, 11, 12, 15, 17, -1 },
+         {  3,  7,  8,  9, 13, -1, -1, -1 },
+         { 13, 17, 18, 19, 23, -1, -1, -1 },
+         {  1,  5,  6,  7, 11, -1, -1, -1 },
+         { 11, 15, 16, 17, 21, -1, -1, -1 }
+      };
+
+      // list of indices to 5x5 matrix to compute summed colors for respective gradients
+      // for red or blue center pixel
+      static const int other_center_indices[ 8 ][ 8 ] =
+      {
+         {  2,  6,  7,  8, 12, -1, -1, -1 },
+         {  8, 12, 13, 14, 18, -1, -1, -1 },
+         { 12, 16, 17, 18, 22, -1, -1, -1 },
+         {  6, 10, 11, 12, 16, -1, -1, -1 },
+         {  3,  4,  7,  8,  9, 12, 13, -1 },
+         { 12, 13, 17, 18, 19, 23, 24, -1 },
+         {  0,  1,  5,  6,  7, 11, 12, -1 },
+         { 11, 12, 15, 16, 17, 20, 21, -1 }
+      };
+
+      for ( int grad = 0; grad < 8; grad++ )
+      {
+         const int* indices = (channels[12] == 1) ? green_center_indices[grad] : other_center_indices[grad];
+         for ( int channel = 0; channel < 3; channel++ )
+         {
+            double* __restrict__ s = averages.At( (grad*3 + channel)*BlockSize );
+            int count = 0;
+            for ( int j = 0; indices[j] >= 0; j++ )
+               if ( channels[indices[j]] == channel )
+               {
+                  const double* __restrict__ f = v[indices[j]];
+                  if ( count++ == 0 )
+                     for ( int i = 0; i < n; i++ )
+                        s[i] = f[i];
+                  else
+                     for ( int i = 0; i < n; i++ )
+                        s[i] += f[i];
+               }
+
+            if ( count > 0 )
+            {
+               for ( int i = 0; i < n; i++ )
+                  s[i] /= double( count );
+               sums[grad][channel] = s;
+            }
+            else
+               sums[grad][channel] = zeros.Begin();
+         }
+      }
+   }
+
+   /*
+    * Interpolates a block of n pixels of a CFA phase. Output pixels are
+    * written with a stride of two samples.
+    */
+   template <bool green_center>
+   static void Interpolate( const double* const* v, const double* const sums[ 8 ][ 3 ], int n,
+                            float* __restrict__ out0, float* __restrict__ out1, float* __restrict__ out2 )
+   {
+      for ( int i = 0; i < n; i++ )
+      {
+         // compute gradients in eight directions: N, E, S, W, NE, SE, NW and SW.
+         // formulas taken directly from VNG method paper
+         double gradients[ 8 ];
+
+         // compute vertical and horizontal gradients
+         gradients[0] = Abs( v[7][i]  - v[17][i] )   + Abs( v[2][i]  - v[12][i] )   + Abs( v[6][i]  - v[16][i] )/2 +
+                        Abs( v[8][i]  - v[18][i] )/2 + Abs( v[1][i]  - v[11][i] )/2 + Abs( v[3][i]  - v[13][i] )/2;
+         gradients[1] = Abs( v[13][i] - v[11][i] )   + Abs( v[14][i] - v[12][i] )   + Abs( v[8][i]  - v[6][i]  )/2 +
+                        Abs( v[18][i] - v[16][i] )/2 + Abs( v[9][i]  - v[7][i]  )/2 + Abs( v[19][i] - v[17][i] )/2;
+         gradients[2] = Abs( v[17][i] - v[7][i]  )   + Abs( v[22][i] - v[12][i] )   + Abs( v[16][i] - v[6][i]  )/2 +
+                        Abs( v[18][i] - v[8][i]  )/2 + Abs( v[21][i] - v[11][i] )/2 + Abs( v[23][i] - v[13][i] )/2;
+         gradients[3] = Abs( v[11][i] - v[13][i] )   + Abs( v[10][i] - v[12][i] )   + Abs( v[6][i]  - v[8][i]  )/2 +
+                        Abs( v[16][i] - v[18][i] )/2 + Abs( v[5][i]  - v[7][i]  )/2 + Abs( v[15][i] - v[17][i] )/2;
+
+         // diagonal gradients differ for green channel and other channels
+         if ( green_center )
+         {
+            gradients[4] = Abs( v[8][i]  - v[16][i] ) + Abs( v[4][i]  - v[12][i] ) +
+                           Abs( v[3][i]  - v[11][i] ) + Abs( v[9][i]  - v[17][i] );
+            gradients[5] = Abs( v[18][i] - v[6][i]  ) + Abs( v[24][i] - v[12][i] ) +
+                           Abs( v[23][i] - v[11][i] ) + Abs( v[19][i] - v[7][i]  );
+            gradients[6] = Abs( v[6][i]  - v[18][i] ) + Abs( v[0][i]  - v[12][i] ) +
+                           Abs( v[1][i]  - v[13][i] ) + Abs( v[5][i]  - v[17][i] );
+            gradients[7] = Abs( v[16][i] - v[8][i]  ) + Abs( v[20][i] - v[12][i] ) +
+                           Abs( v[21][i] - v[13][i] ) + Abs( v[15][i] - v[7][i]  );
+         }
+         else
+         {
+            gradients[4] = Abs( v[8][i]  - v[16][i] )   + Abs( v[4][i]  - v[12][i] )   + Abs( v[7][i]  - v[11][i] )/2 +
+                           Abs( v[13][i] - v[17][i] )/2 + Abs( v[3][i]  - v[7][i]  )/2 + Abs( v[9][i]  - v[13][i] )/2;
+            gradients[5] = Abs( v[18][i] - v[6][i]  )   + Abs( v[24][i] - v[12][i] )   + Abs( v[13][i] - v[7][i]  )/2 +
+                           Abs( v[17][i] - v[11][i] )/2 + Abs( v[19][i] - v[13][i] )   + Abs( v[23][i] - v[17][i] )/2;
+            gradients[6] = Abs( v[6][i]  - v[18][i] )   + Abs( v[0][i]  - v[12][i] )   + Abs( v[7][i]  - v[13][i] )/2 +
+                           Abs( v[11][i] - v[17][i] )/2 + Abs( v[1][i]  - v[7][i]  )/2 + Abs( v[5][i]  - v[11][i] )/2;
+            gradients[7] = Abs( v[16][i] - v[8][i]  )   + Abs( v[20][i] - v[12][i] )   + Abs( v[11][i] - v[7][i]  )/2 +
+                           Abs( v[17][i] - v[13][i] )/2 + Abs( v[15][i] - v[11][i] )   + Abs( v[21][i] - v[17][i] )/2;
+         }
+
+         // get minimal and maximal gradient
+         double min = gradients[0], max = gradients[0];
+         for ( int g = 1; g < 8; g++ )
+         {
+            min = Min( min, gradients[g] );
+            max = Max( max, gradients[g] );
+         }
+
+         // compute threshold
+         // k1 and k2 coefficient values are taken from VNG method paper (empirically found to produce best results)
+         const double k1 = 1.5;
+         const double k2 = 0.5;
+         double threshold = k1*min + k2*(max - min) + 1e-10;
+
+         // sums of color coefficients for all valid gradients (below threshold)
+         double count = 0, sum0 = 0, sum1 = 0, sum2 = 0;
+         for ( int g = 0; g < 8; g++ )
+         {
+            bool valid = gradients[g] <= threshold;
+            count += valid ? 1.0 : 0.0;
+            sum0 += valid ? sums[g][0][i] : 0.0;
+            sum1 += valid ? sums[g][1][i] : 0.0;
+            sum2 += valid ? sums[g][2][i] : 0.0;
+         }
+
+         // compute normalized color differences for remaining channels
+         double diff1 = (sum1 - sum0)/count;
+         double diff2 = (sum2 - sum0)/count;
+
+         // compute current pixel color
+         // current channel is directly known from bayered image (take the center of the matrix)
+         double v12 = v[12][i];
+         out0[2*i] = float( v12 );
+         // two remaining channels are computed using normalized differences
+         out1[2*i] = float( Range( v12+diff1, 0.0, 1.0 ) );
+         out2[2*i] = float( Range( v12+diff2, 0.0, 1.0 ) );
+      }
+   }
+};
+
+// ----------------------------------------------------------------------------
+
+} // pcl
+
+#endif   // __DebayerKernels_h
+
+// ----------------------------------------------------------------------------
+// EOF DebayerKernels.h - Released 2024-12-28T16:54:15Z
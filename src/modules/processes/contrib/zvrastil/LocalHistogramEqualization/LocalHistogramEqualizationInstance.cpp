@@ -74,6 +74,7 @@ LocalHistogramEqualizationInstance::LocalHistogramEqualizationInstance( const Me
    , slopeLimit( TheLHESlopeLimitParameter->DefaultValue() )
    , amount( TheLHEAmountParameter->DefaultValue() )
    , circularKernel( TheLHECircularKernelParameter->DefaultValue() )
+   , tiled( TheLHETiledParameter->DefaultValue() )
 {
 }
 
@@ -97,6 +98,7 @@ void LocalHistogramEqualizationInstance::Assign( const ProcessImplementation& p
       slopeLimit = x->slopeLimit;
       amount = x->amount;
       circularKernel = x->circularKernel;
+      tiled = x->tiled;
    }
 }
 
@@ -160,6 +162,12 @@ public:
          return;
       }
 
+      if ( instance.IsTiled() )
+      {
+         ApplyTiled( image, instance );
+         return;
+      }
+
       // create copy of the luminance to evaluate histogram from
       GenericImage<P> imageCopy( image );
       imageCopy.EnsureUnique(); // really not necessary, but we'll be safer if this is done
@@ -179,6 +187,353 @@ public:
    }
 
 private:
+   // Contextual region (tile interpolated) CLAHE. The image is divided into a
+   // grid of tiles with sides approximately equal to the kernel diameter. A
+   // clipped CDF mapping is computed once for each tile, and the transformed
+   // value of each pixel is a bilinear interpolation of the mappings of the
+   // four nearest tile centers. The cost is O(pixels + tiles*bins), in
+   // contrast to O(pixels*bins) for the sliding kernel implementation.
+   template <class P>
+   static void ApplyTiled( GenericImage<P>& image, const LocalHistogramEqualizationInstance& instance )
+   {
+      int width = image.Width();
+      int height = image.Height();
+      int tileSize = 2*instance.GetRadius() - 1;
+      int histogramSize = instance.GetHistogramSize();
+
+      // Limit the total size of tile mappings to 128 MiB, which may require
+      // larger tiles for huge images with small kernels and many bins.
+      tileSize = Max( tileSize, TruncInt( Ceil( Sqrt( double( width )*height*histogramSize/(32*1024*1024) ) ) ) );
+
+      TileGrid grid;
+      grid.Initialize( grid.x, width, tileSize );
+      grid.Initialize( grid.y, height, tileSize );
+
+      int numberOfTiles = grid.x.count * grid.y.count;
+      FVector maps( numberOfTiles*histogramSize );
+
+      /*
+       * Compute the clipped CDF mappings of all tiles. Source pixels are
+       * not modified until all mappings are available, so no working copy of
+       * the image is necessary in this mode.
+       */
+      {
+         image.Status().Initialize( "CLAHE: computing contextual region mappings", numberOfTiles );
+
+         Array<size_type> L = Thread::OptimalThreadLoads( numberOfTiles );
+         AbstractImage::ThreadData data( image, numberOfTiles );
+         ReferenceArray<TileMappingThread<P>> threads;
+         for ( int i = 0, n = 0; i < int( L.Length() ); n += int( L[i++] ) )
+            threads.Add( new TileMappingThread<P>( data, instance, image, grid, maps.Begin(), n, n + int( L[i] ) ) );
+         AbstractImage::RunThreads( threads, data );
+         threads.Destroy();
+
+         image.Status() = data.status;
+      }
+
+      /*
+       * Transform all pixels by interpolation of tile mappings.
+       */
+      {
+         size_type N = image.NumberOfPixels();
+         image.Status().Initialize( "CLAHE: interpolating contextual region mappings", N );
+
+         Array<size_type> L = Thread::OptimalThreadLoads( height );
+         AbstractImage::ThreadData data( image, N );
+         ReferenceArray<TileInterpolationThread<P>> threads;
+         for ( int i = 0, n = 0; i < int( L.Length() ); n += int( L[i++] ) )
+            threads.Add( new TileInterpolationThread<P>( data, instance, image, grid, maps.Begin(), n, n + int( L[i] ) ) );
+         AbstractImage::RunThreads( threads, data );
+         threads.Destroy();
+
+         image.Status() = data.status;
+      }
+   }
+
+   // Geometry of the contextual region grid, with precomputed interpolation
+   // indices and weights for each column and row of the image.
+   struct TileGrid
+   {
+      struct Axis
+      {
+         int           count = 0; // number of tiles along this axis
+         Array<int>    start;     // first pixel coordinate of each tile, plus a sentinel
+         Array<int>    i0, i1;    // neighbor tile indices for each pixel coordinate
+         Array<float>  w1;        // interpolation weight of tile i1 for each pixel coordinate
+      };
+
+      Axis x, y;
+
+      static void Initialize( Axis& a, int size, int tileSize )
+      {
+         a.count = Max( 1, RoundInt( double( size )/tileSize ) );
+
+         a.start = Array<int>( size_type( a.count+1 ) );
+         for ( int i = 0; i <= a.count; ++i )
+            a.start[i] = int( int64( i )*size/a.count );
+
+         a.i0 = Array<int>( size_type( size ) );
+         a.i1 = Array<int>( size_type( size ) );
+         a.w1 = Array<float>( size_type( size ) );
+         for ( int p = 0, i = 0; p < size; ++p )
+         {
+            // Tile centers are at (start[i] + start[i+1] - 1)/2.
+            while ( i < a.count-1 && 2*p >= a.start[i+1] + a.start[i+2] - 1 )
+               ++i;
+            double c0 = 0.5*(a.start[i] + a.start[i+1] - 1);
+            if ( 2*p <= a.start[i] + a.start[i+1] - 1 || i == a.count-1 )
+            {
+               // Before the first center or past the last one: use a single tile.
+               a.i0[p] = a.i1[p] = i;
+               a.w1[p] = 0;
+            }
+            else
+            {
+               double c1 = 0.5*(a.start[i+1] + a.start[i+2] - 1);
+               a.i0[p] = i;
+               a.i1[p] = i+1;
+               a.w1[p] = float( (p - c0)/(c1 - c0) );
+            }
+         }
+      }
+   };
+
+   // Thread class, computes clipped CDF mappings for a range of tiles
+   template <class P>
+   class TileMappingThread : public Thread
+   {
+   public:
+
+      TileMappingThread( const AbstractImage::ThreadData& data,
+                         const LocalHistogramEqualizationInstance& instance,
+                         const GenericImage<P>& image, const TileGrid& grid,
+                         float* maps, int firstTile, int endTile )
+         : m_data( data )
+         , m_instance( instance )
+         , m_image( image )
+         , m_grid( grid )
+         , m_maps( maps )
+         , m_firstTile( firstTile )
+         , m_endTile( endTile )
+      {
+      }
+
+      void Run() override
+      {
+         INIT_THREAD_MONITOR()
+
+         uint32 histogramSize = m_instance.GetHistogramSize();
+         double factor = histogramSize - 1;
+         double limit = m_instance.GetLimit();
+
+         Array<uint32> histogram( histogramSize );
+         Array<uint32> clippedHistogram( histogramSize );
+
+         for ( int t = m_firstTile; t < m_endTile; ++t )
+         {
+            int tx = t % m_grid.x.count;
+            int ty = t / m_grid.x.count;
+            int x0 = m_grid.x.start[tx], x1 = m_grid.x.start[tx+1];
+            int y0 = m_grid.y.start[ty], y1 = m_grid.y.start[ty+1];
+
+            histogram.Fill( 0 );
+            for ( int y = y0; y < y1; ++y )
+            {
+               const typename P::sample* __restrict__ pL = m_image.PixelAddress( x0, y );
+               for ( int x = x0; x < x1; ++x, ++pL )
+               {
+                  RGBColorSystem::sample L;
+                  P::FromSample( L, *pL );
+                  histogram[Range( uint32( L * factor ), uint32( 0 ), histogramSize - 1 )]++;
+               }
+            }
+
+            ClipHistogram( clippedHistogram.Begin(), histogram.Begin(), histogramSize, uint32( (x1 - x0)*(y1 - y0) ), limit );
+            ComputeMapping( m_maps + size_type( t )*histogramSize, clippedHistogram.Begin(), histogramSize );
+
+            UPDATE_THREAD_MONITOR( 1 )
+         }
+      }
+
+   private:
+
+      const AbstractImage::ThreadData&          m_data;
+      const LocalHistogramEqualizationInstance& m_instance;
+      const GenericImage<P>&                    m_image;
+      const TileGrid&                           m_grid;
+      float*                                    m_maps;
+      int                                       m_firstTile, m_endTile;
+   };
+
+   // Thread class, transforms a range of lines by bilinear interpolation of
+   // tile mappings
+   template <class P>
+   class TileInterpolationThread : public Thread
+   {
+   public:
+
+      TileInterpolationThread( const AbstractImage::ThreadData& data,
+                               const LocalHistogramEqualizationInstance& instance,
+                               GenericImage<P>& image, const TileGrid& grid,
+                               const float* maps, int firstRow, int endRow )
+         : m_data( data )
+         , m_instance( instance )
+         , m_image( image )
+         , m_grid( grid )
+         , m_maps( maps )
+         , m_firstRow( firstRow )
+         , m_endRow( endRow )
+      {
+      }
+
+      void Run() override
+      {
+         INIT_THREAD_MONITOR()
+
+         uint32 histogramSize = m_instance.GetHistogramSize();
+         double factor = histogramSize - 1;
+         double amount = m_instance.GetAmount();
+         int width = m_image.Width();
+         int nx = m_grid.x.count;
+         size_type rowLength = width;
+
+         for ( int y = m_firstRow; y < m_endRow; ++y )
+         {
+            float wy = m_grid.y.w1[y];
+            const float* row0 = m_maps + size_type( m_grid.y.i0[y] )*nx*histogramSize;
+            const float* row1 = m_maps + size_type( m_grid.y.i1[y] )*nx*histogramSize;
+
+            typename P::sample* __restrict__ pL = m_image.ScanLine( y );
+            for ( int x = 0; x < width; ++x, ++pL )
+            {
+               RGBColorSystem::sample L;
+               P::FromSample( L, *pL );
+               uint32 value = Range( uint32( L * factor ), uint32( 0 ), histogramSize - 1 );
+
+               size_type o0 = size_type( m_grid.x.i0[x] )*histogramSize + value;
+               size_type o1 = size_type( m_grid.x.i1[x] )*histogramSize + value;
+               float wx = m_grid.x.w1[x];
+               float v0 = row0[o0] + wx*(row0[o1] - row0[o0]);
+               float v1 = row1[o0] + wx*(row1[o1] - row1[o0]);
+               RGBColorSystem::sample outL = v0 + wy*(v1 - v0);
+
+               // blend with original luminance according to Amount parameter
+               outL = amount * outL + ( 1 - amount ) * L;
+
+               *pL = P::ToSample( outL );
+            }
+
+            UPDATE_THREAD_MONITOR_CHUNK( 256*rowLength, rowLength )
+         }
+      }
+
+   private:
+
+      const AbstractImage::ThreadData&          m_data;
+      const LocalHistogramEqualizationInstance& m_instance;
+      GenericImage<P>&                          m_image;
+      const TileGrid&                           m_grid;
+      const float*                              m_maps;
+      int                                       m_firstRow, m_endRow;
+   };
+
+   // creates clipped version of the histogram
+   // the histogram is clipped to ensure maximal required slope of its cumulative distribution function
+   // it is done by clipping each value in histogram and redistributing clipped values uniformly over
+   // the histogram
+   static void ClipHistogram( uint32* clippedHistogram, const uint32* histogram, uint32 histogramSize,
+                              uint32 valuesInHistogram, double limit )
+   {
+      // copy current histogram to clipped histogram
+      memcpy( clippedHistogram, histogram, histogramSize * sizeof( uint32 ) );
+
+      int clippedValues = 0;
+      int clippedValuesBefore;
+
+      // compute maximal limit for one histogram value from required slope
+      int histLimit = (int)( limit * valuesInHistogram / ( histogramSize - 1 ) + 0.5f );
+      if ( histLimit == 0 )
+         histLimit = 1;
+
+      int iterations = 0;
+
+      // start iterative clipping
+      do
+      {
+         clippedValuesBefore = clippedValues;
+         clippedValues = 0;
+
+         // clip all values over limit, accumulate amount of clipped values
+         for ( uint32 i = 0; i < histogramSize; i++ )
+         {
+            int32 d = (int32)clippedHistogram[i] - histLimit;
+            if ( d > 0 )
+            {
+               clippedValues += d;
+               clippedHistogram[i] = histLimit;
+            }
+         }
+
+         // number of clipped values should be less then in previous iteration
+         if ( iterations == 0 || clippedValues < clippedValuesBefore )
+         {
+            // compute amount to deliver to each value and rest
+            int32 d = clippedValues / histogramSize;
+            int32 m = clippedValues % histogramSize;
+            if ( d != 0 )
+            {
+               // distribute clipped values to whole histogram
+               for ( uint32 i = 0; i < histogramSize; i++ )
+                  clippedHistogram[i] += d;
+            }
+
+            if ( m != 0 )
+            {
+               // distribute uniformly the rest
+               int s = ( histogramSize - 1 ) / m;
+               for ( uint32 i = 0; i < histogramSize; i += s )
+                  clippedHistogram[i]++;
+            }
+         }
+
+         iterations++;
+      }
+      // continue iterations as long as number of clipped values goes down
+      while ( iterations == 1 || clippedValues < clippedValuesBefore );
+   }
+
+   // tabulates the cumulative distribution function of a clipped histogram,
+   // rescaled to the [0,1] range, for all histogram values
+   static void ComputeMapping( float* map, const uint32* clippedHistogram, uint32 histogramSize )
+   {
+      // find first nonzero value in histogram and total sum of histogram
+      uint32 cdfMin = 0;
+      uint32 cdfMax = 0;
+      for ( uint32 i = 0; i < histogramSize; i++ )
+      {
+         if ( cdfMin == 0 )
+            cdfMin = clippedHistogram[i];
+         cdfMax += clippedHistogram[i];
+      }
+
+      // degenerate distribution: identity mapping
+      if ( cdfMax == cdfMin )
+      {
+         for ( uint32 i = 0; i < histogramSize; i++ )
+            map[i] = float( i )/( histogramSize - 1 );
+         return;
+      }
+
+      // values below the first nonzero histogram value map to zero
+      double scale = 1.0 / ( cdfMax - cdfMin );
+      uint32 cdf = 0;
+      for ( uint32 i = 0; i < histogramSize; i++ )
+      {
+         cdf += clippedHistogram[i];
+         map[i] = ( cdf > cdfMin ) ? float( scale * ( cdf - cdfMin ) ) : 0.0F;
+      }
+   }
+
    // Thread class, performs CLAHE on given range of lines
    template <class P>
    class LocalHistogramEqualizationThread : public Thread
@@ -469,68 +824,10 @@ private:
          }
       }
 
-      // creates clipped version of the histogram
-      // the histogram is clipped to ensure maximal required slope of its cumulative distribution function
-      // it is done by clipping each value in histogram and redistributing clipped values uniformly over
-      // the histogram
+      // creates clipped version of the histogram, see LocalHistogramEqualizationEngine::ClipHistogram()
       void ClipHistogram()
       {
-         // copy current histogram to clipped histogram
-         memcpy( clippedHistogram, histogram, histogramSize * sizeof( uint32 ) );
-
-         int clippedValues = 0;
-         int clippedValuesBefore;
-
-         // compute maximal limit for one histogram value from required slope
-         int histLimit = (int)( limit * valuesInHistogram / ( histogramSize - 1 ) + 0.5f );
-         if ( histLimit == 0 )
-            histLimit = 1;
-
-         int iterations = 0;
-
-         // start iterative clipping
-         do
-         {
-            clippedValuesBefore = clippedValues;
-            clippedValues = 0;
-
-            // clip all values over limit, accumulate amount of clipped values
-            for ( uint32 i = 0; i < histogramSize; i++ )
-            {
-               int32 d = (int32)clippedHistogram[i] - histLimit;
-               if ( d > 0 )
-               {
-                  clippedValues += d;
-                  clippedHistogram[i] = histLimit;
-               }
-            }
-
-            // number of clipped values should be less then in previous iteration
-            if ( iterations == 0 || clippedValues < clippedValuesBefore )
-            {
-               // compute amount to deliver to each value and rest
-               int32 d = clippedValues / histogramSize;
-               int32 m = clippedValues % histogramSize;
-               if ( d != 0 )
-               {
-                  // distribute clipped values to whole histogram
-                  for ( uint32 i = 0; i < histogramSize; i++ )
-                     clippedHistogram[i] += d;
-               }
-
-               if ( m != 0 )
-               {
-                  // distribute uniformly the rest
-                  int s = ( histogramSize - 1 ) / m;
-                  for ( uint32 i = 0; i < histogramSize; i += s )
-                     clippedHistogram[i]++;
-               }
-            }
-
-            iterations++;
-         }
-         // continue iterations as long as number of clipped values goes down
-         while ( iterations == 1 || clippedValues < clippedValuesBefore );
+         LocalHistogramEqualizationEngine::ClipHistogram( clippedHistogram, histogram, histogramSize, valuesInHistogram, limit );
       }
 
       // compute new lightness value from old one, using cumulative distribution function
@@ -540,27 +837,22 @@ private:
          // sample value to current histogram resolution
          uint32 value = Range( ( uint32 )( L * factor ), (uint32)0, ( uint32 )( histogramSize - 1 ) );
 
-         // find first nonzero value in histogram
+         // in a single pass over the histogram, find first nonzero value (cdfMin), compute new value
+         // (value of cumulative distribution function for the original luminance value, cdf), and
+         // compute total sum of histogram (cdfMax)
          uint32 cdfMin = 0;
+         uint32 cdf = 0;
+         uint32 cdfMax = 0;
          for ( uint32 i = 0; i < histogramSize; i++ )
          {
-            if ( clippedHistogram[i] != 0 )
-            {
-               cdfMin = clippedHistogram[i];
-               break;
-            }
+            uint32 h = clippedHistogram[i];
+            if ( cdfMin == 0 )
+               cdfMin = h;
+            cdfMax += h;
+            if ( i == value )
+               cdf = cdfMax;
          }
 
-         // compute new value (value of cumulative distribution function for the original luminance value)
-         uint32 cdf = 0;
-         for ( uint32 i = 0; i <= value; i++ )
-            cdf += clippedHistogram[i];
-
-         // compute total sum of histogram
-         uint32 cdfMax = cdf;
-         for ( uint32 i = value + 1; i < histogramSize; i++ )
-            cdfMax += clippedHistogram[i];
-
          // rescale result to range of CDF
          return ( RGBColorSystem::sample )( cdf - cdfMin ) / ( RGBColorSystem::sample )( cdfMax - cdfMin );
       }
@@ -629,6 +921,8 @@ void* LocalHistogramEqualizationInstance::LockParameter( const MetaParameter* p,
       return &slopeLimit;
    if ( p == TheLHECircularKernelParameter )
       return &circularKernel;
+   if ( p == TheLHETiledParameter )
+      return &tiled;
    if ( p == TheLHEAmountParameter )
       return &amount;
 
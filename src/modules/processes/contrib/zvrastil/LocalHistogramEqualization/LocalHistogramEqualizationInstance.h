@@ -96,6 +96,11 @@ public:
       return circularKernel;
    }
 
+   bool IsTiled() const
+   {
+      return tiled;
+   }
+
    void Preview( UInt16Image& ) const;
 
 private:
@@ -105,6 +110,7 @@ private:
    double   slopeLimit;
    double   amount;
    pcl_bool circularKernel;
+   pcl_bool tiled;
 
    friend class LocalHistogramEqualizationProcess;
    friend class LocalHistogramEqualizationInterface;
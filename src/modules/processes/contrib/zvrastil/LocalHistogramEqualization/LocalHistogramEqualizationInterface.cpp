@@ -267,6 +267,8 @@ void LocalHistogramEqualizationInterface::UpdateControls()
    GUI->SlopeLimit_NumericControl.SetValue( instance.slopeLimit );
    GUI->Amount_NumericControl.SetValue( instance.amount );
    GUI->CircularKernel_CheckBox.SetChecked( instance.circularKernel );
+   GUI->CircularKernel_CheckBox.Enable( !instance.tiled );
+   GUI->Tiled_CheckBox.SetChecked( instance.tiled );
 }
 
 // ----------------------------------------------------------------------------
@@ -300,6 +302,11 @@ void LocalHistogramEqualizationInterface::__ItemClicked( Button& sender, bool ch
 {
    if ( sender == GUI->CircularKernel_CheckBox )
       instance.circularKernel = checked;
+   if ( sender == GUI->Tiled_CheckBox )
+   {
+      instance.tiled = checked;
+      GUI->CircularKernel_CheckBox.Enable( !instance.tiled );
+   }
    UpdateRealTimePreview();
 }
 
@@ -393,11 +400,20 @@ LocalHistogramEqualizationInterface::GUIData::GUIData( LocalHistogramEqualizatio
    CircularKernel_CheckBox.SetToolTip( "<p>Use circular (instead of square) area around the pixel to evaluate histogram. Recommended.</p>" );
    CircularKernel_CheckBox.OnClick( (pcl::Button::click_event_handler)&LocalHistogramEqualizationInterface::__ItemClicked, w );
 
+   Tiled_CheckBox.SetText( "Contextual Regions" );
+   Tiled_CheckBox.SetToolTip( "<p>Compute contrast limited histogram equalization functions on a grid of contextual regions "
+                              "(square tiles with sides equal to the kernel diameter), and interpolate them bilinearly for each pixel.</p>"
+                              "<p>This mode is much faster than the default sliding kernel mode, especially for large kernel radii and "
+                              "histogram resolutions, and produces similar results. The Circular Kernel option is ignored in this mode.</p>" );
+   Tiled_CheckBox.OnClick( (pcl::Button::click_event_handler)&LocalHistogramEqualizationInterface::__ItemClicked, w );
+
    CircularKernel_Sizer.Add( HistogramBins_Label );
    CircularKernel_Sizer.AddSpacing( 4 );
    CircularKernel_Sizer.Add( HistogramBins_ComboBox );
    CircularKernel_Sizer.AddSpacing( 20 );
    CircularKernel_Sizer.Add( CircularKernel_CheckBox );
+   CircularKernel_Sizer.AddSpacing( 20 );
+   CircularKernel_Sizer.Add( Tiled_CheckBox );
    CircularKernel_Sizer.AddStretch();
 
    //
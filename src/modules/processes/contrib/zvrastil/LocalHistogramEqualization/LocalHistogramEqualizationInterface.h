@@ -130,6 +130,7 @@ private:
       NumericControl Amount_NumericControl;
       HorizontalSizer CircularKernel_Sizer;
       CheckBox CircularKernel_CheckBox;
+      CheckBox Tiled_CheckBox;
 
       Timer UpdateRealTimePreview_Timer;
    };
@@ -63,6 +63,7 @@ LHEHistogramBins*  TheLHEHistogramBinsParameter = nullptr;
 LHESlopeLimit*     TheLHESlopeLimitParameter = nullptr;
 LHEAmount*         TheLHEAmountParameter = nullptr;
 LHECircularKernel* TheLHECircularKernelParameter = nullptr;
+LHETiled*          TheLHETiledParameter = nullptr;
 
 // ----------------------------------------------------------------------------
 
@@ -222,6 +223,24 @@ bool LHECircularKernel::DefaultValue() const
 
 // ----------------------------------------------------------------------------
 
+LHETiled::LHETiled( MetaProcess* P )
+   : MetaBoolean( P )
+{
+   TheLHETiledParameter = this;
+}
+
+IsoString LHETiled::Id() const
+{
+   return "tiled";
+}
+
+bool LHETiled::DefaultValue() const
+{
+   return false;
+}
+
+// ----------------------------------------------------------------------------
+
 } // namespace pcl
 
 // ----------------------------------------------------------------------------
@@ -155,6 +155,20 @@ extern LHECircularKernel* TheLHECircularKernelParameter;
 
 // ----------------------------------------------------------------------------
 
+class LHETiled : public MetaBoolean
+{
+public:
+
+   LHETiled( MetaProcess* );
+
+   IsoString Id() const override;
+   bool DefaultValue() const override;
+};
+
+extern LHETiled* TheLHETiledParameter;
+
+// ----------------------------------------------------------------------------
+
 PCL_END_LOCAL
 
 } // namespace pcl
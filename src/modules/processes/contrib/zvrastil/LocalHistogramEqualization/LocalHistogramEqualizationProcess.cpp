@@ -79,6 +79,7 @@ LocalHistogramEqualizationProcess::LocalHistogramEqualizationProcess()
    new LHESlopeLimit( this );
    new LHEAmount( this );
    new LHECircularKernel( this );
+   new LHETiled( this );
 }
 
 // ----------------------------------------------------------------------------
@@ -60,6 +60,364 @@ namespace pcl
 
 // ----------------------------------------------------------------------------
 
+/*
+ * Streaming à trous decomposition with separable scaling functions.
+ *
+ * Rows of the input image are swept from top to bottom through a chain of
+ * ring buffers, one per scale. Each scale keeps the row-convolved rows that
+ * fall within the vertical support of its dilated filter, plus the smoothed
+ * rows still pending emission, so all wavelet layers of each row become
+ * available at once in a single pass, without storing any complete
+ * intermediate image. Results are identical to those of successive
+ * SeparableConvolution passes: same mirrored boundaries, filter phases and
+ * accumulation precision.
+ *
+ * For parallel execution the image is divided into horizontal strips. Each
+ * strip is processed by a thread with its own ring buffers, and is extended
+ * at both ends by the cumulative vertical support of the transform, which is
+ * computed redundantly in exchange for complete thread independence.
+ */
+template <class P>
+class PCL_ATWTStreamingEngine
+{
+public:
+
+   using sample = typename P::sample;
+
+   /*
+    * Receives the wavelet decomposition of each row: f is the input row,
+    * w[0..J-1] are the detail layers and w[J] is the residual layer, where J
+    * is the number of computed scales.
+    */
+   class RowSink
+   {
+   public:
+
+      virtual ~RowSink()
+      {
+      }
+
+      virtual void Initialize( int numberOfStrips )
+      {
+      }
+
+      virtual void Row( int strip, int channel, int y, const sample* f, const sample* const* w, int width ) = 0;
+   };
+
+   PCL_ATWTStreamingEngine( const SeparableFilter& filter, int numberOfScales, int delta )
+      : m_hr( filter.FilterAs( 0, (sample*)0 ) )
+      , m_hc( filter.FilterAs( 1, (sample*)0 ) )
+      , m_weight( filter.Weight() )
+      , m_numberOfScales( numberOfScales )
+      , m_d( numberOfScales )
+   {
+      for ( int j = 0; j < m_numberOfScales; ++j )
+         m_d[j] = (delta < 1) ? (1 << j) : (1 + j*delta);
+   }
+
+   static bool IsApplicable( const SeparableFilter& filter, int numberOfScales, int delta, int width, int height )
+   {
+      if ( filter.IsEmpty() || filter.IsHighPassFilter() || numberOfScales < 1 )
+         return false;
+      int n = filter.Size();
+      int j = numberOfScales - 1;
+      int d = (delta < 1) ? (1 << j) : (1 + j*delta);
+      int dn = n + (n - 1)*(d - 1);
+      return dn <= width && dn <= height;
+   }
+
+   void Run( const GenericImage<P>& image, RowSink& sink, StatusMonitor& status, size_type count,
+             bool parallel, int maxProcessors ) const
+   {
+      int halo = 0;
+      for ( int j = 0; j < m_numberOfScales; ++j )
+         halo += (m_hr.Length() >> 1)*m_d[j];
+
+      Array<size_type> L = Thread::OptimalThreadLoads( image.SelectedRectangle().Height(),
+                                                       Max( 16, halo+halo )/*overheadLimit*/,
+                                                       parallel ? maxProcessors : 1 );
+      sink.Initialize( int( L.Length() ) );
+
+      AbstractImage::ThreadData data( status, count );
+      ReferenceArray<StripThread> threads;
+      for ( int i = 0, n = 0; i < int( L.Length() ); n += int( L[i++] ) )
+         threads.Add( new StripThread( *this, data, image, sink, i, n, n + int( L[i] ) ) );
+      AbstractImage::RunThreads( threads, data );
+      threads.Destroy();
+
+      status = data.status;
+   }
+
+private:
+
+   GenericVector<sample> m_hr;             // row filter
+   GenericVector<sample> m_hc;             // column filter
+   double                m_weight;         // filter weight
+   int                   m_numberOfScales;
+   IVector               m_d;              // interlacing distance at each scale
+
+   struct Level
+   {
+      int                   d;            // interlacing distance
+      int                   rd;           // half vertical support, d*(n >> 1)
+      int                   a, b;         // range [a,b) of input rows
+      int                   next;         // next input row to load
+      int                   rawCap = 0;   // capacity of the input row ring (scales > 0)
+      int                   hcCap;        // capacity of the row-convolved ring
+      GenericVector<sample> raw;          // input rows (smoothed rows of the previous scale)
+      GenericVector<sample> hc;           // row-convolved input rows
+   };
+
+   class StripThread : public Thread
+   {
+   public:
+
+      StripThread( const PCL_ATWTStreamingEngine& engine, AbstractImage::ThreadData& data,
+                   const GenericImage<P>& image, RowSink& sink, int strip, int startRow, int endRow )
+         : m_engine( engine )
+         , m_data( data )
+         , m_image( image )
+         , m_sink( sink )
+         , m_strip( strip )
+         , m_startRow( startRow )
+         , m_endRow( endRow )
+      {
+      }
+
+      PCL_HOT_FUNCTION void Run() override
+      {
+         INIT_THREAD_MONITOR()
+
+         const Rect rect = m_image.SelectedRectangle();
+         const int J = m_engine.m_numberOfScales;
+         const int n2 = m_engine.m_hr.Length() >> 1;
+         m_width = rect.Width();
+         m_height = rect.Height();
+         m_stride = m_image.Width();
+
+         /*
+          * Input row ranges, from the last scale down to the first one. The
+          * ring of smoothed input rows for scale j must hold all rows loaded
+          * ahead of the row being emitted, i.e. the cumulative support of
+          * scales >= j.
+          */
+         m_levels = Array<Level>( size_type( J ) );
+         int maxrd = 0;
+         for ( int j = J, a = m_startRow, b = m_endRow, s = 0; --j >= 0; )
+         {
+            Level& L = m_levels[j];
+            L.d = m_engine.m_d[j];
+            L.rd = n2*L.d;
+            L.a = a = Max( 0, a - L.rd );
+            L.b = b = Min( m_height, b + L.rd );
+            L.hcCap = L.rd + L.rd + 1;
+            L.hc = GenericVector<sample>( L.hcCap*size_type( m_width ) );
+            s += L.rd;
+            if ( j > 0 )
+            {
+               L.rawCap = s + 1;
+               L.raw = GenericVector<sample>( L.rawCap*size_type( m_width ) );
+            }
+            maxrd = Max( maxrd, L.rd );
+         }
+
+         m_t = GenericVector<sample>( m_width + maxrd+maxrd );
+         m_s = DVector( m_width );
+
+         GenericVector<sample> cJ( m_width );
+         GenericVector<sample> wv( J*size_type( m_width ) );
+         GenericVector<const sample*> w( J+1 );
+         for ( int j = 0; j < J; ++j )
+            w[j] = wv.At( j*size_type( m_width ) );
+         w[J] = cJ.Begin();
+
+         for ( int c = m_image.FirstSelectedChannel(); c <= m_image.LastSelectedChannel(); ++c )
+         {
+            m_f0 = m_image.PixelAddress( rect.x0, rect.y0, c );
+            for ( Level& L : m_levels )
+               L.next = L.a;
+
+            for ( int y = m_startRow; y < m_endRow; ++y )
+            {
+               Output( J-1, y, cJ.Begin() );
+
+               for ( int j = 0; j < J; ++j )
+               {
+                  const sample* __restrict__ cj = InputRow( j, y );
+                  const sample* __restrict__ cj1 = (j+1 < J) ? InputRow( j+1, y ) : cJ.Begin();
+                  sample* __restrict__ wj = const_cast<sample*>( w[j] );
+                  for ( int x = 0; x < m_width; ++x )
+                     wj[x] = cj[x] - cj1[x];
+               }
+
+               m_sink.Row( m_strip, c - m_image.FirstSelectedChannel(), y, InputRow( 0, y ), w.Begin(), m_width );
+
+               UPDATE_THREAD_MONITOR( 16 )
+            }
+         }
+      }
+
+   private:
+
+      const PCL_ATWTStreamingEngine& m_engine;
+      AbstractImage::ThreadData&     m_data;
+      const GenericImage<P>&         m_image;
+      RowSink&                       m_sink;
+      int                            m_strip;
+      int                            m_startRow;
+      int                            m_endRow;
+      int                            m_width;
+      int                            m_height;
+      size_type                      m_stride;
+      const sample*                  m_f0;
+      Array<Level>                   m_levels;
+      GenericVector<sample>          m_t;      // mirrored row buffer
+      DVector                        m_s;      // row accumulator
+
+      int Mirror( int y ) const noexcept
+      {
+         return (y < 0) ? -y - 1 : ((y >= m_height) ? m_height+m_height - 1 - y : y);
+      }
+
+      const sample* InputRow( int j, int y ) const noexcept
+      {
+         if ( j == 0 )
+            return m_f0 + y*m_stride;
+         const Level& L = m_levels[j];
+         return L.raw.At( (y % L.rawCap)*size_type( m_width ) );
+      }
+
+      /*
+       * Loads input rows of scale j up to the specified row, computing them
+       * from the previous scale as necessary, and stores their row
+       * convolutions.
+       */
+      void Load( int j, int row )
+      {
+         Level& L = m_levels[j];
+         for ( row = Min( row, L.b-1 ); L.next <= row; ++L.next )
+         {
+            const sample* f;
+            if ( j == 0 )
+               f = InputRow( 0, L.next );
+            else
+            {
+               sample* g = L.raw.At( (L.next % L.rawCap)*size_type( m_width ) );
+               Output( j-1, L.next, g );
+               f = g;
+            }
+
+            const int N = m_width;
+            const int dn2 = L.rd;
+            sample* __restrict__ t = m_t.Begin();
+            for ( int i = 0, k = dn2; k > 0; )
+               t[i++] = f[--k];
+            ::memcpy( t+dn2, f, N*sizeof( *f ) );
+            for ( int i = N+dn2+dn2, k = N-dn2; k < N; )
+               t[--i] = f[k++];
+
+            Convolve( L.hc.At( (L.next % L.hcCap)*size_type( m_width ) ), m_engine.m_hr,
+                      [t,&L]( int k ) { return t + k*L.d; }, 1 );
+         }
+      }
+
+      /*
+       * Computes the smoothed row y at scale j (i.e., row y of scale j+1)
+       * by column convolution of row-convolved rows.
+       */
+      void Output( int j, int y, sample* g )
+      {
+         Level& L = m_levels[j];
+         Load( j, y + L.rd );
+         Convolve( g, m_engine.m_hc,
+                   [this,&L,y]( int k )
+                   {
+                      return L.hc.At( (Mirror( y - L.rd + k*L.d ) % L.hcCap)*size_type( m_width ) );
+                   }, m_engine.m_weight );
+      }
+
+      /*
+       * Double precision dot products, accumulated in the same order as in
+       * SeparableConvolution to yield identical results.
+       */
+      template <class R>
+      void Convolve( sample* __restrict__ g, const GenericVector<sample>& hv, R row, double weight ) noexcept
+      {
+         const sample* __restrict__ h = hv.Begin();
+         switch ( hv.Length() )
+         {
+         case 3:
+            {
+               const sample* __restrict__ f0 = row( 0 );
+               const sample* __restrict__ f1 = row( 1 );
+               const sample* __restrict__ f2 = row( 2 );
+               for ( int x = 0; x < m_width; ++x )
+                  g[x] = P::FloatToSample( double( f0[x] ) * double( h[0] )
+                                         + double( f1[x] ) * double( h[1] )
+                                         + double( f2[x] ) * double( h[2] ) );
+            }
+            break;
+         case 5:
+            {
+               const sample* __restrict__ f0 = row( 0 );
+               const sample* __restrict__ f1 = row( 1 );
+               const sample* __restrict__ f2 = row( 2 );
+               const sample* __restrict__ f3 = row( 3 );
+               const sample* __restrict__ f4 = row( 4 );
+               for ( int x = 0; x < m_width; ++x )
+                  g[x] = P::FloatToSample( double( f0[x] ) * double( h[0] )
+                                         + double( f1[x] ) * double( h[1] )
+                                         + double( f2[x] ) * double( h[2] )
+                                         + double( f3[x] ) * double( h[3] )
+                                         + double( f4[x] ) * double( h[4] ) );
+            }
+            break;
+         case 7:
+            {
+               const sample* __restrict__ f0 = row( 0 );
+               const sample* __restrict__ f1 = row( 1 );
+               const sample* __restrict__ f2 = row( 2 );
+               const sample* __restrict__ f3 = row( 3 );
+               const sample* __restrict__ f4 = row( 4 );
+               const sample* __restrict__ f5 = row( 5 );
+               const sample* __restrict__ f6 = row( 6 );
+               for ( int x = 0; x < m_width; ++x )
+                  g[x] = P::FloatToSample( double( f0[x] ) * double( h[0] )
+                                         + double( f1[x] ) * double( h[1] )
+                                         + double( f2[x] ) * double( h[2] )
+                                         + double( f3[x] ) * double( h[3] )
+                                         + double( f4[x] ) * double( h[4] )
+                                         + double( f5[x] ) * double( h[5] )
+                                         + double( f6[x] ) * double( h[6] ) );
+            }
+            break;
+         default:
+            {
+               double* __restrict__ s = m_s.Begin();
+               for ( int x = 0; x < m_width; ++x )
+                  s[x] = 0;
+               for ( int k = 0; k < hv.Length(); ++k )
+               {
+                  const sample* __restrict__ f = row( k );
+                  const double hk = double( h[k] );
+                  for ( int x = 0; x < m_width; ++x )
+                     s[x] += double( f[x] ) * hk;
+               }
+               for ( int x = 0; x < m_width; ++x )
+                  g[x] = P::FloatToSample( s[x] );
+            }
+            break;
+         }
+
+         if ( weight != 1 )
+            for ( int x = 0; x < m_width; ++x )
+               P::Div( g[x], weight );
+      }
+   };
+};
+
+// ----------------------------------------------------------------------------
+
 /*
  * Transform (decomposition)
  */
@@ -73,6 +431,25 @@ public:
    {
       if ( T.m_scalingFunction.IsSeparable() )
       {
+         /*
+          * Only the scales required by enabled layers have to be computed.
+          */
+         int numberOfScales = 0;
+         for ( int j = 0; j <= T.m_numberOfLayers; ++j )
+            if ( T.m_layerEnabled[j] )
+               numberOfScales = Min( j+1, T.m_numberOfLayers );
+
+         if ( numberOfScales == 0 )
+            return;
+
+         if ( PCL_ATWTStreamingEngine<P>::IsApplicable( *T.m_scalingFunction.separableFilter, numberOfScales, T.m_delta,
+                                                          image.SelectedRectangle().Width(),
+                                                          image.SelectedRectangle().Height() ) )
+         {
+            ApplyStreaming( image, T, numberOfScales );
+            return;
+         }
+
          SeparableConvolution C( *T.m_scalingFunction.separableFilter );
          Apply( image, T, C );
       }
@@ -85,6 +462,79 @@ public:
 
 private:
 
+   template <class P>
+   class LayerSink : public PCL_ATWTStreamingEngine<P>::RowSink
+   {
+   public:
+
+      LayerSink( ATrousWaveletTransform::transform& layers, int numberOfScales )
+         : m_layers( layers )
+         , m_numberOfScales( numberOfScales )
+      {
+      }
+
+      void Row( int, int c, int y, const typename P::sample*, const typename P::sample* const* w, int width ) override
+      {
+         for ( int j = 0; j <= m_numberOfScales; ++j )
+            if ( !m_layers[j].IsEmpty() )
+            {
+               float* __restrict__ g = m_layers[j].ScanLine( y, c );
+               const typename P::sample* __restrict__ f = w[j];
+               for ( int x = 0; x < width; ++x )
+                  g[x] = float( f[x] );
+            }
+      }
+
+   private:
+
+      ATrousWaveletTransform::transform& m_layers;
+      int                                m_numberOfScales;
+   };
+
+   template <class P> static
+   void ApplyStreaming( const GenericImage<P>& image, ATrousWaveletTransform& T, int numberOfScales )
+   {
+      bool statusInitialized = false;
+      StatusMonitor& status = (StatusMonitor&)image.Status();
+
+      const Rect r = image.SelectedRectangle();
+      const int numberOfChannels = image.NumberOfSelectedChannels();
+      size_type numberOfRows = size_type( r.Height() )*numberOfChannels;
+
+      try
+      {
+         if ( status.IsInitializationEnabled() )
+         {
+            status.Initialize( "Starlet transform", numberOfRows );
+            status.DisableInitialization();
+            statusInitialized = true;
+         }
+
+         /*
+          * The residual layer of a partial decomposition is never generated.
+          */
+         for ( int j = 0; j <= numberOfScales; ++j )
+            if ( T.m_layerEnabled[j] )
+               if ( j < numberOfScales || numberOfScales == T.m_numberOfLayers )
+                  T.m_transform[j].AllocateData( r.Width(), r.Height(), numberOfChannels,
+                                    (numberOfChannels < 3) ? ColorSpace::Gray : image.ColorSpace() );
+
+         LayerSink<P> sink( T.m_transform, numberOfScales );
+         PCL_ATWTStreamingEngine<P>( *T.m_scalingFunction.separableFilter, numberOfScales, T.m_delta )
+                     .Run( image, sink, status, numberOfRows, T.m_parallel, T.m_maxProcessors );
+
+         if ( statusInitialized )
+            status.EnableInitialization();
+      }
+      catch ( ... )
+      {
+         T.DestroyLayers();
+         if ( statusInitialized )
+            status.EnableInitialization();
+         throw;
+      }
+   }
+
    template <class P, class Cn> static
    void Apply( const GenericImage<P>& image, ATrousWaveletTransform& T, Cn& C )
    {
@@ -532,6 +982,376 @@ double ATrousWaveletTransform::NoiseMRS( const ImageVariant& image, const float
 
 // ----------------------------------------------------------------------------
 
+class PCL_ATWTStreamingNoiseEngine
+{
+public:
+
+   template <class P> static
+   double NoiseKSigma( const SeparableFilter& filter, int numberOfScales, int delta, int j, const GenericImage<P>& image,
+                       float k, float eps, int n, size_type* N, bool parallel, int maxProcessors )
+   {
+      LayerSink<P> sink( j );
+      Sweep( filter, numberOfScales, delta, image, sink, parallel, maxProcessors );
+
+      size_type count = 0;
+      for ( const Array<float>& A : sink.A )
+         count += A.Length();
+      Array<float> A;
+      A.Reserve( count );
+      for ( Array<float>& S : sink.A )
+      {
+         A.Append( S );
+         S.Clear();
+      }
+
+      return NoiseKSigmaEstimate( A, k, eps, n, N );
+   }
+
+   template <class P> static
+   double NoiseMRS( const SeparableFilter& filter, int numberOfLayers, int delta, const float sej[], const GenericImage<P>& image,
+                    double sigma, float K, size_type* nn, float low, float high, bool parallel, int maxProcessors )
+   {
+      size_type N = image.NumberOfSelectedPixels();
+      if ( N < 9 )
+      {
+         if ( nn != nullptr )
+            *nn = 0;
+         return 0;
+      }
+
+      bool statusInitialized = false;
+      if ( image.Status().IsInitializationEnabled() )
+      {
+         image.Status().Initialize( "MRS noise evaluation" ); // unbounded monitor
+         statusInitialized = true;
+      }
+
+      if ( 1 + sigma == 1 )
+      {
+         if ( image.SelectedRectangle() == image.Bounds() )
+         {
+            const typename P::sample* I = image[image.SelectedChannel()];
+            sigma = pcl::StdDev( I, I+N );
+         }
+         else
+         {
+            image.PushSelections();
+            image.SelectChannel( image.SelectedChannel() );
+            GenericImage<P> tmp( image );
+            image.PopSelections();
+            sigma = pcl::StdDev( tmp.PixelData(), tmp.PixelData()+N );
+         }
+
+         if ( 1 + sigma == 1 )
+         {
+            if ( statusInitialized )
+               image.Status().Complete();
+            if ( nn != nullptr )
+               *nn = 0;
+            return 0;
+         }
+      }
+
+      MRSSink<P> sink( numberOfLayers, sej, low, high );
+      Sweep( filter, numberOfLayers, delta, image, sink, parallel, maxProcessors );
+
+      double Ks;
+      ReferenceArray<MRSThread> threads;
+      for ( int i = 0; i < int( sink.M.Length() ); ++i )
+         threads.Add( new MRSThread( sink.M[i], sink.R[i], Ks ) );
+
+      AbstractImage::ThreadData data( image, 0 ); // unbounded monitoring
+      Array<float> S( N );
+      size_type n = 0;
+
+      for ( int it = 0; ; ++it, ++image.Status() )
+      {
+         Ks = K*sigma;
+
+         AbstractImage::RunThreads( threads, data );
+
+         n = 0;
+         for ( const MRSThread& thread : threads )
+            if ( thread.n > 0 )
+            {
+               memcpy( S.At( n ), thread.S.Begin(), thread.n*sizeof( float ) );
+               n += thread.n;
+            }
+
+         if ( n < 2 )
+         {
+            sigma = n = 0;
+            break;
+         }
+
+         double newSigma = pcl::StdDev( S.Begin(), S.At( n ) );
+         if ( 1 + newSigma == 1 )
+         {
+            sigma = n = 0;
+            break;
+         }
+
+         double e = Abs( newSigma - sigma )/newSigma;
+         sigma = newSigma;
+         if ( e < 1e-4 )
+            break;
+
+         if ( it > 16 )
+         {
+            sigma = n = 0;
+            break;
+         }
+      }
+
+      threads.Destroy();
+
+      if ( statusInitialized )
+         image.Status().Complete();
+
+      if ( nn != nullptr )
+         *nn = n;
+      return sigma/0.974; // correction for 2% systematic bias
+   }
+
+private:
+
+   /*
+    * Decomposition of the selected rectangle of the currently selected
+    * channel.
+    */
+   template <class P> static
+   void Sweep( const SeparableFilter& filter, int numberOfScales, int delta, const GenericImage<P>& image,
+               typename PCL_ATWTStreamingEngine<P>::RowSink& sink, bool parallel, int maxProcessors )
+   {
+      StatusMonitor status = image.Status();
+      image.PushSelections();
+      image.SelectChannel( image.SelectedChannel() );
+      try
+      {
+         PCL_ATWTStreamingEngine<P>( filter, numberOfScales, delta ).Run( image, sink, status, 0, parallel, maxProcessors );
+         image.PopSelections();
+         image.Status() = status;
+      }
+      catch ( ... )
+      {
+         image.PopSelections();
+         throw;
+      }
+   }
+
+   /*
+    * Collects the coefficients of a single wavelet layer.
+    */
+   template <class P>
+   class LayerSink : public PCL_ATWTStreamingEngine<P>::RowSink
+   {
+   public:
+
+      Array<Array<float> > A;
+
+      LayerSink( int j )
+         : m_j( j )
+      {
+      }
+
+      void Initialize( int numberOfStrips ) override
+      {
+         A = Array<Array<float> >( size_type( numberOfStrips ) );
+      }
+
+      void Row( int strip, int, int, const typename P::sample*, const typename P::sample* const* w, int width ) override
+      {
+         Array<float>& a = A[strip];
+         const typename P::sample* f = w[m_j];
+         for ( int x = 0; x < width; ++x )
+            a << float( f[x] );
+      }
+
+   private:
+
+      int m_j;
+   };
+
+   /*
+    * For each pixel within the sampling range, stores the maximum absolute
+    * wavelet coefficient in units of the noise at its scale, along with the
+    * pixel value minus the residual layer. A pixel belongs to the
+    * multiresolution support for a given K*sigma iff its significance is
+    * greater than K*sigma, so the noise iterations can be performed without
+    * the wavelet layers.
+    */
+   template <class P>
+   class MRSSink : public PCL_ATWTStreamingEngine<P>::RowSink
+   {
+   public:
+
+      Array<Array<float> > M; // significance
+      Array<Array<float> > R; // noise candidates
+
+      MRSSink( int numberOfLayers, const float sej[], float low, float high )
+         : m_J( numberOfLayers )
+         , m_sej( sej )
+         , m_low( P::ToSample( low ) )
+         , m_high( P::ToSample( high ) )
+      {
+      }
+
+      void Initialize( int numberOfStrips ) override
+      {
+         M = R = Array<Array<float> >( size_type( numberOfStrips ) );
+      }
+
+      void Row( int strip, int, int, const typename P::sample* f, const typename P::sample* const* w, int width ) override
+      {
+         Array<float>& m = M[strip];
+         Array<float>& r = R[strip];
+         for ( int x = 0; x < width; ++x )
+         {
+            typename P::sample v = f[x];
+            if ( v > m_low )
+               if ( v < m_high )
+               {
+                  double s = 0;
+                  for ( int j = 0; j < m_J; ++j )
+                     s = Max( s, Abs( double( float( w[j][x] ) ) )/m_sej[j] );
+                  m << float( s );
+                  r << float( v - w[m_J][x] );
+               }
+         }
+      }
+
+   private:
+
+      int                m_J;
+      const float*       m_sej;
+      typename P::sample m_low;
+      typename P::sample m_high;
+   };
+
+   class MRSThread : public Thread
+   {
+   public:
+
+      Array<float> S;     // noise pixels
+      size_type    n = 0; // number of noise pixels
+
+      MRSThread( const Array<float>& M, const Array<float>& R, const double& Ks )
+         : S( M.Length() )
+         , m_M( M )
+         , m_R( R )
+         , m_Ks( Ks )
+      {
+      }
+
+      void Run() override
+      {
+         n = 0;
+         const double Ks = m_Ks;
+         for ( size_type k = 0; k < m_M.Length(); ++k )
+            if ( m_M[k] <= Ks )
+               S[n++] = m_R[k];
+      }
+
+   private:
+
+      const Array<float>& m_M;
+      const Array<float>& m_R;
+      const double&       m_Ks;
+   };
+};
+
+// ----------------------------------------------------------------------------
+
+double ATrousWaveletTransform::StreamingNoiseKSigma( const ImageVariant& image, int j,
+                                                     float k, float eps, int n, size_type* N ) const
+{
+   ValidateScalingFunction();
+
+   if ( !image )
+      throw Error( "StreamingNoiseKSigma(): No image transported by ImageVariant." );
+
+   if ( j < 0 || j > m_numberOfLayers )
+      throw Error( "StreamingNoiseKSigma(): Invalid wavelet layer index: " + String( j ) );
+
+   int numberOfScales = Min( j+1, m_numberOfLayers );
+
+   if ( m_scalingFunction.IsSeparable() )
+      if ( PCL_ATWTStreamingEngine<FloatPixelTraits>::IsApplicable( *m_scalingFunction.separableFilter, numberOfScales, m_delta,
+                                                          image->SelectedRectangle().Width(),
+                                                          image->SelectedRectangle().Height() ) )
+      {
+         if ( image.IsFloatSample() )
+            switch ( image.BitsPerSample() )
+            {
+            case 32:
+               return PCL_ATWTStreamingNoiseEngine::NoiseKSigma( *m_scalingFunction.separableFilter, numberOfScales, m_delta, j,
+                                                   static_cast<const Image&>( *image ), k, eps, n, N,
+                                                   IsParallelProcessingEnabled(), MaxProcessors() );
+            case 64:
+               return PCL_ATWTStreamingNoiseEngine::NoiseKSigma( *m_scalingFunction.separableFilter, numberOfScales, m_delta, j,
+                                                   static_cast<const DImage&>( *image ), k, eps, n, N,
+                                                   IsParallelProcessingEnabled(), MaxProcessors() );
+            default:
+               return 0; // ?!
+            }
+
+         ImageVariant tmp;
+         tmp.CreateFloatImage();
+         tmp.CopyImage( image );
+         return StreamingNoiseKSigma( tmp, j, k, eps, n, N );
+      }
+
+   ATrousWaveletTransform W( m_scalingFunction, numberOfScales, m_delta );
+   W.EnableParallelProcessing( IsParallelProcessingEnabled(), MaxProcessors() );
+   W << image;
+   return W.NoiseKSigma( j, k, eps, n, N );
+}
+
+// ----------------------------------------------------------------------------
+
+double ATrousWaveletTransform::StreamingNoiseMRS( const ImageVariant& image, const float sej[],
+                                                  double sigma, float K, size_type* N,
+                                                  float low, float high ) const
+{
+   ValidateScalingFunction();
+
+   if ( !image )
+      throw Error( "StreamingNoiseMRS(): No image transported by ImageVariant." );
+
+   if ( m_scalingFunction.IsSeparable() )
+      if ( PCL_ATWTStreamingEngine<FloatPixelTraits>::IsApplicable( *m_scalingFunction.separableFilter, m_numberOfLayers, m_delta,
+                                                          image->SelectedRectangle().Width(),
+                                                          image->SelectedRectangle().Height() ) )
+      {
+         if ( image.IsFloatSample() )
+            switch ( image.BitsPerSample() )
+            {
+            case 32:
+               return PCL_ATWTStreamingNoiseEngine::NoiseMRS( *m_scalingFunction.separableFilter, m_numberOfLayers, m_delta, sej,
+                                                   static_cast<const Image&>( *image ), sigma, K, N, low, high,
+                                                   IsParallelProcessingEnabled(), MaxProcessors() );
+            case 64:
+               return PCL_ATWTStreamingNoiseEngine::NoiseMRS( *m_scalingFunction.separableFilter, m_numberOfLayers, m_delta, sej,
+                                                   static_cast<const DImage&>( *image ), sigma, K, N, low, high,
+                                                   IsParallelProcessingEnabled(), MaxProcessors() );
+            default:
+               return 0; // ?!
+            }
+
+         ImageVariant tmp;
+         tmp.CreateFloatImage();
+         tmp.CopyImage( image );
+         return StreamingNoiseMRS( tmp, sej, sigma, K, N, low, high );
+      }
+
+   ATrousWaveletTransform W( m_scalingFunction, m_numberOfLayers, m_delta );
+   W.EnableParallelProcessing( IsParallelProcessingEnabled(), MaxProcessors() );
+   W << image;
+   return W.NoiseMRS( image, sej, sigma, K, N, low, high );
+}
+
+// ----------------------------------------------------------------------------
+
 void ATrousWaveletTransform::ValidateScalingFunction() const
 {
    if ( !m_scalingFunction.IsValid() )
@@ -49,6 +49,7 @@
 // POSSIBILITY OF SUCH DAMAGE.
 // ----------------------------------------------------------------------------
 
+#include <pcl/Atomic.h>
 #include <pcl/AutoLock.h>
 #include <pcl/Compression.h>
 #include <pcl/ElapsedTime.h>
@@ -155,6 +156,9 @@ public:
          perf->sizeReduction = double( size - compressedSize )/size;
          perf->throughput = size/dt/1024/1024; // MiB/s
          perf->numberOfThreads = numberOfThreads;
+         perf->compressedBytes = compressedSize - subblocks.Size() - sizeof( Compression::subblock_list );
+         perf->uncompressedBytes = size;
+         perf->elapsedTime = dt;
       }
 
       if ( compressedSize >= size )
@@ -261,6 +265,69 @@ Compression::subblock_list Compression::Compress( const void* data, size_type si
 
 // ----------------------------------------------------------------------------
 
+/*
+ * Per-thread decompression state. Codec contexts are created on demand and
+ * reused by all subsequent decompression operations performed by the same
+ * thread. Working buffers are owned by decompression threads and released
+ * at the end of each operation, so only the small codec states persist.
+ */
+class PCL_DecompressionContext
+{
+public:
+
+   PCL_DecompressionContext() = default;
+
+   ~PCL_DecompressionContext()
+   {
+      if ( m_zlibInitialized )
+         (void)::inflateEnd( &m_zlib );
+      if ( m_zstd != nullptr )
+         (void)::ZSTD_freeDCtx( m_zstd );
+   }
+
+   static PCL_DecompressionContext& ForCurrentThread()
+   {
+      static thread_local PCL_DecompressionContext context;
+      return context;
+   }
+
+   z_stream* ZLibStream()
+   {
+      if ( m_zlibInitialized )
+      {
+         if ( ::inflateReset( &m_zlib ) != Z_OK )
+            throw Error( "Unable to reset zlib decompression stream." );
+      }
+      else
+      {
+         ::memset( &m_zlib, 0, sizeof( z_stream ) );
+         if ( ::inflateInit( &m_zlib ) != Z_OK )
+            throw Error( "Unable to initialize zlib decompression stream." );
+         m_zlibInitialized = true;
+      }
+      return &m_zlib;
+   }
+
+   ZSTD_DCtx* ZstdContext()
+   {
+      if ( m_zstd == nullptr )
+      {
+         m_zstd = ::ZSTD_createDCtx();
+         if ( m_zstd == nullptr )
+            throw Error( "Unable to create Zstandard decompression context." );
+      }
+      return m_zstd;
+   }
+
+private:
+
+   z_stream   m_zlib;
+   bool       m_zlibInitialized = false;
+   ZSTD_DCtx* m_zstd = nullptr;
+};
+
+// ----------------------------------------------------------------------------
+
 class PCL_DecompressionEngine
 {
 public:
@@ -271,40 +338,42 @@ public:
    }
 
    size_type operator ()( void* data, size_type maxSize,
-                          const Compression::subblock_list& subblocks, Compression::Performance* perf )
+                          const Compression::subblock_ref_list& subblocks, Compression::Performance* perf )
    {
       if ( subblocks.IsEmpty() )
          return 0;
 
+      m_offsets = Array<size_type>( subblocks.Length() );
       size_type uncompressedSize = 0;
-      for ( const Compression::Subblock& subblock : subblocks )
+      size_type compressedSize = 0;
+      for ( size_type i = 0; i < subblocks.Length(); ++i )
       {
-         if ( subblock.compressedData.IsEmpty() || subblock.uncompressedSize == 0 )
+         const Compression::SubblockRef& subblock = subblocks[i];
+         if ( subblock.compressedData == nullptr || subblock.compressedSize == 0 || subblock.uncompressedSize == 0 )
             m_compression.Throw( "Invalid compressed subblock data." );
+         m_offsets[i] = uncompressedSize;
          uncompressedSize += subblock.uncompressedSize;
+         compressedSize += subblock.compressedSize;
       }
       if ( maxSize < uncompressedSize )
          m_compression.Throw( String().Format( "Insufficient uncompression buffer length (required %llu, available %llu)",
                                                uncompressedSize, maxSize ) );
 
+      m_subblocks = subblocks.Begin();
+      m_numberOfSubblocks = int( subblocks.Length() );
       m_uncompressedData = reinterpret_cast<ByteArray::iterator>( data );
+      m_uncompressedSize = uncompressedSize;
+      m_itemSize = m_compression.ByteShufflingEnabled() ? m_compression.ItemSize() : 1;
+      m_numberOfItems = uncompressedSize/m_itemSize;
+      m_nextSubblock.Store( 0 );
 
-      Array<size_type> L = Thread::OptimalThreadLoads( subblocks.Length(),
+      int numberOfThreads = int( Thread::OptimalThreadLoads( subblocks.Length(),
                                           1/*overheadLimit*/,
-                                          m_compression.IsParallelProcessingEnabled() ? m_compression.MaxProcessors() : 1 );
-      int numberOfThreads = int( L.Length() );
+                                          m_compression.IsParallelProcessingEnabled() ? m_compression.MaxProcessors() : 1 ).Length() );
 
       ReferenceArray<DecompressionThread> threads;
-      size_type offset = 0;
-      for ( int i = 0, n = 0; i < numberOfThreads; n += int( L[i++] ) )
-      {
-         Compression::subblock_list::const_iterator begin = subblocks.At( n );
-         Compression::subblock_list::const_iterator end = subblocks.At( n + int( L[i] ) );
-         threads << new DecompressionThread( *this, offset, begin, end );
-         if ( i < numberOfThreads-1 )
-            for ( Compression::subblock_list::const_iterator i = begin; i != end; ++i )
-               offset += i->uncompressedSize;
-      }
+      for ( int i = 0; i < numberOfThreads; ++i )
+         threads << new DecompressionThread( *this );
 
       m_errors.Clear();
 
@@ -327,24 +396,16 @@ public:
       if ( !m_errors.IsEmpty() )
          m_compression.Throw( String().ToSeparated( m_errors, '\n' ) );
 
-      if ( m_compression.ByteShufflingEnabled() )
-         if ( m_compression.ItemSize() > 1 )
-         {
-            T.Reset();
-            Compression::InPlaceUnshuffle( m_uncompressedData, uncompressedSize, m_compression.ItemSize() );
-            dt += T();
-         }
-
       if ( perf != nullptr )
       {
-         size_type compressedSize = 0;
-         for ( const Compression::Subblock& subblock : subblocks )
-            compressedSize += subblock.compressedData.Length();
-         compressedSize += subblocks.Size() + sizeof( Compression::subblock_list );
-
-         perf->sizeReduction = double( uncompressedSize - compressedSize )/uncompressedSize;
+         size_type totalCompressedSize = compressedSize + subblocks.Length()*sizeof( Compression::Subblock )
+                                                        + sizeof( Compression::subblock_list );
+         perf->sizeReduction = double( uncompressedSize - totalCompressedSize )/uncompressedSize;
          perf->throughput = uncompressedSize/dt/1024/1024; // MiB/s
          perf->numberOfThreads = numberOfThreads;
+         perf->compressedBytes = compressedSize;
+         perf->uncompressedBytes = uncompressedSize;
+         perf->elapsedTime = dt;
       }
 
       return uncompressedSize;
@@ -352,23 +413,55 @@ public:
 
 private:
 
-     const Compression&        m_compression;
-           ByteArray::iterator m_uncompressedData;
-   mutable Mutex               m_mutex;
-   mutable StringList          m_errors;
+     const Compression&               m_compression;
+     const Compression::SubblockRef*  m_subblocks = nullptr;
+           int                        m_numberOfSubblocks = 0;
+           Array<size_type>           m_offsets;
+           ByteArray::iterator        m_uncompressedData = nullptr;
+           size_type                  m_uncompressedSize = 0;
+           size_type                  m_itemSize = 1;
+           size_type                  m_numberOfItems = 0;
+   mutable AtomicInt                  m_nextSubblock;
+   mutable Mutex                      m_mutex;
+   mutable StringList                 m_errors;
+
+   /*
+    * Writes a segment of length n of the shuffled data stream, starting at
+    * the specified offset, to its unshuffled locations in the output block.
+    * Byte j of the i-th item is stored at offset j*N + i of the shuffled
+    * stream, where N is the number of items; trailing bytes that don't form
+    * a complete item are not shuffled.
+    */
+   void Unshuffle( const uint8* __restrict__ s, size_type offset, size_type n ) const
+   {
+      const size_type w = m_itemSize;
+      const size_type N = m_numberOfItems;
+      const size_type shuffledEnd = N*w;
+      const size_type end = offset + n;
+      for ( size_type p = offset; p < end && p < shuffledEnd; )
+      {
+         size_type j = p/N;
+         size_type i = p%N;
+         size_type m = pcl::Min( end, (j + 1)*N ) - p;
+         uint8* __restrict__ u = m_uncompressedData + i*w + j;
+         for ( size_type k = 0; k < m; ++k, u += w )
+            u[0] = s[k];
+         s += m;
+         p += m;
+      }
+      if ( end > shuffledEnd )
+      {
+         size_type p = pcl::Max( offset, shuffledEnd );
+         ::memcpy( m_uncompressedData + p, s, end - p );
+      }
+   }
 
    class DecompressionThread : public Thread
    {
    public:
 
-      DecompressionThread( const PCL_DecompressionEngine& engine,
-                           size_type offset,
-                           Compression::subblock_list::const_iterator begin,
-                           Compression::subblock_list::const_iterator end )
+      DecompressionThread( const PCL_DecompressionEngine& engine )
          : E( engine )
-         , m_offset( offset )
-         , m_begin( begin )
-         , m_end( end )
       {
       }
 
@@ -376,45 +469,49 @@ private:
       {
          try
          {
-            size_type uncompressedSize = 0;
-            for ( Compression::subblock_list::const_iterator i = m_begin; i != m_end; ++i )
-               uncompressedSize += i->uncompressedSize;
+            bool shuffled = E.m_itemSize > 1;
 
-            size_type totalSize = 0;
-            for ( Compression::subblock_list::const_iterator i = m_begin; i != m_end; ++i )
+            for ( ;; )
             {
-               if ( i->checksum != 0 )
+               int index = E.m_nextSubblock.FetchAndAdd( 1 );
+               if ( index >= E.m_numberOfSubblocks )
+                  break;
+
+               const Compression::SubblockRef& subblock = E.m_subblocks[index];
+               size_type offset = E.m_offsets[index];
+
+               if ( subblock.checksum != 0 )
                {
-                  uint64 checksum = i->compressedData.Hash64();
-                  if ( i->checksum != checksum )
+                  uint64 checksum = pcl::Hash64( subblock.compressedData, subblock.compressedSize );
+                  if ( subblock.checksum != checksum )
                      throw String().Format( "Subblock checksum mismatch (offset=%llu, expected %llx, got %llx)",
-                                            m_offset+totalSize, i->checksum, checksum );
+                                            offset, subblock.checksum, checksum );
                }
 
-               if ( i->compressedData.Length() < i->uncompressedSize )
+               if ( subblock.compressedSize < subblock.uncompressedSize )
                {
                   // Compressed subblock.
-                  size_type subblockSize = E.m_compression.UncompressBlock( E.m_uncompressedData+m_offset+totalSize,
-                                                                            uncompressedSize-totalSize,
-                                                                            i->compressedData.Begin(), i->compressedData.Length() );
+                  uint8* output = shuffled ? Buffer( subblock.uncompressedSize ) : E.m_uncompressedData + offset;
+                  size_type subblockSize = E.m_compression.UncompressBlock( output, subblock.uncompressedSize,
+                                                                            subblock.compressedData, subblock.compressedSize );
                   if ( subblockSize == 0 )
                      throw String().Format( "Failed to uncompress subblock data (offset=%llu usize=%llu csize=%llu)",
-                                            m_offset+totalSize, i->uncompressedSize, i->compressedData.Length() );
-                  if ( subblockSize != i->uncompressedSize )
+                                            offset, subblock.uncompressedSize, subblock.compressedSize );
+                  if ( subblockSize != subblock.uncompressedSize )
                      throw String().Format( "Uncompressed subblock size mismatch (offset=%llu, expected %llu, got %llu)",
-                                            m_offset+totalSize, i->uncompressedSize, subblockSize );
+                                            offset, subblock.uncompressedSize, subblockSize );
+                  if ( shuffled )
+                     E.Unshuffle( output, offset, subblock.uncompressedSize );
                }
                else
                {
                   // Subblock too small to be compressed, or data not compressible.
-                  ::memcpy( E.m_uncompressedData+m_offset+totalSize, i->compressedData.Begin(), i->uncompressedSize );
+                  if ( shuffled )
+                     E.Unshuffle( subblock.compressedData, offset, subblock.uncompressedSize );
+                  else
+                     ::memcpy( E.m_uncompressedData + offset, subblock.compressedData, subblock.uncompressedSize );
                }
-
-               totalSize += i->uncompressedSize;
             }
-            if ( totalSize != uncompressedSize )
-               throw String().Format( "Uncompressed data size mismatch (offset=%llu, expected %llu, got %llu)",
-                                      m_offset, uncompressedSize, totalSize );
          }
          catch ( ... )
          {
@@ -445,19 +542,44 @@ private:
 
    private:
 
-      const PCL_DecompressionEngine&                   E;
-            size_type                                  m_offset;
-            Compression::subblock_list::const_iterator m_begin;
-            Compression::subblock_list::const_iterator m_end;
+      const PCL_DecompressionEngine& E;
+            ByteArray                m_buffer; // working buffer for unshuffling
+
+      uint8* Buffer( size_type size )
+      {
+         if ( m_buffer.Length() < size )
+         {
+            m_buffer.Clear();
+            m_buffer = ByteArray( size );
+         }
+         return m_buffer.Begin();
+      }
    };
 };
 
 size_type Compression::Uncompress( void* data, size_type maxSize,
-                                   const Compression::subblock_list& subblocks, Compression::Performance* perf ) const
+                                   const Compression::subblock_ref_list& subblocks, Compression::Performance* perf ) const
 {
    return PCL_DecompressionEngine( *this )( data, maxSize, subblocks, perf );
 }
 
+size_type Compression::Uncompress( void* data, size_type maxSize,
+                                   const Compression::subblock_list& subblocks, Compression::Performance* perf ) const
+{
+   subblock_ref_list refs;
+   refs.Reserve( subblocks.Length() );
+   for ( const Subblock& subblock : subblocks )
+   {
+      SubblockRef ref;
+      ref.compressedData = subblock.compressedData.Begin();
+      ref.compressedSize = subblock.compressedData.Length();
+      ref.uncompressedSize = subblock.uncompressedSize;
+      ref.checksum = subblock.checksum;
+      refs << ref;
+   }
+   return PCL_DecompressionEngine( *this )( data, maxSize, refs, perf );
+}
+
 // ----------------------------------------------------------------------------
 
 void Compression::Throw( const String& errorMessage ) const
@@ -551,10 +673,13 @@ size_type ZLibCompression::UncompressBlock( void* outputData, size_type maxOutpu
       if ( maxOutputSize > uint32_max )
          throw Error( "Invalid maximum output size." );
 
-      unsigned long outputSize = uint32( maxOutputSize );
-      int result = ::uncompress( (uint8*)outputData, &outputSize,
-                                 (const uint8*)inputData, uint32( inputSize ) );
-      return (result == Z_OK) ? outputSize : 0;
+      z_stream* stream = PCL_DecompressionContext::ForCurrentThread().ZLibStream();
+      stream->next_in = (Bytef*)inputData;
+      stream->avail_in = uInt( inputSize );
+      stream->next_out = (Bytef*)outputData;
+      stream->avail_out = uInt( maxOutputSize );
+      int result = ::inflate( stream, Z_FINISH );
+      return (result == Z_STREAM_END) ? size_type( stream->total_out ) : 0;
    }
    catch ( const Exception& x )
    {
@@ -829,7 +954,8 @@ size_type ZstdCompression::UncompressBlock( void* outputData, size_type maxOutpu
       if ( maxOutputSize < outputSize )
          throw Error( "Invalid uncompressed block size." );
 
-      size_type result = ZSTD_decompress( outputData, outputSize, inputData, inputSize );
+      size_type result = ZSTD_decompressDCtx( PCL_DecompressionContext::ForCurrentThread().ZstdContext(),
+                                              outputData, outputSize, inputData, inputSize );
       if ( ZSTD_isError( result ) )
          throw Error( ZSTD_getErrorName( result ) );
       if ( result != outputSize )
@@ -49,11 +49,22 @@
 // POSSIBILITY OF SUCH DAMAGE.
 // ----------------------------------------------------------------------------
 
+#include <pcl/Defs.h>
+
+#ifdef __PCL_WINDOWS
+#  include <windows.h>
+#else
+#  include <sys/mman.h>
+#  include <fcntl.h>
+#  include <unistd.h>
+#endif
+
 #include <pcl/AutoLock.h>
 #include <pcl/Console.h>
 #include <pcl/EphemerisFile.h>
 #include <pcl/GlobalSettings.h>
 #include <pcl/Random.h>
+#include <pcl/SIMDDispatch.h>
 #include <pcl/Version.h>
 #include <pcl/XML.h>
 
@@ -263,18 +274,10 @@ void EphemerisFile::DeserializeObjectThread::Run()
                if ( position < m_minPos || position >= m_fileSize )
                   throw Error( "Invalid index position attribute value." );
 
-               {
-                  static Mutex mutex;
-                  volatile AutoLock lock( mutex );
-
-                  m_file.SetPosition( position );
-                  for ( int i = 0; i < numberOfExpansions; ++i )
-                  {
-                     IndexNode node;
-                     m_file.Read( node );
-                     index.nodes[order] << node;
-                  }
-               }
+               // Positional reads: no need to serialize file accesses among threads.
+               index.nodes[order] = Array<IndexNode>( size_type( numberOfExpansions ) );
+               m_file.ReadAt( position, reinterpret_cast<void*>( index.nodes[order].Begin() ),
+                              numberOfExpansions*sizeof( IndexNode ) );
             }
             else if ( element.Name() == "Description" )
             {
@@ -544,6 +547,125 @@ void EphemerisFile::Open( const String& filePath )
 
    m_constants.Sort();
    m_index.Sort();
+
+   MapFile();
+}
+
+// ----------------------------------------------------------------------------
+
+void EphemerisFile::MapFile()
+{
+   UnmapFile();
+
+   fsize_type size = m_file.Size();
+   if ( size <= 0 || sizeof( void* ) < 8 )
+      return;
+
+#ifdef __PCL_WINDOWS
+
+   HANDLE hFile = ::CreateFileW( (LPCWSTR)File::UnixPathToWindows( m_file.FilePath() ).c_str(),
+                                 GENERIC_READ, FILE_SHARE_READ, 0, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, 0 );
+   if ( hFile == INVALID_HANDLE_VALUE )
+      return;
+   // The mapping object keeps a reference to the file.
+   HANDLE hMapping = ::CreateFileMappingW( hFile, 0, PAGE_READONLY, 0, 0, 0 );
+   ::CloseHandle( hFile );
+   if ( hMapping == 0 )
+      return;
+   void* data = ::MapViewOfFile( hMapping, FILE_MAP_READ, 0, 0, 0 );
+   if ( data == nullptr )
+   {
+      ::CloseHandle( hMapping );
+      return;
+   }
+   m_mapping = (void*)hMapping;
+
+#else
+
+   int fd = ::open( m_file.FilePath().ToUTF8().c_str(), O_RDONLY );
+   if ( fd < 0 )
+      return;
+   // The mapping remains valid after closing the file descriptor.
+   void* data = ::mmap( nullptr, size_t( size ), PROT_READ, MAP_SHARED, fd, 0 );
+   ::close( fd );
+   if ( data == MAP_FAILED )
+      return;
+
+#endif
+
+   m_data = reinterpret_cast<const uint8*>( data );
+   m_dataSize = size;
+}
+
+// ----------------------------------------------------------------------------
+
+void EphemerisFile::UnmapFile()
+{
+   if ( m_data != nullptr )
+   {
+#ifdef __PCL_WINDOWS
+      ::UnmapViewOfFile( (LPCVOID)m_data );
+      ::CloseHandle( (HANDLE)m_mapping );
+#else
+      ::munmap( (void*)m_data, size_t( m_dataSize ) );
+#endif
+      m_data = nullptr;
+      m_dataSize = 0;
+      m_mapping = nullptr;
+   }
+}
+
+// ----------------------------------------------------------------------------
+
+/*
+ * Evaluation of a Chebyshev expansion, whose fitting interval is defined by x0
+ * and dx as in GenericChebyshevFit, for a set of evaluation points. Clenshaw
+ * recurrences are evaluated for groups of points in parallel by a dispatched
+ * SIMD kernel, for each vector component.
+ */
+static void EvaluateExpansion( Vector* y, const double* x, int n, const ChebyshevFit& T, double x0, double dx )
+{
+   int N = T.NumberOfComponents();
+   const ChebyshevFit::coefficient_series& c = T.Coefficients();
+   Vector u( n ), r( n );
+   for ( int j = 0; j < n; ++j )
+   {
+      u[j] = 2*(x[j] - x0)/dx;
+      y[j] = Vector( N );
+   }
+   for ( int i = 0; i < N; ++i )
+   {
+      SIMD::ChebyshevSeries( r.Begin(), u.Begin(), size_type( n ), c[i].Begin(), T.TruncatedLength( i ) );
+      for ( int j = 0; j < n; ++j )
+         y[j][i] = r[j];
+   }
+}
+
+void EphemerisFile::Handle::EvaluateBatch( Array<Vector>& y, const Array<TimePoint>& t, int index )
+{
+   y = Array<Vector>( t.Length() );
+   Array<double> x( t.Length() );
+
+   for ( size_type i = 0; i < t.Length(); )
+   {
+      if ( index == 0 )
+         Update( t[i], 0 );
+      else
+         UpdateDerivative( t[i] );
+
+      /*
+       * Gather all consecutive time points covered by the current expansion.
+       */
+      const NodeInfo& info = m_node[index];
+      size_type j = i;
+      do
+         x[j] = t[j] - info.startTime;
+      while ( ++j < t.Length() && t[j].IsValid() && t[j] >= info.startTime && t[j] < info.endTime );
+
+      double D = info.endTime - info.startTime;
+      EvaluateExpansion( y.At( i ), x.At( i ), int( j - i ), info.expansion, (0 + D)/2, Abs( D ) );
+      i = j;
+   }
 }
 
 // ----------------------------------------------------------------------------
@@ -556,6 +678,7 @@ void EphemerisFile::Close()
       int n = NumberOfHandles();
       if ( n > 0 )
          throw Error( String().Format( "Invalid call: This EphemerisFile instance has %d active child handle(s).", n ) );
+      UnmapFile();
       m_file.Close();
       m_startTime = m_endTime = TimePoint();
       m_metadata = EphemerisMetadata();
@@ -572,6 +695,7 @@ EphemerisFile::~EphemerisFile() noexcept( false )
    int n = NumberOfHandles();
    if ( n > 0 )
       std::cerr << IsoString().Format( "** Warning: Destroying an EphemerisFile instance with %d active child handle(s).\n", n );
+   UnmapFile();
    m_file.Close();
 }
 
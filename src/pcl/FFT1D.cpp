@@ -49,7 +49,15 @@
 // POSSIBILITY OF SUCH DAMAGE.
 // ----------------------------------------------------------------------------
 
+#include <pcl/Atomic.h>
+#include <pcl/AutoLock.h>
+#include <pcl/AutoPointer.h>
+#include <pcl/ElapsedTime.h>
 #include <pcl/FFT1D.h>
+#include <pcl/Math.h>
+#include <pcl/Random.h>
+#include <pcl/ReferenceArray.h>
+#include <pcl/SIMDDispatch.h>
 
 #include <pcl/api/APIException.h>
 #include <pcl/api/APIInterface.h>
@@ -59,142 +67,853 @@ namespace pcl
 
 // ----------------------------------------------------------------------------
 
+/*
+ * Native FFT plan. A mixed-radix Stockham autosort transform of complex data
+ * of length n, or a transform of real data of length n. Real transforms of
+ * even length are computed as complex transforms of length n/2; odd lengths
+ * use a complex transform of length n.
+ *
+ * Plans are immutable once constructed, so they can be shared by any number
+ * of handles and threads.
+ */
+template <typename T>
+class PCL_NativeFFTPlan
+{
+public:
+
+   using complex = Complex<T>;
+
+   PCL_NativeFFTPlan( int n, bool real, int sign )
+      : m_length( n )
+      , m_real( real )
+      , m_sign( sign )
+   {
+      if ( n < 1 )
+         throw Error( "Invalid FFT length: " + String( n ) );
+
+      if ( m_real )
+      {
+         int h = (n & 1) ? n : n >> 1;
+         m_half = new PCL_NativeFFTPlan( h, false, sign );
+         if ( (n & 1) == 0 )
+         {
+            m_realTwiddles = GenericVector<complex>( h );
+            for ( int k = 0; k < h; ++k )
+               m_realTwiddles[k] = Twiddle( k, n );
+         }
+         return;
+      }
+
+      /*
+       * Factorization. Generic odd radices are applied first, so the radix-2
+       * and radix-4 passes, which use SIMD butterflies, are executed with the
+       * longest contiguous runs of data.
+       */
+      Array<int> radices;
+      int m = n, twos = 0;
+      for ( ; (m & 1) == 0; m >>= 1 )
+         ++twos;
+      for ( int p = 3; p*p <= m; p += 2 )
+         for ( ; m % p == 0; m /= p )
+            radices << p;
+      if ( m > 1 )
+         radices << m;
+      if ( twos & 1 )
+         radices << 2;
+      for ( int i = twos >> 1; i > 0; --i )
+         radices << 4;
+
+      size_type twiddles = 0, roots = 0;
+      for ( int r : radices )
+      {
+         Stage stage;
+         stage.radix = r;
+         stage.s = m_stages.IsEmpty() ? 1 : m_stages[m_stages.Length()-1].sr;
+         stage.sr = stage.s*r;
+         stage.m = n/stage.sr;
+         stage.twiddles = twiddles;
+         stage.roots = roots;
+         twiddles += size_type( r - 1 )*size_type( stage.m );
+         if ( r != 2 && r != 4 )
+            roots += r;
+         m_stages << stage;
+      }
+
+      m_twiddles = GenericVector<complex>( int( twiddles ) );
+      m_roots = GenericVector<complex>( int( roots ) );
+      for ( const Stage& stage : m_stages )
+      {
+         complex* w = m_twiddles.Begin() + stage.twiddles;
+         for ( int p = 0; p < stage.m; ++p )
+            for ( int j = 1; j < stage.radix; ++j )
+               *w++ = Twiddle( j*p, stage.radix*stage.m );
+         if ( stage.radix != 2 && stage.radix != 4 )
+            for ( int k = 0; k < stage.radix; ++k )
+               m_roots[int( stage.roots ) + k] = Twiddle( k, stage.radix );
+      }
+   }
+
+   int WorkLength() const
+   {
+      if ( m_real )
+         return ((m_length & 1) ? 2*m_length : m_length/2) + m_half->WorkLength();
+      return 2*m_length;
+   }
+
+   bool IsEquivalentTo( int n, bool real, int sign ) const
+   {
+      return n == m_length && real == m_real && sign == m_sign;
+   }
+
+   /*
+    * Complex transform. The input and output arrays can overlap. The work
+    * array must have at least WorkLength() elements.
+    */
+   void Transform( complex* y, const complex* x, complex* work ) const
+   {
+      int n = m_length;
+      if ( n == 1 )
+      {
+         *y = *x;
+         return;
+      }
+
+      const complex* src = x;
+      if ( x + n > y && y + n > x )
+      {
+         complex* t = work + n;
+         for ( int i = 0; i < n; ++i )
+            t[i] = x[i];
+         src = t;
+      }
+
+      for ( size_type i = 0, S = m_stages.Length(); i < S; ++i )
+      {
+         complex* dst = ((S - 1 - i) & 1) ? work : y;
+         ExecuteStage( m_stages[i], dst, src );
+         src = dst;
+      }
+   }
+
+   /*
+    * Real forward transform: n real values to n/2 + 1 complex values.
+    */
+   void RealTransform( complex* y, const T* x, complex* work ) const
+   {
+      int n = m_length;
+      if ( n & 1 )
+      {
+         complex* z = work;
+         for ( int i = 0; i < n; ++i )
+            z[i] = complex( x[i], T( 0 ) );
+         m_half->Transform( z + n, z, z + 2*n );
+         for ( int i = 0; i <= n/2; ++i )
+            y[i] = z[n + i];
+         return;
+      }
+
+      int h = n >> 1;
+      complex* Z = work;
+      m_half->Transform( Z, reinterpret_cast<const complex*>( x ), work + h );
+
+      y[0] = complex( Z[0].Real() + Z[0].Imag(), T( 0 ) );
+      y[h] = complex( Z[0].Real() - Z[0].Imag(), T( 0 ) );
+      for ( int k = 1; k < h; ++k )
+      {
+         complex a = Z[k];
+         complex b = ~Z[h-k];
+         complex e = T( 0.5 )*(a + b);
+         complex d = a - b;
+         complex o( T( 0.5 )*d.Imag(), T( -0.5 )*d.Real() );
+         y[k] = e + m_realTwiddles[k]*o;
+      }
+   }
+
+   /*
+    * Real inverse transform: n/2 + 1 complex values to n real values.
+    */
+   void RealInverseTransform( T* y, const complex* x, complex* work ) const
+   {
+      int n = m_length;
+      if ( n & 1 )
+      {
+         complex* z = work;
+         z[0] = x[0];
+         for ( int k = 1; k <= n/2; ++k )
+         {
+            z[k] = x[k];
+            z[n-k] = ~x[k];
+         }
+         m_half->Transform( z + n, z, z + 2*n );
+         for ( int i = 0; i < n; ++i )
+            y[i] = z[n + i].Real();
+         return;
+      }
+
+      int h = n >> 1;
+      complex* Z = work;
+      for ( int k = 0; k < h; ++k )
+      {
+         complex a = x[k];
+         complex b = ~x[h-k];
+         complex d = m_realTwiddles[k]*(a - b);
+         Z[k] = (a + b) + complex( -d.Imag(), d.Real() );
+      }
+      m_half->Transform( reinterpret_cast<complex*>( y ), Z, work + h );
+   }
+
+private:
+
+   struct Stage
+   {
+      int       radix;
+      int       m;          // number of butterfly groups
+      int       s;          // stride = number of butterflies per group
+      int       sr;         // s*radix
+      size_type twiddles;   // offset of stage twiddle factors
+      size_type roots;      // offset of roots of unity for generic radices
+   };
+
+   int                               m_length;
+   bool                              m_real;
+   int                               m_sign;
+   Array<Stage>                      m_stages;
+   GenericVector<complex>            m_twiddles;
+   GenericVector<complex>            m_roots;
+   AutoPointer<PCL_NativeFFTPlan<T>> m_half;
+   GenericVector<complex>            m_realTwiddles;
+
+   complex Twiddle( int k, int n ) const
+   {
+      double s, c;
+      SinCos( 2*Const<double>::pi()*(k % n)/n, s, c );
+      return complex( T( c ), T( m_sign*s ) );
+   }
+
+   /*
+    * Stockham pass: for 0 <= p < m, 0 <= q < s, with a_k = x[q + s*(p + k*m)]:
+    *
+    * y[q + s*(r*p + j)] = W^(j*p) * DFT_r( a )_j, W = exp( sign*2*pi*i/(r*m) )
+    */
+   void ExecuteStage( const Stage& stage, complex* __restrict__ y, const complex* __restrict__ x ) const
+   {
+      const int r = stage.radix;
+      const int m = stage.m;
+      const int s = stage.s;
+      const complex* __restrict__ w = m_twiddles.Begin() + stage.twiddles;
+
+      switch ( r )
+      {
+      case 2:
+         if ( s == 1 )
+            for ( int p = 0; p < m; ++p, ++w )
+            {
+               complex a0 = x[p], a1 = x[p + m];
+               y[2*p] = a0 + a1;
+               y[2*p + 1] = *w * (a0 - a1);
+            }
+         else
+            for ( int p = 0; p < m; ++p, ++w )
+               SIMD::FFTRadix2( y + size_type( 2*s )*p, s, x + size_type( s )*p, size_type( s )*m, w, m_sign, s );
+         break;
+
+      case 4:
+         if ( s == 1 )
+            for ( int p = 0; p < m; ++p, w += 3 )
+            {
+               complex a0 = x[p], a1 = x[p + m], a2 = x[p + 2*m], a3 = x[p + 3*m];
+               complex t0 = a0 + a2, t1 = a0 - a2, t2 = a1 + a3, d = a1 - a3;
+               complex t3( -m_sign*d.Imag(), m_sign*d.Real() );
+               y[4*p    ] = t0 + t2;
+               y[4*p + 1] = w[0] * (t1 + t3);
+               y[4*p + 2] = w[1] * (t0 - t2);
+               y[4*p + 3] = w[2] * (t1 - t3);
+            }
+         else
+            for ( int p = 0; p < m; ++p, w += 3 )
+               SIMD::FFTRadix4( y + size_type( 4*s )*p, s, x + size_type( s )*p, size_type( s )*m, w, m_sign, s );
+         break;
+
+      case 3:
+         {
+            const T k = T( m_sign*0.86602540378443864676 ); // sign*sin( 2*pi/3 )
+            for ( int p = 0; p < m; ++p, w += 2 )
+               for ( int q = 0; q < s; ++q )
+               {
+                  complex a0 = x[q + s*p], a1 = x[q + s*(p + m)], a2 = x[q + s*(p + 2*m)];
+                  complex t1 = a1 + a2;
+                  complex t2 = a0 - T( 0.5 )*t1;
+                  complex d = a1 - a2;
+                  complex t3( -k*d.Imag(), k*d.Real() );
+                  complex* __restrict__ z = y + q + s*3*p;
+                  z[0] = a0 + t1;
+                  z[s] = w[0] * (t2 + t3);
+                  z[2*s] = w[1] * (t2 - t3);
+               }
+         }
+         break;
+
+      default:
+         {
+            const complex* __restrict__ u = m_roots.Begin() + stage.roots;
+            GenericVector<complex> a( r );
+            for ( int p = 0; p < m; ++p, w += r-1 )
+               for ( int q = 0; q < s; ++q )
+               {
+                  for ( int k = 0; k < r; ++k )
+                     a[k] = x[q + s*(p + k*m)];
+                  complex* __restrict__ z = y + q + s*r*p;
+                  for ( int j = 0; j < r; ++j )
+                  {
+                     complex sum = a[0];
+                     for ( int k = 1, jk = j; k < r; ++k, jk += j )
+                        sum += a[k] * u[jk % r];
+                     z[s*j] = (j > 0) ? w[j-1] * sum : sum;
+                  }
+               }
+         }
+         break;
+      }
+   }
+};
+
+// ----------------------------------------------------------------------------
+
+/*
+ * Cache of native plans shared by native transform handles. Plans are
+ * reference counted by the handles using them. Unused plans are kept for
+ * reuse, up to MaxUnusedPlans, and released in least recently used order.
+ * The cache is never destroyed, since handles may live in objects with
+ * static storage duration.
+ */
+template <typename T>
+class PCL_NativeFFTPlanCache
+{
+public:
+
+   static const PCL_NativeFFTPlan<T>& Acquire( int n, bool real, int sign )
+   {
+      PCL_NativeFFTPlanCache& cache = Instance();
+      volatile AutoLock lock( cache.m_mutex );
+      for ( Entry& entry : cache.m_entries )
+         if ( entry.plan.IsEquivalentTo( n, real, sign ) )
+         {
+            ++entry.refs;
+            entry.lastUsed = ++cache.m_tick;
+            return entry.plan;
+         }
+      Entry* entry = new Entry( n, real, sign );
+      entry->lastUsed = ++cache.m_tick;
+      cache.m_entries.Add( entry );
+      cache.Trim();
+      return entry->plan;
+   }
+
+   static void Release( const PCL_NativeFFTPlan<T>& plan )
+   {
+      PCL_NativeFFTPlanCache& cache = Instance();
+      volatile AutoLock lock( cache.m_mutex );
+      for ( Entry& entry : cache.m_entries )
+         if ( &entry.plan == &plan )
+         {
+            --entry.refs;
+            break;
+         }
+      cache.Trim();
+   }
+
+private:
+
+   enum { MaxUnusedPlans = 16 };
+
+   struct Entry
+   {
+      PCL_NativeFFTPlan<T> plan;
+      int                  refs = 1;
+      uint64               lastUsed = 0;
+
+      Entry( int n, bool real, int sign )
+         : plan( n, real, sign )
+      {
+      }
+   };
+
+   Mutex                 m_mutex;
+   ReferenceArray<Entry> m_entries;
+   uint64                m_tick = 0;
+
+   static PCL_NativeFFTPlanCache& Instance()
+   {
+      static PCL_NativeFFTPlanCache* cache = new PCL_NativeFFTPlanCache;
+      return *cache;
+   }
+
+   void Trim()
+   {
+      for ( ;; )
+      {
+         int unused = 0;
+         typename ReferenceArray<Entry>::iterator lru = m_entries.End();
+         for ( typename ReferenceArray<Entry>::iterator i = m_entries.Begin(); i != m_entries.End(); ++i )
+            if ( i->refs <= 0 )
+            {
+               ++unused;
+               if ( lru == m_entries.End() || i->lastUsed < lru->lastUsed )
+                  lru = i;
+            }
+         if ( unused <= MaxUnusedPlans )
+            break;
+         m_entries.Destroy( lru );
+      }
+   }
+};
+
+// ----------------------------------------------------------------------------
+
+/*
+ * All handles returned by FFT1DBase are pointers to PCL_FFTHandle objects,
+ * which store either a core application transform or a native transform
+ * (a PCL_NativeFFTHandleBase pointer), along with the backend it was
+ * created with.
+ */
+struct PCL_FFTHandle
+{
+   bool  native;
+   void* handle;
+};
+
+class PCL_NativeFFTHandleBase
+{
+public:
+
+   virtual ~PCL_NativeFFTHandleBase()
+   {
+   }
+};
+
+template <typename T>
+class PCL_NativeFFTHandle : public PCL_NativeFFTHandleBase
+{
+public:
+
+   const PCL_NativeFFTPlan<T>& plan;
+   GenericVector<Complex<T>>   work;
+
+   PCL_NativeFFTHandle( int n, bool real, int sign )
+      : plan( PCL_NativeFFTPlanCache<T>::Acquire( n, real, sign ) )
+   {
+      try
+      {
+         work = GenericVector<Complex<T>>( plan.WorkLength() );
+      }
+      catch ( ... )
+      {
+         PCL_NativeFFTPlanCache<T>::Release( plan );
+         throw;
+      }
+   }
+
+   ~PCL_NativeFFTHandle() override
+   {
+      PCL_NativeFFTPlanCache<T>::Release( plan );
+   }
+};
+
+static inline PCL_NativeFFTHandleBase* NativeHandleBase( void* handle )
+{
+   return static_cast<PCL_NativeFFTHandleBase*>( reinterpret_cast<PCL_FFTHandle*>( handle )->handle );
+}
+
+template <typename T>
+static inline const PCL_NativeFFTHandle<T>& NativeHandle( void* handle )
+{
+   return *static_cast<PCL_NativeFFTHandle<T>*>( NativeHandleBase( handle ) );
+}
+
+template <typename T>
+static void* NewNativeHandle( int n, bool real, int sign )
+{
+   AutoPointer<PCL_NativeFFTHandleBase> h( new PCL_NativeFFTHandle<T>( n, real, sign ) );
+   PCL_FFTHandle* handle = new PCL_FFTHandle{ true, h.Ptr() };
+   h.Release();
+   return handle;
+}
+
+static inline void* CoreHandle( void* handle )
+{
+   PCL_FFTHandle* h = reinterpret_cast<PCL_FFTHandle*>( handle );
+   return h->native ? nullptr : h->handle;
+}
+
+static void* NewCoreHandle( void* handle, const char* functionName )
+{
+   if ( handle == nullptr )
+      throw APIFunctionError( functionName );
+   return new PCL_FFTHandle{ false, handle };
+}
+
+// ----------------------------------------------------------------------------
+
+static AtomicInt s_fftBackend; // FFTBackend::Auto
+
+static bool IsCoreFFTAvailable() noexcept
+{
+   return API != nullptr && API->Numerical != nullptr && API->Numerical->FFTCreateComplexTransformF != nullptr;
+}
+
+FFTBackend::value_type SelectedFFTBackend() noexcept
+{
+   return FFTBackend::value_type( s_fftBackend.Load() );
+}
+
+void SetFFTBackend( FFTBackend::value_type backend ) noexcept
+{
+   s_fftBackend.Store( Range( int( backend ), int( FFTBackend::Auto ), int( FFTBackend::Native ) ) );
+}
+
+FFTBackend::value_type ActiveFFTBackend() noexcept
+{
+   if ( SelectedFFTBackend() != FFTBackend::Native )
+      if ( IsCoreFFTAvailable() )
+         return FFTBackend::Core;
+   return FFTBackend::Native;
+}
+
+static inline bool UseNativeFFT() noexcept
+{
+   return ActiveFFTBackend() == FFTBackend::Native;
+}
+
+/*
+ * Optimized lengths of native transforms: products of the 2, 3 and 5 factors.
+ * Real transforms require even lengths.
+ */
+static int NativeOptimizedLength( int n )
+{
+   for ( int m = Max( 1, n ); ; ++m )
+   {
+      int k = m;
+      while ( (k & 1) == 0 )
+         k >>= 1;
+      while ( k % 3 == 0 )
+         k /= 3;
+      while ( k % 5 == 0 )
+         k /= 5;
+      if ( k == 1 )
+         return m;
+   }
+}
+
+static int NativeOptimizedRealLength( int n )
+{
+   return 2*NativeOptimizedLength( (n + 1) >> 1 );
+}
+
+// ----------------------------------------------------------------------------
+
 int FFT1DBase::OptimizedLength( int n, fcomplex* )
 {
+   if ( UseNativeFFT() )
+      return NativeOptimizedLength( n );
    return int( (*API->Numerical->FFTComplexOptimizedLengthF)( n ) );
 }
 
 int FFT1DBase::OptimizedLength( int n, dcomplex* )
 {
+   if ( UseNativeFFT() )
+      return NativeOptimizedLength( n );
    return int( (*API->Numerical->FFTComplexOptimizedLengthD)( n ) );
 }
 
 int FFT1DBase::OptimizedLength( int n, float* )
 {
+   if ( UseNativeFFT() )
+      return NativeOptimizedRealLength( n );
    return int( (*API->Numerical->FFTRealOptimizedLengthF)( n ) );
 }
 
 int FFT1DBase::OptimizedLength( int n, double* )
 {
+   if ( UseNativeFFT() )
+      return NativeOptimizedRealLength( n );
    return int( (*API->Numerical->FFTRealOptimizedLengthD)( n ) );
 }
 
 void* FFT1DBase::Create( int n, fcomplex* )
 {
-   void* handle = (*API->Numerical->FFTCreateComplexTransformF)( n );
-   if ( handle == 0 )
-      throw APIFunctionError( "FFTCreateComplexTransformF" );
-   return handle;
+   if ( UseNativeFFT() )
+      return NewNativeHandle<float>( n, false, PCL_FFT_FORWARD );
+   return NewCoreHandle( (*API->Numerical->FFTCreateComplexTransformF)( n ), "FFTCreateComplexTransformF" );
 }
 
 void* FFT1DBase::Create( int n, dcomplex* )
 {
-   void* handle = (*API->Numerical->FFTCreateComplexTransformD)( n );
-   if ( handle == 0 )
-      throw APIFunctionError( "FFTCreateComplexTransformD" );
-   return handle;
+   if ( UseNativeFFT() )
+      return NewNativeHandle<double>( n, false, PCL_FFT_FORWARD );
+   return NewCoreHandle( (*API->Numerical->FFTCreateComplexTransformD)( n ), "FFTCreateComplexTransformD" );
 }
 
 void* FFT1DBase::Create( int n, float* )
 {
-   void* handle = (*API->Numerical->FFTCreateRealTransformF)( n );
-   if ( handle == 0 )
-      throw APIFunctionError( "FFTCreateRealTransformF" );
-   return handle;
+   if ( UseNativeFFT() )
+      return NewNativeHandle<float>( n, true, PCL_FFT_FORWARD );
+   return NewCoreHandle( (*API->Numerical->FFTCreateRealTransformF)( n ), "FFTCreateRealTransformF" );
 }
 
 void* FFT1DBase::Create( int n, double* )
 {
-   void* handle = (*API->Numerical->FFTCreateRealTransformD)( n );
-   if ( handle == 0 )
-      throw APIFunctionError( "FFTCreateRealTransformD" );
-   return handle;
+   if ( UseNativeFFT() )
+      return NewNativeHandle<double>( n, true, PCL_FFT_FORWARD );
+   return NewCoreHandle( (*API->Numerical->FFTCreateRealTransformD)( n ), "FFTCreateRealTransformD" );
 }
 
 void* FFT1DBase::CreateInv( int n, fcomplex* )
 {
-   void* handle = (*API->Numerical->FFTCreateComplexInverseTransformF)( n );
-   if ( handle == 0 )
-      throw APIFunctionError( "FFTCreateComplexInverseTransformF" );
-   return handle;
+   if ( UseNativeFFT() )
+      return NewNativeHandle<float>( n, false, PCL_FFT_BACKWARD );
+   return NewCoreHandle( (*API->Numerical->FFTCreateComplexInverseTransformF)( n ), "FFTCreateComplexInverseTransformF" );
 }
 
 void* FFT1DBase::CreateInv( int n, dcomplex* )
 {
-   void* handle = (*API->Numerical->FFTCreateComplexInverseTransformD)( n );
-   if ( handle == 0 )
-      throw APIFunctionError( "FFTCreateComplexInverseTransformD" );
-   return handle;
+   if ( UseNativeFFT() )
+      return NewNativeHandle<double>( n, false, PCL_FFT_BACKWARD );
+   return NewCoreHandle( (*API->Numerical->FFTCreateComplexInverseTransformD)( n ), "FFTCreateComplexInverseTransformD" );
 }
 
 void* FFT1DBase::CreateInv( int n, float* )
 {
-   void* handle = (*API->Numerical->FFTCreateRealInverseTransformF)( n );
-   if ( handle == 0 )
-      throw APIFunctionError( "FFTCreateRealInverseTransformF" );
-   return handle;
+   if ( UseNativeFFT() )
+      return NewNativeHandle<float>( n, true, PCL_FFT_BACKWARD );
+   return NewCoreHandle( (*API->Numerical->FFTCreateRealInverseTransformF)( n ), "FFTCreateRealInverseTransformF" );
 }
 
 void* FFT1DBase::CreateInv( int n, double* )
 {
-   void* handle = (*API->Numerical->FFTCreateRealInverseTransformD)( n );
-   if ( handle == 0 )
-      throw APIFunctionError( "FFTCreateRealInverseTransformD" );
-   return handle;
+   if ( UseNativeFFT() )
+      return NewNativeHandle<double>( n, true, PCL_FFT_BACKWARD );
+   return NewCoreHandle( (*API->Numerical->FFTCreateRealInverseTransformD)( n ), "FFTCreateRealInverseTransformD" );
 }
 
 void FFT1DBase::Destroy( void* handle )
 {
-   if ( (*API->Numerical->FFTDestroyTransform)( handle ) == api_false )
+   AutoPointer<PCL_FFTHandle> h( reinterpret_cast<PCL_FFTHandle*>( handle ) );
+   if ( h->native )
+      delete NativeHandleBase( handle );
+   else if ( (*API->Numerical->FFTDestroyTransform)( h->handle ) == api_false )
       throw APIFunctionError( "FFTDestroyTransform" );
 }
 
 void FFT1DBase::Transform( void* handle, fcomplex* y, const fcomplex* x )
 {
-   if ( (*API->Numerical->FFTComplexTransformF)( handle, y, x ) == api_false )
-      throw APIFunctionError( "FFTComplexTransformF" );
+   if ( void* h = CoreHandle( handle ) )
+   {
+      if ( (*API->Numerical->FFTComplexTransformF)( h, y, x ) == api_false )
+         throw APIFunctionError( "FFTComplexTransformF" );
+   }
+   else
+   {
+      const PCL_NativeFFTHandle<float>& H = NativeHandle<float>( handle );
+      H.plan.Transform( y, x, const_cast<fcomplex*>( H.work.Begin() ) );
+   }
 }
 
 void FFT1DBase::Transform( void* handle, dcomplex* y, const dcomplex* x )
 {
-   if ( (*API->Numerical->FFTComplexTransformD)( handle, y, x ) == api_false )
-      throw APIFunctionError( "FFTComplexTransformD" );
+   if ( void* h = CoreHandle( handle ) )
+   {
+      if ( (*API->Numerical->FFTComplexTransformD)( h, y, x ) == api_false )
+         throw APIFunctionError( "FFTComplexTransformD" );
+   }
+   else
+   {
+      const PCL_NativeFFTHandle<double>& H = NativeHandle<double>( handle );
+      H.plan.Transform( y, x, const_cast<dcomplex*>( H.work.Begin() ) );
+   }
 }
 
 void FFT1DBase::InverseTransform( void* handle, fcomplex* y, const fcomplex* x )
 {
-   if ( (*API->Numerical->FFTComplexInverseTransformF)( handle, y, x ) == api_false )
-      throw APIFunctionError( "FFTComplexInverseTransformF" );
+   if ( void* h = CoreHandle( handle ) )
+   {
+      if ( (*API->Numerical->FFTComplexInverseTransformF)( h, y, x ) == api_false )
+         throw APIFunctionError( "FFTComplexInverseTransformF" );
+   }
+   else
+   {
+      const PCL_NativeFFTHandle<float>& H = NativeHandle<float>( handle );
+      H.plan.Transform( y, x, const_cast<fcomplex*>( H.work.Begin() ) );
+   }
 }
 
 void FFT1DBase::InverseTransform( void* handle, dcomplex* y, const dcomplex* x )
 {
-   if ( (*API->Numerical->FFTComplexInverseTransformD)( handle, y, x ) == api_false )
-      throw APIFunctionError( "FFTComplexInverseTransformD" );
+   if ( void* h = CoreHandle( handle ) )
+   {
+      if ( (*API->Numerical->FFTComplexInverseTransformD)( h, y, x ) == api_false )
+         throw APIFunctionError( "FFTComplexInverseTransformD" );
+   }
+   else
+   {
+      const PCL_NativeFFTHandle<double>& H = NativeHandle<double>( handle );
+      H.plan.Transform( y, x, const_cast<dcomplex*>( H.work.Begin() ) );
+   }
 }
 
 void FFT1DBase::Transform( void* handle, fcomplex* y, const float* x )
 {
-   if ( (*API->Numerical->FFTRealTransformF)( handle, y, x ) == api_false )
-      throw APIFunctionError( "FFTRealTransformF" );
+   if ( void* h = CoreHandle( handle ) )
+   {
+      if ( (*API->Numerical->FFTRealTransformF)( h, y, x ) == api_false )
+         throw APIFunctionError( "FFTRealTransformF" );
+   }
+   else
+   {
+      const PCL_NativeFFTHandle<float>& H = NativeHandle<float>( handle );
+      H.plan.RealTransform( y, x, const_cast<fcomplex*>( H.work.Begin() ) );
+   }
 }
 
 void FFT1DBase::Transform( void* handle, dcomplex* y, const double* x )
 {
-   if ( (*API->Numerical->FFTRealTransformD)( handle, y, x ) == api_false )
-      throw APIFunctionError( "FFTRealTransformD" );
+   if ( void* h = CoreHandle( handle ) )
+   {
+      if ( (*API->Numerical->FFTRealTransformD)( h, y, x ) == api_false )
+         throw APIFunctionError( "FFTRealTransformD" );
+   }
+   else
+   {
+      const PCL_NativeFFTHandle<double>& H = NativeHandle<double>( handle );
+      H.plan.RealTransform( y, x, const_cast<dcomplex*>( H.work.Begin() ) );
+   }
 }
 
 void FFT1DBase::InverseTransform( void* handle, float* y, const fcomplex* x )
 {
-   if ( (*API->Numerical->FFTRealInverseTransformF)( handle, y, x ) == api_false )
-      throw APIFunctionError( "FFTRealInverseTransformF" );
+   if ( void* h = CoreHandle( handle ) )
+   {
+      if ( (*API->Numerical->FFTRealInverseTransformF)( h, y, x ) == api_false )
+         throw APIFunctionError( "FFTRealInverseTransformF" );
+   }
+   else
+   {
+      const PCL_NativeFFTHandle<float>& H = NativeHandle<float>( handle );
+      H.plan.RealInverseTransform( y, x, const_cast<fcomplex*>( H.work.Begin() ) );
+   }
 }
 
 void FFT1DBase::InverseTransform( void* handle, double* y, const dcomplex* x )
 {
-   if ( (*API->Numerical->FFTRealInverseTransformD)( handle, y, x ) == api_false )
-      throw APIFunctionError( "FFTRealInverseTransformD" );
+   if ( void* h = CoreHandle( handle ) )
+   {
+      if ( (*API->Numerical->FFTRealInverseTransformD)( h, y, x ) == api_false )
+         throw APIFunctionError( "FFTRealInverseTransformD" );
+   }
+   else
+   {
+      const PCL_NativeFFTHandle<double>& H = NativeHandle<double>( handle );
+      H.plan.RealInverseTransform( y, x, const_cast<dcomplex*>( H.work.Begin() ) );
+   }
+}
+
+// ----------------------------------------------------------------------------
+
+/*
+ * Average execution time in microseconds of a transform function, repeated
+ * for at least 50 ms after a warm-up call.
+ */
+template <class F>
+static double BenchmarkFFTFunction( F f )
+{
+   f();
+   ElapsedTime T;
+   size_type count = 0;
+   do
+   {
+      for ( int i = 0; i < 4; ++i )
+         f();
+      count += 4;
+   }
+   while ( T() < 0.05 );
+   return 1.0e+06*T()/count;
+}
+
+static double MaxRelativeDifference( const fcomplex* a, const fcomplex* b, int n )
+{
+   double dmax = 0, amax = 0;
+   for ( int i = 0; i < n; ++i )
+   {
+      dmax = Max( dmax, double( Abs( a[i] - b[i] ) ) );
+      amax = Max( amax, double( Abs( a[i] ) ) );
+   }
+   return (amax > 0) ? dmax/amax : dmax;
+}
+
+String BenchmarkFFTBackends( const Array<int>& lengths )
+{
+   Array<int> L = lengths;
+   if ( L.IsEmpty() )
+      L << 64 << 100 << 128 << 240 << 256 << 360 << 500 << 512 << 1000 << 1024 << 2048 << 2400 << 4096 << 8192;
+
+   bool core = IsCoreFFTAvailable();
+   XoShiRo256ss R( 17 );
+   String report;
+
+   for ( int n : L )
+   {
+      if ( n < 2 )
+         continue;
+
+      // Complex transforms
+      {
+         GenericVector<fcomplex> x( n ), y1( n ), y2( n );
+         for ( fcomplex& z : x )
+            z = fcomplex( float( 2*R() - 1 ), float( 2*R() - 1 ) );
+
+         PCL_NativeFFTHandle<float> H( n, false, PCL_FFT_FORWARD );
+         double tn = BenchmarkFFTFunction( [&]() { H.plan.Transform( y2.Begin(), x.Begin(), H.work.Begin() ); } );
+
+         report.AppendFormat( "%6d complex : native %10.3f us", n, tn );
+         if ( core )
+         {
+            void* h = (*API->Numerical->FFTCreateComplexTransformF)( n );
+            if ( h == nullptr )
+               throw APIFunctionError( "FFTCreateComplexTransformF" );
+            double tc = BenchmarkFFTFunction( [&]() { (*API->Numerical->FFTComplexTransformF)( h, y1.Begin(), x.Begin() ); } );
+            (*API->Numerical->FFTDestroyTransform)( h );
+            report.AppendFormat( "  core %10.3f us  native/core %6.3f  max.diff %.2e",
+                                 tc, tn/tc, MaxRelativeDifference( y1.Begin(), y2.Begin(), n ) );
+         }
+         report << '\n';
+      }
+
+      // Real transforms
+      {
+         int nr = n + (n & 1);
+         GenericVector<float> x( nr );
+         GenericVector<fcomplex> y1( nr/2 + 1 ), y2( nr/2 + 1 );
+         for ( float& f : x )
+            f = float( 2*R() - 1 );
+
+         PCL_NativeFFTHandle<float> H( nr, true, PCL_FFT_FORWARD );
+         double tn = BenchmarkFFTFunction( [&]() { H.plan.RealTransform( y2.Begin(), x.Begin(), H.work.Begin() ); } );
+
+         report.AppendFormat( "%6d real    : native %10.3f us", nr, tn );
+         if ( core )
+         {
+            void* h = (*API->Numerical->FFTCreateRealTransformF)( nr );
+            if ( h == nullptr )
+               throw APIFunctionError( "FFTCreateRealTransformF" );
+            double tc = BenchmarkFFTFunction( [&]() { (*API->Numerical->FFTRealTransformF)( h, y1.Begin(), x.Begin() ); } );
+            (*API->Numerical->FFTDestroyTransform)( h );
+            report.AppendFormat( "  core %10.3f us  native/core %6.3f  max.diff %.2e",
+                                 tc, tn/tc, MaxRelativeDifference( y1.Begin(), y2.Begin(), nr/2 + 1 ) );
+         }
+         report << '\n';
+      }
+   }
+
+   return report;
 }
 
 // ----------------------------------------------------------------------------
@@ -57,6 +57,14 @@ namespace pcl
 
 // ----------------------------------------------------------------------------
 
+/*
+ * Number of adjacent columns gathered and scattered at once by column
+ * transform threads.
+ */
+static constexpr int s_columnBlockSize = 16;
+
+// ----------------------------------------------------------------------------
+
 template <typename To, typename Ti>
 class PCL_FFT2DEngineBase
 {
@@ -98,11 +106,20 @@ protected:
 
    void RunThreads( thread_list& threads, int count )
    {
-      int n = 0;
-      for ( Thread& thread : threads )
-         thread.Start( ThreadPriority::DefaultMax, n++ );
-      for ( Thread& thread : threads )
-         thread.Wait();
+      /*
+       * A single thread runs in the calling thread. This also allows using 2-D
+       * transforms without the core application (see FFTBackend).
+       */
+      if ( threads.Length() > 1 )
+      {
+         int n = 0;
+         for ( Thread& thread : threads )
+            thread.Start( ThreadPriority::DefaultMax, n++ );
+         for ( Thread& thread : threads )
+            thread.Wait();
+      }
+      else
+         threads[0].Run();
 
       threads.Destroy();
 
@@ -229,21 +246,35 @@ private:
          void* h = (m_engine.m_dir == PCL_FFT_FORWARD) ?
                this->Create( m_engine.m_rows, (complex*)0 ) : this->CreateInv( m_engine.m_rows, (complex*)0 );
 
-         GenericVector<complex> icol( m_engine.m_rows );
-         GenericVector<complex> ocol( m_engine.m_rows );
+         // Gather and scatter blocks of adjacent columns for cache efficiency.
+         const int rows = m_engine.m_rows;
+         const int cols = m_engine.m_cols;
+         GenericVector<complex> icol( rows*s_columnBlockSize );
+         GenericVector<complex> ocol( rows*s_columnBlockSize );
 
-         for ( int j = m_firstCol; j < m_endCol; ++j )
+         for ( int j0 = m_firstCol; j0 < m_endCol; j0 += s_columnBlockSize )
          {
-            for ( int i = 0, k = j; i < m_engine.m_rows; ++i, k += m_engine.m_cols )
-               icol[i] = m_engine.m_output[k];
+            int nb = Min( s_columnBlockSize, m_endCol - j0 );
+
+            for ( int i = 0; i < rows; ++i )
+            {
+               const complex* __restrict__ r = m_engine.m_output + size_type( i )*cols + j0;
+               for ( int b = 0; b < nb; ++b )
+                  icol[b*rows + i] = r[b];
+            }
 
-            if ( m_engine.m_dir == PCL_FFT_FORWARD )
-               this->Transform( h, *ocol, *icol );
-            else
-               this->InverseTransform( h, *ocol, *icol );
+            for ( int b = 0; b < nb; ++b )
+               if ( m_engine.m_dir == PCL_FFT_FORWARD )
+                  this->Transform( h, ocol.Begin() + b*rows, icol.Begin() + b*rows );
+               else
+                  this->InverseTransform( h, ocol.Begin() + b*rows, icol.Begin() + b*rows );
 
-            for ( int i = 0, k = j; i < m_engine.m_rows; ++i, k += m_engine.m_cols )
-               m_engine.m_output[k] = ocol[i];
+            for ( int i = 0; i < rows; ++i )
+            {
+               complex* __restrict__ r = m_engine.m_output + size_type( i )*cols + j0;
+               for ( int b = 0; b < nb; ++b )
+                  r[b] = ocol[b*rows + i];
+            }
          }
 
          this->Destroy( h );
@@ -365,18 +396,32 @@ private:
       {
          void* h = this->Create( m_engine.m_rows, (complex*)0 );
 
-         GenericVector<complex> icol( m_engine.m_rows );
-         GenericVector<complex> ocol( m_engine.m_rows );
+         // Gather and scatter blocks of adjacent columns for cache efficiency.
+         const int rows = m_engine.m_rows;
+         const int cols = m_engine.m_transformCols;
+         GenericVector<complex> icol( rows*s_columnBlockSize );
+         GenericVector<complex> ocol( rows*s_columnBlockSize );
 
-         for ( int j = m_firstCol; j < m_endCol; ++j )
+         for ( int j0 = m_firstCol; j0 < m_endCol; j0 += s_columnBlockSize )
          {
-            for ( int i = 0, k = j; i < m_engine.m_rows; ++i, k += m_engine.m_transformCols )
-               icol[i] = m_engine.m_output[k];
+            int nb = Min( s_columnBlockSize, m_endCol - j0 );
+
+            for ( int i = 0; i < rows; ++i )
+            {
+               const complex* __restrict__ r = m_engine.m_output + size_type( i )*cols + j0;
+               for ( int b = 0; b < nb; ++b )
+                  icol[b*rows + i] = r[b];
+            }
 
-            this->Transform( h, *ocol, *icol );
+            for ( int b = 0; b < nb; ++b )
+               this->Transform( h, ocol.Begin() + b*rows, icol.Begin() + b*rows );
 
-            for ( int i = 0, k = j; i < m_engine.m_rows; ++i, k += m_engine.m_transformCols )
-               m_engine.m_output[k] = ocol[i];
+            for ( int i = 0; i < rows; ++i )
+            {
+               complex* __restrict__ r = m_engine.m_output + size_type( i )*cols + j0;
+               for ( int b = 0; b < nb; ++b )
+                  r[b] = ocol[b*rows + i];
+            }
          }
 
          this->Destroy( h );
@@ -449,18 +494,32 @@ private:
       {
          void* h = this->CreateInv( m_engine.m_rows, (complex*)0 );
 
-         GenericVector<complex> icol( m_engine.m_rows );
-         GenericVector<complex> ocol( m_engine.m_rows );
+         // Gather and scatter blocks of adjacent columns for cache efficiency.
+         const int rows = m_engine.m_rows;
+         const int cols = m_engine.m_transformCols;
+         GenericVector<complex> icol( rows*s_columnBlockSize );
+         GenericVector<complex> ocol( rows*s_columnBlockSize );
 
-         for ( int j = m_firstCol; j < m_endCol; ++j )
+         for ( int j0 = m_firstCol; j0 < m_endCol; j0 += s_columnBlockSize )
          {
-            for ( int i = 0, k = j; i < m_engine.m_rows; ++i, k += m_engine.m_transformCols )
-               icol[i] = m_engine.m_input[k];
+            int nb = Min( s_columnBlockSize, m_endCol - j0 );
+
+            for ( int i = 0; i < rows; ++i )
+            {
+               const complex* __restrict__ r = m_engine.m_input + size_type( i )*cols + j0;
+               for ( int b = 0; b < nb; ++b )
+                  icol[b*rows + i] = r[b];
+            }
 
-            this->InverseTransform( h, *ocol, *icol );
+            for ( int b = 0; b < nb; ++b )
+               this->InverseTransform( h, ocol.Begin() + b*rows, icol.Begin() + b*rows );
 
-            for ( int i = 0; i < m_engine.m_rows; ++i )
-               m_engine.m_colTransform[i][j] = ocol[i];
+            for ( int i = 0; i < rows; ++i )
+            {
+               complex* __restrict__ r = m_engine.m_colTransform[i] + j0;
+               for ( int b = 0; b < nb; ++b )
+                  r[b] = ocol[b*rows + i];
+            }
          }
 
          this->Destroy( h );
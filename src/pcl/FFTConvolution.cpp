@@ -49,8 +49,12 @@
 // POSSIBILITY OF SUCH DAMAGE.
 // ----------------------------------------------------------------------------
 
+#include <pcl/AutoLock.h>
+#include <pcl/FFT2D.h>
 #include <pcl/FFTConvolution.h>
 #include <pcl/FourierTransform.h>
+#include <pcl/MetaModule.h>
+#include <pcl/SIMDDispatch.h>
 
 namespace pcl
 {
@@ -65,93 +69,18 @@ void __pcl_cconv( C* __restrict__ x, const C* __restrict__ y, T k, size_type N )
       x[i] *= k * y[i];
 }
 
-#ifdef __PCL_AVX2
-
 inline static
 void __pcl_cconv( fcomplex* __restrict__ x, const fcomplex* __restrict__ y, float k, size_type N )
 {
-   size_type nf = N << 1;
-   const size_type n8 = nf >> 3;
-   const __m256 r = _mm256_set1_ps( k );
-   size_type i;
-
-   if ( ((ptrdiff_t)x) & 31 || ((ptrdiff_t)y) & 31 )
-      for ( i = 0; i < n8; ++i )
-      {
-         __m256 a = _mm256_loadu_ps( (const float* __restrict__)(x + i*8) );
-         __m256 b = _mm256_loadu_ps( (const float* __restrict__)(y + i*8) );
-         __m256 b_swap = _mm256_shuffle_ps( b, b, 0xb1 );
-         __m256 a_im = _mm256_shuffle_ps( a, a, 0xf5 );
-         __m256 a_re = _mm256_shuffle_ps( a, a, 0xa0 );
-         __m256 a_im_b_swap = _mm256_mul_ps( a_im, b_swap );
-         __m256 k_y = _mm256_fmaddsub_ps( a_re, b, a_im_b_swap );
-         _mm256_storeu_ps( (float* __restrict__)(x + (i << 3)), _mm256_mul_ps( r, k_y ) );
-      }
-   else
-      for ( i = 0; i < n8; ++i )
-      {
-         __m256 a = ((const __m256* __restrict__)x)[i];
-         __m256 b = ((const __m256* __restrict__)y)[i];
-         __m256 b_swap = _mm256_shuffle_ps( b, b, 0xb1 );
-         __m256 a_im = _mm256_shuffle_ps( a, a, 0xf5 );
-         __m256 a_re = _mm256_shuffle_ps( a, a, 0xa0 );
-         __m256 a_im_b_swap = _mm256_mul_ps( a_im, b_swap );
-         __m256 k_y = _mm256_fmaddsub_ps( a_re, b, a_im_b_swap );
-         ((__m256* __restrict__)x)[i] = _mm256_mul_ps( r, k_y );
-      }
-
-   switch ( N % 4 )
-   {
-   case 3:
-      x[N-3] *= k * y[N-3];
-   case 2:
-      x[N-2] *= k * y[N-2];
-   case 1:
-      x[N-1] *= k * y[N-1];
-   default:
-      break;
-   }
+   SIMD::MultiplyComplex( x, y, k, N );
 }
 
 inline static
 void __pcl_cconv( complex* __restrict__ x, const complex* __restrict__ y, double k, size_type N )
 {
-   size_type nd = N << 1;
-   const size_type n4 = nd >> 2;
-   const __m256d r = _mm256_set1_pd( k );
-   size_type i;
-
-   if ( ((ptrdiff_t)x) & 31 || ((ptrdiff_t)y) & 31 )
-      for ( i = 0; i < n4; ++i )
-      {
-         __m256d a = _mm256_loadu_pd( (const double* __restrict__)(x + i*4) );
-         __m256d b = _mm256_loadu_pd( (const double* __restrict__)(y + i*4) );
-         __m256d b_swap = _mm256_shuffle_pd( b, b, 5 );
-         __m256d a_im = _mm256_shuffle_pd( a, a, 15 );
-         __m256d a_re = _mm256_shuffle_pd( a, a, 0 );
-         __m256d a_im_b_swap = _mm256_mul_pd( a_im, b_swap );
-         __m256d k_y = _mm256_fmaddsub_pd( a_re, b, a_im_b_swap );
-         _mm256_storeu_pd( (double* __restrict__)(x + (i << 2)), _mm256_mul_pd( r, k_y ) );
-      }
-   else
-      for ( i = 0; i < n4; ++i )
-      {
-         __m256d a = ((const __m256d* __restrict__)x)[i];
-         __m256d b = ((const __m256d* __restrict__)y)[i];
-         __m256d b_swap = _mm256_shuffle_pd( b, b, 5 );
-         __m256d a_im = _mm256_shuffle_pd( a, a, 15 );
-         __m256d a_re = _mm256_shuffle_pd( a, a, 0 );
-         __m256d a_im_b_swap = _mm256_mul_pd( a_im, b_swap );
-         __m256d k_y = _mm256_fmaddsub_pd( a_re, b, a_im_b_swap );
-         ((__m256d* __restrict__)x)[i] = _mm256_mul_pd( r, k_y );
-      }
-
-   if ( N & 1 )
-      x[N-1] *= k * y[N-1];
+   SIMD::MultiplyComplex( x, y, k, N );
 }
 
-#endif
-
 // ----------------------------------------------------------------------------
 
 class PCL_FFTConvolutionEngine
@@ -161,6 +90,14 @@ public:
    template <class P>
    static void Apply( GenericImage<P>& image, const FFTConvolution& F )
    {
+      if ( F.m_tiled )
+         if ( !P::IsComplexSample() )
+            if ( F.m_filter || !F.m_image.IsComplexSample() )
+            {
+               ApplyTiled( image, F );
+               return;
+            }
+
       if ( !F.m_h )
       {
          Rect r = image.SelectedRectangle();
@@ -175,6 +112,384 @@ public:
 
 private:
 
+   /*
+    * Tiled convolution with real-to-complex FFTs by the overlap-save method.
+    */
+   template <class P>
+   static void ApplyTiled( GenericImage<P>& image, const FFTConvolution& F )
+   {
+      int nx, ny;
+      if ( F.m_filter )
+         nx = ny = F.m_filter->Size();
+      else
+      {
+         nx = F.m_image->Width();
+         ny = F.m_image->Height();
+      }
+
+      Rect r = image.SelectedRectangle();
+      int L = (F.m_tileSize > 0) ? F.m_tileSize : AutoTileSize( F, nx, r );
+      int w = TileLength( L, nx, r.Width() );
+      int h = TileLength( L, ny, r.Height() );
+
+      if ( !F.m_hTile || F.m_hTileWidth != w || F.m_hTile->Height() != h )
+      {
+         F.m_hTile.Destroy();
+         if ( F.m_filter )
+            F.m_hTile = InitializeTiled( *F.m_filter, w, h, F.IsParallelProcessingEnabled(), F.MaxProcessors() );
+         else
+            F.m_hTile = InitializeTiled( F.m_image, w, h, F.IsParallelProcessingEnabled(), F.MaxProcessors() );
+         F.m_hTileWidth = w;
+      }
+
+      ConvolveTiled( image, *F.m_hTile, w, nx, ny, F.IsRealComponentOutputEnabled(), F.IsParallelProcessingEnabled(), F.MaxProcessors() );
+   }
+
+   /*
+    * Nominal tile size for the working memory budget of F. For square tiles
+    * of size L and T threads we allocate about 12*L^2 bytes per thread (real
+    * tile, Hermitian DFT and FFT workspace), 4*L^2 bytes for the DFT of the
+    * response function, and 8*L*width bytes for two strips of convolved
+    * tiles. The size is also limited to the width required for T tiles per
+    * strip, so all threads can work on each strip.
+    */
+   static int AutoTileSize( const FFTConvolution& F, int nx, const Rect& r )
+   {
+      int numberOfThreads = F.IsParallelProcessingEnabled() ? Thread::NumberOfThreads( F.MaxProcessors() ) : 1;
+
+      double budget = double( F.m_tileMemory );
+      if ( budget <= 0 )
+      {
+         budget = 0.25*Module->AvailablePhysicalMemory();
+         if ( budget <= 0 )
+            budget = double( size_type( 1 ) << 30 );
+      }
+
+      double a = 12.0*numberOfThreads + 4;
+      double b = 8.0*r.Width();
+      double L = (Sqrt( b*b + 4*a*budget ) - b)/(2*a);
+
+      return Max( 2*nx, TruncInt( Min( L, double( (r.Width() + numberOfThreads - 1)/numberOfThreads + nx - 1 ) ) ) );
+   }
+
+   /*
+    * Tile length for a filter of size n and an image of the specified size.
+    * Real FFT lengths must be even.
+    */
+   static int TileLength( int L, int n, int size )
+   {
+      return FRealFFT::OptimizedLength( Min( Max( L, n << 1 ), size + n ) );
+   }
+
+   template <class P>
+   struct TileThreadData : public AbstractImage::ThreadData
+   {
+      TileThreadData( const GenericImage<P>& a_image, const ComplexImage& a_psfFFT, int a_w, int a_nx, int a_ny )
+         : image( a_image )
+         , psfFFT( a_psfFFT )
+         , r( a_image.SelectedRectangle() )
+         , w( a_w )
+         , h( a_psfFFT.Height() )
+         , nx( a_nx )
+         , ny( a_ny )
+         , tw( a_w - a_nx + 1 )
+         , th( a_psfFFT.Height() - a_ny + 1 )
+      {
+      }
+
+      const GenericImage<P>& image;
+      const ComplexImage&    psfFFT;
+            Rect             r;          // target rectangle
+            int              w, h;       // tile dimensions
+            int              nx, ny;     // filter dimensions
+            int              tw, th;     // dimensions of valid convolved tile regions
+            int              channel;    // current channel
+            int              y0;         // current strip, top row relative to r
+            int              rows;       // current strip height
+            FMatrix*         strip;      // current convolved strip
+   };
+
+   /*
+    * Working buffers of a tile convolution thread.
+    */
+   struct TileBuffers
+   {
+      FMatrix   tile;
+      C32Vector dft;
+
+      TileBuffers( int w, int h )
+         : tile( h, w )
+         , dft( h*(w/2 + 1) )
+      {
+      }
+   };
+
+   template <class P>
+   class TileThread : public Thread
+   {
+   public:
+
+      TileThread( TileThreadData<P>& data, TileBuffers& buffers, int startTile, int endTile )
+         : m_data( data )
+         , m_buffers( buffers )
+         , m_startTile( startTile )
+         , m_endTile( endTile )
+      {
+      }
+
+      PCL_HOT_FUNCTION void Run() override
+      {
+         const int w = m_data.w;
+         const int h = m_data.h;
+         const int width = m_data.r.Width();
+         const int height = m_data.r.Height();
+         const int mx = m_data.nx - 1 - (m_data.nx >> 1); // left/top filter margins
+         const int my = m_data.ny - 1 - (m_data.ny >> 1);
+         const int rows = m_data.rows;
+         const int inRows = rows + m_data.ny - 1;
+         const float k = 1.0F/w/h; // FFT scaling factor
+
+         FRealFFT2D fft( h, w );
+         fft.DisableParallelProcessing();
+
+         IVector x( w );
+
+         for ( int t = m_startTile; t < m_endTile; ++t )
+         {
+            /*
+             * Gather the tile and its filter margins, mirroring at image
+             * boundaries (Neumann boundary conditions). Pixels beyond the
+             * margins of the valid tile region do not contribute to the
+             * result and are set to zero.
+             */
+            int x0 = t*m_data.tw;
+            int cols = Min( m_data.tw, width - x0 );
+            int inCols = cols + m_data.nx - 1;
+            for ( int i = 0; i < inCols; ++i )
+               x[i] = m_data.r.x0 + Reflect( x0 - mx + i, width );
+
+            float* __restrict__ b = m_buffers.tile.Begin();
+            for ( int j = 0; j < inRows; ++j )
+            {
+               const typename P::sample* __restrict__ s =
+                  m_data.image.ScanLine( m_data.r.y0 + Reflect( m_data.y0 - my + j, height ), m_data.channel );
+               int i = 0;
+               for ( ; i < inCols; ++i )
+                  P::FromSample( *b++, s[x[i]] );
+               for ( ; i < w; ++i )
+                  *b++ = 0;
+            }
+            for ( int j = inRows; j < h; ++j )
+               for ( int i = 0; i < w; ++i )
+                  *b++ = 0;
+
+            /*
+             * Circular convolution of the tile.
+             */
+            fft( m_buffers.dft.Begin(), m_buffers.tile.Begin() );
+            __pcl_cconv( m_buffers.dft.Begin(), *m_data.psfFFT, k, size_type( m_buffers.dft.Length() ) );
+            fft( m_buffers.tile.Begin(), m_buffers.dft.Begin() );
+
+            /*
+             * Store the valid region of the convolved tile.
+             */
+            for ( int j = 0; j < rows; ++j )
+            {
+               const float* __restrict__ c = m_buffers.tile[my + j] + mx;
+               float* __restrict__ o = (*m_data.strip)[j] + x0;
+               for ( int i = 0; i < cols; ++i )
+                  o[i] = c[i];
+            }
+
+            if ( m_data.numThreads > 1 )
+            {
+               if ( TryIsAborted() )
+                  return;
+               volatile AutoLock lock( m_data.mutex );
+               m_data.count += size_type( cols )*size_type( rows );
+            }
+            else
+               m_data.status += size_type( cols )*size_type( rows );
+         }
+      }
+
+   private:
+
+      TileThreadData<P>& m_data;
+      TileBuffers&       m_buffers;
+      int                m_startTile;
+      int                m_endTile;
+
+      /*
+       * Index of a pixel coordinate mirrored at the boundaries of [0,n), with
+       * the same boundary conditions as the untiled implementation: whole
+       * sample symmetry at the origin and half sample symmetry at n.
+       */
+      static int Reflect( int i, int n )
+      {
+         for ( ;; )
+            if ( i < 0 )
+               i = -i;
+            else if ( i >= n )
+               i = 2*n - 1 - i;
+            else
+               return i;
+      }
+   };
+
+   template <class P>
+   static void ConvolveTiled( GenericImage<P>& image, const ComplexImage& psfFFT, int w, int nx, int ny,
+                              bool outputRealCmp, bool parallel, int maxProcessors )
+   {
+      Rect r = image.SelectedRectangle();
+
+      int ch0 = image.FirstSelectedChannel();
+      int ch1 = image.LastSelectedChannel();
+
+      TileThreadData<P> data( image, psfFFT, w, nx, ny );
+
+      int numberOfTiles = (r.Width() + data.tw - 1)/data.tw;
+      int numberOfStrips = (r.Height() + data.th - 1)/data.th;
+
+      Array<size_type> L = Thread::OptimalThreadLoads( numberOfTiles, 1/*overheadLimit*/, parallel ? maxProcessors : 1 );
+      int numberOfThreads = int( L.Length() );
+
+      ReferenceArray<TileBuffers> buffers;
+      for ( int i = 0; i < numberOfThreads; ++i )
+         buffers.Add( new TileBuffers( w, data.h ) );
+
+      /*
+       * Convolved strips. Each strip of tiles is written back to the image
+       * after convolving the next strip, since the latter reads input pixels
+       * from the former.
+       */
+      FMatrix strips[ 2 ] = { FMatrix( data.th, r.Width() ), FMatrix( data.th, r.Width() ) };
+
+      bool statusInitialized = false;
+      if ( image.Status().IsInitializationEnabled() )
+      {
+         image.Status().Initialize( "Convolution (FFT, tiled)", image.NumberOfSelectedSamples() );
+         image.Status().DisableInitialization();
+         statusInitialized = true;
+      }
+
+      try
+      {
+         for ( int ch = ch0; ch <= ch1; ++ch )
+         {
+            data.channel = ch;
+
+            for ( int s = 0; s <= numberOfStrips; ++s )
+            {
+               if ( s < numberOfStrips )
+               {
+                  data.y0 = s*data.th;
+                  data.rows = Min( data.th, r.Height() - data.y0 );
+                  data.strip = strips + (s & 1);
+                  data.status = image.Status();
+                  data.total = size_type( r.Width() )*size_type( data.rows );
+                  data.count = 0;
+
+                  ReferenceArray<TileThread<P> > threads;
+                  for ( int i = 0, n = 0; i < numberOfThreads; n += int( L[i++] ) )
+                     threads.Add( new TileThread<P>( data, buffers[i], n, n + int( L[i] ) ) );
+
+                  AbstractImage::RunThreads( threads, data );
+                  threads.Destroy();
+
+                  image.Status() = data.status;
+               }
+
+               if ( s > 0 )
+               {
+                  const FMatrix& strip = strips[(s - 1) & 1];
+                  int y0 = (s - 1)*data.th;
+                  int rows = Min( data.th, r.Height() - y0 );
+                  for ( int j = 0; j < rows; ++j )
+                  {
+                     const float* __restrict__ c = strip[j];
+                     typename P::sample* __restrict__ o = image.ScanLine( r.y0 + y0 + j, ch ) + r.x0;
+                     if ( outputRealCmp )
+                        for ( int i = 0; i < r.Width(); ++i )
+                           o[i] = P::ToSample( c[i] );
+                     else
+                        for ( int i = 0; i < r.Width(); ++i )
+                           o[i] = P::ToSample( Abs( c[i] ) );
+                  }
+               }
+            }
+         }
+
+         if ( statusInitialized )
+            image.Status().EnableInitialization();
+      }
+      catch ( ... )
+      {
+         if ( statusInitialized )
+            image.Status().EnableInitialization();
+         throw;
+      }
+   }
+
+   static ComplexImage* InitializeTiled( const KernelFilter& PSF, int w, int h, bool parallel, int maxProcessors )
+   {
+      PCL_CHECK( !PSF.IsEmpty() )
+
+      int n = PSF.Size();
+      if ( n == 0 )
+         throw Error( "Attempt to perform an FFT-based convolution with an empty kernel filter." );
+
+      Image psf( w, h );
+      psf.Zero();
+
+      double k = PSF.Weight();
+      if ( 1 + k == 1 )
+         k = 1;
+      else
+         k = 1/k;
+      if ( IsFinite( k ) && 1 + k != 1 )
+         GetWrapAroundNormalizedPSF( psf, PSF, k );
+
+      return RealDFT( psf, parallel, maxProcessors );
+   }
+
+   static ComplexImage* InitializeTiled( const ImageVariant& PSF, int w, int h, bool parallel, int maxProcessors )
+   {
+      if ( !PSF || PSF->IsEmpty() )
+         throw Error( "Attempt to perform an FFT-based convolution with an empty response function image." );
+
+      Image psf( w, h );
+      psf.Zero();
+
+      if ( PSF.IsFloatSample() )
+         switch ( PSF.BitsPerSample() )
+         {
+         case 32: GetWrapAroundNormalizedPSF( psf, static_cast<const Image&>( *PSF ) ); break;
+         case 64: GetWrapAroundNormalizedPSF( psf, static_cast<const DImage&>( *PSF ) ); break;
+         }
+      else
+         switch ( PSF.BitsPerSample() )
+         {
+         case  8: GetWrapAroundNormalizedPSF( psf, static_cast<const UInt8Image&>( *PSF ) ); break;
+         case 16: GetWrapAroundNormalizedPSF( psf, static_cast<const UInt16Image&>( *PSF ) ); break;
+         case 32: GetWrapAroundNormalizedPSF( psf, static_cast<const UInt32Image&>( *PSF ) ); break;
+         }
+
+      return RealDFT( psf, parallel, maxProcessors );
+   }
+
+   /*
+    * Hermitian half of the DFT of a real wrapped-around PSF.
+    */
+   static ComplexImage* RealDFT( const Image& psf, bool parallel, int maxProcessors )
+   {
+      ComplexImage* psfFFT = new ComplexImage( psf.Width()/2 + 1, psf.Height() );
+      FRealFFT2D fft( psf.Height(), psf.Width() );
+      fft.EnableParallelProcessing( parallel, maxProcessors );
+      fft( **psfFFT, *psf );
+      return psfFFT;
+   }
+
    template <class P>
    static void Convolve( GenericImage<P>& image, const ComplexImage& psfFFT, bool outputRealCmp, bool parallel, int maxProcessors )
    {
@@ -354,32 +669,41 @@ private:
       /*
        * Normalize PSF and store it in wrap-around order.
        */
+      GetWrapAroundNormalizedPSF( *psfFFT, PSF, k );
+
+      /*
+       * Calculate the DFT of the wrap-around normalized PSF.
+       */
+      InPlaceFourierTransform FFT;
+      FFT.EnableParallelProcessing( parallel, maxProcessors );
+      FFT >> *psfFFT;
+
+      return psfFFT;
+   }
+
+   template <class T>
+   static void GetWrapAroundNormalizedPSF( GenericImage<T>& psf, const KernelFilter& PSF, double k )
+   {
+      int w  = psf.Width();
+      int h  = psf.Height();
+      int n  = PSF.Size();
       int n2 = n >> 1;
       // 1st quadrant -> 3rd
       for ( int sy = 0, ty = h-n2; sy < n2; ++sy, ++ty )
          for ( int sx = n2, tx = 0; sx < n; ++sx, ++tx )
-            (*psfFFT)( tx, ty ) = k*PSF[sy][sx];
+            psf( tx, ty ) = k*PSF[sy][sx];
       // 2nd quadrant -> 4th
       for ( int sy = 0, ty = h-n2; sy < n2; ++sy, ++ty )
          for ( int sx = 0, tx = w-n2; sx < n2; ++sx, ++tx )
-            (*psfFFT)( tx, ty ) = k*PSF[sy][sx];
+            psf( tx, ty ) = k*PSF[sy][sx];
       // 3rd quadrant -> 1st
       for ( int sy = n2, ty = 0; sy < n; ++sy, ++ty )
          for ( int sx = 0, tx = w-n2; sx < n2; ++sx, ++tx )
-            (*psfFFT)( tx, ty ) = k*PSF[sy][sx];
+            psf( tx, ty ) = k*PSF[sy][sx];
       // 4th quadrant -> 2nd
       for ( int sy = n2, ty = 0; sy < n; ++sy, ++ty )
          for ( int sx = n2, tx = 0; sx < n; ++sx, ++tx )
-            (*psfFFT)( tx, ty ) = k*PSF[sy][sx];
-
-      /*
-       * Calculate the DFT of the wrap-around normalized PSF.
-       */
-      InPlaceFourierTransform FFT;
-      FFT.EnableParallelProcessing( parallel, maxProcessors );
-      FFT >> *psfFFT;
-
-      return psfFFT;
+            psf( tx, ty ) = k*PSF[sy][sx];
    }
 
    template <class P>
@@ -413,8 +737,8 @@ private:
       return 1/k;
    }
 
-   template <class P>
-   static void GetWrapAroundNormalizedPSF( ComplexImage& psfFFT, const GenericImage<P>& PSF )
+   template <class T, class P>
+   static void GetWrapAroundNormalizedPSF( GenericImage<T>& psfFFT, const GenericImage<P>& PSF )
    {
       /*
        * Normalization factor: The sum of response function elements must be
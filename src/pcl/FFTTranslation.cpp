@@ -49,8 +49,13 @@
 // POSSIBILITY OF SUCH DAMAGE.
 // ----------------------------------------------------------------------------
 
+#include <pcl/AutoLock.h>
+#include <pcl/AutoPointer.h>
+#include <pcl/FFT2D.h>
 #include <pcl/FFTRegistration.h>
 #include <pcl/FourierTransform.h>
+#include <pcl/StringList.h>
+#include <pcl/Thread.h>
 
 namespace pcl
 {
@@ -117,62 +122,419 @@ public:
          // Normalized real PCM or CPSM
          R.Rescale();                                 //*** status += size*size
 
-         // We interpolate the coordinates of the maximum peak in the pase matrix
-         // from a square neighborhood of nine pixels centered at the maximum
-         // location.
+         // Interpolate the coordinates of the maximum peak and obtain
+         // displacements in the correct directions.
+         InterpolatePeak( delta, p, size, [&R]( int x, int y ) { return R.Pixel( x, y ); } );
 
-         Point p0( (p.x > 0) ? p.x-1 : size-1, (p.y > 0) ? p.y-1 : size-1 );
-         Point p1( (p.x < size-1) ? p.x+1 : 0, (p.y < size-1) ? p.y+1 : 0 );
+         image.Status() = R.Status();
 
-         float f00 = 0.7071*R.Pixel( p0.x, p0.y );
-         float f01 =        R.Pixel( p.x,  p0.y );
-         float f02 = 0.7071*R.Pixel( p1.x, p0.y );
+         if ( initializationEnabled )
+            image.Status().EnableInitialization();
+      }
+      catch ( ... )
+      {
+         if ( initializationEnabled )
+            image.Status().EnableInitialization();
+         throw;
+      }
+   }
 
-         float f10 =        R.Pixel( p0.x, p.y  );
-      //float f11 =      0*R.Pixel( p.x,  p.y  ); // = 1 due to normalization of sample values
-         float f12 =        R.Pixel( p1.x, p.y  );
+   /*
+    * Reference initialization for coarse-to-fine evaluation. Returns the DFT
+    * of the binned reference image, or the full-resolution DFT if the image
+    * is too small for the requested number of pyramid levels.
+    */
+   template <class P>
+   static ComplexImage InitializePyramid( FFTTranslation& E, const GenericImage<P>& image )
+   {
+      E.m_pyramidFactor = 0;
+      E.m_referenceWindow = 0;
+      E.m_fftWindowReference.FreeData();
 
-         float f20 = 0.7071*R.Pixel( p0.x, p1.y );
-         float f21 =        R.Pixel( p.x,  p1.y );
-         float f22 = 0.7071*R.Pixel( p1.x, p1.y );
+      Rect r = image.SelectedRectangle();
+      int w = r.Width();
+      int h = r.Height();
+
+      // Binned images smaller than 16 pixels make no sense for registration.
+      int f = 1 << E.m_pyramidLevels;
+      while ( f > 1 && Min( w, h )/f < 16 )
+         f >>= 1;
+      if ( f < 2 )
+         return Initialize( image, E.m_largeTranslations );
+
+      int size = Max( w/f, h/f );
+      if ( E.m_largeTranslations )
+         size <<= 1;
+      ComplexImage C = Transform( image, r, f, FFT2D::OptimizedLength( size ) );
+
+      // Centered refinement window, full resolution.
+      int n = (E.m_refinementSize > 0) ? E.m_refinementSize : Max( 64, Max( w, h ) >> 2 );
+      int ww = Min( n, w );
+      int hw = Min( n, h );
+      E.m_referenceWindow = Rect( ww, hw ).MovedBy( (w - ww) >> 1, (h - hw) >> 1 );
+      E.m_fftWindowReference = Transform( image, E.m_referenceWindow.MovedBy( r.LeftTop() ), 1,
+                                          FFT2D::OptimizedLength( Max( ww, hw ) ) );
+      E.m_pyramidFactor = f;
+      return C;
+   }
 
-         image.Status() = R.Status();
+   /*
+    * Working matrix and FFT object, reused for successive evaluations.
+    */
+   struct Workspace
+   {
+      int                     size = 0;
+      GenericVector<fcomplex> C;
+      AutoPointer<FFT2D>      F;
+      bool                    parallel;
+      int                     maxProcessors;
+
+      Workspace( bool a_parallel = true, int a_maxProcessors = PCL_MAX_PROCESSORS )
+         : parallel( a_parallel )
+         , maxProcessors( a_maxProcessors )
+      {
+      }
 
-         R.FreeData();  // R no longer needed
+      void Resize( int n )
+      {
+         if ( n != size )
+         {
+            C = GenericVector<fcomplex>( n*n );
+            F = new FFT2D( n, n );
+            F->EnableParallelProcessing( parallel, maxProcessors );
+            size = n;
+         }
+      }
+   };
 
-         // Interpolate horizontal and vertical shifts.
-         delta.x = p.x - f00 - f10 - f20 + f02 + f12 + f22;
-         delta.y = p.y - f00 - f01 - f02 + f20 + f21 + f22;
+   /*
+    * Evaluation of a target image, reusing the specified workspaces. Wc is
+    * used for full-resolution or coarse evaluations; Wf for refinement.
+    */
+   template <class P>
+   static void Evaluate( FFTTranslation::Result& result, const GenericImage<P>& image, const FFTTranslation& E,
+                         Workspace& Wc, Workspace& Wf )
+   {
+      Rect r = image.SelectedRectangle();
 
-         // Obtain displacements in the correct directions.
-         //
-         // If an x or y coordinate is greater than the actual working space,
-         // (size/2), then it corresponds to a negative displacement.
-         //
-         // Remember that for this to work with large displacements >= size/2 in
-         // absolute value, the working size has to be doubled.
+      if ( E.m_pyramidFactor < 2 )
+      {
+         Wc.Resize( E.m_fftReference.Width() );
+         Load( *Wc.C, Wc.size, image, r, 1 );
+         Correlate( result.delta, result.peak, Wc, *E.m_fftReference );
+         return;
+      }
 
-         if ( delta.x >= size/2 )
-            delta.x -= size;
-         if ( delta.y >= size/2 )
-            delta.y -= size;
+      // Coarse estimate from binned images.
+      int f = E.m_pyramidFactor;
+      Wc.Resize( E.m_fftReference.Width() );
+      Load( *Wc.C, Wc.size, image, r, f );
+      FPoint dc;
+      float pc;
+      Correlate( dc, pc, Wc, *E.m_fftReference );
+      Point d0( RoundInt( dc.x*f ), RoundInt( dc.y*f ) );
+
+      // Refinement at full resolution on the coarsely registered window.
+      Wf.Resize( E.m_fftWindowReference.Width() );
+      Load( *Wf.C, Wf.size, image, E.m_referenceWindow.MovedBy( r.x0 - d0.x, r.y0 - d0.y ), 1 );
+      FPoint df;
+      Correlate( df, result.peak, Wf, *E.m_fftWindowReference );
+
+      result.delta.x = Round( d0.x + df.x, 2 );
+      result.delta.y = Round( d0.y + df.y, 2 );
+   }
 
-         delta.x = Round( delta.x, 2 );
-         delta.y = Round( delta.y, 2 );
+   template <class P>
+   static void EvaluatePyramid( FPoint& delta, float& peak, const GenericImage<P>& image, const FFTTranslation& E )
+   {
+      Workspace Wc, Wf;
+      FFTTranslation::Result result;
+      Evaluate( result, image, E, Wc, Wf );
+      delta = result.delta;
+      peak = result.peak;
+   }
 
-         if ( initializationEnabled )
-            image.Status().EnableInitialization();
+   static void Evaluate( FFTTranslation::Result& result, const ImageVariant& image, const FFTTranslation& E,
+                         Workspace& Wc, Workspace& Wf )
+   {
+      if ( image )
+         if ( image.IsComplexSample() )
+            switch ( image.BitsPerSample() )
+            {
+            case 32: Evaluate( result, static_cast<const ComplexImage&>( *image ), E, Wc, Wf ); break;
+            case 64: Evaluate( result, static_cast<const DComplexImage&>( *image ), E, Wc, Wf ); break;
+            }
+         else if ( image.IsFloatSample() )
+            switch ( image.BitsPerSample() )
+            {
+            case 32: Evaluate( result, static_cast<const Image&>( *image ), E, Wc, Wf ); break;
+            case 64: Evaluate( result, static_cast<const DImage&>( *image ), E, Wc, Wf ); break;
+            }
+         else
+            switch ( image.BitsPerSample() )
+            {
+            case  8: Evaluate( result, static_cast<const UInt8Image&>( *image ), E, Wc, Wf ); break;
+            case 16: Evaluate( result, static_cast<const UInt16Image&>( *image ), E, Wc, Wf ); break;
+            case 32: Evaluate( result, static_cast<const UInt32Image&>( *image ), E, Wc, Wf ); break;
+            }
+   }
+
+   static FFTTranslation::result_list EvaluateBatch( const FFTTranslation& E, const Array<ImageVariant>& images,
+                                                     bool parallel, int maxProcessors )
+   {
+      if ( !E.IsInitialized() )
+         throw Error( "FFTTranslation::EvaluateBatch(): Uninitialized registration engine." );
+
+      FFTTranslation::result_list results( images.Length() );
+      if ( images.IsEmpty() )
+         return results;
+
+      Array<size_type> L = Thread::OptimalThreadLoads( images.Length(), 1/*overheadLimit*/, parallel ? maxProcessors : 1 );
+      ReferenceArray<BatchThread> threads;
+      for ( size_type i = 0, n = 0; i < L.Length(); n += L[i++] )
+         threads.Add( new BatchThread( E, images, results, n, n + L[i] ) );
+
+      StringList errors;
+      Mutex mutex;
+      for ( BatchThread& thread : threads )
+      {
+         thread.errors = &errors;
+         thread.mutex = &mutex;
       }
-      catch ( ... )
+
+      if ( threads.Length() > 1 )
       {
-         if ( initializationEnabled )
-            image.Status().EnableInitialization();
-         throw;
+         int n = 0;
+         for ( BatchThread& thread : threads )
+            thread.Start( ThreadPriority::DefaultMax, n++ );
+         for ( BatchThread& thread : threads )
+            thread.Wait();
       }
+      else
+         threads[0].Run();
+
+      threads.Destroy();
+
+      if ( !errors.IsEmpty() )
+         throw Error( String().ToSeparated( errors, '\n' ) );
+
+      return results;
    }
 
 private:
 
+   /*
+    * One thread per subset of target images. Each thread owns its working
+    * matrices and FFT objects, which are reused for all of its images. Since
+    * images are already distributed among threads, FFTs are not parallelized.
+    */
+   class BatchThread : public Thread
+   {
+   public:
+
+      StringList* errors = nullptr;
+      Mutex*      mutex = nullptr;
+
+      BatchThread( const FFTTranslation& engine, const Array<ImageVariant>& images,
+                   FFTTranslation::result_list& results, size_type begin, size_type end )
+         : m_engine( engine )
+         , m_images( images )
+         , m_results( results )
+         , m_begin( begin )
+         , m_end( end )
+      {
+      }
+
+      void Run() override
+      {
+         try
+         {
+            Workspace Wc( false ), Wf( false );
+            for ( size_type i = m_begin; i < m_end; ++i )
+               PCL_FFTTranslationEngine::Evaluate( m_results[i], m_images[i], m_engine, Wc, Wf );
+         }
+         catch ( ... )
+         {
+            volatile AutoLock lock( *mutex );
+
+            try
+            {
+               throw;
+            }
+            catch ( Exception& x )
+            {
+               *errors << x.Message();
+            }
+            catch ( std::bad_alloc& )
+            {
+               *errors << "Out of memory";
+            }
+            catch ( ... )
+            {
+               *errors << "Unknown error";
+            }
+         }
+      }
+
+   private:
+
+      const FFTTranslation&              m_engine;
+      const Array<ImageVariant>&         m_images;
+      FFTTranslation::result_list&       m_results;
+      size_type                          m_begin, m_end;
+   };
+
+   /*
+    * Loads the selected channel of the specified rectangular region of an
+    * image, centered within a size x size working matrix, binned by a factor
+    * f. Regions outside the image are filled with zeros.
+    */
+   template <class P>
+   static void Load( fcomplex* C, int size, const GenericImage<P>& image, const Rect& rect, int f )
+   {
+      int w = Min( rect.Width()/f, size );
+      int h = Min( rect.Height()/f, size );
+      int x0 = (size - w) >> 1;
+      int y0 = (size - h) >> 1;
+      int c = image.SelectedChannel();
+
+      ::memset( C, 0, size_type( size )*size_type( size )*sizeof( fcomplex ) );
+
+      if ( f == 1 )
+      {
+         int x1 = Max( 0, -rect.x0 );
+         int x2 = Min( w, image.Width() - rect.x0 );
+         for ( int y = Max( 0, -rect.y0 ), y2 = Min( h, image.Height() - rect.y0 ); y < y2; ++y )
+         {
+            const typename P::sample* __restrict__ s = image.PixelAddress( rect.x0, rect.y0 + y, c );
+            fcomplex* __restrict__ t = C + size_type( y0 + y )*size + x0;
+            for ( int x = x1; x < x2; ++x )
+               t[x] = ComplexPixelTraits::ToSample( s[x] );
+         }
+      }
+      else
+      {
+         for ( int y = 0; y < h; ++y )
+         {
+            fcomplex* __restrict__ t = C + size_type( y0 + y )*size + x0;
+            for ( int x = 0; x < w; ++x )
+            {
+               fcomplex sum = 0;
+               int n = 0;
+               for ( int i = 0, iy = rect.y0 + y*f; i < f; ++i, ++iy )
+                  if ( iy >= 0 && iy < image.Height() )
+                     for ( int j = 0, ix = rect.x0 + x*f; j < f; ++j, ++ix )
+                        if ( ix >= 0 && ix < image.Width() )
+                        {
+                           sum += ComplexPixelTraits::ToSample( image( ix, iy, c ) );
+                           ++n;
+                        }
+               if ( n > 0 )
+                  t[x] = sum/float( n );
+            }
+         }
+      }
+   }
+
+   /*
+    * Returns the DFT of a region of an image, loaded as by Load().
+    */
+   template <class P>
+   static ComplexImage Transform( const GenericImage<P>& image, const Rect& rect, int f, int size )
+   {
+      ComplexImage C( size, size );
+      Load( *C, size, image, rect, f );
+      FFT2D( size, size )( *C, *C, PCL_FFT_FORWARD );
+      return C;
+   }
+
+   /*
+    * Phase correlation of the target image loaded in a workspace with the
+    * reference DFT C0, both of W.size x W.size dimensions.
+    */
+   static void Correlate( FPoint& delta, float& peak, Workspace& W, const fcomplex* C0 )
+   {
+      int size = W.size;
+      fcomplex* C = *W.C;
+      (*W.F)( C, C, PCL_FFT_FORWARD );
+      PhaseCorrelationMatrix( *W.C, *W.C + W.C.Length(), C0, *W.C );
+      (*W.F)( C, C, PCL_FFT_BACKWARD );
+
+      // Extreme values of the absolute PCM, as computed by the image
+      // implementation: first occurrence of the maximum in row order.
+      Point p = 0;
+      float v0 = FloatPixelTraits::ToSample( C[0] );
+      float v1 = v0;
+      for ( int y = 0, i = 0; y < size; ++y )
+         for ( int x = 0; x < size; ++x, ++i )
+         {
+            float v = FloatPixelTraits::ToSample( C[i] );
+            if ( v < v0 )
+               v0 = v;
+            else if ( v > v1 )
+            {
+               v1 = v;
+               p.x = x;
+               p.y = y;
+            }
+         }
+
+      peak = v1;
+
+      // Normalized values of the absolute PCM, as computed by Image::Rescale().
+      double d = (v0 != v1) ? 1.0/(double( v1 ) - double( v0 )) : 0.0;
+      InterpolatePeak( delta, p, size,
+         [=]( int x, int y )
+         {
+            float v = FloatPixelTraits::ToSample( C[size_type( y )*size + x] );
+            return (v0 != v1) ? FloatPixelTraits::FloatToSample( d*(v - v0) ) : Range( v0, 0.0F, 1.0F );
+         } );
+   }
+
+   /*
+    * Interpolates the coordinates of the maximum peak p in the normalized
+    * phase matrix R from a square neighborhood of nine pixels centered at the
+    * maximum location.
+    */
+   template <class F>
+   static void InterpolatePeak( FPoint& delta, const Point& p, int size, F R )
+   {
+      Point p0( (p.x > 0) ? p.x-1 : size-1, (p.y > 0) ? p.y-1 : size-1 );
+      Point p1( (p.x < size-1) ? p.x+1 : 0, (p.y < size-1) ? p.y+1 : 0 );
+
+      float f00 = 0.7071*R( p0.x, p0.y );
+      float f01 =        R( p.x,  p0.y );
+      float f02 = 0.7071*R( p1.x, p0.y );
+
+      float f10 =        R( p0.x, p.y  );
+   //float f11 =      0*R( p.x,  p.y  ); // = 1 due to normalization of sample values
+      float f12 =        R( p1.x, p.y  );
+
+      float f20 = 0.7071*R( p0.x, p1.y );
+      float f21 =        R( p.x,  p1.y );
+      float f22 = 0.7071*R( p1.x, p1.y );
+
+      // Interpolate horizontal and vertical shifts.
+      delta.x = p.x - f00 - f10 - f20 + f02 + f12 + f22;
+      delta.y = p.y - f00 - f01 - f02 + f20 + f21 + f22;
+
+      // Obtain displacements in the correct directions.
+      //
+      // If an x or y coordinate is greater than the actual working space,
+      // (size/2), then it corresponds to a negative displacement.
+      //
+      // Remember that for this to work with large displacements >= size/2 in
+      // absolute value, the working size has to be doubled.
+
+      if ( delta.x >= size/2 )
+         delta.x -= size;
+      if ( delta.y >= size/2 )
+         delta.y -= size;
+
+      delta.x = Round( delta.x, 2 );
+      delta.y = Round( delta.y, 2 );
+   }
+
    template <class P>
    static ComplexImage Initialize( const GenericImage<P>& image, int size )
    {
@@ -208,36 +570,57 @@ private:
 
 ComplexImage FFTTranslation::DoInitialize( const pcl::Image& image )
 {
+   if ( m_pyramidLevels > 0 )
+      return PCL_FFTTranslationEngine::InitializePyramid( *this, image );
+   m_pyramidFactor = 0;
    return PCL_FFTTranslationEngine::Initialize( image, m_largeTranslations );
 }
 
 ComplexImage FFTTranslation::DoInitialize( const pcl::DImage& image )
 {
+   if ( m_pyramidLevels > 0 )
+      return PCL_FFTTranslationEngine::InitializePyramid( *this, image );
+   m_pyramidFactor = 0;
    return PCL_FFTTranslationEngine::Initialize( image, m_largeTranslations );
 }
 
 ComplexImage FFTTranslation::DoInitialize( const pcl::ComplexImage& image )
 {
+   if ( m_pyramidLevels > 0 )
+      return PCL_FFTTranslationEngine::InitializePyramid( *this, image );
+   m_pyramidFactor = 0;
    return PCL_FFTTranslationEngine::Initialize( image, m_largeTranslations );
 }
 
 ComplexImage FFTTranslation::DoInitialize( const pcl::DComplexImage& image )
 {
+   if ( m_pyramidLevels > 0 )
+      return PCL_FFTTranslationEngine::InitializePyramid( *this, image );
+   m_pyramidFactor = 0;
    return PCL_FFTTranslationEngine::Initialize( image, m_largeTranslations );
 }
 
 ComplexImage FFTTranslation::DoInitialize( const pcl::UInt8Image& image )
 {
+   if ( m_pyramidLevels > 0 )
+      return PCL_FFTTranslationEngine::InitializePyramid( *this, image );
+   m_pyramidFactor = 0;
    return PCL_FFTTranslationEngine::Initialize( image, m_largeTranslations );
 }
 
 ComplexImage FFTTranslation::DoInitialize( const pcl::UInt16Image& image )
 {
+   if ( m_pyramidLevels > 0 )
+      return PCL_FFTTranslationEngine::InitializePyramid( *this, image );
+   m_pyramidFactor = 0;
    return PCL_FFTTranslationEngine::Initialize( image, m_largeTranslations );
 }
 
 ComplexImage FFTTranslation::DoInitialize( const pcl::UInt32Image& image )
 {
+   if ( m_pyramidLevels > 0 )
+      return PCL_FFTTranslationEngine::InitializePyramid( *this, image );
+   m_pyramidFactor = 0;
    return PCL_FFTTranslationEngine::Initialize( image, m_largeTranslations );
 }
 
@@ -245,37 +628,65 @@ ComplexImage FFTTranslation::DoInitialize( const pcl::UInt32Image& image )
 
 void FFTTranslation::DoEvaluate( const pcl::Image& image )
 {
-   PCL_FFTTranslationEngine::Evaluate( m_delta, m_peak, image, m_fftReference );
+   if ( m_pyramidFactor > 1 )
+      PCL_FFTTranslationEngine::EvaluatePyramid( m_delta, m_peak, image, *this );
+   else
+      PCL_FFTTranslationEngine::Evaluate( m_delta, m_peak, image, m_fftReference );
 }
 
 void FFTTranslation::DoEvaluate( const pcl::DImage& image )
 {
-   PCL_FFTTranslationEngine::Evaluate( m_delta, m_peak, image, m_fftReference );
+   if ( m_pyramidFactor > 1 )
+      PCL_FFTTranslationEngine::EvaluatePyramid( m_delta, m_peak, image, *this );
+   else
+      PCL_FFTTranslationEngine::Evaluate( m_delta, m_peak, image, m_fftReference );
 }
 
 void FFTTranslation::DoEvaluate( const pcl::ComplexImage& image )
 {
-   PCL_FFTTranslationEngine::Evaluate( m_delta, m_peak, image, m_fftReference );
+   if ( m_pyramidFactor > 1 )
+      PCL_FFTTranslationEngine::EvaluatePyramid( m_delta, m_peak, image, *this );
+   else
+      PCL_FFTTranslationEngine::Evaluate( m_delta, m_peak, image, m_fftReference );
 }
 
 void FFTTranslation::DoEvaluate( const pcl::DComplexImage& image )
 {
-   PCL_FFTTranslationEngine::Evaluate( m_delta, m_peak, image, m_fftReference );
+   if ( m_pyramidFactor > 1 )
+      PCL_FFTTranslationEngine::EvaluatePyramid( m_delta, m_peak, image, *this );
+   else
+      PCL_FFTTranslationEngine::Evaluate( m_delta, m_peak, image, m_fftReference );
 }
 
 void FFTTranslation::DoEvaluate( const pcl::UInt8Image& image )
 {
-   PCL_FFTTranslationEngine::Evaluate( m_delta, m_peak, image, m_fftReference );
+   if ( m_pyramidFactor > 1 )
+      PCL_FFTTranslationEngine::EvaluatePyramid( m_delta, m_peak, image, *this );
+   else
+      PCL_FFTTranslationEngine::Evaluate( m_delta, m_peak, image, m_fftReference );
 }
 
 void FFTTranslation::DoEvaluate( const pcl::UInt16Image& image )
 {
-   PCL_FFTTranslationEngine::Evaluate( m_delta, m_peak, image, m_fftReference );
+   if ( m_pyramidFactor > 1 )
+      PCL_FFTTranslationEngine::EvaluatePyramid( m_delta, m_peak, image, *this );
+   else
+      PCL_FFTTranslationEngine::Evaluate( m_delta, m_peak, image, m_fftReference );
 }
 
 void FFTTranslation::DoEvaluate( const pcl::UInt32Image& image )
 {
-   PCL_FFTTranslationEngine::Evaluate( m_delta, m_peak, image, m_fftReference );
+   if ( m_pyramidFactor > 1 )
+      PCL_FFTTranslationEngine::EvaluatePyramid( m_delta, m_peak, image, *this );
+   else
+      PCL_FFTTranslationEngine::Evaluate( m_delta, m_peak, image, m_fftReference );
+}
+
+// ----------------------------------------------------------------------------
+
+FFTTranslation::result_list FFTTranslation::EvaluateBatch( const Array<ImageVariant>& images, bool parallel, int maxProcessors ) const
+{
+   return PCL_FFTTranslationEngine::EvaluateBatch( *this, images, parallel, maxProcessors );
 }
 
 // ----------------------------------------------------------------------------
@@ -427,6 +427,44 @@ void File::Read( void* b, fsize_type sz )
 
 // ----------------------------------------------------------------------------
 
+void File::ReadAt( fpos_type pos, void* b, fsize_type sz ) const
+{
+   CHECK_READABLE( "ReadAt" );
+
+   while ( sz > 0 )
+   {
+      size_type thisBlockSz = Min( size_type( sz ), ioBlockSz );
+#ifdef __PCL_WINDOWS
+      OVERLAPPED ov = {};
+      ov.Offset = DWORD( pos & 0x00000000FFFFFFFFull );
+      ov.OffsetHigh = DWORD( pos >> 32 );
+      DWORD nr;
+      if ( !::ReadFile( m_fileHandle, b, DWORD( thisBlockSz ), &nr, &ov ) )
+      {
+         if ( ::GetLastError() == ERROR_HANDLE_EOF )
+            throw File::Error( FilePath(), "Unexpected end of file" );
+         throw File::Error( FilePath(), "File read error: " + WinErrorMessage() );
+      }
+#else
+      ssize_t nr = ::pread( ::fileno( (FILE*)m_fileHandle ), b, size_t( thisBlockSz ), off_t( pos ) );
+      if ( nr < 0 )
+      {
+         if ( errno == EINTR )
+            continue;
+         throw File::Error( FilePath(), "File read error: " + String( ::strerror( errno ) ) );
+      }
+#endif
+      if ( nr == 0 )
+         throw File::Error( FilePath(), "Unexpected end of file" );
+
+      b = (void*)(reinterpret_cast<uint8*>( b ) + nr);
+      pos += nr;
+      sz -= nr;
+   }
+}
+
+// ----------------------------------------------------------------------------
+
 void File::Write( const void* b, fsize_type sz )
 {
    CHECK_WRITABLE( "Write" );
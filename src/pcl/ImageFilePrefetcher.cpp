@@ -0,0 +1,473 @@
+//     ____   ______ __
+//    / __ \ / ____// /
+//   / /_/ // /    / /
+//  / ____// /___ / /___   PixInsight Class Library
+// /_/     \____//_____/   PCL 2.8.5
+// ----------------------------------------------------------------------------
+// pcl/ImageFilePrefetcher.cpp - Released 2024-12-28T16:53:56Z
+// ----------------------------------------------------------------------------
+// This file is part of the PixInsight Class Library (PCL).
+// PCL is a multiplatform C++ framework for development of PixInsight modules.
+//
+// Copyright (c) 2003-2024 Pleiades Astrophoto S.L. All Rights Reserved.
+//
+// Redistribution and use in both source and binary forms, with or without
+// modification, is permitted provided that the following conditions are met:
+//
+// 1. All redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//
+// 2. All redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//
+// 3. Neither the names "PixInsight" and "Pleiades Astrophoto", nor the names
+//    of their contributors, may be used to endorse or promote products derived
+//    from this software without specific prior written permission. For written
+//    permission, please contact info@pixinsight.com.
+//
+// 4. All products derived from this software, in any form whatsoever, must
+//    reproduce the following acknowledgment in the end-user documentation
+//    and/or other materials provided with the product:
+//
+//    "This product is based on software from the PixInsight project, developed
+//    by Pleiades Astrophoto and its contributors (https://pixinsight.com/)."
+//
+//    Alternatively, if that is where third-party acknowledgments normally
+//    appear, this acknowledgment must be reproduced in the product itself.
+//
+// THIS SOFTWARE IS PROVIDED BY PLEIADES ASTROPHOTO AND ITS CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED
+// TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+// PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL PLEIADES ASTROPHOTO OR ITS
+// CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, BUSINESS
+// INTERRUPTION; PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; AND LOSS OF USE,
+// DATA OR PROFITS) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+// ----------------------------------------------------------------------------
+
+#include <pcl/AutoLock.h>
+#include <pcl/Console.h>
+#include <pcl/File.h>
+#include <pcl/FileFormat.h>
+#include <pcl/FileFormatInstance.h>
+#include <pcl/ImageFilePrefetcher.h>
+#include <pcl/ElapsedTime.h>
+#include <pcl/MetaModule.h>
+#include <pcl/Thread.h>
+
+#ifndef __PCL_WINDOWS
+#  include <sys/types.h>
+#  include <sys/stat.h>
+#  include <fcntl.h>
+#  include <limits.h>
+#  include <unistd.h>
+#endif
+
+namespace pcl
+{
+
+// ----------------------------------------------------------------------------
+
+/*
+ * Tells the operating system that the specified file will be read soon, so
+ * that it can start transferring its contents to the page cache.
+ */
+static void AdviseWillNeed( const String& filePath )
+{
+#ifndef __PCL_WINDOWS
+   IsoString utf8 = filePath.ToUTF8();
+   int fd = ::open( utf8.c_str(), O_RDONLY );
+   if ( fd < 0 )
+      return;
+#  ifdef __PCL_MACOSX
+   struct stat s;
+   if ( ::fstat( fd, &s ) == 0 )
+   {
+      struct radvisory r;
+      r.ra_offset = 0;
+      r.ra_count = int( Min( s.st_size, off_t( INT_MAX ) ) );
+      (void)::fcntl( fd, F_RDADVISE, &r );
+   }
+#  else
+   (void)::posix_fadvise( fd, 0, 0, POSIX_FADV_WILLNEED );
+#  endif
+   ::close( fd );
+#endif
+}
+
+// ----------------------------------------------------------------------------
+
+/*
+ * Polling interval in milliseconds of the reader and consumer threads while
+ * waiting for a change of the shared queue state.
+ */
+static constexpr unsigned s_pollInterval = 5;
+
+// ----------------------------------------------------------------------------
+
+class ImageFilePrefetcherPrivate
+{
+public:
+
+   /*
+    * An image read by the reader thread, or the error that prevented reading
+    * it, waiting to be retrieved by the consumer.
+    */
+   struct Slot
+   {
+      ImageFilePrefetcher::Item data;
+      size_type                 bytes = 0;      // reserved from the memory budget
+      String                    consoleText;    // console output of the file format
+      String                    errorMessage;
+      bool                      failed = false;
+      bool                      caught = false; // error already written to the console
+      bool                      aborted = false;
+   };
+
+   class ReaderThread : public Thread
+   {
+   public:
+
+      ReaderThread( ImageFilePrefetcherPrivate& data )
+         : m_data( data )
+      {
+      }
+
+      void Run() override
+      {
+         const StringList& filePaths = m_data.m_filePaths;
+         for ( size_type i = m_data.m_start; i < filePaths.Length(); ++i )
+         {
+            for ( ;; )
+            {
+               {
+                  volatile AutoLock lock( m_data.m_mutex );
+                  if ( m_data.m_stop )
+                     return;
+                  if ( int( m_data.m_queue.Length() ) < m_data.m_prefetchCount )
+                     break;
+               }
+               Sleep( s_pollInterval );
+            }
+
+            if ( i+1 < filePaths.Length() )
+               AdviseWillNeed( filePaths[i+1] );
+
+            Slot slot;
+            slot.data.filePath = filePaths[i];
+            try
+            {
+               if ( !ReadFile( slot ) )
+                  return;
+            }
+            catch ( ProcessAborted& )
+            {
+               slot.failed = slot.aborted = true;
+            }
+            catch ( CaughtException& )
+            {
+               slot.failed = slot.caught = true;
+            }
+            catch ( Exception& x )
+            {
+               slot.failed = true;
+               slot.errorMessage = x.Message();
+            }
+            catch ( std::bad_alloc& )
+            {
+               slot.failed = true;
+               slot.errorMessage = "Out of memory";
+            }
+            catch ( ... )
+            {
+               slot.failed = true;
+               slot.errorMessage = "Unknown exception";
+            }
+
+            slot.consoleText = ConsoleOutputText();
+            ClearConsoleOutputText();
+
+            {
+               volatile AutoLock lock( m_data.m_mutex );
+               if ( slot.failed )
+               {
+                  slot.data.image.Free();
+                  m_data.m_queuedBytes -= slot.bytes;
+                  slot.bytes = 0;
+               }
+               m_data.m_queue << std::move( slot );
+            }
+         }
+      }
+
+   private:
+
+      ImageFilePrefetcherPrivate& m_data;
+
+      /*
+       * Reads the first image in a file. Returns false if the prefetcher was
+       * stopped while waiting for memory.
+       */
+      bool ReadFile( Slot& slot )
+      {
+         const String& filePath = slot.data.filePath;
+
+         FileFormat format( File::ExtractExtension( filePath ), true/*read*/, false/*write*/ );
+         FileFormatInstance file( format );
+
+         ImageDescriptionArray images;
+         if ( !file.Open( images, filePath, m_data.m_hints ) )
+            throw CaughtException();
+         if ( images.IsEmpty() )
+            throw Error( filePath + ": Empty image file." );
+
+         slot.data.numberOfImages = int( images.Length() );
+         slot.data.description = images[0];
+
+         int bitsPerSample = m_data.m_bitsPerSample;
+         bool floatSample = m_data.m_floatSample;
+         if ( bitsPerSample == 0 )
+         {
+            bitsPerSample = images[0].options.bitsPerSample;
+            floatSample = images[0].options.ieeefpSampleFormat || images[0].options.complexSample;
+         }
+         if ( floatSample )
+            bitsPerSample = (bitsPerSample > 32) ? 64 : 32;
+         else
+            bitsPerSample = (bitsPerSample > 16) ? 32 : ((bitsPerSample > 8) ? 16 : 8);
+
+         if ( !Reserve( slot, images[0].info.NumberOfSamples()*(bitsPerSample >> 3) ) )
+            return false;
+
+         if ( m_data.m_readKeywords )
+            if ( format.CanStoreKeywords() )
+               file.ReadFITSKeywords( slot.data.keywords );
+
+         if ( m_data.m_readProperties )
+            if ( format.CanStoreImageProperties() )
+               slot.data.properties = file.ReadImageProperties();
+
+         if ( m_data.m_sharedImages )
+            slot.data.image.CreateSharedImage( floatSample, false/*isComplex*/, bitsPerSample );
+         else
+            slot.data.image.CreateImage( floatSample, false/*isComplex*/, bitsPerSample );
+
+         if ( !file.ReadImage( slot.data.image ) || !file.Close() )
+            throw CaughtException();
+
+         return true;
+      }
+
+      /*
+       * Waits until an image of the specified size fits in the memory budget,
+       * and reserves the required memory.
+       */
+      bool Reserve( Slot& slot, size_type bytes )
+      {
+         for ( ;; )
+         {
+            {
+               volatile AutoLock lock( m_data.m_mutex );
+               if ( m_data.m_stop )
+                  return false;
+               if ( m_data.m_memoryLimit == 0
+                 || m_data.m_queue.IsEmpty()
+                 || m_data.m_queuedBytes + bytes <= m_data.m_memoryLimit )
+               {
+                  m_data.m_queuedBytes += bytes;
+                  slot.bytes = bytes;
+                  return true;
+               }
+            }
+            Sleep( s_pollInterval );
+         }
+      }
+   };
+
+   ImageFilePrefetcherPrivate( const ImageFilePrefetcher& prefetcher )
+      : m_filePaths( prefetcher.m_filePaths )
+      , m_hints( prefetcher.m_hints )
+      , m_start( prefetcher.m_next )
+      , m_prefetchCount( prefetcher.m_prefetchCount )
+      , m_memoryLimit( prefetcher.m_memoryLimit )
+      , m_bitsPerSample( prefetcher.m_bitsPerSample )
+      , m_floatSample( prefetcher.m_floatSample )
+      , m_sharedImages( prefetcher.m_sharedImages )
+      , m_readKeywords( prefetcher.m_readKeywords )
+      , m_readProperties( prefetcher.m_readProperties )
+      , m_thread( *this )
+   {
+   }
+
+   /*
+    * Requests the reader thread to stop and waits until it terminates.
+    */
+   void Stop()
+   {
+      {
+         volatile AutoLock lock( m_mutex );
+         m_stop = true;
+      }
+      m_thread.Wait();
+   }
+
+   /*
+    * Waits until the next image is available. Returns false on timeout.
+    */
+   bool Wait( unsigned ms )
+   {
+      for ( ElapsedTime T; ; )
+      {
+         {
+            volatile AutoLock lock( m_mutex );
+            if ( !m_queue.IsEmpty() )
+               return true;
+         }
+         if ( !m_thread.IsActive() )
+            return true;
+         double remaining = ms - 1000*T();
+         if ( remaining <= 0 )
+            return false;
+         Sleep( Min( s_pollInterval, unsigned( remaining ) + 1 ) );
+      }
+   }
+
+   /*
+    * Removes the next image from the queue. Returns false if the reader has
+    * terminated without reading it.
+    */
+   bool Pop( Slot& slot )
+   {
+      volatile AutoLock lock( m_mutex );
+      if ( m_queue.IsEmpty() )
+         return false;
+      slot = *m_queue.Begin();
+      m_queue.Remove( m_queue.Begin() );
+      m_queuedBytes -= slot.bytes;
+      return true;
+   }
+
+private:
+
+   StringList              m_filePaths;
+   IsoString               m_hints;
+   size_type               m_start;
+   int                     m_prefetchCount;
+   size_type               m_memoryLimit;
+   int                     m_bitsPerSample;
+   bool                    m_floatSample;
+   bool                    m_sharedImages;
+   bool                    m_readKeywords;
+   bool                    m_readProperties;
+
+   Mutex                   m_mutex;
+   Array<Slot>             m_queue;
+   size_type               m_queuedBytes = 0;
+   bool                    m_stop = false;
+
+   ReaderThread            m_thread;
+
+   friend class ImageFilePrefetcher;
+};
+
+// ----------------------------------------------------------------------------
+
+ImageFilePrefetcher::ImageFilePrefetcher( const StringList& filePaths, const IsoString& hints )
+   : m_filePaths( filePaths )
+   , m_hints( hints )
+{
+}
+
+// ----------------------------------------------------------------------------
+
+ImageFilePrefetcher::~ImageFilePrefetcher()
+{
+   Stop();
+}
+
+// ----------------------------------------------------------------------------
+
+void ImageFilePrefetcher::Start()
+{
+   if ( m_data.IsNull() )
+      if ( HasNext() )
+      {
+         AdviseWillNeed( m_filePaths[m_next] );
+         m_data = new ImageFilePrefetcherPrivate( *this );
+         m_data->m_thread.Start();
+      }
+}
+
+// ----------------------------------------------------------------------------
+
+void ImageFilePrefetcher::Stop()
+{
+   if ( !m_data.IsNull() )
+   {
+      m_data->Stop();
+      m_data.Destroy();
+   }
+}
+
+// ----------------------------------------------------------------------------
+
+bool ImageFilePrefetcher::IsRunning() const
+{
+   return !m_data.IsNull();
+}
+
+// ----------------------------------------------------------------------------
+
+bool ImageFilePrefetcher::WaitNext( unsigned ms )
+{
+   if ( !HasNext() )
+      return true;
+   if ( m_data.IsNull() )
+      return false;
+   return m_data->Wait( ms );
+}
+
+// ----------------------------------------------------------------------------
+
+ImageFilePrefetcher::Item ImageFilePrefetcher::Next()
+{
+   if ( !HasNext() )
+      throw Error( "ImageFilePrefetcher::Next(): No more images available." );
+
+   Start();
+
+   bool processEvents = Thread::IsRootThread();
+   while ( !m_data->Wait( 250 ) )
+      if ( processEvents )
+         Module->ProcessEvents( true/*excludeUserInputEvents*/ );
+
+   ImageFilePrefetcherPrivate::Slot slot;
+   if ( !m_data->Pop( slot ) )
+      throw Error( "ImageFilePrefetcher::Next(): Internal error: The reader thread has terminated unexpectedly." );
+   ++m_next;
+
+   if ( !slot.consoleText.IsEmpty() )
+      Console().Write( slot.consoleText );
+
+   if ( slot.failed )
+   {
+      if ( slot.aborted )
+         throw ProcessAborted();
+      if ( slot.caught )
+         throw CaughtException();
+      throw Error( slot.errorMessage );
+   }
+
+   return std::move( slot.data );
+}
+
+// ----------------------------------------------------------------------------
+
+} // pcl
+
+// ----------------------------------------------------------------------------
+// EOF pcl/ImageFilePrefetcher.cpp - Released 2024-12-28T16:53:56Z
@@ -49,8 +49,12 @@
 // POSSIBILITY OF SUCH DAMAGE.
 // ----------------------------------------------------------------------------
 
+#include <pcl/FileFormatInstance.h>
+#include <pcl/ImageInfo.h>
 #include <pcl/IntegerResample.h>
+#include <pcl/ReferenceArray.h>
 #include <pcl/Selection.h>
+#include <pcl/Thread.h>
 
 // ----------------------------------------------------------------------------
 
@@ -75,8 +79,8 @@ class PCL_IntegerResampleEngine
 {
 public:
 
-   template <class P> inline
-   static void Apply( GenericImage<P>& image, const IntegerResample& Z )
+   template <class P> static
+   void Apply( GenericImage<P>& image, const IntegerResample& Z )
    {
       int width = image.Width();
       int srcWidth = width;
@@ -100,21 +104,18 @@ public:
       typename P::sample** f0 = nullptr;
 
       int numberOfChannels = image.NumberOfChannels();
-      size_type N = image.NumberOfPixels();
       typename GenericImage<P>::color_space colorSpace = image.ColorSpace();
 
       StatusMonitor status = image.Status();
 
-      int z = pcl::Abs( Z.ZoomFactor() );
-      int z2 = z*z;
-      int n2 = z2 >> 1;
+      /*
+       * Upsampling threads process source rows; downsampling threads process
+       * target rows.
+       */
+      int rows = (Z.ZoomFactor() > 0) ? srcHeight : height;
 
       try
       {
-         GenericVector<typename P::sample> fm;
-         if ( Z.ZoomFactor() < 0 && Z.DownsampleMode() == IntegerDownsampleMode::Median )
-            fm = GenericVector<typename P::sample>( z2 );
-
          f0 = image.ReleaseData();
 
          if ( Z.IsGammaCorrectionEnabled() )
@@ -130,123 +131,20 @@ public:
          }
 
          if ( status.IsInitializationEnabled() )
-         {
-            String info = (Z.ZoomFactor() > 0) ? "Upsampling" : "Downsampling";
+            status.Initialize( StatusInfo( Z, width, height ), size_type( numberOfChannels )*rows );
 
-            info.AppendFormat( " %d:%d, %dx%d",
-               (Z.ZoomFactor() > 0) ? z : 1, (Z.ZoomFactor() > 0) ? 1 : z, width, height );
-
-            if ( Z.ZoomFactor() < 0 )
-            {
-               info += ", ";
-               switch ( Z.DownsampleMode() )
-               {
-               default:
-               case IntegerDownsampleMode::Average: info += "average"; break;
-               case IntegerDownsampleMode::Median:  info += "median"; break;
-               case IntegerDownsampleMode::Maximum: info += "maximum"; break;
-               case IntegerDownsampleMode::Minimum: info += "minimum"; break;
-               }
-            }
-
-            status.Initialize( info, size_type( numberOfChannels )*N );
-         }
-
-         for ( int c = 0; c < numberOfChannels; ++c, status += N )
+         for ( int c = 0; c < numberOfChannels; ++c )
          {
             f = image.Allocator().AllocatePixels( width, height );
 
-            if ( Z.ZoomFactor() > 0 )
-            {
-               const typename P::sample* f0c = f0[c];
-
-               for ( int y = 0; y < srcHeight; ++y )
-               {
-                  int yz = y*z;
-
-                  for ( int x = 0; x < srcWidth; ++x )
-                  {
-                     int xz = x*z;
-                     typename P::sample v = *f0c++;
-
-                     for ( int i = 0; i < z; ++i )
-                     {
-                        typename P::sample* fi = f + (size_type( yz + i )*width + xz);
-
-                        for ( int j = 0; j < z; ++j )
-                           *fi++ = v;
-                     }
-                  }
-               }
-            }
-            else
-            {
-               typename P::sample* fz = f;
-
-               for ( int y = 0; y < height; ++y )
-               {
-                  const typename P::sample* fy = f0[c] + size_type( y )*z*srcWidth;
-
-                  for ( int x = 0; x < width; ++x )
-                  {
-                     const typename P::sample* fyx = fy + x*z;
-
-                     switch ( Z.DownsampleMode() )
-                     {
-                     default:
-                     case IntegerDownsampleMode::Average:
-                        {
-                           double s = 0;
-                           for ( int i = 0; i < z; ++i, fyx += srcWidth )
-                              for ( int j = 0; j < z; ++j )
-                                 s += fyx[j];
-                           *fz++ = typename P::sample( P::IsFloatSample() ? s/z2 : Round( s/z2 ) );
-                        }
-                        break;
-
-                     case IntegerDownsampleMode::Median:
-                        {
-                           typename P::sample* fmi = *fm;
-                           for ( int i = 0; i < z; ++i, fyx += srcWidth )
-                              for ( int j = 0; j < z; ++j )
-                                 *fmi++ = fyx[j];
-
-                           *fz++ = (z & 1) ?
-                                 *Select( *fm, fm.At( z2 ), n2 ) :
-                                 P::FloatToSample( 0.5*(double( *Select( *fm, fm.At( z2 ), n2   ) ) +
-                                                        double( *Select( *fm, fm.At( z2 ), n2-1 ) )) );
-                        }
-                        break;
-
-                     case IntegerDownsampleMode::Maximum:
-                        {
-                           *fz = P::MinSampleValue();
-                           for ( int i = 0; i < z; ++i, fyx += srcWidth )
-                              for ( int j = 0; j < z; ++j )
-                                 if ( fyx[j] > *fz )
-                                    *fz = fyx[j];
-                           ++fz;
-                        }
-                        break;
-
-                     case IntegerDownsampleMode::Minimum:
-                        {
-                           *fz = P::MaxSampleValue();
-                           for ( int i = 0; i < z; ++i, fyx += srcWidth )
-                              for ( int j = 0; j < z; ++j )
-                                 if ( fyx[j] < *fz )
-                                    *fz = fyx[j];
-                           ++fz;
-                        }
-                        break;
-                     }
-                  }
-               }
-            }
+            ResampleThreadData<P> data( Z, f0[c], f, srcWidth, width, status, rows );
+            Resample( data, rows );
 
             image.Allocator().Deallocate( f0[c] );
             f0[c] = f;
             f = nullptr;
+
+            status = data.status;
          }
 
          if ( Z.IsGammaCorrectionEnabled() )
@@ -276,6 +174,378 @@ public:
          throw;
       }
    }
+
+   template <class P> static
+   bool Read( GenericImage<P>& image, FileFormatInstance& file, const ImageInfo& info, const IntegerResample& Z )
+   {
+      if ( Z.ZoomFactor() > -2 || !file.CanReadIncrementally() )
+      {
+         if ( !file.ReadImage( image ) )
+            return false;
+         Apply( image, Z );
+         return true;
+      }
+
+      int srcWidth = info.width;
+      int width = srcWidth;
+      int height = info.height;
+      Z.GetNewSizes( width, height );
+
+      if ( width == 0 || height == 0 )
+      {
+         image.FreeData();
+         return true;
+      }
+
+      int z = -Z.ZoomFactor();
+      int numberOfChannels = info.numberOfChannels;
+
+      image.AllocateData( width, height, numberOfChannels, typename GenericImage<P>::color_space( info.colorSpace ) );
+
+      StatusMonitor status = image.Status();
+      if ( status.IsInitializationEnabled() )
+         status.Initialize( StatusInfo( Z, width, height ) + ", incremental read", size_type( numberOfChannels )*height );
+
+      /*
+       * Read strips of z*stripRows source rows, with about 4M samples per
+       * strip, and downsample them to stripRows target rows.
+       */
+      int stripRows = Range( int( (size_type( 1 ) << 22)/(size_type( z )*srcWidth) ), 1, height );
+      Array<typename P::sample> buffer( size_type( stripRows )*z*srcWidth );
+
+      for ( int c = 0; c < numberOfChannels; ++c )
+         for ( int y = 0; y < height; y += stripRows )
+         {
+            int rows = Min( stripRows, height - y );
+            if ( !file.ReadSamples( buffer.Begin(), y*z, rows*z, c ) )
+               return false;
+
+            if ( Z.IsGammaCorrectionEnabled() )
+            {
+               size_type N = size_type( rows )*z*srcWidth;
+               AbstractImage::ThreadData data( StatusMonitor(), N );
+               Z.ApplyGammaCorrection<P>( buffer.Begin(), N, data, Z.MaxProcessors() );
+            }
+
+            ResampleThreadData<P> data( Z, buffer.Begin(), image[c] + size_type( y )*width, srcWidth, width, status, rows );
+            Resample( data, rows );
+            status = data.status;
+         }
+
+      if ( Z.IsGammaCorrectionEnabled() )
+      {
+         size_type Nout = size_type( width ) * size_type( height );
+         if ( status.IsInitializationEnabled() )
+            status.Initialize( "Inverse gamma correction", size_type( numberOfChannels )*Nout );
+         AbstractImage::ThreadData data( status, Nout );
+         for ( int c = 0; c < numberOfChannels; ++c )
+            Z.ApplyInverseGammaCorrection<P>( image[c], Nout, data, Z.MaxProcessors() );
+      }
+
+      image.Status() = status;
+      return true;
+   }
+
+private:
+
+   /*
+    * Maximum number of target pixels processed as a vector by downsampling
+    * kernels.
+    */
+   constexpr static int ChunkSize = 64;
+
+   static String StatusInfo( const IntegerResample& Z, int width, int height )
+   {
+      int z = pcl::Abs( Z.ZoomFactor() );
+
+      String info = (Z.ZoomFactor() > 0) ? "Upsampling" : "Downsampling";
+
+      info.AppendFormat( " %d:%d, %dx%d",
+         (Z.ZoomFactor() > 0) ? z : 1, (Z.ZoomFactor() > 0) ? 1 : z, width, height );
+
+      if ( Z.ZoomFactor() < 0 )
+      {
+         info += ", ";
+         switch ( Z.DownsampleMode() )
+         {
+         default:
+         case IntegerDownsampleMode::Average: info += "average"; break;
+         case IntegerDownsampleMode::Median:  info += "median"; break;
+         case IntegerDownsampleMode::Maximum: info += "maximum"; break;
+         case IntegerDownsampleMode::Minimum: info += "minimum"; break;
+         }
+      }
+
+      return info;
+   }
+
+   template <class P>
+   struct ResampleThreadData : public AbstractImage::ThreadData
+   {
+      ResampleThreadData( const IntegerResample& a_Z, const typename P::sample* a_f0, typename P::sample* a_f,
+                          int a_srcWidth, int a_width, const StatusMonitor& a_status, size_type a_count )
+         : AbstractImage::ThreadData( a_status, a_count )
+         , Z( a_Z )
+         , f0( a_f0 )
+         , f( a_f )
+         , srcWidth( a_srcWidth )
+         , width( a_width )
+      {
+      }
+
+      const IntegerResample&    Z;
+      const typename P::sample* f0;       // source data
+            typename P::sample* f;        // target data
+            int                 srcWidth; // source width
+            int                 width;    // target width
+   };
+
+   template <class P> static
+   void Resample( ResampleThreadData<P>& data, int rows )
+   {
+      const IntegerResample& Z = data.Z;
+      int overheadLimit = pcl::Max( 1, int( 65536/(size_type( pcl::Abs( Z.ZoomFactor() ) )*data.srcWidth) ) );
+      Array<size_type> L = Thread::OptimalThreadLoads( rows,
+                                                       overheadLimit,
+                                                       Z.IsParallelProcessingEnabled() ? Z.MaxProcessors() : 1 );
+      ReferenceArray<ResampleThread<P>> threads;
+      for ( int i = 0, n = 0; i < int( L.Length() ); n += int( L[i++] ) )
+         threads.Add( new ResampleThread<P>( data, n, n + int( L[i] ) ) );
+      AbstractImage::RunThreads( threads, data );
+      threads.Destroy();
+   }
+
+   template <class P>
+   class ResampleThread : public Thread
+   {
+   public:
+
+      using sample = typename P::sample;
+
+      ResampleThread( ResampleThreadData<P>& data, int firstRow, int endRow )
+         : m_data( data )
+         , m_firstRow( firstRow )
+         , m_endRow( endRow )
+      {
+      }
+
+      PCL_HOT_FUNCTION void Run() override
+      {
+         INIT_THREAD_MONITOR()
+
+         int z = pcl::Abs( m_data.Z.ZoomFactor() );
+         int srcWidth = m_data.srcWidth;
+         int width = m_data.width;
+
+         if ( m_data.Z.ZoomFactor() > 0 )
+         {
+            for ( int y = m_firstRow; y < m_endRow; ++y )
+            {
+               const sample* __restrict__ f0 = m_data.f0 + size_type( y )*srcWidth;
+               sample* __restrict__ f = m_data.f + size_type( y )*z*width;
+
+               for ( int x = 0, k = 0; x < srcWidth; ++x )
+                  for ( int j = 0; j < z; ++j, ++k )
+                     f[k] = f0[x];
+               for ( int i = 1; i < z; ++i )
+                  ::memcpy( f + size_type( i )*width, f, width*sizeof( sample ) );
+
+               UPDATE_THREAD_MONITOR( 16 )
+            }
+         }
+         else
+         {
+            GenericVector<sample> fm;
+            if ( m_data.Z.DownsampleMode() == IntegerDownsampleMode::Median )
+               if ( z > 4 )
+                  fm = GenericVector<sample>( z*z );
+
+            for ( int y = m_firstRow; y < m_endRow; ++y )
+            {
+               const sample* f0 = m_data.f0 + size_type( y )*z*srcWidth;
+               sample* f = m_data.f + size_type( y )*width;
+
+               switch ( m_data.Z.DownsampleMode() )
+               {
+               default:
+               case IntegerDownsampleMode::Average:
+                  switch ( z )
+                  {
+                  case  2: AverageRow<2>( f, f0, srcWidth, width, z ); break;
+                  case  3: AverageRow<3>( f, f0, srcWidth, width, z ); break;
+                  case  4: AverageRow<4>( f, f0, srcWidth, width, z ); break;
+                  default: AverageRow<0>( f, f0, srcWidth, width, z ); break;
+                  }
+                  break;
+               case IntegerDownsampleMode::Median:
+                  switch ( z )
+                  {
+                  case  2: MedianRow<2>( f, f0, srcWidth, width ); break;
+                  case  3: MedianRow<3>( f, f0, srcWidth, width ); break;
+                  case  4: MedianRow<4>( f, f0, srcWidth, width ); break;
+                  default: MedianRow( f, f0, srcWidth, width, z, fm ); break;
+                  }
+                  break;
+               case IntegerDownsampleMode::Maximum:
+                  switch ( z )
+                  {
+                  case  2: ExtremeRow<2, true>( f, f0, srcWidth, width, z ); break;
+                  case  3: ExtremeRow<3, true>( f, f0, srcWidth, width, z ); break;
+                  case  4: ExtremeRow<4, true>( f, f0, srcWidth, width, z ); break;
+                  default: ExtremeRow<0, true>( f, f0, srcWidth, width, z ); break;
+                  }
+                  break;
+               case IntegerDownsampleMode::Minimum:
+                  switch ( z )
+                  {
+                  case  2: ExtremeRow<2, false>( f, f0, srcWidth, width, z ); break;
+                  case  3: ExtremeRow<3, false>( f, f0, srcWidth, width, z ); break;
+                  case  4: ExtremeRow<4, false>( f, f0, srcWidth, width, z ); break;
+                  default: ExtremeRow<0, false>( f, f0, srcWidth, width, z ); break;
+                  }
+                  break;
+               }
+
+               UPDATE_THREAD_MONITOR( 16 )
+            }
+         }
+      }
+
+   private:
+
+      ResampleThreadData<P>& m_data;
+      int                    m_firstRow;
+      int                    m_endRow;
+
+      /*
+       * Row kernels. Each kernel computes a row of target pixels from z
+       * consecutive source rows. Kernels process chunks of target pixels with
+       * inner loops free of dependencies, which the compiler can vectorize.
+       * For Z > 0 the zoom factor is a compile-time constant, so the loops
+       * over source pixels in a block can be fully unrolled; Z = 0 selects a
+       * generic kernel for the runtime zoom factor z.
+       */
+
+      template <int Z>
+      static void AverageRow( sample* __restrict__ f, const sample* __restrict__ f0, int srcWidth, int width, int z )
+      {
+         const int n = (Z > 0) ? Z : z;
+         const int n2 = n*n;
+         double s[ ChunkSize ];
+         for ( int x0 = 0; x0 < width; x0 += ChunkSize )
+         {
+            const int m = pcl::Min( ChunkSize, width - x0 );
+            for ( int k = 0; k < m; ++k )
+               s[k] = 0;
+            const sample* __restrict__ r = f0 + size_type( x0 )*n;
+            for ( int i = 0; i < n; ++i, r += srcWidth )
+               for ( int k = 0; k < m; ++k )
+                  for ( int j = 0; j < n; ++j )
+                     s[k] += r[k*n + j];
+            for ( int k = 0; k < m; ++k )
+               f[x0+k] = sample( P::IsFloatSample() ? s[k]/n2 : Round( s[k]/n2 ) );
+         }
+      }
+
+      template <int Z, bool max>
+      static void ExtremeRow( sample* __restrict__ f, const sample* __restrict__ f0, int srcWidth, int width, int z )
+      {
+         const int n = (Z > 0) ? Z : z;
+         for ( int x0 = 0; x0 < width; x0 += ChunkSize )
+         {
+            const int m = pcl::Min( ChunkSize, width - x0 );
+            sample* __restrict__ e = f + x0;
+            for ( int k = 0; k < m; ++k )
+               e[k] = max ? P::MinSampleValue() : P::MaxSampleValue();
+            const sample* __restrict__ r = f0 + size_type( x0 )*n;
+            for ( int i = 0; i < n; ++i, r += srcWidth )
+               for ( int k = 0; k < m; ++k )
+                  for ( int j = 0; j < n; ++j )
+                     e[k] = max ? pcl::Max( e[k], r[k*n + j] ) : pcl::Min( e[k], r[k*n + j] );
+         }
+      }
+
+      /*
+       * Compare-exchange operation of a selection network, applied to
+       * vectors of m elements.
+       */
+      static void CompareExchange( sample* __restrict__ a, sample* __restrict__ b, int m )
+      {
+         for ( int k = 0; k < m; ++k )
+         {
+            sample x = a[k], y = b[k];
+            a[k] = pcl::Min( x, y );
+            b[k] = pcl::Max( x, y );
+         }
+      }
+
+      /*
+       * Median of 2x2, 3x3 and 4x4 pixel blocks. The pixels of a chunk of
+       * blocks are transposed to Z*Z vectors, which are then sorted
+       * elementwise with a selection network: Batcher's odd-even merge sort
+       * for 4 and 16 elements, and the optimal median-of-9 network for 3x3
+       * blocks.
+       */
+      template <int Z>
+      static void MedianRow( sample* __restrict__ f, const sample* __restrict__ f0, int srcWidth, int width )
+      {
+         constexpr int N = Z*Z;
+         sample v[ N ][ ChunkSize ];
+         for ( int x0 = 0; x0 < width; x0 += ChunkSize )
+         {
+            const int m = pcl::Min( ChunkSize, width - x0 );
+            const sample* __restrict__ r = f0 + size_type( x0 )*Z;
+            for ( int i = 0; i < Z; ++i, r += srcWidth )
+               for ( int j = 0; j < Z; ++j )
+                  for ( int k = 0; k < m; ++k )
+                     v[i*Z + j][k] = r[k*Z + j];
+
+            if ( Z == 3 )
+            {
+               static const int s_med9[][ 2 ] =
+               {
+                  {1,2}, {4,5}, {7,8}, {0,1}, {3,4}, {6,7}, {1,2}, {4,5}, {7,8}, {0,3},
+                  {5,8}, {4,7}, {3,6}, {1,4}, {2,5}, {4,7}, {4,2}, {6,4}, {4,2}
+               };
+               for ( const auto& c : s_med9 )
+                  CompareExchange( v[c[0]], v[c[1]], m );
+               for ( int k = 0; k < m; ++k )
+                  f[x0+k] = v[4][k];
+            }
+            else
+            {
+               for ( int p = 1; p < N; p <<= 1 )
+                  for ( int q = p; q > 0; q >>= 1 )
+                     for ( int j = q % p; j + q < N; j += q << 1 )
+                        for ( int i = 0; i < q && i + j + q < N; ++i )
+                           if ( (i + j)/(p << 1) == (i + j + q)/(p << 1) )
+                              CompareExchange( v[i+j], v[i+j+q], m );
+               for ( int k = 0; k < m; ++k )
+                  f[x0+k] = P::FloatToSample( 0.5*(double( v[N/2][k] ) + double( v[N/2-1][k] )) );
+            }
+         }
+      }
+
+      static void MedianRow( sample* __restrict__ f, const sample* __restrict__ f0, int srcWidth, int width, int z,
+                             GenericVector<sample>& fm )
+      {
+         int z2 = z*z;
+         int n2 = z2 >> 1;
+         for ( int x = 0; x < width; ++x )
+         {
+            const sample* fyx = f0 + x*z;
+            sample* fmi = *fm;
+            for ( int i = 0; i < z; ++i, fyx += srcWidth )
+               for ( int j = 0; j < z; ++j )
+                  *fmi++ = fyx[j];
+
+            *f++ = (z & 1) ?
+                  *Select( *fm, fm.At( z2 ), n2 ) :
+                  P::FloatToSample( 0.5*(double( *Select( *fm, fm.At( z2 ), n2   ) ) +
+                                         double( *Select( *fm, fm.At( z2 ), n2-1 ) )) );
+         }
+      }
+   };
 };
 
 // ----------------------------------------------------------------------------
@@ -307,6 +577,33 @@ void IntegerResample::Apply( UInt32Image& image ) const
 
 // ----------------------------------------------------------------------------
 
+bool IntegerResample::ReadImage( FileFormatInstance& file, const ImageInfo& info, Image& image ) const
+{
+   return PCL_IntegerResampleEngine::Read( image, file, info, *this );
+}
+
+bool IntegerResample::ReadImage( FileFormatInstance& file, const ImageInfo& info, DImage& image ) const
+{
+   return PCL_IntegerResampleEngine::Read( image, file, info, *this );
+}
+
+bool IntegerResample::ReadImage( FileFormatInstance& file, const ImageInfo& info, UInt8Image& image ) const
+{
+   return PCL_IntegerResampleEngine::Read( image, file, info, *this );
+}
+
+bool IntegerResample::ReadImage( FileFormatInstance& file, const ImageInfo& info, UInt16Image& image ) const
+{
+   return PCL_IntegerResampleEngine::Read( image, file, info, *this );
+}
+
+bool IntegerResample::ReadImage( FileFormatInstance& file, const ImageInfo& info, UInt32Image& image ) const
+{
+   return PCL_IntegerResampleEngine::Read( image, file, info, *this );
+}
+
+// ----------------------------------------------------------------------------
+
 } // pcl
 
 // ----------------------------------------------------------------------------
@@ -0,0 +1,187 @@
+//     ____   ______ __
+//    / __ \ / ____// /
+//   / /_/ // /    / /
+//  / ____// /___ / /___   PixInsight Class Library
+// /_/     \____//_____/   PCL 2.8.5
+// ----------------------------------------------------------------------------
+// pcl/MeasurementContext.cpp - Released 2024-12-28T16:53:56Z
+// ----------------------------------------------------------------------------
+// This file is part of the PixInsight Class Library (PCL).
+// PCL is a multiplatform C++ framework for development of PixInsight modules.
+//
+// Copyright (c) 2003-2024 Pleiades Astrophoto S.L. All Rights Reserved.
+//
+// Redistribution and use in both source and binary forms, with or without
+// modification, is permitted provided that the following conditions are met:
+//
+// 1. All redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//
+// 2. All redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//
+// 3. Neither the names "PixInsight" and "Pleiades Astrophoto", nor the names
+//    of their contributors, may be used to endorse or promote products derived
+//    from this software without specific prior written permission. For written
+//    permission, please contact info@pixinsight.com.
+//
+// 4. All products derived from this software, in any form whatsoever, must
+//    reproduce the following acknowledgment in the end-user documentation
+//    and/or other materials provided with the product:
+//
+//    "This product is based on software from the PixInsight project, developed
+//    by Pleiades Astrophoto and its contributors (https://pixinsight.com/)."
+//
+//    Alternatively, if that is where third-party acknowledgments normally
+//    appear, this acknowledgment must be reproduced in the product itself.
+//
+// THIS SOFTWARE IS PROVIDED BY PLEIADES ASTROPHOTO AND ITS CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED
+// TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+// PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL PLEIADES ASTROPHOTO OR ITS
+// CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, BUSINESS
+// INTERRUPTION; PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; AND LOSS OF USE,
+// DATA OR PROFITS) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+// ----------------------------------------------------------------------------
+
+#include <pcl/MeasurementContext.h>
+
+namespace pcl
+{
+
+// ----------------------------------------------------------------------------
+
+void MeasurementContext::Clear()
+{
+   m_imageKey.Clear();
+   m_detectionKey.Clear();
+   m_images.Destroy();
+   m_stars.Clear();
+   m_psfs.Clear();
+   m_statistics.Clear();
+}
+
+// ----------------------------------------------------------------------------
+
+size_type MeasurementContext::ImageMemorySize() const
+{
+   size_type size = 0;
+   for ( const ImageItem& item : m_images )
+      size += item.image.ImageSize();
+   return size;
+}
+
+// ----------------------------------------------------------------------------
+
+bool MeasurementContext::GetStatistic( const ImageVariant& image, const IsoString& key, double& value )
+{
+   Bind( image );
+   for ( const StatisticItem& item : m_statistics )
+      if ( item.key == key )
+      {
+         value = item.value;
+         return true;
+      }
+   return false;
+}
+
+// ----------------------------------------------------------------------------
+
+void MeasurementContext::SetStatistic( const ImageVariant& image, const IsoString& key, double value )
+{
+   Bind( image );
+   for ( StatisticItem& item : m_statistics )
+      if ( item.key == key )
+      {
+         item.value = value;
+         return;
+      }
+   m_statistics << StatisticItem{ key, value };
+}
+
+// ----------------------------------------------------------------------------
+
+void MeasurementContext::Bind( const ImageVariant& image )
+{
+   /*
+    * The image identity is defined by the address of the image object and its
+    * geometry and color space. Pixel selections are not part of the identity;
+    * they are encoded in the keys of cached items where relevant.
+    */
+   IsoString key;
+   if ( image )
+      key = IsoString().Format( "%p:%d:%d:%d:%d:%d:%d", static_cast<const void*>( &*image ),
+                                image.Width(), image.Height(), image.NumberOfChannels(),
+                                image.ColorSpace(), image.IsFloatSample() ? 1 : 0, image.BitsPerSample() );
+   if ( key != m_imageKey )
+   {
+      Clear();
+      m_imageKey = key;
+   }
+}
+
+// ----------------------------------------------------------------------------
+
+Image* MeasurementContext::FindImage( const IsoString& key )
+{
+   for ( ImageItem& item : m_images )
+      if ( item.key == key )
+         return &item.image;
+   return nullptr;
+}
+
+// ----------------------------------------------------------------------------
+
+Image& MeasurementContext::AddImage( const IsoString& key )
+{
+   ImageItem* item = new ImageItem;
+   item->key = key;
+   m_images << item;
+   return item->image;
+}
+
+// ----------------------------------------------------------------------------
+
+const MeasurementContext::StarListItem* MeasurementContext::FindStars( const IsoString& key ) const
+{
+   for ( const StarListItem& item : m_stars )
+      if ( item.key == key )
+         return &item;
+   return nullptr;
+}
+
+// ----------------------------------------------------------------------------
+
+void MeasurementContext::AddStars( const IsoString& key, const StarDetector::star_list& stars, int minStarSize )
+{
+   m_stars << StarListItem{ key, stars, minStarSize };
+}
+
+// ----------------------------------------------------------------------------
+
+const Array<PSFData>* MeasurementContext::FindPSFs( const IsoString& key ) const
+{
+   for ( const PSFListItem& item : m_psfs )
+      if ( item.key == key )
+         return &item.psfs;
+   return nullptr;
+}
+
+// ----------------------------------------------------------------------------
+
+void MeasurementContext::AddPSFs( const IsoString& key, const Array<PSFData>& psfs )
+{
+   m_psfs << PSFListItem{ key, psfs };
+}
+
+// ----------------------------------------------------------------------------
+
+} // pcl
+
+// ----------------------------------------------------------------------------
+// EOF pcl/MeasurementContext.cpp - Released 2024-12-28T16:53:56Z
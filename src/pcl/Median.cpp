@@ -51,6 +51,7 @@
 
 #include <pcl/Math.h>
 #include <pcl/ReferenceArray.h>
+#include <pcl/SIMDDispatch.h>
 #include <pcl/Thread.h>
 #include <pcl/Vector.h>
 
@@ -122,112 +123,21 @@ private:
       }
    }
 
-#ifdef __PCL_AVX2
-
-   PCL_HOT_FUNCTION
    static void Build( SzVector& H, const float* __restrict__ A, size_type N, double low, double high )
    {
       const double range = high - low;
-      if ( 1 + range == 1 )
-         return;
-
-      const float s = float( (__PCL_MEDIAN_HISTOGRAM_LENGTH - 1)/range );
-      const float l = float( low );
-      const __m256 S = _mm256_set1_ps( s );
-      const __m256 L = _mm256_set1_ps( l );
-      const size_type stepLength = 0x40000000u;
-
-      for ( size_type p = 0; p < N; p += stepLength )
-      {
-         const float* __restrict__ V = A + p;
-         const int n = int( Min( stepLength, N - p ) );
-         const int n8 = n >> 3;
-
-         if ( ((ptrdiff_t)V) & 31 )
-            for ( int i = 0; i < n8; ++i )
-            {
-               __m256 v = _mm256_loadu_ps( (const float* __restrict__)(V + i*8) );
-               __m256i K = _mm256_cvttps_epi32( _mm256_mul_ps( _mm256_sub_ps( v, L ), S ) );
-               for ( int j = 0; j < 8; ++j )
-               {
-                  const int k = ((const int* __restrict__)&K)[j];
-                  if ( k >= 0 && k < __PCL_MEDIAN_HISTOGRAM_LENGTH )
-                     ++H[k];
-               }
-            }
-         else
-            for ( int i = 0; i < n8; ++i )
-            {
-               __m256i K = _mm256_cvttps_epi32( _mm256_mul_ps( _mm256_sub_ps( ((const __m256* __restrict__)V)[i], L ), S ) );
-               for ( int j = 0; j < 8; ++j )
-               {
-                  const int k = ((const int* __restrict__)&K)[j];
-                  if ( k >= 0 && k < __PCL_MEDIAN_HISTOGRAM_LENGTH )
-                     ++H[k];
-               }
-            }
-
-         for ( int i = n8 << 3; i < n; ++i )
-         {
-            const int k = TruncInt( s * (V[i] - l) );
-            if ( k >= 0 && k < __PCL_MEDIAN_HISTOGRAM_LENGTH )
-               ++H[k];
-         }
-      }
+      if ( 1 + range != 1 )
+         SIMD::Histogram( H.Begin(), __PCL_MEDIAN_HISTOGRAM_LENGTH, A, N,
+                          float( low ), float( (__PCL_MEDIAN_HISTOGRAM_LENGTH - 1)/range ) );
    }
 
-   PCL_HOT_FUNCTION
    static void Build( SzVector& H, const double* __restrict__ A, size_type N, double low, double high )
    {
       const double range = high - low;
-      if ( 1 + range == 1 )
-         return;
-
-      const double s = (__PCL_MEDIAN_HISTOGRAM_LENGTH - 1)/range;
-      const __m256d S = _mm256_set1_pd( s );
-      const __m256d L = _mm256_set1_pd( low );
-      const size_type stepLength = 0x40000000u;
-
-      for ( size_type p = 0; p < N; p += stepLength )
-      {
-         const double* __restrict__ V = A + p;
-         const int n = int( Min( stepLength, N - p ) );
-         const int n4 = n >> 2;
-
-         if ( ((ptrdiff_t)V) & 31 )
-            for ( int i = 0; i < n4; ++i )
-            {
-               __m256d v = _mm256_loadu_pd( (const double* __restrict__)(V + i*4) );
-               __m128i K = _mm256_cvttpd_epi32( _mm256_mul_pd( _mm256_sub_pd( v, L ), S ) );
-               for ( int j = 0; j < 4; ++j )
-               {
-                  const int k = ((const int* __restrict__)&K)[j];
-                  if ( k >= 0 && k < __PCL_MEDIAN_HISTOGRAM_LENGTH )
-                     ++H[k];
-               }
-            }
-         else
-            for ( int i = 0; i < n4; ++i )
-            {
-               __m128i K = _mm256_cvttpd_epi32( _mm256_mul_pd( _mm256_sub_pd( ((const __m256d* __restrict__)V)[i], L ), S ) );
-               for ( int j = 0; j < 4; ++j )
-               {
-                  const int k = ((const int* __restrict__)&K)[j];
-                  if ( k >= 0 && k < __PCL_MEDIAN_HISTOGRAM_LENGTH )
-                     ++H[k];
-               }
-            }
-
-         for ( int i = n4 << 2; i < n; ++i )
-         {
-            const int k = TruncInt( s * (V[i] - low) );
-            if ( k >= 0 && k < __PCL_MEDIAN_HISTOGRAM_LENGTH )
-               ++H[k];
-         }
-      }
+      if ( 1 + range != 1 )
+         SIMD::Histogram( H.Begin(), __PCL_MEDIAN_HISTOGRAM_LENGTH, A, N,
+                          low, (__PCL_MEDIAN_HISTOGRAM_LENGTH - 1)/range );
    }
-
-#endif // __PCL_AVX2
 };
 
 template <typename T>
@@ -268,125 +178,17 @@ private:
             max = A[i];
    }
 
-#ifdef __PCL_AVX2
-
-   PCL_HOT_FUNCTION
    static void Build( float& min, float& max, const float* __restrict__ A, size_type N )
    {
-      min = max = A[0];
-      const size_type stepLength = 0x40000000u;
-      if ( N >= 8 )
-      {
-         __m256 vmin = _mm256_loadu_ps( A );
-         __m256 vmax = vmin;
-         for ( size_type p = 0; p < N; p += stepLength )
-         {
-            const float* __restrict__ V = A + p;
-            const int n = int( Min( stepLength, N - p ) );
-            const int n8 = n >> 3;
-            if ( n8 > 0 )
-            {
-               if ( ((ptrdiff_t)V) & 31 )
-                  for ( int i = 0; i < n8; ++i )
-                  {
-                     __m256 v = _mm256_loadu_ps( (const float* __restrict__)(V + (i << 3)) );
-                     vmin = _mm256_min_ps( vmin, v );
-                     vmax = _mm256_max_ps( vmax, v );
-                  }
-               else
-                  for ( int i = 0; i < n8; ++i )
-                  {
-                     __m256 v = ((const __m256* __restrict__)V)[i];
-                     vmin = _mm256_min_ps( vmin, v );
-                     vmax = _mm256_max_ps( vmax, v );
-                  }
-
-               for ( int i = 0; i < 8; ++i )
-               {
-                  float vn = ((const float* __restrict__)&vmin)[i];
-                  float vx = ((const float* __restrict__)&vmax)[i];
-                  if ( vn < min )
-                     min = vn;
-                  if ( max < vx )
-                     max = vx;
-               }
-            }
-            for ( int i = n8 << 3; i < n; ++i )
-               if ( A[i] < min )
-                  min = A[i];
-               else if ( max < A[i] )
-                  max = A[i];
-         }
-      }
-      else
-      {
-         for ( size_type i = 1; i < N; ++i )
-            if ( A[i] < min )
-               min = A[i];
-            else if ( max < A[i] )
-               max = A[i];
-      }
+      min = SIMD::Min( A, N );
+      max = SIMD::Max( A, N );
    }
 
-   PCL_HOT_FUNCTION
    static void Build( double& min, double& max, const double* __restrict__ A, size_type N )
    {
-      min = max = A[0];
-      const size_type stepLength = 0x40000000u;
-      if ( N >= 4 )
-      {
-         __m256d vmin = _mm256_loadu_pd( A );
-         __m256d vmax = vmin;
-         for ( size_type p = 0; p < N; p += stepLength )
-         {
-            const double* __restrict__ V = A + p;
-            const int n = int( Min( stepLength, N - p ) );
-            const int n4 = n >> 2;
-            if ( n4 > 0 )
-            {
-               if ( ((ptrdiff_t)V) & 31 )
-                  for ( int i = 0; i < n4; ++i )
-                  {
-                     __m256d v = _mm256_loadu_pd( (const double* __restrict__)(V + (i << 2)) );
-                     vmin = _mm256_min_pd( vmin, v );
-                     vmax = _mm256_max_pd( vmax, v );
-                  }
-               else
-                  for ( int i = 0; i < n4; ++i )
-                  {
-                     __m256d v = ((const __m256d* __restrict__)V)[i];
-                     vmin = _mm256_min_pd( vmin, v );
-                     vmax = _mm256_max_pd( vmax, v );
-                  }
-
-               for ( int i = 0; i < 4; ++i )
-               {
-                  double vn = ((const double* __restrict__)&vmin)[i];
-                  double vx = ((const double* __restrict__)&vmax)[i];
-                  if ( vn < min )
-                     min = vn;
-                  if ( max < vx )
-                     max = vx;
-               }
-            }
-            for ( int i = n4 << 2; i < n; ++i )
-               if ( A[i] < min )
-                  min = A[i];
-               else if ( max < A[i] )
-                  max = A[i];
-         }
-      }
-      else
-      {
-         for ( size_type i = 1; i < N; ++i )
-            if ( A[i] < min )
-               min = A[i];
-            else if ( max < A[i] )
-               max = A[i];
-      }
+      min = SIMD::Min( A, N );
+      max = SIMD::Max( A, N );
    }
-
-#endif // __PCL_AVX2
 };
 
 // ----------------------------------------------------------------------------
@@ -1703,121 +1505,21 @@ private:
       }
    }
 
-#ifdef __PCL_AVX2
-
-   PCL_HOT_FUNCTION
    static void Build( SzVector& H, const float* __restrict__ A, size_type N, double center, double low, double high )
    {
       const double range = high - low;
-      if ( 1 + range == 1 )
-         return;
-
-      const float s = float( (__PCL_MEDIAN_HISTOGRAM_LENGTH - 1)/range );
-      const float l = float( low );
-      const float c = float( center );
-      const __m256 S = _mm256_set1_ps( s );
-      const __m256 L = _mm256_set1_ps( l );
-      const __m256 C = _mm256_set1_ps( c );
-      union { float f; uint32 u; } m; m.u = 0x7FFFFFFFu;
-      const __m256 M = _mm256_set1_ps( m.f );
-      const size_type stepLength = 0x40000000u;
-
-      for ( size_type p = 0; p < N; p += stepLength )
-      {
-         const float* __restrict__ V = A + p;
-         const int n = int( Min( stepLength, N - p ) );
-         const int n8 = n >> 3;
-
-         if ( ((ptrdiff_t)V) & 31 )
-            for ( int i = 0; i < n8; ++i )
-            {
-               __m256 v = _mm256_loadu_ps( (const float* __restrict__)(V + (i << 3)) );
-               __m256i K = _mm256_cvttps_epi32( _mm256_mul_ps( _mm256_sub_ps( _mm256_and_ps( _mm256_sub_ps( v, C ), M ), L ), S ) );
-               for ( int j = 0; j < 8; ++j )
-               {
-                  const int k = ((const int* __restrict__)&K)[j];
-                  if ( k >= 0 && k < __PCL_MEDIAN_HISTOGRAM_LENGTH )
-                     ++H[k];
-               }
-            }
-         else
-            for ( int i = 0; i < n8; ++i )
-            {
-               __m256i K = _mm256_cvttps_epi32( _mm256_mul_ps( _mm256_sub_ps( _mm256_and_ps(
-                                 _mm256_sub_ps( ((const __m256* __restrict__)V)[i], C ), M ), L ), S ) );
-               for ( int j = 0; j < 8; ++j )
-               {
-                  const int k = ((const int* __restrict__)&K)[j];
-                  if ( k >= 0 && k < __PCL_MEDIAN_HISTOGRAM_LENGTH )
-                     ++H[k];
-               }
-            }
-
-         for ( int i = n8 << 3; i < n; ++i )
-         {
-            const int k = TruncInt( s * (Abs( V[i] - c ) - l) );
-            if ( k >= 0 && k < __PCL_MEDIAN_HISTOGRAM_LENGTH )
-               ++H[k];
-         }
-      }
+      if ( 1 + range != 1 )
+         SIMD::AbsDevHistogram( H.Begin(), __PCL_MEDIAN_HISTOGRAM_LENGTH, A, N,
+                                float( center ), float( low ), float( (__PCL_MEDIAN_HISTOGRAM_LENGTH - 1)/range ) );
    }
 
-   PCL_HOT_FUNCTION
    static void Build( SzVector& H, const double* __restrict__ A, size_type N, double center, double low, double high )
    {
       const double range = high - low;
-      if ( 1 + range == 1 )
-         return;
-
-      const double s = (__PCL_MEDIAN_HISTOGRAM_LENGTH - 1)/range;
-      const __m256d S = _mm256_set1_pd( s );
-      const __m256d L = _mm256_set1_pd( low );
-      const __m256d C = _mm256_set1_pd( center );
-      union { double f; uint64 u; } m; m.u = 0x7FFFFFFFFFFFFFFFull;
-      const __m256d M = _mm256_set1_pd( m.f );
-      const size_type stepLength = 0x40000000u;
-
-      for ( size_type p = 0; p < N; p += stepLength )
-      {
-         const double* __restrict__ V = A + p;
-         const int n = int( Min( stepLength, N - p ) );
-         const int n4 = n >> 2;
-
-         if ( ((ptrdiff_t)V) & 31 )
-            for ( int i = 0; i < n4; ++i )
-            {
-               __m256d v = _mm256_loadu_pd( (const double* __restrict__)(V + (i << 2)) );
-               __m128i K = _mm256_cvttpd_epi32( _mm256_mul_pd( _mm256_sub_pd( _mm256_and_pd( _mm256_sub_pd( v, C ), M ), L ), S ) );
-               for ( int j = 0; j < 4; ++j )
-               {
-                  const int k = ((const int* __restrict__)&K)[j];
-                  if ( k >= 0 && k < __PCL_MEDIAN_HISTOGRAM_LENGTH )
-                     ++H[k];
-               }
-            }
-         else
-            for ( int i = 0; i < n4; ++i )
-            {
-               __m128i K = _mm256_cvttpd_epi32( _mm256_mul_pd( _mm256_sub_pd( _mm256_and_pd(
-                                 _mm256_sub_pd( ((const __m256d* __restrict__)V)[i], C ), M ), L ), S ) );
-               for ( int j = 0; j < 4; ++j )
-               {
-                  const int k = ((const int* __restrict__)&K)[j];
-                  if ( k >= 0 && k < __PCL_MEDIAN_HISTOGRAM_LENGTH )
-                     ++H[k];
-               }
-            }
-
-         for ( int i = n4 << 2; i < n; ++i )
-         {
-            const int k = TruncInt( s * (Abs( V[i] - center ) - low) );
-            if ( k >= 0 && k < __PCL_MEDIAN_HISTOGRAM_LENGTH )
-               ++H[k];
-         }
-      }
+      if ( 1 + range != 1 )
+         SIMD::AbsDevHistogram( H.Begin(), __PCL_MEDIAN_HISTOGRAM_LENGTH, A, N,
+                                center, low, (__PCL_MEDIAN_HISTOGRAM_LENGTH - 1)/range );
    }
-
-#endif // __PCL_AVX2
 };
 
 template <typename T>
@@ -2160,215 +1862,41 @@ private:
       }
    }
 
-#ifdef __PCL_AVX2
-
-   PCL_HOT_FUNCTION
+   /*
+    * Low deviations are accumulated as k = scale*(center - low - x), that is,
+    * as a histogram of x with a negative scale.
+    */
    static void BuildLow( SzVector& H, const float* __restrict__ A, size_type N, double center, double low, double high )
    {
       const double range = high - low;
-      if ( 1 + range == 1 )
-         return;
-
-      const float s = float( (__PCL_MEDIAN_HISTOGRAM_LENGTH - 1)/range );
-      const float c = float( center - low );
-      const __m256 S = _mm256_set1_ps( s );
-      const __m256 C = _mm256_set1_ps( c );
-      const size_type stepLength = 0x40000000u;
-
-      for ( size_type p = 0; p < N; p += stepLength )
-      {
-         const float* __restrict__ V = A + p;
-         const int n = int( Min( stepLength, N - p ) );
-         const int n8 = n >> 3;
-
-         if ( ((ptrdiff_t)V) & 31 )
-            for ( int i = 0; i < n8; ++i )
-            {
-               __m256 v = _mm256_loadu_ps( (const float* __restrict__)(V + (i << 3)) );
-               __m256i K = _mm256_cvttps_epi32( _mm256_mul_ps( _mm256_sub_ps( C, v ), S ) );
-               for ( int j = 0; j < 8; ++j )
-               {
-                  const int k = ((const int* __restrict__)&K)[j];
-                  if ( k >= 0 && k < __PCL_MEDIAN_HISTOGRAM_LENGTH )
-                     ++H[k];
-               }
-            }
-         else
-            for ( int i = 0; i < n8; ++i )
-            {
-               __m256i K = _mm256_cvttps_epi32( _mm256_mul_ps( _mm256_sub_ps( C, ((const __m256* __restrict__)V)[i] ), S ) );
-               for ( int j = 0; j < 8; ++j )
-               {
-                  const int k = ((const int* __restrict__)&K)[j];
-                  if ( k >= 0 && k < __PCL_MEDIAN_HISTOGRAM_LENGTH )
-                     ++H[k];
-               }
-            }
-
-         for ( int i = n8 << 3; i < n; ++i )
-         {
-            const int k = TruncInt( s * (c - V[i]) );
-            if ( k >= 0 && k < __PCL_MEDIAN_HISTOGRAM_LENGTH )
-               ++H[k];
-         }
-      }
+      if ( 1 + range != 1 )
+         SIMD::Histogram( H.Begin(), __PCL_MEDIAN_HISTOGRAM_LENGTH, A, N,
+                          float( center - low ), -float( (__PCL_MEDIAN_HISTOGRAM_LENGTH - 1)/range ) );
    }
 
-   PCL_HOT_FUNCTION
    static void BuildLow( SzVector& H, const double* __restrict__ A, size_type N, double center, double low, double high )
    {
       const double range = high - low;
-      if ( 1 + range == 1 )
-         return;
-
-      const double s = (__PCL_MEDIAN_HISTOGRAM_LENGTH - 1)/range;
-      const __m256d S = _mm256_set1_pd( s );
-      const __m256d C = _mm256_set1_pd( center - low );
-      const size_type stepLength = 0x40000000u;
-
-      for ( size_type p = 0; p < N; p += stepLength )
-      {
-         const double* __restrict__ V = A + p;
-         const int n = int( Min( stepLength, N - p ) );
-         const int n4 = n >> 2;
-
-         if ( ((ptrdiff_t)V) & 31 )
-            for ( int i = 0; i < n4; ++i )
-            {
-               __m256d v = _mm256_loadu_pd( (const double* __restrict__)(V + (i << 2)) );
-               __m128i K = _mm256_cvttpd_epi32( _mm256_mul_pd( _mm256_sub_pd( C, v ), S ) );
-               for ( int j = 0; j < 4; ++j )
-               {
-                  const int k = ((const int* __restrict__)&K)[j];
-                  if ( k >= 0 && k < __PCL_MEDIAN_HISTOGRAM_LENGTH )
-                     ++H[k];
-               }
-            }
-         else
-            for ( int i = 0; i < n4; ++i )
-            {
-               __m128i K = _mm256_cvttpd_epi32( _mm256_mul_pd( _mm256_sub_pd( C, ((const __m256d* __restrict__)V)[i] ), S ) );
-               for ( int j = 0; j < 4; ++j )
-               {
-                  const int k = ((const int* __restrict__)&K)[j];
-                  if ( k >= 0 && k < __PCL_MEDIAN_HISTOGRAM_LENGTH )
-                     ++H[k];
-               }
-            }
-
-         for ( int i = n4 << 2; i < n; ++i )
-         {
-            const int k = TruncInt( s * (center - V[i]) );
-            if ( k >= 0 && k < __PCL_MEDIAN_HISTOGRAM_LENGTH )
-               ++H[k];
-         }
-      }
+      if ( 1 + range != 1 )
+         SIMD::Histogram( H.Begin(), __PCL_MEDIAN_HISTOGRAM_LENGTH, A, N,
+                          center - low, -(__PCL_MEDIAN_HISTOGRAM_LENGTH - 1)/range );
    }
 
-   PCL_HOT_FUNCTION
    static void BuildHigh( SzVector& H, const float* __restrict__ A, size_type N, double center, double low, double high )
    {
       const double range = high - low;
-      if ( 1 + range == 1 )
-         return;
-
-      const float s = float( (__PCL_MEDIAN_HISTOGRAM_LENGTH - 1)/range );
-      const float c = float( center + low );
-      const __m256 S = _mm256_set1_ps( s );
-      const __m256 C = _mm256_set1_ps( c );
-      const size_type stepLength = 0x40000000u;
-
-      for ( size_type p = 0; p < N; p += stepLength )
-      {
-         const float* __restrict__ V = A + p;
-         const int n = int( Min( stepLength, N - p ) );
-         const int n8 = n >> 3;
-
-         if ( ((ptrdiff_t)V) & 31 )
-            for ( int i = 0; i < n8; ++i )
-            {
-               __m256 v = _mm256_loadu_ps( (const float* __restrict__)(V + (i << 3)) );
-               __m256i K = _mm256_cvttps_epi32( _mm256_mul_ps( _mm256_sub_ps( v, C ), S ) );
-               for ( int j = 0; j < 8; ++j )
-               {
-                  const int k = ((const int* __restrict__)&K)[j];
-                  if ( k >= 0 && k < __PCL_MEDIAN_HISTOGRAM_LENGTH )
-                     ++H[k];
-               }
-            }
-         else
-            for ( int i = 0; i < n8; ++i )
-            {
-               __m256i K = _mm256_cvttps_epi32( _mm256_mul_ps( _mm256_sub_ps( ((const __m256* __restrict__)V)[i], C ), S ) );
-               for ( int j = 0; j < 8; ++j )
-               {
-                  const int k = ((const int* __restrict__)&K)[j];
-                  if ( k >= 0 && k < __PCL_MEDIAN_HISTOGRAM_LENGTH )
-                     ++H[k];
-               }
-            }
-
-         for ( int i = n8 << 3; i < n; ++i )
-         {
-            const int k = TruncInt( s * (V[i] - c) );
-            if ( k >= 0 && k < __PCL_MEDIAN_HISTOGRAM_LENGTH )
-               ++H[k];
-         }
-      }
+      if ( 1 + range != 1 )
+         SIMD::Histogram( H.Begin(), __PCL_MEDIAN_HISTOGRAM_LENGTH, A, N,
+                          float( center + low ), float( (__PCL_MEDIAN_HISTOGRAM_LENGTH - 1)/range ) );
    }
 
-   PCL_HOT_FUNCTION
    static void BuildHigh( SzVector& H, const double* __restrict__ A, size_type N, double center, double low, double high )
    {
       const double range = high - low;
-      if ( 1 + range == 1 )
-         return;
-
-      const double s = (__PCL_MEDIAN_HISTOGRAM_LENGTH - 1)/range;
-      const __m256d S = _mm256_set1_pd( s );
-      const __m256d C = _mm256_set1_pd( center + low );
-      const size_type stepLength = 0x40000000u;
-
-      for ( size_type p = 0; p < N; p += stepLength )
-      {
-         const double* __restrict__ V = A + p;
-         const int n = int( Min( stepLength, N - p ) );
-         const int n4 = n >> 2;
-
-         if ( ((ptrdiff_t)V) & 31 )
-            for ( int i = 0; i < n4; ++i )
-            {
-               __m256d v = _mm256_loadu_pd( (const double* __restrict__)(V + (i << 2)) );
-               __m128i K = _mm256_cvttpd_epi32( _mm256_mul_pd( _mm256_sub_pd( v, C ), S ) );
-               for ( int j = 0; j < 4; ++j )
-               {
-                  const int k = ((const int* __restrict__)&K)[j];
-                  if ( k >= 0 && k < __PCL_MEDIAN_HISTOGRAM_LENGTH )
-                     ++H[k];
-               }
-            }
-         else
-            for ( int i = 0; i < n4; ++i )
-            {
-               __m128i K = _mm256_cvttpd_epi32( _mm256_mul_pd( _mm256_sub_pd( ((const __m256d* __restrict__)V)[i], C ), S ) );
-               for ( int j = 0; j < 4; ++j )
-               {
-                  const int k = ((const int* __restrict__)&K)[j];
-                  if ( k >= 0 && k < __PCL_MEDIAN_HISTOGRAM_LENGTH )
-                     ++H[k];
-               }
-            }
-
-         for ( int i = n4 << 2; i < n; ++i )
-         {
-            const int k = TruncInt( s * (V[i] - center) );
-            if ( k >= 0 && k < __PCL_MEDIAN_HISTOGRAM_LENGTH )
-               ++H[k];
-         }
-      }
+      if ( 1 + range != 1 )
+         SIMD::Histogram( H.Begin(), __PCL_MEDIAN_HISTOGRAM_LENGTH, A, N,
+                          center + low, (__PCL_MEDIAN_HISTOGRAM_LENGTH - 1)/range );
    }
-
-#endif // __PCL_AVX2
 };
 
 template <typename T>
@@ -50,6 +50,7 @@
 // ----------------------------------------------------------------------------
 
 #include <pcl/AutoStatusCallbackRestorer.h>
+#include <pcl/MeasurementContext.h>
 #include <pcl/MuteStatus.h>
 #include <pcl/PSFEstimator.h>
 #include <pcl/QuadTree.h>
@@ -155,6 +156,20 @@ private:
 // ----------------------------------------------------------------------------
 
 Array<PSFData> PSFEstimator::FitStars( const ImageVariant& image ) const
+{
+   return FitStars( image, nullptr );
+}
+
+// ----------------------------------------------------------------------------
+
+Array<PSFData> PSFEstimator::FitStars( const ImageVariant& image, MeasurementContext& context ) const
+{
+   return FitStars( image, &context );
+}
+
+// ----------------------------------------------------------------------------
+
+Array<PSFData> PSFEstimator::FitStars( const ImageVariant& image, MeasurementContext* context ) const
 {
    bool initializeStatus = image.Status().IsInitializationEnabled();
 
@@ -176,12 +191,26 @@ Array<PSFData> PSFEstimator::FitStars( const ImageVariant& image ) const
                                                          : double( m_saturationThreshold ) );
       m_starDetector.EnableParallelProcessing( IsParallelProcessingEnabled() );
       m_starDetector.SetMaxProcessors( MaxProcessors() );
-      stars = m_starDetector.DetectStars( image );
+      stars = (context != nullptr) ? m_starDetector.DetectStars( image, *context )
+                                   : m_starDetector.DetectStars( image );
 
       if ( initializeStatus )
          image.Status().EnableInitialization();
    }
 
+   /*
+    * Reuse PSF fits previously performed with the same parameters.
+    */
+   IsoString fitsKey;
+   if ( context != nullptr )
+   {
+      fitsKey = context->m_detectionKey + IsoString().Format( ":PSFEstimator:%d,%.8g,%.8g,%.8g,%d,%d",
+                                 int( m_psfType ), m_psfCentroidTolerance, m_rejectionLimit, m_growthForFlux,
+                                 m_maxStars, int( m_weighted ) );
+      if ( const Array<PSFData>* cached = context->FindPSFs( fitsKey ) )
+         return *cached;
+   }
+
    if ( !stars.IsEmpty() )
    {
       /*
@@ -264,6 +293,9 @@ Array<PSFData> PSFEstimator::FitStars( const ImageVariant& image ) const
    if ( initializeStatus )
       image.Status().EnableInitialization();
 
+   if ( context != nullptr )
+      context->AddPSFs( fitsKey, psfs );
+
    return psfs;
 }
 
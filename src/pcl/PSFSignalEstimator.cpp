@@ -51,6 +51,7 @@
 
 #include <pcl/AutoPointer.h>
 #include <pcl/GridInterpolation.h>
+#include <pcl/MeasurementContext.h>
 #include <pcl/MultiscaleMedianTransform.h>
 #include <pcl/PSFSignalEstimator.h>
 #include <pcl/Resample.h>
@@ -293,13 +294,27 @@ Array<float> PSFSignalEstimator::LocalBackgroundResidual( const ImageVariant& im
 // ----------------------------------------------------------------------------
 
 PSFSignalEstimator::Estimates PSFSignalEstimator::EstimateSignal( const ImageVariant& image ) const
+{
+   return EstimateSignal( image, nullptr );
+}
+
+// ----------------------------------------------------------------------------
+
+PSFSignalEstimator::Estimates PSFSignalEstimator::EstimateSignal( const ImageVariant& image, MeasurementContext& context ) const
+{
+   return EstimateSignal( image, &context );
+}
+
+// ----------------------------------------------------------------------------
+
+PSFSignalEstimator::Estimates PSFSignalEstimator::EstimateSignal( const ImageVariant& image, MeasurementContext* context ) const
 {
    Estimates E;
 
    /*
     * Detect sources and fit PSF models.
     */
-   Array<PSFData> psfs = FitStars( image );
+   Array<PSFData> psfs = (context != nullptr) ? FitStars( image, *context ) : FitStars( image );
 
    if ( !psfs.IsEmpty() )
    {
@@ -382,9 +397,26 @@ PSFSignalEstimator::Estimates PSFSignalEstimator::EstimateSignal( const ImageVar
        * M* robust mean background estimate.
        * N* robust noise estimate.
        */
+      IsoString key;
+      if ( context != nullptr )
+      {
+         Rect r = image.SelectedRectangle();
+         key = IsoString().Format( "PSFSignalEstimator:%d,%d,%d,%d:%d:%d",
+                                   r.x0, r.y0, r.x1, r.y1, image.SelectedChannel(), m_scale );
+         if ( context->GetStatistic( image, key + ":MStar", E.MStar ) )
+            if ( context->GetStatistic( image, key + ":NStar", E.NStar ) )
+               return E;
+      }
+
       Array<float> R = LocalBackgroundResidual( image, m_scale, MaxProcessors() );
       E.MStar = Median( R.Begin(), R.End() );
       E.NStar = NStar( R );
+
+      if ( context != nullptr )
+      {
+         context->SetStatistic( image, key + ":MStar", E.MStar );
+         context->SetStatistic( image, key + ":NStar", E.NStar );
+      }
    }
 
    return E;
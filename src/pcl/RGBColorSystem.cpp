@@ -49,8 +49,10 @@
 // POSSIBILITY OF SUCH DAMAGE.
 // ----------------------------------------------------------------------------
 
-#include <pcl/RGBColorSystem.h>
 #include <pcl/Exception.h>
+#include <pcl/RGBColorSystem.h>
+#include <pcl/Random.h>
+#include <pcl/SIMDDispatch.h>
 
 namespace pcl
 {
@@ -401,6 +403,1184 @@ void RGBColorSystem::Data::Initialize()
 
 // ----------------------------------------------------------------------------
 
+// ----------------------------------------------------------------------------
+// Batch Conversions
+// ----------------------------------------------------------------------------
+
+#ifdef __PCL_SIMD_DISPATCH
+
+/*
+ * Vectorized natural logarithm and exponential functions for 32-bit floating
+ * point arguments, adapted from the Cephes library (logf, expf). Relative
+ * errors are smaller than 2.5e-7 for normal positive arguments of the
+ * logarithm, and for arguments of the exponential in [-87,88].
+ */
+__PCL_TARGET_AVX2
+static inline __m256 __pcl_log_ps( __m256 x )
+{
+   const __m256 one = _mm256_set1_ps( 1.0F );
+   __m256i ix = _mm256_castps_si256( x );
+   __m256 e = _mm256_cvtepi32_ps( _mm256_sub_epi32( _mm256_srli_epi32( ix, 23 ), _mm256_set1_epi32( 126 ) ) );
+   x = _mm256_castsi256_ps( _mm256_or_si256( _mm256_and_si256( ix, _mm256_set1_epi32( 0x007fffff ) ),
+                                             _mm256_set1_epi32( 0x3f000000 ) ) ); // mantissa in [0.5,1)
+   __m256 mask = _mm256_cmp_ps( x, _mm256_set1_ps( 0.707106781186547524F ), _CMP_LT_OQ );
+   __m256 t = _mm256_and_ps( x, mask );
+   x = _mm256_sub_ps( x, one );
+   e = _mm256_sub_ps( e, _mm256_and_ps( one, mask ) );
+   x = _mm256_add_ps( x, t );
+   __m256 z = _mm256_mul_ps( x, x );
+   __m256 y =          _mm256_set1_ps(  7.0376836292e-2F );
+   y = _mm256_fmadd_ps( y, x, _mm256_set1_ps( -1.1514610310e-1F ) );
+   y = _mm256_fmadd_ps( y, x, _mm256_set1_ps(  1.1676998740e-1F ) );
+   y = _mm256_fmadd_ps( y, x, _mm256_set1_ps( -1.2420140846e-1F ) );
+   y = _mm256_fmadd_ps( y, x, _mm256_set1_ps(  1.4249322787e-1F ) );
+   y = _mm256_fmadd_ps( y, x, _mm256_set1_ps( -1.6668057665e-1F ) );
+   y = _mm256_fmadd_ps( y, x, _mm256_set1_ps(  2.0000714765e-1F ) );
+   y = _mm256_fmadd_ps( y, x, _mm256_set1_ps( -2.4999993993e-1F ) );
+   y = _mm256_fmadd_ps( y, x, _mm256_set1_ps(  3.3333331174e-1F ) );
+   y = _mm256_mul_ps( _mm256_mul_ps( y, x ), z );
+   y = _mm256_fmadd_ps( e, _mm256_set1_ps( -2.12194440e-4F ), y );
+   y = _mm256_fnmadd_ps( z, _mm256_set1_ps( 0.5F ), y );
+   x = _mm256_add_ps( x, y );
+   return _mm256_fmadd_ps( e, _mm256_set1_ps( 0.693359375F ), x );
+}
+
+__PCL_TARGET_AVX2
+static inline __m256 __pcl_exp_ps( __m256 x )
+{
+   x = _mm256_min_ps( _mm256_max_ps( x, _mm256_set1_ps( -87.0F ) ), _mm256_set1_ps( 88.0F ) );
+   __m256 fx = _mm256_floor_ps( _mm256_fmadd_ps( x, _mm256_set1_ps( 1.44269504088896341F ), _mm256_set1_ps( 0.5F ) ) );
+   x = _mm256_fnmadd_ps( fx, _mm256_set1_ps( 0.693359375F ), x );
+   x = _mm256_fnmadd_ps( fx, _mm256_set1_ps( -2.12194440e-4F ), x );
+   __m256 z = _mm256_mul_ps( x, x );
+   __m256 y =          _mm256_set1_ps( 1.9875691500e-4F );
+   y = _mm256_fmadd_ps( y, x, _mm256_set1_ps( 1.3981999507e-3F ) );
+   y = _mm256_fmadd_ps( y, x, _mm256_set1_ps( 8.3334519073e-3F ) );
+   y = _mm256_fmadd_ps( y, x, _mm256_set1_ps( 4.1665795894e-2F ) );
+   y = _mm256_fmadd_ps( y, x, _mm256_set1_ps( 1.6666665459e-1F ) );
+   y = _mm256_fmadd_ps( y, x, _mm256_set1_ps( 5.0000001201e-1F ) );
+   y = _mm256_add_ps( _mm256_fmadd_ps( y, z, x ), _mm256_set1_ps( 1.0F ) );
+   __m256i n = _mm256_slli_epi32( _mm256_add_epi32( _mm256_cvttps_epi32( fx ), _mm256_set1_epi32( 127 ) ), 23 );
+   return _mm256_mul_ps( y, _mm256_castsi256_ps( n ) );
+}
+
+/*
+ * x^y for x >= 0. Zero and subnormal arguments yield zero.
+ */
+__PCL_TARGET_AVX2
+static inline __m256 __pcl_pow_ps( __m256 x, __m256 y )
+{
+   return _mm256_and_ps( __pcl_exp_ps( _mm256_mul_ps( y, __pcl_log_ps( x ) ) ),
+                         _mm256_cmp_ps( x, _mm256_set1_ps( 1.17549435e-38F ), _CMP_GE_OQ ) );
+}
+
+__PCL_TARGET_AVX2
+static inline __m256 __pcl_range_ps( __m256 x )
+{
+   return _mm256_min_ps( _mm256_max_ps( x, _mm256_setzero_ps() ), _mm256_set1_ps( 1.0F ) );
+}
+
+#endif // __PCL_SIMD_DISPATCH
+
+/*
+ * CIE L*a*b* constants, see RGBColorSystem.h
+ */
+#define _16_116         1.379310344827586e-01 // 16/116
+#define CIEEpsilon      8.856451679035631e-03 // 216/24389
+#define CIEKappa116     7.787037037037037e+00 // CIEKappa/116
+
+// ----------------------------------------------------------------------------
+
+class PCL_RGBColorSystemEngine
+{
+public:
+
+   using Data = RGBColorSystem::Data;
+
+   /*
+    * Single-precision working space parameters, with normalization of CIE X,
+    * Z, a* and b* components folded into transformation coefficients.
+    */
+   struct Parameters
+   {
+      float M[ 9 ];     // RGB -> normalized XYZ
+      float M_[ 9 ];    // normalized XYZ -> RGB
+      float gamma, gammaInv;
+      float mA, mB, mC; // normalization factors of a*, b*, c*
+      float zA, zB;     // zero offsets of a*, b*
+      bool  issRGB, isLinear;
+
+      Parameters( const Data& d )
+         : gamma( d.gamma )
+         , gammaInv( d.gammaInv )
+         , mA( float( d.mA ) )
+         , mB( float( d.mB ) )
+         , mC( float( d.mC ) )
+         , zA( float( d.zA ) )
+         , zB( float( d.zB ) )
+         , issRGB( d.issRGB )
+         , isLinear( d.isLinear )
+      {
+         for ( int i = 0; i < 3; ++i )
+         {
+            M[i]   = float( d.M[i]/d.mX );
+            M[3+i] = float( d.M[3+i] );
+            M[6+i] = float( d.M[6+i]/d.mZ );
+            M_[3*i]   = float( d.M_[3*i]*d.mX );
+            M_[3*i+1] = float( d.M_[3*i+1] );
+            M_[3*i+2] = float( d.M_[3*i+2]*d.mZ );
+         }
+      }
+   };
+
+   /*
+    * Batch conversion kernels. All three-component conversions share the same
+    * function type: three output arrays, three input arrays, the number of
+    * elements and a conversion flag, whose meaning depends on the conversion
+    * (linearization of input RGB components, or lightness instead of
+    * luminance for RGBToCIEY). Single-component conversions use the first
+    * output array only.
+    */
+   using transfer_function = void (*)( const Parameters&, float*, size_type );
+   using conversion_function = void (*)( const Parameters&, float*, float*, float*,
+                                         const float*, const float*, const float*, size_type, bool );
+
+   static SIMDKernel<transfer_function>& LinearRGB();
+   static SIMDKernel<transfer_function>& GammaRGB();
+   static SIMDKernel<conversion_function>& RGBToCIEXYZ();
+   static SIMDKernel<conversion_function>& CIEXYZToRGB();
+   static SIMDKernel<conversion_function>& RGBToCIEY();
+   static SIMDKernel<conversion_function>& RGBToCIELab();
+   static SIMDKernel<conversion_function>& CIELabToRGB();
+   static SIMDKernel<conversion_function>& RGBToCIELch();
+   static SIMDKernel<conversion_function>& CIELchToRGB();
+
+   /*
+    * HSV and HSI are color ordering systems not based on an RGB working
+    * space, so their conversion kernels don't depend on working space
+    * parameters.
+    */
+   using ordering_function = void (*)( float*, float*, float*, const float*, const float*, const float*, size_type );
+
+   static SIMDKernel<ordering_function>& RGBToHSV();
+   static SIMDKernel<ordering_function>& RGBToHSI();
+   static SIMDKernel<ordering_function>& HSVToRGB();
+   static SIMDKernel<ordering_function>& HSIToRGB();
+
+private:
+
+   /*
+    * Scalar component transformations.
+    */
+
+   static float Range( float x )
+   {
+      return pcl::Range( x, 0.0F, 1.0F );
+   }
+
+   static float Linear( const Parameters& P, float x )
+   {
+      return float( P.issRGB ? RGBColorSystem::SRGBToLinear( x ) : pcl::Pow( double( x ), double( P.gamma ) ) );
+   }
+
+   static float Gamma( const Parameters& P, float x )
+   {
+      return float( P.issRGB ? RGBColorSystem::LinearToSRGB( x ) : pcl::Pow( double( x ), double( P.gammaInv ) ) );
+   }
+
+   static float XYZLab( float x )
+   {
+      double y = x;
+      RGBColorSystem::XYZLab( y );
+      return float( y );
+   }
+
+   static float LabXYZ( float x )
+   {
+      double y = x;
+      RGBColorSystem::LabXYZ( y );
+      return float( y );
+   }
+
+   static void ToXYZ( const Parameters& P, float& X, float& Y, float& Z, float R, float G, float B, bool linearize )
+   {
+      if ( linearize )
+      {
+         R = Linear( P, R );
+         G = Linear( P, G );
+         B = Linear( P, B );
+      }
+      X = Range( P.M[0]*R + P.M[1]*G + P.M[2]*B );
+      Y = Range( P.M[3]*R + P.M[4]*G + P.M[5]*B );
+      Z = Range( P.M[6]*R + P.M[7]*G + P.M[8]*B );
+   }
+
+   static void FromXYZ( const Parameters& P, float& R, float& G, float& B, float X, float Y, float Z )
+   {
+      R = Range( P.M_[0]*X + P.M_[1]*Y + P.M_[2]*Z );
+      G = Range( P.M_[3]*X + P.M_[4]*Y + P.M_[5]*Z );
+      B = Range( P.M_[6]*X + P.M_[7]*Y + P.M_[8]*Z );
+      if ( !P.isLinear )
+      {
+         R = Gamma( P, R );
+         G = Gamma( P, G );
+         B = Gamma( P, B );
+      }
+   }
+
+   /*
+    * Conversion from CIE L* and nonnormalized a*, b* components to RGB.
+    */
+   static void FromLab( const Parameters& P, float& R, float& G, float& B, float L, float a, float b )
+   {
+      float Y = (L + 0.16F)/1.16F;
+      float X = a/5 + Y;
+      float Z = Y - b/2;
+      FromXYZ( P, R, G, B, LabXYZ( X ), LabXYZ( Y ), LabXYZ( Z ) );
+   }
+
+   /*
+    * Normalized hue in [0,1) from nonnormalized CIE a*, b* components.
+    */
+   static float Hue( float b, float a )
+   {
+      double h = pcl::ArcTan( double( b ), double( a ) );
+      if ( h < 0 )
+         h += Const<double>::_2pi();
+      return float( h/Const<double>::_2pi() );
+   }
+
+   /*
+    * Portable implementations.
+    */
+
+   static void LinearRGBGeneric( const Parameters& P, float* x, size_type n )
+   {
+      for ( size_type i = 0; i < n; ++i )
+         x[i] = Linear( P, x[i] );
+   }
+
+   static void GammaRGBGeneric( const Parameters& P, float* x, size_type n )
+   {
+      for ( size_type i = 0; i < n; ++i )
+         x[i] = Gamma( P, x[i] );
+   }
+
+   static void RGBToCIEXYZGeneric( const Parameters& P, float* X, float* Y, float* Z,
+                                   const float* R, const float* G, const float* B, size_type n, bool linearize )
+   {
+      for ( size_type i = 0; i < n; ++i )
+      {
+         float x, y, z;
+         ToXYZ( P, x, y, z, R[i], G[i], B[i], linearize );
+         X[i] = x;
+         Y[i] = y;
+         Z[i] = z;
+      }
+   }
+
+   static void CIEXYZToRGBGeneric( const Parameters& P, float* R, float* G, float* B,
+                                   const float* X, const float* Y, const float* Z, size_type n, bool )
+   {
+      for ( size_type i = 0; i < n; ++i )
+      {
+         float r, g, b;
+         FromXYZ( P, r, g, b, X[i], Y[i], Z[i] );
+         R[i] = r;
+         G[i] = g;
+         B[i] = b;
+      }
+   }
+
+   static void RGBToCIEYGeneric( const Parameters& P, float* Y, float*, float*,
+                                 const float* R, const float* G, const float* B, size_type n, bool lightness )
+   {
+      const bool linearize = !P.isLinear;
+      for ( size_type i = 0; i < n; ++i )
+      {
+         float r = R[i], g = G[i], b = B[i];
+         if ( linearize )
+         {
+            r = Linear( P, r );
+            g = Linear( P, g );
+            b = Linear( P, b );
+         }
+         float y = Range( P.M[3]*r + P.M[4]*g + P.M[5]*b );
+         Y[i] = lightness ? 1.16F*XYZLab( y ) - 0.16F : y;
+      }
+   }
+
+   static void RGBToCIELabGeneric( const Parameters& P, float* L, float* a, float* b,
+                                   const float* R, const float* G, const float* B, size_type n, bool linearize )
+   {
+      for ( size_type i = 0; i < n; ++i )
+      {
+         float x, y, z;
+         ToXYZ( P, x, y, z, R[i], G[i], B[i], linearize );
+         x = XYZLab( x );
+         y = XYZLab( y );
+         z = XYZLab( z );
+         L[i] = Range( 1.16F*y - 0.16F );
+         a[i] = Range( (5*(x - y) + P.zA)/P.mA );
+         b[i] = Range( (2*(y - z) + P.zB)/P.mB );
+      }
+   }
+
+   static void CIELabToRGBGeneric( const Parameters& P, float* R, float* G, float* B,
+                                   const float* L, const float* a, const float* b, size_type n, bool )
+   {
+      for ( size_type i = 0; i < n; ++i )
+      {
+         float r, g, v;
+         FromLab( P, r, g, v, L[i], P.mA*a[i] - P.zA, P.mB*b[i] - P.zB );
+         R[i] = r;
+         G[i] = g;
+         B[i] = v;
+      }
+   }
+
+   static void RGBToCIELchGeneric( const Parameters& P, float* L, float* c, float* h,
+                                   const float* R, const float* G, const float* B, size_type n, bool linearize )
+   {
+      for ( size_type i = 0; i < n; ++i )
+      {
+         float x, y, z;
+         ToXYZ( P, x, y, z, R[i], G[i], B[i], linearize );
+         x = XYZLab( x );
+         y = XYZLab( y );
+         z = XYZLab( z );
+         float a = 5*(x - y);
+         float b = 2*(y - z);
+         L[i] = Range( 1.16F*y - 0.16F );
+         c[i] = Range( pcl::Sqrt( a*a + b*b )/P.mC );
+         h[i] = Hue( b, a );
+      }
+   }
+
+   static void CIELchToRGBGeneric( const Parameters& P, float* R, float* G, float* B,
+                                   const float* L, const float* c, const float* h, size_type n, bool )
+   {
+      for ( size_type i = 0; i < n; ++i )
+      {
+         double sh, ch;
+         pcl::SinCos( double( h[i] )*Const<double>::_2pi(), sh, ch );
+         double ci = double( c[i] )*P.mC;
+         float r, g, v;
+         FromLab( P, r, g, v, L[i], float( ci*ch ), float( ci*sh ) );
+         R[i] = r;
+         G[i] = g;
+         B[i] = v;
+      }
+   }
+
+   static void RGBToHSVGeneric( float* H, float* S, float* V, const float* R, const float* G, const float* B, size_type n )
+   {
+      for ( size_type i = 0; i < n; ++i )
+      {
+         RGBColorSystem::sample h, s, v;
+         RGBColorSystem::RGBToHSV( h, s, v, R[i], G[i], B[i] );
+         H[i] = float( h );
+         S[i] = float( s );
+         V[i] = float( v );
+      }
+   }
+
+   static void RGBToHSIGeneric( float* H, float* S, float* I, const float* R, const float* G, const float* B, size_type n )
+   {
+      for ( size_type i = 0; i < n; ++i )
+      {
+         RGBColorSystem::sample h, s, v;
+         RGBColorSystem::RGBToHSI( h, s, v, R[i], G[i], B[i] );
+         H[i] = float( h );
+         S[i] = float( s );
+         I[i] = float( v );
+      }
+   }
+
+   static void HSVToRGBGeneric( float* R, float* G, float* B, const float* H, const float* S, const float* V, size_type n )
+   {
+      for ( size_type i = 0; i < n; ++i )
+      {
+         RGBColorSystem::sample r, g, b;
+         RGBColorSystem::HSVToRGB( r, g, b, H[i], S[i], V[i] );
+         R[i] = float( r );
+         G[i] = float( g );
+         B[i] = float( b );
+      }
+   }
+
+   static void HSIToRGBGeneric( float* R, float* G, float* B, const float* H, const float* S, const float* I, size_type n )
+   {
+      for ( size_type i = 0; i < n; ++i )
+      {
+         RGBColorSystem::sample r, g, b;
+         RGBColorSystem::HSIToRGB( r, g, b, H[i], S[i], I[i] );
+         R[i] = float( r );
+         G[i] = float( g );
+         B[i] = float( b );
+      }
+   }
+
+#ifdef __PCL_SIMD_DISPATCH
+
+   /*
+    * Vectorized component transformations.
+    */
+
+   __PCL_TARGET_AVX2
+   static __m256 Linear( const Parameters& P, __m256 x )
+   {
+      if ( P.issRGB )
+      {
+         __m256 p = __pcl_pow_ps( _mm256_mul_ps( _mm256_add_ps( x, _mm256_set1_ps( 0.055F ) ), _mm256_set1_ps( float( 1/1.055 ) ) ),
+                                  _mm256_set1_ps( 2.4F ) );
+         __m256 l = _mm256_mul_ps( x, _mm256_set1_ps( float( 1/12.92 ) ) );
+         return _mm256_blendv_ps( l, p, _mm256_cmp_ps( x, _mm256_set1_ps( 0.04045F ), _CMP_GT_OQ ) );
+      }
+      return __pcl_pow_ps( x, _mm256_set1_ps( P.gamma ) );
+   }
+
+   __PCL_TARGET_AVX2
+   static __m256 Gamma( const Parameters& P, __m256 x )
+   {
+      if ( P.issRGB )
+      {
+         __m256 p = _mm256_fmsub_ps( _mm256_set1_ps( 1.055F ), __pcl_pow_ps( x, _mm256_set1_ps( float( 1/2.4 ) ) ), _mm256_set1_ps( 0.055F ) );
+         __m256 l = _mm256_mul_ps( x, _mm256_set1_ps( 12.92F ) );
+         return _mm256_blendv_ps( l, p, _mm256_cmp_ps( x, _mm256_set1_ps( 0.0031308F ), _CMP_GT_OQ ) );
+      }
+      return __pcl_pow_ps( x, _mm256_set1_ps( P.gammaInv ) );
+   }
+
+   __PCL_TARGET_AVX2
+   static __m256 XYZLab( __m256 x )
+   {
+      __m256 p = __pcl_pow_ps( x, _mm256_set1_ps( float( 1.0/3 ) ) );
+      __m256 l = _mm256_fmadd_ps( x, _mm256_set1_ps( float( CIEKappa116 ) ), _mm256_set1_ps( float( _16_116 ) ) );
+      return _mm256_blendv_ps( l, p, _mm256_cmp_ps( x, _mm256_set1_ps( float( CIEEpsilon ) ), _CMP_GT_OQ ) );
+   }
+
+   __PCL_TARGET_AVX2
+   static __m256 LabXYZ( __m256 x )
+   {
+      __m256 x3 = _mm256_mul_ps( _mm256_mul_ps( x, x ), x );
+      __m256 l = _mm256_mul_ps( _mm256_sub_ps( x, _mm256_set1_ps( float( _16_116 ) ) ), _mm256_set1_ps( float( 1/CIEKappa116 ) ) );
+      return _mm256_blendv_ps( l, x3, _mm256_cmp_ps( x3, _mm256_set1_ps( float( CIEEpsilon ) ), _CMP_GT_OQ ) );
+   }
+
+   __PCL_TARGET_AVX2
+   static __m256 Dot( const float* m, __m256 x, __m256 y, __m256 z )
+   {
+      return _mm256_fmadd_ps( _mm256_set1_ps( m[0] ), x,
+               _mm256_fmadd_ps( _mm256_set1_ps( m[1] ), y,
+                  _mm256_mul_ps( _mm256_set1_ps( m[2] ), z ) ) );
+   }
+
+   __PCL_TARGET_AVX2
+   static void ToXYZ( const Parameters& P, __m256& X, __m256& Y, __m256& Z, __m256 R, __m256 G, __m256 B, bool linearize )
+   {
+      if ( linearize )
+      {
+         R = Linear( P, R );
+         G = Linear( P, G );
+         B = Linear( P, B );
+      }
+      X = __pcl_range_ps( Dot( P.M,   R, G, B ) );
+      Y = __pcl_range_ps( Dot( P.M+3, R, G, B ) );
+      Z = __pcl_range_ps( Dot( P.M+6, R, G, B ) );
+   }
+
+   __PCL_TARGET_AVX2
+   static void FromXYZ( const Parameters& P, __m256& R, __m256& G, __m256& B, __m256 X, __m256 Y, __m256 Z )
+   {
+      R = __pcl_range_ps( Dot( P.M_,   X, Y, Z ) );
+      G = __pcl_range_ps( Dot( P.M_+3, X, Y, Z ) );
+      B = __pcl_range_ps( Dot( P.M_+6, X, Y, Z ) );
+      if ( !P.isLinear )
+      {
+         R = Gamma( P, R );
+         G = Gamma( P, G );
+         B = Gamma( P, B );
+      }
+   }
+
+   __PCL_TARGET_AVX2
+   static void FromLab( const Parameters& P, __m256& R, __m256& G, __m256& B, __m256 L, __m256 a, __m256 b )
+   {
+      __m256 Y = _mm256_mul_ps( _mm256_add_ps( L, _mm256_set1_ps( 0.16F ) ), _mm256_set1_ps( float( 1/1.16 ) ) );
+      __m256 X = _mm256_fmadd_ps( a, _mm256_set1_ps( 0.2F ), Y );
+      __m256 Z = _mm256_fnmadd_ps( b, _mm256_set1_ps( 0.5F ), Y );
+      FromXYZ( P, R, G, B, LabXYZ( X ), LabXYZ( Y ), LabXYZ( Z ) );
+   }
+
+   /*
+    * AVX2 implementations. Groups of eight elements are processed in
+    * parallel; remaining elements are converted by the portable routines.
+    */
+
+   __PCL_TARGET_AVX2
+   static void LinearRGBAVX2( const Parameters& P, float* x, size_type n )
+   {
+      const size_type n8 = n >> 3;
+      for ( size_type i = 0; i < n8; ++i )
+         _mm256_storeu_ps( x + (i << 3), Linear( P, _mm256_loadu_ps( x + (i << 3) ) ) );
+      LinearRGBGeneric( P, x + (n8 << 3), n & 7 );
+   }
+
+   __PCL_TARGET_AVX2
+   static void GammaRGBAVX2( const Parameters& P, float* x, size_type n )
+   {
+      const size_type n8 = n >> 3;
+      for ( size_type i = 0; i < n8; ++i )
+         _mm256_storeu_ps( x + (i << 3), Gamma( P, _mm256_loadu_ps( x + (i << 3) ) ) );
+      GammaRGBGeneric( P, x + (n8 << 3), n & 7 );
+   }
+
+   __PCL_TARGET_AVX2
+   static void RGBToCIEXYZAVX2( const Parameters& P, float* X, float* Y, float* Z,
+                                const float* R, const float* G, const float* B, size_type n, bool linearize )
+   {
+      const size_type m = n & ~size_type( 7 );
+      for ( size_type i = 0; i < m; i += 8 )
+      {
+         __m256 x, y, z;
+         ToXYZ( P, x, y, z, _mm256_loadu_ps( R+i ), _mm256_loadu_ps( G+i ), _mm256_loadu_ps( B+i ), linearize );
+         _mm256_storeu_ps( X+i, x );
+         _mm256_storeu_ps( Y+i, y );
+         _mm256_storeu_ps( Z+i, z );
+      }
+      RGBToCIEXYZGeneric( P, X+m, Y+m, Z+m, R+m, G+m, B+m, n-m, linearize );
+   }
+
+   __PCL_TARGET_AVX2
+   static void CIEXYZToRGBAVX2( const Parameters& P, float* R, float* G, float* B,
+                                const float* X, const float* Y, const float* Z, size_type n, bool )
+   {
+      const size_type m = n & ~size_type( 7 );
+      for ( size_type i = 0; i < m; i += 8 )
+      {
+         __m256 r, g, b;
+         FromXYZ( P, r, g, b, _mm256_loadu_ps( X+i ), _mm256_loadu_ps( Y+i ), _mm256_loadu_ps( Z+i ) );
+         _mm256_storeu_ps( R+i, r );
+         _mm256_storeu_ps( G+i, g );
+         _mm256_storeu_ps( B+i, b );
+      }
+      CIEXYZToRGBGeneric( P, R+m, G+m, B+m, X+m, Y+m, Z+m, n-m, false );
+   }
+
+   __PCL_TARGET_AVX2
+   static void RGBToCIEYAVX2( const Parameters& P, float* Y, float*, float*,
+                              const float* R, const float* G, const float* B, size_type n, bool lightness )
+   {
+      const bool linearize = !P.isLinear;
+      const size_type m = n & ~size_type( 7 );
+      for ( size_type i = 0; i < m; i += 8 )
+      {
+         __m256 r = _mm256_loadu_ps( R+i ), g = _mm256_loadu_ps( G+i ), b = _mm256_loadu_ps( B+i );
+         if ( linearize )
+         {
+            r = Linear( P, r );
+            g = Linear( P, g );
+            b = Linear( P, b );
+         }
+         __m256 y = __pcl_range_ps( Dot( P.M+3, r, g, b ) );
+         if ( lightness )
+            y = _mm256_fmsub_ps( XYZLab( y ), _mm256_set1_ps( 1.16F ), _mm256_set1_ps( 0.16F ) );
+         _mm256_storeu_ps( Y+i, y );
+      }
+      RGBToCIEYGeneric( P, Y+m, nullptr, nullptr, R+m, G+m, B+m, n-m, lightness );
+   }
+
+   __PCL_TARGET_AVX2
+   static void RGBToCIELabAVX2( const Parameters& P, float* L, float* a, float* b,
+                                const float* R, const float* G, const float* B, size_type n, bool linearize )
+   {
+      const __m256 mA = _mm256_set1_ps( 1/P.mA ), zA = _mm256_set1_ps( P.zA );
+      const __m256 mB = _mm256_set1_ps( 1/P.mB ), zB = _mm256_set1_ps( P.zB );
+      const size_type m = n & ~size_type( 7 );
+      for ( size_type i = 0; i < m; i += 8 )
+      {
+         __m256 x, y, z;
+         ToXYZ( P, x, y, z, _mm256_loadu_ps( R+i ), _mm256_loadu_ps( G+i ), _mm256_loadu_ps( B+i ), linearize );
+         x = XYZLab( x );
+         y = XYZLab( y );
+         z = XYZLab( z );
+         _mm256_storeu_ps( L+i, __pcl_range_ps( _mm256_fmsub_ps( y, _mm256_set1_ps( 1.16F ), _mm256_set1_ps( 0.16F ) ) ) );
+         _mm256_storeu_ps( a+i, __pcl_range_ps( _mm256_mul_ps( _mm256_fmadd_ps( _mm256_sub_ps( x, y ), _mm256_set1_ps( 5.0F ), zA ), mA ) ) );
+         _mm256_storeu_ps( b+i, __pcl_range_ps( _mm256_mul_ps( _mm256_fmadd_ps( _mm256_sub_ps( y, z ), _mm256_set1_ps( 2.0F ), zB ), mB ) ) );
+      }
+      RGBToCIELabGeneric( P, L+m, a+m, b+m, R+m, G+m, B+m, n-m, linearize );
+   }
+
+   __PCL_TARGET_AVX2
+   static void CIELabToRGBAVX2( const Parameters& P, float* R, float* G, float* B,
+                                const float* L, const float* a, const float* b, size_type n, bool )
+   {
+      const __m256 mA = _mm256_set1_ps( P.mA ), zA = _mm256_set1_ps( P.zA );
+      const __m256 mB = _mm256_set1_ps( P.mB ), zB = _mm256_set1_ps( P.zB );
+      const size_type m = n & ~size_type( 7 );
+      for ( size_type i = 0; i < m; i += 8 )
+      {
+         __m256 r, g, v;
+         FromLab( P, r, g, v, _mm256_loadu_ps( L+i ),
+                  _mm256_fmsub_ps( mA, _mm256_loadu_ps( a+i ), zA ),
+                  _mm256_fmsub_ps( mB, _mm256_loadu_ps( b+i ), zB ) );
+         _mm256_storeu_ps( R+i, r );
+         _mm256_storeu_ps( G+i, g );
+         _mm256_storeu_ps( B+i, v );
+      }
+      CIELabToRGBGeneric( P, R+m, G+m, B+m, L+m, a+m, b+m, n-m, false );
+   }
+
+   __PCL_TARGET_AVX2
+   static void RGBToCIELchAVX2( const Parameters& P, float* L, float* c, float* h,
+                                const float* R, const float* G, const float* B, size_type n, bool linearize )
+   {
+      const size_type m = n & ~size_type( 7 );
+      for ( size_type i = 0; i < m; i += 8 )
+      {
+         __m256 x, y, z;
+         ToXYZ( P, x, y, z, _mm256_loadu_ps( R+i ), _mm256_loadu_ps( G+i ), _mm256_loadu_ps( B+i ), linearize );
+         x = XYZLab( x );
+         y = XYZLab( y );
+         z = XYZLab( z );
+         __m256 a = _mm256_mul_ps( _mm256_sub_ps( x, y ), _mm256_set1_ps( 5.0F ) );
+         __m256 b = _mm256_mul_ps( _mm256_sub_ps( y, z ), _mm256_set1_ps( 2.0F ) );
+         _mm256_storeu_ps( L+i, __pcl_range_ps( _mm256_fmsub_ps( y, _mm256_set1_ps( 1.16F ), _mm256_set1_ps( 0.16F ) ) ) );
+         _mm256_storeu_ps( c+i, __pcl_range_ps( _mm256_mul_ps( _mm256_sqrt_ps( _mm256_fmadd_ps( a, a, _mm256_mul_ps( b, b ) ) ),
+                                                               _mm256_set1_ps( 1/P.mC ) ) ) );
+         float ha[ 8 ], hb[ 8 ];
+         _mm256_storeu_ps( ha, a );
+         _mm256_storeu_ps( hb, b );
+         for ( int j = 0; j < 8; ++j )
+            h[i+j] = Hue( hb[j], ha[j] );
+      }
+      RGBToCIELchGeneric( P, L+m, c+m, h+m, R+m, G+m, B+m, n-m, linearize );
+   }
+
+   __PCL_TARGET_AVX2
+   static void CIELchToRGBAVX2( const Parameters& P, float* R, float* G, float* B,
+                                const float* L, const float* c, const float* h, size_type n, bool )
+   {
+      const size_type m = n & ~size_type( 7 );
+      for ( size_type i = 0; i < m; i += 8 )
+      {
+         float ha[ 8 ], hb[ 8 ];
+         for ( int j = 0; j < 8; ++j )
+         {
+            double sh, ch;
+            pcl::SinCos( double( h[i+j] )*Const<double>::_2pi(), sh, ch );
+            double cj = double( c[i+j] )*P.mC;
+            ha[j] = float( cj*ch );
+            hb[j] = float( cj*sh );
+         }
+         __m256 r, g, v;
+         FromLab( P, r, g, v, _mm256_loadu_ps( L+i ), _mm256_loadu_ps( ha ), _mm256_loadu_ps( hb ) );
+         _mm256_storeu_ps( R+i, r );
+         _mm256_storeu_ps( G+i, g );
+         _mm256_storeu_ps( B+i, v );
+      }
+      CIELchToRGBGeneric( P, R+m, G+m, B+m, L+m, c+m, h+m, n-m, false );
+   }
+
+   /*
+    * Normalized hue from RGB components, their maximum and their nonzero
+    * range. Hue is undefined for achromatic pixels, where it is masked out.
+    */
+   __PCL_TARGET_AVX2
+   static __m256 Hue( __m256 r, __m256 g, __m256 b, __m256 max, __m256 delta, __m256 chromatic )
+   {
+      __m256 h = _mm256_add_ps( _mm256_div_ps( _mm256_sub_ps( r, g ), delta ), _mm256_set1_ps( 4.0F ) );
+      h = _mm256_blendv_ps( h, _mm256_add_ps( _mm256_div_ps( _mm256_sub_ps( b, r ), delta ), _mm256_set1_ps( 2.0F ) ),
+                            _mm256_cmp_ps( g, max, _CMP_EQ_OQ ) );
+      h = _mm256_blendv_ps( h, _mm256_div_ps( _mm256_sub_ps( g, b ), delta ),
+                            _mm256_cmp_ps( r, max, _CMP_EQ_OQ ) );
+      h = _mm256_mul_ps( h, _mm256_set1_ps( float( 1.0/6 ) ) );
+      h = _mm256_add_ps( h, _mm256_and_ps( _mm256_set1_ps( 1.0F ), _mm256_cmp_ps( h, _mm256_setzero_ps(), _CMP_LT_OQ ) ) );
+      return _mm256_and_ps( h, chromatic );
+   }
+
+   __PCL_TARGET_AVX2
+   static void RGBToHSVAVX2( float* H, float* S, float* V, const float* R, const float* G, const float* B, size_type n )
+   {
+      const size_type m = n & ~size_type( 7 );
+      for ( size_type i = 0; i < m; i += 8 )
+      {
+         __m256 r = _mm256_loadu_ps( R+i ), g = _mm256_loadu_ps( G+i ), b = _mm256_loadu_ps( B+i );
+         __m256 max = _mm256_max_ps( _mm256_max_ps( r, g ), b );
+         __m256 delta = _mm256_sub_ps( max, _mm256_min_ps( _mm256_min_ps( r, g ), b ) );
+         __m256 chromatic = _mm256_cmp_ps( delta, _mm256_setzero_ps(), _CMP_NEQ_OQ );
+         _mm256_storeu_ps( H+i, Hue( r, g, b, max, delta, chromatic ) );
+         _mm256_storeu_ps( S+i, _mm256_and_ps( _mm256_div_ps( delta, max ), chromatic ) );
+         _mm256_storeu_ps( V+i, max );
+      }
+      RGBToHSVGeneric( H+m, S+m, V+m, R+m, G+m, B+m, n-m );
+   }
+
+   __PCL_TARGET_AVX2
+   static void RGBToHSIAVX2( float* H, float* S, float* I, const float* R, const float* G, const float* B, size_type n )
+   {
+      const __m256 one = _mm256_set1_ps( 1.0F );
+      const size_type m = n & ~size_type( 7 );
+      for ( size_type i = 0; i < m; i += 8 )
+      {
+         __m256 r = _mm256_loadu_ps( R+i ), g = _mm256_loadu_ps( G+i ), b = _mm256_loadu_ps( B+i );
+         __m256 min = _mm256_min_ps( _mm256_min_ps( r, g ), b );
+         __m256 max = _mm256_max_ps( _mm256_max_ps( r, g ), b );
+         __m256 delta = _mm256_sub_ps( max, min );
+         __m256 sum = _mm256_add_ps( min, max );
+         __m256 chromatic = _mm256_cmp_ps( delta, _mm256_setzero_ps(), _CMP_NEQ_OQ );
+         __m256 d = _mm256_blendv_ps( _mm256_sub_ps( _mm256_set1_ps( 2.0F ), sum ), sum, _mm256_cmp_ps( sum, one, _CMP_LE_OQ ) );
+         _mm256_storeu_ps( H+i, Hue( r, g, b, max, delta, chromatic ) );
+         _mm256_storeu_ps( S+i, _mm256_and_ps( _mm256_div_ps( delta, d ), chromatic ) );
+         _mm256_storeu_ps( I+i, _mm256_mul_ps( sum, _mm256_set1_ps( 0.5F ) ) );
+      }
+      RGBToHSIGeneric( H+m, S+m, I+m, R+m, G+m, B+m, n-m );
+   }
+
+   __PCL_TARGET_AVX2
+   static void HSVToRGBAVX2( float* R, float* G, float* B, const float* H, const float* S, const float* V, size_type n )
+   {
+      const __m256 one = _mm256_set1_ps( 1.0F );
+      const size_type m = n & ~size_type( 7 );
+      for ( size_type i = 0; i < m; i += 8 )
+      {
+         __m256 h = _mm256_mul_ps( _mm256_loadu_ps( H+i ), _mm256_set1_ps( 6.0F ) );
+         __m256 s = _mm256_loadu_ps( S+i );
+         __m256 v = _mm256_loadu_ps( V+i );
+         __m256 k = _mm256_floor_ps( h );   // sector index
+         __m256 f = _mm256_sub_ps( h, k );
+         __m256 p = _mm256_mul_ps( v, _mm256_sub_ps( one, s ) );
+         __m256 q = _mm256_mul_ps( v, _mm256_fnmadd_ps( s, f, one ) );
+         __m256 t = _mm256_mul_ps( v, _mm256_fnmadd_ps( s, _mm256_sub_ps( one, f ), one ) );
+         __m256 k0 = _mm256_cmp_ps( k, _mm256_setzero_ps(), _CMP_EQ_OQ );
+         __m256 k1 = _mm256_cmp_ps( k, one, _CMP_EQ_OQ );
+         __m256 k2 = _mm256_cmp_ps( k, _mm256_set1_ps( 2.0F ), _CMP_EQ_OQ );
+         __m256 k3 = _mm256_cmp_ps( k, _mm256_set1_ps( 3.0F ), _CMP_EQ_OQ );
+         __m256 k4 = _mm256_cmp_ps( k, _mm256_set1_ps( 4.0F ), _CMP_EQ_OQ );
+         __m256 k5 = _mm256_cmp_ps( k, _mm256_set1_ps( 5.0F ), _CMP_EQ_OQ );
+         // Out-of-range sectors yield achromatic pixels, as the scalar conversion.
+         __m256 r = _mm256_blendv_ps( _mm256_blendv_ps( _mm256_blendv_ps( v, q, k1 ), p, _mm256_or_ps( k2, k3 ) ), t, k4 );
+         __m256 g = _mm256_blendv_ps( _mm256_blendv_ps( _mm256_blendv_ps( v, t, k0 ), q, k3 ), p, _mm256_or_ps( k4, k5 ) );
+         __m256 b = _mm256_blendv_ps( _mm256_blendv_ps( _mm256_blendv_ps( v, p, _mm256_or_ps( k0, k1 ) ), t, k2 ), q, k5 );
+         _mm256_storeu_ps( R+i, r );
+         _mm256_storeu_ps( G+i, g );
+         _mm256_storeu_ps( B+i, b );
+      }
+      HSVToRGBGeneric( R+m, G+m, B+m, H+m, S+m, V+m, n-m );
+   }
+
+   /*
+    * Vectorized RGBColorSystem::HSIH2RGB(), with d = v2 - v1.
+    */
+   __PCL_TARGET_AVX2
+   static __m256 HSIH2RGB( __m256 v1, __m256 v2, __m256 d, __m256 h )
+   {
+      const __m256 one = _mm256_set1_ps( 1.0F );
+      const __m256 _2_3 = _mm256_set1_ps( float( 2.0/3 ) );
+      h = _mm256_add_ps( h, _mm256_and_ps( one, _mm256_cmp_ps( h, _mm256_setzero_ps(), _CMP_LT_OQ ) ) );
+      h = _mm256_sub_ps( h, _mm256_and_ps( one, _mm256_cmp_ps( h, one, _CMP_GT_OQ ) ) );
+      __m256 x = _mm256_blendv_ps( v1, _mm256_fmadd_ps( _mm256_mul_ps( _mm256_sub_ps( _2_3, h ), _mm256_set1_ps( 6.0F ) ), d, v1 ),
+                                   _mm256_cmp_ps( h, _2_3, _CMP_LT_OQ ) );
+      x = _mm256_blendv_ps( x, v2, _mm256_cmp_ps( h, _mm256_set1_ps( 0.5F ), _CMP_LT_OQ ) );
+      return _mm256_blendv_ps( x, _mm256_fmadd_ps( _mm256_mul_ps( h, _mm256_set1_ps( 6.0F ) ), d, v1 ),
+                               _mm256_cmp_ps( h, _mm256_set1_ps( float( 1.0/6 ) ), _CMP_LT_OQ ) );
+   }
+
+   __PCL_TARGET_AVX2
+   static void HSIToRGBAVX2( float* R, float* G, float* B, const float* H, const float* S, const float* I, size_type n )
+   {
+      const __m256 _1_3 = _mm256_set1_ps( float( 1.0/3 ) );
+      const size_type m = n & ~size_type( 7 );
+      for ( size_type i = 0; i < m; i += 8 )
+      {
+         __m256 h = _mm256_loadu_ps( H+i );
+         __m256 s = _mm256_loadu_ps( S+i );
+         __m256 l = _mm256_loadu_ps( I+i );
+         // Achromatic pixels (s = 0) yield v1 = v2 = l, hence r = g = b = l.
+         __m256 v2 = _mm256_blendv_ps( _mm256_fnmadd_ps( s, l, _mm256_add_ps( l, s ) ),
+                                       _mm256_fmadd_ps( l, s, l ),
+                                       _mm256_cmp_ps( l, _mm256_set1_ps( 0.5F ), _CMP_LT_OQ ) );
+         __m256 v1 = _mm256_sub_ps( _mm256_add_ps( l, l ), v2 );
+         __m256 d = _mm256_sub_ps( v2, v1 );
+         _mm256_storeu_ps( R+i, HSIH2RGB( v1, v2, d, _mm256_add_ps( h, _1_3 ) ) );
+         _mm256_storeu_ps( G+i, HSIH2RGB( v1, v2, d, h ) );
+         _mm256_storeu_ps( B+i, HSIH2RGB( v1, v2, d, _mm256_sub_ps( h, _1_3 ) ) );
+      }
+      HSIToRGBGeneric( R+m, G+m, B+m, H+m, S+m, I+m, n-m );
+   }
+
+#endif // __PCL_SIMD_DISPATCH
+
+   /*
+    * Self-test and benchmark functions. Implementations are validated for
+    * sRGB and for a gamma 2.2 working space with the same primaries, with and
+    * without the conversion flag. Input components are uniformly distributed
+    * in [0,1], which is the valid range of all normalized color components.
+    * Vectorized transfer functions use polynomial approximations, hence the
+    * absolute tolerance.
+    */
+
+   static Array<Parameters> TestParameters()
+   {
+      RGBColorSystem rgbws( 2.2F, false/*issRGB*/, RGBColorSystem::sRGB_x, RGBColorSystem::sRGB_y, RGBColorSystem::sRGB_Y );
+      Array<Parameters> P;
+      P << Parameters( *RGBColorSystem::sRGB.m_data ) << Parameters( *rgbws.m_data );
+      return P;
+   }
+
+   static FVector TestData( size_type n, uint64 seed )
+   {
+      XoShiRo256ss R( seed );
+      FVector v( 0.0F, int( n ) );
+      for ( float& x : v )
+         x = float( R() );
+      return v;
+   }
+
+   /*
+    * Hue components wrap around at 0 and 1, so distances are circular.
+    */
+   static bool Agree( const FVector& a, const FVector& b )
+   {
+      for ( int i = 0; i < a.Length(); ++i )
+      {
+         float d = pcl::Abs( a[i] - b[i] );
+         if ( pcl::Min( d, 1 - d ) > 1.0e-04F )
+            return false;
+      }
+      return true;
+   }
+
+   static bool TestTransfer( transfer_function f, transfer_function g )
+   {
+      for ( const Parameters& P : TestParameters() )
+         for ( size_type n : { 1, 7, 8, 9, 31, 1000 } )
+         {
+            FVector x1 = TestData( n, n ), x2 = x1;
+            f( P, x1.Begin(), n );
+            g( P, x2.Begin(), n );
+            if ( !Agree( x1, x2 ) )
+               return false;
+         }
+      return true;
+   }
+
+   static void BenchmarkTransfer( transfer_function f, size_type n )
+   {
+      static FVector x;
+      if ( size_type( x.Length() ) != n )
+         x = TestData( n, 1 );
+      f( Parameters( *RGBColorSystem::sRGB.m_data ), x.Begin(), n );
+   }
+
+   static bool TestConversion( conversion_function f, conversion_function g )
+   {
+      for ( const Parameters& P : TestParameters() )
+         for ( size_type n : { 1, 7, 8, 9, 31, 1000 } )
+         {
+            FVector a = TestData( n, n ), b = TestData( n, n+1 ), c = TestData( n, n+2 );
+            for ( bool flag : { false, true } )
+            {
+               FVector x1( 0.0F, int( n ) ), y1( 0.0F, int( n ) ), z1( 0.0F, int( n ) );
+               FVector x2( 0.0F, int( n ) ), y2( 0.0F, int( n ) ), z2( 0.0F, int( n ) );
+               f( P, x1.Begin(), y1.Begin(), z1.Begin(), a.Begin(), b.Begin(), c.Begin(), n, flag );
+               g( P, x2.Begin(), y2.Begin(), z2.Begin(), a.Begin(), b.Begin(), c.Begin(), n, flag );
+               if ( !Agree( x1, x2 ) || !Agree( y1, y2 ) || !Agree( z1, z2 ) )
+                  return false;
+            }
+         }
+      return true;
+   }
+
+   static void BenchmarkConversion( conversion_function f, size_type n )
+   {
+      static FVector a, b, c, x, y, z;
+      if ( size_type( a.Length() ) != n )
+      {
+         a = TestData( n, 1 );
+         b = TestData( n, 2 );
+         c = TestData( n, 3 );
+         x = y = z = FVector( 0.0F, int( n ) );
+      }
+      f( Parameters( *RGBColorSystem::sRGB.m_data ), x.Begin(), y.Begin(), z.Begin(), a.Begin(), b.Begin(), c.Begin(), n, true );
+   }
+
+   static bool TestOrdering( ordering_function f, ordering_function g )
+   {
+      for ( size_type n : { 1, 7, 8, 9, 31, 1000 } )
+      {
+         FVector a = TestData( n, n ), b = TestData( n, n+1 ), c = TestData( n, n+2 );
+         // Include achromatic pixels.
+         for ( size_type i = 0; i < n; i += 5 )
+            b[i] = c[i] = a[i];
+         FVector x1( 0.0F, int( n ) ), y1( 0.0F, int( n ) ), z1( 0.0F, int( n ) );
+         FVector x2( 0.0F, int( n ) ), y2( 0.0F, int( n ) ), z2( 0.0F, int( n ) );
+         f( x1.Begin(), y1.Begin(), z1.Begin(), a.Begin(), b.Begin(), c.Begin(), n );
+         g( x2.Begin(), y2.Begin(), z2.Begin(), a.Begin(), b.Begin(), c.Begin(), n );
+         if ( !Agree( x1, x2 ) || !Agree( y1, y2 ) || !Agree( z1, z2 ) )
+            return false;
+      }
+      return true;
+   }
+
+   static void BenchmarkOrdering( ordering_function f, size_type n )
+   {
+      static FVector a, b, c, x, y, z;
+      if ( size_type( a.Length() ) != n )
+      {
+         a = TestData( n, 1 );
+         b = TestData( n, 2 );
+         c = TestData( n, 3 );
+         x = y = z = FVector( 0.0F, int( n ) );
+      }
+      f( x.Begin(), y.Begin(), z.Begin(), a.Begin(), b.Begin(), c.Begin(), n );
+   }
+};
+
+#undef _16_116
+#undef CIEEpsilon
+#undef CIEKappa116
+
+// ----------------------------------------------------------------------------
+
+/*
+ * Batch conversion kernels. They are constructed on first use, or by
+ * InitializeRGBColorSystemKernels() when the SIMD kernel registry is
+ * enumerated for validation and benchmarking.
+ */
+#ifdef __PCL_SIMD_DISPATCH
+#  define __PCL_RGBCS_AVX2( name ) name##AVX2
+#else
+#  define __PCL_RGBCS_AVX2( name ) nullptr
+#endif
+
+#define __PCL_RGBCS_KERNEL( type, name, test, benchmark )                                        \
+   SIMDKernel<PCL_RGBColorSystemEngine::type>& PCL_RGBColorSystemEngine::name()                  \
+   {                                                                                             \
+      static SIMDKernel<type> kernel( "RGBColorSystem" #name, name##Generic, nullptr,             \
+                                      __PCL_RGBCS_AVX2( name ), nullptr, test, benchmark );       \
+      return kernel;                                                                             \
+   }
+
+__PCL_RGBCS_KERNEL( transfer_function,   LinearRGB,   TestTransfer,   BenchmarkTransfer )
+__PCL_RGBCS_KERNEL( transfer_function,   GammaRGB,    TestTransfer,   BenchmarkTransfer )
+__PCL_RGBCS_KERNEL( conversion_function, RGBToCIEXYZ, TestConversion, BenchmarkConversion )
+__PCL_RGBCS_KERNEL( conversion_function, CIEXYZToRGB, TestConversion, BenchmarkConversion )
+__PCL_RGBCS_KERNEL( conversion_function, RGBToCIEY,   TestConversion, BenchmarkConversion )
+__PCL_RGBCS_KERNEL( conversion_function, RGBToCIELab, TestConversion, BenchmarkConversion )
+__PCL_RGBCS_KERNEL( conversion_function, CIELabToRGB, TestConversion, BenchmarkConversion )
+__PCL_RGBCS_KERNEL( conversion_function, RGBToCIELch, TestConversion, BenchmarkConversion )
+__PCL_RGBCS_KERNEL( conversion_function, CIELchToRGB, TestConversion, BenchmarkConversion )
+__PCL_RGBCS_KERNEL( ordering_function,   RGBToHSV,    TestOrdering,   BenchmarkOrdering )
+__PCL_RGBCS_KERNEL( ordering_function,   RGBToHSI,    TestOrdering,   BenchmarkOrdering )
+__PCL_RGBCS_KERNEL( ordering_function,   HSVToRGB,    TestOrdering,   BenchmarkOrdering )
+__PCL_RGBCS_KERNEL( ordering_function,   HSIToRGB,    TestOrdering,   BenchmarkOrdering )
+
+#undef __PCL_RGBCS_KERNEL
+#undef __PCL_RGBCS_AVX2
+
+void InitializeRGBColorSystemKernels()
+{
+   PCL_RGBColorSystemEngine::LinearRGB();
+   PCL_RGBColorSystemEngine::GammaRGB();
+   PCL_RGBColorSystemEngine::RGBToCIEXYZ();
+   PCL_RGBColorSystemEngine::CIEXYZToRGB();
+   PCL_RGBColorSystemEngine::RGBToCIEY();
+   PCL_RGBColorSystemEngine::RGBToCIELab();
+   PCL_RGBColorSystemEngine::CIELabToRGB();
+   PCL_RGBColorSystemEngine::RGBToCIELch();
+   PCL_RGBColorSystemEngine::CIELchToRGB();
+   PCL_RGBColorSystemEngine::RGBToHSV();
+   PCL_RGBColorSystemEngine::RGBToHSI();
+   PCL_RGBColorSystemEngine::HSVToRGB();
+   PCL_RGBColorSystemEngine::HSIToRGB();
+}
+
+// ----------------------------------------------------------------------------
+
+void RGBColorSystem::LinearRGB( float* x, size_type n ) const
+{
+   if ( !m_data->isLinear )
+      PCL_RGBColorSystemEngine::LinearRGB()( PCL_RGBColorSystemEngine::Parameters( *m_data ), x, n );
+}
+
+void RGBColorSystem::GammaRGB( float* x, size_type n ) const
+{
+   if ( !m_data->isLinear )
+      PCL_RGBColorSystemEngine::GammaRGB()( PCL_RGBColorSystemEngine::Parameters( *m_data ), x, n );
+}
+
+// ----------------------------------------------------------------------------
+
+FVector RGBColorSystem::LinearRGBTable( int bits ) const
+{
+   if ( bits < 1 || bits > 16 )
+      throw Error( "RGBColorSystem::LinearRGBTable(): Invalid number of bits: " + String( bits ) );
+   int n = 1 << bits;
+   FVector table( n );
+   float k = 1.0F/(n - 1);
+   for ( int i = 0; i < n; ++i )
+      table[i] = i*k;
+   LinearRGB( table.Begin(), n );
+   return table;
+}
+
+// ----------------------------------------------------------------------------
+
+void RGBColorSystem::LinearRGB( float* y, const uint8* x, size_type n ) const
+{
+   FVector table = LinearRGBTable( 8 );
+   PCL_IVDEP
+   for ( size_type i = 0; i < n; ++i )
+      y[i] = table[x[i]];
+}
+
+// ----------------------------------------------------------------------------
+
+void RGBColorSystem::LinearRGB( float* y, const uint16* x, size_type n ) const
+{
+   /*
+    * A lookup table is only worth generating for long sequences.
+    */
+   if ( n >= 4*65536 )
+      LinearRGB( y, x, n, LinearRGBTable( 16 ) );
+   else
+   {
+      const float k = 1.0F/65535;
+      PCL_IVDEP
+      for ( size_type i = 0; i < n; ++i )
+         y[i] = x[i]*k;
+      LinearRGB( y, n );
+   }
+}
+
+// ----------------------------------------------------------------------------
+
+void RGBColorSystem::LinearRGB( float* y, const uint16* x, size_type n, const FVector& table ) const
+{
+   PCL_PRECONDITION( !table.IsEmpty() )
+   const int m = table.Length() - 1;
+   PCL_IVDEP
+   for ( size_type i = 0; i < n; ++i )
+      y[i] = table[Min( int( x[i] ), m )];
+}
+
+// ----------------------------------------------------------------------------
+
+void RGBColorSystem::RGBToCIEXYZ( float* X, float* Y, float* Z, const float* R, const float* G, const float* B, size_type n ) const
+{
+   PCL_RGBColorSystemEngine::RGBToCIEXYZ()( PCL_RGBColorSystemEngine::Parameters( *m_data ), X, Y, Z, R, G, B, n, !m_data->isLinear );
+}
+
+void RGBColorSystem::LinearRGBToCIEXYZ( float* X, float* Y, float* Z, const float* R, const float* G, const float* B, size_type n ) const
+{
+   PCL_RGBColorSystemEngine::RGBToCIEXYZ()( PCL_RGBColorSystemEngine::Parameters( *m_data ), X, Y, Z, R, G, B, n, false/*linearize*/ );
+}
+
+void RGBColorSystem::CIEXYZToRGB( float* R, float* G, float* B, const float* X, const float* Y, const float* Z, size_type n ) const
+{
+   PCL_RGBColorSystemEngine::CIEXYZToRGB()( PCL_RGBColorSystemEngine::Parameters( *m_data ), R, G, B, X, Y, Z, n, false );
+}
+
+// ----------------------------------------------------------------------------
+
+void RGBColorSystem::RGBToCIEY( float* Y, const float* R, const float* G, const float* B, size_type n ) const
+{
+   PCL_RGBColorSystemEngine::RGBToCIEY()( PCL_RGBColorSystemEngine::Parameters( *m_data ), Y, nullptr, nullptr, R, G, B, n, false/*lightness*/ );
+}
+
+void RGBColorSystem::RGBToCIEL( float* L, const float* R, const float* G, const float* B, size_type n ) const
+{
+   PCL_RGBColorSystemEngine::RGBToCIEY()( PCL_RGBColorSystemEngine::Parameters( *m_data ), L, nullptr, nullptr, R, G, B, n, true/*lightness*/ );
+}
+
+// ----------------------------------------------------------------------------
+
+void RGBColorSystem::RGBToCIELab( float* L, float* a, float* b, const float* R, const float* G, const float* B, size_type n ) const
+{
+   PCL_RGBColorSystemEngine::RGBToCIELab()( PCL_RGBColorSystemEngine::Parameters( *m_data ), L, a, b, R, G, B, n, !m_data->isLinear );
+}
+
+void RGBColorSystem::LinearRGBToCIELab( float* L, float* a, float* b, const float* R, const float* G, const float* B, size_type n ) const
+{
+   PCL_RGBColorSystemEngine::RGBToCIELab()( PCL_RGBColorSystemEngine::Parameters( *m_data ), L, a, b, R, G, B, n, false/*linearize*/ );
+}
+
+void RGBColorSystem::CIELabToRGB( float* R, float* G, float* B, const float* L, const float* a, const float* b, size_type n ) const
+{
+   PCL_RGBColorSystemEngine::CIELabToRGB()( PCL_RGBColorSystemEngine::Parameters( *m_data ), R, G, B, L, a, b, n, false );
+}
+
+// ----------------------------------------------------------------------------
+
+void RGBColorSystem::RGBToCIELch( float* L, float* c, float* h, const float* R, const float* G, const float* B, size_type n ) const
+{
+   PCL_RGBColorSystemEngine::RGBToCIELch()( PCL_RGBColorSystemEngine::Parameters( *m_data ), L, c, h, R, G, B, n, !m_data->isLinear );
+}
+
+void RGBColorSystem::CIELchToRGB( float* R, float* G, float* B, const float* L, const float* c, const float* h, size_type n ) const
+{
+   PCL_RGBColorSystemEngine::CIELchToRGB()( PCL_RGBColorSystemEngine::Parameters( *m_data ), R, G, B, L, c, h, n, false );
+}
+
+// ----------------------------------------------------------------------------
+
+void RGBColorSystem::RGBToHSV( float* H, float* S, float* V, const float* R, const float* G, const float* B, size_type n )
+{
+   PCL_RGBColorSystemEngine::RGBToHSV()( H, S, V, R, G, B, n );
+}
+
+void RGBColorSystem::RGBToHSI( float* H, float* S, float* I, const float* R, const float* G, const float* B, size_type n )
+{
+   PCL_RGBColorSystemEngine::RGBToHSI()( H, S, I, R, G, B, n );
+}
+
+void RGBColorSystem::HSVToRGB( float* R, float* G, float* B, const float* H, const float* S, const float* V, size_type n )
+{
+   PCL_RGBColorSystemEngine::HSVToRGB()( R, G, B, H, S, V, n );
+}
+
+void RGBColorSystem::HSIToRGB( float* R, float* G, float* B, const float* H, const float* S, const float* I, size_type n )
+{
+   PCL_RGBColorSystemEngine::HSIToRGB()( R, G, B, H, S, I, n );
+}
+
+// ----------------------------------------------------------------------------
+
+void RGBColorSystem::RGBToHSVL( float* H, float* S, float* V, float* L, const float* R, const float* G, const float* B, size_type n ) const
+{
+   // Lightness first, since HSV components can be computed in-place.
+   RGBToCIEL( L, R, G, B, n );
+   RGBToHSV( H, S, V, R, G, B, n );
+}
+
+void RGBColorSystem::RGBToHSIL( float* H, float* S, float* I, float* L, const float* R, const float* G, const float* B, size_type n ) const
+{
+   RGBToCIEL( L, R, G, B, n );
+   RGBToHSI( H, S, I, R, G, B, n );
+}
+
+void RGBColorSystem::HSVLToRGB( float* R, float* G, float* B, const float* H, const float* S, const float* V, const float* L, size_type n ) const
+{
+   /*
+    * Replace the lightness of HSV chrominance with L. The L* components
+    * computed by the intermediate in-place conversion are discarded.
+    */
+   HSVToRGB( R, G, B, H, S, V, n );
+   RGBToCIELab( R, G, B, R, G, B, n );
+   CIELabToRGB( R, G, B, L, G, B, n );
+}
+
+void RGBColorSystem::HSILToRGB( float* R, float* G, float* B, const float* H, const float* S, const float* I, const float* L, size_type n ) const
+{
+   HSIToRGB( R, G, B, H, S, I, n );
+   RGBToCIELab( R, G, B, R, G, B, n );
+   CIELabToRGB( R, G, B, L, G, B, n );
+}
+
+// ----------------------------------------------------------------------------
+
 } // pcl
 
 // ----------------------------------------------------------------------------
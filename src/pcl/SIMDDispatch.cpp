@@ -0,0 +1,2195 @@
+//     ____   ______ __
+//    / __ \ / ____// /
+//   / /_/ // /    / /
+//  / ____// /___ / /___   PixInsight Class Library
+// /_/     \____//_____/   PCL 2.8.5
+// ----------------------------------------------------------------------------
+// pcl/SIMDDispatch.cpp - Released 2024-12-28T16:53:56Z
+// ----------------------------------------------------------------------------
+// This file is part of the PixInsight Class Library (PCL).
+// PCL is a multiplatform C++ framework for development of PixInsight modules.
+//
+// Copyright (c) 2003-2024 Pleiades Astrophoto S.L. All Rights Reserved.
+//
+// Redistribution and use in both source and binary forms, with or without
+// modification, is permitted provided that the following conditions are met:
+//
+// 1. All redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//
+// 2. All redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//
+// 3. Neither the names "PixInsight" and "Pleiades Astrophoto", nor the names
+//    of their contributors, may be used to endorse or promote products derived
+//    from this software without specific prior written permission. For written
+//    permission, please contact info@pixinsight.com.
+//
+// 4. All products derived from this software, in any form whatsoever, must
+//    reproduce the following acknowledgment in the end-user documentation
+//    and/or other materials provided with the product:
+//
+//    "This product is based on software from the PixInsight project, developed
+//    by Pleiades Astrophoto and its contributors (https://pixinsight.com/)."
+//
+//    Alternatively, if that is where third-party acknowledgments normally
+//    appear, this acknowledgment must be reproduced in the product itself.
+//
+// THIS SOFTWARE IS PROVIDED BY PLEIADES ASTROPHOTO AND ITS CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED
+// TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+// PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL PLEIADES ASTROPHOTO OR ITS
+// CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, BUSINESS
+// INTERRUPTION; PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; AND LOSS OF USE,
+// DATA OR PROFITS) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+// ----------------------------------------------------------------------------
+
+#include <pcl/AutoLock.h>
+#include <pcl/ElapsedTime.h>
+#include <pcl/Math.h>
+#include <pcl/Random.h>
+#include <pcl/SIMDDispatch.h>
+#include <pcl/Vector.h>
+
+#ifdef __PCL_SIMD_DISPATCH
+#  ifndef _MSC_VER
+#    include <cpuid.h>
+#  endif
+#endif
+
+/*
+ * GCC emits spurious -Wuninitialized warnings for the _mm512_undefined_xx()
+ * placeholders used by many AVX-512 intrinsics (reductions, permutations,
+ * conversions), which are inlined into our kernels. Scope the suppression to
+ * the AVX-512 implementations.
+ */
+#if defined( __GNUC__ ) && !defined( __clang__ )
+#  define __PCL_BEGIN_AVX512_IMPLEMENTATIONS               \
+      _Pragma( "GCC diagnostic push" )                    \
+      _Pragma( "GCC diagnostic ignored \"-Wuninitialized\"" ) \
+      _Pragma( "GCC diagnostic ignored \"-Wmaybe-uninitialized\"" )
+#  define __PCL_END_AVX512_IMPLEMENTATIONS                 \
+      _Pragma( "GCC diagnostic pop" )
+#else
+#  define __PCL_BEGIN_AVX512_IMPLEMENTATIONS
+#  define __PCL_END_AVX512_IMPLEMENTATIONS
+#endif
+
+namespace pcl
+{
+
+// ----------------------------------------------------------------------------
+
+namespace SIMDInstructionSet
+{
+   String Name( int isa )
+   {
+      static const char* name[] = { "Generic", "SSE4", "AVX2", "AVX512" };
+      PCL_PRECONDITION( isa >= 0 && isa < NumberOfInstructionSets )
+      if ( isa >= 0 && isa < NumberOfInstructionSets )
+         return String( name[isa] );
+      return String();
+   }
+} // SIMDInstructionSet
+
+// ----------------------------------------------------------------------------
+
+#ifdef __PCL_SIMD_DISPATCH
+
+static void CPUID( uint32* r, uint32 leaf, uint32 subleaf = 0 ) noexcept
+{
+#ifdef _MSC_VER
+   int info[ 4 ];
+   __cpuidex( info, int( leaf ), int( subleaf ) );
+   for ( int i = 0; i < 4; ++i )
+      r[i] = uint32( info[i] );
+#else
+   __cpuid_count( leaf, subleaf, r[0], r[1], r[2], r[3] );
+#endif
+}
+
+static uint64 XGETBV0() noexcept
+{
+#ifdef _MSC_VER
+   return _xgetbv( 0 );
+#else
+   uint32 lo, hi;
+   asm volatile( "xgetbv" : "=a" (lo), "=d" (hi) : "c" (0) );
+   return (uint64( hi ) << 32) | lo;
+#endif
+}
+
+#endif   // __PCL_SIMD_DISPATCH
+
+static SIMDInstructionSet::value_type DetectSIMDInstructionSet() noexcept
+{
+#ifdef __PCL_SIMD_DISPATCH
+   uint32 r0[ 4 ], r1[ 4 ];
+   CPUID( r0, 0 );
+   const uint32 maxLeaf = r0[0];
+   if ( maxLeaf < 1 )
+      return SIMDInstructionSet::Generic;
+
+   CPUID( r1, 1 );
+   const uint32 ecx1 = r1[2];
+   if ( !(ecx1 & (1u << 20)) )      // SSE4.2
+      return SIMDInstructionSet::Generic;
+
+   /*
+    * AVX requires OS support for saving the YMM register state. Check the
+    * OSXSAVE, AVX and FMA feature flags, then the XCR0 register.
+    */
+   if ( (ecx1 & ((1u << 27)|(1u << 28)|(1u << 12))) != ((1u << 27)|(1u << 28)|(1u << 12)) || maxLeaf < 7 )
+      return SIMDInstructionSet::SSE4;
+   const uint64 xcr0 = XGETBV0();
+   if ( (xcr0 & 0x06) != 0x06 )     // XMM and YMM states
+      return SIMDInstructionSet::SSE4;
+
+   uint32 r7[ 4 ];
+   CPUID( r7, 7, 0 );
+   const uint32 ebx7 = r7[1];
+   if ( !(ebx7 & (1u << 5)) )       // AVX2
+      return SIMDInstructionSet::SSE4;
+   if ( (ebx7 & (1u << 16)) )       // AVX-512F
+      if ( (xcr0 & 0xe6) == 0xe6 )  // XMM, YMM, opmask and ZMM states
+         return SIMDInstructionSet::AVX512;
+   return SIMDInstructionSet::AVX2;
+#else
+   return SIMDInstructionSet::Generic;
+#endif
+}
+
+SIMDInstructionSet::value_type MaxSIMDInstructionSetSupported() noexcept
+{
+   static const SIMDInstructionSet::value_type isa = DetectSIMDInstructionSet();
+   return isa;
+}
+
+static AtomicInt s_limit( SIMDInstructionSet::AVX512 );
+
+SIMDInstructionSet::value_type SIMDInstructionSetLimit() noexcept
+{
+   return SIMDInstructionSet::value_type( s_limit.Load() );
+}
+
+// ----------------------------------------------------------------------------
+
+/*
+ * Global kernel registry. Constructed on first use, so kernels can be
+ * registered safely during static initialization of any translation unit.
+ *
+ * The library is compiled for an SSE4.2 baseline (-msse4.2 in the makefiles,
+ * without -mavx2, -mfma or __PCL_AVX2), so the compiler cannot emit AVX
+ * instructions in ordinary code. AVX2 and AVX-512 code exists only in
+ * functions declared with __PCL_TARGET_AVX2 or __PCL_TARGET_AVX512, and GCC
+ * and Clang never inline such functions into callers compiled for a lesser
+ * target. Those functions are only reachable through the implementation
+ * tables of registered kernels, or from other functions with the same or a
+ * wider target. A table entry is only executed by Select(), SelfTest(),
+ * Benchmark() and the *All() functions for instruction sets not above
+ * MaxSIMDInstructionSetSupported(), which checks the CPUID feature flags and
+ * the XCR0 register (XGETBV) for operating system support of the YMM and
+ * ZMM states. SIMDKernel::Implementation() applies the same check. Building
+ * the library with global AVX options would break this guarantee: the
+ * compiler could then use AVX instructions anywhere, including the generic
+ * code that runs before the check.
+ */
+struct SIMDKernelRegistry
+{
+   Array<SIMDKernelBase*> kernels;
+   Mutex                  mutex;
+};
+
+static SIMDKernelRegistry& Registry()
+{
+   static SIMDKernelRegistry registry;
+   return registry;
+}
+
+static void InitializeBuiltInKernels();
+
+// ----------------------------------------------------------------------------
+
+void SetSIMDInstructionSetLimit( SIMDInstructionSet::value_type isa )
+{
+   s_limit.Store( Range( int( isa ), int( SIMDInstructionSet::Generic ), int( SIMDInstructionSet::AVX512 ) ) );
+   InitializeBuiltInKernels();
+   SIMDKernelRegistry& R = Registry();
+   volatile AutoLock lock( R.mutex );
+   for ( SIMDKernelBase* kernel : R.kernels )
+      kernel->Select();
+}
+
+// ----------------------------------------------------------------------------
+
+SIMDKernelBase::SIMDKernelBase( const IsoString& id )
+   : m_id( id )
+{
+   SIMDKernelRegistry& R = Registry();
+   volatile AutoLock lock( R.mutex );
+   R.kernels << this;
+}
+
+// ----------------------------------------------------------------------------
+
+SIMDKernelBase::~SIMDKernelBase()
+{
+   SIMDKernelRegistry& R = Registry();
+   volatile AutoLock lock( R.mutex );
+   R.kernels.Remove( this );
+}
+
+// ----------------------------------------------------------------------------
+
+void SIMDKernelBase::Select() noexcept
+{
+   for ( int isa = ActiveSIMDInstructionSet(); ; --isa )
+      if ( HasImplementation( instruction_set( isa ) ) || isa == SIMDInstructionSet::Generic )
+      {
+         m_selected = instruction_set( isa );
+         SelectImplementation( m_selected );
+         break;
+      }
+}
+
+// ----------------------------------------------------------------------------
+
+bool SIMDKernelBase::SelfTest( instruction_set isa ) const
+{
+   if ( !IsAvailable( isa ) )
+      return false;
+   return DoSelfTest( isa );
+}
+
+// ----------------------------------------------------------------------------
+
+double SIMDKernelBase::Benchmark( instruction_set isa, size_type length ) const
+{
+   if ( !IsAvailable( isa ) || length == 0 )
+      return 0;
+
+   // Warm up caches and branch predictors.
+   DoBenchmark( isa, length );
+
+   // Repeat for at least 50 ms.
+   ElapsedTime T;
+   size_type count = 0;
+   do
+   {
+      for ( int i = 0; i < 8; ++i )
+         DoBenchmark( isa, length );
+      count += 8;
+   }
+   while ( T() < 0.05 );
+   return 1.0e+09*T()/count/length;
+}
+
+// ----------------------------------------------------------------------------
+
+Array<SIMDKernelBase*> SIMDKernelBase::Kernels()
+{
+   InitializeBuiltInKernels();
+   SIMDKernelRegistry& R = Registry();
+   volatile AutoLock lock( R.mutex );
+   return R.kernels;
+}
+
+// ----------------------------------------------------------------------------
+
+SIMDKernelBase* SIMDKernelBase::KernelById( const IsoString& id )
+{
+   for ( SIMDKernelBase* kernel : Kernels() )
+      if ( kernel->Id() == id )
+         return kernel;
+   return nullptr;
+}
+
+// ----------------------------------------------------------------------------
+
+bool SIMDKernelBase::SelfTestAll( String* report )
+{
+   bool ok = true;
+   for ( const SIMDKernelBase* kernel : Kernels() )
+      for ( int isa = SIMDInstructionSet::SSE4; isa < SIMDInstructionSet::NumberOfInstructionSets; ++isa )
+         if ( kernel->HasImplementation( instruction_set( isa ) ) )
+         {
+            String result;
+            if ( kernel->IsAvailable( instruction_set( isa ) ) )
+            {
+               bool passed = kernel->DoSelfTest( instruction_set( isa ) );
+               if ( !passed )
+                  ok = false;
+               result = passed ? "passed" : "FAILED";
+            }
+            else
+               result = "not available";
+            if ( report != nullptr )
+            {
+               report->AppendFormat( "%-28s %-8s : ", kernel->Id().c_str(), IsoString( SIMDInstructionSet::Name( isa ) ).c_str() );
+               report->Append( result );
+               report->Append( '\n' );
+            }
+         }
+   return ok;
+}
+
+// ----------------------------------------------------------------------------
+
+String SIMDKernelBase::BenchmarkAll( size_type length )
+{
+   String report;
+   for ( const SIMDKernelBase* kernel : Kernels() )
+   {
+      report.AppendFormat( "%-28s", kernel->Id().c_str() );
+      for ( int isa = SIMDInstructionSet::Generic; isa < SIMDInstructionSet::NumberOfInstructionSets; ++isa )
+         if ( kernel->IsAvailable( instruction_set( isa ) ) )
+            report.AppendFormat( " %s:%.3f", IsoString( SIMDInstructionSet::Name( isa ) ).c_str(),
+                                             kernel->Benchmark( instruction_set( isa ), length ) );
+      report.AppendFormat( " (selected: %s)\n", IsoString( SIMDInstructionSet::Name( kernel->SelectedInstructionSet() ) ).c_str() );
+   }
+   return report;
+}
+
+// ----------------------------------------------------------------------------
+// Minimum and maximum
+// ----------------------------------------------------------------------------
+
+template <typename T>
+static T MinGeneric( const T* __restrict__ f, size_type n )
+{
+   T x = f[0];
+   for ( size_type i = 1; i < n; ++i )
+      if ( f[i] < x )
+         x = f[i];
+   return x;
+}
+
+template <typename T>
+static T MaxGeneric( const T* __restrict__ f, size_type n )
+{
+   T x = f[0];
+   for ( size_type i = 1; i < n; ++i )
+      if ( x < f[i] )
+         x = f[i];
+   return x;
+}
+
+#ifdef __PCL_SIMD_DISPATCH
+
+/*
+ * Horizontal reductions of partial results stored from a vector register to
+ * the array p. The scalar tail is processed by the caller.
+ */
+#define __PCL_REDUCE_MIN( T, N )  \
+   T x = p[0];                    \
+   for ( int j = 1; j < N; ++j )  \
+      if ( p[j] < x )             \
+         x = p[j];
+
+#define __PCL_REDUCE_MAX( T, N )  \
+   T x = p[0];                    \
+   for ( int j = 1; j < N; ++j )  \
+      if ( x < p[j] )             \
+         x = p[j];
+
+__PCL_TARGET_SSE4
+static float MinSSE4( const float* __restrict__ f, size_type n )
+{
+   if ( n < 4 )
+      return MinGeneric( f, n );
+   const size_type n4 = n >> 2;
+   __m128 v = _mm_loadu_ps( f );
+   for ( size_type i = 1; i < n4; ++i )
+      v = _mm_min_ps( v, _mm_loadu_ps( f + (i << 2) ) );
+   float p[ 4 ];
+   _mm_storeu_ps( p, v );
+   __PCL_REDUCE_MIN( float, 4 )
+   for ( size_type i = n4 << 2; i < n; ++i )
+      if ( f[i] < x )
+         x = f[i];
+   return x;
+}
+
+__PCL_TARGET_SSE4
+static double MinSSE4( const double* __restrict__ f, size_type n )
+{
+   if ( n < 2 )
+      return f[0];
+   const size_type n2 = n >> 1;
+   __m128d v = _mm_loadu_pd( f );
+   for ( size_type i = 1; i < n2; ++i )
+      v = _mm_min_pd( v, _mm_loadu_pd( f + (i << 1) ) );
+   double p[ 2 ];
+   _mm_storeu_pd( p, v );
+   __PCL_REDUCE_MIN( double, 2 )
+   if ( n & 1 )
+      if ( f[n-1] < x )
+         x = f[n-1];
+   return x;
+}
+
+__PCL_TARGET_SSE4
+static float MaxSSE4( const float* __restrict__ f, size_type n )
+{
+   if ( n < 4 )
+      return MaxGeneric( f, n );
+   const size_type n4 = n >> 2;
+   __m128 v = _mm_loadu_ps( f );
+   for ( size_type i = 1; i < n4; ++i )
+      v = _mm_max_ps( v, _mm_loadu_ps( f + (i << 2) ) );
+   float p[ 4 ];
+   _mm_storeu_ps( p, v );
+   __PCL_REDUCE_MAX( float, 4 )
+   for ( size_type i = n4 << 2; i < n; ++i )
+      if ( x < f[i] )
+         x = f[i];
+   return x;
+}
+
+__PCL_TARGET_SSE4
+static double MaxSSE4( const double* __restrict__ f, size_type n )
+{
+   if ( n < 2 )
+      return f[0];
+   const size_type n2 = n >> 1;
+   __m128d v = _mm_loadu_pd( f );
+   for ( size_type i = 1; i < n2; ++i )
+      v = _mm_max_pd( v, _mm_loadu_pd( f + (i << 1) ) );
+   double p[ 2 ];
+   _mm_storeu_pd( p, v );
+   __PCL_REDUCE_MAX( double, 2 )
+   if ( n & 1 )
+      if ( x < f[n-1] )
+         x = f[n-1];
+   return x;
+}
+
+__PCL_TARGET_AVX2
+static float MinAVX2( const float* __restrict__ f, size_type n )
+{
+   if ( n < 8 )
+      return MinGeneric( f, n );
+   const size_type n8 = n >> 3;
+   __m256 v = _mm256_loadu_ps( f );
+   for ( size_type i = 1; i < n8; ++i )
+      v = _mm256_min_ps( v, _mm256_loadu_ps( f + (i << 3) ) );
+   float p[ 8 ];
+   _mm256_storeu_ps( p, v );
+   __PCL_REDUCE_MIN( float, 8 )
+   for ( size_type i = n8 << 3; i < n; ++i )
+      if ( f[i] < x )
+         x = f[i];
+   return x;
+}
+
+__PCL_TARGET_AVX2
+static double MinAVX2( const double* __restrict__ f, size_type n )
+{
+   if ( n < 4 )
+      return MinGeneric( f, n );
+   const size_type n4 = n >> 2;
+   __m256d v = _mm256_loadu_pd( f );
+   for ( size_type i = 1; i < n4; ++i )
+      v = _mm256_min_pd( v, _mm256_loadu_pd( f + (i << 2) ) );
+   double p[ 4 ];
+   _mm256_storeu_pd( p, v );
+   __PCL_REDUCE_MIN( double, 4 )
+   for ( size_type i = n4 << 2; i < n; ++i )
+      if ( f[i] < x )
+         x = f[i];
+   return x;
+}
+
+__PCL_TARGET_AVX2
+static float MaxAVX2( const float* __restrict__ f, size_type n )
+{
+   if ( n < 8 )
+      return MaxGeneric( f, n );
+   const size_type n8 = n >> 3;
+   __m256 v = _mm256_loadu_ps( f );
+   for ( size_type i = 1; i < n8; ++i )
+      v = _mm256_max_ps( v, _mm256_loadu_ps( f + (i << 3) ) );
+   float p[ 8 ];
+   _mm256_storeu_ps( p, v );
+   __PCL_REDUCE_MAX( float, 8 )
+   for ( size_type i = n8 << 3; i < n; ++i )
+      if ( x < f[i] )
+         x = f[i];
+   return x;
+}
+
+__PCL_TARGET_AVX2
+static double MaxAVX2( const double* __restrict__ f, size_type n )
+{
+   if ( n < 4 )
+      return MaxGeneric( f, n );
+   const size_type n4 = n >> 2;
+   __m256d v = _mm256_loadu_pd( f );
+   for ( size_type i = 1; i < n4; ++i )
+      v = _mm256_max_pd( v, _mm256_loadu_pd( f + (i << 2) ) );
+   double p[ 4 ];
+   _mm256_storeu_pd( p, v );
+   __PCL_REDUCE_MAX( double, 4 )
+   for ( size_type i = n4 << 2; i < n; ++i )
+      if ( x < f[i] )
+         x = f[i];
+   return x;
+}
+
+__PCL_BEGIN_AVX512_IMPLEMENTATIONS
+
+__PCL_TARGET_AVX512
+static float MinAVX512( const float* __restrict__ f, size_type n )
+{
+   if ( n < 16 )
+      return MinAVX2( f, n );
+   const size_type n16 = n >> 4;
+   __m512 v = _mm512_loadu_ps( f );
+   for ( size_type i = 1; i < n16; ++i )
+      v = _mm512_min_ps( v, _mm512_loadu_ps( f + (i << 4) ) );
+   float p[ 16 ];
+   _mm512_storeu_ps( p, v );
+   __PCL_REDUCE_MIN( float, 16 )
+   for ( size_type i = n16 << 4; i < n; ++i )
+      if ( f[i] < x )
+         x = f[i];
+   return x;
+}
+
+__PCL_TARGET_AVX512
+static double MinAVX512( const double* __restrict__ f, size_type n )
+{
+   if ( n < 8 )
+      return MinAVX2( f, n );
+   const size_type n8 = n >> 3;
+   __m512d v = _mm512_loadu_pd( f );
+   for ( size_type i = 1; i < n8; ++i )
+      v = _mm512_min_pd( v, _mm512_loadu_pd( f + (i << 3) ) );
+   double p[ 8 ];
+   _mm512_storeu_pd( p, v );
+   __PCL_REDUCE_MIN( double, 8 )
+   for ( size_type i = n8 << 3; i < n; ++i )
+      if ( f[i] < x )
+         x = f[i];
+   return x;
+}
+
+__PCL_TARGET_AVX512
+static float MaxAVX512( const float* __restrict__ f, size_type n )
+{
+   if ( n < 16 )
+      return MaxAVX2( f, n );
+   const size_type n16 = n >> 4;
+   __m512 v = _mm512_loadu_ps( f );
+   for ( size_type i = 1; i < n16; ++i )
+      v = _mm512_max_ps( v, _mm512_loadu_ps( f + (i << 4) ) );
+   float p[ 16 ];
+   _mm512_storeu_ps( p, v );
+   __PCL_REDUCE_MAX( float, 16 )
+   for ( size_type i = n16 << 4; i < n; ++i )
+      if ( x < f[i] )
+         x = f[i];
+   return x;
+}
+
+__PCL_TARGET_AVX512
+static double MaxAVX512( const double* __restrict__ f, size_type n )
+{
+   if ( n < 8 )
+      return MaxAVX2( f, n );
+   const size_type n8 = n >> 3;
+   __m512d v = _mm512_loadu_pd( f );
+   for ( size_type i = 1; i < n8; ++i )
+      v = _mm512_max_pd( v, _mm512_loadu_pd( f + (i << 3) ) );
+   double p[ 8 ];
+   _mm512_storeu_pd( p, v );
+   __PCL_REDUCE_MAX( double, 8 )
+   for ( size_type i = n8 << 3; i < n; ++i )
+      if ( x < f[i] )
+         x = f[i];
+   return x;
+}
+
+__PCL_END_AVX512_IMPLEMENTATIONS
+
+#undef __PCL_REDUCE_MIN
+#undef __PCL_REDUCE_MAX
+
+#endif   // __PCL_SIMD_DISPATCH
+
+// ----------------------------------------------------------------------------
+// Histogram accumulation
+// ----------------------------------------------------------------------------
+
+template <typename T>
+static void HistogramGeneric( size_type* __restrict__ H, int length, const T* __restrict__ f, size_type n, T low, T scale )
+{
+   for ( size_type i = 0; i < n; ++i )
+   {
+      const int k = int( scale*(f[i] - low) );
+      if ( k >= 0 && k < length )
+         ++H[k];
+   }
+}
+
+#ifdef __PCL_SIMD_DISPATCH
+
+/*
+ * Bin indices are computed with vector instructions for blocks of data, then
+ * accumulated with scalar code, since histogram increments are inherently
+ * sequential. Out-of-range conversions yield the 'integer indefinite' value
+ * 0x80000000, which is rejected as a negative index.
+ */
+static const int s_binBlockLength = 256;
+
+static void AccumulateBins( size_type* __restrict__ H, int length, const int* __restrict__ K, int n )
+{
+   for ( int j = 0; j < n; ++j )
+      if ( uint32( K[j] ) < uint32( length ) )
+         ++H[K[j]];
+}
+
+__PCL_TARGET_SSE4
+static void HistogramSSE4( size_type* __restrict__ H, int length, const float* __restrict__ f, size_type n, float low, float scale )
+{
+   const __m128 S = _mm_set1_ps( scale );
+   const __m128 L = _mm_set1_ps( low );
+   const size_type n4 = n >> 2;
+   int K[ s_binBlockLength ];
+   for ( size_type i = 0; i < n4; )
+   {
+      int m = 0;
+      for ( ; m < s_binBlockLength && i < n4; m += 4, ++i )
+         _mm_storeu_si128( (__m128i*)(K + m), _mm_cvttps_epi32( _mm_mul_ps( _mm_sub_ps( _mm_loadu_ps( f + (i << 2) ), L ), S ) ) );
+      AccumulateBins( H, length, K, m );
+   }
+   HistogramGeneric( H, length, f + (n4 << 2), n & 3, low, scale );
+}
+
+__PCL_TARGET_SSE4
+static void HistogramSSE4( size_type* __restrict__ H, int length, const double* __restrict__ f, size_type n, double low, double scale )
+{
+   const __m128d S = _mm_set1_pd( scale );
+   const __m128d L = _mm_set1_pd( low );
+   const size_type n2 = n >> 1;
+   int K[ s_binBlockLength ];
+   for ( size_type i = 0; i < n2; )
+   {
+      int m = 0;
+      for ( ; m < s_binBlockLength && i < n2; m += 2, ++i )
+         _mm_storel_epi64( (__m128i*)(K + m), _mm_cvttpd_epi32( _mm_mul_pd( _mm_sub_pd( _mm_loadu_pd( f + (i << 1) ), L ), S ) ) );
+      AccumulateBins( H, length, K, m );
+   }
+   HistogramGeneric( H, length, f + (n2 << 1), n & 1, low, scale );
+}
+
+__PCL_TARGET_AVX2
+static void HistogramAVX2( size_type* __restrict__ H, int length, const float* __restrict__ f, size_type n, float low, float scale )
+{
+   const __m256 S = _mm256_set1_ps( scale );
+   const __m256 L = _mm256_set1_ps( low );
+   const size_type n8 = n >> 3;
+   int K[ s_binBlockLength ];
+   for ( size_type i = 0; i < n8; )
+   {
+      int m = 0;
+      for ( ; m < s_binBlockLength && i < n8; m += 8, ++i )
+         _mm256_storeu_si256( (__m256i*)(K + m), _mm256_cvttps_epi32( _mm256_mul_ps( _mm256_sub_ps( _mm256_loadu_ps( f + (i << 3) ), L ), S ) ) );
+      AccumulateBins( H, length, K, m );
+   }
+   HistogramGeneric( H, length, f + (n8 << 3), n & 7, low, scale );
+}
+
+__PCL_TARGET_AVX2
+static void HistogramAVX2( size_type* __restrict__ H, int length, const double* __restrict__ f, size_type n, double low, double scale )
+{
+   const __m256d S = _mm256_set1_pd( scale );
+   const __m256d L = _mm256_set1_pd( low );
+   const size_type n4 = n >> 2;
+   int K[ s_binBlockLength ];
+   for ( size_type i = 0; i < n4; )
+   {
+      int m = 0;
+      for ( ; m < s_binBlockLength && i < n4; m += 4, ++i )
+         _mm_storeu_si128( (__m128i*)(K + m), _mm256_cvttpd_epi32( _mm256_mul_pd( _mm256_sub_pd( _mm256_loadu_pd( f + (i << 2) ), L ), S ) ) );
+      AccumulateBins( H, length, K, m );
+   }
+   HistogramGeneric( H, length, f + (n4 << 2), n & 3, low, scale );
+}
+
+__PCL_BEGIN_AVX512_IMPLEMENTATIONS
+
+__PCL_TARGET_AVX512
+static void HistogramAVX512( size_type* __restrict__ H, int length, const float* __restrict__ f, size_type n, float low, float scale )
+{
+   const __m512 S = _mm512_set1_ps( scale );
+   const __m512 L = _mm512_set1_ps( low );
+   const size_type n16 = n >> 4;
+   int K[ s_binBlockLength ];
+   for ( size_type i = 0; i < n16; )
+   {
+      int m = 0;
+      for ( ; m < s_binBlockLength && i < n16; m += 16, ++i )
+         _mm512_storeu_si512( K + m, _mm512_cvttps_epi32( _mm512_mul_ps( _mm512_sub_ps( _mm512_loadu_ps( f + (i << 4) ), L ), S ) ) );
+      AccumulateBins( H, length, K, m );
+   }
+   HistogramGeneric( H, length, f + (n16 << 4), n & 15, low, scale );
+}
+
+__PCL_TARGET_AVX512
+static void HistogramAVX512( size_type* __restrict__ H, int length, const double* __restrict__ f, size_type n, double low, double scale )
+{
+   const __m512d S = _mm512_set1_pd( scale );
+   const __m512d L = _mm512_set1_pd( low );
+   const size_type n8 = n >> 3;
+   int K[ s_binBlockLength ];
+   for ( size_type i = 0; i < n8; )
+   {
+      int m = 0;
+      for ( ; m < s_binBlockLength && i < n8; m += 8, ++i )
+         _mm256_storeu_si256( (__m256i*)(K + m), _mm512_cvttpd_epi32( _mm512_mul_pd( _mm512_sub_pd( _mm512_loadu_pd( f + (i << 3) ), L ), S ) ) );
+      AccumulateBins( H, length, K, m );
+   }
+   HistogramGeneric( H, length, f + (n8 << 3), n & 7, low, scale );
+}
+
+__PCL_END_AVX512_IMPLEMENTATIONS
+
+#endif   // __PCL_SIMD_DISPATCH
+
+// ----------------------------------------------------------------------------
+// Histogram accumulation of absolute deviations
+// ----------------------------------------------------------------------------
+
+template <typename T>
+static void AbsDevHistogramGeneric( size_type* __restrict__ H, int length, const T* __restrict__ f, size_type n, T center, T low, T scale )
+{
+   for ( size_type i = 0; i < n; ++i )
+   {
+      const int k = int( scale*(Abs( f[i] - center ) - low) );
+      if ( k >= 0 && k < length )
+         ++H[k];
+   }
+}
+
+#ifdef __PCL_SIMD_DISPATCH
+
+/*
+ * Absolute values are computed by clearing sign bits.
+ */
+__PCL_TARGET_SSE4
+static void AbsDevHistogramSSE4( size_type* __restrict__ H, int length, const float* __restrict__ f, size_type n, float center, float low, float scale )
+{
+   const __m128 S = _mm_set1_ps( scale );
+   const __m128 L = _mm_set1_ps( low );
+   const __m128 C = _mm_set1_ps( center );
+   const __m128 M = _mm_castsi128_ps( _mm_set1_epi32( 0x7fffffff ) );
+   const size_type n4 = n >> 2;
+   int K[ s_binBlockLength ];
+   for ( size_type i = 0; i < n4; )
+   {
+      int m = 0;
+      for ( ; m < s_binBlockLength && i < n4; m += 4, ++i )
+         _mm_storeu_si128( (__m128i*)(K + m), _mm_cvttps_epi32( _mm_mul_ps( _mm_sub_ps(
+                              _mm_and_ps( _mm_sub_ps( _mm_loadu_ps( f + (i << 2) ), C ), M ), L ), S ) ) );
+      AccumulateBins( H, length, K, m );
+   }
+   AbsDevHistogramGeneric( H, length, f + (n4 << 2), n & 3, center, low, scale );
+}
+
+__PCL_TARGET_SSE4
+static void AbsDevHistogramSSE4( size_type* __restrict__ H, int length, const double* __restrict__ f, size_type n, double center, double low, double scale )
+{
+   const __m128d S = _mm_set1_pd( scale );
+   const __m128d L = _mm_set1_pd( low );
+   const __m128d C = _mm_set1_pd( center );
+   const __m128d M = _mm_castsi128_pd( _mm_set1_epi64x( 0x7fffffffffffffffll ) );
+   const size_type n2 = n >> 1;
+   int K[ s_binBlockLength ];
+   for ( size_type i = 0; i < n2; )
+   {
+      int m = 0;
+      for ( ; m < s_binBlockLength && i < n2; m += 2, ++i )
+         _mm_storel_epi64( (__m128i*)(K + m), _mm_cvttpd_epi32( _mm_mul_pd( _mm_sub_pd(
+                              _mm_and_pd( _mm_sub_pd( _mm_loadu_pd( f + (i << 1) ), C ), M ), L ), S ) ) );
+      AccumulateBins( H, length, K, m );
+   }
+   AbsDevHistogramGeneric( H, length, f + (n2 << 1), n & 1, center, low, scale );
+}
+
+__PCL_TARGET_AVX2
+static void AbsDevHistogramAVX2( size_type* __restrict__ H, int length, const float* __restrict__ f, size_type n, float center, float low, float scale )
+{
+   const __m256 S = _mm256_set1_ps( scale );
+   const __m256 L = _mm256_set1_ps( low );
+   const __m256 C = _mm256_set1_ps( center );
+   const __m256 M = _mm256_castsi256_ps( _mm256_set1_epi32( 0x7fffffff ) );
+   const size_type n8 = n >> 3;
+   int K[ s_binBlockLength ];
+   for ( size_type i = 0; i < n8; )
+   {
+      int m = 0;
+      for ( ; m < s_binBlockLength && i < n8; m += 8, ++i )
+         _mm256_storeu_si256( (__m256i*)(K + m), _mm256_cvttps_epi32( _mm256_mul_ps( _mm256_sub_ps(
+                              _mm256_and_ps( _mm256_sub_ps( _mm256_loadu_ps( f + (i << 3) ), C ), M ), L ), S ) ) );
+      AccumulateBins( H, length, K, m );
+   }
+   AbsDevHistogramGeneric( H, length, f + (n8 << 3), n & 7, center, low, scale );
+}
+
+__PCL_TARGET_AVX2
+static void AbsDevHistogramAVX2( size_type* __restrict__ H, int length, const double* __restrict__ f, size_type n, double center, double low, double scale )
+{
+   const __m256d S = _mm256_set1_pd( scale );
+   const __m256d L = _mm256_set1_pd( low );
+   const __m256d C = _mm256_set1_pd( center );
+   const __m256d M = _mm256_castsi256_pd( _mm256_set1_epi64x( 0x7fffffffffffffffll ) );
+   const size_type n4 = n >> 2;
+   int K[ s_binBlockLength ];
+   for ( size_type i = 0; i < n4; )
+   {
+      int m = 0;
+      for ( ; m < s_binBlockLength && i < n4; m += 4, ++i )
+         _mm_storeu_si128( (__m128i*)(K + m), _mm256_cvttpd_epi32( _mm256_mul_pd( _mm256_sub_pd(
+                              _mm256_and_pd( _mm256_sub_pd( _mm256_loadu_pd( f + (i << 2) ), C ), M ), L ), S ) ) );
+      AccumulateBins( H, length, K, m );
+   }
+   AbsDevHistogramGeneric( H, length, f + (n4 << 2), n & 3, center, low, scale );
+}
+
+__PCL_BEGIN_AVX512_IMPLEMENTATIONS
+
+__PCL_TARGET_AVX512
+static void AbsDevHistogramAVX512( size_type* __restrict__ H, int length, const float* __restrict__ f, size_type n, float center, float low, float scale )
+{
+   const __m512 S = _mm512_set1_ps( scale );
+   const __m512 L = _mm512_set1_ps( low );
+   const __m512 C = _mm512_set1_ps( center );
+   const size_type n16 = n >> 4;
+   int K[ s_binBlockLength ];
+   for ( size_type i = 0; i < n16; )
+   {
+      int m = 0;
+      for ( ; m < s_binBlockLength && i < n16; m += 16, ++i )
+         _mm512_storeu_si512( K + m, _mm512_cvttps_epi32( _mm512_mul_ps( _mm512_sub_ps(
+                              _mm512_abs_ps( _mm512_sub_ps( _mm512_loadu_ps( f + (i << 4) ), C ) ), L ), S ) ) );
+      AccumulateBins( H, length, K, m );
+   }
+   AbsDevHistogramGeneric( H, length, f + (n16 << 4), n & 15, center, low, scale );
+}
+
+__PCL_TARGET_AVX512
+static void AbsDevHistogramAVX512( size_type* __restrict__ H, int length, const double* __restrict__ f, size_type n, double center, double low, double scale )
+{
+   const __m512d S = _mm512_set1_pd( scale );
+   const __m512d L = _mm512_set1_pd( low );
+   const __m512d C = _mm512_set1_pd( center );
+   const size_type n8 = n >> 3;
+   int K[ s_binBlockLength ];
+   for ( size_type i = 0; i < n8; )
+   {
+      int m = 0;
+      for ( ; m < s_binBlockLength && i < n8; m += 8, ++i )
+         _mm256_storeu_si256( (__m256i*)(K + m), _mm512_cvttpd_epi32( _mm512_mul_pd( _mm512_sub_pd(
+                              _mm512_abs_pd( _mm512_sub_pd( _mm512_loadu_pd( f + (i << 3) ), C ) ), L ), S ) ) );
+      AccumulateBins( H, length, K, m );
+   }
+   AbsDevHistogramGeneric( H, length, f + (n8 << 3), n & 7, center, low, scale );
+}
+
+__PCL_END_AVX512_IMPLEMENTATIONS
+
+#endif   // __PCL_SIMD_DISPATCH
+
+// ----------------------------------------------------------------------------
+// Scaled complex multiplication
+// ----------------------------------------------------------------------------
+
+/*
+ * Complex arrays are processed as interleaved (re,im) pairs of real numbers.
+ */
+template <typename T>
+static void MultiplyComplexGeneric( T* __restrict__ x, const T* __restrict__ y, T k, size_type n )
+{
+   for ( size_type i = 0; i < n; ++i, x += 2, y += 2 )
+   {
+      const T re = x[0]*y[0] - x[1]*y[1];
+      const T im = x[0]*y[1] + x[1]*y[0];
+      x[0] = k*re;
+      x[1] = k*im;
+   }
+}
+
+#ifdef __PCL_SIMD_DISPATCH
+
+__PCL_TARGET_SSE4
+static void MultiplyComplexSSE4( float* __restrict__ x, const float* __restrict__ y, float k, size_type n )
+{
+   const __m128 K = _mm_set1_ps( k );
+   const size_type n2 = n >> 1;
+   for ( size_type i = 0; i < n2; ++i )
+   {
+      __m128 a = _mm_loadu_ps( x + (i << 2) );
+      __m128 b = _mm_loadu_ps( y + (i << 2) );
+      __m128 b_swap = _mm_shuffle_ps( b, b, 0xb1 );
+      __m128 a_re = _mm_moveldup_ps( a );
+      __m128 a_im = _mm_movehdup_ps( a );
+      __m128 c = _mm_addsub_ps( _mm_mul_ps( a_re, b ), _mm_mul_ps( a_im, b_swap ) );
+      _mm_storeu_ps( x + (i << 2), _mm_mul_ps( K, c ) );
+   }
+   if ( n & 1 )
+      MultiplyComplexGeneric( x + (n2 << 2), y + (n2 << 2), k, 1 );
+}
+
+__PCL_TARGET_SSE4
+static void MultiplyComplexSSE4( double* __restrict__ x, const double* __restrict__ y, double k, size_type n )
+{
+   const __m128d K = _mm_set1_pd( k );
+   for ( size_type i = 0; i < n; ++i )
+   {
+      __m128d a = _mm_loadu_pd( x + (i << 1) );
+      __m128d b = _mm_loadu_pd( y + (i << 1) );
+      __m128d b_swap = _mm_shuffle_pd( b, b, 1 );
+      __m128d a_re = _mm_movedup_pd( a );
+      __m128d a_im = _mm_unpackhi_pd( a, a );
+      __m128d c = _mm_addsub_pd( _mm_mul_pd( a_re, b ), _mm_mul_pd( a_im, b_swap ) );
+      _mm_storeu_pd( x + (i << 1), _mm_mul_pd( K, c ) );
+   }
+}
+
+__PCL_TARGET_AVX2
+static void MultiplyComplexAVX2( float* __restrict__ x, const float* __restrict__ y, float k, size_type n )
+{
+   const __m256 K = _mm256_set1_ps( k );
+   const size_type n4 = n >> 2;
+   for ( size_type i = 0; i < n4; ++i )
+   {
+      __m256 a = _mm256_loadu_ps( x + (i << 3) );
+      __m256 b = _mm256_loadu_ps( y + (i << 3) );
+      __m256 b_swap = _mm256_permute_ps( b, 0xb1 );
+      __m256 a_re = _mm256_moveldup_ps( a );
+      __m256 a_im = _mm256_movehdup_ps( a );
+      __m256 c = _mm256_fmaddsub_ps( a_re, b, _mm256_mul_ps( a_im, b_swap ) );
+      _mm256_storeu_ps( x + (i << 3), _mm256_mul_ps( K, c ) );
+   }
+   MultiplyComplexGeneric( x + (n4 << 3), y + (n4 << 3), k, n & 3 );
+}
+
+__PCL_TARGET_AVX2
+static void MultiplyComplexAVX2( double* __restrict__ x, const double* __restrict__ y, double k, size_type n )
+{
+   const __m256d K = _mm256_set1_pd( k );
+   const size_type n2 = n >> 1;
+   for ( size_type i = 0; i < n2; ++i )
+   {
+      __m256d a = _mm256_loadu_pd( x + (i << 2) );
+      __m256d b = _mm256_loadu_pd( y + (i << 2) );
+      __m256d b_swap = _mm256_permute_pd( b, 5 );
+      __m256d a_re = _mm256_movedup_pd( a );
+      __m256d a_im = _mm256_permute_pd( a, 15 );
+      __m256d c = _mm256_fmaddsub_pd( a_re, b, _mm256_mul_pd( a_im, b_swap ) );
+      _mm256_storeu_pd( x + (i << 2), _mm256_mul_pd( K, c ) );
+   }
+   MultiplyComplexGeneric( x + (n2 << 2), y + (n2 << 2), k, n & 1 );
+}
+
+__PCL_BEGIN_AVX512_IMPLEMENTATIONS
+
+__PCL_TARGET_AVX512
+static void MultiplyComplexAVX512( float* __restrict__ x, const float* __restrict__ y, float k, size_type n )
+{
+   const __m512 K = _mm512_set1_ps( k );
+   const size_type n8 = n >> 3;
+   for ( size_type i = 0; i < n8; ++i )
+   {
+      __m512 a = _mm512_loadu_ps( x + (i << 4) );
+      __m512 b = _mm512_loadu_ps( y + (i << 4) );
+      __m512 b_swap = _mm512_permute_ps( b, 0xb1 );
+      __m512 a_re = _mm512_moveldup_ps( a );
+      __m512 a_im = _mm512_movehdup_ps( a );
+      __m512 c = _mm512_fmaddsub_ps( a_re, b, _mm512_mul_ps( a_im, b_swap ) );
+      _mm512_storeu_ps( x + (i << 4), _mm512_mul_ps( K, c ) );
+   }
+   MultiplyComplexAVX2( x + (n8 << 4), y + (n8 << 4), k, n & 7 );
+}
+
+__PCL_TARGET_AVX512
+static void MultiplyComplexAVX512( double* __restrict__ x, const double* __restrict__ y, double k, size_type n )
+{
+   const __m512d K = _mm512_set1_pd( k );
+   const size_type n4 = n >> 2;
+   for ( size_type i = 0; i < n4; ++i )
+   {
+      __m512d a = _mm512_loadu_pd( x + (i << 3) );
+      __m512d b = _mm512_loadu_pd( y + (i << 3) );
+      __m512d b_swap = _mm512_permute_pd( b, 0x55 );
+      __m512d a_re = _mm512_movedup_pd( a );
+      __m512d a_im = _mm512_permute_pd( a, 0xff );
+      __m512d c = _mm512_fmaddsub_pd( a_re, b, _mm512_mul_pd( a_im, b_swap ) );
+      _mm512_storeu_pd( x + (i << 3), _mm512_mul_pd( K, c ) );
+   }
+   MultiplyComplexAVX2( x + (n4 << 3), y + (n4 << 3), k, n & 3 );
+}
+
+__PCL_END_AVX512_IMPLEMENTATIONS
+
+#endif   // __PCL_SIMD_DISPATCH
+
+// ----------------------------------------------------------------------------
+// Dot product
+// ----------------------------------------------------------------------------
+
+template <typename T>
+static double DotProductGeneric( const T* __restrict__ x, const T* __restrict__ y, size_type n )
+{
+   double r = 0;
+   for ( size_type i = 0; i < n; ++i )
+      r += double( x[i] ) * double( y[i] );
+   return r;
+}
+
+#ifdef __PCL_SIMD_DISPATCH
+
+__PCL_TARGET_SSE4
+static double DotProductSSE4( const float* __restrict__ x, const float* __restrict__ y, size_type n )
+{
+   const size_type n4 = n >> 2;
+   __m128 d = _mm_setzero_ps();
+   for ( size_type i = 0; i < n4; ++i )
+      d = _mm_add_ps( d, _mm_mul_ps( _mm_loadu_ps( x + (i << 2) ), _mm_loadu_ps( y + (i << 2) ) ) );
+   d = _mm_hadd_ps( d, d );
+   d = _mm_hadd_ps( d, d );
+   return _mm_cvtss_f32( d ) + DotProductGeneric( x + (n4 << 2), y + (n4 << 2), n & 3 );
+}
+
+__PCL_TARGET_SSE4
+static double DotProductSSE4( const double* __restrict__ x, const double* __restrict__ y, size_type n )
+{
+   const size_type n2 = n >> 1;
+   __m128d d = _mm_setzero_pd();
+   for ( size_type i = 0; i < n2; ++i )
+      d = _mm_add_pd( d, _mm_mul_pd( _mm_loadu_pd( x + (i << 1) ), _mm_loadu_pd( y + (i << 1) ) ) );
+   d = _mm_hadd_pd( d, d );
+   return _mm_cvtsd_f64( d ) + DotProductGeneric( x + (n2 << 1), y + (n2 << 1), n & 1 );
+}
+
+__PCL_TARGET_AVX2
+static double DotProductAVX2( const float* __restrict__ x, const float* __restrict__ y, size_type n )
+{
+   const size_type n8 = n >> 3;
+   __m256 d = _mm256_setzero_ps();
+   for ( size_type i = 0; i < n8; ++i )
+      d = _mm256_fmadd_ps( _mm256_loadu_ps( x + (i << 3) ), _mm256_loadu_ps( y + (i << 3) ), d );
+   __m128 s = _mm_add_ps( _mm256_castps256_ps128( d ), _mm256_extractf128_ps( d, 1 ) );
+   s = _mm_hadd_ps( s, s );
+   s = _mm_hadd_ps( s, s );
+   return _mm_cvtss_f32( s ) + DotProductGeneric( x + (n8 << 3), y + (n8 << 3), n & 7 );
+}
+
+__PCL_TARGET_AVX2
+static double DotProductAVX2( const double* __restrict__ x, const double* __restrict__ y, size_type n )
+{
+   const size_type n4 = n >> 2;
+   __m256d d = _mm256_setzero_pd();
+   for ( size_type i = 0; i < n4; ++i )
+      d = _mm256_fmadd_pd( _mm256_loadu_pd( x + (i << 2) ), _mm256_loadu_pd( y + (i << 2) ), d );
+   __m128d s = _mm_add_pd( _mm256_castpd256_pd128( d ), _mm256_extractf128_pd( d, 1 ) );
+   s = _mm_hadd_pd( s, s );
+   return _mm_cvtsd_f64( s ) + DotProductGeneric( x + (n4 << 2), y + (n4 << 2), n & 3 );
+}
+
+__PCL_BEGIN_AVX512_IMPLEMENTATIONS
+
+__PCL_TARGET_AVX512
+static double DotProductAVX512( const float* __restrict__ x, const float* __restrict__ y, size_type n )
+{
+   const size_type n16 = n >> 4;
+   __m512 d = _mm512_setzero_ps();
+   for ( size_type i = 0; i < n16; ++i )
+      d = _mm512_fmadd_ps( _mm512_loadu_ps( x + (i << 4) ), _mm512_loadu_ps( y + (i << 4) ), d );
+   return _mm512_reduce_add_ps( d ) + DotProductAVX2( x + (n16 << 4), y + (n16 << 4), n & 15 );
+}
+
+__PCL_TARGET_AVX512
+static double DotProductAVX512( const double* __restrict__ x, const double* __restrict__ y, size_type n )
+{
+   const size_type n8 = n >> 3;
+   __m512d d = _mm512_setzero_pd();
+   for ( size_type i = 0; i < n8; ++i )
+      d = _mm512_fmadd_pd( _mm512_loadu_pd( x + (i << 3) ), _mm512_loadu_pd( y + (i << 3) ), d );
+   return _mm512_reduce_add_pd( d ) + DotProductAVX2( x + (n8 << 3), y + (n8 << 3), n & 7 );
+}
+
+__PCL_END_AVX512_IMPLEMENTATIONS
+
+#endif   // __PCL_SIMD_DISPATCH
+
+// ----------------------------------------------------------------------------
+// Indexed dot product
+// ----------------------------------------------------------------------------
+
+template <typename T>
+static double IndexedDotProductGeneric( const T* __restrict__ x, const T* __restrict__ y, const int* __restrict__ index, size_type n )
+{
+   double r = 0;
+   for ( size_type i = 0; i < n; ++i )
+      r += double( x[index[i]] ) * double( y[i] );
+   return r;
+}
+
+#ifdef __PCL_SIMD_DISPATCH
+
+/*
+ * Gather instructions are only available since AVX2, so there are no SSE4
+ * implementations of this kernel. The AVX2 masked gather forms avoid GCC
+ * uninitialized value warnings caused by the unmasked intrinsics.
+ */
+__PCL_TARGET_AVX2
+static double IndexedDotProductAVX2( const float* __restrict__ x, const float* __restrict__ y, const int* __restrict__ index, size_type n )
+{
+   const __m256 M = _mm256_castsi256_ps( _mm256_set1_epi32( -1 ) );
+   const size_type n8 = n >> 3;
+   __m256 d = _mm256_setzero_ps();
+   for ( size_type i = 0; i < n8; ++i )
+      d = _mm256_fmadd_ps( _mm256_mask_i32gather_ps( _mm256_setzero_ps(), x, _mm256_loadu_si256( (const __m256i*)(index + (i << 3)) ), M, 4 ),
+                           _mm256_loadu_ps( y + (i << 3) ), d );
+   __m128 s = _mm_add_ps( _mm256_castps256_ps128( d ), _mm256_extractf128_ps( d, 1 ) );
+   s = _mm_hadd_ps( s, s );
+   s = _mm_hadd_ps( s, s );
+   return _mm_cvtss_f32( s ) + IndexedDotProductGeneric( x, y + (n8 << 3), index + (n8 << 3), n & 7 );
+}
+
+__PCL_TARGET_AVX2
+static double IndexedDotProductAVX2( const double* __restrict__ x, const double* __restrict__ y, const int* __restrict__ index, size_type n )
+{
+   const __m256d M = _mm256_castsi256_pd( _mm256_set1_epi64x( -1 ) );
+   const size_type n4 = n >> 2;
+   __m256d d = _mm256_setzero_pd();
+   for ( size_type i = 0; i < n4; ++i )
+      d = _mm256_fmadd_pd( _mm256_mask_i32gather_pd( _mm256_setzero_pd(), x, _mm_loadu_si128( (const __m128i*)(index + (i << 2)) ), M, 8 ),
+                           _mm256_loadu_pd( y + (i << 2) ), d );
+   __m128d s = _mm_add_pd( _mm256_castpd256_pd128( d ), _mm256_extractf128_pd( d, 1 ) );
+   s = _mm_hadd_pd( s, s );
+   return _mm_cvtsd_f64( s ) + IndexedDotProductGeneric( x, y + (n4 << 2), index + (n4 << 2), n & 3 );
+}
+
+__PCL_BEGIN_AVX512_IMPLEMENTATIONS
+
+__PCL_TARGET_AVX512
+static double IndexedDotProductAVX512( const float* __restrict__ x, const float* __restrict__ y, const int* __restrict__ index, size_type n )
+{
+   const size_type n16 = n >> 4;
+   __m512 d = _mm512_setzero_ps();
+   for ( size_type i = 0; i < n16; ++i )
+      d = _mm512_fmadd_ps( _mm512_i32gather_ps( _mm512_loadu_si512( index + (i << 4) ), x, 4 ),
+                           _mm512_loadu_ps( y + (i << 4) ), d );
+   return _mm512_reduce_add_ps( d ) + IndexedDotProductAVX2( x, y + (n16 << 4), index + (n16 << 4), n & 15 );
+}
+
+__PCL_TARGET_AVX512
+static double IndexedDotProductAVX512( const double* __restrict__ x, const double* __restrict__ y, const int* __restrict__ index, size_type n )
+{
+   const size_type n8 = n >> 3;
+   __m512d d = _mm512_setzero_pd();
+   for ( size_type i = 0; i < n8; ++i )
+      d = _mm512_fmadd_pd( _mm512_i32gather_pd( _mm256_loadu_si256( (const __m256i*)(index + (i << 3)) ), x, 8 ),
+                           _mm512_loadu_pd( y + (i << 3) ), d );
+   return _mm512_reduce_add_pd( d ) + IndexedDotProductAVX2( x, y + (n8 << 3), index + (n8 << 3), n & 7 );
+}
+
+__PCL_END_AVX512_IMPLEMENTATIONS
+
+#endif   // __PCL_SIMD_DISPATCH
+
+// ----------------------------------------------------------------------------
+// Chebyshev series
+// ----------------------------------------------------------------------------
+
+/*
+ * Clenshaw recurrences for a set of evaluation points y in [-1,+1]. The
+ * vector implementations evaluate groups of consecutive points in parallel.
+ * Results are written to the array r.
+ */
+static void ChebyshevSeriesGeneric( double* __restrict__ r, const double* __restrict__ y, size_type n, const double* __restrict__ c, int m )
+{
+   for ( size_type j = 0; j < n; ++j )
+   {
+      const double y0 = y[j];
+      const double y2 = y0 + y0;
+      double d0 = 0, d1 = 0;
+      for ( int l = m; --l > 0; )
+      {
+         double d = d1;
+         d1 = y2*d1 - d0 + c[l];
+         d0 = d;
+      }
+      r[j] = y0*d1 - d0 + c[0]/2;
+   }
+}
+
+#ifdef __PCL_SIMD_DISPATCH
+
+__PCL_TARGET_SSE4
+static void ChebyshevSeriesSSE4( double* __restrict__ r, const double* __restrict__ y, size_type n, const double* __restrict__ c, int m )
+{
+   const size_type n2 = n >> 1;
+   const __m128d c0 = _mm_set1_pd( c[0]/2 );
+   for ( size_type j = 0; j < n2; ++j )
+   {
+      const __m128d y0 = _mm_loadu_pd( y + (j << 1) );
+      const __m128d y2 = _mm_add_pd( y0, y0 );
+      __m128d d0 = _mm_setzero_pd();
+      __m128d d1 = _mm_setzero_pd();
+      for ( int l = m; --l > 0; )
+      {
+         __m128d d = d1;
+         d1 = _mm_add_pd( _mm_sub_pd( _mm_mul_pd( y2, d1 ), d0 ), _mm_set1_pd( c[l] ) );
+         d0 = d;
+      }
+      _mm_storeu_pd( r + (j << 1), _mm_add_pd( _mm_sub_pd( _mm_mul_pd( y0, d1 ), d0 ), c0 ) );
+   }
+   ChebyshevSeriesGeneric( r + (n2 << 1), y + (n2 << 1), n & 1, c, m );
+}
+
+__PCL_TARGET_AVX2
+static void ChebyshevSeriesAVX2( double* __restrict__ r, const double* __restrict__ y, size_type n, const double* __restrict__ c, int m )
+{
+   const size_type n4 = n >> 2;
+   const __m256d c0 = _mm256_set1_pd( c[0]/2 );
+   for ( size_type j = 0; j < n4; ++j )
+   {
+      const __m256d y0 = _mm256_loadu_pd( y + (j << 2) );
+      const __m256d y2 = _mm256_add_pd( y0, y0 );
+      __m256d d0 = _mm256_setzero_pd();
+      __m256d d1 = _mm256_setzero_pd();
+      for ( int l = m; --l > 0; )
+      {
+         __m256d d = d1;
+         d1 = _mm256_add_pd( _mm256_fmsub_pd( y2, d1, d0 ), _mm256_set1_pd( c[l] ) );
+         d0 = d;
+      }
+      _mm256_storeu_pd( r + (j << 2), _mm256_add_pd( _mm256_fmsub_pd( y0, d1, d0 ), c0 ) );
+   }
+   ChebyshevSeriesSSE4( r + (n4 << 2), y + (n4 << 2), n & 3, c, m );
+}
+
+__PCL_BEGIN_AVX512_IMPLEMENTATIONS
+
+__PCL_TARGET_AVX512
+static void ChebyshevSeriesAVX512( double* __restrict__ r, const double* __restrict__ y, size_type n, const double* __restrict__ c, int m )
+{
+   const size_type n8 = n >> 3;
+   const __m512d c0 = _mm512_set1_pd( c[0]/2 );
+   for ( size_type j = 0; j < n8; ++j )
+   {
+      const __m512d y0 = _mm512_loadu_pd( y + (j << 3) );
+      const __m512d y2 = _mm512_add_pd( y0, y0 );
+      __m512d d0 = _mm512_setzero_pd();
+      __m512d d1 = _mm512_setzero_pd();
+      for ( int l = m; --l > 0; )
+      {
+         __m512d d = d1;
+         d1 = _mm512_add_pd( _mm512_fmsub_pd( y2, d1, d0 ), _mm512_set1_pd( c[l] ) );
+         d0 = d;
+      }
+      _mm512_storeu_pd( r + (j << 3), _mm512_add_pd( _mm512_fmsub_pd( y0, d1, d0 ), c0 ) );
+   }
+   ChebyshevSeriesAVX2( r + (n8 << 3), y + (n8 << 3), n & 7, c, m );
+}
+
+__PCL_END_AVX512_IMPLEMENTATIONS
+
+#endif   // __PCL_SIMD_DISPATCH
+
+// ----------------------------------------------------------------------------
+// FFT butterflies
+// ----------------------------------------------------------------------------
+
+/*
+ * Radix-2 and radix-4 butterflies of a Stockham autosort FFT. Strides and
+ * lengths are expressed in complex elements; complex arrays are processed as
+ * interleaved (re,im) pairs. The twiddle factors w_j, j > 0, are constant for
+ * the n butterflies processed in a call. Multiplication by sign*i is
+ * implemented as a swap of real and imaginary components, followed by a
+ * multiplication by (-sign,+sign).
+ */
+template <typename T>
+static void FFTRadix2Generic( T* __restrict__ y, size_type ys, const T* __restrict__ x, size_type xs,
+                              const T* __restrict__ w, T /*sign*/, size_type n )
+{
+   const T* __restrict__ x1 = x + 2*xs;
+   T* __restrict__ y1 = y + 2*ys;
+   for ( size_type i = 0, k = 0; i < n; ++i, k += 2 )
+   {
+      const T dr = x[k] - x1[k];
+      const T di = x[k+1] - x1[k+1];
+      y[k] = x[k] + x1[k];
+      y[k+1] = x[k+1] + x1[k+1];
+      y1[k] = dr*w[0] - di*w[1];
+      y1[k+1] = dr*w[1] + di*w[0];
+   }
+}
+
+template <typename T>
+static void FFTRadix4Generic( T* __restrict__ y, size_type ys, const T* __restrict__ x, size_type xs,
+                              const T* __restrict__ w, T sign, size_type n )
+{
+   const T* __restrict__ x1 = x + 2*xs;
+   const T* __restrict__ x2 = x1 + 2*xs;
+   const T* __restrict__ x3 = x2 + 2*xs;
+   T* __restrict__ y1 = y + 2*ys;
+   T* __restrict__ y2 = y1 + 2*ys;
+   T* __restrict__ y3 = y2 + 2*ys;
+   for ( size_type i = 0, k = 0; i < n; ++i, k += 2 )
+   {
+      const T t0r = x[k] + x2[k], t0i = x[k+1] + x2[k+1];
+      const T t1r = x[k] - x2[k], t1i = x[k+1] - x2[k+1];
+      const T t2r = x1[k] + x3[k], t2i = x1[k+1] + x3[k+1];
+      const T t3r = -sign*(x1[k+1] - x3[k+1]), t3i = sign*(x1[k] - x3[k]);
+      y[k] = t0r + t2r;
+      y[k+1] = t0i + t2i;
+      const T ar = t1r + t3r, ai = t1i + t3i;
+      y1[k] = ar*w[0] - ai*w[1];
+      y1[k+1] = ar*w[1] + ai*w[0];
+      const T br = t0r - t2r, bi = t0i - t2i;
+      y2[k] = br*w[2] - bi*w[3];
+      y2[k+1] = br*w[3] + bi*w[2];
+      const T cr = t1r - t3r, ci = t1i - t3i;
+      y3[k] = cr*w[4] - ci*w[5];
+      y3[k+1] = cr*w[5] + ci*w[4];
+   }
+}
+
+#ifdef __PCL_SIMD_DISPATCH
+
+__PCL_TARGET_SSE4
+static void FFTRadix2SSE4( float* __restrict__ y, size_type ys, const float* __restrict__ x, size_type xs,
+                           const float* __restrict__ w, float sign, size_type n )
+{
+   const __m128 wr = _mm_set1_ps( w[0] );
+   const __m128 wi = _mm_set1_ps( w[1] );
+   const size_type n2 = n >> 1;
+   for ( size_type i = 0; i < n2; ++i )
+   {
+      const size_type k = i << 2;
+      __m128 a0 = _mm_loadu_ps( x + k );
+      __m128 a1 = _mm_loadu_ps( x + 2*xs + k );
+      __m128 d = _mm_sub_ps( a0, a1 );
+      _mm_storeu_ps( y + k, _mm_add_ps( a0, a1 ) );
+      _mm_storeu_ps( y + 2*ys + k, _mm_addsub_ps( _mm_mul_ps( d, wr ), _mm_mul_ps( _mm_shuffle_ps( d, d, 0xb1 ), wi ) ) );
+   }
+   if ( n & 1 )
+      FFTRadix2Generic( y + (n2 << 2), ys, x + (n2 << 2), xs, w, sign, 1 );
+}
+
+__PCL_TARGET_SSE4
+static void FFTRadix2SSE4( double* __restrict__ y, size_type ys, const double* __restrict__ x, size_type xs,
+                           const double* __restrict__ w, double /*sign*/, size_type n )
+{
+   const __m128d wr = _mm_set1_pd( w[0] );
+   const __m128d wi = _mm_set1_pd( w[1] );
+   for ( size_type i = 0; i < n; ++i )
+   {
+      const size_type k = i << 1;
+      __m128d a0 = _mm_loadu_pd( x + k );
+      __m128d a1 = _mm_loadu_pd( x + 2*xs + k );
+      __m128d d = _mm_sub_pd( a0, a1 );
+      _mm_storeu_pd( y + k, _mm_add_pd( a0, a1 ) );
+      _mm_storeu_pd( y + 2*ys + k, _mm_addsub_pd( _mm_mul_pd( d, wr ), _mm_mul_pd( _mm_shuffle_pd( d, d, 1 ), wi ) ) );
+   }
+}
+
+__PCL_TARGET_SSE4
+static void FFTRadix4SSE4( float* __restrict__ y, size_type ys, const float* __restrict__ x, size_type xs,
+                           const float* __restrict__ w, float sign, size_type n )
+{
+   const __m128 w1r = _mm_set1_ps( w[0] ), w1i = _mm_set1_ps( w[1] );
+   const __m128 w2r = _mm_set1_ps( w[2] ), w2i = _mm_set1_ps( w[3] );
+   const __m128 w3r = _mm_set1_ps( w[4] ), w3i = _mm_set1_ps( w[5] );
+   const __m128 rot = _mm_setr_ps( -sign, sign, -sign, sign );
+   const size_type n2 = n >> 1;
+   for ( size_type i = 0; i < n2; ++i )
+   {
+      const size_type k = i << 2;
+      __m128 a0 = _mm_loadu_ps( x + k );
+      __m128 a1 = _mm_loadu_ps( x + 2*xs + k );
+      __m128 a2 = _mm_loadu_ps( x + 4*xs + k );
+      __m128 a3 = _mm_loadu_ps( x + 6*xs + k );
+      __m128 t0 = _mm_add_ps( a0, a2 );
+      __m128 t1 = _mm_sub_ps( a0, a2 );
+      __m128 t2 = _mm_add_ps( a1, a3 );
+      __m128 t3 = _mm_sub_ps( a1, a3 );
+      t3 = _mm_mul_ps( _mm_shuffle_ps( t3, t3, 0xb1 ), rot );
+      __m128 b1 = _mm_add_ps( t1, t3 );
+      __m128 b2 = _mm_sub_ps( t0, t2 );
+      __m128 b3 = _mm_sub_ps( t1, t3 );
+      _mm_storeu_ps( y + k, _mm_add_ps( t0, t2 ) );
+      _mm_storeu_ps( y + 2*ys + k, _mm_addsub_ps( _mm_mul_ps( b1, w1r ), _mm_mul_ps( _mm_shuffle_ps( b1, b1, 0xb1 ), w1i ) ) );
+      _mm_storeu_ps( y + 4*ys + k, _mm_addsub_ps( _mm_mul_ps( b2, w2r ), _mm_mul_ps( _mm_shuffle_ps( b2, b2, 0xb1 ), w2i ) ) );
+      _mm_storeu_ps( y + 6*ys + k, _mm_addsub_ps( _mm_mul_ps( b3, w3r ), _mm_mul_ps( _mm_shuffle_ps( b3, b3, 0xb1 ), w3i ) ) );
+   }
+   if ( n & 1 )
+      FFTRadix4Generic( y + (n2 << 2), ys, x + (n2 << 2), xs, w, sign, 1 );
+}
+
+__PCL_TARGET_SSE4
+static void FFTRadix4SSE4( double* __restrict__ y, size_type ys, const double* __restrict__ x, size_type xs,
+                           const double* __restrict__ w, double sign, size_type n )
+{
+   const __m128d w1r = _mm_set1_pd( w[0] ), w1i = _mm_set1_pd( w[1] );
+   const __m128d w2r = _mm_set1_pd( w[2] ), w2i = _mm_set1_pd( w[3] );
+   const __m128d w3r = _mm_set1_pd( w[4] ), w3i = _mm_set1_pd( w[5] );
+   const __m128d rot = _mm_setr_pd( -sign, sign );
+   for ( size_type i = 0; i < n; ++i )
+   {
+      const size_type k = i << 1;
+      __m128d a0 = _mm_loadu_pd( x + k );
+      __m128d a1 = _mm_loadu_pd( x + 2*xs + k );
+      __m128d a2 = _mm_loadu_pd( x + 4*xs + k );
+      __m128d a3 = _mm_loadu_pd( x + 6*xs + k );
+      __m128d t0 = _mm_add_pd( a0, a2 );
+      __m128d t1 = _mm_sub_pd( a0, a2 );
+      __m128d t2 = _mm_add_pd( a1, a3 );
+      __m128d t3 = _mm_sub_pd( a1, a3 );
+      t3 = _mm_mul_pd( _mm_shuffle_pd( t3, t3, 1 ), rot );
+      __m128d b1 = _mm_add_pd( t1, t3 );
+      __m128d b2 = _mm_sub_pd( t0, t2 );
+      __m128d b3 = _mm_sub_pd( t1, t3 );
+      _mm_storeu_pd( y + k, _mm_add_pd( t0, t2 ) );
+      _mm_storeu_pd( y + 2*ys + k, _mm_addsub_pd( _mm_mul_pd( b1, w1r ), _mm_mul_pd( _mm_shuffle_pd( b1, b1, 1 ), w1i ) ) );
+      _mm_storeu_pd( y + 4*ys + k, _mm_addsub_pd( _mm_mul_pd( b2, w2r ), _mm_mul_pd( _mm_shuffle_pd( b2, b2, 1 ), w2i ) ) );
+      _mm_storeu_pd( y + 6*ys + k, _mm_addsub_pd( _mm_mul_pd( b3, w3r ), _mm_mul_pd( _mm_shuffle_pd( b3, b3, 1 ), w3i ) ) );
+   }
+}
+
+__PCL_TARGET_AVX2
+static void FFTRadix2AVX2( float* __restrict__ y, size_type ys, const float* __restrict__ x, size_type xs,
+                           const float* __restrict__ w, float sign, size_type n )
+{
+   const __m256 wr = _mm256_set1_ps( w[0] );
+   const __m256 wi = _mm256_set1_ps( w[1] );
+   const size_type n4 = n >> 2;
+   for ( size_type i = 0; i < n4; ++i )
+   {
+      const size_type k = i << 3;
+      __m256 a0 = _mm256_loadu_ps( x + k );
+      __m256 a1 = _mm256_loadu_ps( x + 2*xs + k );
+      __m256 d = _mm256_sub_ps( a0, a1 );
+      _mm256_storeu_ps( y + k, _mm256_add_ps( a0, a1 ) );
+      _mm256_storeu_ps( y + 2*ys + k, _mm256_fmaddsub_ps( d, wr, _mm256_mul_ps( _mm256_permute_ps( d, 0xb1 ), wi ) ) );
+   }
+   FFTRadix2Generic( y + (n4 << 3), ys, x + (n4 << 3), xs, w, sign, n & 3 );
+}
+
+__PCL_TARGET_AVX2
+static void FFTRadix2AVX2( double* __restrict__ y, size_type ys, const double* __restrict__ x, size_type xs,
+                           const double* __restrict__ w, double sign, size_type n )
+{
+   const __m256d wr = _mm256_set1_pd( w[0] );
+   const __m256d wi = _mm256_set1_pd( w[1] );
+   const size_type n2 = n >> 1;
+   for ( size_type i = 0; i < n2; ++i )
+   {
+      const size_type k = i << 2;
+      __m256d a0 = _mm256_loadu_pd( x + k );
+      __m256d a1 = _mm256_loadu_pd( x + 2*xs + k );
+      __m256d d = _mm256_sub_pd( a0, a1 );
+      _mm256_storeu_pd( y + k, _mm256_add_pd( a0, a1 ) );
+      _mm256_storeu_pd( y + 2*ys + k, _mm256_fmaddsub_pd( d, wr, _mm256_mul_pd( _mm256_permute_pd( d, 5 ), wi ) ) );
+   }
+   FFTRadix2Generic( y + (n2 << 2), ys, x + (n2 << 2), xs, w, sign, n & 1 );
+}
+
+__PCL_TARGET_AVX2
+static void FFTRadix4AVX2( float* __restrict__ y, size_type ys, const float* __restrict__ x, size_type xs,
+                           const float* __restrict__ w, float sign, size_type n )
+{
+   const __m256 w1r = _mm256_set1_ps( w[0] ), w1i = _mm256_set1_ps( w[1] );
+   const __m256 w2r = _mm256_set1_ps( w[2] ), w2i = _mm256_set1_ps( w[3] );
+   const __m256 w3r = _mm256_set1_ps( w[4] ), w3i = _mm256_set1_ps( w[5] );
+   const __m256 rot = _mm256_setr_ps( -sign, sign, -sign, sign, -sign, sign, -sign, sign );
+   const size_type n4 = n >> 2;
+   for ( size_type i = 0; i < n4; ++i )
+   {
+      const size_type k = i << 3;
+      __m256 a0 = _mm256_loadu_ps( x + k );
+      __m256 a1 = _mm256_loadu_ps( x + 2*xs + k );
+      __m256 a2 = _mm256_loadu_ps( x + 4*xs + k );
+      __m256 a3 = _mm256_loadu_ps( x + 6*xs + k );
+      __m256 t0 = _mm256_add_ps( a0, a2 );
+      __m256 t1 = _mm256_sub_ps( a0, a2 );
+      __m256 t2 = _mm256_add_ps( a1, a3 );
+      __m256 t3 = _mm256_mul_ps( _mm256_permute_ps( _mm256_sub_ps( a1, a3 ), 0xb1 ), rot );
+      __m256 b1 = _mm256_add_ps( t1, t3 );
+      __m256 b2 = _mm256_sub_ps( t0, t2 );
+      __m256 b3 = _mm256_sub_ps( t1, t3 );
+      _mm256_storeu_ps( y + k, _mm256_add_ps( t0, t2 ) );
+      _mm256_storeu_ps( y + 2*ys + k, _mm256_fmaddsub_ps( b1, w1r, _mm256_mul_ps( _mm256_permute_ps( b1, 0xb1 ), w1i ) ) );
+      _mm256_storeu_ps( y + 4*ys + k, _mm256_fmaddsub_ps( b2, w2r, _mm256_mul_ps( _mm256_permute_ps( b2, 0xb1 ), w2i ) ) );
+      _mm256_storeu_ps( y + 6*ys + k, _mm256_fmaddsub_ps( b3, w3r, _mm256_mul_ps( _mm256_permute_ps( b3, 0xb1 ), w3i ) ) );
+   }
+   FFTRadix4Generic( y + (n4 << 3), ys, x + (n4 << 3), xs, w, sign, n & 3 );
+}
+
+__PCL_TARGET_AVX2
+static void FFTRadix4AVX2( double* __restrict__ y, size_type ys, const double* __restrict__ x, size_type xs,
+                           const double* __restrict__ w, double sign, size_type n )
+{
+   const __m256d w1r = _mm256_set1_pd( w[0] ), w1i = _mm256_set1_pd( w[1] );
+   const __m256d w2r = _mm256_set1_pd( w[2] ), w2i = _mm256_set1_pd( w[3] );
+   const __m256d w3r = _mm256_set1_pd( w[4] ), w3i = _mm256_set1_pd( w[5] );
+   const __m256d rot = _mm256_setr_pd( -sign, sign, -sign, sign );
+   const size_type n2 = n >> 1;
+   for ( size_type i = 0; i < n2; ++i )
+   {
+      const size_type k = i << 2;
+      __m256d a0 = _mm256_loadu_pd( x + k );
+      __m256d a1 = _mm256_loadu_pd( x + 2*xs + k );
+      __m256d a2 = _mm256_loadu_pd( x + 4*xs + k );
+      __m256d a3 = _mm256_loadu_pd( x + 6*xs + k );
+      __m256d t0 = _mm256_add_pd( a0, a2 );
+      __m256d t1 = _mm256_sub_pd( a0, a2 );
+      __m256d t2 = _mm256_add_pd( a1, a3 );
+      __m256d t3 = _mm256_mul_pd( _mm256_permute_pd( _mm256_sub_pd( a1, a3 ), 5 ), rot );
+      __m256d b1 = _mm256_add_pd( t1, t3 );
+      __m256d b2 = _mm256_sub_pd( t0, t2 );
+      __m256d b3 = _mm256_sub_pd( t1, t3 );
+      _mm256_storeu_pd( y + k, _mm256_add_pd( t0, t2 ) );
+      _mm256_storeu_pd( y + 2*ys + k, _mm256_fmaddsub_pd( b1, w1r, _mm256_mul_pd( _mm256_permute_pd( b1, 5 ), w1i ) ) );
+      _mm256_storeu_pd( y + 4*ys + k, _mm256_fmaddsub_pd( b2, w2r, _mm256_mul_pd( _mm256_permute_pd( b2, 5 ), w2i ) ) );
+      _mm256_storeu_pd( y + 6*ys + k, _mm256_fmaddsub_pd( b3, w3r, _mm256_mul_pd( _mm256_permute_pd( b3, 5 ), w3i ) ) );
+   }
+   FFTRadix4Generic( y + (n2 << 2), ys, x + (n2 << 2), xs, w, sign, n & 1 );
+}
+
+__PCL_BEGIN_AVX512_IMPLEMENTATIONS
+
+__PCL_TARGET_AVX512
+static void FFTRadix2AVX512( float* __restrict__ y, size_type ys, const float* __restrict__ x, size_type xs,
+                             const float* __restrict__ w, float sign, size_type n )
+{
+   const __m512 wr = _mm512_set1_ps( w[0] );
+   const __m512 wi = _mm512_set1_ps( w[1] );
+   const size_type n8 = n >> 3;
+   for ( size_type i = 0; i < n8; ++i )
+   {
+      const size_type k = i << 4;
+      __m512 a0 = _mm512_loadu_ps( x + k );
+      __m512 a1 = _mm512_loadu_ps( x + 2*xs + k );
+      __m512 d = _mm512_sub_ps( a0, a1 );
+      _mm512_storeu_ps( y + k, _mm512_add_ps( a0, a1 ) );
+      _mm512_storeu_ps( y + 2*ys + k, _mm512_fmaddsub_ps( d, wr, _mm512_mul_ps( _mm512_permute_ps( d, 0xb1 ), wi ) ) );
+   }
+   FFTRadix2AVX2( y + (n8 << 4), ys, x + (n8 << 4), xs, w, sign, n & 7 );
+}
+
+__PCL_TARGET_AVX512
+static void FFTRadix2AVX512( double* __restrict__ y, size_type ys, const double* __restrict__ x, size_type xs,
+                             const double* __restrict__ w, double sign, size_type n )
+{
+   const __m512d wr = _mm512_set1_pd( w[0] );
+   const __m512d wi = _mm512_set1_pd( w[1] );
+   const size_type n4 = n >> 2;
+   for ( size_type i = 0; i < n4; ++i )
+   {
+      const size_type k = i << 3;
+      __m512d a0 = _mm512_loadu_pd( x + k );
+      __m512d a1 = _mm512_loadu_pd( x + 2*xs + k );
+      __m512d d = _mm512_sub_pd( a0, a1 );
+      _mm512_storeu_pd( y + k, _mm512_add_pd( a0, a1 ) );
+      _mm512_storeu_pd( y + 2*ys + k, _mm512_fmaddsub_pd( d, wr, _mm512_mul_pd( _mm512_permute_pd( d, 0x55 ), wi ) ) );
+   }
+   FFTRadix2AVX2( y + (n4 << 3), ys, x + (n4 << 3), xs, w, sign, n & 3 );
+}
+
+__PCL_TARGET_AVX512
+static void FFTRadix4AVX512( float* __restrict__ y, size_type ys, const float* __restrict__ x, size_type xs,
+                             const float* __restrict__ w, float sign, size_type n )
+{
+   const __m512 w1r = _mm512_set1_ps( w[0] ), w1i = _mm512_set1_ps( w[1] );
+   const __m512 w2r = _mm512_set1_ps( w[2] ), w2i = _mm512_set1_ps( w[3] );
+   const __m512 w3r = _mm512_set1_ps( w[4] ), w3i = _mm512_set1_ps( w[5] );
+   const __m512 rot = _mm512_mul_ps( _mm512_set1_ps( sign ),
+                                     _mm512_setr_ps( -1, 1, -1, 1, -1, 1, -1, 1, -1, 1, -1, 1, -1, 1, -1, 1 ) );
+   const size_type n8 = n >> 3;
+   for ( size_type i = 0; i < n8; ++i )
+   {
+      const size_type k = i << 4;
+      __m512 a0 = _mm512_loadu_ps( x + k );
+      __m512 a1 = _mm512_loadu_ps( x + 2*xs + k );
+      __m512 a2 = _mm512_loadu_ps( x + 4*xs + k );
+      __m512 a3 = _mm512_loadu_ps( x + 6*xs + k );
+      __m512 t0 = _mm512_add_ps( a0, a2 );
+      __m512 t1 = _mm512_sub_ps( a0, a2 );
+      __m512 t2 = _mm512_add_ps( a1, a3 );
+      __m512 t3 = _mm512_mul_ps( _mm512_permute_ps( _mm512_sub_ps( a1, a3 ), 0xb1 ), rot );
+      __m512 b1 = _mm512_add_ps( t1, t3 );
+      __m512 b2 = _mm512_sub_ps( t0, t2 );
+      __m512 b3 = _mm512_sub_ps( t1, t3 );
+      _mm512_storeu_ps( y + k, _mm512_add_ps( t0, t2 ) );
+      _mm512_storeu_ps( y + 2*ys + k, _mm512_fmaddsub_ps( b1, w1r, _mm512_mul_ps( _mm512_permute_ps( b1, 0xb1 ), w1i ) ) );
+      _mm512_storeu_ps( y + 4*ys + k, _mm512_fmaddsub_ps( b2, w2r, _mm512_mul_ps( _mm512_permute_ps( b2, 0xb1 ), w2i ) ) );
+      _mm512_storeu_ps( y + 6*ys + k, _mm512_fmaddsub_ps( b3, w3r, _mm512_mul_ps( _mm512_permute_ps( b3, 0xb1 ), w3i ) ) );
+   }
+   FFTRadix4AVX2( y + (n8 << 4), ys, x + (n8 << 4), xs, w, sign, n & 7 );
+}
+
+__PCL_TARGET_AVX512
+static void FFTRadix4AVX512( double* __restrict__ y, size_type ys, const double* __restrict__ x, size_type xs,
+                             const double* __restrict__ w, double sign, size_type n )
+{
+   const __m512d w1r = _mm512_set1_pd( w[0] ), w1i = _mm512_set1_pd( w[1] );
+   const __m512d w2r = _mm512_set1_pd( w[2] ), w2i = _mm512_set1_pd( w[3] );
+   const __m512d w3r = _mm512_set1_pd( w[4] ), w3i = _mm512_set1_pd( w[5] );
+   const __m512d rot = _mm512_mul_pd( _mm512_set1_pd( sign ), _mm512_setr_pd( -1, 1, -1, 1, -1, 1, -1, 1 ) );
+   const size_type n4 = n >> 2;
+   for ( size_type i = 0; i < n4; ++i )
+   {
+      const size_type k = i << 3;
+      __m512d a0 = _mm512_loadu_pd( x + k );
+      __m512d a1 = _mm512_loadu_pd( x + 2*xs + k );
+      __m512d a2 = _mm512_loadu_pd( x + 4*xs + k );
+      __m512d a3 = _mm512_loadu_pd( x + 6*xs + k );
+      __m512d t0 = _mm512_add_pd( a0, a2 );
+      __m512d t1 = _mm512_sub_pd( a0, a2 );
+      __m512d t2 = _mm512_add_pd( a1, a3 );
+      __m512d t3 = _mm512_mul_pd( _mm512_permute_pd( _mm512_sub_pd( a1, a3 ), 0x55 ), rot );
+      __m512d b1 = _mm512_add_pd( t1, t3 );
+      __m512d b2 = _mm512_sub_pd( t0, t2 );
+      __m512d b3 = _mm512_sub_pd( t1, t3 );
+      _mm512_storeu_pd( y + k, _mm512_add_pd( t0, t2 ) );
+      _mm512_storeu_pd( y + 2*ys + k, _mm512_fmaddsub_pd( b1, w1r, _mm512_mul_pd( _mm512_permute_pd( b1, 0x55 ), w1i ) ) );
+      _mm512_storeu_pd( y + 4*ys + k, _mm512_fmaddsub_pd( b2, w2r, _mm512_mul_pd( _mm512_permute_pd( b2, 0x55 ), w2i ) ) );
+      _mm512_storeu_pd( y + 6*ys + k, _mm512_fmaddsub_pd( b3, w3r, _mm512_mul_pd( _mm512_permute_pd( b3, 0x55 ), w3i ) ) );
+   }
+   FFTRadix4AVX2( y + (n4 << 3), ys, x + (n4 << 3), xs, w, sign, n & 3 );
+}
+
+__PCL_END_AVX512_IMPLEMENTATIONS
+
+#endif   // __PCL_SIMD_DISPATCH
+
+// ----------------------------------------------------------------------------
+// Self-test and benchmark functions
+// ----------------------------------------------------------------------------
+
+/*
+ * Test array lengths, covering all vector tail cases.
+ */
+static const size_type s_testLengths[] = { 1, 2, 3, 5, 7, 8, 9, 15, 16, 17, 31, 33, 63, 64, 65, 1000, 4099 };
+
+template <typename T>
+static GenericVector<T> TestData( size_type n, uint64 seed )
+{
+   XoShiRo256ss R( seed );
+   GenericVector<T> v( (int)n );
+   for ( T& x : v )
+      x = T( 2*R() - 1 );
+   return v;
+}
+
+/*
+ * Relative tolerance for floating point kernels whose implementations may
+ * differ by the order of accumulation and fused multiply-add rounding.
+ */
+template <typename T> static double Tolerance()
+{
+   return (sizeof( T ) > 4) ? 1.0e-12 : 1.0e-05;
+}
+
+template <typename T>
+static bool TestMinMax( T (*f)( const T*, size_type ), T (*g)( const T*, size_type ) )
+{
+   for ( size_type n : s_testLengths )
+   {
+      GenericVector<T> v = TestData<T>( n + 1, n );
+      // Also test unaligned data.
+      if ( f( v.Begin(), n ) != g( v.Begin(), n ) || f( v.Begin()+1, n ) != g( v.Begin()+1, n ) )
+         return false;
+   }
+   return true;
+}
+
+template <typename T>
+static void BenchmarkMinMax( T (*f)( const T*, size_type ), size_type n )
+{
+   static GenericVector<T> v;
+   if ( size_type( v.Length() ) != n )
+      v = TestData<T>( n, 1 );
+   volatile T x = f( v.Begin(), n );
+   (void)x;
+}
+
+template <typename T>
+static bool TestHistogram( void (*f)( size_type*, int, const T*, size_type, T, T ),
+                           void (*g)( size_type*, int, const T*, size_type, T, T ) )
+{
+   const int length = 1000;
+   for ( size_type n : s_testLengths )
+   {
+      // Include out-of-range values to test bin rejection.
+      GenericVector<T> v = TestData<T>( n, n );
+      v *= T( 1.25 );
+      GenericVector<size_type> H1( size_type( 0 ), length ), H2( size_type( 0 ), length );
+      f( H1.Begin(), length, v.Begin(), n, T( -1 ), T( length/2.0 ) );
+      g( H2.Begin(), length, v.Begin(), n, T( -1 ), T( length/2.0 ) );
+      if ( H1 != H2 )
+         return false;
+   }
+   return true;
+}
+
+template <typename T>
+static void BenchmarkHistogram( void (*f)( size_type*, int, const T*, size_type, T, T ), size_type n )
+{
+   static GenericVector<T> v;
+   static GenericVector<size_type> H( size_type( 0 ), 8192 );
+   if ( size_type( v.Length() ) != n )
+      v = TestData<T>( n, 1 );
+   f( H.Begin(), 8192, v.Begin(), n, T( -1 ), T( 4095.5 ) );
+}
+
+template <typename T>
+static bool TestAbsDevHistogram( void (*f)( size_type*, int, const T*, size_type, T, T, T ),
+                                 void (*g)( size_type*, int, const T*, size_type, T, T, T ) )
+{
+   const int length = 1000;
+   for ( size_type n : s_testLengths )
+   {
+      // Include out-of-range values to test bin rejection.
+      GenericVector<T> v = TestData<T>( n, n );
+      v *= T( 1.25 );
+      GenericVector<size_type> H1( size_type( 0 ), length ), H2( size_type( 0 ), length );
+      f( H1.Begin(), length, v.Begin(), n, T( 0.25 ), T( 0.125 ), T( length/1.5 ) );
+      g( H2.Begin(), length, v.Begin(), n, T( 0.25 ), T( 0.125 ), T( length/1.5 ) );
+      if ( H1 != H2 )
+         return false;
+   }
+   return true;
+}
+
+template <typename T>
+static void BenchmarkAbsDevHistogram( void (*f)( size_type*, int, const T*, size_type, T, T, T ), size_type n )
+{
+   static GenericVector<T> v;
+   static GenericVector<size_type> H( size_type( 0 ), 8192 );
+   if ( size_type( v.Length() ) != n )
+      v = TestData<T>( n, 1 );
+   f( H.Begin(), 8192, v.Begin(), n, T( 0 ), T( 0 ), T( 8191 ) );
+}
+
+template <typename T>
+static bool TestMultiplyComplex( void (*f)( T*, const T*, T, size_type ), void (*g)( T*, const T*, T, size_type ) )
+{
+   for ( size_type n : s_testLengths )
+   {
+      GenericVector<T> x = TestData<T>( 2*n + 1, n );
+      GenericVector<T> y = TestData<T>( 2*n + 1, n + 1 );
+      GenericVector<T> x1 = x, x2 = x;
+      f( x1.Begin()+1, y.Begin()+1, T( 0.75 ), n );
+      g( x2.Begin()+1, y.Begin()+1, T( 0.75 ), n );
+      for ( int i = 0; i < x.Length(); ++i )
+         if ( Abs( double( x1[i] ) - double( x2[i] ) ) > 4*Tolerance<T>() )
+            return false;
+   }
+   return true;
+}
+
+template <typename T>
+static void BenchmarkMultiplyComplex( void (*f)( T*, const T*, T, size_type ), size_type n )
+{
+   static GenericVector<T> x, y;
+   if ( size_type( x.Length() ) != 2*n )
+   {
+      // Unit-modulus factors prevent overflow and underflow in repeated calls.
+      x = TestData<T>( 2*n, 1 );
+      y = TestData<T>( 2*n, 2 );
+      for ( size_type i = 0; i < n; ++i )
+      {
+         T s, c;
+         SinCos( T( Const<T>::pi()*y[2*i] ), s, c );
+         y[2*i] = c;
+         y[2*i+1] = s;
+      }
+   }
+   f( x.Begin(), y.Begin(), T( 1 ), n );
+}
+
+template <typename T>
+static bool TestDotProduct( double (*f)( const T*, const T*, size_type ), double (*g)( const T*, const T*, size_type ) )
+{
+   for ( size_type n : s_testLengths )
+   {
+      GenericVector<T> x = TestData<T>( n + 1, n );
+      GenericVector<T> y = TestData<T>( n + 1, n + 1 );
+      // Errors are bounded relative to the sum of absolute products.
+      double s = 0;
+      for ( size_type i = 0; i <= n; ++i )
+         s += Abs( double( x[i] )*double( y[i] ) );
+      if ( Abs( f( x.Begin()+1, y.Begin(), n ) - g( x.Begin()+1, y.Begin(), n ) ) > Tolerance<T>()*s )
+         return false;
+   }
+   return true;
+}
+
+template <typename T>
+static void BenchmarkDotProduct( double (*f)( const T*, const T*, size_type ), size_type n )
+{
+   static GenericVector<T> x, y;
+   if ( size_type( x.Length() ) != n )
+   {
+      x = TestData<T>( n, 1 );
+      y = TestData<T>( n, 2 );
+   }
+   volatile double r = f( x.Begin(), y.Begin(), n );
+   (void)r;
+}
+
+/*
+ * Random indices into the x array, including repeated indices.
+ */
+static GenericVector<int> TestIndices( size_type n, size_type m, uint64 seed )
+{
+   XoShiRo256ss R( seed );
+   GenericVector<int> index( (int)n );
+   for ( int& i : index )
+      i = Min( int( R()*m ), int( m ) - 1 );
+   return index;
+}
+
+template <typename T>
+static bool TestIndexedDotProduct( double (*f)( const T*, const T*, const int*, size_type ),
+                                   double (*g)( const T*, const T*, const int*, size_type ) )
+{
+   for ( size_type n : s_testLengths )
+   {
+      GenericVector<T> x = TestData<T>( 2*n, n );
+      GenericVector<T> y = TestData<T>( n + 1, n + 1 );
+      GenericVector<int> index = TestIndices( n, 2*n, n );
+      double s = 0;
+      for ( size_type i = 0; i < n; ++i )
+         s += Abs( double( x[index[i]] )*double( y[i+1] ) );
+      if ( Abs( f( x.Begin(), y.Begin()+1, index.Begin(), n ) - g( x.Begin(), y.Begin()+1, index.Begin(), n ) ) > Tolerance<T>()*s )
+         return false;
+   }
+   return true;
+}
+
+template <typename T>
+static void BenchmarkIndexedDotProduct( double (*f)( const T*, const T*, const int*, size_type ), size_type n )
+{
+   static GenericVector<T> x, y;
+   static GenericVector<int> index;
+   if ( size_type( x.Length() ) != n )
+   {
+      x = TestData<T>( n, 1 );
+      y = TestData<T>( n, 2 );
+      index = TestIndices( n, n, 3 );
+   }
+   volatile double r = f( x.Begin(), y.Begin(), index.Begin(), n );
+   (void)r;
+}
+
+static bool TestChebyshevSeries( void (*f)( double*, const double*, size_type, const double*, int ),
+                                 void (*g)( double*, const double*, size_type, const double*, int ) )
+{
+   for ( int m : { 1, 2, 3, 8, 15, 32 } )
+   {
+      GenericVector<double> c = TestData<double>( m, m );
+      double s = 0;
+      for ( double ck : c )
+         s += Abs( ck );
+      for ( size_type n : s_testLengths )
+      {
+         GenericVector<double> y = TestData<double>( n + 1, n );
+         GenericVector<double> r1( 0.0, int( n ) ), r2( 0.0, int( n ) );
+         f( r1.Begin(), y.Begin()+1, n, c.Begin(), m );
+         g( r2.Begin(), y.Begin()+1, n, c.Begin(), m );
+         for ( size_type i = 0; i < n; ++i )
+            if ( Abs( r1[i] - r2[i] ) > m*Tolerance<double>()*s )
+               return false;
+      }
+   }
+   return true;
+}
+
+static void BenchmarkChebyshevSeries( void (*f)( double*, const double*, size_type, const double*, int ), size_type n )
+{
+   static GenericVector<double> y, r, c;
+   if ( size_type( y.Length() ) != n )
+   {
+      y = TestData<double>( n, 1 );
+      r = GenericVector<double>( 0.0, int( n ) );
+      c = TestData<double>( 16, 2 );
+   }
+   f( r.Begin(), y.Begin(), n, c.Begin(), c.Length() );
+}
+
+/*
+ * Radix-4 butterflies are tested with non-unit strides and unit-modulus
+ * twiddle factors. Radix-2 kernels use the first twiddle factor only.
+ */
+template <typename T>
+static bool TestFFTRadix( void (*f)( T*, size_type, const T*, size_type, const T*, T, size_type ),
+                          void (*g)( T*, size_type, const T*, size_type, const T*, T, size_type ) )
+{
+   GenericVector<T> w = TestData<T>( 6, 3 );
+   for ( int j = 0; j < 3; ++j )
+   {
+      T s, c;
+      SinCos( T( Const<T>::pi()*w[2*j] ), s, c );
+      w[2*j] = c;
+      w[2*j+1] = s;
+   }
+   for ( size_type n : s_testLengths )
+   {
+      size_type xs = n + 3, ys = n + 1;
+      GenericVector<T> x = TestData<T>( 8*xs, n );
+      for ( T sign : { T( -1 ), T( +1 ) } )
+      {
+         GenericVector<T> y1( T( 0 ), int( 8*ys ) ), y2( T( 0 ), int( 8*ys ) );
+         f( y1.Begin(), ys, x.Begin(), xs, w.Begin(), sign, n );
+         g( y2.Begin(), ys, x.Begin(), xs, w.Begin(), sign, n );
+         for ( int i = 0; i < y1.Length(); ++i )
+            if ( Abs( double( y1[i] ) - double( y2[i] ) ) > 16*Tolerance<T>() )
+               return false;
+      }
+   }
+   return true;
+}
+
+template <typename T>
+static void BenchmarkFFTRadix( void (*f)( T*, size_type, const T*, size_type, const T*, T, size_type ), size_type n )
+{
+   static GenericVector<T> x, y, w;
+   if ( size_type( x.Length() ) != 8*n )
+   {
+      x = TestData<T>( 8*n, 1 );
+      y = GenericVector<T>( T( 0 ), int( 8*n ) );
+      w = GenericVector<T>( T( 0.6 ), 6 );
+   }
+   f( y.Begin(), n, x.Begin(), n, w.Begin(), T( -1 ), n );
+}
+
+// ----------------------------------------------------------------------------
+// Built-in kernels
+// ----------------------------------------------------------------------------
+
+#ifdef __PCL_SIMD_DISPATCH
+#  define __PCL_SIMD_IMPLEMENTATIONS( type, name )                  \
+   static_cast<type>( name##Generic ), static_cast<type>( name##SSE4 ), \
+   static_cast<type>( name##AVX2 ), static_cast<type>( name##AVX512 )
+#  define __PCL_SIMD_AVX_IMPLEMENTATIONS( type, name )              \
+   static_cast<type>( name##Generic ), nullptr,                     \
+   static_cast<type>( name##AVX2 ), static_cast<type>( name##AVX512 )
+#else
+#  define __PCL_SIMD_IMPLEMENTATIONS( type, name )                  \
+   static_cast<type>( name##Generic ), nullptr, nullptr, nullptr
+#  define __PCL_SIMD_AVX_IMPLEMENTATIONS( type, name )              \
+   static_cast<type>( name##Generic ), nullptr, nullptr, nullptr
+#endif
+
+using min_max_f = float (*)( const float*, size_type );
+using min_max_d = double (*)( const double*, size_type );
+using histogram_f = void (*)( size_type*, int, const float*, size_type, float, float );
+using histogram_d = void (*)( size_type*, int, const double*, size_type, double, double );
+using abs_dev_histogram_f = void (*)( size_type*, int, const float*, size_type, float, float, float );
+using abs_dev_histogram_d = void (*)( size_type*, int, const double*, size_type, double, double, double );
+using complex_mul_f = void (*)( float*, const float*, float, size_type );
+using complex_mul_d = void (*)( double*, const double*, double, size_type );
+using dot_product_f = double (*)( const float*, const float*, size_type );
+using dot_product_d = double (*)( const double*, const double*, size_type );
+using indexed_dot_product_f = double (*)( const float*, const float*, const int*, size_type );
+using indexed_dot_product_d = double (*)( const double*, const double*, const int*, size_type );
+using chebyshev_series_d = void (*)( double*, const double*, size_type, const double*, int );
+using fft_radix_f = void (*)( float*, size_type, const float*, size_type, const float*, float, size_type );
+using fft_radix_d = void (*)( double*, size_type, const double*, size_type, const double*, double, size_type );
+
+/*
+ * Built-in kernels are constructed on first use to prevent static
+ * initialization order problems with other translation units.
+ */
+#define __PCL_SIMD_KERNEL( accessor, id, type, name, test, benchmark )  \
+   static SIMDKernel<type>& accessor()                                  \
+   {                                                                    \
+      static SIMDKernel<type> kernel( id, __PCL_SIMD_IMPLEMENTATIONS( type, name ), test, benchmark ); \
+      return kernel;                                                    \
+   }
+
+/*
+ * Kernels without SSE4 implementations.
+ */
+#define __PCL_SIMD_AVX_KERNEL( accessor, id, type, name, test, benchmark )  \
+   static SIMDKernel<type>& accessor()                                      \
+   {                                                                        \
+      static SIMDKernel<type> kernel( id, __PCL_SIMD_AVX_IMPLEMENTATIONS( type, name ), test, benchmark ); \
+      return kernel;                                                        \
+   }
+
+__PCL_SIMD_KERNEL( MinFloat,               "MinFloat",               min_max_f,     Min,             TestMinMax,          BenchmarkMinMax )
+__PCL_SIMD_KERNEL( MinDouble,              "MinDouble",              min_max_d,     Min,             TestMinMax,          BenchmarkMinMax )
+__PCL_SIMD_KERNEL( MaxFloat,               "MaxFloat",               min_max_f,     Max,             TestMinMax,          BenchmarkMinMax )
+__PCL_SIMD_KERNEL( MaxDouble,              "MaxDouble",              min_max_d,     Max,             TestMinMax,          BenchmarkMinMax )
+__PCL_SIMD_KERNEL( HistogramFloat,         "HistogramFloat",         histogram_f,   Histogram,       TestHistogram,       BenchmarkHistogram )
+__PCL_SIMD_KERNEL( HistogramDouble,        "HistogramDouble",        histogram_d,   Histogram,       TestHistogram,       BenchmarkHistogram )
+__PCL_SIMD_KERNEL( AbsDevHistogramFloat,   "AbsDevHistogramFloat",   abs_dev_histogram_f, AbsDevHistogram, TestAbsDevHistogram, BenchmarkAbsDevHistogram )
+__PCL_SIMD_KERNEL( AbsDevHistogramDouble,  "AbsDevHistogramDouble",  abs_dev_histogram_d, AbsDevHistogram, TestAbsDevHistogram, BenchmarkAbsDevHistogram )
+__PCL_SIMD_KERNEL( MultiplyComplexFloat,   "MultiplyComplexFloat",   complex_mul_f, MultiplyComplex, TestMultiplyComplex, BenchmarkMultiplyComplex )
+__PCL_SIMD_KERNEL( MultiplyComplexDouble,  "MultiplyComplexDouble",  complex_mul_d, MultiplyComplex, TestMultiplyComplex, BenchmarkMultiplyComplex )
+__PCL_SIMD_KERNEL( DotProductFloat,        "DotProductFloat",        dot_product_f, DotProduct,      TestDotProduct,      BenchmarkDotProduct )
+__PCL_SIMD_KERNEL( DotProductDouble,       "DotProductDouble",       dot_product_d, DotProduct,      TestDotProduct,      BenchmarkDotProduct )
+__PCL_SIMD_AVX_KERNEL( IndexedDotProductFloat,  "IndexedDotProductFloat",  indexed_dot_product_f, IndexedDotProduct, TestIndexedDotProduct, BenchmarkIndexedDotProduct )
+__PCL_SIMD_AVX_KERNEL( IndexedDotProductDouble, "IndexedDotProductDouble", indexed_dot_product_d, IndexedDotProduct, TestIndexedDotProduct, BenchmarkIndexedDotProduct )
+__PCL_SIMD_KERNEL( ChebyshevSeriesDouble,  "ChebyshevSeriesDouble",  chebyshev_series_d, ChebyshevSeries, TestChebyshevSeries, BenchmarkChebyshevSeries )
+__PCL_SIMD_KERNEL( FFTRadix2Float,         "FFTRadix2Float",         fft_radix_f,   FFTRadix2,       TestFFTRadix,        BenchmarkFFTRadix )
+__PCL_SIMD_KERNEL( FFTRadix2Double,        "FFTRadix2Double",        fft_radix_d,   FFTRadix2,       TestFFTRadix,        BenchmarkFFTRadix )
+__PCL_SIMD_KERNEL( FFTRadix4Float,         "FFTRadix4Float",         fft_radix_f,   FFTRadix4,       TestFFTRadix,        BenchmarkFFTRadix )
+__PCL_SIMD_KERNEL( FFTRadix4Double,        "FFTRadix4Double",        fft_radix_d,   FFTRadix4,       TestFFTRadix,        BenchmarkFFTRadix )
+
+#undef __PCL_SIMD_KERNEL
+#undef __PCL_SIMD_AVX_KERNEL
+#undef __PCL_SIMD_IMPLEMENTATIONS
+#undef __PCL_SIMD_AVX_IMPLEMENTATIONS
+
+// Defined in RGBColorSystem.cpp
+void InitializeRGBColorSystemKernels();
+
+static void InitializeBuiltInKernels()
+{
+   MinFloat();
+   MinDouble();
+   MaxFloat();
+   MaxDouble();
+   HistogramFloat();
+   HistogramDouble();
+   AbsDevHistogramFloat();
+   AbsDevHistogramDouble();
+   MultiplyComplexFloat();
+   MultiplyComplexDouble();
+   DotProductFloat();
+   DotProductDouble();
+   IndexedDotProductFloat();
+   IndexedDotProductDouble();
+   ChebyshevSeriesDouble();
+   FFTRadix2Float();
+   FFTRadix2Double();
+   FFTRadix4Float();
+   FFTRadix4Double();
+   InitializeRGBColorSystemKernels();
+}
+
+// ----------------------------------------------------------------------------
+
+namespace SIMD
+{
+   float Min( const float* f, size_type n )
+   {
+      return MinFloat()( f, n );
+   }
+
+   double Min( const double* f, size_type n )
+   {
+      return MinDouble()( f, n );
+   }
+
+   float Max( const float* f, size_type n )
+   {
+      return MaxFloat()( f, n );
+   }
+
+   double Max( const double* f, size_type n )
+   {
+      return MaxDouble()( f, n );
+   }
+
+   void Histogram( size_type* H, int length, const float* f, size_type n, float low, float scale )
+   {
+      HistogramFloat()( H, length, f, n, low, scale );
+   }
+
+   void Histogram( size_type* H, int length, const double* f, size_type n, double low, double scale )
+   {
+      HistogramDouble()( H, length, f, n, low, scale );
+   }
+
+   void AbsDevHistogram( size_type* H, int length, const float* f, size_type n, float center, float low, float scale )
+   {
+      AbsDevHistogramFloat()( H, length, f, n, center, low, scale );
+   }
+
+   void AbsDevHistogram( size_type* H, int length, const double* f, size_type n, double center, double low, double scale )
+   {
+      AbsDevHistogramDouble()( H, length, f, n, center, low, scale );
+   }
+
+   void MultiplyComplex( fcomplex* x, const fcomplex* y, float k, size_type n )
+   {
+      MultiplyComplexFloat()( reinterpret_cast<float*>( x ), reinterpret_cast<const float*>( y ), k, n );
+   }
+
+   void MultiplyComplex( dcomplex* x, const dcomplex* y, double k, size_type n )
+   {
+      MultiplyComplexDouble()( reinterpret_cast<double*>( x ), reinterpret_cast<const double*>( y ), k, n );
+   }
+
+   double DotProduct( const float* x, const float* y, size_type n )
+   {
+      return DotProductFloat()( x, y, n );
+   }
+
+   double DotProduct( const double* x, const double* y, size_type n )
+   {
+      return DotProductDouble()( x, y, n );
+   }
+
+   double IndexedDotProduct( const float* x, const float* y, const int* index, size_type n )
+   {
+      return IndexedDotProductFloat()( x, y, index, n );
+   }
+
+   double IndexedDotProduct( const double* x, const double* y, const int* index, size_type n )
+   {
+      return IndexedDotProductDouble()( x, y, index, n );
+   }
+
+   void ChebyshevSeries( double* r, const double* y, size_type n, const double* c, int m )
+   {
+      ChebyshevSeriesDouble()( r, y, n, c, m );
+   }
+
+   void FFTRadix2( fcomplex* y, size_type ys, const fcomplex* x, size_type xs, const fcomplex* w, int sign, size_type n )
+   {
+      FFTRadix2Float()( reinterpret_cast<float*>( y ), ys, reinterpret_cast<const float*>( x ), xs,
+                        reinterpret_cast<const float*>( w ), float( sign ), n );
+   }
+
+   void FFTRadix2( dcomplex* y, size_type ys, const dcomplex* x, size_type xs, const dcomplex* w, int sign, size_type n )
+   {
+      FFTRadix2Double()( reinterpret_cast<double*>( y ), ys, reinterpret_cast<const double*>( x ), xs,
+                         reinterpret_cast<const double*>( w ), double( sign ), n );
+   }
+
+   void FFTRadix4( fcomplex* y, size_type ys, const fcomplex* x, size_type xs, const fcomplex* w, int sign, size_type n )
+   {
+      FFTRadix4Float()( reinterpret_cast<float*>( y ), ys, reinterpret_cast<const float*>( x ), xs,
+                        reinterpret_cast<const float*>( w ), float( sign ), n );
+   }
+
+   void FFTRadix4( dcomplex* y, size_type ys, const dcomplex* x, size_type xs, const dcomplex* w, int sign, size_type n )
+   {
+      FFTRadix4Double()( reinterpret_cast<double*>( y ), ys, reinterpret_cast<const double*>( x ), xs,
+                         reinterpret_cast<const double*>( w ), double( sign ), n );
+   }
+} // SIMD
+
+// ----------------------------------------------------------------------------
+
+} // pcl
+
+// ----------------------------------------------------------------------------
+// EOF pcl/SIMDDispatch.cpp - Released 2024-12-28T16:53:56Z
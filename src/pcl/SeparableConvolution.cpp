@@ -49,6 +49,7 @@
 // POSSIBILITY OF SUCH DAMAGE.
 // ----------------------------------------------------------------------------
 
+#include <pcl/SIMDDispatch.h>
 #include <pcl/SeparableConvolution.h>
 #include <pcl/Thread.h>
 
@@ -137,106 +138,30 @@ double __pcl_dp_i( const T* __restrict__ x, const T* __restrict__ y, const int*
    return r;
 }
 
-#ifdef __PCL_AVX2
-
 inline static
 double __pcl_dp( const float* __restrict__ x, const float* __restrict__ y, int n )
 {
-   const int n8 = n >> 3;
-   __m256 d = _mm256_setzero_ps();
-   for ( int i = 0; i < n8; ++i )
-      d = _mm256_fmadd_ps( _mm256_loadu_ps( x + i*8 ), _mm256_loadu_ps( y + i*8 ), d );
-   float r = __pcl_hsum256_ps( d );
-   for ( int i = n8 << 3; i < n; ++i )
-      r += x[i] * y[i];
-   return r;
+   return SIMD::DotProduct( x, y, size_type( n ) );
 }
 
-/*
 inline static
-double __pcl_dp( const float* __restrict__ x, const float* __restrict__ y, int n )
+double __pcl_dp( const double* __restrict__ x, const double* __restrict__ y, int n )
 {
-   const int n8 = n >> 3;
-   __m256d d = _mm256_setzero_pd();
-   for ( int i = 0; i < n8; ++i )
-   {
-      // Accumulate all sums in double precision to avoid roundoff errors.
-      __m256 p = _mm256_mul_ps( ((const __m256* __restrict__)x)[i],
-                                ((const __m256* __restrict__)y)[i] );
-      d = _mm256_add_pd( d, _mm256_add_pd( _mm256_cvtps_pd( ((const __m128* __restrict__)&p)[0] ),
-                                           _mm256_cvtps_pd( ((const __m128* __restrict__)&p)[1] ) ) );
-   }
-   double r = __pcl_hsum256_pd( d );
-   for ( int i = n8 << 3; i < n; ++i )
-      r += x[i] * y[i];
-   return r;
+   return SIMD::DotProduct( x, y, size_type( n ) );
 }
-*/
 
 inline static
 double __pcl_dp_i( const float* __restrict__ x, const float* __restrict__ y, const int* __restrict__ index, int n )
 {
-   const int n8 = n >> 3;
-   __m256 d = _mm256_setzero_ps();
-   for ( int i = 0; i < n8; ++i )
-      d = _mm256_fmadd_ps( _mm256_i32gather_ps( x, ((const __m256i* __restrict__)index)[i], 4 ),
-                           _mm256_loadu_ps( y + i*8 ),
-                           d );
-   float r = __pcl_hsum256_ps( d );
-   for ( int i = n8 << 3; i < n; ++i )
-      r += x[index[i]] * y[i];
-   return r;
-}
-
-// inline static
-// double __pcl_dp_i( const float* __restrict__ x, const float* __restrict__ y, const int* __restrict__ index, int n )
-// {
-//    const int n8 = n >> 3;
-//    __m256d d = _mm256_setzero_pd();
-//    for ( int i = 0; i < n8; ++i )
-//    {
-//       // Accumulate all sums in double precision to avoid roundoff errors.
-//       __m256 p = _mm256_mul_ps( _mm256_i32gather_ps( x, ((const __m256i* __restrict__)index)[i], 4 ),
-//                                 ((const __m256* __restrict__)y)[i] );
-//       d = _mm256_add_pd( d, _mm256_add_pd( _mm256_cvtps_pd( ((const __m128* __restrict__)&p)[0] ),
-//                                            _mm256_cvtps_pd( ((const __m128* __restrict__)&p)[1] ) ) );
-//    }
-//    double r = __pcl_hsum256_pd( d );
-//    for ( int i = n8 << 3; i < n; ++i )
-//       r += x[index[i]] * y[i];
-//    return r;
-// }
-
-inline static
-double __pcl_dp( const double* __restrict__ x, const double* __restrict__ y, int n )
-{
-   const int n4 = n >> 2;
-   __m256d d = _mm256_setzero_pd();
-   for ( int i = 0; i < n4; ++i )
-      d = _mm256_fmadd_pd( _mm256_loadu_pd( x + i*4 ), _mm256_loadu_pd( y + i*4 ), d );
-   double r = __pcl_hsum256_pd( d );
-   for ( int i = n4 << 2; i < n; ++i )
-      r += x[i] * y[i];
-   return r;
+   return SIMD::IndexedDotProduct( x, y, index, size_type( n ) );
 }
 
 inline static
 double __pcl_dp_i( const double* __restrict__ x, const double* __restrict__ y, const int* __restrict__ index, int n )
 {
-   const int n4 = n >> 2;
-   __m256d d = _mm256_setzero_pd();
-   for ( int i = 0; i < n4; ++i )
-      d = _mm256_fmadd_pd( _mm256_i32gather_pd( x, ((const __m128i* __restrict__)index)[i], 8 ),
-                           _mm256_loadu_pd( y + i*4 ),
-                           d );
-   double r = __pcl_hsum256_pd( d );
-   for ( int i = n4 << 2; i < n; ++i )
-      r += x[index[i]] * y[i];
-   return r;
+   return SIMD::IndexedDotProduct( x, y, index, size_type( n ) );
 }
 
-#endif
-
 // ----------------------------------------------------------------------------
 
 class PCL_SeparableConvolutionEngine
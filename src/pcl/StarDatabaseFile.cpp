@@ -49,7 +49,9 @@
 // POSSIBILITY OF SUCH DAMAGE.
 // ----------------------------------------------------------------------------
 
+#include <pcl/AutoLock.h>
 #include <pcl/Console.h>
+#include <pcl/IndirectSortedArray.h>
 #include <pcl/StarDatabaseFile.h>
 #include <pcl/Version.h>
 #include <pcl/XML.h>
@@ -88,6 +90,267 @@ struct XPSDFileSignature
 
 // ----------------------------------------------------------------------------
 
+/*
+ * Process-wide cache of uncompressed leaf node data blocks, shared by all
+ * StarDatabaseFile instances. Blocks are identified by a file identifier and
+ * their offsets in the file. File identifiers are associated with the full
+ * path, size and last modification time of each file, so cached blocks
+ * remain valid after a file is closed, and can be reused when the same file
+ * is opened again by any instance. When the cache is full, least recently
+ * used blocks are discarded.
+ *
+ * Cached items are sorted by file identifier and block offset for fast
+ * lookup, and linked in a doubly linked list by order of use, so both cache
+ * hits and evictions take constant time.
+ */
+class XPSDBlockCache
+{
+public:
+
+   XPSDBlockCache() = default;
+
+   ~XPSDBlockCache()
+   {
+      m_items.Destroy();
+   }
+
+   /*
+    * Returns the identifier of the specified file. If the file has been
+    * modified since it was last identified, the blocks cached for its
+    * previous contents are discarded and a new identifier is returned.
+    */
+   uint64 FileId( const String& path, fsize_type size, const FileTime& lastModified )
+   {
+      volatile AutoLock lock( m_mutex );
+      for ( FileKey& file : m_files )
+         if ( file.path == path )
+         {
+            if ( file.size != size || !(file.lastModified == lastModified) )
+            {
+               PurgeItems( file.id );
+               file.size = size;
+               file.lastModified = lastModified;
+               file.id = ++m_lastFileId;
+            }
+            return file.id;
+         }
+      m_files << FileKey{ path, size, lastModified, ++m_lastFileId };
+      return m_lastFileId;
+   }
+
+   bool Get( ByteArray& block, uint64 fileId, uint64 offset )
+   {
+      volatile AutoLock lock( m_mutex );
+      IndirectSortedArray<Item>::const_iterator i = m_items.Search( Item( fileId, offset ) );
+      if ( i == m_items.End() )
+         return false;
+      Unlink( *i );
+      Link( *i );
+      block = (*i)->data;
+      return true;
+   }
+
+   void Put( const ByteArray& block, uint64 fileId, uint64 offset )
+   {
+      volatile AutoLock lock( m_mutex );
+      if ( block.Size() > m_capacity )
+         return;
+      Item item( fileId, offset );
+      if ( m_items.Contains( item ) ) // possibly loaded by a concurrent search
+         return;
+      Item* newItem = new Item( fileId, offset );
+      newItem->data = block;
+      m_items.Add( newItem );
+      Link( newItem );
+      m_size += block.Size();
+      Trim();
+   }
+
+   void Clear()
+   {
+      volatile AutoLock lock( m_mutex );
+      m_items.Destroy();
+      m_mru = m_lru = nullptr;
+      m_size = 0;
+   }
+
+   size_type Capacity()
+   {
+      volatile AutoLock lock( m_mutex );
+      return m_capacity;
+   }
+
+   void SetCapacity( size_type capacity )
+   {
+      volatile AutoLock lock( m_mutex );
+      m_capacity = capacity;
+      Trim();
+   }
+
+   size_type Size()
+   {
+      volatile AutoLock lock( m_mutex );
+      return m_size;
+   }
+
+private:
+
+   struct Item
+   {
+      uint64    fileId;
+      uint64    offset;
+      ByteArray data;
+      Item*     prev = nullptr; // more recently used item
+      Item*     next = nullptr; // less recently used item
+
+      Item( uint64 a_fileId, uint64 a_offset )
+         : fileId( a_fileId )
+         , offset( a_offset )
+      {
+      }
+
+      bool operator ==( const Item& x ) const
+      {
+         return fileId == x.fileId && offset == x.offset;
+      }
+
+      bool operator <( const Item& x ) const
+      {
+         return (fileId != x.fileId) ? fileId < x.fileId : offset < x.offset;
+      }
+   };
+
+   struct FileKey
+   {
+      String     path;
+      fsize_type size;
+      FileTime   lastModified;
+      uint64     id;
+   };
+
+   Mutex                     m_mutex;
+   Array<FileKey>            m_files;
+   IndirectSortedArray<Item> m_items;
+   Item*                     m_mru = nullptr; // most recently used item
+   Item*                     m_lru = nullptr; // least recently used item
+   size_type                 m_capacity = 256*1024*1024;
+   size_type                 m_size = 0;
+   uint64                    m_lastFileId = 0;
+
+   /*
+    * Releases all cached blocks of the specified file. The caller must hold
+    * the cache mutex.
+    */
+   void PurgeItems( uint64 fileId )
+   {
+      // Items are sorted by file identifier, then by block offset.
+      IndirectSortedArray<Item>::const_iterator i = m_items.Begin();
+      while ( i != m_items.End() && (*i)->fileId < fileId )
+         ++i;
+      IndirectSortedArray<Item>::const_iterator j = i;
+      for ( ; j != m_items.End() && (*j)->fileId == fileId; ++j )
+      {
+         m_size -= (*j)->data.Size();
+         Unlink( *j );
+         delete *j;
+      }
+      m_items.Remove( i, j );
+   }
+
+   /*
+    * Inserts an item at the most recently used end of the list.
+    */
+   void Link( Item* item )
+   {
+      item->prev = nullptr;
+      item->next = m_mru;
+      if ( m_mru != nullptr )
+         m_mru->prev = item;
+      else
+         m_lru = item;
+      m_mru = item;
+   }
+
+   /*
+    * Removes an item from the list.
+    */
+   void Unlink( Item* item )
+   {
+      if ( item->prev != nullptr )
+         item->prev->next = item->next;
+      else
+         m_mru = item->next;
+      if ( item->next != nullptr )
+         item->next->prev = item->prev;
+      else
+         m_lru = item->prev;
+      item->prev = item->next = nullptr;
+   }
+
+   void Trim()
+   {
+      while ( m_size > m_capacity && m_lru != nullptr )
+      {
+         Item* item = m_lru;
+         Unlink( item );
+         m_size -= item->data.Size();
+         m_items.Remove( m_items.Search( *item ) );
+         delete item;
+      }
+   }
+};
+
+static XPSDBlockCache s_blockCache;
+
+// ----------------------------------------------------------------------------
+
+size_type StarDatabaseFile::BlockCacheCapacity()
+{
+   return s_blockCache.Capacity();
+}
+
+// ----------------------------------------------------------------------------
+
+void StarDatabaseFile::SetBlockCacheCapacity( size_type capacity )
+{
+   s_blockCache.SetCapacity( capacity );
+}
+
+// ----------------------------------------------------------------------------
+
+size_type StarDatabaseFile::BlockCacheSize()
+{
+   return s_blockCache.Size();
+}
+
+// ----------------------------------------------------------------------------
+
+void StarDatabaseFile::ClearBlockCache()
+{
+   s_blockCache.Clear();
+}
+
+// ----------------------------------------------------------------------------
+
+ByteArray StarDatabaseFile::GetLeafData( const XPSD::IndexNode& node, void* searchData ) const
+{
+   ByteArray block;
+   if ( s_blockCache.Get( block, m_fileId, node.BlockOffset() ) )
+   {
+      ++reinterpret_cast<SearchDataBase*>( searchData )->countCacheHits;
+      return block;
+   }
+
+   block = ByteArray( size_type( node.CompressedBlockSize() ) );
+   LoadData( block.Begin(), node.BlockOffset(), node.CompressedBlockSize(), searchData );
+   if ( node.CompressedBlockSize() != node.BlockSize() )
+      Uncompress( block, node.BlockSize(), searchData );
+   s_blockCache.Put( block, m_fileId, node.BlockOffset() );
+   return block;
+}
+
+// ----------------------------------------------------------------------------
+
 static void WarnOnUnexpectedChildNode( const XMLNode& node, const String& parsingWhatElement )
 {
    if ( !node.IsComment() )
@@ -112,6 +375,10 @@ void StarDatabaseFile::Open( const String& filePath )
    Close();
 
    m_file.OpenForReading( filePath );
+   {
+      FileInfo info( filePath );
+      m_fileId = s_blockCache.FileId( File::FullPath( filePath ), info.Size(), info.LastModified() );
+   }
 
    XMLDocument xml;
    size_type minPos;
@@ -54,6 +54,7 @@
 #include <pcl/Console.h>
 #include <pcl/Convolution.h>
 #include <pcl/GaussianFilter.h>
+#include <pcl/MeasurementContext.h>
 #include <pcl/MetaModule.h>
 #include <pcl/MorphologicalTransformation.h>
 #include <pcl/MuteStatus.h>
@@ -183,25 +184,20 @@ static void GetStructureMap( Image& map, int structureLayers, int noiseLayers, i
    else
    {
       // A "natural" image - binarize at 3*noise_stdDev
-      static const float B3[] =
-      {
-         0.003906F, 0.015625F, 0.023438F, 0.015625F, 0.003906F,
-         0.015625F, 0.062500F, 0.093750F, 0.062500F, 0.015625F,
-         0.023438F, 0.093750F, 0.140625F, 0.093750F, 0.023438F,
-         0.015625F, 0.062500F, 0.093750F, 0.062500F, 0.015625F,
-         0.003906F, 0.015625F, 0.023438F, 0.015625F, 0.003906F
-      };
       static const float B3v[] = { 0.0625F, 0.25F, 0.375F, 0.25F, 0.0625F };
       static const float B3k[] = { 0.8907F, 0.2007F, 0.0856F };
 
-      ATrousWaveletTransform::WaveletScalingFunction H;
-      if ( SeparableConvolution::FasterThanNonseparableFilterSize( Thread::NumberOfThreads( PCL_MAX_PROCESSORS ) ) > 5 )
-         H.Set( KernelFilter( B3, 5 ) );
-      else
-         H.Set( SeparableFilter( B3v, B3v, 5 ) );
-      ATrousWaveletTransform W( H, 2 );
-      W << map; // 2*N
-      float noise = W.NoiseKSigma( 1/*j*/, 3/*k*/, 0.01F/*eps*/, 10/*nit*/ )/B3k[1];
+      /*
+       * Only the second wavelet layer is required, so we compute its noise
+       * estimate with a streaming decomposition without storing any layer.
+       * The streaming engine requires a separable scaling function, so the
+       * B3 spline is always applied as a separable filter, even on machines
+       * where a nonseparable 5x5 convolution would be faster. The 5x5 B3
+       * kernel is the outer product of B3v, so the estimate changes only by
+       * the rounding of the kernel coefficients.
+       */
+      ATrousWaveletTransform W( SeparableFilter( B3v, B3v, 5 ), 2 );
+      float noise = W.StreamingNoiseKSigma( ImageVariant( &map ), 1/*j*/, 3/*k*/, 0.01F/*eps*/, 10/*nit*/ )/B3k[1];
       map.Binarize( median + 3*noise ); // N
    }
 
@@ -440,7 +436,7 @@ public:
    StarDetector::star_list stars;
 
    PCL_SD_PSFFitThread( const AbstractImage::ThreadData& data,
-                        Image& image, psf_function psfType, bool circular, float tolerance,
+                        const Image& image, psf_function psfType, bool circular, float tolerance,
                         const Array<PSFFitData>& psfData, int start, int end )
       : m_data( data )
       , m_image( image )
@@ -473,7 +469,7 @@ public:
             rect.InflateBy( 1, 1 );
          }
 
-         PSFFit fit( ImageVariant( &m_image ), d.pos + 0.5, rect, m_psfType, m_circular );
+         PSFFit fit( ImageVariant( const_cast<Image*>( &m_image ) ), d.pos + 0.5, rect, m_psfType, m_circular );
          if ( fit )
             if ( DRect( rect ).DeflatedBy( rect.Width()*0.15 ).Includes( fit.psf.c0 ) )
                if ( fit.psf.c0.DistanceTo( d.pos + 0.5 ) < m_tolerance )
@@ -488,7 +484,7 @@ public:
 private:
 
    const AbstractImage::ThreadData& m_data;
-         Image&                     m_image;
+   const Image&                     m_image;
          psf_function               m_psfType;
          bool                       m_circular;
          float                      m_tolerance;
@@ -496,25 +492,21 @@ private:
          int                        m_start, m_end;
 };
 
-StarDetector::star_list StarDetector::DetectStars( Image& image ) const
+static void PreprocessImage( Image& image, bool invert, int noiseReductionFilterRadius, int hotPixelFilterRadius )
 {
-   if ( image.IsEmpty() )
-      return star_list();
-
    /*
     * If the invert flag is set, then we are looking for dark structures on a
     * bright background.
     */
-   if ( m_invert )
+   if ( invert )
       image.Invert();
 
-   bool initializeStatus = image.Status().IsInitializationEnabled();
-
    /*
     * Optional noise reduction
     */
-   if ( m_noiseReductionFilterRadius > 0 )
+   if ( noiseReductionFilterRadius > 0 )
    {
+      bool initializeStatus = image.Status().IsInitializationEnabled();
       if ( initializeStatus )
       {
          image.Status().Initialize( "Noise reduction", 2*image.NumberOfPixels() );
@@ -523,9 +515,9 @@ StarDetector::star_list StarDetector::DetectStars( Image& image ) const
 
       // If noise reduction is enabled, remove hot pixels first - Otherwise
       // they would be "promoted to stars".
-      HotPixelFilter( image, m_hotPixelFilterRadius ); // N
+      HotPixelFilter( image, hotPixelFilterRadius ); // N
 
-      GaussianFilter G( (m_noiseReductionFilterRadius << 1)|1 );
+      GaussianFilter G( (noiseReductionFilterRadius << 1)|1 );
       if ( G.Size() < SeparableConvolution::FasterThanNonseparableFilterSize( Thread::NumberOfThreads( PCL_MAX_PROCESSORS ) ) )
          Convolution( G ) >> image;  // N
       else
@@ -534,6 +526,49 @@ StarDetector::star_list StarDetector::DetectStars( Image& image ) const
       if ( initializeStatus )
          image.Status().EnableInitialization();
    }
+}
+
+// ----------------------------------------------------------------------------
+
+/*
+ * Working image for star detection: the intensity component of the image, or
+ * its selected channel if the image is not completely selected.
+ */
+static void GetDetectionImage( Image& I, const ImageVariant& image )
+{
+   {
+      volatile AutoStatusCallbackRestorer saveStatus( image.Status() );
+      bool initializeStatus = image.Status().IsInitializationEnabled();
+      MuteStatus status;
+      image.SetStatusCallback( &status );
+      image.Status().DisableInitialization();
+
+      ImageVariant V( &I );
+      if ( image.NumberOfSelectedChannels() == image.NumberOfNominalChannels() )
+         image.GetIntensity( V );
+      else
+      {
+         image.PushSelections();
+         image.SelectChannel( image.SelectedChannel() );
+         V.AssignImage( image );
+         image.PopSelections();
+      }
+
+      if ( initializeStatus )
+         image.Status().EnableInitialization();
+   }
+
+   I.Status() = image.Status();
+}
+
+// ----------------------------------------------------------------------------
+
+StarDetector::star_list StarDetector::DetectStars( Image& image ) const
+{
+   if ( image.IsEmpty() )
+      return star_list();
+
+   PreprocessImage( image, m_invert, m_noiseReductionFilterRadius, m_hotPixelFilterRadius );
 
    /*
     * Structure map
@@ -552,6 +587,15 @@ StarDetector::star_list StarDetector::DetectStars( Image& image ) const
       GetLocalMaximaMap( lmMap, m_localDetectionFilterRadius, m_localMaximaDetectionLimit );
    }
 
+   return ExtractStars( image, map, lmMap );
+}
+
+// ----------------------------------------------------------------------------
+
+StarDetector::star_list StarDetector::ExtractStars( const Image& image, Image& map, const Image& lmMap ) const
+{
+   bool initializeStatus = image.Status().IsInitializationEnabled();
+
    if ( initializeStatus )
    {
       image.Status().Initialize( "Detecting stars", size_type( image.Width()-1 )*size_type( image.Height()-1 ) );
@@ -828,30 +872,105 @@ StarDetector::star_list StarDetector::DetectStars( Image& image ) const
 StarDetector::star_list StarDetector::DetectStars( const ImageVariant& image ) const
 {
    Image I;
+   GetDetectionImage( I, image );
+   return DetectStars( I );
+}
+
+// ----------------------------------------------------------------------------
+
+StarDetector::star_list StarDetector::DetectStars( const ImageVariant& image, MeasurementContext& context ) const
+{
+   context.Bind( image );
+
+   /*
+    * Cache keys. The working image depends on the current pixel selection;
+    * preprocessed images, structure maps and local maxima maps depend on a
+    * few preprocessing parameters; star lists depend on all detection
+    * parameters.
+    */
+   Rect r = image.SelectedRectangle();
+   IsoString sourceKey = IsoString().Format( "StarDetector:%d,%d,%d,%d:%d,%d",
+                                 r.x0, r.y0, r.x1, r.y1, image.FirstSelectedChannel(), image.LastSelectedChannel() );
+   int hotPixelFilterRadius = (m_noiseReductionFilterRadius > 0) ? m_hotPixelFilterRadius : 0;
+   IsoString preprocessingKey = sourceKey + IsoString().Format( ":P%d,%d,%d",
+                                 int( m_invert ), m_noiseReductionFilterRadius, hotPixelFilterRadius );
+   IsoString detectionKey = preprocessingKey + IsoString().Format( ":D%d,%d,%d,%d,%d,%.8g,%.8g,%.8g,%.8g,%.8g,%d,%d,%.8g,%.8g,%p,%d,%d,%d,%.8g",
+                                 m_structureLayers, m_noiseLayers, m_hotPixelFilterRadius,
+                                 m_minStructureSize, int( m_allowClusteredSources ),
+                                 m_sensitivity, m_peakResponse, m_minSNR, m_brightThreshold, m_maxDistortion,
+                                 m_localDetectionFilterRadius, int( m_noLocalMaximaDetection ), m_localMaximaDetectionLimit,
+                                 m_upperLimit, static_cast<const void*>( m_mask ),
+                                 int( m_fitPSF ), int( m_psfType ), int( m_psfElliptic ), m_psfCentroidTolerance );
+
+   context.m_detectionKey = detectionKey;
+
+   if ( const MeasurementContext::StarListItem* item = context.FindStars( detectionKey ) )
    {
-      volatile AutoStatusCallbackRestorer saveStatus( image.Status() );
-      bool initializeStatus = image.Status().IsInitializationEnabled();
-      MuteStatus status;
-      image.SetStatusCallback( &status );
-      image.Status().DisableInitialization();
+      m_minStarSize = item->minStarSize;
+      return item->stars;
+   }
 
-      ImageVariant V( &I );
-      if ( image.NumberOfSelectedChannels() == image.NumberOfNominalChannels() )
-         image.GetIntensity( V );
-      else
+   Image* source = context.FindImage( sourceKey );
+   if ( source == nullptr )
+   {
+      source = &context.AddImage( sourceKey );
+      GetDetectionImage( *source, image );
+   }
+   if ( source->IsEmpty() )
+      return star_list();
+
+   Image* working = source;
+   if ( m_invert || m_noiseReductionFilterRadius > 0 )
+   {
+      working = context.FindImage( preprocessingKey );
+      if ( working == nullptr )
       {
-         image.PushSelections();
-         image.SelectChannel( image.SelectedChannel() );
-         V.AssignImage( image );
-         image.PopSelections();
+         working = &context.AddImage( preprocessingKey );
+         *working = *source;
+         PreprocessImage( *working, m_invert, m_noiseReductionFilterRadius, m_hotPixelFilterRadius );
       }
+   }
+   working->Status() = image.Status();
 
-      if ( initializeStatus )
-         image.Status().EnableInitialization();
+   /*
+    * Structure map. The cached map is copied on write by ExtractStars().
+    */
+   IsoString mapKey = preprocessingKey + IsoString().Format( ":S%d,%d,%d",
+                                 m_structureLayers, m_noiseLayers,
+                                 (m_noiseReductionFilterRadius <= 0) ? m_hotPixelFilterRadius : 0 );
+   Image* cachedMap = context.FindImage( mapKey );
+   if ( cachedMap == nullptr )
+   {
+      cachedMap = &context.AddImage( mapKey );
+      *cachedMap = *working;
+      cachedMap->Status() = working->Status();
+      GetStructureMap( *cachedMap, m_structureLayers, m_noiseLayers,
+                       (m_noiseReductionFilterRadius <= 0) ? m_hotPixelFilterRadius : 0 );
    }
+   Image map( *cachedMap );
 
-   I.Status() = image.Status();
-   return DetectStars( I );
+   /*
+    * Local maxima map
+    */
+   Image* lmMap = nullptr;
+   Image noMap;
+   if ( !m_noLocalMaximaDetection )
+   {
+      IsoString lmMapKey = preprocessingKey + IsoString().Format( ":L%d,%.8g",
+                                 m_localDetectionFilterRadius, m_localMaximaDetectionLimit );
+      lmMap = context.FindImage( lmMapKey );
+      if ( lmMap == nullptr )
+      {
+         lmMap = &context.AddImage( lmMapKey );
+         *lmMap = *working;
+         lmMap->Status() = working->Status();
+         GetLocalMaximaMap( *lmMap, m_localDetectionFilterRadius, m_localMaximaDetectionLimit );
+      }
+   }
+
+   star_list S = ExtractStars( *working, map, (lmMap != nullptr) ? *lmMap : noMap );
+   context.AddStars( detectionKey, S, m_minStarSize );
+   return S;
 }
 
 // ----------------------------------------------------------------------------
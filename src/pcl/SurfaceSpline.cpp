@@ -50,6 +50,7 @@
 // ----------------------------------------------------------------------------
 
 #include <pcl/MetaModule.h>
+#include <pcl/ReferenceArray.h>
 #include <pcl/SurfaceSpline.h>
 
 #include <pcl/api/APIInterface.h>
@@ -691,6 +692,273 @@ void GenerateSpline( T* __restrict__ cv,
    Solve( *A, nm, *pvt, cv );
 }
 
+// ----------------------------------------------------------------------------
+
+/*
+ * Vectorized evaluation of surface splines with PCL-implemented RBFs.
+ *
+ * Evaluation points are processed in blocks of normalized coordinates. For
+ * each interpolation node, the inner loops iterate over the points of the
+ * current block, so they have no loop-carried dependencies and can be
+ * vectorized by the compiler, including calls to transcendental functions.
+ *
+ * For r = 0 the polyharmonic RBFs are evaluated with a tiny positive offset
+ * added to r^2 instead of a conditional branch. This yields a zero
+ * contribution at r = 0 and is an identity for any other representable r^2
+ * value in normalized coordinates.
+ */
+static constexpr int    s_evaluationBlockSize = 64;
+static constexpr double s_evaluationR2Offset  = 1.0e-300;
+
+template <typename T>
+class PCL_SurfaceSplineEvaluator
+{
+public:
+
+   PCL_SurfaceSplineEvaluator( SurfaceSplineBase::rbf_type rbf, double e2, bool polynomial, int order,
+                               const T* xn, const T* yn, const T* spline, int nodes,
+                               double x0, double y0, double r0 )
+      : m_rbf( rbf )
+      , m_e2( e2 )
+      , m_polynomial( polynomial )
+      , m_order( order )
+      , m_xn( xn )
+      , m_yn( yn )
+      , m_spline( spline )
+      , m_nodes( nodes )
+      , m_x0( x0 )
+      , m_y0( y0 )
+      , m_r0( r0 )
+   {
+   }
+
+   void operator()( T* __restrict__ z, const T* __restrict__ x, const T* __restrict__ y, size_type n ) const
+   {
+      for ( size_type i = 0; i < n; i += s_evaluationBlockSize )
+      {
+         int nb = int( Min( size_type( s_evaluationBlockSize ), n - i ) );
+         EvaluateBlock( z + i, x + i, y + i, nb );
+      }
+   }
+
+private:
+
+   SurfaceSplineBase::rbf_type m_rbf;
+   double                      m_e2;
+   bool                        m_polynomial;
+   int                         m_order;
+   const T* __restrict__       m_xn;
+   const T* __restrict__       m_yn;
+   const T* __restrict__       m_spline;
+   int                         m_nodes;
+   double                      m_x0, m_y0, m_r0;
+
+   PCL_HOT_FUNCTION
+   void EvaluateBlock( T* __restrict__ z, const T* __restrict__ x, const T* __restrict__ y, int n ) const
+   {
+      double px[ s_evaluationBlockSize ];
+      double py[ s_evaluationBlockSize ];
+      double pz[ s_evaluationBlockSize ];
+      double r2[ s_evaluationBlockSize ];
+      double f[ s_evaluationBlockSize ];
+
+      PCL_IVDEP
+      for ( int k = 0; k < n; ++k )
+      {
+         px[k] = m_r0*(x[k] - m_x0);
+         py[k] = m_r0*(y[k] - m_y0);
+         pz[k] = 0;
+      }
+
+      /*
+       * Polynomial part.
+       */
+      if ( m_polynomial )
+      {
+         const T* __restrict__ c = m_spline + m_nodes;
+         switch ( m_order )
+         {
+         case 2:
+            PCL_IVDEP
+            for ( int k = 0; k < n; ++k )
+               pz[k] = c[0] + c[1]*px[k] + c[2]*py[k];
+            break;
+         case 3:
+            PCL_IVDEP
+            for ( int k = 0; k < n; ++k )
+               pz[k] = c[0] + (c[1] + c[3]*px[k] + c[4]*py[k])*px[k] + (c[2] + c[5]*py[k])*py[k];
+            break;
+         default:
+            for ( int k = 0; k < n; ++k )
+            {
+               double s = c[0];
+               for ( int i = 1, i1 = (m_order*(m_order + 1))>>1, ix = 0, iy = 0; i < i1; ++i )
+                  if ( ix == 0 )
+                  {
+                     ix = iy + 1;
+                     iy = 0;
+                     s += c[i] * PowI( px[k], ix );
+                  }
+                  else
+                  {
+                     --ix;
+                     ++iy;
+                     s += c[i] * PowI( px[k], ix ) * PowI( py[k], iy );
+                  }
+               pz[k] = s;
+            }
+            break;
+         }
+      }
+
+      /*
+       * Radial basis functions.
+       */
+      for ( int i = 0; i < m_nodes; ++i )
+      {
+         const double c = m_spline[i];
+         const double xi = m_xn[i];
+         const double yi = m_yn[i];
+
+         PCL_IVDEP
+         for ( int k = 0; k < n; ++k )
+         {
+            double dx = xi - px[k];
+            double dy = yi - py[k];
+            r2[k] = dx*dx + dy*dy;
+         }
+
+         switch ( m_rbf )
+         {
+         case RadialBasisFunction::VariableOrder:
+            PCL_IVDEP
+            for ( int k = 0; k < n; ++k )
+            {
+               r2[k] += s_evaluationR2Offset;
+               f[k] = r2[k] * pcl::Ln( r2[k] );
+            }
+            for ( int j = m_order; --j > 1; )
+               PCL_IVDEP
+               for ( int k = 0; k < n; ++k )
+                  f[k] *= r2[k];
+            PCL_IVDEP
+            for ( int k = 0; k < n; ++k )
+               pz[k] += c * f[k];
+            break;
+         case RadialBasisFunction::ThinPlateSpline:
+            PCL_IVDEP
+            for ( int k = 0; k < n; ++k )
+            {
+               double s = r2[k] + s_evaluationR2Offset;
+               pz[k] += c * 0.5*s * pcl::Ln( s );
+            }
+            break;
+         case RadialBasisFunction::Gaussian:
+            PCL_IVDEP
+            for ( int k = 0; k < n; ++k )
+               pz[k] += c * pcl::Exp( -m_e2 * r2[k] );
+            break;
+         case RadialBasisFunction::Multiquadric:
+            PCL_IVDEP
+            for ( int k = 0; k < n; ++k )
+               pz[k] += c * pcl::Sqrt( 1 + m_e2 * r2[k] );
+            break;
+         case RadialBasisFunction::InverseMultiquadric:
+            PCL_IVDEP
+            for ( int k = 0; k < n; ++k )
+               pz[k] += c / pcl::Sqrt( 1 + m_e2 * r2[k] );
+            break;
+         case RadialBasisFunction::InverseQuadratic:
+            PCL_IVDEP
+            for ( int k = 0; k < n; ++k )
+               pz[k] += c / (1 + m_e2 * r2[k]);
+            break;
+         default:
+            break;
+         }
+      }
+
+      PCL_IVDEP
+      for ( int k = 0; k < n; ++k )
+         z[k] = T( pz[k] );
+   }
+};
+
+// ----------------------------------------------------------------------------
+
+template <typename T>
+class PCL_SurfaceSplineEvaluationThread : public Thread
+{
+public:
+
+   PCL_SurfaceSplineEvaluationThread( const PCL_SurfaceSplineEvaluator<T>& E,
+                                      T* z, const T* x, const T* y, size_type n )
+      : m_E( E )
+      , m_z( z )
+      , m_x( x )
+      , m_y( y )
+      , m_n( n )
+   {
+   }
+
+   void Run() override
+   {
+      m_E( m_z, m_x, m_y, m_n );
+   }
+
+private:
+
+   const PCL_SurfaceSplineEvaluator<T>& m_E;
+         T*                             m_z;
+   const T*                             m_x;
+   const T*                             m_y;
+         size_type                      m_n;
+};
+
+// ----------------------------------------------------------------------------
+
+template <typename T> static
+void EvaluateSpline( T* __restrict__ z, const T* __restrict__ x, const T* __restrict__ y, size_type n,
+                     double x0, double y0, double r0,
+                     SurfaceSplineBase::rbf_type rbf, double e2, bool polynomial, int order,
+                     const T* __restrict__ xn, const T* __restrict__ yn, const T* __restrict__ spline, int nodes,
+                     bool parallel, int maxProcessors )
+{
+   if ( n == 0 )
+      return;
+
+   PCL_SurfaceSplineEvaluator<T> E( rbf, e2, polynomial, order, xn, yn, spline, nodes, x0, y0, r0 );
+
+   /*
+    * Evaluation is split across threads only when called from the root
+    * thread, to prevent oversubscription when the caller is already running
+    * in parallel, as GridInterpolation does. Without the core application
+    * the evaluation runs in the calling thread.
+    */
+   Array<size_type> L;
+   if ( parallel )
+      if ( API != nullptr )
+         if ( Thread::IsRootThread() )
+            L = Thread::OptimalThreadLoadsAligned( n, s_evaluationBlockSize,
+                                    Max( size_type( s_evaluationBlockSize ), size_type( (1 << 20)/(nodes + 1) ) ),
+                                    maxProcessors );
+   if ( L.Length() < 2 )
+   {
+      E( z, x, y, n );
+      return;
+   }
+
+   ReferenceArray<PCL_SurfaceSplineEvaluationThread<T>> threads;
+   for ( size_type i = 0, k = 0; i < L.Length(); k += L[i++] )
+      threads.Add( new PCL_SurfaceSplineEvaluationThread<T>( E, z + k, x + k, y + k, L[i] ) );
+   int i = 0;
+   for ( auto& thread : threads )
+      thread.Start( ThreadPriority::DefaultMax, i++ );
+   for ( auto& thread : threads )
+      thread.Wait();
+   threads.Destroy();
+}
+
 // ----------------------------------------------------------------------------
 // ----------------------------------------------------------------------------
 
@@ -748,6 +1016,28 @@ void SurfaceSplineBase::EvaluateHandle( const void* handle, double* z, const dou
 
 // ----------------------------------------------------------------------------
 
+void SurfaceSplineBase::EvaluateVector( float* __restrict__ z, const float* __restrict__ x, const float* __restrict__ y, size_type n,
+                                        double x0, double y0, double r0,
+                                        rbf_type rbf, double e2, bool polynomial, int order,
+                                        const float* __restrict__ xn, const float* __restrict__ yn,
+                                        const float* __restrict__ spline, int nodes,
+                                        bool parallel, int maxProcessors )
+{
+   EvaluateSpline( z, x, y, n, x0, y0, r0, rbf, e2, polynomial, order, xn, yn, spline, nodes, parallel, maxProcessors );
+}
+
+void SurfaceSplineBase::EvaluateVector( double* __restrict__ z, const double* __restrict__ x, const double* __restrict__ y, size_type n,
+                                        double x0, double y0, double r0,
+                                        rbf_type rbf, double e2, bool polynomial, int order,
+                                        const double* __restrict__ xn, const double* __restrict__ yn,
+                                        const double* __restrict__ spline, int nodes,
+                                        bool parallel, int maxProcessors )
+{
+   EvaluateSpline( z, x, y, n, x0, y0, r0, rbf, e2, polynomial, order, xn, yn, spline, nodes, parallel, maxProcessors );
+}
+
+// ----------------------------------------------------------------------------
+
 void SurfaceSplineBase::SerializeHandle( IsoString& data, const void* handle )
 {
    if ( handle != 0 )
@@ -84,6 +84,7 @@ const bool XISF::DefaultIgnoreProperties = false;
 const bool XISF::DefaultAutoMetadata = true;
 const bool XISF::DefaultNoWarnings = false;
 const bool XISF::DefaultWarningsAreErrors = false;
+const bool XISF::DefaultSpoolImageData = false;
 const char* XISF::InternalNamespacePrefix = "XISF:";
 
 #endif
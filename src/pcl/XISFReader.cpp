@@ -286,30 +286,6 @@ struct XISFInputDataBlock
       VerifyChecksum( f );
    }
 
-   void LoadCompressedData( File& file )
-   {
-      if ( IsEmpty() || !IsCompressed() )
-         throw Error( String( "XISFInputDataBlock::LoadCompressedData(): " ) + "Internal error: Invalid function call." );
-
-      VerifyChecksum( file );
-
-      if ( !HasCompressedData() )
-      {
-         file.SetPosition( position );
-         for ( const SubblockDimensions& info : subblockInfo )
-         {
-            Compression::Subblock subblock;
-            subblock.compressedData = ByteArray( size_type( info.compressedSize ) );
-            subblock.uncompressedSize = info.uncompressedSize;
-            file.Read( subblock.compressedData.Begin(), info.compressedSize );
-            subblocks << subblock;
-         }
-
-         if ( subblocks.IsEmpty() )
-            throw Error( String( "XISFInputDataBlock::LoadCompressedData(): " ) + "Internal error: Invalid or corrupted compressed subblock data." );
-      }
-   }
-
    void Uncompress( File& file )
    {
       if ( IsEmpty() || !IsCompressed() )
@@ -318,9 +294,43 @@ struct XISFInputDataBlock
       if ( !HasData() )
       {
          AutoPointer<Compression> compressor( XISF::NewCompression( compressionCodec, compressedItemSize ) );
-         LoadCompressedData( file );
-         data = compressor->Uncompress( subblocks );
-         subblocks.Clear();
+         if ( HasCompressedData() )
+         {
+            data = compressor->Uncompress( subblocks );
+            subblocks.Clear();
+         }
+         else
+         {
+            /*
+             * Read all compressed subblocks with a single file read operation
+             * and uncompress them in place.
+             */
+            VerifyChecksum( file );
+
+            Compression::subblock_ref_list refs;
+            size_type compressedSize = 0;
+            for ( const SubblockDimensions& info : subblockInfo )
+               compressedSize += info.compressedSize;
+            ByteArray compressedData( compressedSize );
+            file.SetPosition( position );
+            file.Read( compressedData.Begin(), compressedSize );
+            size_type offset = 0;
+            for ( const SubblockDimensions& info : subblockInfo )
+            {
+               Compression::SubblockRef ref;
+               ref.compressedData = compressedData.At( offset );
+               ref.compressedSize = info.compressedSize;
+               ref.uncompressedSize = info.uncompressedSize;
+               refs << ref;
+               offset += info.compressedSize;
+            }
+
+            if ( refs.IsEmpty() )
+               throw Error( String( "XISFInputDataBlock::Uncompress(): " ) + "Internal error: Invalid or corrupted compressed subblock data." );
+
+            data = ByteArray( DataSize() );
+            (void)compressor->Uncompress( data.Begin(), data.Length(), refs );
+         }
       }
 
       ApplyByteOrder();
@@ -74,6 +74,8 @@ struct XISFOutputBlock
    int               itemSize          = 1;
    subblock_list     subblocks;
    ByteArray         data;
+   String            spoolPath;        // uncompressed data stored in a temporary file
+   size_type         spoolSize         = 0;
    block_checksum    checksumAlgorithm = XISFChecksum::None;
    ByteArray         checksum;
 
@@ -108,6 +110,11 @@ struct XISFOutputBlock
       return !data.IsEmpty();
    }
 
+   bool IsSpooled() const
+   {
+      return !spoolPath.IsEmpty();
+   }
+
    bool HasCompressedData() const
    {
       return !subblocks.IsEmpty();
@@ -120,6 +127,9 @@ struct XISFOutputBlock
 
    size_type BlockSize() const
    {
+      if ( IsSpooled() )
+         return spoolSize;
+
       if ( HasData() )
          return data.Length();
 
@@ -136,6 +146,9 @@ struct XISFOutputBlock
 
    String EncodedData() const
    {
+      if ( IsSpooled() )
+         return IsoString::ToBase64( File::ReadFile( spoolPath ) );
+
       if ( HasData() )
          return IsoString::ToBase64( data );
 
@@ -210,7 +223,21 @@ struct XISFOutputBlock
    {
       AutoPointer<CryptographicHash> hash( XISF::NewCryptographicHash( checksumAlgorithm = method ) );
 
-      if ( HasData() )
+      if ( IsSpooled() )
+      {
+         hash->Initialize();
+         File file = File::OpenFileForReading( spoolPath );
+         ByteArray buffer( Min( spoolSize, SpoolChunkSize ) );
+         for ( size_type remaining = spoolSize; remaining > 0; )
+         {
+            size_type n = Min( remaining, buffer.Length() );
+            file.Read( buffer.Begin(), fsize_type( n ) );
+            hash->Update( buffer.Begin(), n );
+            remaining -= n;
+         }
+         checksum = hash->Finalize();
+      }
+      else if ( HasData() )
       {
          checksum = hash->Hash( data );
       }
@@ -234,7 +261,19 @@ struct XISFOutputBlock
 
    void WriteData( File& file ) const
    {
-      if ( HasData() )
+      if ( IsSpooled() )
+      {
+         File spool = File::OpenFileForReading( spoolPath );
+         ByteArray buffer( Min( spoolSize, SpoolChunkSize ) );
+         for ( size_type remaining = spoolSize; remaining > 0; )
+         {
+            size_type n = Min( remaining, buffer.Length() );
+            spool.Read( buffer.Begin(), fsize_type( n ) );
+            file.Write( reinterpret_cast<const void*>( buffer.Begin() ), fsize_type( n ) );
+            remaining -= n;
+         }
+      }
+      else if ( HasData() )
          file.Write( reinterpret_cast<const void*>( data.Begin() ), fsize_type( data.Length() ) );
       else if ( HasCompressedData() )
          for ( const Compression::Subblock& subblock : subblocks )
@@ -248,6 +287,11 @@ struct XISFOutputBlock
 
 private:
 
+   /*
+    * Size of the buffer used to copy spooled data.
+    */
+   static constexpr size_type SpoolChunkSize = size_type( 4 ) << 20;
+
    /*
     * Create a unique token for second-pass generation of an attachment
     * attribute:
@@ -306,7 +350,11 @@ class XISFWriterEngine
 public:
 
    XISFWriterEngine() = default;
-   virtual ~XISFWriterEngine() = default;
+
+   virtual ~XISFWriterEngine()
+   {
+      RemoveSpoolFiles();
+   }
 
    /*
     * Set format-specific options.
@@ -729,7 +777,7 @@ public:
          return;
       }
 
-      m_randomData.Clear();
+      ClearRandomAccessData();
 
       if ( m_xisfOptions.verbosity > 0 )
          LogLn( "Writing image" + (m_id.IsEmpty() ? String() : String( " '" + m_id + '\'' )) +
@@ -784,10 +832,27 @@ public:
       CloseImage();
 
       m_info = info;
-      m_randomData = ByteArray( size_type( m_info.width )
-                                         * m_info.height
-                                         * m_info.numberOfChannels
-                                         * (m_options.bitsPerSample >> 3), uint8( 0 ) );
+      size_type blockSize = BlockSampleSize( m_info.height ) * m_info.numberOfChannels;
+
+      /*
+       * If requested, uncompressed image data that cannot be embedded in the
+       * XML header are written to a temporary spool file, which is copied to
+       * the output file in Close(). This keeps memory usage bounded for
+       * incremental writes of large images.
+       */
+      bool spool = m_xisfOptions.spoolImageData
+                && m_xisfOptions.compressionCodec == XISFCompression::None
+                && blockSize > m_xisfOptions.maxInlineBlockSize;
+      if ( spool )
+      {
+         m_spoolPath = File::UniqueFileName( File::ExtractDrive( m_path ) + File::ExtractDirectory( m_path ),
+                                             12, File::ExtractName( m_path ) + '~', ".xisf-spool" );
+         m_spoolFile.Create( m_spoolPath );
+         m_spoolFiles << m_spoolPath;
+         m_spoolFile.Resize( fsize_type( blockSize ) );
+      }
+      else
+         m_randomData = ByteArray( blockSize, uint8( 0 ) );
    }
 
    /*
@@ -796,7 +861,7 @@ public:
    template <typename T, class P>
    void WriteSamples( const T* buffer, int startRow, int rowCount, int channel, P* )
    {
-      if ( !m_randomData.IsEmpty() ) // CreateImage() should have been called before this
+      if ( HasRandomAccessData() ) // CreateImage() should have been called before this
          if ( rowCount > 0 )
             if ( m_options.complexSample )
                switch ( m_options.bitsPerSample )
@@ -825,7 +890,7 @@ public:
     */
    void CloseImage()
    {
-      if ( !m_randomData.IsEmpty() ) // CreateImage() should have been called before this
+      if ( HasRandomAccessData() ) // CreateImage() should have been called before this
       {
          if ( m_xisfOptions.verbosity > 0 )
             LogLn( "Writing image" + (m_id.IsEmpty() ? String() : String( " '" + m_id + '\'' )) +
@@ -836,7 +901,10 @@ public:
 
          XMLElement* element = NewElement( m_root, "Image" );
          WriteImageAttributes( element );
-         NewBlock( element, m_randomData, m_options.bitsPerSample >> 3, false/*canInline*/ );
+         if ( m_spoolFile.IsOpen() )
+            NewSpooledBlock( element );
+         else
+            NewBlock( element, m_randomData, m_options.bitsPerSample >> 3, false/*canInline*/ );
          WriteImageElements( element );
          ResetImage();
       }
@@ -873,6 +941,10 @@ private:
    UInt8Image              m_thumbnail;       // thumbnail image
    XISFOutputPropertyArray m_imageProperties; // image properties
    ByteArray               m_randomData;      // sequential/random access image data
+   File                    m_spoolFile;       // sequential/random access image data, spooled
+   String                  m_spoolPath;
+   ByteArray               m_spoolBuffer;     // sample conversion buffer for spooled data
+   StringList              m_spoolFiles;      // spool files to be removed
 
    /*
     * Reset the state of the engine and destroy all internal data structures.
@@ -885,6 +957,7 @@ private:
       m_blocks.Clear();
       m_lastKeywords.Clear();
       ResetImage();
+      RemoveSpoolFiles();
    }
 
    /*
@@ -901,7 +974,41 @@ private:
       m_iccProfile.Clear();
       m_thumbnail.FreeData();
       m_imageProperties.Clear();
+      ClearRandomAccessData();
+   }
+
+   bool HasRandomAccessData() const
+   {
+      return !m_randomData.IsEmpty() || m_spoolFile.IsOpen();
+   }
+
+   void ClearRandomAccessData()
+   {
       m_randomData.Clear();
+      if ( m_spoolFile.IsOpen() )
+         m_spoolFile.Close();
+      m_spoolPath.Clear();
+      m_spoolBuffer.Clear();
+   }
+
+   /*
+    * Remove all temporary spool files. Spooled blocks are no longer valid
+    * after calling this function.
+    */
+   void RemoveSpoolFiles() noexcept
+   {
+      try
+      {
+         if ( m_spoolFile.IsOpen() )
+            m_spoolFile.Close();
+         for ( const String& path : m_spoolFiles )
+            if ( File::Exists( path ) )
+               File::Remove( path );
+      }
+      catch ( ... )
+      {
+      }
+      m_spoolFiles.Clear();
    }
 
    /*
@@ -1115,6 +1222,25 @@ private:
                                     reinterpret_cast<const uint8*>( blockData ) + blockSize ), itemSize, canInline );
    }
 
+   /*
+    * Generate a new attached block for the current spooled sequential/random
+    * access image data. Spooled data are never compressed.
+    */
+   void NewSpooledBlock( XMLElement* element )
+   {
+      XISFOutputBlock block;
+      block.spoolPath = m_spoolPath;
+      block.spoolSize = size_type( m_spoolFile.Size() );
+      m_spoolFile.Close();
+
+      if ( m_xisfOptions.checksumAlgorithm != XISFChecksum::None )
+         block.ComputeChecksum( m_xisfOptions.checksumAlgorithm );
+
+      WriteBlockChecksumAttributes( element, block );
+      element->SetAttribute( "location", block.attachmentPos + ':' + String( block.spoolSize ) );
+      m_blocks << block;
+   }
+
    /*
     * Generate a new image block.
     *
@@ -1403,11 +1529,17 @@ private:
    template <class I, class P>
    void WriteSamples( const typename I::sample* buffer, int startRow, int rowCount, int channel, I*, P* )
    {
-      typename P::sample* p = reinterpret_cast<typename P::sample*>( m_randomData.At( BlockSampleOffset( startRow, channel ) ) );
+      if ( m_spoolFile.IsOpen() )
+         if ( m_spoolBuffer.Length() < BlockSampleSize( rowCount ) )
+            m_spoolBuffer = ByteArray( BlockSampleSize( rowCount ) );
+      typename P::sample* p = reinterpret_cast<typename P::sample*>(
+            m_spoolFile.IsOpen() ? m_spoolBuffer.Begin() : m_randomData.At( BlockSampleOffset( startRow, channel ) ) );
       size_type n = BlockSampleCount( rowCount );
       XISF::EnsurePTLUTInitialized();
       for ( size_type i = 0; i < n; ++i, ++p, ++buffer )
          *p = P::ToSample( *buffer );
+      if ( m_spoolFile.IsOpen() )
+         WriteSpoolData( m_spoolBuffer.Begin(), startRow, rowCount, channel );
    }
 
    /*
@@ -1416,7 +1548,20 @@ private:
    template <class P>
    void WriteSamples( const typename P::sample* buffer, int startRow, int rowCount, int channel, P*, P* )
    {
-      ::memcpy( m_randomData.At( BlockSampleOffset( startRow, channel ) ), buffer, BlockSampleSize( rowCount ) );
+      if ( m_spoolFile.IsOpen() )
+         WriteSpoolData( buffer, startRow, rowCount, channel );
+      else
+         ::memcpy( m_randomData.At( BlockSampleOffset( startRow, channel ) ), buffer, BlockSampleSize( rowCount ) );
+   }
+
+   /*
+    * Write a block of rowCount contiguous pixel sample rows in the output
+    * sample data type to the current spool file.
+    */
+   void WriteSpoolData( const void* data, int startRow, int rowCount, int channel )
+   {
+      m_spoolFile.SetPosition( fpos_type( BlockSampleOffset( startRow, channel ) ) );
+      m_spoolFile.Write( data, fsize_type( BlockSampleSize( rowCount ) ) );
    }
 
    /*
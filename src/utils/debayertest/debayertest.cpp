@@ -0,0 +1,710 @@
+//     ____   ______ __
+//    / __ \ / ____// /
+//   / /_/ // /    / /
+//  / ____// /___ / /___   PixInsight Class Library
+// /_/     \____//_____/   PCL 2.8.5
+// ----------------------------------------------------------------------------
+//
+// This file is part of the Debayer kernel test utility.
+//
+// Copyright (c) 2024 Pleiades Astrophoto S.L.
+//
+// Redistribution and use in both source and binary forms, with or without
+// modification, is permitted provided that the following conditions are met:
+//
+// 1. All redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//
+// 2. All redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//
+// 3. Neither the names "PixInsight" and "Pleiades Astrophoto", nor the names
+//    of their contributors, may be used to endorse or promote products derived
+//    from this software without specific prior written permission. For written
+//    permission, please contact info@pixinsight.com.
+//
+// 4. All products derived from this software, in any form whatsoever, must
+//    reproduce the following acknowledgment in the end-user documentation
+//    and/or other materials provided with the product:
+//
+//    "This product is based on software from the PixInsight project, developed
+//    by Pleiades Astrophoto and its contributors (http://pixinsight.com/)."
+//
+//    Alternatively, if that is where third-party acknowledgments normally
+//    appear, this acknowledgment must be reproduced in the product itself.
+//
+// THIS SOFTWARE IS PROVIDED BY PLEIADES ASTROPHOTO AND ITS CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED
+// TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+// PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL PLEIADES ASTROPHOTO OR ITS
+// CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, BUSINESS
+// INTERRUPTION; PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; AND LOSS OF USE,
+// DATA OR PROFITS) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+// ----------------------------------------------------------------------------
+
+
+/*
+ * A command line utility to test the row-wise demosaicing kernels of the
+ * Debayer module.
+ *
+ * The SuperPixel, bilinear and VNG kernels defined in DebayerKernels.h are
+ * compared with the original per-pixel scalar implementations on random CFA
+ * images of all supported sample data types, for all Bayer patterns,
+ * grayscale and RGB CFA images, and even and odd image dimensions. Both
+ * implementations must agree within the rounding error of the 32-bit
+ * floating point output images.
+ *
+ * This program is built separately from the Debayer module and must be run
+ * after any change to the demosaicing kernels.
+ *
+ * Usage: debayertest (no arguments)
+ */
+
+#include "../../modules/processes/contrib/spool/Debayer/DebayerKernels.h"
+
+#include <pcl/ErrorHandler.h>
+#include <pcl/Random.h>
+
+#include <iostream>
+
+using namespace pcl;
+
+// ----------------------------------------------------------------------------
+
+#define PROGRAM_NAME    "debayertest"
+#define PROGRAM_VERSION "1.0"
+#define PROGRAM_YEAR    "2024"
+
+// ----------------------------------------------------------------------------
+
+/*
+ * Reference implementations: the original per-pixel scalar SuperPixel,
+ * bilinear and VNG algorithms. Border rows and columns are replicated in the
+ * same way as in the Debayer module.
+ */
+class ReferenceKernels
+{
+public:
+
+#define SRC_CHANNEL(c) (source.IsColor() ? c : 0)
+
+   template <class P>
+   static void SuperPixel( Image& output, const GenericImage<P>& source, pcl_enum bayerPattern )
+   {
+      int target_w = source.Width() >> 1;
+      int target_h = source.Height() >> 1;
+
+      output.AllocateData( target_w, target_h, 3, ColorSpace::RGB );
+
+      for ( int row = 0; row < target_h; row++ )
+         for ( int col = 0; col < target_w; col++ )
+         {
+            int red_col, red_row, green_col1, green_col2, green_row1, green_row2, blue_row, blue_col;
+            int col2 = col << 1;
+            int row2 = row << 1;
+            switch( bayerPattern )
+            {
+            default:
+            case DebayerBayerPatternParameter::RGGB:
+               red_col    = col2;
+               red_row    = row2;
+               green_col1 = col2 + 1;
+               green_row1 = row2;
+               green_col2 = col2;
+               green_row2 = row2 + 1;
+               blue_col   = col2 + 1;
+               blue_row   = row2 + 1;
+               break;
+            case DebayerBayerPatternParameter::BGGR:
+               red_col    = col2 + 1;
+               red_row    = row2 + 1;
+               green_col1 = col2 + 1;
+               green_row1 = row2;
+               green_col2 = col2;
+               green_row2 = row2 + 1;
+               blue_col   = col2;
+               blue_row   = row2;
+               break;
+            case DebayerBayerPatternParameter::GBRG:
+               red_col    = col2;
+               red_row    = row2 + 1;
+               green_col1 = col2;
+               green_row1 = row2;
+               green_col2 = col2 + 1;
+               green_row2 = row2 + 1;
+               blue_col   = col2 + 1;
+               blue_row   = row2;
+               break;
+            case DebayerBayerPatternParameter::GRBG:
+               red_col    = col2 + 1;
+               red_row    = row2;
+               green_col1 = col2;
+               green_row1 = row2;
+               green_col2 = col2 + 1;
+               green_row2 = row2 + 1;
+               blue_col   = col2;
+               blue_row   = row2 + 1;
+               break;
+            case DebayerBayerPatternParameter::GRGB:
+               red_col    = col2 + 1;
+               red_row    = row2;
+               green_col1 = col2;
+               green_row1 = row2;
+               green_col2 = col2;
+               green_row2 = row2 + 1;
+               blue_col   = col2 + 1;
+               blue_row   = row2 + 1;
+               break;
+            case DebayerBayerPatternParameter::GBGR:
+               red_col    = col2 + 1;
+               red_row    = row2 + 1;
+               green_col1 = col2;
+               green_row1 = row2;
+               green_col2 = col2;
+               green_row2 = row2 + 1;
+               blue_col   = col2 + 1;
+               blue_row   = row2;
+               break;
+            case DebayerBayerPatternParameter::RGBG:
+               red_col    = col2;
+               red_row    = row2;
+               green_col1 = col2 + 1;
+               green_row1 = row2;
+               green_col2 = col2 + 1;
+               green_row2 = row2 + 1;
+               blue_col   = col2;
+               blue_row   = row2 + 1;
+               break;
+            case DebayerBayerPatternParameter::BGRG:
+               red_col    = col2;
+               red_row    = row2 + 1;
+               green_col1 = col2 + 1;
+               green_row1 = row2;
+               green_col2 = col2 + 1;
+               green_row2 = row2 + 1;
+               blue_col   = col2;
+               blue_row   = row2;
+               break;
+            }
+
+            // red
+            P::FromSample( output( col, row, 0 ), source( red_col, red_row, SRC_CHANNEL( 0 ) ) );
+            //green
+            double v1, v2;
+            P::FromSample( v1, source( green_col1, green_row1, SRC_CHANNEL( 1 ) ) );
+            P::FromSample( v2, source( green_col2, green_row2, SRC_CHANNEL( 1 ) ) );
+            output( col, row, 1 ) = (v1 + v2)/2;
+            // blue
+            P::FromSample( output( col, row, 2 ), source( blue_col, blue_row, SRC_CHANNEL( 2 ) ) );
+         }
+   }
+
+   template <class P>
+   static void Bilinear( Image& output, const GenericImage<P>& source, pcl_enum bayerPattern )
+   {
+      const int src_w = source.Width();
+      const int src_h = source.Height();
+      int colors[ 2 ][ 2 ]; // [row][col]
+      BayerPatternToColorIndices( colors, bayerPattern );
+
+      output.AllocateData( src_w, src_h, 3, ColorSpace::RGB );
+
+      for ( int row = 1; row < src_h-1; ++row )
+      {
+         // skip the first and last column
+         for ( int col = 1; col < src_w-1; ++col )
+         {
+            int current_color = colors[(row % 2)][(col % 2)];
+            int next_color = colors[(row % 2)][((col+1) % 2)];
+            double c1, c2, v1, v2, v3, v4, target_colors[ 3 ];
+            //straight copy of the current color
+            P::FromSample( target_colors[current_color], source( col, row, SRC_CHANNEL( current_color ) ) );
+            switch ( current_color )
+            {
+            case 0: // red done
+            case 2: // blue done
+               // get green samples
+               P::FromSample( v2, source( col, row + 1, SRC_CHANNEL( 1 ) ) );
+               P::FromSample( v1, source( col, row - 1, SRC_CHANNEL( 1 ) ) );
+               P::FromSample( v3, source( col - 1, row, SRC_CHANNEL( 1 ) ) );
+               P::FromSample( v4, source( col + 1, row, SRC_CHANNEL( 1 ) ) );
+               c1 = (v1 + v2 + v3 + v4)/4;
+               target_colors[1] = c1;
+               // get blue or red samples
+               P::FromSample( v1, source( col - 1, row - 1, SRC_CHANNEL( 2-current_color ) ) );
+               P::FromSample( v2, source( col + 1, row + 1, SRC_CHANNEL( 2-current_color ) ) );
+               P::FromSample( v3, source( col - 1, row + 1, SRC_CHANNEL( 2-current_color ) ) );
+               P::FromSample( v4, source( col + 1, row - 1, SRC_CHANNEL( 2-current_color ) ) );
+               c1 = (v1 + v2 + v3 + v4)/4;
+               // if the current color is red then we just grabbed blue and vise versa
+               target_colors[2-current_color] = c1;
+               break;
+
+            case 1: // green already done
+               P::FromSample( v1, source( col, row - 1, SRC_CHANNEL( 2-next_color ) ) );
+               P::FromSample( v2, source( col, row + 1, SRC_CHANNEL( 2-next_color ) ) );
+               P::FromSample( v3, source( col - 1, row, SRC_CHANNEL( next_color ) ) ); // next color
+               P::FromSample( v4, source( col + 1, row, SRC_CHANNEL( next_color ) ) );
+               c1 = (v1 + v2)/2;
+               c2 = (v3 + v4)/2;
+               // if the current color is red then we just grabbed blue and vise versa
+               target_colors[next_color] = c2;
+               target_colors[2-next_color] = c1;
+               break;
+            }
+
+            for ( int i = 0; i < 3; i++ )
+               output( col, row, i ) = target_colors[i];
+         }
+
+         // get colors for the inner and outer column
+         for ( int i = 0; i < 3; i++ )
+         {
+            output( 0, row, i ) = output( 1, row, i );
+            output( src_w - 1, row, i ) = output( src_w-2, row, i );
+         }
+      }
+
+      // Copy top and bottom rows from the adjecent ones.
+      for ( int col = 0; col < src_w; col++ )
+         for ( int i = 0; i < 3; i++ )
+         {
+            output( col, 0, i ) = output( col, 1, i );
+            output( col, src_h-1, i ) = output( col, src_h-2, i );
+         }
+   }
+
+   template <class P>
+   static void VNG( Image& output, const GenericImage<P>& source, pcl_enum bayerPattern )
+   {
+      const int src_w = source.Width();
+      const int src_h = source.Height();
+      int colors[ 2 ][ 2 ]; // [row][col]
+      BayerPatternToColorIndices( colors, bayerPattern );
+
+      output.AllocateData( src_w, src_h, 3, ColorSpace::RGB );
+
+      for ( int row = 2; row < src_h-2; row++ )
+      {
+         // cache matrix of 5x5 pixels around current pixel
+         double v[ 25 ];     // values of 5x5 pixels of bayered image, centered on current pixel
+         int channels[ 25 ]; // channel indices for 5x5 pixels
+
+         // skip two first and last columns
+         for ( int col = 2; col < src_w-2; col++ )
+         {
+            if ( col == 2 )
+            {
+               // for first column, read whole matrix
+               for ( int y = 0; y < 5; y++ )
+                  for ( int x = 0; x < 5; x++ )
+                  {
+                     int c = col+x-2;
+                     int r = row+y-2;
+                     channels[y*5+x] = colors[r%2][c%2];
+                     P::FromSample( v[y*5+x], source( c, r, SRC_CHANNEL( channels[y*5+x] ) ) );
+                  }
+            }
+            else
+            {
+               // for other columns, shift the matrix to the left and read just last column
+               for ( int y = 0; y < 5; y++ )
+               {
+                  for (int x = 0; x < 4; x++)
+                  {
+                     channels[y*5+x] = channels[y*5+x+1];
+                     v[y*5+x] = v[y*5+x+1];
+                  }
+                  channels[y*5+4] = colors[(row+y-2)%2][(col+2)%2];
+                  P::FromSample( v[y*5+4], source( col+2, row+y-2, SRC_CHANNEL( channels[y*5+4] ) ) );
+               }
+            }
+
+            double gradients[ 8 ];     // gradients in N, E, S, W, NE, SW, NW and SE directions
+            int valid_gradients[ 8 ];  // list of gradients below computed threshold (valid for color computation)
+            int valid_gradients_count; // number of valid gradients
+            double value_sums[ 3 ];    // sums of color coefficients for all valid gradients
+
+            // get channel for actual pixel from bayer pattern
+            int current_channel = colors[row % 2][col % 2];
+
+            ComputeGradients( v, current_channel, gradients );
+            ThresholdGradients( gradients, valid_gradients, valid_gradients_count );
+            ComputeSums( v, channels, valid_gradients, valid_gradients_count, value_sums );
+
+            // get indices of two remaining channels
+            int other_channel1 = 0, other_channel2 = 0;
+            switch ( current_channel )
+            {
+            case 0:
+               other_channel1 = 1;
+               other_channel2 = 2;
+               break;
+            case 1:
+               other_channel1 = 0;
+               other_channel2 = 2;
+               break;
+            case 2:
+               other_channel1 = 0;
+               other_channel2 = 1;
+               break;
+            }
+
+            // compute normalized color differences for remaining channels
+            double diff1 = (value_sums[other_channel1] - value_sums[current_channel])/double( valid_gradients_count );
+            double diff2 = (value_sums[other_channel2] - value_sums[current_channel])/double( valid_gradients_count );
+
+            // current channel is directly known from bayered image (take the center of the cached matrix)
+            output( col, row, current_channel ) = v[12];
+            // two remaining channels are computed using normalized differences
+            output( col, row, other_channel1 ) = Range( v[12]+diff1, 0.0, 1.0 );
+            output( col, row, other_channel2 ) = Range( v[12]+diff2, 0.0, 1.0 );
+         }
+
+         // get colors for the inner and outer two columns
+         for ( int i = 0; i < 3; i++ )
+         {
+            output( 0, row, i ) = output( 2, row, i );
+            output( 1, row, i ) = output( 2, row, i );
+            output( src_w - 1, row, i ) = output( src_w - 3, row, i );
+            output( src_w - 2, row, i ) = output( src_w - 3, row, i );
+         }
+      }
+
+      // Copy top and bottom two rows from the adjecent ones.
+      for ( int col = 0; col < src_w; col++ )
+         for ( int i = 0; i < 3; i++ )
+         {
+            output( col, 0, i ) = output( col, 1, i ) = output( col, 2, i );
+            output( col, src_h-1, i ) = output( col, src_h-2, i ) = output( col, src_h-3, i );
+         }
+   }
+
+#undef SRC_CHANNEL
+
+private:
+
+   // compute gradients in eight directions around current pixel
+   static void ComputeGradients( const double* v, int current_channel, double* gradients )
+   {
+      // formulas taken directly from VNG method paper
+      const int G_N = 0;
+      const int G_E = 1;
+      const int G_S = 2;
+      const int G_W = 3;
+      const int G_NE = 4;
+      const int G_SE = 5;
+      const int G_NW = 6;
+      const int G_SW = 7;
+
+      // compute vertical and horizontal gradients
+      gradients[G_N]  = Abs( v[7]  - v[17] )   + Abs( v[2]  - v[12] )   + Abs( v[6]  - v[16] )/2 +
+                        Abs( v[8]  - v[18] )/2 + Abs( v[1]  - v[11] )/2 + Abs( v[3]  - v[13] )/2;
+      gradients[G_E]  = Abs( v[13] - v[11] )   + Abs( v[14] - v[12] )   + Abs( v[8]  - v[6]  )/2 +
+                        Abs( v[18] - v[16] )/2 + Abs( v[9]  - v[7]  )/2 + Abs( v[19] - v[17] )/2;
+      gradients[G_S]  = Abs( v[17] - v[7]  )   + Abs( v[22] - v[12] )   + Abs( v[16] - v[6]  )/2 +
+                        Abs( v[18] - v[8]  )/2 + Abs( v[21] - v[11] )/2 + Abs( v[23] - v[13] )/2;
+      gradients[G_W]  = Abs( v[11] - v[13] )   + Abs( v[10] - v[12] )   + Abs( v[6]  - v[8]  )/2 +
+                        Abs( v[16] - v[18] )/2 + Abs( v[5]  - v[7]  )/2 + Abs( v[15] - v[17] )/2;
+
+      // diagonal gradients differ for green channel and other channels
+      switch ( current_channel )
+      {
+      // green center
+      default: // just to shut down '-Wmaybe-uninitialized' warnings
+      case 1:
+         gradients[G_NE] = Abs( v[8]  - v[16] ) + Abs( v[4]  - v[12] ) +
+                           Abs( v[3]  - v[11] ) + Abs( v[9]  - v[17] );
+         gradients[G_SE] = Abs( v[18] - v[6]  ) + Abs( v[24] - v[12] ) +
+                           Abs( v[23] - v[11] ) + Abs( v[19] - v[7]  );
+         gradients[G_NW] = Abs( v[6]  - v[18] ) + Abs( v[0]  - v[12] ) +
+                           Abs( v[1]  - v[13] ) + Abs( v[5]  - v[17] );
+         gradients[G_SW] = Abs( v[16] - v[8]  ) + Abs( v[20] - v[12] ) +
+                           Abs( v[21] - v[13] ) + Abs( v[15] - v[7]  );
+         break;
+      // red or blue center
+      case 0:
+      case 2:
+         gradients[G_NE] = Abs( v[8]  - v[16] )   + Abs( v[4]  - v[12] )   + Abs( v[7]  - v[11] )/2 +
+                           Abs( v[13] - v[17] )/2 + Abs( v[3]  - v[7]  )/2 + Abs( v[9]  - v[13] )/2;
+         gradients[G_SE] = Abs( v[18] - v[6]  )   + Abs( v[24] - v[12] )   + Abs( v[13] - v[7]  )/2 +
+                           Abs( v[17] - v[11] )/2 + Abs( v[19] - v[13] )   + Abs( v[23] - v[17] )/2;
+         gradients[G_NW] = Abs( v[6]  - v[18] )   + Abs( v[0]  - v[12] )   + Abs( v[7]  - v[13] )/2 +
+                           Abs( v[11] - v[17] )/2 + Abs( v[1]  - v[7]  )/2 + Abs( v[5]  - v[11] )/2;
+         gradients[G_SW] = Abs( v[16] - v[8]  )   + Abs( v[20] - v[12] )   + Abs( v[11] - v[7]  )/2 +
+                           Abs( v[17] - v[13] )/2 + Abs( v[15] - v[11] )   + Abs( v[21] - v[17] )/2;
+         break;
+      }
+   }
+
+   // compute threshold and list of gradients below the threshold
+   static void ThresholdGradients( const double* gradients, int* valid_gradients, int& count )
+   {
+      double min = gradients[0], max = gradients[0];
+      for ( int i = 1; i < 8; i++ )
+      {
+         if ( gradients[i] < min )
+            min = gradients[i];
+         if ( gradients[i] > max )
+            max = gradients[i];
+      }
+
+      // k1 and k2 coefficient values are taken from VNG method paper
+      const double k1 = 1.5;
+      const double k2 = 0.5;
+      double threshold = k1*min + k2*(max - min);
+
+      count = 0;
+      for ( int i = 0; i < 8; i++ )
+         if ( gradients[i] <= threshold+1e-10 )
+            valid_gradients[count++] = i;
+   }
+
+   // compute sums of averaged color coefficients for each of valid gradients
+   static void ComputeSums( const double* v, const int* channels, const int* valid_gradients, int count, double* sums )
+   {
+      // indices to the 5x5 matrix for each gradient, green center pixel
+      static const int green_center_indices[ 8 ][ 8 ] =
+      {
+         {  1,  2,  3,  7, 11, 12, 13, -1 },
+         {  7,  9, 12, 13, 14, 17, 19, -1 },
+         { 11, 12, 13, 17, 21, 22, 23, -1 },
+         {  5,  7, 10, 11, 12, 15, 17, -1 },
+         {  3,  7,  8,  9, 13, -1, -1, -1 },
+         { 13, 17, 18, 19, 23, -1, -1, -1 },
+         {  1,  5,  6,  7, 11, -1, -1, -1 },
+         { 11, 15, 16, 17, 21, -1, -1, -1 }
+      };
+
+      // indices to the 5x5 matrix for each gradient, red or blue center pixel
+      static const int other_center_indices[ 8 ][ 8 ] =
+      {
+         {  2,  6,  7,  8, 12, -1, -1, -1 },
+         {  8, 12, 13, 14, 18, -1, -1, -1 },
+         { 12, 16, 17, 18, 22, -1, -1, -1 },
+         {  6, 10, 11, 12, 16, -1, -1, -1 },
+         {  3,  4,  7,  8,  9, 12, 13, -1 },
+         { 12, 13, 17, 18, 19, 23, 24, -1 },
+         {  0,  1,  5,  6,  7, 11, 12, -1 },
+         { 11, 12, 15, 16, 17, 20, 21, -1 }
+      };
+
+      for ( int channel = 0; channel < 3; channel++ )
+         sums[channel] = 0;
+
+      for ( int i = 0; i < count; i++ )
+      {
+         int grad = valid_gradients[i];
+         double partial_sums[ 3 ] = { 0.0, 0.0, 0.0 };
+         int partial_counts[ 3 ] = { 0, 0, 0 };
+         const int* indices = (channels[ 12 ] == 1) ? green_center_indices[grad] : other_center_indices[grad];
+         for ( int j = 0; indices[j] >= 0; j++ )
+         {
+            int index = indices[j];
+            int channel = channels[index];
+            partial_sums[channel] += v[index];
+            partial_counts[channel]++;
+         }
+
+         // add averaged partial sums to total sums per each channel
+         for ( int channel = 0; channel < 3; channel++ )
+            if ( partial_counts[channel] > 0 )
+               sums[channel] += partial_sums[channel]/double( partial_counts[channel] );
+      }
+   }
+}; // ReferenceKernels
+
+// ----------------------------------------------------------------------------
+
+/*
+ * Demosaicing with the row-wise kernels, single-threaded, with the same row
+ * ranges and border row replication as the Debayer module.
+ */
+class RowKernels
+{
+public:
+
+   template <class P>
+   static void SuperPixel( Image& output, const GenericImage<P>& source, pcl_enum bayerPattern )
+   {
+      int target_h = source.Height() >> 1;
+      output.AllocateData( source.Width() >> 1, target_h, 3, ColorSpace::RGB );
+      SuperPixelKernel<P> kernel( source, bayerPattern );
+      for ( int row = 0; row < target_h; ++row )
+         kernel( row, output.ScanLine( row, 0 ), output.ScanLine( row, 1 ), output.ScanLine( row, 2 ) );
+   }
+
+   template <class P>
+   static void Bilinear( Image& output, const GenericImage<P>& source, pcl_enum bayerPattern )
+   {
+      Interpolate<BilinearKernel<P> >( output, source, bayerPattern, 1 );
+   }
+
+   template <class P>
+   static void VNG( Image& output, const GenericImage<P>& source, pcl_enum bayerPattern )
+   {
+      Interpolate<VNGKernel<P> >( output, source, bayerPattern, 2 );
+   }
+
+private:
+
+   template <class K, class P>
+   static void Interpolate( Image& output, const GenericImage<P>& source, pcl_enum bayerPattern, int border )
+   {
+      int w = source.Width();
+      int h = source.Height();
+      output.AllocateData( w, h, 3, ColorSpace::RGB );
+      K kernel( source, bayerPattern );
+      for ( int row = border; row < h-border; ++row )
+      {
+         float* out[ 3 ];
+         for ( int i = 0; i < 3; ++i )
+            out[i] = output.ScanLine( row, i );
+         kernel( row, out );
+      }
+
+      for ( int r = 0; r < border; ++r )
+         for ( int i = 0; i < 3; ++i )
+            for ( int col = 0; col < w; ++col )
+            {
+               output( col, r, i ) = output( col, border, i );
+               output( col, h-1-r, i ) = output( col, h-1-border, i );
+            }
+   }
+};
+
+// ----------------------------------------------------------------------------
+
+static const char* MethodId( int method )
+{
+   static const char* ids[] = { "SuperPixel", "Bilinear", "VNG" };
+   return ids[method];
+}
+
+static const char* PatternId( pcl_enum bayerPattern )
+{
+   switch ( bayerPattern )
+   {
+   case DebayerBayerPatternParameter::RGGB: return "RGGB";
+   case DebayerBayerPatternParameter::BGGR: return "BGGR";
+   case DebayerBayerPatternParameter::GBRG: return "GBRG";
+   case DebayerBayerPatternParameter::GRBG: return "GRBG";
+   case DebayerBayerPatternParameter::GRGB: return "GRGB";
+   case DebayerBayerPatternParameter::GBGR: return "GBGR";
+   case DebayerBayerPatternParameter::RGBG: return "RGBG";
+   case DebayerBayerPatternParameter::BGRG: return "BGRG";
+   default:                                 return "????";
+   }
+}
+
+// ----------------------------------------------------------------------------
+
+template <class P>
+static bool Test( XoShiRo256ss& R )
+{
+   static const pcl_enum patterns[] =
+   {
+      DebayerBayerPatternParameter::RGGB, DebayerBayerPatternParameter::BGGR,
+      DebayerBayerPatternParameter::GBRG, DebayerBayerPatternParameter::GRBG,
+      DebayerBayerPatternParameter::GRGB, DebayerBayerPatternParameter::GBGR,
+      DebayerBayerPatternParameter::RGBG, DebayerBayerPatternParameter::BGRG
+   };
+   static const int geometries[][ 2 ] = { { 64, 48 }, { 37, 29 }, { 601, 7 } };
+
+   IsoString typeId = IsoString( P::IsFloatSample() ? "Float" : "UInt" ) + IsoString( P::BitsPerSample() );
+
+   bool passed = true;
+   for ( const auto& geometry : geometries )
+      for ( int numberOfChannels = 1; numberOfChannels <= 3; numberOfChannels += 2 )
+      {
+         GenericImage<P> source( geometry[0], geometry[1],
+                                 (numberOfChannels == 1) ? ColorSpace::Gray : ColorSpace::RGB );
+         for ( int c = 0; c < numberOfChannels; ++c )
+            for ( typename P::sample* f = source[c], * f1 = f + source.NumberOfPixels(); f < f1; ++f )
+               *f = P::ToSample( R() );
+
+         for ( int method = 0; method < 3; ++method )
+            for ( pcl_enum pattern : patterns )
+            {
+               Image output, reference;
+               switch ( method )
+               {
+               case 0:
+                  RowKernels::SuperPixel( output, source, pattern );
+                  ReferenceKernels::SuperPixel( reference, source, pattern );
+                  break;
+               case 1:
+                  RowKernels::Bilinear( output, source, pattern );
+                  ReferenceKernels::Bilinear( reference, source, pattern );
+                  break;
+               case 2:
+                  RowKernels::VNG( output, source, pattern );
+                  ReferenceKernels::VNG( reference, source, pattern );
+                  break;
+               }
+
+               double delta = 0;
+               bool ok = output.Width() == reference.Width() && output.Height() == reference.Height();
+               if ( ok )
+               {
+                  for ( int c = 0; c < 3; ++c )
+                     for ( const float* f = output[c], * r = reference[c], * f1 = f + output.NumberOfPixels(); f < f1; ++f, ++r )
+                        delta = Max( delta, Abs( double( *f ) - double( *r ) ) );
+                  ok = delta < 1.0e-6;
+               }
+               if ( !ok )
+                  passed = false;
+
+               std::cout << IsoString().Format( "%-10s %-4s %-7s %-4s %3dx%-3d : ",
+                                                MethodId( method ), PatternId( pattern ), typeId.c_str(),
+                                                (numberOfChannels == 1) ? "Gray" : "RGB",
+                                                source.Width(), source.Height() )
+                         << (ok ? IsoString().Format( "passed (max. delta = %.3e)\n", delta ) : IsoString( "FAILED\n" ));
+            }
+      }
+
+   return passed;
+}
+
+// ----------------------------------------------------------------------------
+
+int main( int argc, const char* argv[] )
+{
+   Exception::DisableGUIOutput();
+   Exception::EnableConsoleOutput();
+
+   try
+   {
+      std::cout <<
+"\nPixInsight Debayer Kernel Test Utility - " PROGRAM_NAME " version " PROGRAM_VERSION
+"\nCopyright (c) " PROGRAM_YEAR " Pleiades Astrophoto S.L."
+"\n\n";
+
+      XoShiRo256ss R( 0x5e1f7e57 );
+      bool passed = Test<UInt8PixelTraits>( R )
+                  & Test<UInt16PixelTraits>( R )
+                  & Test<UInt32PixelTraits>( R )
+                  & Test<FloatPixelTraits>( R )
+                  & Test<DoublePixelTraits>( R );
+
+      if ( !passed )
+      {
+         std::cout << "\n*** Test failed!\n";
+         return 1;
+      }
+
+      std::cout << "\n* Test passed.\n";
+      return 0;
+   }
+
+   ERROR_HANDLER
+   return -1;
+}
+
+// ----------------------------------------------------------------------------
+// EOF debayertest.cpp